@@ -268,6 +268,14 @@ public class AnalyzerOptions implements Serializable {
     return builder.getPreserveColumnAliases();
   }
 
+  public void setAllocateResolvedAstInArena(boolean value) {
+    builder.setAllocateResolvedAstInArena(value);
+  }
+
+  public boolean getAllocateResolvedAstInArena() {
+    return builder.getAllocateResolvedAstInArena();
+  }
+
   static AnalyzerOptions deserialize(
       AnalyzerOptionsProto proto, List<ZetaSQLDescriptorPool> pools, TypeFactory factory) {
     AnalyzerOptions options = new AnalyzerOptions();
@@ -282,6 +290,7 @@ public class AnalyzerOptions implements Serializable {
     options.setStrictValidationOnColumnReplacements(
         proto.getStrictValidationOnColumnReplacements());
     options.setPreserveColumnAliases(proto.getPreserveColumnAliases());
+    options.setAllocateResolvedAstInArena(proto.getAllocateResolvedAstInArena());
 
     if (proto.hasInScopeExpressionColumn()) {
       options.setInScopeExpressionColumn(
@@ -18,17 +18,26 @@
 package com.google.zetasql;
 
 import com.google.auto.service.AutoService;
+import com.google.protobuf.CodedOutputStream;
+import com.google.protobuf.MessageLite;
+import io.grpc.CallOptions;
 import io.grpc.Channel;
+import io.grpc.ClientCall;
 import io.grpc.LoadBalancerProvider;
 import io.grpc.LoadBalancerRegistry;
+import io.grpc.Metadata;
+import io.grpc.MethodDescriptor;
+import io.grpc.Status;
 import io.grpc.netty.NettyChannelBuilder;
 import io.netty.channel.ChannelException;
 import io.netty.channel.EventLoopGroup;
 import io.netty.channel.nio.NioEventLoopGroup;
 import io.netty.channel.socket.nio.NioSocketChannel;
 import java.io.IOException;
+import java.io.InputStream;
 import java.net.InetSocketAddress;
 import java.net.SocketAddress;
+import java.nio.ByteBuffer;
 import java.nio.channels.SocketChannel;
 
 /** Controller class of the ZetaSQL JniChannelProvider. */
@@ -36,6 +45,7 @@ import java.nio.channels.SocketChannel;
 public class JniChannelProvider implements ClientChannelProvider {
   private static final InetSocketAddress ADDRESS = new InetSocketAddress(0);
   private static Channel channel = null;
+  private static Channel nettyChannel = null;
   private static EventLoopGroup eventLoopGroup;
 
   private static String getLibraryPath() {
@@ -84,6 +94,34 @@ public class JniChannelProvider implements ClientChannelProvider {
   /** Returns a SocketChannel connected to the server. */
   private static native SocketChannel getSocketChannel() throws IOException;
 
+  /**
+   * Serves a unary RPC in-process without going through gRPC. The request proto must be serialized
+   * into the first {@code length} bytes of the direct buffer {@code request}; the returned direct
+   * buffer contains the serialized response and must be released with {@link #releaseResponse}.
+   * Both sides of the call share state (registered catalogs, prepared expressions) with the
+   * socketpair channel.
+   */
+  private static native ByteBuffer call(String methodName, ByteBuffer request, int length)
+      throws ServiceException;
+
+  /** Frees the native memory backing a buffer returned by {@link #call}. */
+  private static native void releaseResponse(ByteBuffer response);
+
+  /** Thrown by the native bridge when a direct call fails; constructed from JNI. */
+  protected static class ServiceException extends Exception {
+    private final int code;
+
+    ServiceException(int code, String message) {
+      super(message);
+      this.code = code;
+    }
+
+    /** Returns the canonical (gRPC) error code of the failure. */
+    int getCode() {
+      return code;
+    }
+  }
+
   /** Wraps one end of a socketpair for NioSocketChannel. */
   protected static class SocketPairChannel extends NioSocketChannel {
 
@@ -132,17 +170,155 @@ public class JniChannelProvider implements ClientChannelProvider {
     }
   }
 
-  private synchronized Channel getChannelInternal() {
-    if (channel == null) {
+  /** InputStream view of a ByteBuffer, so response buffers are parsed without copying out. */
+  private static class ByteBufferInputStream extends InputStream {
+    private final ByteBuffer buffer;
+
+    ByteBufferInputStream(ByteBuffer buffer) {
+      this.buffer = buffer;
+    }
+
+    @Override
+    public int read() {
+      return buffer.hasRemaining() ? buffer.get() & 0xFF : -1;
+    }
+
+    @Override
+    public int read(byte[] bytes, int offset, int length) {
+      if (!buffer.hasRemaining()) {
+        return -1;
+      }
+      length = Math.min(length, buffer.remaining());
+      buffer.get(bytes, offset, length);
+      return length;
+    }
+
+    @Override
+    public int available() {
+      return buffer.remaining();
+    }
+  }
+
+  // Direct request buffer reused across calls on the same thread, grown on demand, so steady-state
+  // calls allocate no native memory for requests.
+  private static final ThreadLocal<ByteBuffer> requestBuffer = new ThreadLocal<>();
+
+  private static ByteBuffer getRequestBuffer(int size) {
+    ByteBuffer buffer = requestBuffer.get();
+    if (buffer == null || buffer.capacity() < size) {
+      buffer = ByteBuffer.allocateDirect(Math.max(size, 4096));
+      requestBuffer.set(buffer);
+    }
+    buffer.clear();
+    return buffer;
+  }
+
+  /**
+   * Unary call served by the native bridge. The request is serialized straight into a direct
+   * buffer and the response is parsed straight out of one, skipping the socketpair, gRPC framing
+   * and the intermediate copies they imply; for multi-megabyte messages (resolved ASTs, large
+   * catalogs) those copies dominate the cost of a call.
+   */
+  private static class DirectClientCall<ReqT, RespT> extends ClientCall<ReqT, RespT> {
+    private final MethodDescriptor<ReqT, RespT> method;
+    private Listener<RespT> listener;
+    private ReqT requestMessage;
+    private boolean cancelled = false;
+
+    DirectClientCall(MethodDescriptor<ReqT, RespT> method) {
+      this.method = method;
+    }
+
+    @Override
+    public void start(Listener<RespT> listener, Metadata headers) {
+      this.listener = listener;
+    }
+
+    @Override
+    public void request(int numMessages) {}
+
+    @Override
+    public void cancel(String message, Throwable cause) {
+      cancelled = true;
+    }
+
+    @Override
+    public void sendMessage(ReqT message) {
+      requestMessage = message;
+    }
+
+    @Override
+    public void halfClose() {
+      if (cancelled) {
+        listener.onClose(Status.CANCELLED, new Metadata());
+        return;
+      }
+      ByteBuffer response = null;
+      try {
+        MessageLite message = (MessageLite) requestMessage;
+        int size = message.getSerializedSize();
+        ByteBuffer request = getRequestBuffer(size);
+        CodedOutputStream stream = CodedOutputStream.newInstance(request);
+        message.writeTo(stream);
+        stream.flush();
+        String fullName = method.getFullMethodName();
+        response = call(fullName.substring(fullName.lastIndexOf('/') + 1), request, size);
+        RespT parsed = method.parseResponse(new ByteBufferInputStream(response));
+        listener.onHeaders(new Metadata());
+        listener.onMessage(parsed);
+        listener.onClose(Status.OK, new Metadata());
+      } catch (ServiceException e) {
+        listener.onClose(
+            Status.fromCodeValue(e.getCode()).withDescription(e.getMessage()), new Metadata());
+      } catch (IOException | RuntimeException e) {
+        listener.onClose(Status.INTERNAL.withCause(e), new Metadata());
+      } finally {
+        if (response != null) {
+          releaseResponse(response);
+        }
+      }
+    }
+  }
+
+  /** Serves unary RPCs through the native bridge, everything else through the socketpair. */
+  private static class DirectCallChannel extends Channel {
+    @Override
+    public String authority() {
+      return "localhost";
+    }
+
+    @Override
+    public <ReqT, RespT> ClientCall<ReqT, RespT> newCall(
+        MethodDescriptor<ReqT, RespT> method, CallOptions options) {
+      if (method.getType() != MethodDescriptor.MethodType.UNARY) {
+        return getNettyChannel().newCall(method, options);
+      }
+      return new DirectClientCall<>(method);
+    }
+  }
+
+  private static synchronized Channel getNettyChannel() {
+    if (nettyChannel == null) {
       // TODO release EventLoopGroup during shutdown
       eventLoopGroup = new NioEventLoopGroup();
-      channel =
+      nettyChannel =
           NettyChannelBuilder.forAddress(ADDRESS)
               .channelType(SocketPairChannel.class)
               .eventLoopGroup(eventLoopGroup)
               .usePlaintext()
               .build();
     }
+    return nettyChannel;
+  }
+
+  private synchronized Channel getChannelInternal() {
+    if (channel == null) {
+      if ("false".equals(System.getProperty("zetasql.local_service.direct_calls"))) {
+        channel = getNettyChannel();
+      } else {
+        channel = new DirectCallChannel();
+      }
+    }
     return channel;
   }
 
@@ -0,0 +1,175 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// A corpus of adversarial statements with known superlinear-behavior risk,
+// used as a performance regression gate. Each case is a scaled-up version of
+// an input class that caused a production incident: costs that look fine at
+// normal sizes (parser recursion, per-element resolution work, recursive
+// supertype computation, overload matching) only blow up at pathological
+// scale, so each class is analyzed here at that scale under a time and
+// memory ceiling.
+//
+// The ceilings are orders of magnitude above the healthy cost of these
+// inputs (milliseconds and a few megabytes), so the tests are not sensitive
+// to machine speed and only fail when a change makes an input class
+// drastically (e.g. quadratically) more expensive. Analysis must either
+// succeed or fail cleanly within the ceiling; hanging or exhausting process
+// memory is the regression being gated. Use analyzer_benchmark to measure
+// gradual changes on healthy inputs.
+
+#include <memory>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/builtin_function.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace {
+
+// Every case must complete (or fail cleanly) within these ceilings.
+constexpr absl::Duration kTimeCeiling = absl::Seconds(30);
+constexpr int64_t kMemoryCeilingBytes = int64_t{256} * 1024 * 1024;
+
+class AdversarialPerfTest : public ::testing::Test {
+ protected:
+  AdversarialPerfTest() : catalog_("adversarial_perf_test") {
+    catalog_.AddZetaSQLFunctions();
+  }
+
+  // Analyzes 'sql' under the time and memory ceilings and expects success.
+  // The analysis deadline and memory budget turn a resolver-side blowup into
+  // a clean resource-exhausted error (instead of a hung or OOMed test), and
+  // the wall-time check also covers the parser, which the deadline does not.
+  void ExpectAnalyzesWithinCeiling(const std::string& sql) {
+    AnalyzerOptions options;
+    options.set_analysis_deadline(absl::Now() + kTimeCeiling);
+    options.set_max_analysis_memory_bytes(kMemoryCeilingBytes);
+
+    const absl::Time start = absl::Now();
+    std::unique_ptr<const AnalyzerOutput> output;
+    const zetasql_base::Status status =
+        AnalyzeStatement(sql, options, &catalog_, &type_factory_, &output);
+    const absl::Duration elapsed = absl::Now() - start;
+
+    ZETASQL_EXPECT_OK(status) << "for an adversarial statement of "
+                      << sql.size() << " bytes";
+    EXPECT_LT(elapsed, kTimeCeiling)
+        << "analyzing an adversarial statement of " << sql.size()
+        << " bytes took " << elapsed;
+  }
+
+  TypeFactory type_factory_;
+  SimpleCatalog catalog_;
+};
+
+// Returns "SELECT (((...1...)))" with 'depth' nested parentheses. Exercises
+// the parenthesized-expression recursion in the parser grammar.
+std::string DeepParenthesization(int depth) {
+  std::string sql = "SELECT ";
+  sql.append(depth, '(');
+  sql.append("1");
+  sql.append(depth, ')');
+  return sql;
+}
+
+// Returns "SELECT 1 IN (0, 1, ..., n - 1)". Each element is resolved and
+// checked against the IN list's common supertype, so per-element costs that
+// are superlinear in the list size show up here.
+std::string HugeInList(int num_elements) {
+  std::string sql = "SELECT 1 IN (";
+  for (int i = 0; i < num_elements; ++i) {
+    if (i > 0) sql.append(", ");
+    absl::StrAppend(&sql, i);
+  }
+  sql.append(")");
+  return sql;
+}
+
+// Returns a struct literal with 'num_fields' fields of the given literal
+// value (e.g. "1" or "1.5").
+std::string WideStruct(int num_fields, const std::string& value) {
+  std::string sql = "STRUCT(";
+  for (int i = 0; i < num_fields; ++i) {
+    if (i > 0) sql.append(", ");
+    absl::StrAppend(&sql, value, " AS f", i);
+  }
+  sql.append(")");
+  return sql;
+}
+
+// Returns a struct nested 'depth' levels deep with the given innermost
+// literal value.
+std::string DeepStruct(int depth, const std::string& value) {
+  std::string sql;
+  for (int i = 0; i < depth; ++i) sql.append("STRUCT(");
+  sql.append(value);
+  sql.append(depth, ')');
+  return sql;
+}
+
+// Returns "SELECT 1 + 2.0 + 3 + 4.0 + ..." with 'num_terms' terms of
+// alternating INT64 and DOUBLE type. Every '+' goes through FunctionResolver
+// overload matching with an argument coercion, so signature matching costs
+// that compound along the chain show up here.
+std::string MixedTypeArithmeticChain(int num_terms) {
+  std::string sql = "SELECT 1";
+  for (int i = 1; i < num_terms; ++i) {
+    if (i % 2 == 1) {
+      absl::StrAppend(&sql, " + ", i, ".0");
+    } else {
+      absl::StrAppend(&sql, " + ", i);
+    }
+  }
+  return sql;
+}
+
+TEST_F(AdversarialPerfTest, DeepParenthesization) {
+  // Kept below the default expression nesting limits; deep enough that
+  // superlinear parser behavior is visible against the ceiling.
+  ExpectAnalyzesWithinCeiling(DeepParenthesization(500));
+}
+
+TEST_F(AdversarialPerfTest, HugeInList) {
+  ExpectAnalyzesWithinCeiling(HugeInList(20000));
+}
+
+TEST_F(AdversarialPerfTest, WideStructCoercion) {
+  // An array of two wide structs whose field types differ forces the Coercer
+  // to compute a common supertype field by field.
+  ExpectAnalyzesWithinCeiling(absl::StrCat(
+      "SELECT [", WideStruct(1000, "1"), ", ", WideStruct(1000, "1.5"), "]"));
+}
+
+TEST_F(AdversarialPerfTest, DeepStructCoercion) {
+  // An array of two deeply nested structs whose innermost types differ
+  // exercises the Coercer's struct recursion at depth.
+  ExpectAnalyzesWithinCeiling(absl::StrCat(
+      "SELECT [", DeepStruct(50, "1"), ", ", DeepStruct(50, "1.5"), "]"));
+}
+
+TEST_F(AdversarialPerfTest, SignatureMatchingChain) {
+  ExpectAnalyzesWithinCeiling(MixedTypeArithmeticChain(2000));
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -16,17 +16,22 @@
 
 #include "zetasql/public/analyzer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <set>
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/analyzer/function_resolver.h"
 #include "zetasql/analyzer/resolver.h"
 #include "zetasql/analyzer/table_name_resolver.h"
 #include "zetasql/common/errors.h"
+#include "zetasql/common/fingerprint.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_errors.h"
 #include "zetasql/parser/parser.h"
@@ -36,13 +41,18 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/validator.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
+#include "zetasql/base/trace.h"
 
 ABSL_FLAG(bool, zetasql_validate_resolved_ast, true,
           "Run validator on resolved AST before returning it.");
@@ -73,6 +83,28 @@ bool StringVectorCaseLess::operator()(
 
 namespace {
 
+// Returns true if the resolved AST produced by this analysis should be run
+// through the Validator, applying the validation mode from 'options'.
+// Sampled mode uses a process-wide counter so that the configured rate holds
+// across statements regardless of how many AnalyzerOptions instances exist.
+bool ShouldValidateResolvedAST(const AnalyzerOptions& options) {
+  if (!absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)) return false;
+  switch (options.validation_mode()) {
+    case VALIDATE_NONE:
+      return false;
+    case VALIDATE_FULL:
+      return true;
+    case VALIDATE_SAMPLED: {
+      static std::atomic<int64_t>* sample_counter =
+          new std::atomic<int64_t>(0);
+      return sample_counter->fetch_add(1, std::memory_order_relaxed) %
+                 options.validation_sampling_rate() ==
+             0;
+    }
+  }
+  return true;
+}
+
 // Verifies that the provided AnalyzerOptions have a valid combination of
 // settings.
 zetasql_base::Status ValidateAnalyzerOptions(const AnalyzerOptions& options) {
@@ -404,6 +436,12 @@ zetasql_base::Status AnalyzerOptions::Deserialize(
   result->set_strict_validation_on_column_replacements(
       proto.strict_validation_on_column_replacements());
   result->set_preserve_column_aliases(proto.preserve_column_aliases());
+  result->set_allocate_resolved_ast_in_arena(
+      proto.allocate_resolved_ast_in_arena());
+  result->set_validation_mode(proto.validation_mode());
+  if (proto.validation_sampling_rate() >= 1) {
+    result->set_validation_sampling_rate(proto.validation_sampling_rate());
+  }
 
   if (proto.has_allowed_hints_and_options()) {
     AllowedHintsAndOptions hints_and_options("");
@@ -474,6 +512,9 @@ zetasql_base::Status AnalyzerOptions::Serialize(
   proto->set_strict_validation_on_column_replacements(
       strict_validation_on_column_replacements_);
   proto->set_preserve_column_aliases(preserve_column_aliases_);
+  proto->set_allocate_resolved_ast_in_arena(allocate_resolved_ast_in_arena_);
+  proto->set_validation_mode(validation_mode_);
+  proto->set_validation_sampling_rate(validation_sampling_rate_);
 
   ZETASQL_RETURN_IF_ERROR(allowed_hints_and_options_.Serialize(
       map, proto->mutable_allowed_hints_and_options()));
@@ -634,6 +675,100 @@ ParserOptions AnalyzerOptions::GetParserOptions() const {
   return ParserOptions(id_string_pool(), arena());
 }
 
+// Combines <type> into <fingerprint> via its DebugString, which fully
+// describes the type (including proto/enum full names).  <type> may be NULL
+// (e.g. for hints that allow any type).
+static uint64_t FingerprintType(uint64_t fingerprint, const Type* type) {
+  return FingerprintCombine(fingerprint,
+                            type == nullptr ? "" : type->DebugString());
+}
+
+uint64_t AnalyzerOptions::fingerprint() const {
+  uint64_t fingerprint =
+      FingerprintCombine(kFingerprintSeed, language_options_.fingerprint());
+
+  // The maps below are ordered, so iterating gives a deterministic encoding.
+  // Each variable-length field is preceded by its size so that consecutive
+  // fields cannot alias each other.
+  fingerprint = FingerprintCombine(fingerprint, query_parameters_.size());
+  for (const auto& entry : query_parameters_) {
+    fingerprint = FingerprintCombine(fingerprint, entry.first);
+    fingerprint = FingerprintType(fingerprint, entry.second);
+  }
+  fingerprint =
+      FingerprintCombine(fingerprint, positional_query_parameters_.size());
+  for (const Type* type : positional_query_parameters_) {
+    fingerprint = FingerprintType(fingerprint, type);
+  }
+  fingerprint = FingerprintCombine(fingerprint, expression_columns_.size());
+  for (const auto& entry : expression_columns_) {
+    fingerprint = FingerprintCombine(fingerprint, entry.first);
+    fingerprint = FingerprintType(fingerprint, entry.second);
+  }
+  fingerprint =
+      FingerprintCombine(fingerprint, in_scope_expression_column_.first);
+  fingerprint =
+      FingerprintType(fingerprint, in_scope_expression_column_.second);
+  fingerprint = FingerprintCombine(fingerprint, ddl_pseudo_columns_.size());
+  for (const auto& entry : ddl_pseudo_columns_) {
+    fingerprint = FingerprintCombine(fingerprint, entry.first);
+    fingerprint = FingerprintType(fingerprint, entry.second);
+  }
+  fingerprint = FingerprintCombine(fingerprint, system_variables_.size());
+  for (const auto& entry : system_variables_) {
+    fingerprint = FingerprintCombine(fingerprint, entry.first.size());
+    for (const std::string& name : entry.first) {
+      fingerprint = FingerprintCombine(fingerprint, name);
+    }
+    fingerprint = FingerprintType(fingerprint, entry.second);
+  }
+
+  const AllowedHintsAndOptions& hints = allowed_hints_and_options_;
+  fingerprint =
+      FingerprintCombine(fingerprint, hints.disallow_unknown_options);
+  fingerprint = FingerprintCombine(
+      fingerprint, hints.disallow_unknown_hints_with_qualifiers.size());
+  for (const std::string& qualifier :
+       hints.disallow_unknown_hints_with_qualifiers) {
+    fingerprint = FingerprintCombine(fingerprint, qualifier);
+  }
+  // The hint and option maps are unordered, so serialize their entries and
+  // sort before combining to get a deterministic encoding.
+  std::vector<std::string> hint_entries;
+  hint_entries.reserve(hints.hints_lower.size() + hints.options_lower.size());
+  for (const auto& entry : hints.hints_lower) {
+    hint_entries.push_back(absl::StrCat(
+        "hint:", entry.first.first, ".", entry.first.second, ":",
+        entry.second == nullptr ? "" : entry.second->DebugString()));
+  }
+  for (const auto& entry : hints.options_lower) {
+    hint_entries.push_back(absl::StrCat(
+        "option:", entry.first, ":",
+        entry.second == nullptr ? "" : entry.second->DebugString()));
+  }
+  std::sort(hint_entries.begin(), hint_entries.end());
+  fingerprint = FingerprintCombine(fingerprint, hint_entries.size());
+  for (const std::string& hint_entry : hint_entries) {
+    fingerprint = FingerprintCombine(fingerprint, hint_entry);
+  }
+
+  fingerprint = FingerprintCombine(fingerprint, error_message_mode_);
+  fingerprint = FingerprintCombine(fingerprint, default_timezone_.name());
+  fingerprint = FingerprintCombine(fingerprint, statement_context_);
+  fingerprint = FingerprintCombine(fingerprint, record_parse_locations_);
+  fingerprint = FingerprintCombine(fingerprint, validation_mode_);
+  fingerprint = FingerprintCombine(fingerprint, validation_sampling_rate_);
+  fingerprint = FingerprintCombine(fingerprint, allow_undeclared_parameters_);
+  fingerprint = FingerprintCombine(fingerprint, parameter_mode_);
+  fingerprint = FingerprintCombine(fingerprint, prune_unused_columns_);
+  fingerprint =
+      FingerprintCombine(fingerprint, allocate_resolved_ast_in_arena_);
+  fingerprint = FingerprintCombine(fingerprint,
+                                   strict_validation_on_column_replacements_);
+  fingerprint = FingerprintCombine(fingerprint, preserve_column_aliases_);
+  return fingerprint;
+}
+
 AnalyzerOutput::AnalyzerOutput(
     std::shared_ptr<IdStringPool> id_string_pool,
     std::shared_ptr<zetasql_base::UnsafeArena> arena,
@@ -681,12 +816,25 @@ static zetasql_base::Status FinishAnalyzeStatementImpl(
     std::unique_ptr<const ResolvedStatement>* resolved_statement) {
   VLOG(5) << "Parsed AST:\n" << parser_output.statement()->DebugString();
 
-  ZETASQL_RETURN_IF_ERROR(resolver->ResolveStatement(sql, parser_output.statement(),
-                                             resolved_statement));
+  // If requested, allocate resolved AST nodes in the options' arena, which
+  // AnalyzerOutput keeps alive, so the nodes' memory is released in bulk.
+  absl::optional<ResolvedNodeArenaScope> arena_scope;
+  if (options.allocate_resolved_ast_in_arena()) {
+    ZETASQL_RET_CHECK(options.arena() != nullptr)
+        << "allocate_resolved_ast_in_arena requires arena() to be set";
+    arena_scope.emplace(options.arena().get());
+  }
+
+  {
+    ZETASQL_TRACE_SPAN("AnalyzeStatement::Resolve");
+    ZETASQL_RETURN_IF_ERROR(resolver->ResolveStatement(
+        sql, parser_output.statement(), resolved_statement));
+  }
 
   VLOG(3) << "Resolved AST:\n" << (*resolved_statement)->DebugString();
 
-  if (absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)) {
+  if (ShouldValidateResolvedAST(options)) {
+    ZETASQL_TRACE_SPAN("AnalyzeStatement::Validate");
     Validator validator(options.language_options());
     ZETASQL_RETURN_IF_ERROR(
         validator.ValidateResolvedStatement(resolved_statement->get()));
@@ -734,8 +882,11 @@ static zetasql_base::Status AnalyzeStatementImpl(
 
   VLOG(1) << "Parsing statement:\n" << sql;
   std::unique_ptr<ParserOutput> parser_output;
-  const zetasql_base::Status status = ParseStatement(
-      sql, options.GetParserOptions(), &parser_output);
+  zetasql_base::Status status;
+  {
+    ZETASQL_TRACE_SPAN("AnalyzeStatement::Parse");
+    status = ParseStatement(sql, options.GetParserOptions(), &parser_output);
+  }
   if (!status.ok()) {
     return UnsupportedStatementErrorOrStatus(
         status, ParseResumeLocation::FromStringView(sql), options);
@@ -805,6 +956,332 @@ zetasql_base::Status AnalyzeNextStatement(
       options.error_message_mode(), resume_location->input(), status);
 }
 
+AnalyzerSession::AnalyzerSession(const AnalyzerOptions& options,
+                                 Catalog* catalog, TypeFactory* type_factory)
+    : options_(options), catalog_(catalog), type_factory_(type_factory) {
+  options_.CreateDefaultArenasIfNotSet();
+  resolver_ = absl::make_unique<Resolver>(catalog_, type_factory_, &options_);
+}
+
+AnalyzerSession::~AnalyzerSession() {
+}
+
+zetasql_base::Status AnalyzerSession::AnalyzeNext(
+    absl::string_view sql, std::unique_ptr<const AnalyzerOutput>* output) {
+  const zetasql_base::Status status = AnalyzeNextImpl(sql, output);
+  return ConvertInternalErrorLocationAndAdjustErrorString(
+      options_.error_message_mode(), sql, status);
+}
+
+zetasql_base::Status AnalyzerSession::AnalyzeNextImpl(
+    absl::string_view sql, std::unique_ptr<const AnalyzerOutput>* output) {
+  output->reset();
+
+  ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options_));
+
+  VLOG(1) << "Parsing statement in session:\n" << sql;
+  std::unique_ptr<ParserOutput> parser_output;
+  const zetasql_base::Status parse_status =
+      ParseStatement(sql, options_.GetParserOptions(), &parser_output);
+  if (!parse_status.ok()) {
+    return UnsupportedStatementErrorOrStatus(
+        parse_status, ParseResumeLocation::FromStringView(sql), options_);
+  }
+
+  std::unique_ptr<const ResolvedStatement> resolved_statement;
+  ZETASQL_RETURN_IF_ERROR(FinishAnalyzeStatementImpl(
+      sql, *parser_output, resolver_.get(), options_, catalog_, type_factory_,
+      &resolved_statement));
+  *output = absl::make_unique<AnalyzerOutput>(
+      options_.id_string_pool(), options_.arena(),
+      std::move(resolved_statement),
+      AnalyzerOutputProperties(),
+      std::move(parser_output),
+      ConvertInternalErrorLocationsAndAdjustErrorStrings(
+          options_.error_message_mode(), sql,
+          resolver_->deprecation_warnings()),
+      resolver_->undeclared_parameters(),
+      resolver_->undeclared_positional_parameters());
+  return zetasql_base::OkStatus();
+}
+
+namespace {
+
+// Parse-tree node kinds that correspond to a single literal token in the
+// statement text.  ASTDateOrTimeLiteral subsumes its inner string literal
+// because GetDescendantSubtreesWithKinds() does not descend into found nodes.
+const std::set<int>& LiteralASTNodeKinds() {
+  static const std::set<int>* kinds = new std::set<int>{
+      AST_INT_LITERAL,     AST_FLOAT_LITERAL,   AST_NUMERIC_LITERAL,
+      AST_STRING_LITERAL,  AST_BYTES_LITERAL,   AST_BOOLEAN_LITERAL,
+      AST_NULL_LITERAL,    AST_DATE_OR_TIME_LITERAL};
+  return *kinds;
+}
+
+// Computes the shape key for <statement>: the statement text with every
+// literal token replaced by a placeholder byte that cannot survive literal
+// stripping, prefixed by the literal count.  Returns the literal token
+// ranges in <*literal_ranges>, ordered by parse location.
+zetasql_base::Status BuildStatementShapeKey(
+    absl::string_view sql, const ASTStatement* statement,
+    std::vector<ParseLocationRange>* literal_ranges, std::string* key) {
+  std::vector<const ASTNode*> literal_nodes;
+  statement->GetDescendantSubtreesWithKinds(LiteralASTNodeKinds(),
+                                            &literal_nodes);
+  literal_ranges->clear();
+  literal_ranges->reserve(literal_nodes.size());
+  for (const ASTNode* node : literal_nodes) {
+    literal_ranges->push_back(node->GetParseLocationRange());
+  }
+  std::sort(literal_ranges->begin(), literal_ranges->end(),
+            [](const ParseLocationRange& a, const ParseLocationRange& b) {
+              return a.start().GetByteOffset() < b.start().GetByteOffset();
+            });
+
+  key->clear();
+  absl::StrAppend(key, literal_ranges->size(), ":");
+  int prefix_offset = 0;
+  for (const ParseLocationRange& range : *literal_ranges) {
+    const int first_offset = range.start().GetByteOffset();
+    const int last_offset = range.end().GetByteOffset();
+    ZETASQL_RET_CHECK(first_offset >= prefix_offset && last_offset > first_offset &&
+              last_offset <= sql.length())
+        << "Parse locations of literals are broken:\nQuery: " << sql;
+    absl::StrAppend(key, sql.substr(prefix_offset, first_offset - prefix_offset),
+                    "\x01");
+    prefix_offset = last_offset;
+  }
+  absl::StrAppend(key, sql.substr(prefix_offset));
+  return ::zetasql_base::OkStatus();
+}
+
+// Collects the resolved literals of <statement>, grouped by the literal
+// token range they were resolved from, into <*literal_groups> (one group
+// per entry of <literal_ranges>, in the same order).  Returns false if the
+// resolved literals do not correspond one-to-one to the literal tokens -
+// i.e. some token's value flowed somewhere other than a literal node at its
+// own location (GROUP BY ordinals, array/struct constructors, ...) - in
+// which case the statement must not be used as a template.
+bool CollectTemplateLiteralGroups(
+    const ResolvedStatement* statement,
+    const std::vector<ParseLocationRange>& literal_ranges,
+    std::vector<std::vector<const ResolvedLiteral*>>* literal_groups) {
+  absl::flat_hash_map<std::pair<int, int>, int> range_index;
+  for (int i = 0; i < literal_ranges.size(); ++i) {
+    range_index[std::make_pair(literal_ranges[i].start().GetByteOffset(),
+                               literal_ranges[i].end().GetByteOffset())] = i;
+  }
+
+  std::vector<const ResolvedNode*> literal_nodes;
+  statement->GetDescendantsWithKinds({RESOLVED_LITERAL}, &literal_nodes);
+  literal_groups->clear();
+  literal_groups->resize(literal_ranges.size());
+  for (const ResolvedNode* node : literal_nodes) {
+    const ResolvedLiteral* literal = node->GetAs<ResolvedLiteral>();
+    const ParseLocationRange* location = literal->GetParseLocationRangeOrNULL();
+    if (location == nullptr) {
+      // Not created directly from a token (e.g. an injected default value).
+      // Its value is part of the statement shape and is never patched.
+      continue;
+    }
+    const int* index = zetasql_base::FindOrNull(
+        range_index, std::make_pair(location->start().GetByteOffset(),
+                                    location->end().GetByteOffset()));
+    if (index == nullptr) {
+      // A literal whose location is not exactly a literal token; its value
+      // was derived from more than one token or from elsewhere.
+      return false;
+    }
+    std::vector<const ResolvedLiteral*>& group = (*literal_groups)[*index];
+    if (!group.empty() &&
+        (!group[0]->type()->Equals(literal->type()) ||
+         group[0]->value() != literal->value())) {
+      // Literals sharing a token must agree, so that one patched value can
+      // replace all of them.
+      return false;
+    }
+    group.push_back(literal);
+  }
+
+  for (const std::vector<const ResolvedLiteral*>& group : *literal_groups) {
+    if (group.empty()) {
+      // A literal token with no literal node at its location; its value
+      // influenced resolution some other way (e.g. a GROUP BY ordinal).
+      return false;
+    }
+  }
+  return true;
+}
+
+// Deep-copies a resolved AST, replacing the value of each literal that
+// appears in <patches> and resetting its float_literal_id, which refers to
+// the original statement's literal images.
+class LiteralPatchingVisitor : public ResolvedASTDeepCopyVisitor {
+ public:
+  explicit LiteralPatchingVisitor(
+      const absl::flat_hash_map<const ResolvedLiteral*, Value>* patches)
+      : patches_(patches) {}
+
+ private:
+  zetasql_base::Status VisitResolvedLiteral(const ResolvedLiteral* node) override {
+    const Value* patched_value = zetasql_base::FindOrNull(*patches_, node);
+    if (patched_value == nullptr) {
+      return CopyVisitResolvedLiteral(node);
+    }
+    auto copy = MakeResolvedLiteral(node->type(), *patched_value,
+                                    node->has_explicit_type(),
+                                    /*float_literal_id=*/0);
+    const ParseLocationRange* location = node->GetParseLocationRangeOrNULL();
+    if (location != nullptr) {
+      copy->SetParseLocationRange(*location);
+    }
+    PushNodeToStack(std::move(copy));
+    return ::zetasql_base::OkStatus();
+  }
+
+  const absl::flat_hash_map<const ResolvedLiteral*, Value>* patches_;
+};
+
+}  // namespace
+
+struct StatementTemplateCache::StatementTemplate {
+  // The full analysis of the first statement seen with this shape.  Kept
+  // alive by the cache and shared with that statement's caller.
+  std::shared_ptr<const AnalyzerOutput> output;
+
+  // The template's resolved literals, one group per literal token of the
+  // statement, in parse order.  Groups with more than one element come from
+  // duplicate literals created for analytic functions, which share a
+  // location and value.  The pointers are into <output>'s resolved AST.
+  std::vector<std::vector<const ResolvedLiteral*>> literal_groups;
+};
+
+StatementTemplateCache::StatementTemplateCache(const AnalyzerOptions& options,
+                                               Catalog* catalog,
+                                               TypeFactory* type_factory)
+    : options_(options), catalog_(catalog), type_factory_(type_factory) {
+  options_.CreateDefaultArenasIfNotSet();
+  // Literal patching needs the parse location of every resolved literal.
+  options_.set_record_parse_locations(true);
+}
+
+StatementTemplateCache::~StatementTemplateCache() {
+}
+
+zetasql_base::Status StatementTemplateCache::AnalyzeStatement(
+    absl::string_view sql, std::shared_ptr<const AnalyzerOutput>* output) {
+  const zetasql_base::Status status = AnalyzeStatementImpl(sql, output);
+  return ConvertInternalErrorLocationAndAdjustErrorString(
+      options_.error_message_mode(), sql, status);
+}
+
+zetasql_base::Status StatementTemplateCache::AnalyzeStatementImpl(
+    absl::string_view sql, std::shared_ptr<const AnalyzerOutput>* output) {
+  output->reset();
+
+  ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options_));
+
+  VLOG(1) << "Parsing statement for template cache:\n" << sql;
+  std::unique_ptr<ParserOutput> parser_output;
+  const zetasql_base::Status parse_status =
+      ParseStatement(sql, options_.GetParserOptions(), &parser_output);
+  if (!parse_status.ok()) {
+    return UnsupportedStatementErrorOrStatus(
+        parse_status, ParseResumeLocation::FromStringView(sql), options_);
+  }
+
+  std::vector<ParseLocationRange> literal_ranges;
+  std::string shape_key;
+  ZETASQL_RETURN_IF_ERROR(BuildStatementShapeKey(sql, parser_output->statement(),
+                                         &literal_ranges, &shape_key));
+
+  const std::unique_ptr<StatementTemplate>* entry =
+      zetasql_base::FindOrNull(templates_, shape_key);
+  if (entry != nullptr) {
+    const zetasql_base::Status patch_status =
+        AnalyzeFromTemplate(sql, **entry, literal_ranges, output);
+    if (patch_status.ok()) {
+      ++cache_hits_;
+      return ::zetasql_base::OkStatus();
+    }
+    // The template could not be applied (e.g. a literal failed to coerce to
+    // the template's type).  Fall back to full analysis, which produces the
+    // authoritative result or error for this statement.
+    VLOG(2) << "Statement template not applicable: " << patch_status;
+    output->reset();
+  }
+
+  std::unique_ptr<const AnalyzerOutput> analyzed;
+  ZETASQL_RETURN_IF_ERROR(AnalyzeStatementFromParserOutputOwnedOnSuccess(
+      &parser_output, options_, sql, catalog_, type_factory_, &analyzed));
+  std::shared_ptr<const AnalyzerOutput> shared_output(std::move(analyzed));
+
+  if (entry == nullptr) {
+    auto new_entry = absl::make_unique<StatementTemplate>();
+    new_entry->output = shared_output;
+    if (CollectTemplateLiteralGroups(shared_output->resolved_statement(),
+                                     literal_ranges,
+                                     &new_entry->literal_groups)) {
+      templates_.emplace(std::move(shape_key), std::move(new_entry));
+    }
+  }
+
+  *output = std::move(shared_output);
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status StatementTemplateCache::AnalyzeFromTemplate(
+    absl::string_view sql, const StatementTemplate& entry,
+    const std::vector<ParseLocationRange>& literal_ranges,
+    std::shared_ptr<const AnalyzerOutput>* output) {
+  ZETASQL_RET_CHECK_EQ(entry.literal_groups.size(), literal_ranges.size());
+
+  absl::flat_hash_map<const ResolvedLiteral*, Value> patches;
+  for (int i = 0; i < literal_ranges.size(); ++i) {
+    const std::vector<const ResolvedLiteral*>& group = entry.literal_groups[i];
+    ZETASQL_RET_CHECK(!group.empty());
+    const Type* target_type = group[0]->type();
+
+    const int first_offset = literal_ranges[i].start().GetByteOffset();
+    const int last_offset = literal_ranges[i].end().GetByteOffset();
+    const absl::string_view literal_sql =
+        sql.substr(first_offset, last_offset - first_offset);
+
+    // Analyze the literal token on its own and coerce it to the template
+    // literal's type.  This reapplies type checking and value validation
+    // (e.g. date format, enum names) to the new literal.
+    std::unique_ptr<const AnalyzerOutput> literal_output;
+    ZETASQL_RETURN_IF_ERROR(AnalyzeExpressionForAssignmentToType(
+        literal_sql, options_, catalog_, type_factory_, target_type,
+        &literal_output));
+    const ResolvedExpr* literal_expr = literal_output->resolved_expr();
+    // Coercions of literals fold back into a literal; anything else means
+    // this token's value cannot be patched in directly.
+    ZETASQL_RET_CHECK_EQ(literal_expr->node_kind(), RESOLVED_LITERAL);
+    const Value& new_value = literal_expr->GetAs<ResolvedLiteral>()->value();
+    ZETASQL_RET_CHECK(new_value.type()->Equals(target_type));
+
+    for (const ResolvedLiteral* literal : group) {
+      zetasql_base::InsertOrDie(&patches, literal, new_value);
+    }
+  }
+
+  LiteralPatchingVisitor copier(&patches);
+  ZETASQL_RETURN_IF_ERROR(entry.output->resolved_statement()->Accept(&copier));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedStatement> patched_statement,
+                   copier.ConsumeRootNode<ResolvedStatement>());
+  patched_statement->ClearFieldsAccessed();
+
+  *output = std::make_shared<AnalyzerOutput>(
+      options_.id_string_pool(), options_.arena(),
+      std::unique_ptr<const ResolvedStatement>(std::move(patched_statement)),
+      entry.output->analyzer_output_properties(),
+      /*parser_output=*/nullptr, entry.output->deprecation_warnings(),
+      entry.output->undeclared_parameters(),
+      entry.output->undeclared_positional_parameters());
+  return ::zetasql_base::OkStatus();
+}
+
 static zetasql_base::Status AnalyzeStatementFromParserOutputImpl(
     std::unique_ptr<ParserOutput>* statement_parser_output,
     bool take_ownership_on_success, const AnalyzerOptions& options,
@@ -915,6 +1392,17 @@ static zetasql_base::Status AnalyzeExpressionFromParserASTImpl(
     const Type* target_type, std::unique_ptr<const AnalyzerOutput>* output) {
   std::unique_ptr<const ResolvedExpr> resolved_expr;
   Resolver resolver(catalog, type_factory, &options);
+
+  // If requested, allocate resolved AST nodes in the options' arena, which
+  // AnalyzerOutput keeps alive.  The scope also covers the target type
+  // conversion below, which may add cast nodes to the tree.
+  absl::optional<ResolvedNodeArenaScope> arena_scope;
+  if (options.allocate_resolved_ast_in_arena()) {
+    ZETASQL_RET_CHECK(options.arena() != nullptr)
+        << "allocate_resolved_ast_in_arena requires arena() to be set";
+    arena_scope.emplace(options.arena().get());
+  }
+
   ZETASQL_RETURN_IF_ERROR(resolver.ResolveStandaloneExpr(
       sql, &ast_expression, &resolved_expr));
   VLOG(3) << "Resolved AST:\n" << resolved_expr->DebugString();
@@ -925,7 +1413,7 @@ static zetasql_base::Status AnalyzeExpressionFromParserASTImpl(
                                             &resolved_expr));
   }
 
-  if (absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)) {
+  if (ShouldValidateResolvedAST(options)) {
     Validator validator(options.language_options());
     ZETASQL_RETURN_IF_ERROR(
         validator.ValidateStandaloneResolvedExpr(resolved_expr.get()));
@@ -1130,6 +1618,75 @@ zetasql_base::Status ExtractTableNamesFromNextStatement(
       options.error_message_mode(), resume_location->input(), status);
 }
 
+static zetasql_base::Status ExtractTableNamesFromAllStatementsImpl(
+    absl::string_view sql, const AnalyzerOptions& options, int max_threads,
+    TableNamesSet* table_names) {
+  ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options));
+
+  VLOG(3) << "Extracting table names from all statements in:\n" << sql;
+  std::vector<std::unique_ptr<ParserOutput>> parser_outputs;
+  ZETASQL_RETURN_IF_ERROR(ParseAllStatements(sql, max_threads, &parser_outputs));
+
+  const int num_statements = parser_outputs.size();
+  const int num_threads = std::max(1, std::min(max_threads, num_statements));
+  if (num_threads <= 1) {
+    for (const std::unique_ptr<ParserOutput>& parser_output : parser_outputs) {
+      // FindTables() clears its output set, so collect into a local set.
+      TableNamesSet statement_table_names;
+      ZETASQL_RETURN_IF_ERROR(table_name_resolver::FindTables(
+          sql, *parser_output->statement(), options, &statement_table_names));
+      table_names->insert(statement_table_names.begin(),
+                          statement_table_names.end());
+    }
+    return zetasql_base::OkStatus();
+  }
+
+  // Workers claim statement indexes with an atomic counter and collect names
+  // into per-thread sets; <options> is shared read-only.
+  std::vector<TableNamesSet> thread_table_names(num_threads);
+  std::vector<zetasql_base::Status> statement_statuses(num_statements);
+  std::atomic<int> next_statement_index(0);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int thread_index = 0; thread_index < num_threads; ++thread_index) {
+    threads.emplace_back([&, thread_index] {
+      while (true) {
+        const int statement_index = next_statement_index.fetch_add(1);
+        if (statement_index >= num_statements) break;
+        TableNamesSet statement_table_names;
+        statement_statuses[statement_index] = table_name_resolver::FindTables(
+            sql, *parser_outputs[statement_index]->statement(), options,
+            &statement_table_names);
+        thread_table_names[thread_index].insert(statement_table_names.begin(),
+                                                statement_table_names.end());
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Return the error for the earliest failing statement, if any.
+  for (const zetasql_base::Status& status : statement_statuses) {
+    ZETASQL_RETURN_IF_ERROR(status);
+  }
+  for (const TableNamesSet& names : thread_table_names) {
+    table_names->insert(names.begin(), names.end());
+  }
+  return zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ExtractTableNamesFromAllStatements(
+    absl::string_view sql, const AnalyzerOptions& options_in, int max_threads,
+    TableNamesSet* table_names) {
+  std::unique_ptr<AnalyzerOptions> copy;
+  const AnalyzerOptions& options = GetOptionsWithArenas(&options_in, &copy);
+  const zetasql_base::Status status = ExtractTableNamesFromAllStatementsImpl(
+      sql, options, max_threads, table_names);
+  return ConvertInternalErrorLocationAndAdjustErrorString(
+      options.error_message_mode(), sql, status);
+}
+
 zetasql_base::Status ExtractTableNamesFromASTStatement(
     const ASTStatement& ast_statement, const AnalyzerOptions& options_in,
     absl::string_view sql, TableNamesSet* table_names) {
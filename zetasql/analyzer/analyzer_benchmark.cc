@@ -0,0 +1,246 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for end-to-end analysis over the sample catalog, broken down
+// by phase (parse, resolve, validate), plus a scaled-up catalog with
+// thousands of tables for name-lookup-heavy workloads. Run with e.g.:
+//   bazel run -c opt //zetasql/analyzer:analyzer_benchmark
+//
+// Each benchmark reports a statements/second counter and the process peak
+// RSS, so both analyzer latency and memory regressions are visible across
+// upgrades.
+
+#include <sys/resource.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/builtin_function.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/resolved_ast/validator.h"
+#include "zetasql/testdata/sample_catalog.h"
+#include "zetasql/base/allocation_stats.h"
+#include "zetasql/base/status.h"
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+ABSL_DECLARE_FLAG(bool, zetasql_validate_resolved_ast);
+
+namespace zetasql {
+namespace {
+
+// Short OLTP-style point lookup.
+constexpr char kOltpQuery[] =
+    "SELECT Key, Value FROM KeyValue WHERE Key = 42 AND Value = 'abc'";
+
+// Join plus aggregation, like a reporting query.
+constexpr char kJoinAggregateQuery[] =
+    "SELECT t1.Value, COUNT(*) AS c "
+    "FROM KeyValue t1 JOIN KeyValue t2 ON t1.Key = t2.Key "
+    "GROUP BY t1.Value HAVING COUNT(*) > 1 ORDER BY c DESC LIMIT 10";
+
+// Returns a query with 'num_predicates' OR'ed predicates, which stresses
+// expression resolution and function signature matching.
+std::string MakeManyPredicatesQuery(int num_predicates) {
+  std::vector<std::string> predicates;
+  predicates.reserve(num_predicates);
+  for (int i = 0; i < num_predicates; ++i) {
+    predicates.push_back(absl::StrCat("(Key + ", i, " = ", i * 2, ")"));
+  }
+  return absl::StrCat("SELECT Key FROM KeyValue WHERE ",
+                      absl::StrJoin(predicates, " OR "));
+}
+
+LanguageOptions BenchmarkLanguageOptions() {
+  LanguageOptions language_options;
+  language_options.SetSupportsAllStatementKinds();
+  return language_options;
+}
+
+// Reports the process peak RSS next to the timing numbers so memory
+// regressions are visible from the same run.
+void ReportPeakRss(benchmark::State& state) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is in kilobytes on Linux.
+    state.counters["peak_rss_mb"] = usage.ru_maxrss / 1024.0;
+  }
+}
+
+// Reports per-iteration allocation counters; allocation count is an
+// early-warning signal for latency regressions.
+void ReportAllocationsPerOp(benchmark::State& state,
+                            const zetasql_base::AllocationTotals& allocated) {
+  state.counters["allocs_per_op"] = benchmark::Counter(
+      allocated.allocations, benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes_per_op"] =
+      benchmark::Counter(allocated.bytes, benchmark::Counter::kAvgIterations);
+}
+
+void ReportStatementRate(benchmark::State& state) {
+  state.counters["statements_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  ReportPeakRss(state);
+}
+
+// Parse phase only.
+void BenchmarkParsePhase(benchmark::State& state, const std::string& sql) {
+  AnalyzerOptions options(BenchmarkLanguageOptions());
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    std::unique_ptr<ParserOutput> parser_output;
+    ZETASQL_CHECK_OK(ParseStatement(sql, options.GetParserOptions(), &parser_output));
+    benchmark::DoNotOptimize(parser_output);
+  }
+  ReportStatementRate(state);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+
+// Resolve phase only: the statement is parsed once up front and the parse
+// tree is re-analyzed each iteration.  The validator is disabled so this
+// measures resolution alone.
+void BenchmarkResolvePhase(benchmark::State& state, const std::string& sql) {
+  SampleCatalog sample_catalog(BenchmarkLanguageOptions());
+  const bool saved_validate_flag =
+      absl::GetFlag(FLAGS_zetasql_validate_resolved_ast);
+  absl::SetFlag(&FLAGS_zetasql_validate_resolved_ast, false);
+
+  AnalyzerOptions base_options(BenchmarkLanguageOptions());
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_CHECK_OK(
+      ParseStatement(sql, base_options.GetParserOptions(), &parser_output));
+
+  TypeFactory type_factory;
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    // Fresh arenas per iteration, as a fresh analysis would use.
+    AnalyzerOptions options = base_options;
+    options.CreateDefaultArenasIfNotSet();
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_CHECK_OK(AnalyzeStatementFromParserOutputUnowned(
+        &parser_output, options, sql, sample_catalog.catalog(), &type_factory,
+        &output));
+    benchmark::DoNotOptimize(output);
+  }
+  absl::SetFlag(&FLAGS_zetasql_validate_resolved_ast, saved_validate_flag);
+  ReportStatementRate(state);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+
+// Validate phase only, over a statement analyzed once up front.
+void BenchmarkValidatePhase(benchmark::State& state, const std::string& sql) {
+  SampleCatalog sample_catalog(BenchmarkLanguageOptions());
+  AnalyzerOptions options(BenchmarkLanguageOptions());
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_CHECK_OK(AnalyzeStatement(sql, options, sample_catalog.catalog(),
+                            &type_factory, &output));
+
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    Validator validator(options.language_options());
+    ZETASQL_CHECK_OK(
+        validator.ValidateResolvedStatement(output->resolved_statement()));
+  }
+  ReportStatementRate(state);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+
+// End to end: parse, resolve and validate together.
+void BenchmarkAnalyzeStatement(benchmark::State& state, const std::string& sql,
+                               Catalog* catalog) {
+  AnalyzerOptions options(BenchmarkLanguageOptions());
+  TypeFactory type_factory;
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_CHECK_OK(AnalyzeStatement(sql, options, catalog, &type_factory, &output));
+    benchmark::DoNotOptimize(output);
+  }
+  ReportStatementRate(state);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+
+void BM_ParseOltp(benchmark::State& state) {
+  BenchmarkParsePhase(state, kOltpQuery);
+}
+BENCHMARK(BM_ParseOltp);
+
+void BM_ResolveOltp(benchmark::State& state) {
+  BenchmarkResolvePhase(state, kOltpQuery);
+}
+BENCHMARK(BM_ResolveOltp);
+
+void BM_ValidateOltp(benchmark::State& state) {
+  BenchmarkValidatePhase(state, kOltpQuery);
+}
+BENCHMARK(BM_ValidateOltp);
+
+void BM_AnalyzeOltp(benchmark::State& state) {
+  SampleCatalog sample_catalog(BenchmarkLanguageOptions());
+  BenchmarkAnalyzeStatement(state, kOltpQuery, sample_catalog.catalog());
+}
+BENCHMARK(BM_AnalyzeOltp);
+
+void BM_ResolveJoinAggregate(benchmark::State& state) {
+  BenchmarkResolvePhase(state, kJoinAggregateQuery);
+}
+BENCHMARK(BM_ResolveJoinAggregate);
+
+void BM_AnalyzeJoinAggregate(benchmark::State& state) {
+  SampleCatalog sample_catalog(BenchmarkLanguageOptions());
+  BenchmarkAnalyzeStatement(state, kJoinAggregateQuery,
+                            sample_catalog.catalog());
+}
+BENCHMARK(BM_AnalyzeJoinAggregate);
+
+void BM_ResolveManyPredicates(benchmark::State& state) {
+  BenchmarkResolvePhase(state, MakeManyPredicatesQuery(state.range(0)));
+}
+BENCHMARK(BM_ResolveManyPredicates)->Arg(10)->Arg(100);
+
+// Analysis against a catalog with many tables, to expose catalog lookup
+// costs that the small sample catalog hides.
+void BM_AnalyzeLargeCatalog(benchmark::State& state) {
+  const int num_tables = state.range(0);
+  TypeFactory type_factory;
+  SimpleCatalog catalog("large_catalog", &type_factory);
+  catalog.AddZetaSQLFunctions();
+  for (int i = 0; i < num_tables; ++i) {
+    catalog.AddOwnedTable(new SimpleTable(
+        absl::StrCat("Table_", i), {{"key", type_factory.get_int64()},
+                                    {"name", type_factory.get_string()},
+                                    {"value", type_factory.get_double()}}));
+  }
+  const std::string sql =
+      absl::StrCat("SELECT t.key, t.name FROM Table_", num_tables / 2,
+                   " t WHERE t.value > 0.5");
+  BenchmarkAnalyzeStatement(state, sql, &catalog);
+}
+BENCHMARK(BM_AnalyzeLargeCatalog)->Arg(100)->Arg(10000);
+
+}  // namespace
+}  // namespace zetasql
+
+BENCHMARK_MAIN();
@@ -45,6 +45,8 @@
 #include "zetasql/base/case.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/status.h"
 
@@ -500,6 +502,108 @@ TEST_F(AnalyzerOptionsTest, ErrorMessageFormat) {
           expr, options_, catalog(), &type_factory_, &output)));
 }
 
+TEST_F(AnalyzerOptionsTest, AnalysisDeadline) {
+  std::unique_ptr<const AnalyzerOutput> output;
+
+  // A deadline in the future does not affect analysis.
+  options_.set_analysis_deadline(absl::Now() + absl::Hours(1));
+  ZETASQL_EXPECT_OK(AnalyzeStatement("SELECT 1 + 2", options_, catalog(),
+                             &type_factory_, &output));
+
+  // A deadline that has already passed fails resolution promptly with a
+  // resource-exhausted error.
+  options_.set_analysis_deadline(absl::Now() - absl::Seconds(1));
+  EXPECT_THAT(AnalyzeStatement("SELECT 1 + 2", options_, catalog(),
+                               &type_factory_, &output),
+              StatusIs(zetasql_base::RESOURCE_EXHAUSTED,
+                       HasSubstr("analysis deadline")));
+
+  // The deadline bounds resolution only; parse errors are still reported
+  // as such.
+  EXPECT_THAT(AnalyzeStatement("SELECT 1 +", options_, catalog(),
+                               &type_factory_, &output),
+              StatusIs(zetasql_base::INVALID_ARGUMENT,
+                       HasSubstr("Syntax error")));
+}
+
+TEST_F(AnalyzerOptionsTest, MaxAnalysisMemoryBytes) {
+  std::unique_ptr<const AnalyzerOutput> output;
+
+  // A generous budget does not affect analysis.
+  options_.set_max_analysis_memory_bytes(64 * 1024 * 1024);
+  ZETASQL_EXPECT_OK(AnalyzeStatement("SELECT Key, Value FROM KeyValue", options_,
+                             catalog(), &type_factory_, &output));
+
+  // A tiny budget fails resolution with a resource-exhausted error instead
+  // of letting the arena grow without bound. The budget is checked against
+  // the arena, so it must be small enough that even this statement's parse
+  // tree exceeds it.
+  options_.set_max_analysis_memory_bytes(1);
+  EXPECT_THAT(AnalyzeStatement("SELECT Key, Value FROM KeyValue", options_,
+                               catalog(), &type_factory_, &output),
+              StatusIs(zetasql_base::RESOURCE_EXHAUSTED,
+                       HasSubstr("analysis memory budget")));
+}
+
+TEST_F(AnalyzerOptionsTest, PruneUnusedColumnsThroughSubqueries) {
+  std::unique_ptr<const AnalyzerOutput> output;
+  options_.set_prune_unused_columns(true);
+
+  // The subquery computes a column from Value, but the outer query only reads
+  // Key.  Pruning drops the unused computed column and, with it, the Value
+  // column, so the table scan reads a single column.
+  ZETASQL_ASSERT_OK(AnalyzeStatement(
+      "SELECT Key FROM (SELECT Key, LENGTH(Value) AS vl FROM KeyValue)",
+      options_, catalog(), &type_factory_, &output));
+
+  std::vector<const ResolvedNode*> table_scans;
+  output->resolved_statement()->GetDescendantsWithKinds({RESOLVED_TABLE_SCAN},
+                                                        &table_scans);
+  ASSERT_EQ(table_scans.size(), 1);
+  const ResolvedTableScan* table_scan =
+      table_scans.front()->GetAs<ResolvedTableScan>();
+  ASSERT_EQ(table_scan->column_list_size(), 1);
+  EXPECT_EQ(table_scan->column_list(0).name(), "Key");
+}
+
+TEST_F(AnalyzerOptionsTest, Fingerprint) {
+  AnalyzerOptions options;
+  const uint64_t base_fingerprint = options.fingerprint();
+
+  // The fingerprint is stable across calls and equal for equal options.
+  EXPECT_EQ(base_fingerprint, options.fingerprint());
+  EXPECT_EQ(base_fingerprint, AnalyzerOptions().fingerprint());
+
+  // Scalar options, declared parameters, hints and language options all
+  // change the fingerprint.
+  options.set_prune_unused_columns(true);
+  const uint64_t pruning_fingerprint = options.fingerprint();
+  EXPECT_NE(base_fingerprint, pruning_fingerprint);
+
+  ZETASQL_ASSERT_OK(options.AddQueryParameter("param", types::Int64Type()));
+  const uint64_t parameter_fingerprint = options.fingerprint();
+  EXPECT_NE(pruning_fingerprint, parameter_fingerprint);
+
+  AllowedHintsAndOptions allowed("qual");
+  allowed.AddOption("opt1", types::Int64Type());
+  options.set_allowed_hints_and_options(allowed);
+  const uint64_t hints_fingerprint = options.fingerprint();
+  EXPECT_NE(parameter_fingerprint, hints_fingerprint);
+
+  // Language option changes flow through, including through the mutable
+  // accessor.
+  options.mutable_language()->EnableLanguageFeature(
+      FEATURE_ANALYTIC_FUNCTIONS);
+  EXPECT_NE(hints_fingerprint, options.fingerprint());
+
+  // The analysis deadline and memory budget do not change analysis output,
+  // so they are deliberately excluded.
+  const uint64_t final_fingerprint = options.fingerprint();
+  options.set_analysis_deadline(absl::Now());
+  options.set_max_analysis_memory_bytes(1);
+  EXPECT_EQ(final_fingerprint, options.fingerprint());
+}
+
 // Some of these were previously dchecking because of bug 20010119.
 TEST_F(AnalyzerOptionsTest, EofErrorMessageTrailingNewlinesAndWhitespace) {
   std::unique_ptr<const AnalyzerOutput> output;
@@ -580,6 +684,58 @@ TEST_F(AnalyzerOptionsTest, LiteralReplacement) {
   EXPECT_EQ(generated_parameters["_p1_STRING"], Value::String("Yes"));
 }
 
+TEST_F(AnalyzerOptionsTest, StatementTemplateCache) {
+  StatementTemplateCache cache(options_, catalog(), &type_factory_);
+
+  std::shared_ptr<const AnalyzerOutput> output1;
+  ZETASQL_ASSERT_OK(cache.AnalyzeStatement(
+      "SELECT Key + 1 FROM KeyValue WHERE Value = 'a'", &output1));
+  EXPECT_EQ(1, cache.cache_size());
+  EXPECT_EQ(0, cache.cache_hits());
+
+  // Same shape with different literals is served by patching the cached AST.
+  std::shared_ptr<const AnalyzerOutput> output2;
+  ZETASQL_ASSERT_OK(cache.AnalyzeStatement(
+      "SELECT Key + 25 FROM KeyValue WHERE Value = 'other'", &output2));
+  EXPECT_EQ(1, cache.cache_size());
+  EXPECT_EQ(1, cache.cache_hits());
+
+  std::vector<const ResolvedNode*> literal_nodes;
+  output2->resolved_statement()->GetDescendantsWithKinds({RESOLVED_LITERAL},
+                                                         &literal_nodes);
+  std::vector<Value> literal_values;
+  for (const ResolvedNode* node : literal_nodes) {
+    literal_values.push_back(node->GetAs<ResolvedLiteral>()->value());
+  }
+  EXPECT_THAT(literal_values, testing::UnorderedElementsAre(
+                                  Value::Int64(25), Value::String("other")));
+
+  // A literal that does not coerce to the template literal's type falls back
+  // to full analysis, and does not count as a hit.
+  std::shared_ptr<const AnalyzerOutput> output3;
+  ZETASQL_ASSERT_OK(cache.AnalyzeStatement(
+      "SELECT Key + 1.5 FROM KeyValue WHERE Value = 'x'", &output3));
+  EXPECT_EQ(1, cache.cache_hits());
+
+  // A different shape gets its own cache entry.
+  std::shared_ptr<const AnalyzerOutput> output4;
+  ZETASQL_ASSERT_OK(cache.AnalyzeStatement("SELECT 'abc'", &output4));
+  EXPECT_EQ(2, cache.cache_size());
+
+  // A GROUP BY ordinal's value influences resolution beyond the literal
+  // itself, so such statements are never cached.
+  std::shared_ptr<const AnalyzerOutput> output5;
+  ZETASQL_ASSERT_OK(cache.AnalyzeStatement(
+      "SELECT Key, COUNT(*) FROM KeyValue GROUP BY 1", &output5));
+  EXPECT_EQ(2, cache.cache_size());
+
+  // Analysis errors still surface.
+  std::shared_ptr<const AnalyzerOutput> bad_output;
+  EXPECT_THAT(
+      cache.AnalyzeStatement("SELECT BadColumn FROM KeyValue", &bad_output),
+      StatusIs(_, HasSubstr("Unrecognized name: BadColumn")));
+}
+
 // Test 'option_names_to_ignore' which is a set of option names to ignore during
 // literal removal.
 TEST_F(AnalyzerOptionsTest, LiteralReplacementIgnoreWhitelistedOptions) {
@@ -778,6 +934,8 @@ TEST_F(AnalyzerOptionsTest, Deserialize) {
   proto.set_default_timezone("Asia/Shanghai");
   proto.set_strict_validation_on_column_replacements(true);
   proto.set_preserve_column_aliases(false);
+  proto.set_validation_mode(VALIDATE_SAMPLED);
+  proto.set_validation_sampling_rate(1000);
 
   auto* param = proto.add_query_parameters();
   param->set_name("q1");
@@ -890,6 +1048,8 @@ TEST_F(AnalyzerOptionsTest, Deserialize) {
   ASSERT_EQ(PARAMETER_POSITIONAL, options.parameter_mode());
   ASSERT_TRUE(options.strict_validation_on_column_replacements());
   ASSERT_FALSE(options.preserve_column_aliases());
+  ASSERT_EQ(VALIDATE_SAMPLED, options.validation_mode());
+  ASSERT_EQ(1000, options.validation_sampling_rate());
 
   ASSERT_EQ(5, options.query_parameters().size());
   ASSERT_TRUE(types::Int64Type()->Equals(options.query_parameters().at("q1")));
@@ -953,13 +1113,13 @@ TEST_F(AnalyzerOptionsTest, Deserialize) {
 }
 
 TEST_F(AnalyzerOptionsTest, ClassAndProtoSize) {
-  EXPECT_EQ(200, sizeof(AnalyzerOptions) - sizeof(LanguageOptions) -
+  EXPECT_EQ(240, sizeof(AnalyzerOptions) - sizeof(LanguageOptions) -
                      sizeof(AllowedHintsAndOptions) -
                      sizeof(Catalog::FindOptions) - sizeof(SystemVariablesMap) -
                      2 * sizeof(QueryParametersMap) - 1 * sizeof(std::string))
       << "The size of AnalyzerOptions class has changed, please also update "
       << "the proto and serialization code if you added/removed fields in it.";
-  EXPECT_EQ(17, AnalyzerOptionsProto::descriptor()->field_count())
+  EXPECT_EQ(20, AnalyzerOptionsProto::descriptor()->field_count())
       << "The number of fields in AnalyzerOptionsProto has changed, please "
       << "also update the serialization code accordingly.";
 }
@@ -970,6 +970,25 @@ zetasql_base::Status FunctionResolver::CheckCreateAggregateFunctionProperties(
   return zetasql_base::OkStatus();
 }
 
+// Returns true if the result of signature matching for <input_arguments> is
+// fully determined by the arguments' TypeKinds, making it safe to memoize by
+// TypeKind vector.  Literals, parameters and untyped arguments follow coercion
+// rules that depend on more than the argument's TypeKind, and non-simple types
+// (arrays, structs, protos, enums) are not uniquely identified by their
+// TypeKind.
+static bool ArgumentsSupportSignatureMemoization(
+    const std::vector<InputArgumentType>& input_arguments) {
+  for (const InputArgumentType& argument : input_arguments) {
+    if (argument.is_literal() || argument.is_query_parameter() ||
+        argument.is_untyped() || argument.is_relation() ||
+        argument.is_model() || argument.type() == nullptr ||
+        !argument.type()->IsSimpleType()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // TODO: Eventually we want to keep track of the closest
 // signature even if there is no match, so that we can provide a good
 // error message.  Currently, this code takes an early exit if a signature
@@ -981,6 +1000,21 @@ const FunctionSignature* FunctionResolver::FindMatchingSignature(
   std::unique_ptr<FunctionSignature> best_result_signature;
   SignatureMatchResult best_result;
 
+  const bool memoize = ArgumentsSupportSignatureMemoization(input_arguments);
+  std::vector<TypeKind> memo_key_kinds;
+  if (memoize) {
+    memo_key_kinds.reserve(input_arguments.size());
+    for (const InputArgumentType& argument : input_arguments) {
+      memo_key_kinds.push_back(argument.type()->kind());
+    }
+    const auto it =
+        signature_match_memo_.find(std::make_pair(function, memo_key_kinds));
+    if (it != signature_match_memo_.end()) {
+      return it->second == nullptr ? nullptr
+                                   : new FunctionSignature(*it->second);
+    }
+  }
+
   VLOG(6) << "FindMatchingSignature for function: "
           << function->DebugString(/*verbose=*/true) << "\n  for arguments: "
           << InputArgumentType::ArgumentsToString(
@@ -1026,6 +1060,14 @@ const FunctionSignature* FunctionResolver::FindMatchingSignature(
       }
     }
   }
+
+  if (memoize) {
+    signature_match_memo_.emplace(
+        std::make_pair(function, std::move(memo_key_kinds)),
+        best_result_signature == nullptr
+            ? nullptr
+            : absl::make_unique<FunctionSignature>(*best_result_signature));
+  }
   return best_result_signature.release();
 }
 
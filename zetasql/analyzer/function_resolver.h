@@ -22,8 +22,10 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "zetasql/analyzer/expr_resolver_helper.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/public/catalog.h"
@@ -179,6 +181,18 @@ class FunctionResolver {
   TypeFactory* type_factory_;  // Not owned.
   Resolver* resolver_;         // Not owned.
 
+  // Memo of FindMatchingSignature() results keyed by (function, argument
+  // TypeKind vector).  Only consulted when every argument is a non-literal,
+  // non-parameter expression of a simple type, so that the TypeKind vector
+  // fully determines the matching outcome.  This lets ubiquitous operators
+  // ($equal, $add, $and, ...) with already-seen argument types resolve with
+  // one hash lookup instead of re-running coercion checks against every
+  // signature.  A null value records that no signature matched.  Mutable
+  // because FindMatchingSignature() is const.
+  mutable absl::flat_hash_map<std::pair<const Function*, std::vector<TypeKind>>,
+                              std::unique_ptr<FunctionSignature>>
+      signature_match_memo_;
+
   // Represents the argument types corresponding to a SignatureArgumentKind.
   // There are three possibilities:
   // 1) The object represents an untyped NULL.
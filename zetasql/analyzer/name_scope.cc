@@ -156,6 +156,7 @@ bool NameScope::IsEmpty() const {
 void NameScope::CopyStateFrom(const NameScope& other) {
   // This does CopyOnWrite.
   state_ = other.state_;
+  lookup_cache_.clear();
 }
 
 void NameScope::AddNameTarget(IdString name, const NameTarget& target) {
@@ -218,6 +219,41 @@ bool NameScope::LookupName(
     correlated_columns_sets->clear();
   }
 
+  if (previous_scope_ == nullptr) {
+    // Single-scope lookups are already cheap; don't bother caching them.
+    // This also avoids cache churn on NameLists under construction, whose
+    // internal NameScopes interleave insertions and lookups.
+    const NameScope* found_scope;
+    return LookupNameUncached(name, found, &found_scope);
+  }
+
+  const CachedLookupResult* cached =
+      zetasql_base::FindOrNull(lookup_cache_, name);
+  if (cached == nullptr) {
+    CachedLookupResult new_entry;
+    new_entry.found =
+        LookupNameUncached(name, &new_entry.target, &new_entry.found_scope);
+    cached = &lookup_cache_.emplace(name, new_entry).first->second;
+  }
+  *found = cached->target;
+
+  // If we are collecting correlated_columns_sets and this was a correlated
+  // lookup, traverse from <this> to the defining scope, collecting all
+  // non-NULL correlated_columns_set_ pointers we pass.
+  if (cached->found && !cached->target.IsAmbiguous() &&
+      correlated_columns_sets != nullptr && cached->found_scope != this) {
+    for (const NameScope* scope = this; scope != cached->found_scope;
+         scope = scope->previous_scope_) {
+      if (scope->correlated_columns_set_ != nullptr) {
+        correlated_columns_sets->push_back(scope->correlated_columns_set_);
+      }
+    }
+  }
+  return cached->found;
+}
+
+bool NameScope::LookupNameUncached(IdString name, NameTarget* found,
+                                   const NameScope** found_scope) const {
   const NameScope* current = this;
   while (current != nullptr) {
     // Look for any matching names stored directly in this NameScope.
@@ -235,6 +271,7 @@ bool NameScope::LookupName(
         case Type::HAS_PSEUDO_FIELD:
           if (tmp != nullptr) {
             found->SetAmbiguous();
+            *found_scope = current;
             return true;
           } else {
             tmp = &field_target;
@@ -242,27 +279,14 @@ bool NameScope::LookupName(
           break;
         case Type::HAS_AMBIGUOUS_FIELD:
           found->SetAmbiguous();
+          *found_scope = current;
           return true;
       }
     }
 
     if (tmp != nullptr) {
       *found = *tmp;
-
-      // If we are collecting correlated_columns_sets and this was a correlated
-      // lookup, traverse from <this> to <current> again, collecting all
-      // non-NULL correlated_columns_set_ pointers we pass.
-      if (!tmp->IsAmbiguous() && correlated_columns_sets != nullptr
-          && current != this) {
-        const NameScope* scope = this;
-        while (scope != current) {
-          if (scope->correlated_columns_set_ != nullptr) {
-            correlated_columns_sets->push_back(scope->correlated_columns_set_);
-          }
-          scope = scope->previous_scope_;
-        }
-      }
-
+      *found_scope = current;
       return true;
     }
     current = current->previous_scope_;
@@ -270,6 +294,7 @@ bool NameScope::LookupName(
 
   // We didn't find anything.
   found->SetAmbiguous();
+  *found_scope = nullptr;
   return false;
 }
 
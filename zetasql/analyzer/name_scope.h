@@ -828,17 +828,47 @@ class NameScope {
   };
   State state_;
 
+  // A memoized LookupName() outcome for this scope, including names found in
+  // previous scopes.  <found_scope> records which scope in the chain supplied
+  // the target, so correlated columns sets can be re-collected on cache hits
+  // (they depend on the scopes between this scope and the defining scope, not
+  // on the caller).
+  struct CachedLookupResult {
+    bool found = false;
+    const NameScope* found_scope = nullptr;
+    NameTarget target;
+  };
+
+  // Lazily built cache of LookupName() results, used only for scopes with a
+  // fallback scope (single-scope lookups are already one hash probe).  Wide
+  // SELECT lists resolve the same column names against the same scope chain
+  // repeatedly; without this, each reference walks every scope in the chain.
+  // Cleared whenever the local names change (see mutable_names() below); new
+  // scopes pushed on top of this one have their own empty caches.
+  // Mutable because LookupName() is const.
+  mutable IdStringHashMapCase<CachedLookupResult> lookup_cache_;
+
+  // Implements the scope chain walk for LookupName(), bypassing
+  // <lookup_cache_>.  Returns the scope that supplied <found> in
+  // <found_scope> (or NULL if the name was not found).
+  bool LookupNameUncached(IdString name, NameTarget* found,
+                          const NameScope** found_scope) const;
+
   // Accessors for fields inside the CopyOnWrite state_.
+  // The mutable accessors clear <lookup_cache_> since cached lookups may
+  // depend on the local names.
   const IdStringHashMapCase<NameTarget>& names() const {
     return state_.names;
   }
   IdStringHashMapCase<NameTarget>* mutable_names() {
+    lookup_cache_.clear();
     return &state_.names;
   }
   const std::vector<ValueTableColumn>& value_table_columns() const {
     return state_.value_table_columns;
   }
   std::vector<ValueTableColumn>* mutable_value_table_columns() {
+    lookup_cache_.clear();
     return &state_.value_table_columns;
   }
 
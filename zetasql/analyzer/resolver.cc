@@ -50,8 +50,10 @@
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "absl/memory/memory.h"
 #include "zetasql/base/case.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/ret_check.h"
@@ -89,6 +91,7 @@ void Resolver::Reset(absl::string_view sql) {
   next_subquery_id_ = 1;
   next_unnest_id_ = 1;
   analyzing_expression_ = false;
+  limits_check_countdown_ = 0;
   analyzing_partition_by_clause_name_ = nullptr;
   disallowing_query_parameters_with_error_ = nullptr;
   // generated_column_cycle_detector_ contains a pointer to a local object, so
@@ -101,6 +104,10 @@ void Resolver::Reset(absl::string_view sql) {
   function_arguments_.clear();
   function_table_arguments_.clear();
   resolved_columns_from_table_scans_.clear();
+  // find_table_memo_ and find_function_memo_ are intentionally not cleared;
+  // catalog contents are expected to be stable for the lifetime of a
+  // Resolver, and preserving the memos lets AnalyzerSessions amortize
+  // catalog lookups across statements.
 
   if (analyzer_options_.column_id_sequence_number() != nullptr) {
     next_column_id_sequence_ = analyzer_options_.column_id_sequence_number();
@@ -110,6 +117,41 @@ void Resolver::Reset(absl::string_view sql) {
   }
 }
 
+// With deeply nested statements a recursion boundary is hit every few AST
+// nodes, so examining the limits once per this many calls detects an
+// exceeded limit promptly while keeping the amortized cost of
+// CheckAnalysisLimits() to a single comparison.
+static const int kLimitsCheckInterval = 512;
+
+zetasql_base::Status Resolver::CheckAnalysisLimits() {
+  const absl::Time deadline = analyzer_options_.analysis_deadline();
+  const int64_t max_memory_bytes =
+      analyzer_options_.max_analysis_memory_bytes();
+  if (deadline == absl::InfiniteFuture() &&
+      max_memory_bytes == std::numeric_limits<int64_t>::max()) {
+    return ::zetasql_base::OkStatus();
+  }
+  if (--limits_check_countdown_ > 0) return ::zetasql_base::OkStatus();
+  limits_check_countdown_ = kLimitsCheckInterval;
+  if (absl::Now() >= deadline) {
+    return ::zetasql_base::ResourceExhaustedErrorBuilder()
+           << "Analysis was aborted because the analysis deadline ("
+           << absl::FormatTime(deadline, absl::UTCTimeZone())
+           << ") was exceeded";
+  }
+  if (analyzer_options_.arena() != nullptr) {
+    const int64_t allocated_bytes =
+        analyzer_options_.arena()->status().bytes_allocated();
+    if (allocated_bytes > max_memory_bytes) {
+      return ::zetasql_base::ResourceExhaustedErrorBuilder()
+             << "Analysis was aborted because the analysis memory budget ("
+             << max_memory_bytes << " bytes) was exceeded: " << allocated_bytes
+             << " bytes allocated";
+    }
+  }
+  return ::zetasql_base::OkStatus();
+}
+
 int Resolver::AllocateColumnId() {
   int64_t id = next_column_id_sequence_->GetNext();
   if (id == 0) {  // Avoid using column_id 0.
@@ -992,6 +1034,143 @@ zetasql_base::Status Resolver::SetColumnAccessList(ResolvedStatement* statement)
   return ::zetasql_base::OkStatus();
 }
 
+// Adds to 'used_columns' every column the tree under 'node' actually depends
+// on: columns referenced from expressions, columns named in output and DML
+// column lists, and columns in lists that are positional and so cannot be
+// pruned independently (set operations and WITH references).  Scan
+// column_lists are what pruning trims, so they never count as uses by
+// themselves.  A computed column normally keeps the column it defines, since
+// visitors like the SQLBuilder only reach its expression while the defining
+// entry is in the tree, but columns in 'droppable_definitions' are ones
+// PruneColumnLists can drop together with their expressions, so their
+// definitions do not count as uses.
+static void CollectColumnUses(
+    const ResolvedNode* node,
+    const std::set<ResolvedColumn>& droppable_definitions,
+    std::set<ResolvedColumn>* used_columns) {
+  std::vector<ResolvedNode::PreorderNode> traversal;
+  node->GetPreorderTraversal(&traversal);
+  for (const ResolvedNode::PreorderNode& entry : traversal) {
+    switch (entry.kind) {
+      case RESOLVED_COLUMN_REF:
+        used_columns->insert(entry.node->GetAs<ResolvedColumnRef>()->column());
+        break;
+      case RESOLVED_COMPUTED_COLUMN: {
+        const ResolvedColumn& column =
+            entry.node->GetAs<ResolvedComputedColumn>()->column();
+        if (!zetasql_base::ContainsKey(droppable_definitions, column)) {
+          used_columns->insert(column);
+        }
+        break;
+      }
+      case RESOLVED_OUTPUT_COLUMN:
+        used_columns->insert(
+            entry.node->GetAs<ResolvedOutputColumn>()->column());
+        break;
+      case RESOLVED_COLUMN_HOLDER:
+        used_columns->insert(
+            entry.node->GetAs<ResolvedColumnHolder>()->column());
+        break;
+      case RESOLVED_COLUMN_DEFINITION:
+        used_columns->insert(
+            entry.node->GetAs<ResolvedColumnDefinition>()->column());
+        break;
+      case RESOLVED_ARRAY_SCAN:
+        used_columns->insert(
+            entry.node->GetAs<ResolvedArrayScan>()->element_column());
+        break;
+      case RESOLVED_UNNEST_ITEM:
+        used_columns->insert(
+            entry.node->GetAs<ResolvedUnnestItem>()->element_column());
+        break;
+      case RESOLVED_SET_OPERATION_SCAN:
+        // The scan's column_list matches position-wise with the
+        // output_column_list on each input item, so none of its columns can
+        // be pruned individually.
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedScan>()->column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_SET_OPERATION_ITEM:
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedSetOperationItem>()
+                     ->output_column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_WITH_REF_SCAN:
+        // The column_list here must match 1:1 with the column_list on the
+        // WITH subquery, so we keep both sides in full.
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedScan>()->column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_WITH_ENTRY:
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedWithEntry>()
+                     ->with_subquery()->column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_TVFARGUMENT:
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedTVFArgument>()
+                     ->argument_column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_INSERT_STMT: {
+        const ResolvedInsertStmt* insert_stmt =
+            entry.node->GetAs<ResolvedInsertStmt>();
+        for (const ResolvedColumn& column : insert_stmt->insert_column_list()) {
+          used_columns->insert(column);
+        }
+        for (const ResolvedColumn& column :
+                 insert_stmt->query_output_column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      }
+      case RESOLVED_MERGE_WHEN:
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedMergeWhen>()->insert_column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      case RESOLVED_CREATE_TABLE_STMT:
+      case RESOLVED_CREATE_TABLE_AS_SELECT_STMT:
+        for (const ResolvedColumn& column :
+                 entry.node->GetAs<ResolvedCreateTableStmtBase>()
+                     ->pseudo_column_list()) {
+          used_columns->insert(column);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// Removes the entries of '*computed_columns' whose defined column is not in
+// 'used_columns'.  Returns true if any entry was removed.
+static bool DropUnusedComputedColumns(
+    const std::set<ResolvedColumn>& used_columns,
+    std::vector<std::unique_ptr<const ResolvedComputedColumn>>*
+        computed_columns) {
+  const size_t original_size = computed_columns->size();
+  computed_columns->erase(
+      std::remove_if(
+          computed_columns->begin(), computed_columns->end(),
+          [&used_columns](
+              const std::unique_ptr<const ResolvedComputedColumn>& column) {
+            return !zetasql_base::ContainsKey(used_columns, column->column());
+          }),
+      computed_columns->end());
+  return computed_columns->size() != original_size;
+}
+
 zetasql_base::Status Resolver::PruneColumnLists(const ResolvedNode* node) const {
   if (!analyzer_options_.prune_unused_columns()) {
     return ::zetasql_base::OkStatus();
@@ -1009,6 +1188,65 @@ zetasql_base::Status Resolver::PruneColumnLists(const ResolvedNode* node) const
   std::vector<const ResolvedNode*> scan_nodes;
   node->GetDescendantsSatisfying(&ResolvedNode::IsScan, &scan_nodes);
 
+  // Before pruning column_lists, drop computed columns that nothing in the
+  // tree reads.  Columns produced in a SELECT list are always recorded in
+  // referenced_column_access_, even when the enclosing query ignores them
+  // (see ResolveSelect), so without this step an unused expression and all
+  // the columns it reads keep flowing through the interior scans.  Dropping
+  // an expression can orphan the columns it was reading, so repeat until no
+  // more entries drop.
+  std::set<ResolvedColumn> used_columns;
+  while (true) {
+    std::set<ResolvedColumn> droppable_definitions;
+    for (const ResolvedNode* scan_node : scan_nodes) {
+      if (scan_node->node_kind() == RESOLVED_PROJECT_SCAN) {
+        for (const auto& computed_column :
+                 scan_node->GetAs<ResolvedProjectScan>()->expr_list()) {
+          droppable_definitions.insert(computed_column->column());
+        }
+      } else if (scan_node->node_kind() == RESOLVED_AGGREGATE_SCAN) {
+        // Only the aggregate_list is droppable; dropping a group_by_list
+        // entry would change the cardinality of the scan.
+        for (const auto& computed_column :
+                 scan_node->GetAs<ResolvedAggregateScan>()->aggregate_list()) {
+          droppable_definitions.insert(computed_column->column());
+        }
+      }
+    }
+
+    used_columns.clear();
+    CollectColumnUses(node, droppable_definitions, &used_columns);
+
+    bool dropped_computed_columns = false;
+    for (const ResolvedNode* scan_node : scan_nodes) {
+      // As with the column_list updates below, we use const_cast to mutate
+      // the scans because this runs after all resolving, before ownership
+      // transfers to the caller.
+      if (scan_node->node_kind() == RESOLVED_PROJECT_SCAN) {
+        ResolvedProjectScan* project_scan = const_cast<ResolvedProjectScan*>(
+            scan_node->GetAs<ResolvedProjectScan>());
+        auto expr_list = project_scan->release_expr_list();
+        dropped_computed_columns |=
+            DropUnusedComputedColumns(used_columns, &expr_list);
+        project_scan->set_expr_list(std::move(expr_list));
+      } else if (scan_node->node_kind() == RESOLVED_AGGREGATE_SCAN) {
+        ResolvedAggregateScan* aggregate_scan =
+            const_cast<ResolvedAggregateScan*>(
+                scan_node->GetAs<ResolvedAggregateScan>());
+        auto aggregate_list = aggregate_scan->release_aggregate_list();
+        dropped_computed_columns |=
+            DropUnusedComputedColumns(used_columns, &aggregate_list);
+        aggregate_scan->set_aggregate_list(std::move(aggregate_list));
+      }
+    }
+    if (!dropped_computed_columns) break;
+
+    // The dropped expressions may have contained subqueries, so 'scan_nodes'
+    // can now include freed nodes.  Re-collect before using it again.
+    scan_nodes.clear();
+    node->GetDescendantsSatisfying(&ResolvedNode::IsScan, &scan_nodes);
+  }
+
   std::vector<ResolvedColumn> pruned_column_list;
   std::vector<int> pruned_column_index_list;
   for (const ResolvedNode* scan_node : scan_nodes) {
@@ -1026,7 +1264,8 @@ zetasql_base::Status Resolver::PruneColumnLists(const ResolvedNode* node) const
     pruned_column_index_list.clear();
     for (int i = 0; i < scan->column_list().size(); ++i) {
       const ResolvedColumn& column = scan->column_list(i);
-      if (zetasql_base::ContainsKey(referenced_column_access_, column)) {
+      if (zetasql_base::ContainsKey(referenced_column_access_, column) &&
+          zetasql_base::ContainsKey(used_columns, column)) {
         pruned_column_list.push_back(column);
         if (has_column_index_list) {
           const int column_index = table_scan->column_index_list(i);
@@ -1051,13 +1290,49 @@ zetasql_base::Status Resolver::PruneColumnLists(const ResolvedNode* node) const
   return ::zetasql_base::OkStatus();
 }
 
+std::string Resolver::MakeCatalogMemoKey(absl::Span<const std::string> path) {
+  std::string key;
+  for (const std::string& name : path) {
+    absl::StrAppend(&key, name.size(), ":", absl::AsciiStrToLower(name));
+  }
+  return key;
+}
+
+zetasql_base::Status Resolver::FindTableFromCatalog(
+    absl::Span<const std::string> path, const Table** table) const {
+  std::string key = MakeCatalogMemoKey(path);
+  const Table** cached = zetasql_base::FindOrNull(find_table_memo_, key);
+  if (cached != nullptr) {
+    *table = *cached;
+    return ::zetasql_base::OkStatus();
+  }
+  ZETASQL_RETURN_IF_ERROR(
+      catalog_->FindTable(path, table, analyzer_options_.find_options()));
+  zetasql_base::InsertOrDie(&find_table_memo_, std::move(key), *table);
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status Resolver::FindFunctionFromCatalog(
+    absl::Span<const std::string> path, const Function** function) const {
+  std::string key = MakeCatalogMemoKey(path);
+  const Function** cached = zetasql_base::FindOrNull(find_function_memo_, key);
+  if (cached != nullptr) {
+    *function = *cached;
+    return ::zetasql_base::OkStatus();
+  }
+  ZETASQL_RETURN_IF_ERROR(
+      catalog_->FindFunction(path, function, analyzer_options_.find_options()));
+  zetasql_base::InsertOrDie(&find_function_memo_, std::move(key), *function);
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status Resolver::FindTable(
     const ASTPathExpression* name, const Table** table) {
   ZETASQL_RET_CHECK(name != nullptr);
   ZETASQL_RET_CHECK(table != nullptr);
 
-  zetasql_base::Status status = catalog_->FindTable(
-      name->ToIdentifierVector(), table, analyzer_options_.find_options());
+  zetasql_base::Status status =
+      FindTableFromCatalog(name->ToIdentifierVector(), table);
   if (status.code() == zetasql_base::StatusCode::kNotFound) {
     std::string message;
     absl::StrAppend(
@@ -267,6 +267,10 @@ class Resolver {
   // Next unique unnest ID to allocate. Used for display only.
   int next_unnest_id_;
 
+  // Counts down the recursion-boundary calls remaining before
+  // CheckAnalysisLimits() next examines the deadline and memory budget.
+  int limits_check_countdown_ = 0;
+
   // True if we are analyzing a standalone expression rather than a statement.
   bool analyzing_expression_;
 
@@ -405,6 +409,19 @@ class Resolver {
   // ResolvedLiterals without a cached image.
   int next_float_literal_image_id_ = 1;
 
+  // Memo of successful Catalog::FindTable/FindFunction lookups, keyed by the
+  // lowercased name path (name resolution is case-insensitive, so different
+  // spellings of the same path share one entry).  The same path is commonly
+  // looked up many times within one statement (self-joins, subqueries,
+  // repeated function calls), which is expensive with Catalog implementations
+  // backed by a remote service.  Only successful lookups are memoized so that
+  // each call site still produces its own error message on failure.  Mutable
+  // because lookups also happen from const methods like
+  // LookupFunctionFromCatalog().  Kept across Reset() calls — catalog
+  // contents are expected to be stable for the lifetime of a Resolver.
+  mutable absl::flat_hash_map<std::string, const Table*> find_table_memo_;
+  mutable absl::flat_hash_map<std::string, const Function*> find_function_memo_;
+
   // Resolve the Type from the <type_name> without resetting the state.
   zetasql_base::Status ResolveTypeNameInternal(const std::string& type_name,
                                        const Type** type);
@@ -2089,6 +2106,15 @@ class Resolver {
       ExprResolutionInfo* parent_expr_resolution_info,
       std::unique_ptr<const ResolvedExpr>* resolved_expr_out);
 
+  // Returns a resource-exhausted error if the analysis_deadline() in
+  // AnalyzerOptions has passed or the bytes allocated in its arena() exceed
+  // max_analysis_memory_bytes(), and OK otherwise. Called at recursion
+  // boundaries (ResolveExpr(), ResolveQuery()) so that a pathological
+  // statement fails promptly instead of consuming unbounded CPU or memory.
+  // The check is amortized: the limits are only examined once per several
+  // hundred calls, so the common path is a single comparison.
+  zetasql_base::Status CheckAnalysisLimits();
+
   // Resolve a literal expression. Requires ast_expr->node_kind() to be one of
   // AST_*_LITERAL.
   zetasql_base::Status ResolveLiteralExpr(
@@ -2900,6 +2926,19 @@ class Resolver {
   // found.
   zetasql_base::Status FindTable(const ASTPathExpression* name, const Table** table);
 
+  // Wrappers around Catalog::FindTable/FindFunction that consult and populate
+  // the per-statement memo of successful lookups (see find_table_memo_).
+  // All catalog table and function lookups in the resolver should go through
+  // these rather than calling the Catalog directly.
+  zetasql_base::Status FindTableFromCatalog(absl::Span<const std::string> path,
+                                    const Table** table) const;
+  zetasql_base::Status FindFunctionFromCatalog(absl::Span<const std::string> path,
+                                       const Function** function) const;
+
+  // Returns the memo key for a catalog <path>: the lowercased names, each
+  // preceded by its length so that no two distinct paths share a key.
+  static std::string MakeCatalogMemoKey(absl::Span<const std::string> path);
+
   // Attempts to find a column in <table> by <name>. Sets <index> to -1 if not
   // found; otherwise, sets it to the first column found, starting at index 0.
   // Sets <duplicate> to true if two or more were found.
@@ -441,8 +441,10 @@ zetasql_base::StatusOr<const google::protobuf::Descriptor*> Resolver::FindMessag
   }
 
   const Type* found_type = nullptr;
-  const zetasql_base::Status find_type_status = catalog_->FindType(
-      type_name_path, &found_type, analyzer_options_.find_options());
+  Catalog::FindOptions find_options = analyzer_options_.find_options();
+  find_options.set_speculative(true);
+  const zetasql_base::Status find_type_status =
+      catalog_->FindType(type_name_path, &found_type, find_options);
   if (find_type_status.code() == zetasql_base::StatusCode::kNotFound) {
     // We don't give an error if it wasn't found.  That will happen in
     // the caller so it has a chance to try generating a better error.
@@ -572,6 +574,7 @@ zetasql_base::Status Resolver::ResolveExpr(
     ExprResolutionInfo* parent_expr_resolution_info,
     std::unique_ptr<const ResolvedExpr>* resolved_expr_out) {
   DCHECK(parent_expr_resolution_info != nullptr);
+  ZETASQL_RETURN_IF_ERROR(CheckAnalysisLimits());
 
   // Use a separate ExprAggregationInfo for the child because we don't
   // want it to observe <has_aggregation> or <has_analytic> from a sibling.
@@ -1226,10 +1229,15 @@ zetasql_base::Status Resolver::ResolvePathExpressionAsExpression(
     // (4) We still haven't found a matching name. Try to resolve the longest
     // possible prefix of <path_expr> to a named constant.
     const Constant* constant = nullptr;
+    // This lookup is speculative: every path expression that did not resolve
+    // to another name gets probed here, and nearly all of those probes miss,
+    // so skip building NOT_FOUND messages that are never read.
+    Catalog::FindOptions find_options = analyzer_options_.find_options();
+    find_options.set_speculative(true);
     zetasql_base::Status find_constant_with_path_prefix_status =
         catalog_->FindConstantWithPathPrefix(path_expr->ToIdentifierVector(),
                                              &num_names_consumed, &constant,
-                                             analyzer_options_.find_options());
+                                             find_options);
 
     // Handle the case where a constant was found or some internal error
     // occurred. If no constant was found, <num_names_consumed> is set to 0.
@@ -1416,18 +1424,19 @@ zetasql_base::Status Resolver::MaybeResolveProtoFieldAccess(
   const std::string dot_name = identifier->GetAsString();
 
   ZETASQL_RET_CHECK(resolved_lhs->type()->IsProto());
-  const google::protobuf::Descriptor* lhs_proto =
-      resolved_lhs->type()->AsProto()->descriptor();
-  ZETASQL_ASSIGN_OR_RETURN(const google::protobuf::FieldDescriptor* field,
-                   FindFieldDescriptor(identifier, lhs_proto, dot_name));
+  const ProtoType* lhs_proto_type = resolved_lhs->type()->AsProto();
+  const google::protobuf::Descriptor* lhs_proto = lhs_proto_type->descriptor();
+  // Use the lookup on the ProtoType, which indexes the field names, rather
+  // than the linear scan done by the static descriptor-based lookup.
+  const google::protobuf::FieldDescriptor* field =
+      lhs_proto_type->FindFieldByNameIgnoreCase(dot_name);
   bool get_has_bit = false;
   if (options.get_has_bit_override) {
     get_has_bit = *options.get_has_bit_override;
   } else if (absl::StartsWithIgnoreCase(dot_name, "has_")) {
     const std::string dot_name_without_has = dot_name.substr(4);
-    ZETASQL_ASSIGN_OR_RETURN(
-        const google::protobuf::FieldDescriptor* has_field,
-        FindFieldDescriptor(identifier, lhs_proto, dot_name_without_has));
+    const google::protobuf::FieldDescriptor* has_field =
+        lhs_proto_type->FindFieldByNameIgnoreCase(dot_name_without_has);
     if (has_field != nullptr) {
       if (field != nullptr) {
         // Give an error if we asked for has_X and the proto has fields
@@ -2094,10 +2103,12 @@ zetasql_base::Status Resolver::ResolveSystemVariableExpression(
 
   int num_names_consumed = 0;
   const Constant* constant = nullptr;
+  // The lookup is speculative; we generate our own error on a miss below.
+  Catalog::FindOptions find_options = analyzer_options_.find_options();
+  find_options.set_speculative(true);
   zetasql_base::Status find_constant_with_path_prefix_status =
       system_variables_catalog->FindConstantWithPathPrefix(
-          path_parts, &num_names_consumed, &constant,
-          analyzer_options_.find_options());
+          path_parts, &num_names_consumed, &constant, find_options);
 
   if (find_constant_with_path_prefix_status.code() ==
       zetasql_base::StatusCode::kNotFound) {
@@ -2351,39 +2362,67 @@ zetasql_base::Status Resolver::ResolveBinaryExpr(
     ExprResolutionInfo* expr_resolution_info,
     std::unique_ptr<const ResolvedExpr>* resolved_expr_out) {
 
-  std::unique_ptr<const ResolvedExpr> resolved_binary_expr;
-  // Special case to handle IS operator. Based on the rhs_ resolved type (i.e.
-  // true/false/NULL), the general function name is resolved to
-  // $is_true/$is_false/$is_null respectively with lhs_ as an argument.
-  if (binary_expr->op() == ASTBinaryExpression::IS) {
-    const std::string& function_name =
-        IsOperatorToFunctionName(binary_expr->rhs());
-    ZETASQL_RETURN_IF_ERROR(ResolveFunctionCallByNameWithoutAggregatePropertyCheck(
-        binary_expr, function_name, { binary_expr->lhs() },
-        *kEmptyArgumentOptionMap, expr_resolution_info,
-        &resolved_binary_expr));
-  } else {
-    const std::string& function_name =
-        FunctionResolver::BinaryOperatorToFunctionName(binary_expr->op());
-    ZETASQL_RETURN_IF_ERROR(ResolveFunctionCallByNameWithoutAggregatePropertyCheck(
-        binary_expr, function_name,
-        { binary_expr->lhs(), binary_expr->rhs() },
-        *kEmptyArgumentOptionMap, expr_resolution_info,
-        &resolved_binary_expr));
-
-    // Give an error on literal NULL arguments to any binary expression
-    // except IS.
-    ZETASQL_RETURN_IF_ERROR(ReturnErrorOnLiteralNullArg(
-        binary_expr->GetSQLForOperator(),
-        {binary_expr->lhs(), binary_expr->rhs()}, resolved_binary_expr.get()));
+  // Binary operators are left-associative, so a chain like 'a+b+c+...' parses
+  // as a tree that nests arbitrarily deeply down the lhs. Resolving the lhs
+  // through ResolveExpr() would use one C++ stack frame per operator, which
+  // forces large thread stacks for worst-case inputs. Instead, collect the
+  // lhs chain and resolve it bottom-up with an explicit loop so that the
+  // recursion depth is independent of the chain length.
+  std::vector<const ASTBinaryExpression*> chain = {binary_expr};
+  while (chain.back()->lhs()->node_kind() == AST_BINARY_EXPRESSION) {
+    chain.push_back(chain.back()->lhs()->GetAsOrDie<ASTBinaryExpression>());
   }
 
-  if (binary_expr->is_not()) {
-    return MakeNotExpr(binary_expr, std::move(resolved_binary_expr),
-                       expr_resolution_info, resolved_expr_out);
+  // The deepest lhs is the only expression resolved recursively.
+  std::unique_ptr<const ResolvedExpr> resolved_lhs;
+  ZETASQL_RETURN_IF_ERROR(
+      ResolveExpr(chain.back()->lhs(), expr_resolution_info, &resolved_lhs));
+
+  while (!chain.empty()) {
+    const ASTBinaryExpression* expr = chain.back();
+    chain.pop_back();
+
+    std::unique_ptr<const ResolvedExpr> resolved_binary_expr;
+    std::vector<std::unique_ptr<const ResolvedExpr>> resolved_arguments;
+    resolved_arguments.push_back(std::move(resolved_lhs));
+    // Special case to handle IS operator. Based on the rhs_ resolved type
+    // (i.e. true/false/NULL), the general function name is resolved to
+    // $is_true/$is_false/$is_null respectively with lhs_ as an argument.
+    if (expr->op() == ASTBinaryExpression::IS) {
+      const std::string& function_name = IsOperatorToFunctionName(expr->rhs());
+      ZETASQL_RETURN_IF_ERROR(ResolveFunctionCallWithResolvedArguments(
+          expr, /*arg_locations=*/{expr->lhs()}, function_name,
+          std::move(resolved_arguments), expr_resolution_info,
+          &resolved_binary_expr));
+    } else {
+      const std::string& function_name =
+          FunctionResolver::BinaryOperatorToFunctionName(expr->op());
+      ZETASQL_RETURN_IF_ERROR(ResolveExpressionArgument(
+          expr->rhs(), expr_resolution_info, &resolved_arguments));
+      ZETASQL_RETURN_IF_ERROR(ResolveFunctionCallWithResolvedArguments(
+          expr, /*arg_locations=*/{expr->lhs(), expr->rhs()}, function_name,
+          std::move(resolved_arguments), expr_resolution_info,
+          &resolved_binary_expr));
+
+      // Give an error on literal NULL arguments to any binary expression
+      // except IS.
+      ZETASQL_RETURN_IF_ERROR(ReturnErrorOnLiteralNullArg(
+          expr->GetSQLForOperator(), {expr->lhs(), expr->rhs()},
+          resolved_binary_expr.get()));
+    }
+
+    if (expr->is_not()) {
+      ZETASQL_RETURN_IF_ERROR(MakeNotExpr(expr, std::move(resolved_binary_expr),
+                                  expr_resolution_info,
+                                  &resolved_binary_expr));
+    }
+
+    // The result becomes the lhs of the next (enclosing) operator in the
+    // chain.
+    resolved_lhs = std::move(resolved_binary_expr);
   }
 
-  *resolved_expr_out = std::move(resolved_binary_expr);
+  *resolved_expr_out = std::move(resolved_lhs);
   return ::zetasql_base::OkStatus();
 }
 
@@ -5028,8 +5067,7 @@ zetasql_base::Status Resolver::LookupFunctionFromCatalog(
 
     stripped_name.remove_prefix(1);
     is_stripped = true;
-    find_status = catalog_->FindFunction(stripped_name, function,
-                                         analyzer_options_.find_options());
+    find_status = FindFunctionFromCatalog(stripped_name, function);
     if (find_status.ok()) {
       if (!(*function)->SupportsSafeErrorMode()) {
         return MakeSqlErrorAt(ast_location)
@@ -5039,8 +5077,7 @@ zetasql_base::Status Resolver::LookupFunctionFromCatalog(
       *error_mode = ResolvedFunctionCallBase::SAFE_ERROR_MODE;
     }
   } else {
-    find_status = catalog_->FindFunction(function_name_path, function,
-                                         analyzer_options_.find_options());
+    find_status = FindFunctionFromCatalog(function_name_path, function);
   }
 
   bool function_lookup_succeeded = find_status.ok();
@@ -146,6 +146,7 @@ zetasql_base::Status Resolver::ResolveQuery(
     bool is_outer_query,
     std::unique_ptr<const ResolvedScan>* output,
     std::shared_ptr<const NameList>* output_name_list) {
+  ZETASQL_RETURN_IF_ERROR(CheckAnalysisLimits());
 
   std::vector<std::unique_ptr<const ResolvedWithEntry>> with_entries;
 
@@ -5182,8 +5183,7 @@ zetasql_base::StatusOr<Resolver::ResolvedTVFArgType> Resolver::ResolveTVFArg(
       } else if (table_path->num_names() == 1 &&
                  zetasql_base::ContainsKey(function_table_arguments_,
                                   table_path->first_name()->GetAsIdString()) &&
-                 catalog_->FindTable(table_path->ToIdentifierVector(), &table,
-                                     analyzer_options_.find_options())
+                 FindTableFromCatalog(table_path->ToIdentifierVector(), &table)
                          .code() == zetasql_base::StatusCode::kNotFound) {
         ZETASQL_RETURN_IF_ERROR(ResolvePathExpressionAsFunctionTableArgument(
             table_path, /*hint=*/nullptr,
@@ -5588,8 +5588,7 @@ zetasql_base::Status Resolver::ResolveArrayScan(
           unnest->expression()->GetAsOrDie<ASTPathExpression>();
       const Table* table;
       const zetasql_base::Status find_status =
-          catalog_->FindTable(path_expr->ToIdentifierVector(), &table,
-                              analyzer_options_.find_options());
+          FindTableFromCatalog(path_expr->ToIdentifierVector(), &table);
       if (find_status.ok()) {
         return MakeSqlErrorAt(path_expr)
             << "UNNEST cannot be applied on a table: "
@@ -5852,8 +5851,7 @@ zetasql_base::Status Resolver::ResolvePathExpressionAsTableScan(
 
   const Table* table = nullptr;
   const zetasql_base::Status find_status =
-      catalog_->FindTable(path_expr->ToIdentifierVector(), &table,
-                          analyzer_options_.find_options());
+      FindTableFromCatalog(path_expr->ToIdentifierVector(), &table);
   if (find_status.code() == zetasql_base::StatusCode::kNotFound) {
     std::string error_message;
     absl::StrAppend(&error_message,
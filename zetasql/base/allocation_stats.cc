@@ -0,0 +1,161 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/allocation_stats.h"
+
+#include <stdlib.h>
+
+#include <new>
+
+#include "zetasql/base/logging.h"
+
+namespace zetasql_base {
+
+namespace {
+
+// Plain thread-locals: zero-initialized, no dynamic initializer, so reading
+// them from the allocator hooks is safe even during static initialization.
+thread_local int64_t tls_allocations = 0;
+thread_local int64_t tls_bytes = 0;
+thread_local int tls_tracking_depth = 0;
+
+}  // namespace
+
+namespace allocation_stats_internal {
+
+AllocationTotals ThreadTotals() {
+  AllocationTotals totals;
+  totals.allocations = tls_allocations;
+  totals.bytes = tls_bytes;
+  return totals;
+}
+
+void RecordAllocation(size_t size) {
+  if (tls_tracking_depth == 0) return;  // disabled: one predictable branch
+  ++tls_allocations;
+  tls_bytes += static_cast<int64_t>(size);
+}
+
+}  // namespace allocation_stats_internal
+
+ScopedAllocationTracking::ScopedAllocationTracking(absl::string_view tag)
+    : tag_(tag) {
+  // Record the start totals after constructing tag_, so the scope's own
+  // allocation is not attributed to it.
+  start_ = allocation_stats_internal::ThreadTotals();
+  ++tls_tracking_depth;
+}
+
+ScopedAllocationTracking::~ScopedAllocationTracking() {
+  DCHECK_GT(tls_tracking_depth, 0);
+  --tls_tracking_depth;
+}
+
+AllocationTotals ScopedAllocationTracking::delta() const {
+  const AllocationTotals now = allocation_stats_internal::ThreadTotals();
+  AllocationTotals delta;
+  delta.allocations = now.allocations - start_.allocations;
+  delta.bytes = now.bytes - start_.bytes;
+  return delta;
+}
+
+}  // namespace zetasql_base
+
+// Global allocator overrides. These take effect in any binary that links
+// this library and forward to malloc/free, differing from the default
+// implementations only in the RecordAllocation call.
+
+void* operator new(size_t size) {
+  void* p = malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  return p;
+}
+
+void* operator new[](size_t size) {
+  void* p = malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  void* p = malloc(size);
+  if (p != nullptr) {
+    zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  }
+  return p;
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  void* p = malloc(size);
+  if (p != nullptr) {
+    zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#if defined(__cpp_aligned_new)
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  void* p = nullptr;
+  if (posix_memalign(&p, static_cast<size_t>(alignment), size) != 0) {
+    throw std::bad_alloc();
+  }
+  zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  void* p = nullptr;
+  if (posix_memalign(&p, static_cast<size_t>(alignment), size) != 0) {
+    return nullptr;
+  }
+  zetasql_base::allocation_stats_internal::RecordAllocation(size);
+  return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t& nothrow) noexcept {
+  return operator new(size, alignment, nothrow);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  free(p);
+}
+void operator delete[](void* p, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  free(p);
+}
+
+#endif  // __cpp_aligned_new
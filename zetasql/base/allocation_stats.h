@@ -0,0 +1,90 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_ALLOCATION_STATS_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_ALLOCATION_STATS_H_
+
+// A scoped heap-allocation counter for benchmarks and perf investigations.
+//
+// Linking //zetasql/base:allocation_stats into a binary overrides the global
+// operator new/delete so that every C++ heap allocation on a thread with an
+// active ScopedAllocationTracking is counted (number of allocations and
+// requested bytes). Threads without an active scope pay only a thread-local
+// integer check per allocation, and binaries that do not link this library
+// are entirely unaffected, so it is safe to keep the instrumentation in all
+// benchmark targets.
+//
+// Counters are per thread: allocations made by other threads while a scope
+// is active are not attributed to it. Scopes nest; each scope observes the
+// allocations made while it is active, so nested scopes with different tags
+// attribute the same allocations to each enclosing phase. Typical benchmark
+// usage:
+//
+//   zetasql_base::ScopedAllocationTracking tracking;
+//   for (auto _ : state) { ... }
+//   state.counters["allocs_per_op"] = benchmark::Counter(
+//       tracking.delta().allocations, benchmark::Counter::kAvgIterations);
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include <cstdint>
+
+namespace zetasql_base {
+
+// Number of heap allocations and the sum of their requested sizes.
+struct AllocationTotals {
+  int64_t allocations = 0;
+  int64_t bytes = 0;
+};
+
+// Enables allocation counting on the current thread for its lifetime.
+// Must be destroyed on the thread it was created on, in LIFO order with
+// respect to other scopes on the same thread.
+class ScopedAllocationTracking {
+ public:
+  // <tag> names what the scope measures (e.g. "resolve"); it is only stored
+  // for the caller's reporting convenience.
+  explicit ScopedAllocationTracking(absl::string_view tag = "");
+  ScopedAllocationTracking(const ScopedAllocationTracking&) = delete;
+  ScopedAllocationTracking& operator=(const ScopedAllocationTracking&) =
+      delete;
+  ~ScopedAllocationTracking();
+
+  // The allocations made on this thread since this scope was constructed.
+  AllocationTotals delta() const;
+
+  const std::string& tag() const { return tag_; }
+
+ private:
+  const std::string tag_;
+  AllocationTotals start_;
+};
+
+namespace allocation_stats_internal {
+
+// Running totals for the current thread since tracking first became active
+// on it. Only advances while a ScopedAllocationTracking is alive.
+AllocationTotals ThreadTotals();
+
+// Called by the operator new overrides in allocation_stats.cc.
+void RecordAllocation(size_t size);
+
+}  // namespace allocation_stats_internal
+
+}  // namespace zetasql_base
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_ALLOCATION_STATS_H_
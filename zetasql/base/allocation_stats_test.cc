@@ -0,0 +1,93 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/allocation_stats.h"
+
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace zetasql_base {
+namespace {
+
+// Allocation the optimizer cannot elide.
+void* volatile sink;
+
+void AllocateAndFree(size_t size) {
+  char* p = new char[size];
+  sink = p;
+  delete[] p;
+}
+
+TEST(AllocationStats, CountsAllocationsInScope) {
+  ScopedAllocationTracking tracking("test");
+  EXPECT_EQ("test", tracking.tag());
+  const AllocationTotals before = tracking.delta();
+  AllocateAndFree(1000);
+  const AllocationTotals after = tracking.delta();
+  // Other machinery may allocate too, so expect at-least rather than exact.
+  EXPECT_GE(after.allocations, before.allocations + 1);
+  EXPECT_GE(after.bytes, before.bytes + 1000);
+}
+
+TEST(AllocationStats, DoesNotCountOutsideScope) {
+  AllocationTotals delta;
+  {
+    ScopedAllocationTracking tracking;
+    delta = tracking.delta();
+  }
+  // The scope above made no allocations after construction.
+  EXPECT_EQ(0, delta.allocations);
+  EXPECT_EQ(0, delta.bytes);
+
+  // With no scope alive, allocations do not advance the thread totals.
+  const AllocationTotals before = allocation_stats_internal::ThreadTotals();
+  AllocateAndFree(1 << 20);
+  const AllocationTotals after = allocation_stats_internal::ThreadTotals();
+  EXPECT_EQ(before.allocations, after.allocations);
+  EXPECT_EQ(before.bytes, after.bytes);
+}
+
+TEST(AllocationStats, NestedScopesBothObserve) {
+  ScopedAllocationTracking outer("outer");
+  AllocateAndFree(100);
+  {
+    ScopedAllocationTracking inner("inner");
+    AllocateAndFree(200);
+    EXPECT_GE(inner.delta().bytes, 200);
+    EXPECT_GE(outer.delta().bytes, inner.delta().bytes + 100);
+  }
+  AllocateAndFree(300);
+  EXPECT_GE(outer.delta().bytes, 600);
+}
+
+TEST(AllocationStats, CountersArePerThread) {
+  ScopedAllocationTracking tracking;
+  const AllocationTotals before = tracking.delta();
+  std::thread other([] {
+    // No scope is active on this thread; nothing is counted anywhere.
+    AllocateAndFree(1 << 20);
+  });
+  other.join();
+  const AllocationTotals after = tracking.delta();
+  // Joining a thread allocates a little on this thread, but the other
+  // thread's megabyte must not appear here.
+  EXPECT_LT(after.bytes - before.bytes, 1 << 20);
+}
+
+}  // namespace
+}  // namespace zetasql_base
@@ -31,6 +31,7 @@
 #include <sys/types.h>         // one place uintptr_t might be
 #include <unistd.h>            // last place uintptr_t might be
 #include <algorithm>
+#include <atomic>
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
@@ -39,6 +40,174 @@
 
 namespace zetasql_base {
 
+namespace {
+
+// Process-wide recycler for arena blocks.
+//
+// Arenas are frequently created, Reset() and destroyed per statement (the
+// analyzer and parser both do this), and every such cycle used to return the
+// blocks to malloc just to ask for identically-sized ones moments later.
+// Instead, freed blocks whose size exactly matches one of a few size classes
+// (covering the block sizes arenas are created with in practice) are kept on
+// freelists for reuse.  Each thread holds a small cache that is accessed
+// without any synchronization; thread caches spill to and refill from global
+// per-class lists in batches, so the mutex on a global list is touched once
+// per batch rather than once per block.  Blocks of other sizes - notably the
+// dedicated blocks made for oversized allocations - go to malloc/free as
+// before.
+//
+// A freed block stores the freelist link in its own first bytes, so the
+// recycler needs no memory of its own.
+//
+// Under ADDRESS_SANITIZER the recycler is disabled so that every block
+// really is returned to the allocator and use-after-free of arena memory
+// stays detectable.
+
+constexpr size_t kRecycledBlockSizes[] = {1024, 4096, 8192, 16384, 32768};
+constexpr int kNumBlockClasses = ABSL_ARRAYSIZE(kRecycledBlockSizes);
+
+// Per-class limits on cached blocks, per thread and process-wide.
+constexpr int kMaxThreadCacheBlocks = 8;
+constexpr int kMaxGlobalFreeBlocks = 64;
+
+// Returns the size class for <size>, or -1 if blocks of this size are not
+// recycled.  Only exact matches are reused so a recycled block never has to
+// be split or truncated.
+int BlockClassIndex(size_t size) {
+  for (int i = 0; i < kNumBlockClasses; ++i) {
+    if (kRecycledBlockSizes[i] == size) return i;
+  }
+  return -1;
+}
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+static_assert(sizeof(FreeBlock) <= 1024,
+              "Freelist link must fit in the smallest recycled block");
+
+struct GlobalBlockList {
+  absl::Mutex mutex;
+  FreeBlock* head ABSL_GUARDED_BY(mutex) = nullptr;
+  int count ABSL_GUARDED_BY(mutex) = 0;
+};
+
+GlobalBlockList* GlobalBlockLists() {
+  static GlobalBlockList* lists = new GlobalBlockList[kNumBlockClasses];
+  return lists;
+}
+
+// The per-thread block cache.  All members are only touched by the owning
+// thread; the destructor gives the cached blocks back to the global lists
+// when the thread exits.
+class ThreadBlockCache {
+ public:
+  ~ThreadBlockCache() {
+    for (int i = 0; i < kNumBlockClasses; ++i) {
+      SpillToGlobal(i, counts_[i]);
+    }
+  }
+
+  // Returns a cached block of size class <class_index>, or nullptr if
+  // neither this thread's cache nor the global list has one.
+  void* Take(int class_index) {
+    if (heads_[class_index] == nullptr) {
+      RefillFromGlobal(class_index);
+      if (heads_[class_index] == nullptr) return nullptr;
+    }
+    FreeBlock* block = heads_[class_index];
+    heads_[class_index] = block->next;
+    --counts_[class_index];
+    return block;
+  }
+
+  // Caches <mem>, a block of size class <class_index>.
+  void Put(int class_index, void* mem) {
+    if (counts_[class_index] >= kMaxThreadCacheBlocks) {
+      SpillToGlobal(class_index, kMaxThreadCacheBlocks / 2);
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(mem);
+    block->next = heads_[class_index];
+    heads_[class_index] = block;
+    ++counts_[class_index];
+  }
+
+ private:
+  // Moves up to <max_blocks> blocks to the global list for <class_index>,
+  // freeing them instead once the global list is full.
+  void SpillToGlobal(int class_index, int max_blocks) {
+    GlobalBlockList* global = &GlobalBlockLists()[class_index];
+    absl::MutexLock lock(&global->mutex);
+    for (int i = 0; i < max_blocks && heads_[class_index] != nullptr; ++i) {
+      FreeBlock* block = heads_[class_index];
+      heads_[class_index] = block->next;
+      --counts_[class_index];
+      if (global->count < kMaxGlobalFreeBlocks) {
+        block->next = global->head;
+        global->head = block;
+        ++global->count;
+      } else {
+        free(block);
+      }
+    }
+  }
+
+  // Takes up to half a cache's worth of blocks from the global list for
+  // <class_index>.
+  void RefillFromGlobal(int class_index) {
+    GlobalBlockList* global = &GlobalBlockLists()[class_index];
+    absl::MutexLock lock(&global->mutex);
+    for (int i = 0; i < kMaxThreadCacheBlocks / 2 && global->head != nullptr;
+         ++i) {
+      FreeBlock* block = global->head;
+      global->head = block->next;
+      --global->count;
+      block->next = heads_[class_index];
+      heads_[class_index] = block;
+      ++counts_[class_index];
+    }
+  }
+
+  FreeBlock* heads_[kNumBlockClasses] = {};
+  int counts_[kNumBlockClasses] = {};
+};
+
+ThreadBlockCache& GetThreadBlockCache() {
+  thread_local ThreadBlockCache cache;
+  return cache;
+}
+
+// Allocates an arena block of <size> bytes, reusing a recycled block when
+// one is available.
+void* AllocateArenaBlock(size_t size) {
+#ifndef ADDRESS_SANITIZER
+  const int class_index = BlockClassIndex(size);
+  if (class_index >= 0) {
+    void* mem = GetThreadBlockCache().Take(class_index);
+    if (mem != nullptr) return mem;
+  }
+#endif
+  return malloc(size);
+}
+
+// Frees an arena block of <size> bytes, keeping it for reuse when its size
+// matches a recycled class.  Blocks from aligned_malloc may be released
+// through this as well; they are at least as aligned as malloc results, so
+// reusing them for later blocks is safe.
+void ReleaseArenaBlock(void* mem, size_t size) {
+#ifndef ADDRESS_SANITIZER
+  const int class_index = BlockClassIndex(size);
+  if (class_index >= 0) {
+    GetThreadBlockCache().Put(class_index, mem);
+    return;
+  }
+#endif
+  free(mem);
+}
+
+}  // namespace
+
 static void *aligned_malloc(size_t size, int minimum_alignment) {
   void *ptr = nullptr;
   // posix_memalign requires that the requested alignment be at least
@@ -107,7 +276,8 @@ BaseArena::BaseArena(char* first, const size_t orig_block_size,
                                                                     kPageSize));
       PCHECK(nullptr != first_blocks_[0].mem);
     } else {
-      first_blocks_[0].mem = reinterpret_cast<char*>(malloc(block_size_));
+      first_blocks_[0].mem =
+          reinterpret_cast<char*>(AllocateArenaBlock(block_size_));
     }
     first_blocks_[0].size = block_size_;
   }
@@ -125,7 +295,7 @@ BaseArena::~BaseArena() {
 #endif
   // The first X blocks stay allocated always by default.  Delete them now.
   for (int i = first_block_externally_owned_ ? 1 : 0; i < blocks_alloced_; ++i)
-    free(first_blocks_[i].mem);
+    ReleaseArenaBlock(first_blocks_[i].mem, first_blocks_[i].size);
 }
 
 // ----------------------------------------------------------------------
@@ -269,7 +439,8 @@ BaseArena::AllocatedBlock*  BaseArena::AllocNewBlock(const size_t block_size,
     block->mem = reinterpret_cast<char*>(aligned_malloc(adjusted_block_size,
                                                         adjusted_alignment));
   } else {
-    block->mem = reinterpret_cast<char*>(malloc(adjusted_block_size));
+    block->mem =
+        reinterpret_cast<char*>(AllocateArenaBlock(adjusted_block_size));
   }
   block->size = adjusted_block_size;
   PCHECK(nullptr != block->mem)
@@ -368,7 +539,7 @@ void* BaseArena::GetMemoryFallback(const size_t size, const int alignment) {
 
 void BaseArena::FreeBlocks() {
   for ( int i = 1; i < blocks_alloced_; ++i ) {  // keep first block alloced
-    free(first_blocks_[i].mem);
+    ReleaseArenaBlock(first_blocks_[i].mem, first_blocks_[i].size);
     first_blocks_[i].mem = nullptr;
     first_blocks_[i].size = 0;
   }
@@ -376,7 +547,7 @@ void BaseArena::FreeBlocks() {
   if (overflow_blocks_ != nullptr) {
     std::vector<AllocatedBlock>::iterator it;
     for (it = overflow_blocks_->begin(); it != overflow_blocks_->end(); ++it) {
-      free(it->mem);
+      ReleaseArenaBlock(it->mem, it->size);
     }
     delete overflow_blocks_;             // These should be used very rarely
     overflow_blocks_ = nullptr;
@@ -490,4 +661,89 @@ void UnsafeArena::UnusedKeyMethod() {}
 void SafeArena::UnusedKeyMethod() {}
 void Gladiator::UnusedKeyMethod() {}
 
+// ----------------------------------------------------------------------
+// ShardedSafeArena
+//    Thread-safe allocation without a single shared mutex: each thread
+//    is assigned a sub-arena (with its own mutex) round-robin the first
+//    time it allocates, so concurrent allocators on different threads
+//    use different sub-arenas.
+// ----------------------------------------------------------------------
+
+const int ShardedSafeArena::kDefaultNumShards;
+
+struct ShardedSafeArena::Shard {
+  explicit Shard(size_t block_size) : arena(block_size) {}
+
+  mutable absl::Mutex mutex;
+  UnsafeArena arena ABSL_GUARDED_BY(mutex);
+};
+
+// Returns a process-wide index for the calling thread, assigned in order of
+// first use.  The first N allocating threads thus land on N distinct shards
+// of an N-shard arena.
+static int CallingThreadIndex() {
+  static std::atomic<int> next_thread_index{0};
+  thread_local const int thread_index =
+      next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_index;
+}
+
+ShardedSafeArena::ShardedSafeArena(size_t block_size, int num_shards) {
+  CHECK_GT(num_shards, 0);
+  shards_.reserve(num_shards);
+  for (int i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(new Shard(block_size));
+  }
+}
+
+ShardedSafeArena::~ShardedSafeArena() {}
+
+ShardedSafeArena::Shard* ShardedSafeArena::PickShard() {
+  return shards_[CallingThreadIndex() % shards_.size()].get();
+}
+
+char* ShardedSafeArena::Alloc(const size_t size) {
+  Shard* shard = PickShard();
+  absl::MutexLock lock(&shard->mutex);
+  return shard->arena.Alloc(size);
+}
+
+void* ShardedSafeArena::AllocAligned(const size_t size, const int align) {
+  Shard* shard = PickShard();
+  absl::MutexLock lock(&shard->mutex);
+  return shard->arena.AllocAligned(size, align);
+}
+
+char* ShardedSafeArena::Calloc(const size_t size) {
+  char* return_value = Alloc(size);
+  memset(return_value, 0, size);
+  return return_value;
+}
+
+char* ShardedSafeArena::Memdup(const char* s, size_t bytes) {
+  char* newstr = Alloc(bytes);
+  memcpy(newstr, s, bytes);
+  return newstr;
+}
+
+char* ShardedSafeArena::Strdup(const char* s) {
+  return Memdup(s, strlen(s) + 1);
+}
+
+void ShardedSafeArena::Reset() {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex);
+    shard->arena.Reset();
+  }
+}
+
+size_t ShardedSafeArena::bytes_allocated() const {
+  size_t total = 0;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex);
+    total += shard->arena.status().bytes_allocated();
+  }
+  return total;
+}
+
 }  // namespace zetasql_base
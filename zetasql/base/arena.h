@@ -255,6 +255,7 @@
 
 #include <assert.h>
 #include <string.h>
+#include <memory>
 #include <vector>
 #ifdef ADDRESS_SANITIZER
 #include <sanitizer/asan_interface.h>
@@ -591,6 +592,54 @@ class SafeArena : public BaseArena {
   virtual void UnusedKeyMethod();  // Dummy key method to avoid weak vtable.
 };
 
+// A thread-safe arena that, unlike SafeArena, does not serialize all
+// allocation on one mutex.  Allocation is spread over a fixed set of
+// sub-arenas; each thread is assigned one round-robin the first time it
+// allocates, so as long as there are at least as many shards as allocating
+// threads, no two threads ever contend on the same sub-arena's mutex.  All
+// memory is owned by this object and released together by Reset() or the
+// destructor.
+//
+// As with SafeArena, memory returned to one thread may be used by any other
+// thread; only the placement of an allocation depends on the calling thread.
+// Reset() and destruction must not be called concurrently with allocation.
+//
+// This provides the malloc-style allocation interface.  It is not a
+// BaseArena, so it cannot be used with ArenaAllocator or Gladiator; those
+// still require UnsafeArena or SafeArena.
+class ShardedSafeArena {
+ public:
+  static const int kDefaultNumShards = 16;
+
+  // Each sub-arena allocates blocks of <block_size> bytes, like the
+  // corresponding UnsafeArena constructor.
+  explicit ShardedSafeArena(size_t block_size,
+                            int num_shards = kDefaultNumShards);
+  ~ShardedSafeArena();
+
+  char* Alloc(size_t size);
+  void* AllocAligned(size_t size, int align);
+  char* Calloc(size_t size);
+  char* Memdup(const char* s, size_t bytes);
+  char* Strdup(const char* s);
+
+  // Releases the memory of every sub-arena.
+  void Reset();
+
+  // Total bytes allocated across all sub-arenas.
+  size_t bytes_allocated() const;
+
+ private:
+  struct Shard;
+
+  Shard* PickShard();
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  ShardedSafeArena(const ShardedSafeArena&) = delete;
+  ShardedSafeArena& operator=(const ShardedSafeArena&) = delete;
+};
+
 }  // namespace zetasql_base
 
 #endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_ARENA_H_
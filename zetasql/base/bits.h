@@ -37,6 +37,10 @@
 //   * Bytes(ContainByte(LessThan)?|AllInRange) - These scan a sequence of bytes
 //     looking for one with(out)? some property.
 //
+//   * CountOnesInRange|Rank|Select|FindNthSetBit64 - Word-parallel population
+//     count and rank/select over LSB-first bitmaps (e.g. null bitmaps of
+//     columnar value batches).
+//
 //   * (Get|Set|Copy)Bits
 //
 //   * GetLowBits - Extract N lowest bits from value.
@@ -187,6 +191,31 @@ class Bits {
   // Return the number of one bits in the byte sequence.
   static int Count(const void *m, int num_bytes);
 
+  // The functions below view 'bitmap' as a sequence of bits in LSB-first
+  // order: bit i of the bitmap is bit (i % 8) of byte (i / 8). This is the
+  // layout commonly used for the null bitmaps of columnar value batches.
+
+  // Return the number of one bits in the half-open bit range
+  // [begin_bit, end_bit) of 'bitmap'.
+  static int64_t CountOnesInRange(const uint8_t* bitmap, int64_t begin_bit,
+                                  int64_t end_bit);
+
+  // Return the number of one bits of 'bitmap' strictly before 'bit_index',
+  // i.e. the rank of 'bit_index'.
+  static int64_t Rank(const uint8_t* bitmap, int64_t bit_index) {
+    return CountOnesInRange(bitmap, 0, bit_index);
+  }
+
+  // Return the index of the k-th (0-indexed) one bit among the first
+  // 'num_bits' bits of 'bitmap', or -1 if that range has at most k one bits.
+  // Select is the inverse of Rank: if the result is non-negative then
+  // Rank(bitmap, Select(bitmap, num_bits, k)) == k.
+  static int64_t Select(const uint8_t* bitmap, int64_t num_bits, int64_t k);
+
+  // Return the index of the k-th (0-indexed) one bit of n. The result is
+  // undefined if k is not less than CountOnes64(n).
+  static int FindNthSetBit64(uint64_t n, int k);
+
   // Return the number of different bits in the given byte sequences.
   // (i.e., the Hamming distance)
   static int Difference(const void *m1, const void *m2, int num_bytes);
@@ -497,6 +526,18 @@ inline int Bits::CountOnesInByte(unsigned char n) {
   return num_bits[n];
 }
 
+inline int Bits::FindNthSetBit64(uint64_t n, int k) {
+#if defined(__BMI2__) && defined(__x86_64__)
+  // Depositing a single bit at position k into n leaves exactly the k-th one
+  // bit of n set, so select reduces to pdep + tzcnt.
+  return FindLSBSetNonZero64(_pdep_u64(uint64_t{1} << k, n));
+#else
+  // Clear the k lowest one bits, then find the next one.
+  for (int i = 0; i < k; ++i) n &= n - 1;
+  return FindLSBSetNonZero64(n);
+#endif
+}
+
 inline uint8_t Bits::ReverseBits8(unsigned char n) {
 #if defined(__aarch64__) && defined(__GNUC__)
   // aarch64 has a reverse bits instruction but there is no gcc builtin.
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -491,6 +492,102 @@ TEST(ReverseBits, In64BitWord) {
                                        "084c2a6e195d3b7f", nullptr, 16)));
 }
 
+// Bit i of the bitmap in LSB-first order, as documented on CountOnesInRange.
+static bool GetBitmapBit(const uint8_t* bitmap, int64_t i) {
+  return (bitmap[i / 8] >> (i % 8)) & 1;
+}
+
+TEST(CountOnesInRange, MatchesBitByBitCount) {
+  std::mt19937_64 random(301);
+  uint8_t bitmap[40];
+  for (uint8_t& byte : bitmap) byte = static_cast<uint8_t>(random());
+  const int64_t num_bits = sizeof(bitmap) * 8;
+
+  // All ranges over the first few words, plus ranges with large interiors,
+  // cover every combination of partial and whole leading/trailing bytes.
+  for (int64_t begin = 0; begin <= 80; ++begin) {
+    for (int64_t end = begin; end <= 80; ++end) {
+      int64_t expected = 0;
+      for (int64_t i = begin; i < end; ++i) expected += GetBitmapBit(bitmap, i);
+      EXPECT_EQ(expected, Bits::CountOnesInRange(bitmap, begin, end))
+          << begin << " " << end;
+      int64_t expected_tail = 0;
+      for (int64_t i = begin; i < num_bits - end; ++i)
+        expected_tail += GetBitmapBit(bitmap, i);
+      EXPECT_EQ(expected_tail,
+                Bits::CountOnesInRange(bitmap, begin, num_bits - end));
+    }
+  }
+  EXPECT_EQ(Bits::Count(bitmap, sizeof(bitmap)),
+            Bits::CountOnesInRange(bitmap, 0, num_bits));
+}
+
+TEST(FindNthSetBit64, OneAllOrSomeBitsSet) {
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(i, Bits::FindNthSetBit64(uint64_t{1} << i, 0));
+    EXPECT_EQ(i, Bits::FindNthSetBit64(~uint64_t{0}, i));
+    // 0x5555... has only 32 one bits, and higher ranks are undefined.
+    if (i < 32) {
+      EXPECT_EQ(2 * i, Bits::FindNthSetBit64(0x5555555555555555ull, i));
+    }
+  }
+  EXPECT_EQ(4, Bits::FindNthSetBit64(0xf0, 0));
+  EXPECT_EQ(7, Bits::FindNthSetBit64(0xf0, 3));
+}
+
+TEST(Select, IsInverseOfRank) {
+  std::mt19937_64 random(302);
+  // Sparse bitmap so that some words contribute no bits at all.
+  uint8_t bitmap[40];
+  for (uint8_t& byte : bitmap)
+    byte = static_cast<uint8_t>(random() & random() & random());
+  const int64_t num_bits = sizeof(bitmap) * 8;
+
+  for (int64_t prefix : {int64_t{1}, int64_t{7}, int64_t{64}, int64_t{100},
+                         num_bits}) {
+    const int64_t total = Bits::CountOnesInRange(bitmap, 0, prefix);
+    int64_t expected_index = -1;
+    for (int64_t k = 0; k < total; ++k) {
+      do {
+        ++expected_index;
+      } while (!GetBitmapBit(bitmap, expected_index));
+      EXPECT_EQ(expected_index, Bits::Select(bitmap, prefix, k)) << k;
+      EXPECT_EQ(k, Bits::Rank(bitmap, Bits::Select(bitmap, prefix, k)));
+    }
+    // Out-of-range ranks.
+    EXPECT_EQ(-1, Bits::Select(bitmap, prefix, total));
+    EXPECT_EQ(-1, Bits::Select(bitmap, prefix, total + 100));
+  }
+  EXPECT_EQ(-1, Bits::Select(bitmap, 0, 0));
+}
+
+TEST(CountAndDifference, WordAtATimeMatchesBytewise) {
+  std::mt19937_64 random(303);
+  uint8_t m1[35], m2[35];
+  for (int i = 0; i < sizeof(m1); ++i) {
+    m1[i] = static_cast<uint8_t>(random());
+    m2[i] = static_cast<uint8_t>(random());
+  }
+  // Every length exercises some mix of whole words and a bytewise tail.
+  for (int len = 0; len <= sizeof(m1); ++len) {
+    int expected_count = 0;
+    int expected_diff = 0;
+    for (int i = 0; i < len; ++i) {
+      expected_count += Bits::CountOnesInByte(m1[i]);
+      expected_diff += Bits::CountOnesInByte(m1[i] ^ m2[i]);
+    }
+    EXPECT_EQ(expected_count, Bits::Count(m1, len)) << len;
+    EXPECT_EQ(expected_diff, Bits::Difference(m1, m2, len)) << len;
+    EXPECT_EQ(expected_diff,
+              Bits::CappedDifference(m1, m2, len, 8 * sizeof(m1)));
+    if (expected_diff > 0) {
+      // A capped count may stop early, but must still exceed the cap.
+      EXPECT_GT(Bits::CappedDifference(m1, m2, len, expected_diff - 1),
+                expected_diff - 1);
+    }
+  }
+}
+
 TEST(ReverseBits, In128BitWord) {
   EXPECT_EQ(absl::uint128(0), Bits::ReverseBits128(absl::uint128(0)));
   EXPECT_EQ(~absl::uint128(0), Bits::ReverseBits128(~absl::uint128(0)));
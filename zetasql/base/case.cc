@@ -20,18 +20,64 @@
 
 #include "zetasql/base/case.h"
 
+#include <cstring>
 #include <string>
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
+#include <cstdint>
 
 namespace zetasql_base {
 
+namespace {
+
+constexpr uint64_t kByteOnes = 0x0101010101010101;
+constexpr uint64_t kByteHighBits = 0x8080808080808080;
+
+inline uint64_t Load64(const char* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// Loads the first <n> bytes at <p> (n < 8) into the low bytes of a word,
+// zero-padding the rest.
+inline uint64_t LoadPartial64(const char* p, size_t n) {
+  uint64_t v = 0;
+  memcpy(&v, p, n);
+  return v;
+}
+
+// Lowercases eight bytes at once: returns <v> with the 0x20 bit set in every
+// byte that holds an ASCII uppercase letter. Bytes outside 'A'..'Z',
+// including non-ASCII bytes with the high bit set, pass through unchanged,
+// so this matches absl::ascii_tolower for all 256 byte values and needs no
+// non-ASCII fallback.
+inline uint64_t ToLower64(uint64_t v) {
+  const uint64_t heptets = v & ~kByteHighBits;
+  // High bit of each byte set iff that byte (mod 0x80) is > 'Z' / >= 'A'.
+  const uint64_t is_gt_z = heptets + (0x7f - 'Z') * kByteOnes;
+  const uint64_t is_ge_a = heptets + (0x80 - 'A') * kByteOnes;
+  const uint64_t is_upper = (is_ge_a & ~is_gt_z & ~v) & kByteHighBits;
+  return v | (is_upper >> 2);  // 0x80 >> 2 == 0x20
+}
+
+}  // namespace
+
 static int memcasecmp(const char* s1, const char* s2, size_t len) {
+  // Compare word-at-a-time while the lowercased words are equal. ToLower64
+  // only maps 'A'..'Z' pairs together, so equal lowered words mean the eight
+  // byte pairs are exactly case-insensitively equal; on a mismatch, fall
+  // through to the byte loop to find the first differing byte.
+  size_t i = 0;
+  while (i + sizeof(uint64_t) <= len &&
+         ToLower64(Load64(s1 + i)) == ToLower64(Load64(s2 + i))) {
+    i += sizeof(uint64_t);
+  }
+
   const unsigned char* us1 = reinterpret_cast<const unsigned char*>(s1);
   const unsigned char* us2 = reinterpret_cast<const unsigned char*>(s2);
-
-  for (size_t i = 0; i < len; i++) {
+  for (; i < len; i++) {
     const int diff =
         int{static_cast<unsigned char>(absl::ascii_tolower(us1[i]))} -
         int{static_cast<unsigned char>(absl::ascii_tolower(us2[i]))};
@@ -57,4 +103,26 @@ int CaseCompare(absl::string_view s1, absl::string_view s2) {
   }
 }
 
+size_t CaseHash(absl::string_view s) {
+  // Mixes one lowercased word at a time, so no lowercased copy of <s> is
+  // ever materialized. The multiply-xorshift step is the 128-to-64-bit
+  // mixer from CityHash; the seed folds in the length so that the
+  // zero-padded last word cannot collide with explicit trailing NUL bytes.
+  constexpr uint64_t kMul = 0x9ddfea08eb382d69;
+  const char* p = s.data();
+  size_t len = s.size();
+  uint64_t h = 0x9e3779b97f4a7c15 ^ (uint64_t{s.size()} * kMul);
+  while (len >= sizeof(uint64_t)) {
+    h = (h ^ ToLower64(Load64(p))) * kMul;
+    h ^= h >> 47;
+    p += sizeof(uint64_t);
+    len -= sizeof(uint64_t);
+  }
+  if (len > 0) {
+    h = (h ^ ToLower64(LoadPartial64(p, len))) * kMul;
+    h ^= h >> 47;
+  }
+  return static_cast<size_t>(h * kMul);
+}
+
 }  // namespace zetasql_base
@@ -107,6 +107,14 @@ struct CaseLess {
   }
 };
 
+// CaseHash()
+//
+// Returns a hash of <s> that ignores ASCII case, i.e. strings for which
+// CaseEqual() returns true hash to the same value. The hash is computed a
+// word at a time without materializing a lowercased copy of <s>. The value
+// is not stable across processes; use it only for in-memory hash containers.
+size_t CaseHash(absl::string_view s);
+
 struct StringViewCaseEqual {
   bool operator()(absl::string_view s1, absl::string_view s2) const {
     return CaseEqual(s1, s2);
@@ -114,9 +122,7 @@ struct StringViewCaseEqual {
 };
 
 struct StringViewCaseHash {
-  size_t operator()(absl::string_view s1) const {
-    return std::hash<std::string>()(absl::AsciiStrToLower(s1));
-  }
+  size_t operator()(absl::string_view s1) const { return CaseHash(s1); }
 };
 
 }  // namespace zetasql_base
@@ -102,4 +102,64 @@ TEST(stringtest, CaseCompare) {
   ASSERT_TRUE(CaseLess()(k, j));
 }
 
+TEST(stringtest, CaseCompareLongStrings) {
+  // Strings longer than eight bytes take the word-at-a-time path.
+  const std::string base = "The Quick Brown Fox Jumps Over The Lazy Dog";
+  std::string upper = base;
+  std::string lower = base;
+  for (char& c : upper) c = absl::ascii_toupper(c);
+  for (char& c : lower) c = absl::ascii_tolower(c);
+  ASSERT_TRUE(CaseEqual(base, upper));
+  ASSERT_TRUE(CaseEqual(base, lower));
+  ASSERT_EQ(CaseCompare(upper, lower), 0);
+
+  // Bytes that differ only in the 0x20 bit but are not letters must not
+  // compare equal ('@' is 0x40, '`' is 0x60).
+  const std::string at = base + "@tail";
+  const std::string backtick = base + "`tail";
+  ASSERT_FALSE(CaseEqual(at, backtick));
+  ASSERT_LT(CaseCompare(at, backtick), 0);
+
+  // A difference in each word position, including the unaligned tail.
+  for (int i = 0; i < base.size(); ++i) {
+    std::string changed = lower;
+    changed[i] = '~';
+    ASSERT_FALSE(CaseEqual(base, changed)) << i;
+    ASSERT_NE(CaseCompare(base, changed), 0) << i;
+  }
+
+  // Non-ASCII bytes are compared exactly.
+  const std::string high1 = base + "\xc3\xa9";
+  const std::string high2 = base + "\xc3\x89";
+  ASSERT_TRUE(CaseEqual(high1, high1));
+  ASSERT_FALSE(CaseEqual(high1, high2));
+}
+
+TEST(stringtest, CaseHash) {
+  // CaseEqual strings must hash identically, across all word alignments.
+  const std::string base = "The Quick Brown Fox Jumps Over The Lazy Dog";
+  for (int len = 0; len <= base.size(); ++len) {
+    const std::string s = base.substr(0, len);
+    std::string upper = s;
+    std::string lower = s;
+    for (char& c : upper) c = absl::ascii_toupper(c);
+    for (char& c : lower) c = absl::ascii_tolower(c);
+    ASSERT_EQ(CaseHash(s), CaseHash(upper)) << len;
+    ASSERT_EQ(CaseHash(s), CaseHash(lower)) << len;
+    ASSERT_EQ(CaseHash(s), StringViewCaseHash()(s)) << len;
+  }
+
+  // Embedded and trailing NUL bytes are significant.
+  ASSERT_NE(CaseHash(absl::string_view("a", 1)),
+            CaseHash(absl::string_view("a\0", 2)));
+  ASSERT_NE(CaseHash(absl::string_view("a\0b", 3)),
+            CaseHash(absl::string_view("a\0c", 3)));
+
+  // Not a guarantee, but these obviously-different strings should not
+  // collide with a 64-bit hash.
+  ASSERT_NE(CaseHash("abc"), CaseHash("abd"));
+  ASSERT_NE(CaseHash("abc"), CaseHash("ab"));
+  ASSERT_NE(CaseHash(""), CaseHash(absl::string_view("\0", 1)));
+}
+
 }  // namespace zetasql_base
@@ -0,0 +1,295 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// A read-only companion to GeneralTrie (general_trie.h) that stores the trie
+// as a double-array (Aoe's base/check representation) instead of one heap
+// allocation per node. All transitions are computed as array offsets, so a
+// lookup touches two flat arrays instead of chasing per-node child pointers;
+// for read-mostly uses such as keyword or suggestion lookups this removes
+// most of the cache misses of the pointer-based layout.
+//
+// The lookup interface (GetData(), GetDataForMaximalPrefix*(),
+// GetAllMatchingStrings()) is identical to GeneralTrie's so callers can build
+// their table with GeneralTrie::Insert() and then freeze it:
+//
+//   GeneralTrie<int, 0> builder;
+//   builder.Insert("select", 1);
+//   ...
+//   DoubleArrayTrie<int, 0> trie;
+//   trie.BuildFrom(builder);  // builder can be discarded now
+//
+// Like GeneralTrie, the class comes in two flavors with the same null-value
+// policies: DoubleArrayTrie<T, T NULL_VALUE> for integral (and pointer) types
+// and ClassDoubleArrayTrie<T> for class types.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_DOUBLE_ARRAY_TRIE_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_DOUBLE_ARRAY_TRIE_H_
+
+#include <string.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/general_trie.h"
+#include "zetasql/base/logging.h"
+#include <cstdint>
+
+namespace zetasql_base {
+
+template <class T, class NullValuePolicy>  // NullValuePolicy implements Null()
+class DoubleArrayTrieImpl {
+ public:
+  typedef T value_type;
+
+  typedef std::pair<std::string, T> TrieData;
+
+  DoubleArrayTrieImpl() : null_value_instance_(NullValuePolicy::Null()) {
+    Clear();
+  }
+
+  // Rebuilds this trie to hold exactly the keys of <trie>. The source trie is
+  // only read, never retained; it can be destroyed once BuildFrom() returns.
+  void BuildFrom(const GeneralTrieImpl<T, NullValuePolicy>& trie) {
+    std::vector<TrieData> entries;
+    for (typename GeneralTrieImpl<T, NullValuePolicy>::TraverseIterator iter =
+             trie.Traverse();
+         !iter.Done(); iter.Next()) {
+      entries.push_back(std::make_pair(iter.Key(), iter.Value()));
+    }
+    // TraverseIterator yields keys in lexicographical order.
+    BuildFromSorted(entries);
+  }
+
+  // Rebuilds this trie from <entries>, which must be sorted by key with no
+  // duplicate keys. Values equal to NullValuePolicy::Null() are legal but
+  // indistinguishable from absent keys on lookup, exactly as in GeneralTrie.
+  void BuildFromSorted(const std::vector<TrieData>& entries) {
+    Clear();
+    for (int i = 1; i < entries.size(); ++i) {
+      CHECK_LT(entries[i - 1].first, entries[i].first)
+          << "BuildFromSorted requires sorted, duplicate-free keys";
+    }
+    size_ = entries.size();
+    if (!entries.empty()) {
+      BuildNode(0 /* root */, 0, entries.size(), 0 /* depth */, entries);
+    }
+  }
+
+  // Returns the data associated with s in the trie, or NullValuePolicy::Null()
+  // if s is not in the trie.
+  const T& GetData(const char* s) const {
+    int node = 0;
+    for (; *s != '\0'; ++s) {
+      node = Step(node, *s);
+      if (node < 0) return null_value_instance_;
+    }
+    return data_[node];
+  }
+
+  // Finds the greatest number n such that:
+  //  1. the first n characters of s form a std::string in the trie;
+  //  2. (s[n] == '\0') or is_terminator[s[n]] is true.
+  // If there is no n that satisfies these conditions, the method returns
+  // NullValuePolicy::Null().  Otherwise, it returns the data associated with
+  // the first n characters of s and sets *chars_matched to n.  is_terminator
+  // should point to an array of 256 bools.  You can also pass a null pointer
+  // for is_terminator, in which case the function treats every character as a
+  // terminator, so condition 2 is always satisfied.
+  const T& GetDataForMaximalPrefix(const char* s, int* chars_matched,
+                                   const bool* is_terminator) const {
+    return GetDataForMaximalPrefixWithLen(s, strlen(s), chars_matched,
+                                          is_terminator);
+  }
+
+  // Same as GetDataForMaximalPrefix but takes in the length of the input
+  // so that we don't need to compute it.
+  const T& GetDataForMaximalPrefixWithLen(const char* s, int slen,
+                                          int* chars_matched,
+                                          const bool* is_terminator) const {
+    int node = 0;
+    const T* matched_data = &null_value_instance_;
+    for (int next_pos = 0; ; ++next_pos) {
+      if (data_[node] != null_value_instance_ &&
+          ((s[next_pos] == '\0') || (is_terminator == nullptr) ||
+           (is_terminator[static_cast<int8_t>(s[next_pos])]))) {
+        *chars_matched = next_pos;
+        matched_data = &data_[node];
+      }
+      if (next_pos >= slen) return *matched_data;
+      node = Step(node, s[next_pos]);
+      if (node < 0) return *matched_data;
+    }
+  }
+
+  // Gets all strings (and associated data) matching the given
+  // std::string, in lexicographical order. The given std::string must match in
+  // its entirety.  Note: empty input std::string matches everything in the
+  // trie.
+  void GetAllMatchingStrings(const char* s, int len,
+                             std::vector<TrieData>* outdata) const {
+    outdata->clear();
+    int node = 0;
+    for (int i = 0; i < len; ++i) {
+      node = Step(node, s[i]);
+      if (node < 0) return;
+    }
+    std::string buf(s, len);
+    CollectAll(node, &buf, outdata);
+  }
+
+  // The number of keys in the trie.
+  size_t size() const { return size_; }
+
+  // The number of double-array slots, including unused ones. Exposed mostly
+  // so tests and benchmarks can see how compact the layout is.
+  size_t slot_count() const { return base_.size(); }
+
+ private:
+  // check_[i] values below 0 are not valid parent indexes:
+  static constexpr int32_t kFreeSlot = -1;  // slot i is unused
+  static constexpr int32_t kRootSlot = -2;  // slot i is the root (slot 0)
+
+  // Transition offsets are char + 1, so they lie in [1, 256] and a node can
+  // never be its own child.
+  static int Offset(char c) { return static_cast<unsigned char>(c) + 1; }
+
+  // Follows the edge labelled <c> out of <node>. Returns the child index, or
+  // -1 if there is no such edge.
+  int Step(int node, char c) const {
+    const int next = base_[node] + Offset(c);
+    if (next >= check_.size() || check_[next] != node) return -1;
+    return next;
+  }
+
+  void Clear() {
+    base_.assign(1, 0);
+    check_.assign(1, kRootSlot);
+    data_.assign(1, null_value_instance_);
+    size_ = 0;
+  }
+
+  // Grows the arrays so that slot <index> exists.
+  void EnsureSlot(int index) {
+    if (index >= base_.size()) {
+      base_.resize(index + 1, 0);
+      check_.resize(index + 1, kFreeSlot);
+      data_.resize(index + 1, null_value_instance_);
+    }
+  }
+
+  // Lays out the subtrie for entries [begin, end), which all share a prefix of
+  // length <depth>, rooted at slot <node>.
+  void BuildNode(int node, int begin, int end, int depth,
+                 const std::vector<TrieData>& entries) {
+    if (entries[begin].first.size() == depth) {
+      // The shared prefix itself is a key.
+      data_[node] = entries[begin].second;
+      ++begin;
+      if (begin == end) return;
+    }
+
+    // Partition [begin, end) into runs with the same character at <depth>.
+    std::vector<std::pair<char, std::pair<int, int> > > children;
+    for (int i = begin; i < end;) {
+      const char c = entries[i].first[depth];
+      int j = i + 1;
+      while (j < end && entries[j].first[depth] == c) ++j;
+      children.push_back(std::make_pair(c, std::make_pair(i, j)));
+      i = j;
+    }
+
+    // Find the first base where every child's slot is free. This linear probe
+    // makes construction quadratic in the worst case, which is fine for the
+    // build-once keyword-table sizes this class is meant for.
+    int base = 1;
+    for (;; ++base) {
+      bool fits = true;
+      for (int k = 0; k < children.size(); ++k) {
+        const int slot = base + Offset(children[k].first);
+        if (slot < check_.size() && check_[slot] != kFreeSlot) {
+          fits = false;
+          break;
+        }
+      }
+      if (fits) break;
+    }
+
+    // Claim all the child slots before recursing so that descendants cannot
+    // steal them.
+    base_[node] = base;
+    for (int k = 0; k < children.size(); ++k) {
+      const int slot = base + Offset(children[k].first);
+      EnsureSlot(slot);
+      check_[slot] = node;
+    }
+    for (int k = 0; k < children.size(); ++k) {
+      BuildNode(base + Offset(children[k].first), children[k].second.first,
+                children[k].second.second, depth + 1, entries);
+    }
+  }
+
+  // Appends every key below <node> (whose key text is *buf) to <outdata> in
+  // lexicographical order.
+  void CollectAll(int node, std::string* buf,
+                  std::vector<TrieData>* outdata) const {
+    if (data_[node] != null_value_instance_) {
+      outdata->push_back(std::make_pair(*buf, data_[node]));
+    }
+    for (int c = 0; c < 256; ++c) {
+      const int slot = base_[node] + c + 1;
+      if (slot < check_.size() && check_[slot] == node) {
+        buf->append(1, static_cast<char>(c));
+        CollectAll(slot, buf, outdata);
+        buf->erase(buf->size() - 1);
+      }
+    }
+  }
+
+  // base_[i] + Offset(c) is where the child of node i labelled c lives;
+  // check_[base_[i] + Offset(c)] == i confirms that the edge exists. data_[i]
+  // is the value at node i, or the null value if node i is not a key.
+  std::vector<int32_t> base_;
+  std::vector<int32_t> check_;
+  std::vector<T> data_;
+  const T null_value_instance_;  // allows return by reference
+  size_t size_;
+
+  // Disallow copy constructor and operator=
+  DoubleArrayTrieImpl(const DoubleArrayTrieImpl<T, NullValuePolicy>&);
+  void operator=(const DoubleArrayTrieImpl<T, NullValuePolicy>&);
+};
+
+// DoubleArrayTrie version for integral types (and pointers), mirroring
+// GeneralTrie<T, NULL_VALUE>.
+template <class T, T NULL_VALUE>
+class DoubleArrayTrie
+    : public DoubleArrayTrieImpl<T, IntegralNullValuePolicy<T, NULL_VALUE> > {
+ public:
+  typedef IntegralNullValuePolicy<T, NULL_VALUE> null_value_policy;
+};
+
+// DoubleArrayTrie version that supports classes, mirroring ClassGeneralTrie.
+template <class T>
+class ClassDoubleArrayTrie
+    : public DoubleArrayTrieImpl<T, DefaultConstructedNullValuePolicy<T> > {
+ public:
+  typedef DefaultConstructedNullValuePolicy<T> null_value_policy;
+};
+
+}  // namespace zetasql_base
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_DOUBLE_ARRAY_TRIE_H_
@@ -0,0 +1,192 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/double_array_trie.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/general_trie.h"
+#include "zetasql/base/logging.h"
+#include "absl/base/macros.h"
+#include "gtest/gtest.h"
+
+namespace zetasql_base {
+namespace {
+
+TEST(DoubleArrayTrie, Basic) {
+  GeneralTrie<int, 0> builder;
+  builder.Insert("one", 1);
+  builder.Insert("two", 2);
+  builder.Insert("three", 3);
+  builder.Insert("oneflew", 4);
+  builder.Insert("oneflewover", 5);
+  builder.Insert("oneflewoverthe", 6);
+  builder.Insert("twoiscompany", 7);
+
+  DoubleArrayTrie<int, 0> trie;
+  trie.BuildFrom(builder);
+  CHECK_EQ(trie.size(), 7);
+
+  CHECK_EQ(trie.GetData("one"), 1);
+  CHECK_EQ(trie.GetData("two"), 2);
+  CHECK_EQ(trie.GetData("three"), 3);
+  CHECK_EQ(trie.GetData("oneflew"), 4);
+  CHECK_EQ(trie.GetData("oneflewover"), 5);
+  CHECK_EQ(trie.GetData("oneflewoverthe"), 6);
+  CHECK_EQ(trie.GetData("twoiscompany"), 7);
+  // Non-existent entries, including proper prefixes and extensions of keys.
+  CHECK_EQ(trie.GetData("foo"), 0);
+  CHECK_EQ(trie.GetData("on"), 0);
+  CHECK_EQ(trie.GetData("ones"), 0);
+  CHECK_EQ(trie.GetData(""), 0);
+
+  int chars_matched = -1;
+  CHECK_EQ(trie.GetDataForMaximalPrefix("one", &chars_matched, nullptr), 1);
+  CHECK_EQ(chars_matched, 3);
+  CHECK_EQ(trie.GetDataForMaximalPrefix("oneflewove", &chars_matched, nullptr),
+           4);
+  CHECK_EQ(chars_matched, 7);
+  bool is_terminators[256] = {};
+  is_terminators['b'] = true;
+  CHECK_EQ(
+      trie.GetDataForMaximalPrefix("oneby", &chars_matched, is_terminators), 1);
+  CHECK_EQ(chars_matched, 3);
+  // 'f' is not a terminator, so "one" must not match inside "oneflew".
+  CHECK_EQ(
+      trie.GetDataForMaximalPrefix("onefl", &chars_matched, is_terminators), 0);
+
+  std::vector<std::pair<std::string, int> > outdata;
+  trie.GetAllMatchingStrings("onefl", strlen("onefl"), &outdata);
+  CHECK_EQ(outdata.size(), 3);
+  CHECK_EQ(outdata[0].first, "oneflew");
+  CHECK_EQ(outdata[0].second, 4);
+  CHECK_EQ(outdata[1].first, "oneflewover");
+  CHECK_EQ(outdata[1].second, 5);
+  CHECK_EQ(outdata[2].first, "oneflewoverthe");
+  CHECK_EQ(outdata[2].second, 6);
+
+  trie.GetAllMatchingStrings("two", strlen("two"), &outdata);
+  CHECK_EQ(outdata.size(), 2);
+  CHECK_EQ(outdata[0].first, "two");
+  CHECK_EQ(outdata[0].second, 2);
+  CHECK_EQ(outdata[1].first, "twoiscompany");
+  CHECK_EQ(outdata[1].second, 7);
+
+  trie.GetAllMatchingStrings("foo", strlen("foo"), &outdata);
+  CHECK_EQ(outdata.size(), 0);
+
+  // Empty input matches everything, in lexicographical order.
+  trie.GetAllMatchingStrings("", 0, &outdata);
+  CHECK_EQ(outdata.size(), 7);
+  CHECK_EQ(outdata[0].first, "one");
+  CHECK_EQ(outdata[6].first, "twoiscompany");
+}
+
+TEST(DoubleArrayTrie, MatchesGeneralTrieOnEveryProbe) {
+  // Build both tries over the same keys and check that every prefix and every
+  // one-character extension of every key gets identical answers.
+  const char* kKeys[] = {"a",      "ab",    "abcde", "abd", "b",
+                         "select", "selec", "sel",   "zzz", "z"};
+  GeneralTrie<int, -1> general;
+  DoubleArrayTrie<int, -1> double_array;
+  std::vector<std::string> probes;
+  for (int i = 0; i < ABSL_ARRAYSIZE(kKeys); ++i) {
+    general.Insert(kKeys[i], i);
+    for (int len = 0; len <= strlen(kKeys[i]); ++len) {
+      probes.push_back(std::string(kKeys[i], len));
+      probes.push_back(std::string(kKeys[i], len) + "q");
+    }
+  }
+  double_array.BuildFrom(general);
+  CHECK_EQ(double_array.size(), ABSL_ARRAYSIZE(kKeys));
+
+  for (int i = 0; i < probes.size(); ++i) {
+    const std::string& probe = probes[i];
+    CHECK_EQ(general.GetData(probe.c_str()),
+             double_array.GetData(probe.c_str()))
+        << probe;
+
+    int general_matched = -1;
+    int double_array_matched = -1;
+    CHECK_EQ(general.GetDataForMaximalPrefix(probe.c_str(), &general_matched,
+                                             nullptr),
+             double_array.GetDataForMaximalPrefix(
+                 probe.c_str(), &double_array_matched, nullptr))
+        << probe;
+    CHECK_EQ(general_matched, double_array_matched) << probe;
+
+    std::vector<std::pair<std::string, int> > general_out;
+    std::vector<std::pair<std::string, int> > double_array_out;
+    general.GetAllMatchingStrings(probe.data(), probe.size(), &general_out);
+    double_array.GetAllMatchingStrings(probe.data(), probe.size(),
+                                       &double_array_out);
+    CHECK(general_out == double_array_out) << probe;
+  }
+}
+
+TEST(DoubleArrayTrie, EmptyAndRootKey) {
+  DoubleArrayTrie<int, 0> empty;
+  CHECK_EQ(empty.size(), 0);
+  CHECK_EQ(empty.GetData(""), 0);
+  CHECK_EQ(empty.GetData("anything"), 0);
+  std::vector<std::pair<std::string, int> > outdata;
+  empty.GetAllMatchingStrings("", 0, &outdata);
+  CHECK_EQ(outdata.size(), 0);
+
+  // A value on the empty key lives at the root.
+  GeneralTrie<int, 0> builder;
+  builder.Insert("", 1234);
+  builder.Insert("a", 5678);
+  DoubleArrayTrie<int, 0> trie;
+  trie.BuildFrom(builder);
+  CHECK_EQ(trie.size(), 2);
+  CHECK_EQ(trie.GetData(""), 1234);
+  CHECK_EQ(trie.GetData("a"), 5678);
+  trie.GetAllMatchingStrings("", 0, &outdata);
+  CHECK_EQ(outdata.size(), 2);
+  CHECK_EQ(outdata[0].first, "");
+  CHECK_EQ(outdata[0].second, 1234);
+  CHECK_EQ(outdata[1].first, "a");
+  CHECK_EQ(outdata[1].second, 5678);
+
+  // Rebuilding replaces the previous contents.
+  GeneralTrie<int, 0> other;
+  other.Insert("x", 9);
+  trie.BuildFrom(other);
+  CHECK_EQ(trie.size(), 1);
+  CHECK_EQ(trie.GetData(""), 0);
+  CHECK_EQ(trie.GetData("x"), 9);
+}
+
+TEST(DoubleArrayTrie, BuildFromSorted) {
+  std::vector<std::pair<std::string, int> > entries;
+  entries.push_back(std::make_pair("ant", 1));
+  entries.push_back(std::make_pair("bee", 2));
+  entries.push_back(std::make_pair("beetle", 3));
+
+  DoubleArrayTrie<int, 0> trie;
+  trie.BuildFromSorted(entries);
+  CHECK_EQ(trie.size(), 3);
+  CHECK_EQ(trie.GetData("ant"), 1);
+  CHECK_EQ(trie.GetData("bee"), 2);
+  CHECK_EQ(trie.GetData("beetle"), 3);
+  CHECK_EQ(trie.GetData("beet"), 0);
+}
+
+}  // namespace
+}  // namespace zetasql_base
@@ -0,0 +1,69 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/endian_codec.h"
+
+#include <cstdint>
+
+namespace zetasql_base {
+
+const char* DecodeVarint64(const char* src, const char* limit,
+                           uint64_t* value) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const in_limit = reinterpret_cast<const uint8_t*>(limit);
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (in >= in_limit) return nullptr;  // truncated
+    const uint8_t byte = *in++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      // The tenth group holds only one significant bit; anything else means
+      // the value does not fit in 64 bits.
+      if (shift == 63 && (byte & 0x7e) != 0) return nullptr;
+      *value = result;
+      return reinterpret_cast<const char*>(in);
+    }
+  }
+  return nullptr;  // more than kMaxVarint64Bytes continuation bytes
+}
+
+size_t VarintSize64Span(const uint64_t* values, size_t count) {
+  size_t size = 0;
+  for (size_t i = 0; i < count; ++i) size += VarintSize64(values[i]);
+  return size;
+}
+
+char* EncodeVarint64Span(const uint64_t* values, size_t count, char* dst) {
+  for (size_t i = 0; i < count; ++i) dst = EncodeVarint64(values[i], dst);
+  return dst;
+}
+
+const char* DecodeVarint64Span(const char* src, const char* limit,
+                               size_t count, uint64_t* values) {
+  for (size_t i = 0; i < count; ++i) {
+    // Common fast case: the next value fits in one byte.
+    if (src < limit && (*reinterpret_cast<const uint8_t*>(src) & 0x80) == 0) {
+      values[i] = *reinterpret_cast<const uint8_t*>(src);
+      ++src;
+      continue;
+    }
+    src = DecodeVarint64(src, limit, &values[i]);
+    if (src == nullptr) return nullptr;
+  }
+  return src;
+}
+
+}  // namespace zetasql_base
@@ -0,0 +1,156 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_ENDIAN_CODEC_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_ENDIAN_CODEC_H_
+
+// Span-level little-endian encode/decode helpers built on top of the
+// single-value loads and stores in endian.h. These are the shared primitives
+// for row and column serializers (e.g. spill-to-disk sort runs and catalog
+// snapshots), so that each serializer does not hand-roll its own byte loops
+// and any future vectorization happens in one place.
+//
+// Encoders take a destination pointer and return the pointer just past the
+// bytes written; the caller must have reserved enough room (see
+// kMaxVarint64Bytes and VarintSize64Span). Decoders take a [src, limit)
+// range and return the pointer just past the bytes consumed, or nullptr if
+// the input is truncated or malformed. The wire formats are the obvious
+// ones: fixed-width values are stored little-endian back to back, and
+// varints use the base-128 encoding that protocol buffers use.
+
+#include <stddef.h>
+#include <string.h>
+
+#include <type_traits>
+
+#include "zetasql/base/endian.h"
+#include <cstdint>
+
+namespace zetasql_base {
+
+// Maximum encoded size of one varint-encoded uint64_t.
+inline constexpr size_t kMaxVarint64Bytes = 10;
+
+// Fixed-width spans ------------------------------------------------------
+
+// Stores <count> values of the integral type T at <dst> in little-endian
+// byte order, unaligned. Returns the pointer past the last byte written.
+// On little-endian hosts this compiles to a single memcpy.
+template <typename T>
+inline char* StoreLittleEndianSpan(const T* src, size_t count, char* dst) {
+  static_assert(std::is_integral<T>::value &&
+                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                     sizeof(T) == 8),
+                "T must be an integral type of 1, 2, 4 or 8 bytes");
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  memcpy(dst, src, count * sizeof(T));
+#else
+  for (size_t i = 0; i < count; ++i) {
+    if (sizeof(T) == 1) {
+      memcpy(dst + i, &src[i], 1);
+    } else if (sizeof(T) == 2) {
+      LittleEndian::Store16(dst + i * 2, static_cast<uint16_t>(src[i]));
+    } else if (sizeof(T) == 4) {
+      LittleEndian::Store32(dst + i * 4, static_cast<uint32_t>(src[i]));
+    } else {
+      LittleEndian::Store64(dst + i * 8, static_cast<uint64_t>(src[i]));
+    }
+  }
+#endif
+  return dst + count * sizeof(T);
+}
+
+// Loads <count> little-endian values of the integral type T from <src> into
+// <dst>. Returns the pointer past the last byte consumed, or nullptr if
+// [src, limit) holds fewer than count * sizeof(T) bytes.
+template <typename T>
+inline const char* LoadLittleEndianSpan(const char* src, const char* limit,
+                                        size_t count, T* dst) {
+  static_assert(std::is_integral<T>::value &&
+                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                     sizeof(T) == 8),
+                "T must be an integral type of 1, 2, 4 or 8 bytes");
+  if (limit - src < 0 ||
+      static_cast<size_t>(limit - src) < count * sizeof(T)) {
+    return nullptr;
+  }
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  memcpy(dst, src, count * sizeof(T));
+#else
+  for (size_t i = 0; i < count; ++i) {
+    if (sizeof(T) == 1) {
+      memcpy(&dst[i], src + i, 1);
+    } else if (sizeof(T) == 2) {
+      dst[i] = static_cast<T>(LittleEndian::Load16(src + i * 2));
+    } else if (sizeof(T) == 4) {
+      dst[i] = static_cast<T>(LittleEndian::Load32(src + i * 4));
+    } else {
+      dst[i] = static_cast<T>(LittleEndian::Load64(src + i * 8));
+    }
+  }
+#endif
+  return src + count * sizeof(T);
+}
+
+// Varints ----------------------------------------------------------------
+
+// Returns the number of bytes EncodeVarint64 will write for <value>.
+inline size_t VarintSize64(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+// Stores <value> at <dst> as a base-128 varint, low groups first. Returns
+// the pointer past the last byte written, at most kMaxVarint64Bytes later.
+inline char* EncodeVarint64(uint64_t value, char* dst) {
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  while (value >= 0x80) {
+    *out++ = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(value);
+  return reinterpret_cast<char*>(out);
+}
+
+// Decodes one varint from [src, limit) into *value. Returns the pointer past
+// the last byte consumed, or nullptr if the input ends inside the varint or
+// the varint does not fit in 64 bits.
+const char* DecodeVarint64(const char* src, const char* limit,
+                           uint64_t* value);
+
+// Batch variants. The encoded bytes of consecutive values are simply
+// concatenated; use VarintSize64Span to size the destination buffer.
+
+// Returns the total encoded size of <count> values.
+size_t VarintSize64Span(const uint64_t* values, size_t count);
+
+// Encodes <count> values back to back at <dst>. Returns the pointer past the
+// last byte written.
+char* EncodeVarint64Span(const uint64_t* values, size_t count, char* dst);
+
+// Decodes <count> varints from [src, limit) into <values>. Returns the
+// pointer past the last byte consumed, or nullptr if any varint is truncated
+// or malformed (in which case the contents of <values> are unspecified).
+const char* DecodeVarint64Span(const char* src, const char* limit,
+                               size_t count, uint64_t* values);
+
+}  // namespace zetasql_base
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_ENDIAN_CODEC_H_
@@ -0,0 +1,160 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/endian_codec.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace zetasql_base {
+namespace {
+
+template <typename T>
+void RoundTripFixedSpan(const std::vector<T>& values) {
+  std::vector<char> buffer(values.size() * sizeof(T));
+  char* end = StoreLittleEndianSpan(values.data(), values.size(),
+                                    buffer.data());
+  ASSERT_EQ(buffer.data() + buffer.size(), end);
+
+  // The wire bytes are little-endian regardless of host order.
+  for (size_t i = 0; i < values.size(); ++i) {
+    typename std::make_unsigned<T>::type v = values[i];
+    for (size_t b = 0; b < sizeof(T); ++b) {
+      EXPECT_EQ(static_cast<uint8_t>(v >> (8 * b)),
+                static_cast<uint8_t>(buffer[i * sizeof(T) + b]));
+    }
+  }
+
+  std::vector<T> decoded(values.size());
+  const char* read_end =
+      LoadLittleEndianSpan(buffer.data(), buffer.data() + buffer.size(),
+                           decoded.size(), decoded.data());
+  ASSERT_EQ(buffer.data() + buffer.size(), read_end);
+  EXPECT_EQ(values, decoded);
+
+  // One byte short must fail.
+  if (!buffer.empty()) {
+    EXPECT_EQ(nullptr,
+              LoadLittleEndianSpan(buffer.data(),
+                                   buffer.data() + buffer.size() - 1,
+                                   decoded.size(), decoded.data()));
+  }
+}
+
+TEST(EndianCodec, FixedSpanRoundTrip) {
+  RoundTripFixedSpan<uint8_t>({0, 1, 0x7f, 0x80, 0xff});
+  RoundTripFixedSpan<uint16_t>({0, 1, 0x0123, 0xffff});
+  RoundTripFixedSpan<uint32_t>({0, 1, 0x01234567, 0xffffffff});
+  RoundTripFixedSpan<uint64_t>(
+      {0, 1, 0x0123456789abcdefull, std::numeric_limits<uint64_t>::max()});
+  RoundTripFixedSpan<int32_t>({-1, 0, 1, std::numeric_limits<int32_t>::min(),
+                               std::numeric_limits<int32_t>::max()});
+  RoundTripFixedSpan<int64_t>({-1, 0, 1, std::numeric_limits<int64_t>::min(),
+                               std::numeric_limits<int64_t>::max()});
+  RoundTripFixedSpan<uint64_t>({});
+}
+
+TEST(EndianCodec, VarintSize64) {
+  EXPECT_EQ(1, VarintSize64(0));
+  EXPECT_EQ(1, VarintSize64(0x7f));
+  EXPECT_EQ(2, VarintSize64(0x80));
+  EXPECT_EQ(2, VarintSize64(0x3fff));
+  EXPECT_EQ(3, VarintSize64(0x4000));
+  EXPECT_EQ(10, VarintSize64(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(EndianCodec, VarintRoundTrip) {
+  std::vector<uint64_t> values = {0, 1, 0x7f, 0x80, 300, 0x3fff, 0x4000,
+                                  1ull << 31, 1ull << 42,
+                                  std::numeric_limits<uint64_t>::max()};
+  std::mt19937_64 random(12345);
+  for (int i = 0; i < 1000; ++i) {
+    // Skew toward small values, which dominate real row data.
+    values.push_back(random() >> (random() % 64));
+  }
+
+  std::vector<char> buffer(VarintSize64Span(values.data(), values.size()));
+  char* end = EncodeVarint64Span(values.data(), values.size(), buffer.data());
+  ASSERT_EQ(buffer.data() + buffer.size(), end);
+
+  std::vector<uint64_t> decoded(values.size());
+  const char* read_end =
+      DecodeVarint64Span(buffer.data(), buffer.data() + buffer.size(),
+                         decoded.size(), decoded.data());
+  ASSERT_EQ(buffer.data() + buffer.size(), read_end);
+  EXPECT_EQ(values, decoded);
+
+  // Values must also decode one at a time.
+  const char* p = buffer.data();
+  for (uint64_t expected : values) {
+    uint64_t value;
+    p = DecodeVarint64(p, buffer.data() + buffer.size(), &value);
+    ASSERT_NE(nullptr, p);
+    EXPECT_EQ(expected, value);
+  }
+}
+
+TEST(EndianCodec, VarintMatchesKnownEncoding) {
+  // 300 = 0b10'0101100 encodes as AC 02, the classic protobuf example.
+  char buffer[kMaxVarint64Bytes];
+  char* end = EncodeVarint64(300, buffer);
+  ASSERT_EQ(buffer + 2, end);
+  EXPECT_EQ(0xac, static_cast<uint8_t>(buffer[0]));
+  EXPECT_EQ(0x02, static_cast<uint8_t>(buffer[1]));
+
+  end = EncodeVarint64(std::numeric_limits<uint64_t>::max(), buffer);
+  EXPECT_EQ(buffer + kMaxVarint64Bytes, end);
+}
+
+TEST(EndianCodec, VarintRejectsBadInput) {
+  uint64_t value;
+  // Truncated in the middle of a multi-byte varint.
+  char buffer[kMaxVarint64Bytes];
+  char* end = EncodeVarint64(1ull << 42, buffer);
+  for (const char* limit = buffer; limit < end; ++limit) {
+    EXPECT_EQ(nullptr, DecodeVarint64(buffer, limit, &value));
+  }
+
+  // Empty input.
+  EXPECT_EQ(nullptr, DecodeVarint64(buffer, buffer, &value));
+
+  // Eleven continuation bytes never fit in 64 bits.
+  char too_long[11];
+  memset(too_long, 0x80, sizeof(too_long));
+  EXPECT_EQ(nullptr, DecodeVarint64(too_long, too_long + sizeof(too_long),
+                                    &value));
+
+  // A tenth byte with more than one significant bit overflows.
+  char overflow[kMaxVarint64Bytes];
+  memset(overflow, 0xff, sizeof(overflow));
+  overflow[kMaxVarint64Bytes - 1] = 0x02;
+  EXPECT_EQ(nullptr, DecodeVarint64(overflow,
+                                    overflow + kMaxVarint64Bytes, &value));
+
+  // A batch decode fails as a whole on a truncated element.
+  uint64_t values[2];
+  end = EncodeVarint64Span(values, 0, buffer);
+  EXPECT_EQ(buffer, end);
+  char* batch_end = EncodeVarint64(300, buffer);
+  EXPECT_EQ(nullptr, DecodeVarint64Span(buffer, batch_end, 2, values));
+}
+
+}  // namespace
+}  // namespace zetasql_base
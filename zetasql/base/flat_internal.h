@@ -21,6 +21,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <functional>
+#include <iterator>
 #include <type_traits>
 #include <utility>
 
@@ -53,6 +55,60 @@ constexpr std::pair<T&&, U&&> forward_as_pair(T&& t, U&& u) noexcept {
   return {std::forward<T>(t), std::forward<U>(u)};
 }
 
+// True if lower_bound over a random-access range of Value ordered by Cmp can
+// use the branch-reduced integer implementation below: the values are
+// integral, the probe has the same type, and the comparator is the default
+// std::less, so `left < right` gives exactly the comparator's order.
+template <typename Iterator, typename Probe, typename Cmp>
+struct use_branch_reduced_lower_bound
+    : absl::conjunction<
+          std::is_base_of<
+              std::random_access_iterator_tag,
+              typename std::iterator_traits<Iterator>::iterator_category>,
+          std::is_integral<typename std::iterator_traits<Iterator>::value_type>,
+          std::is_same<typename std::iterator_traits<Iterator>::value_type,
+                       Probe>,
+          absl::disjunction<
+              std::is_same<
+                  Cmp, std::less<
+                           typename std::iterator_traits<Iterator>::value_type>>,
+              std::is_same<Cmp, std::less<>>>> {};
+
+// Branch-reduced lower_bound for random-access ranges of integral values in
+// ascending order.  std::lower_bound guards every halving step with a
+// conditional jump that is essentially unpredictable for random probes; this
+// form updates the base with a conditional move instead, so the only branch
+// left is the well-predicted loop exit.
+template <typename Iterator, typename V>
+Iterator branch_reduced_lower_bound(Iterator begin, Iterator end, const V& v) {
+  typename std::iterator_traits<Iterator>::difference_type length =
+      end - begin;
+  if (length == 0) return begin;
+  while (length > 1) {
+    const auto half = length / 2;
+    begin += (begin[half - 1] < v) ? half : 0;
+    length -= half;
+  }
+  return begin + (*begin < v ? 1 : 0);
+}
+
+// lower_bound entry point used by the flat containers.  Dispatches to the
+// branch-reduced implementation for default-ordered integer keys, and to
+// std::lower_bound otherwise.
+template <typename Iterator, typename V, typename Cmp>
+absl::enable_if_t<use_branch_reduced_lower_bound<Iterator, V, Cmp>::value,
+                  Iterator>
+ordered_lower_bound(Iterator begin, Iterator end, const V& v, Cmp /*cmp*/) {
+  return branch_reduced_lower_bound(begin, end, v);
+}
+
+template <typename Iterator, typename V, typename Cmp>
+absl::enable_if_t<!use_branch_reduced_lower_bound<Iterator, V, Cmp>::value,
+                  Iterator>
+ordered_lower_bound(Iterator begin, Iterator end, const V& v, Cmp cmp) {
+  return std::lower_bound(begin, end, v, cmp);
+}
+
 // Enum to control whether to use insert() vs insert_or_assign() logic
 // in the shared utility functions below.
 enum class OnKeyCollision { kKeepOldValue, kAssignNewValue };
@@ -70,7 +126,7 @@ template <typename Rep, typename V, typename Cmp>
 std::pair<typename Rep::iterator, bool> insert(
     Rep* rep, V&& v, Cmp cmp,
     const OnKeyCollision policy = OnKeyCollision::kKeepOldValue) {
-  auto it = std::lower_bound(rep->begin(), rep->end(), v, cmp);
+  auto it = ordered_lower_bound(rep->begin(), rep->end(), v, cmp);
   if (it == rep->end()) {
     rep->push_back(std::forward<V>(v));
     return {rep->end() - 1, true};
@@ -221,7 +277,7 @@ typename Rep::size_type erase(Rep* rep,
 // Finds a value in an ordered sequence.
 template <typename Iterator, typename V, typename Cmp>
 Iterator ordered_find(Iterator begin, Iterator end, const V& v, Cmp cmp) {
-  auto it = std::lower_bound(begin, end, v, cmp);
+  auto it = ordered_lower_bound(begin, end, v, cmp);
   if (it == end) return it;
   if (cmp(v, *it)) return end;
   return it;
@@ -77,6 +77,35 @@ TEST(FlatInternalTest, VerifyBadHint) {
               Pair(VerifyHintResult::kKeyExists, rep.begin()));
 }
 
+TEST(FlatInternalTest, BranchReducedLowerBound) {
+  const std::less<int> cmp;
+  // Compare against std::lower_bound on every probe into every prefix of a
+  // sorted array with duplicates.
+  const std::vector<int> rep = {0, 2, 2, 4, 6, 6, 6, 9};
+  for (int size = 0; size <= rep.size(); ++size) {
+    for (int probe = -1; probe <= 10; ++probe) {
+      EXPECT_EQ(std::lower_bound(rep.begin(), rep.begin() + size, probe, cmp),
+                branch_reduced_lower_bound(rep.begin(), rep.begin() + size,
+                                           probe))
+          << "size=" << size << " probe=" << probe;
+    }
+  }
+}
+
+TEST(FlatInternalTest, OrderedLowerBoundDispatch) {
+  // Default-ordered integers take the branch-reduced path; both paths must
+  // agree with std::lower_bound.
+  const std::vector<int> ints = {1, 3, 5};
+  EXPECT_EQ(ints.begin() + 1,
+            ordered_lower_bound(ints.begin(), ints.end(), 2, std::less<int>()));
+  // Non-integral values fall back to std::lower_bound.
+  const std::vector<std::string> strings = {"a", "c"};
+  EXPECT_EQ(
+      strings.begin() + 1,
+      ordered_lower_bound(strings.begin(), strings.end(), std::string("b"),
+                          std::less<std::string>()));
+}
+
 TEST(FlatInternalTest, MultiInsertUniqueWithPerfectHint) {
   const value_compare<std::less<int>> cmp;
   std::vector<std::pair<int, int>> rep;
@@ -130,6 +130,20 @@ class flat_set {
   flat_set(sorted_unique_container_t, const Compare& cmp, Args&&... args)
       : impl_(sorted_container, cmp, std::forward<Args>(args)...) {}
 
+  // Named factory over the sorted_unique_container constructor, for callers
+  // that already hold a strictly ordered, duplicate-free container.
+  static flat_set from_sorted_unique(Rep rep, const Compare& cmp = Compare()) {
+    return flat_set(sorted_unique_container, cmp, std::move(rep));
+  }
+
+  // Named factory taking an arbitrarily-ordered container (which may hold
+  // duplicates) and sorting and deduplicating it once.  This is cheaper than
+  // building the set with element-wise insert, which maintains the sorted
+  // order on every insertion.
+  static flat_set from_unsorted(Rep rep, const Compare& cmp = Compare()) {
+    return flat_set(std::move(rep), cmp);
+  }
+
   // iterators:
   iterator begin() { return rep().begin(); }
   const_iterator begin() const { return rep().begin(); }
@@ -250,21 +264,27 @@ class flat_set {
     return find(k) != end();
   }
 
+  // lower_bound dispatches through internal_flat::ordered_lower_bound, which
+  // uses a branch-reduced search for default-ordered integer keys.
   iterator lower_bound(const value_type& v) {
-    return std::lower_bound(rep().begin(), rep().end(), v, key_comp());
+    return internal_flat::ordered_lower_bound(rep().begin(), rep().end(), v,
+                                              key_comp());
   }
   const_iterator lower_bound(const value_type& v) const {
-    return std::lower_bound(rep().begin(), rep().end(), v, key_comp());
+    return internal_flat::ordered_lower_bound(rep().begin(), rep().end(), v,
+                                              key_comp());
   }
   template <typename K>
   absl::enable_if_t<CompareIsTransparent<K>(), iterator> lower_bound(
       const K& v) {
-    return std::lower_bound(rep().begin(), rep().end(), v, key_comp());
+    return internal_flat::ordered_lower_bound(rep().begin(), rep().end(), v,
+                                              key_comp());
   }
   template <typename K>
   absl::enable_if_t<CompareIsTransparent<K>(), const_iterator> lower_bound(
       const K& v) const {
-    return std::lower_bound(rep().begin(), rep().end(), v, key_comp());
+    return internal_flat::ordered_lower_bound(rep().begin(), rep().end(), v,
+                                              key_comp());
   }
 
   iterator upper_bound(const value_type& v) {
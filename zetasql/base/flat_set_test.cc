@@ -377,6 +377,28 @@ TEST(FlatSetTest, BinarySearchesWork) {
   TestBinarySearches<const flat_set<OnlyLT>>();
 }
 
+TEST(FlatSetTest, BinarySearchesWorkForIntegerKeys) {
+  // Integer keys with the default comparator take the branch-reduced
+  // lower_bound in flat_internal.
+  const flat_set<int> s = {1, 3, 5};
+  EXPECT_EQ(s.lower_bound(0), s.begin());
+  EXPECT_EQ(s.lower_bound(3), s.begin() + 1);
+  EXPECT_EQ(s.lower_bound(4), s.begin() + 2);
+  EXPECT_EQ(s.lower_bound(6), s.end());
+  EXPECT_EQ(s.find(5), s.begin() + 2);
+  EXPECT_EQ(s.find(4), s.end());
+  EXPECT_EQ(1, s.count(1));
+  EXPECT_FALSE(s.contains(2));
+}
+
+TEST(FlatSetTest, NamedFactories) {
+  auto unsorted = flat_set<int>::from_unsorted({4, 9, 1, 4});
+  EXPECT_THAT(unsorted, ElementsAre(1, 4, 9));
+
+  auto sorted = flat_set<int>::from_sorted_unique({1, 4, 9});
+  EXPECT_THAT(sorted, ElementsAre(1, 4, 9));
+}
+
 TEST(FlatSetTest, CopyAndAssignmentWork) {
   flat_set<OnlyLT> s;
   s.insert(OnlyLT(1));
@@ -136,6 +136,11 @@ using MapUtilInitT = typename internal_map_util::InitType<M>::type;
 //
 // Find*()
 //
+// The key parameter of these functions is a separate deduced type so that
+// maps supporting heterogeneous lookup (e.g. absl::flat_hash_map with
+// std::string keys probed by absl::string_view) can be searched without
+// materializing a key object.
+//
 
 // Returns a const reference to the value associated with the given key if it
 // exists. Crashes otherwise.
@@ -153,35 +158,34 @@ using MapUtilInitT = typename internal_map_util::InitType<M>::type;
 //
 // This version assumes the key is printable, and includes it in the fatal log
 // message.
-template <typename M>
-const MapUtilMappedT<M>& FindOrDie(const M& m, const MapUtilKeyT<M>& key) {
+template <typename M, typename Key>
+const MapUtilMappedT<M>& FindOrDie(const M& m, const Key& key) {
   auto it = m.find(key);
   CHECK(it != m.end()) << "Map key not found: " << key;
   return zetasql_base::subtle::GetMapped(*it);
 }
 
 // Same as above, but returns a non-const reference.
-template <typename M>
+template <typename M, typename Key>
 MapUtilMappedT<M>& FindOrDie(M& m,  // NOLINT
-                             const MapUtilKeyT<M>& key) {
+                             const Key& key) {
   auto it = m.find(key);
   CHECK(it != m.end()) << "Map key not found: " << key;
   return zetasql_base::subtle::GetMapped(*it);
 }
 
 // Same as FindOrDie above, but doesn't log the key on failure.
-template <typename M>
-const MapUtilMappedT<M>& FindOrDieNoPrint(const M& m,
-                                          const MapUtilKeyT<M>& key) {
+template <typename M, typename Key>
+const MapUtilMappedT<M>& FindOrDieNoPrint(const M& m, const Key& key) {
   auto it = m.find(key);
   CHECK(it != m.end()) << "Map key not found";
   return zetasql_base::subtle::GetMapped(*it);
 }
 
 // Same as above, but returns a non-const reference.
-template <typename M>
+template <typename M, typename Key>
 MapUtilMappedT<M>& FindOrDieNoPrint(M& m,  // NOLINT
-                                    const MapUtilKeyT<M>& key) {
+                                    const Key& key) {
   auto it = m.find(key);
   CHECK(it != m.end()) << "Map key not found";
   return zetasql_base::subtle::GetMapped(*it);
@@ -190,9 +194,8 @@ MapUtilMappedT<M>& FindOrDieNoPrint(M& m,  // NOLINT
 // Returns a const reference to the value associated with the given key if it
 // exists, otherwise returns a const reference to a value-initialized object
 // that is never destroyed.
-template <typename M>
-const MapUtilMappedT<M>& FindWithDefault(const M& m,
-                                         const MapUtilKeyT<M>& key) {
+template <typename M, typename Key>
+const MapUtilMappedT<M>& FindWithDefault(const M& m, const Key& key) {
   auto it = m.find(key);
   if (it != m.end()) return zetasql_base::subtle::GetMapped(*it);
   return internal_map_util::ValueInitializedDefault<MapUtilMappedT<M>>();
@@ -212,8 +215,8 @@ const MapUtilMappedT<M>& FindWithDefault(const M& m,
 // or store it in a std::string (not std::string&).
 //
 // TODO: Stop using this.
-template <typename M>
-const MapUtilMappedT<M>& FindWithDefault(const M& m, const MapUtilKeyT<M>& key,
+template <typename M, typename Key>
+const MapUtilMappedT<M>& FindWithDefault(const M& m, const Key& key,
                                          const MapUtilMappedT<M>& value) {
   auto it = m.find(key);
   if (it != m.end()) return zetasql_base::subtle::GetMapped(*it);
@@ -222,8 +225,8 @@ const MapUtilMappedT<M>& FindWithDefault(const M& m, const MapUtilKeyT<M>& key,
 
 // Returns a pointer to the const value associated with the given key if it
 // exists, or null otherwise.
-template <typename M>
-const MapUtilMappedT<M>* FindOrNull(const M& m, const MapUtilKeyT<M>& key) {
+template <typename M, typename Key>
+const MapUtilMappedT<M>* FindOrNull(const M& m, const Key& key) {
   auto it = m.find(key);
   if (it == m.end()) return nullptr;
   return &zetasql_base::subtle::GetMapped(*it);
@@ -231,9 +234,9 @@ const MapUtilMappedT<M>* FindOrNull(const M& m, const MapUtilKeyT<M>& key) {
 
 // Returns a pointer to the non-const value associated with the given key if it
 // exists, or null otherwise.
-template <typename M>
+template <typename M, typename Key>
 MapUtilMappedT<M>* FindOrNull(M& m,  // NOLINT
-                              const MapUtilKeyT<M>& key) {
+                              const Key& key) {
   auto it = m.find(key);
   if (it == m.end()) return nullptr;
   return &zetasql_base::subtle::GetMapped(*it);
@@ -245,8 +248,8 @@ MapUtilMappedT<M>* FindOrNull(M& m,  // NOLINT
 //
 // This function does not distinguish between a missing key and a key mapped
 // to a null value.
-template <typename M>
-MapUtilMappedT<M> FindPtrOrNull(const M& m, const MapUtilKeyT<M>& key) {
+template <typename M, typename Key>
+MapUtilMappedT<M> FindPtrOrNull(const M& m, const Key& key) {
   auto it = m.find(key);
   if (it == m.end()) return MapUtilMappedT<M>();
   return zetasql_base::subtle::GetMapped(*it);
@@ -256,9 +259,9 @@ MapUtilMappedT<M> FindPtrOrNull(const M& m, const MapUtilKeyT<M>& key) {
 //
 // This function is needed for containers that propagate constness to the
 // pointee, such as boost::ptr_map.
-template <typename M>
+template <typename M, typename Key>
 MapUtilMappedT<M> FindPtrOrNull(M& m,  // NOLINT
-                                const MapUtilKeyT<M>& key) {
+                                const Key& key) {
   auto it = m.find(key);
   if (it == m.end()) return MapUtilMappedT<M>();
   return zetasql_base::subtle::GetMapped(*it);
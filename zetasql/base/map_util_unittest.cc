@@ -28,7 +28,9 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "zetasql/base/logging.h"
 
 // All of the templates for the tests are defined here.
@@ -60,6 +62,30 @@ TEST(MapUtil, ImplicitTypeConversion) {
   EXPECT_TRUE(ContainsKey(m, "foo"));
 }
 
+TEST(MapUtil, HeterogeneousLookup) {
+  // Maps that support heterogeneous lookup can be probed with a key of a
+  // different type, without materializing a key object.  Here the map has
+  // std::string keys and the probes are string_views.
+  absl::flat_hash_map<std::string, int> m;
+  EXPECT_TRUE(InsertOrUpdate(&m, "foo", 1));
+  const absl::string_view foo("foo");
+  const absl::string_view bar("bar");
+  EXPECT_TRUE(ContainsKey(m, foo));
+  EXPECT_FALSE(ContainsKey(m, bar));
+  EXPECT_EQ(1, *FindOrNull(m, foo));
+  EXPECT_EQ(nullptr, FindOrNull(m, bar));
+  EXPECT_EQ(1, FindOrDie(m, foo));
+  EXPECT_EQ(1, FindWithDefault(m, foo));
+  EXPECT_EQ(0, FindWithDefault(m, bar));
+  EXPECT_EQ(2, FindWithDefault(m, bar, 2));
+
+  absl::flat_hash_map<std::string, const int*> ptr_map;
+  const int value = 3;
+  EXPECT_TRUE(InsertOrUpdate(&ptr_map, "foo", &value));
+  EXPECT_EQ(&value, FindPtrOrNull(ptr_map, foo));
+  EXPECT_EQ(nullptr, FindPtrOrNull(ptr_map, bar));
+}
+
 TEST(MapUtil, SetOperations) {
   // Set operations
   using Set = std::set<int>;
@@ -0,0 +1,35 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/trace.h"
+
+namespace zetasql_base {
+
+TraceSink::~TraceSink() {}
+
+namespace internal_trace {
+std::atomic<TraceSink*> g_trace_sink{nullptr};
+}  // namespace internal_trace
+
+void SetTraceSink(TraceSink* sink) {
+  internal_trace::g_trace_sink.store(sink, std::memory_order_release);
+}
+
+TraceSink* GetTraceSink() {
+  return internal_trace::g_trace_sink.load(std::memory_order_acquire);
+}
+
+}  // namespace zetasql_base
@@ -0,0 +1,132 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_TRACE_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_TRACE_H_
+
+// A lightweight structured tracing facility for hot paths.
+//
+// Trace points mark spans (begin/end pairs) at interesting boundaries, such
+// as the analyzer's parse/resolve/validate phases or a reference
+// implementation operator's open/next/close. Events go to a process-wide
+// caller-registered TraceSink, which embedders can bridge to their tracing
+// system (e.g., Perfetto). Unlike logging, no strings are formatted: a trace
+// point passes a statically-allocated name and, optionally, a detail string
+// that is only computed when a sink is registered.
+//
+// Cost: with no sink registered, a trace point is one atomic load and
+// a predictable branch, cheap enough for row-granularity use. Defining
+// ZETASQL_DISABLE_TRACING removes trace points at compile time entirely.
+//
+// Usage:
+//   {
+//     ZETASQL_TRACE_SPAN("AnalyzeStatement::Parse");
+//     ... the work being traced ...
+//   }  // The span ends when the scope exits.
+
+#include <atomic>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql_base {
+
+// Receives trace events from all threads. Implementations must be
+// thread-safe. On each thread, calls are balanced and properly nested: every
+// BeginSpan() is followed by a matching EndSpan() on the same thread, with
+// inner spans ending before outer ones.
+class TraceSink {
+ public:
+  virtual ~TraceSink();
+
+  // Called when a traced span begins. 'name' points to a statically-allocated
+  // string, so sinks may key on the pointer value. 'detail' is optional
+  // context (e.g., an operator's debug string) valid only for the duration of
+  // the call; it is empty for most spans.
+  virtual void BeginSpan(const char* name, absl::string_view detail) = 0;
+
+  // Called when the most recently begun span on the calling thread ends.
+  virtual void EndSpan() = 0;
+};
+
+// Registers 'sink' to receive trace events from all threads, replacing any
+// previously-registered sink, or disables tracing if 'sink' is null. Does not
+// take ownership; 'sink' must outlive all traced work. There is no
+// synchronization with in-flight trace points, so this is typically called
+// once at startup (and spans in flight across a change may be unbalanced).
+void SetTraceSink(TraceSink* sink);
+
+// Returns the registered sink, or null if tracing is disabled.
+TraceSink* GetTraceSink();
+
+namespace internal_trace {
+
+extern std::atomic<TraceSink*> g_trace_sink;
+
+// The object behind ZETASQL_TRACE_SPAN. Samples the sink once at
+// construction so that Begin/End calls are always balanced even if the sink
+// is swapped mid-span.
+class ScopedTraceSpan {
+ public:
+  explicit ScopedTraceSpan(const char* name)
+      : sink_(g_trace_sink.load(std::memory_order_acquire)) {
+    if (sink_ != nullptr) sink_->BeginSpan(name, /*detail=*/{});
+  }
+
+  // 'detail_fn' is only invoked if a sink is registered.
+  template <typename DetailFn>
+  ScopedTraceSpan(const char* name, DetailFn&& detail_fn)
+      : sink_(g_trace_sink.load(std::memory_order_acquire)) {
+    if (sink_ != nullptr) sink_->BeginSpan(name, detail_fn());
+  }
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+  ~ScopedTraceSpan() {
+    if (sink_ != nullptr) sink_->EndSpan();
+  }
+
+ private:
+  TraceSink* const sink_;
+};
+
+}  // namespace internal_trace
+}  // namespace zetasql_base
+
+#ifdef ZETASQL_DISABLE_TRACING
+
+#define ZETASQL_TRACE_SPAN(...) \
+  do {                          \
+  } while (false)
+
+#else
+
+#define ZETASQL_TRACE_INTERNAL_CONCAT2(a, b) a##b
+#define ZETASQL_TRACE_INTERNAL_CONCAT(a, b) ZETASQL_TRACE_INTERNAL_CONCAT2(a, b)
+
+// Begins a span that ends when the enclosing scope exits. The first argument
+// is the span name, which must be a string literal (or otherwise outlive the
+// program). An optional second argument is a callable returning the detail
+// string; it is only invoked when a sink is registered.
+#define ZETASQL_TRACE_SPAN(...)                               \
+  ::zetasql_base::internal_trace::ScopedTraceSpan             \
+      ZETASQL_TRACE_INTERNAL_CONCAT(zetasql_trace_span_,      \
+                                    __LINE__)(__VA_ARGS__)
+
+#endif  // ZETASQL_DISABLE_TRACING
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_TRACE_H_
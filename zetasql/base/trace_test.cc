@@ -0,0 +1,121 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/trace.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Records events as strings for inspection. Single-threaded; tests that use
+// it do not trace from other threads.
+class RecordingSink : public zetasql_base::TraceSink {
+ public:
+  void BeginSpan(const char* name, absl::string_view detail) override {
+    if (detail.empty()) {
+      events_.push_back(absl::StrCat("begin ", name));
+    } else {
+      events_.push_back(absl::StrCat("begin ", name, " [", detail, "]"));
+    }
+  }
+
+  void EndSpan() override { events_.push_back("end"); }
+
+  const std::vector<std::string>& events() const { return events_; }
+
+ private:
+  std::vector<std::string> events_;
+};
+
+// Restores the no-sink default state when a test exits, even on failure.
+class ScopedSink {
+ public:
+  explicit ScopedSink(zetasql_base::TraceSink* sink) {
+    zetasql_base::SetTraceSink(sink);
+  }
+  ~ScopedSink() { zetasql_base::SetTraceSink(nullptr); }
+};
+
+TEST(TraceTest, NoSinkRegistered) {
+  ASSERT_EQ(zetasql_base::GetTraceSink(), nullptr);
+  // Must not crash.
+  ZETASQL_TRACE_SPAN("orphan");
+}
+
+TEST(TraceTest, NestedSpans) {
+  RecordingSink sink;
+  ScopedSink scoped_sink(&sink);
+  EXPECT_EQ(zetasql_base::GetTraceSink(), &sink);
+  {
+    ZETASQL_TRACE_SPAN("outer");
+    {
+      ZETASQL_TRACE_SPAN("inner");
+    }
+  }
+  EXPECT_THAT(sink.events(),
+              ElementsAre("begin outer", "begin inner", "end", "end"));
+}
+
+TEST(TraceTest, DetailCallback) {
+  RecordingSink sink;
+  ScopedSink scoped_sink(&sink);
+  {
+    ZETASQL_TRACE_SPAN("op", [] { return std::string("ScanOp"); });
+  }
+  EXPECT_THAT(sink.events(), ElementsAre("begin op [ScanOp]", "end"));
+}
+
+TEST(TraceTest, DetailCallbackNotInvokedWithoutSink) {
+  bool invoked = false;
+  {
+    ZETASQL_TRACE_SPAN("op", [&invoked] {
+      invoked = true;
+      return std::string("unused");
+    });
+  }
+  EXPECT_FALSE(invoked);
+}
+
+TEST(TraceTest, SinkSwapMidSpanKeepsCallsBalanced) {
+  RecordingSink sink;
+  zetasql_base::SetTraceSink(&sink);
+  {
+    ZETASQL_TRACE_SPAN("span");
+    // The span captured 'sink' at construction; removing the global sink
+    // must not suppress the matching EndSpan() call.
+    zetasql_base::SetTraceSink(nullptr);
+  }
+  EXPECT_THAT(sink.events(), ElementsAre("begin span", "end"));
+
+  // Conversely, a span begun with no sink stays silent even if a sink
+  // appears before it ends.
+  RecordingSink late_sink;
+  {
+    ZETASQL_TRACE_SPAN("late");
+    ScopedSink scoped_sink(&late_sink);
+  }
+  EXPECT_THAT(late_sink.events(), IsEmpty());
+}
+
+}  // namespace
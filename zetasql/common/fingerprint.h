@@ -0,0 +1,63 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_COMMON_FINGERPRINT_H_
+#define ZETASQL_COMMON_FINGERPRINT_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+
+// Helpers for building stable 64-bit fingerprints of options objects, used
+// as cache keys (e.g. LanguageOptions::fingerprint()).
+//
+// These use FNV-1a rather than absl::Hash because absl::Hash is randomly
+// seeded per process, while fingerprints must be deterministic across
+// processes and builds so they can be compared between servers or persisted.
+// The combine step is not commutative, so callers must feed fields in a
+// fixed order, and variable-length fields should be preceded by their size
+// to keep the encoding unambiguous.
+
+// The FNV-1a 64-bit offset basis; use as the initial fingerprint value.
+constexpr uint64_t kFingerprintSeed = 0xcbf29ce484222325u;
+
+// Combines one 64-bit value into 'fingerprint', one FNV-1a step per byte.
+inline uint64_t FingerprintCombine(uint64_t fingerprint, uint64_t value) {
+  constexpr uint64_t kFnvPrime = 0x00000100000001b3u;
+  for (int i = 0; i < 8; ++i) {
+    fingerprint = (fingerprint ^ (value & 0xff)) * kFnvPrime;
+    value >>= 8;
+  }
+  return fingerprint;
+}
+
+// Combines a string into 'fingerprint', including its size so that
+// consecutive strings cannot alias each other.
+inline uint64_t FingerprintCombine(uint64_t fingerprint,
+                                   absl::string_view value) {
+  constexpr uint64_t kFnvPrime = 0x00000100000001b3u;
+  fingerprint = FingerprintCombine(fingerprint, value.size());
+  for (char c : value) {
+    fingerprint = (fingerprint ^ static_cast<unsigned char>(c)) * kFnvPrime;
+  }
+  return fingerprint;
+}
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_COMMON_FINGERPRINT_H_
@@ -74,6 +74,8 @@ class InternalValue {
   // order_kind()=kIgnoresOrder are compared as multisets to respective arrays
   // in 'y' value. If 'reason' is not null, upon inequality it may be set to
   // human-readable explanation of what parts of values differ or cleared.
+  // Large arrays in the explanation are rendered in capped form (see
+  // Value::CappedDebugString()) to keep it readable and cheap to build.
   static bool Equals(const Value& x, const Value& y,
                      FloatMargin float_margin = kExactFloatMargin,
                      std::string* reason = nullptr) {
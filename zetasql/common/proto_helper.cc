@@ -16,13 +16,17 @@
 
 #include "zetasql/common/proto_helper.h"
 
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 #include "zetasql/common/errors.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/ret_check.h"
@@ -85,6 +89,71 @@ zetasql_base::Status PopulateFileDescriptorSet(
   return zetasql_base::OkStatus();
 }
 
+const std::vector<const google::protobuf::FileDescriptor*>&
+FileDescriptorClosureCache::GetTransitiveClosure(
+    const google::protobuf::FileDescriptor* file_descr) {
+  absl::MutexLock lock(&mutex_);
+  return GetTransitiveClosureLocked(file_descr);
+}
+
+const std::vector<const google::protobuf::FileDescriptor*>&
+FileDescriptorClosureCache::GetTransitiveClosureLocked(
+    const google::protobuf::FileDescriptor* file_descr) {
+  std::unique_ptr<std::vector<const google::protobuf::FileDescriptor*>>& closure =
+      closures_[file_descr];
+  if (closure != nullptr) {
+    return *closure;
+  }
+  // FileDescriptor dependencies do not allow circular dependencies, so this
+  // cannot recurse indefinitely, and the sub-closures it computes along the
+  // way are themselves memoized.
+  auto new_closure =
+      absl::make_unique<std::vector<const google::protobuf::FileDescriptor*>>();
+  std::set<const google::protobuf::FileDescriptor*> seen;
+  for (int idx = 0; idx < file_descr->dependency_count(); ++idx) {
+    for (const google::protobuf::FileDescriptor* dependency :
+         GetTransitiveClosureLocked(file_descr->dependency(idx))) {
+      if (zetasql_base::InsertIfNotPresent(&seen, dependency)) {
+        new_closure->push_back(dependency);
+      }
+    }
+  }
+  new_closure->push_back(file_descr);
+  // The recursive calls above may have rehashed <closures_>, invalidating
+  // <closure>, so look the entry up again.
+  std::unique_ptr<std::vector<const google::protobuf::FileDescriptor*>>& entry =
+      closures_[file_descr];
+  entry = std::move(new_closure);
+  return *entry;
+}
+
+zetasql_base::Status PopulateFileDescriptorSet(
+    const google::protobuf::FileDescriptor* file_descr,
+    absl::optional<int64_t> file_descriptor_set_max_size_bytes,
+    FileDescriptorClosureCache* closure_cache,
+    google::protobuf::FileDescriptorSet* file_descriptor_set,
+    std::set<const google::protobuf::FileDescriptor*>* file_descriptors) {
+  ZETASQL_RET_CHECK(closure_cache != nullptr);
+  ZETASQL_RET_CHECK(file_descriptor_set != nullptr);
+  ZETASQL_RET_CHECK(file_descriptors != nullptr);
+  for (const google::protobuf::FileDescriptor* file :
+       closure_cache->GetTransitiveClosure(file_descr)) {
+    if (zetasql_base::InsertIfNotPresent(file_descriptors, file)) {
+      file->CopyTo(file_descriptor_set->add_file());
+    }
+  }
+  if (file_descriptor_set_max_size_bytes.has_value() &&
+      file_descriptor_set->ByteSizeLong() >
+          file_descriptor_set_max_size_bytes.value()) {
+    return MakeSqlError()
+        << "Serializing proto descriptors failed due to maximum "
+        << "FileDescriptorSet size exceeded, max = "
+        << file_descriptor_set_max_size_bytes.value() << ", size = "
+        << file_descriptor_set->ByteSizeLong();
+  }
+  return zetasql_base::OkStatus();
+}
+
 zetasql_base::Status AddFileDescriptorSetToPool(
     const google::protobuf::FileDescriptorSet* file_descriptor_set,
     google::protobuf::DescriptorPool* pool) {
@@ -17,12 +17,17 @@
 #ifndef ZETASQL_COMMON_PROTO_HELPER_H_
 #define ZETASQL_COMMON_PROTO_HELPER_H_
 
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "google/protobuf/compiler/importer.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "zetasql/base/status.h"
 
@@ -83,6 +88,53 @@ zetasql_base::Status PopulateFileDescriptorSet(
     google::protobuf::FileDescriptorSet* file_descriptor_set,
     std::set<const google::protobuf::FileDescriptor*>* file_descriptors);
 
+// Computes and memoizes the transitive dependency closures of
+// FileDescriptors, so that repeated serialization of types from the same
+// .proto files does not walk the same dependency graph again and again.
+// Closures are returned in dependency order (referenced files before
+// referencing files), matching the order PopulateFileDescriptorSet() emits.
+// Every FileDescriptor passed in must outlive this cache, so a cache should
+// serve only DescriptorPools at least as long-lived as itself. Thread-safe.
+class FileDescriptorClosureCache {
+ public:
+  FileDescriptorClosureCache() {}
+
+  // Not copyable or movable.
+  FileDescriptorClosureCache(const FileDescriptorClosureCache&) = delete;
+  FileDescriptorClosureCache& operator=(const FileDescriptorClosureCache&) =
+      delete;
+
+  // Returns the transitive dependency closure of <file_descr> (which includes
+  // <file_descr> itself, in last position), computing and caching it on first
+  // use. The returned reference is valid for the life of this cache.
+  const std::vector<const google::protobuf::FileDescriptor*>& GetTransitiveClosure(
+      const google::protobuf::FileDescriptor* file_descr) LOCKS_EXCLUDED(mutex_);
+
+ private:
+  const std::vector<const google::protobuf::FileDescriptor*>&
+  GetTransitiveClosureLocked(const google::protobuf::FileDescriptor* file_descr)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  // unique_ptr gives the closure vectors stable addresses across rehashes.
+  absl::flat_hash_map<
+      const google::protobuf::FileDescriptor*,
+      std::unique_ptr<std::vector<const google::protobuf::FileDescriptor*>>>
+      closures_ GUARDED_BY(mutex_);
+};
+
+// Form of PopulateFileDescriptorSet() that takes the dependency closure from
+// <closure_cache> instead of walking the dependency graph. Produces the same
+// <file_descriptor_set> and <file_descriptors> as the uncached form. Callers
+// that serialize types from the same files repeatedly (e.g., a catalog
+// serialized per request) should hold a long-lived cache and use this form.
+zetasql_base::Status PopulateFileDescriptorSet(
+    const google::protobuf::FileDescriptor* file_descr,
+    absl::optional<int64_t> file_descriptor_set_max_size_bytes,
+    FileDescriptorClosureCache* closure_cache,
+    google::protobuf::FileDescriptorSet* file_descriptor_set,
+    std::set<const google::protobuf::FileDescriptor*>* file_descriptors);
+
 // Deserialize a FileDescriptorSet and add all FileDescriptors into the given
 // DescriptorPool.
 // Return an error status if the FileDescriptorSet is incomplete or contain
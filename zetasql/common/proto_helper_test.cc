@@ -135,6 +135,74 @@ TEST_F(ProtoHelperTest, PopulateFileDescriptorSet) {
   ASSERT_EQ(expected_proto_matchers.size(), file_descriptors.size());
 }
 
+TEST_F(ProtoHelperTest, FileDescriptorClosureCache) {
+  const google::protobuf::FileDescriptor* file = pool_->FindFileByName(
+      "zetasql/testdata/test_schema.proto");
+  FileDescriptorClosureCache cache;
+  const std::vector<const google::protobuf::FileDescriptor*>& closure =
+      cache.GetTransitiveClosure(file);
+  ASSERT_EQ(4, closure.size());
+  // Referenced files come before referencing files, with <file> itself last.
+  EXPECT_THAT(closure.front()->name(), HasSubstr("/descriptor.proto"));
+  EXPECT_EQ(file, closure.back());
+
+  // A second lookup returns the same memoized closure.
+  EXPECT_EQ(&closure, &cache.GetTransitiveClosure(file));
+
+  // A sub-closure memoized along the way is consistent with a direct lookup.
+  const google::protobuf::FileDescriptor* type_annotation_file = pool_->FindFileByName(
+      "zetasql/public/proto/type_annotation.proto");
+  const std::vector<const google::protobuf::FileDescriptor*>& sub_closure =
+      cache.GetTransitiveClosure(type_annotation_file);
+  ASSERT_EQ(2, sub_closure.size());
+  EXPECT_EQ(type_annotation_file, sub_closure.back());
+}
+
+TEST_F(ProtoHelperTest, PopulateFileDescriptorSet_Cached) {
+  const google::protobuf::FileDescriptor* file = pool_->FindFileByName(
+      "zetasql/testdata/test_schema.proto");
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  std::set<const google::protobuf::FileDescriptor*> file_descriptors;
+  ZETASQL_ASSERT_OK(PopulateFileDescriptorSet(file, absl::optional<int64_t>(),
+                                      &file_descriptor_set, &file_descriptors));
+
+  // The cached form produces the same set, in the same order, as the
+  // uncached form.
+  FileDescriptorClosureCache cache;
+  google::protobuf::FileDescriptorSet cached_file_descriptor_set;
+  std::set<const google::protobuf::FileDescriptor*> cached_file_descriptors;
+  ZETASQL_ASSERT_OK(PopulateFileDescriptorSet(file, absl::optional<int64_t>(), &cache,
+                                      &cached_file_descriptor_set,
+                                      &cached_file_descriptors));
+  EXPECT_EQ(file_descriptor_set.DebugString(),
+            cached_file_descriptor_set.DebugString());
+  EXPECT_EQ(file_descriptors, cached_file_descriptors);
+
+  // Populating again into the same output is a no-op, matching the
+  // deduplication behavior of the uncached form.
+  ZETASQL_ASSERT_OK(PopulateFileDescriptorSet(file, absl::optional<int64_t>(), &cache,
+                                      &cached_file_descriptor_set,
+                                      &cached_file_descriptors));
+  EXPECT_EQ(file_descriptor_set.file_size(),
+            cached_file_descriptor_set.file_size());
+}
+
+TEST_F(ProtoHelperTest, PopulateFileDescriptorSet_CachedTooBig) {
+  const google::protobuf::FileDescriptor* file = pool_->FindFileByName(
+      "zetasql/public/proto/type_annotation.proto");
+  FileDescriptorClosureCache cache;
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  std::set<const google::protobuf::FileDescriptor*> file_descriptors;
+  const zetasql_base::Status status = PopulateFileDescriptorSet(
+      file, /*file_descriptor_set_max_size_bytes=*/0, &cache,
+      &file_descriptor_set, &file_descriptors);
+  ASSERT_FALSE(status.ok()) << status;
+  EXPECT_THAT(status,
+              StatusIs(_, testing::HasSubstr(
+                              "Serializing proto descriptors failed due "
+                              "to maximum FileDescriptorSet size exceeded")));
+}
+
 TEST_F(ProtoHelperTest, PopulateFileDescriptorSet_TooBig) {
   const google::protobuf::FileDescriptor* file = pool_->FindFileByName(
       "zetasql/public/proto/type_annotation.proto");
@@ -23,6 +23,39 @@ ABSL_FLAG(int64_t, zetasql_simple_iterator_call_time_now_rows_period, 1000,
 
 namespace zetasql {
 
+namespace {
+
+// Returns true if 'value' passes 'filter'. Unknown filter kinds keep the row.
+bool ValuePassesFilter(const Value& value, const ColumnFilter& filter) {
+  switch (filter.kind()) {
+    case ColumnFilter::kRange: {
+      const Value& lower_bound = filter.lower_bound();
+      const Value& upper_bound = filter.upper_bound();
+      if (lower_bound.is_valid() &&
+          !(lower_bound.SqlLessThan(value) == values::True()) &&
+          !(lower_bound.SqlEquals(value) == values::True())) {
+        return false;
+      }
+      if (upper_bound.is_valid() &&
+          !(value.SqlLessThan(upper_bound) == values::True()) &&
+          !(value.SqlEquals(upper_bound) == values::True())) {
+        return false;
+      }
+      return true;
+    }
+    case ColumnFilter::kInList:
+      for (const Value& element : filter.in_list()) {
+        if (value.SqlEquals(element) == values::True()) return true;
+      }
+      return false;
+    default:
+      // Skip this unknown column filter.
+      return true;
+  }
+}
+
+}  // namespace
+
 zetasql_base::Status SimpleEvaluatorTableIterator::SetColumnFilterMap(
     absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map) {
   filter_map_.clear();
@@ -56,33 +89,7 @@ bool SimpleEvaluatorTableIterator::NextRow() {
       const std::unique_ptr<ColumnFilter>& filter = entry.second;
 
       const Value& value = (*column_major_values_[column_idx])[row_idx_];
-      switch (filter->kind()) {
-        case ColumnFilter::kRange: {
-          const Value& lower_bound = filter->lower_bound();
-          const Value& upper_bound = filter->upper_bound();
-          keep_row = !lower_bound.is_valid() ||
-                     (lower_bound.SqlLessThan(value) == values::True()) ||
-                     (lower_bound.SqlEquals(value) == values::True());
-          if (!keep_row) break;
-          keep_row = !upper_bound.is_valid() ||
-                     (value.SqlLessThan(upper_bound) == values::True()) ||
-                     (value.SqlEquals(upper_bound) == values::True());
-          break;
-        }
-        case ColumnFilter::kInList:
-          keep_row = false;
-          for (const Value& element : filter->in_list()) {
-            if (value.SqlEquals(element) == values::True()) {
-              keep_row = true;
-              break;
-            }
-          }
-          break;
-        default:
-          // Skip this unknown column filter.
-          keep_row = true;
-          break;
-      }
+      keep_row = ValuePassesFilter(value, *filter);
     }
 
     if (keep_row) return true;
@@ -91,4 +98,83 @@ bool SimpleEvaluatorTableIterator::NextRow() {
   return false;
 }
 
+zetasql_base::Status PagedEvaluatorTableIterator::SetColumnFilterMap(
+    absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map) {
+  filter_map_.clear();
+  for (auto& entry : filter_map) {
+    if (filter_column_idxs_.contains(entry.first)) {
+      ZETASQL_RET_CHECK(filter_map_.insert(std::move(entry)).second);
+    }
+  }
+  return zetasql_base::OkStatus();
+}
+
+bool PagedEvaluatorTableIterator::LoadNextPageLocked() {
+  page_start_row_idx_ += rows_in_page_;
+  page_ = Page();
+  rows_in_page_ = 0;
+  row_idx_in_page_ = -1;
+
+  pager_status_ = pager_(page_start_row_idx_, &page_);
+  if (!pager_status_.ok()) return false;
+  if (page_.column_major_values.empty()) {
+    done_ = true;
+    return false;
+  }
+  if (page_.column_major_values.size() != columns_.size()) {
+    pager_status_ = zetasql_base::InternalErrorBuilder()
+                    << "Pager returned " << page_.column_major_values.size()
+                    << " columns for a scan of " << columns_.size()
+                    << " columns";
+    return false;
+  }
+  rows_in_page_ = page_.column_major_values[0]->size();
+  for (const auto& values_for_column : page_.column_major_values) {
+    if (values_for_column->size() != rows_in_page_) {
+      pager_status_ = zetasql_base::InternalErrorBuilder()
+                      << "Pager returned columns with different numbers of "
+                      << "rows: " << rows_in_page_ << " vs. "
+                      << values_for_column->size();
+      return false;
+    }
+  }
+  if (rows_in_page_ == 0) {
+    done_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool PagedEvaluatorTableIterator::NextRow() {
+  absl::MutexLock l(&mutex_);
+  if (cancelled_ || done_ || !pager_status_.ok()) return false;
+
+  while (true) {
+    if (row_idx_in_page_ + 1 >= rows_in_page_) {
+      if (!LoadNextPageLocked()) return false;
+    }
+    ++row_idx_in_page_;
+
+    if (((page_start_row_idx_ + row_idx_in_page_) %
+             absl::GetFlag(
+                 FLAGS_zetasql_simple_iterator_call_time_now_rows_period) ==
+         0) &&
+        clock_->TimeNow() > deadline_) {
+      deadline_exceeded_ = true;
+      return false;
+    }
+
+    bool keep_row = true;
+    for (const auto& entry : filter_map_) {
+      const Value& value =
+          (*page_.column_major_values[entry.first])[row_idx_in_page_];
+      if (!ValuePassesFilter(value, *entry.second)) {
+        keep_row = false;
+        break;
+      }
+    }
+    if (keep_row) return true;
+  }
+}
+
 }  // namespace zetasql
@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "zetasql/base/logging.h"
@@ -34,6 +35,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/status.h"
@@ -96,6 +98,12 @@ class SimpleEvaluatorTableIterator : public EvaluatorTableIterator {
       absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map)
       override;
 
+  // An upper bound: rows skipped by the column filters are still counted.
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    absl::ReaderMutexLock l(&mutex_);
+    return num_rows_;
+  }
+
   bool NextRow() override;
 
   const Value& GetValue(int i) const override {
@@ -159,6 +167,133 @@ class SimpleEvaluatorTableIterator : public EvaluatorTableIterator {
   absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map_;
 };
 
+// A variant of SimpleEvaluatorTableIterator that loads column pages on demand
+// from a caller-supplied pager instead of holding the whole table in memory.
+// Only one page is resident at a time, so tables much larger than RAM can
+// back an evaluator scan.
+class PagedEvaluatorTableIterator : public EvaluatorTableIterator {
+ public:
+  // One page of rows in column-major form. '(*column_major_values[i])[j]' is
+  // the value of column 'i' in the j-th row of the page. All columns must
+  // have the same number of rows, and the number of columns must match the
+  // 'columns' passed to the constructor. An empty
+  // 'column_major_values' marks the end of the table.
+  struct Page {
+    std::vector<std::shared_ptr<const std::vector<Value>>> column_major_values;
+  };
+
+  // Fills '*page' with the page starting at row 'start_row_idx' (the number
+  // of rows returned by all previous calls). Called with a default-constructed
+  // '*page'; page sizes may vary between calls. Errors are returned to the
+  // caller through Status().
+  using PagerCallback =
+      std::function<zetasql_base::Status(int64_t start_row_idx, Page* page)>;
+
+  // 'columns', 'end_status', 'filter_column_idxs', 'cancel_cb',
+  // 'set_deadline_cb' and 'clock' are as for SimpleEvaluatorTableIterator.
+  PagedEvaluatorTableIterator(
+      const std::vector<const Column*>& columns, PagerCallback pager,
+      const zetasql_base::Status& end_status,
+      const absl::flat_hash_set<int>& filter_column_idxs,
+      const std::function<void()>& cancel_cb,
+      const std::function<void(absl::Time)>& set_deadline_cb,
+      zetasql_base::Clock* clock)
+      : columns_(columns),
+        pager_(std::move(pager)),
+        end_status_(end_status),
+        filter_column_idxs_(filter_column_idxs),
+        cancel_cb_(cancel_cb),
+        set_deadline_cb_(set_deadline_cb),
+        clock_(clock) {
+    CHECK(pager_ != nullptr);
+  }
+
+  PagedEvaluatorTableIterator(const PagedEvaluatorTableIterator&) = delete;
+  PagedEvaluatorTableIterator& operator=(const PagedEvaluatorTableIterator&) =
+      delete;
+
+  int NumColumns() const override { return columns_.size(); }
+
+  std::string GetColumnName(int i) const override {
+    return columns_[i]->Name();
+  }
+
+  const Type* GetColumnType(int i) const override {
+    return columns_[i]->GetType();
+  }
+
+  zetasql_base::Status SetColumnFilterMap(
+      absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map)
+      override;
+
+  bool NextRow() override;
+
+  const Value& GetValue(int i) const override {
+    absl::ReaderMutexLock l(&mutex_);
+    return (*page_.column_major_values[i])[row_idx_in_page_];
+  }
+
+  zetasql_base::Status Status() const override {
+    absl::ReaderMutexLock l(&mutex_);
+    if (cancelled_) {
+      return zetasql_base::CancelledErrorBuilder()
+             << "PagedEvaluatorTableIterator was cancelled";
+    }
+    if (deadline_exceeded_) {
+      return zetasql_base::DeadlineExceededErrorBuilder()
+             << "PagedEvaluatorTableIterator deadline exceeded";
+    }
+    if (!pager_status_.ok()) return pager_status_;
+    if (done_) return end_status_;
+    return zetasql_base::OkStatus();
+  }
+
+  zetasql_base::Status Cancel() override {
+    absl::MutexLock l(&mutex_);
+    cancelled_ = true;
+    cancel_cb_();
+    return zetasql_base::OkStatus();
+  }
+
+  void SetDeadline(absl::Time deadline) override {
+    absl::MutexLock l(&mutex_);
+    deadline_ = deadline;
+    set_deadline_cb_(deadline);
+  }
+
+ private:
+  // Replaces 'page_' with the next page from 'pager_'. Sets 'done_' at the
+  // end of the table and 'pager_status_' on pager or validation errors.
+  // Returns true if the new page has at least one row.
+  bool LoadNextPageLocked() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::vector<const Column*> columns_;
+  const PagerCallback pager_;
+  const zetasql_base::Status end_status_;
+  const absl::flat_hash_set<int> filter_column_idxs_;
+  const std::function<void()> cancel_cb_;
+  const std::function<void(absl::Time)> set_deadline_cb_;
+
+  mutable absl::Mutex mutex_;
+
+  Page page_ GUARDED_BY(mutex_);
+  // The global row index of the first row in 'page_'.
+  int64_t page_start_row_idx_ GUARDED_BY(mutex_) = 0;
+  int64_t rows_in_page_ GUARDED_BY(mutex_) = 0;
+  int64_t row_idx_in_page_ GUARDED_BY(mutex_) = -1;
+  bool done_ GUARDED_BY(mutex_) = false;
+  zetasql_base::Status pager_status_ GUARDED_BY(mutex_);
+
+  bool cancelled_ GUARDED_BY(mutex_) = false;
+  bool deadline_exceeded_ GUARDED_BY(mutex_) = false;
+  absl::Time deadline_ GUARDED_BY(mutex_) = absl::InfiniteFuture();
+  zetasql_base::Clock* clock_ GUARDED_BY(mutex_) PT_GUARDED_BY(mutex_);
+
+  // Contains the entries passed to 'filter_map' that are in
+  // 'filter_column_idxs_'.
+  absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map_;
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_COMMON_SIMPLE_EVALUATOR_TABLE_ITERATOR_H_
@@ -200,5 +200,168 @@ TEST_F(ColumnFilterTest, DeletionsInThreeColumnsOnlyRespectTwo) {
                                ElementsAre(Int64(4), Int64(40), Int64(400)))));
 }
 
+// Fixture for tests of PagedEvaluatorTableIterator. The pager serves the same
+// table as ColumnFilterTest in pages of 'page_size' rows.
+class PagedIteratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (int i = 1; i <= 3; ++i) {
+      columns_.push_back(absl::make_unique<SimpleColumn>(
+          "TestTable", absl::StrCat("column", i), Int64Type()));
+    }
+  }
+
+  void ResetIter(int64_t page_size,
+                 const absl::flat_hash_set<int> filter_column_idxs = {0, 1,
+                                                                      2}) {
+    std::vector<const Column*> columns;
+    columns.reserve(columns_.size());
+    for (const std::unique_ptr<Column>& column : columns_) {
+      columns.push_back(column.get());
+    }
+
+    const std::vector<std::vector<Value>> column_major_values = {
+        {Int64(1), Int64(2), Int64(3), Int64(4)},
+        {Int64(10), Int64(20), Int64(30), Int64(40)},
+        {Int64(100), Int64(200), Int64(300), Int64(400)}};
+
+    const auto pager = [column_major_values, page_size](
+                           int64_t start_row_idx,
+                           PagedEvaluatorTableIterator::Page* page) {
+      const int64_t num_rows = column_major_values[0].size();
+      if (start_row_idx >= num_rows) return zetasql_base::OkStatus();
+      const int64_t end_row_idx =
+          std::min(num_rows, start_row_idx + page_size);
+      for (const std::vector<Value>& values : column_major_values) {
+        page->column_major_values.push_back(
+            std::make_shared<const std::vector<Value>>(
+                values.begin() + start_row_idx, values.begin() + end_row_idx));
+      }
+      return zetasql_base::OkStatus();
+    };
+
+    iter_ = absl::WrapUnique(new PagedEvaluatorTableIterator(
+        columns, pager,
+        /*end_status=*/zetasql_base::OkStatus(), filter_column_idxs,
+        /*cancel_cb=*/[]() {}, /*set_deadline_cb=*/[](absl::Time) {},
+        zetasql_base::Clock::RealClock()));
+  }
+
+  zetasql_base::StatusOr<std::vector<std::vector<Value>>> Read(
+      absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map) {
+    ZETASQL_RETURN_IF_ERROR(iter_->SetColumnFilterMap(std::move(filter_map)));
+
+    std::vector<std::vector<Value>> rows;
+    while (true) {
+      if (!iter_->NextRow()) {
+        ZETASQL_RETURN_IF_ERROR(iter_->Status());
+        return rows;
+      }
+
+      std::vector<Value> row;
+      row.reserve(iter_->NumColumns());
+      for (int i = 0; i < iter_->NumColumns(); ++i) {
+        row.push_back(iter_->GetValue(i));
+      }
+      rows.push_back(std::move(row));
+    }
+  }
+
+ protected:
+  std::vector<std::unique_ptr<Column>> columns_;
+  std::unique_ptr<PagedEvaluatorTableIterator> iter_;
+};
+
+TEST_F(PagedIteratorTest, AllRowsAcrossPages) {
+  for (const int64_t page_size : {1, 2, 3, 4, 10}) {
+    ResetIter(page_size);
+    EXPECT_THAT(
+        Read(/*filter_map=*/{}),
+        IsOkAndHolds(ElementsAre(ElementsAre(Int64(1), Int64(10), Int64(100)),
+                                 ElementsAre(Int64(2), Int64(20), Int64(200)),
+                                 ElementsAre(Int64(3), Int64(30), Int64(300)),
+                                 ElementsAre(Int64(4), Int64(40), Int64(400)))))
+        << "page_size: " << page_size;
+  }
+}
+
+TEST_F(PagedIteratorTest, FiltersApplyAcrossPageBoundaries) {
+  ResetIter(/*page_size=*/2);
+  absl::flat_hash_map<int, std::unique_ptr<ColumnFilter>> filter_map;
+  filter_map.emplace(1, absl::make_unique<ColumnFilter>(
+                            std::vector<Value>{Int64(20), Int64(40)}));
+
+  EXPECT_THAT(
+      Read(std::move(filter_map)),
+      IsOkAndHolds(ElementsAre(ElementsAre(Int64(2), Int64(20), Int64(200)),
+                               ElementsAre(Int64(4), Int64(40), Int64(400)))));
+}
+
+TEST_F(PagedIteratorTest, EmptyTable) {
+  std::vector<const Column*> columns;
+  for (const std::unique_ptr<Column>& column : columns_) {
+    columns.push_back(column.get());
+  }
+  iter_ = absl::WrapUnique(new PagedEvaluatorTableIterator(
+      columns,
+      [](int64_t start_row_idx, PagedEvaluatorTableIterator::Page* page) {
+        return zetasql_base::OkStatus();
+      },
+      /*end_status=*/zetasql_base::OkStatus(), /*filter_column_idxs=*/{},
+      /*cancel_cb=*/[]() {}, /*set_deadline_cb=*/[](absl::Time) {},
+      zetasql_base::Clock::RealClock()));
+  EXPECT_THAT(Read(/*filter_map=*/{}), IsOkAndHolds(IsEmpty()));
+}
+
+TEST_F(PagedIteratorTest, PagerErrorIsReturnedThroughStatus) {
+  std::vector<const Column*> columns;
+  for (const std::unique_ptr<Column>& column : columns_) {
+    columns.push_back(column.get());
+  }
+  iter_ = absl::WrapUnique(new PagedEvaluatorTableIterator(
+      columns,
+      [](int64_t start_row_idx, PagedEvaluatorTableIterator::Page* page) {
+        return zetasql_base::Status(zetasql_base::StatusCode::kResourceExhausted,
+                            "pager failed");
+      },
+      /*end_status=*/zetasql_base::OkStatus(), /*filter_column_idxs=*/{},
+      /*cancel_cb=*/[]() {}, /*set_deadline_cb=*/[](absl::Time) {},
+      zetasql_base::Clock::RealClock()));
+
+  EXPECT_FALSE(iter_->NextRow());
+  EXPECT_THAT(iter_->Status(),
+              zetasql_base::testing::StatusIs(zetasql_base::RESOURCE_EXHAUSTED,
+                                        "pager failed"));
+  // The error is sticky.
+  EXPECT_FALSE(iter_->NextRow());
+}
+
+TEST_F(PagedIteratorTest, PagerIsCalledWithRunningStartRowIndex) {
+  std::vector<const Column*> columns = {columns_[0].get()};
+  std::vector<int64_t> start_row_idxs;
+  iter_ = absl::WrapUnique(new PagedEvaluatorTableIterator(
+      columns,
+      [&start_row_idxs](int64_t start_row_idx,
+                        PagedEvaluatorTableIterator::Page* page) {
+        start_row_idxs.push_back(start_row_idx);
+        if (start_row_idx < 4) {
+          page->column_major_values.push_back(
+              std::make_shared<const std::vector<Value>>(
+                  std::vector<Value>{Int64(start_row_idx),
+                                     Int64(start_row_idx + 1)}));
+        }
+        return zetasql_base::OkStatus();
+      },
+      /*end_status=*/zetasql_base::OkStatus(), /*filter_column_idxs=*/{},
+      /*cancel_cb=*/[]() {}, /*set_deadline_cb=*/[](absl::Time) {},
+      zetasql_base::Clock::RealClock()));
+
+  EXPECT_THAT(Read(/*filter_map=*/{}),
+              IsOkAndHolds(ElementsAre(
+                  ElementsAre(Int64(0)), ElementsAre(Int64(1)),
+                  ElementsAre(Int64(2)), ElementsAre(Int64(3)))));
+  EXPECT_THAT(start_row_idxs, ElementsAre(0, 2, 4));
+}
+
 }  // namespace
 }  // namespace zetasql
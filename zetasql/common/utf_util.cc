@@ -16,6 +16,9 @@
 
 #include "zetasql/common/utf_util.h"
 
+#include <cstdint>
+#include <cstring>
+
 #include "zetasql/base/logging.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -25,8 +28,30 @@ namespace zetasql {
 
 constexpr absl::string_view kReplacementCharacter = "\uFFFD";
 
+// Returns the number of leading ASCII bytes in ('s', 'length'). ASCII bytes
+// are trivially well-formed UTF8, so callers can skip over them without
+// decoding each code point. Examines the input a word at a time, which for
+// mostly-ASCII input does an eighth as many loads and branches as the
+// byte-at-a-time decoding loops below.
+static size_t SpanAscii(const char* s, size_t length) {
+  constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  size_t i = 0;
+  uint64_t word;
+  while (i + sizeof(word) <= length) {
+    std::memcpy(&word, s + i, sizeof(word));
+    if ((word & kHighBits) != 0) break;
+    i += sizeof(word);
+  }
+  while (i < length && (static_cast<unsigned char>(s[i]) & 0x80) == 0) {
+    ++i;
+  }
+  return i;
+}
+
 static int SpanWellFormedUTF8(const char* s, int length) {
   for (int i = 0; i < length;) {
+    i += static_cast<int>(SpanAscii(s + i, length - i));
+    if (i >= length) break;
     int start = i;
     UChar32 c;
     U8_NEXT(s, i, length, c);
@@ -48,6 +73,8 @@ std::string CoerceToWellFormedUTF8(absl::string_view input) {
   size_t prev = 0;
   std::string out;
   for (size_t i = 0; i < length;) {
+    i += SpanAscii(s + i, length - i);
+    if (i >= length) break;
     size_t start = i;
     UChar32 c;
     U8_NEXT(s, i, length, c);
@@ -17,6 +17,7 @@
 #include "zetasql/common/utf_util.h"
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
 namespace zetasql {
@@ -110,6 +111,26 @@ TEST(UtfUtilTest, CoerceToWellFormedUTF8) {
   TestCoerce("ABC\xf0\x90", "ABC\uFFFD");
 }
 
+TEST(UtfUtilTest, LongStrings) {
+  // Exercise the word-at-a-time ASCII fast path with strings longer than one
+  // word and with interesting bytes at every offset within a word.
+  const std::string ascii(100, 'x');
+  TestWellFormedString(ascii);
+  for (int i = 0; i <= 20; ++i) {
+    const std::string str(i, 'a');
+
+    // ASCII followed by a multi-byte character, and vice versa.
+    TestWellFormedString(absl::StrCat(str, "\xc2\xbf"));
+    TestWellFormedString(absl::StrCat("\xe8\xb0\xb7", str));
+
+    // An ill-formed byte after 'i' ASCII bytes.
+    TestIllFormedString(absl::StrCat(str, "\xc1"), i);
+    TestIllFormedString(absl::StrCat(str, "\xc1", ascii), i);
+    TestCoerce(absl::StrCat(str, "\xc1", str),
+               absl::StrCat(str, "\uFFFD", str));
+  }
+}
+
 TEST(UtfUtilTest, PrettyTruncateUTF8) {
   // 10 ascii characters
   std::string str1 = "1234567890";
@@ -16,8 +16,16 @@
 
 #include "zetasql/local_service/local_service.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +39,7 @@
 #include "zetasql/proto/simple_catalog.pb.h"
 #include "zetasql/public/builtin_function.h"
 #include "zetasql/public/evaluator.h"
+#include "zetasql/public/evaluator_table_iterator.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/id_string.h"
 #include "zetasql/public/language_options.h"
@@ -42,9 +51,14 @@
 #include "zetasql/public/value.h"
 #include "zetasql/public/value.pb.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_visitor.h"
 #include "zetasql/resolved_ast/sql_builder.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
 #include "absl/synchronization/mutex.h"
+#include "zetasql/base/arena.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
@@ -81,38 +95,123 @@ zetasql_base::Status RepeatedParametersToMap(
 }
 
 // Populate the existing pools into the map with existing indices, to make sure
-// the serialized type will use the same indices.
+// the serialized type will use the same indices. A pool's shared underlay (if
+// any) is registered under the same index: descriptors resolved through an
+// overlay pool belong to the underlay pool object, and must serialize with the
+// index the client used for that descriptor set.
 void PopulateExistingPoolsToFileDescriptorSetMap(
     const std::vector<const google::protobuf::DescriptorPool*>& pools,
+    const std::vector<std::shared_ptr<const google::protobuf::DescriptorPool>>&
+        underlays,
     FileDescriptorSetMap* file_descriptor_set_map) {
   file_descriptor_set_map->clear();
 
+  CHECK_EQ(pools.size(), underlays.size());
   for (int i = 0; i < pools.size(); ++i) {
     std::unique_ptr<Type::FileDescriptorEntry>& entry =
         (*file_descriptor_set_map)[pools[i]];
     CHECK_EQ(entry.get(), nullptr);
     entry = absl::make_unique<Type::FileDescriptorEntry>();
     entry->descriptor_set_index = i;
+
+    if (underlays[i] != nullptr && underlays[i].get() != pools[i]) {
+      std::unique_ptr<Type::FileDescriptorEntry>& underlay_entry =
+          (*file_descriptor_set_map)[underlays[i].get()];
+      CHECK_EQ(underlay_entry.get(), nullptr);
+      underlay_entry = absl::make_unique<Type::FileDescriptorEntry>();
+      underlay_entry->descriptor_set_index = i;
+    }
   }
 
-  CHECK_EQ(pools.size(), file_descriptor_set_map->size());
+  CHECK_LE(pools.size(), file_descriptor_set_map->size());
 }
 
 zetasql_base::Status SerializeTypeUsingExistingPools(
     const Type* type, const std::vector<const google::protobuf::DescriptorPool*>& pools,
+    const std::vector<std::shared_ptr<const google::protobuf::DescriptorPool>>&
+        underlays,
     TypeProto* type_proto) {
   FileDescriptorSetMap file_descriptor_set_map;
-  PopulateExistingPoolsToFileDescriptorSetMap(pools, &file_descriptor_set_map);
+  PopulateExistingPoolsToFileDescriptorSetMap(pools, underlays,
+                                              &file_descriptor_set_map);
+  const size_t num_known_pools = file_descriptor_set_map.size();
 
   ZETASQL_RETURN_IF_ERROR(type->SerializeToProtoAndDistinctFileDescriptors(
       type_proto, &file_descriptor_set_map));
 
-  ZETASQL_RET_CHECK_EQ(pools.size(), file_descriptor_set_map.size())
+  ZETASQL_RET_CHECK_EQ(num_known_pools, file_descriptor_set_map.size())
       << type->DebugString(true)
       << " uses unknown DescriptorPool, this shouldn't happen.";
   return ::zetasql_base::OkStatus();
 }
 
+// Process-wide cache of immutable DescriptorPools, keyed by the serialized
+// bytes of the FileDescriptorSet each was built from. Clients that register
+// many catalogs tend to send byte-identical descriptor sets for most of them;
+// sharing one pool per distinct set makes registration time and memory
+// proportional to the number of distinct schemas instead of the number of
+// catalogs times the schema size. Entries are held weakly, so a pool is freed
+// when the last state using it is deleted.
+class DescriptorPoolCache {
+ public:
+  static DescriptorPoolCache& Get() {
+    static DescriptorPoolCache* cache = new DescriptorPoolCache();
+    return *cache;
+  }
+
+  DescriptorPoolCache(const DescriptorPoolCache&) = delete;
+  DescriptorPoolCache& operator=(const DescriptorPoolCache&) = delete;
+
+  // Returns the shared pool for 'fdset', building it on first use.
+  zetasql_base::StatusOr<std::shared_ptr<const google::protobuf::DescriptorPool>>
+  GetOrCreatePool(const google::protobuf::FileDescriptorSet& fdset) {
+    const std::string key = fdset.SerializeAsString();
+    {
+      absl::MutexLock lock(&mutex_);
+      const auto it = pools_.find(key);
+      if (it != pools_.end()) {
+        std::shared_ptr<const google::protobuf::DescriptorPool> pool =
+            it->second.lock();
+        if (pool != nullptr) {
+          return pool;
+        }
+      }
+    }
+
+    // Built without holding the mutex; building can be expensive.
+    auto new_pool = std::make_shared<google::protobuf::DescriptorPool>();
+    ZETASQL_RETURN_IF_ERROR(AddFileDescriptorSetToPool(&fdset, new_pool.get()));
+
+    absl::MutexLock lock(&mutex_);
+    std::shared_ptr<const google::protobuf::DescriptorPool> existing =
+        pools_[key].lock();
+    if (existing != nullptr) {
+      // Another thread built a pool for the same set concurrently.
+      return existing;
+    }
+    // Opportunistically drop entries whose pools have all been deleted.
+    for (auto it = pools_.begin(); it != pools_.end();) {
+      if (it->second.expired() && it->first != key) {
+        pools_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    std::shared_ptr<const google::protobuf::DescriptorPool> pool =
+        std::move(new_pool);
+    pools_[key] = pool;
+    return pool;
+  }
+
+ private:
+  DescriptorPoolCache() {}
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string,
+                      std::weak_ptr<const google::protobuf::DescriptorPool>>
+      pools_ GUARDED_BY(mutex_);
+};
+
 }  // namespace
 
 // This class is thread-safe.
@@ -127,18 +226,27 @@ class BaseSavedState : public GenericState {
     // In case Init() failed half way and called again.
     pools_.clear();
     const_pools_.clear();
+    underlays_.clear();
 
     const int num_pools = fdsets.size();
     pools_.reserve(num_pools);
     const_pools_.reserve(num_pools);
+    underlays_.reserve(num_pools);
 
     for (const auto& file_descirptor_set : fdsets) {
+      auto shared_pool_or =
+          DescriptorPoolCache::Get().GetOrCreatePool(file_descirptor_set);
+      ZETASQL_RETURN_IF_ERROR(shared_pool_or.status());
+      std::shared_ptr<const google::protobuf::DescriptorPool> shared_pool =
+          std::move(shared_pool_or.ValueOrDie());
+      // Each state gets its own overlay pool, so files added later (e.g. by
+      // AddSimpleTable()) stay private to this state. All lookups for the
+      // registered files fall through to the shared pool.
       std::unique_ptr<google::protobuf::DescriptorPool> pool(
-          new google::protobuf::DescriptorPool());
-      ZETASQL_RETURN_IF_ERROR(
-          AddFileDescriptorSetToPool(&file_descirptor_set, pool.get()));
+          new google::protobuf::DescriptorPool(shared_pool.get()));
       const_pools_.emplace_back(pool.get());
       pools_.emplace_back(pool.release());
+      underlays_.emplace_back(std::move(shared_pool));
     }
 
     return ::zetasql_base::OkStatus();
@@ -147,25 +255,34 @@ class BaseSavedState : public GenericState {
   zetasql_base::Status static MergeFileDescriptorSetsToPools(
       const RepeatedPtrField<google::protobuf::FileDescriptorSet>& fdsets,
       std::vector<std::unique_ptr<google::protobuf::DescriptorPool>>* pools,
-      std::vector<const google::protobuf::DescriptorPool*>* const_pools) {
+      std::vector<const google::protobuf::DescriptorPool*>* const_pools,
+      std::vector<std::shared_ptr<const google::protobuf::DescriptorPool>>*
+          underlays) {
     const int original_num_pools = pools->size();
     const int num_pools = std::max(fdsets.size(), original_num_pools);
     pools->reserve(num_pools);
     const_pools->reserve(num_pools);
+    underlays->reserve(num_pools);
 
     int i = 0;
     for (const auto& file_descirptor_set : fdsets) {
       if (i < original_num_pools) {
+        // Merged files go into this state's private overlay pool; the shared
+        // underlay pool stays untouched.
         ZETASQL_RETURN_IF_ERROR(
             AddFileDescriptorSetToPool(
                 &file_descirptor_set, (*pools)[i].get()));
       } else {
+        auto shared_pool_or =
+            DescriptorPoolCache::Get().GetOrCreatePool(file_descirptor_set);
+        ZETASQL_RETURN_IF_ERROR(shared_pool_or.status());
+        std::shared_ptr<const google::protobuf::DescriptorPool> shared_pool =
+            std::move(shared_pool_or.ValueOrDie());
         std::unique_ptr<google::protobuf::DescriptorPool> pool(
-                    new google::protobuf::DescriptorPool());
-        ZETASQL_RETURN_IF_ERROR(
-            AddFileDescriptorSetToPool(&file_descirptor_set, pool.get()));
+            new google::protobuf::DescriptorPool(shared_pool.get()));
         const_pools->emplace_back(pool.get());
         pools->emplace_back(pool.release());
+        underlays->emplace_back(std::move(shared_pool));
       }
       i++;
     }
@@ -188,6 +305,18 @@ class BaseSavedState : public GenericState {
     return const_pools_;
   }
 
+  // Returns the shared pools backing GetDescriptorPools(), 1-1 by index
+  // (nullptr where a pool has no shared underlay). Descriptors resolved
+  // through an overlay pool belong to the underlay pool object, so
+  // serialization must map both objects to the same descriptor set index.
+  const std::vector<std::shared_ptr<const google::protobuf::DescriptorPool>>&
+  GetDescriptorPoolUnderlays() {
+    absl::MutexLock lock(&mutex_);
+    CHECK(initialized_);
+
+    return underlays_;
+  }
+
  protected:
   absl::Mutex mutex_;
 
@@ -198,6 +327,10 @@ class BaseSavedState : public GenericState {
   std::vector<std::unique_ptr<google::protobuf::DescriptorPool>> pools_
       GUARDED_BY(mutex_);
   std::vector<const google::protobuf::DescriptorPool*> const_pools_ GUARDED_BY(mutex_);
+  // Shared underlays of the pools in <pools_>, 1-1 by index, to keep them
+  // alive for as long as this state references their descriptors.
+  std::vector<std::shared_ptr<const google::protobuf::DescriptorPool>>
+      underlays_ GUARDED_BY(mutex_);
 };
 
 class PreparedExpressionState : public BaseSavedState {
@@ -246,6 +379,94 @@ class RegisteredCatalogState : public BaseSavedState {
     return ::zetasql_base::OkStatus();
   }
 
+  // Initializes this state as an overlay over 'base': every unchanged
+  // catalog object is shared by pointer with the base catalog, and only the
+  // upserted tables are deserialized, so the cost is proportional to the
+  // diff rather than the catalog size. 'base' is retained so the shared
+  // objects (and the type factory owning their types) outlive this state.
+  zetasql_base::Status InitAsDiff(const RegisterCatalogDiffRequest& request,
+                          std::shared_ptr<RegisteredCatalogState> base) {
+    ZETASQL_RETURN_IF_ERROR(BaseSavedState::Init(request.file_descriptor_set()));
+
+    SimpleCatalog* base_catalog = base->GetCatalog();
+
+    absl::MutexLock lock(&mutex_);
+
+    // Lower-case names of base tables that must not be shared.
+    absl::flat_hash_set<std::string> replaced_tables;
+    for (const std::string& name : request.removed_table_name()) {
+      replaced_tables.insert(absl::AsciiStrToLower(name));
+    }
+    for (const SimpleTableProto& table_proto : request.upserted_table()) {
+      const std::string& name = table_proto.has_name_in_catalog()
+                                    ? table_proto.name_in_catalog()
+                                    : table_proto.name();
+      replaced_tables.insert(absl::AsciiStrToLower(name));
+    }
+
+    catalog_ = absl::make_unique<SimpleCatalog>(base_catalog->FullName());
+    for (const auto& entry : base_catalog->tables_by_name()) {
+      if (!replaced_tables.contains(entry.first)) {
+        catalog_->AddTable(entry.first, entry.second);
+      }
+    }
+    for (const auto& entry : base_catalog->types_by_name()) {
+      catalog_->AddType(entry.first, entry.second);
+    }
+    for (const auto& entry : base_catalog->catalogs_by_name()) {
+      catalog_->AddCatalog(entry.first, entry.second);
+    }
+    // A function with an alias appears in the map under both names, and
+    // AddFunction registers the alias along with the primary name, so alias
+    // entries that have a sibling primary entry must be skipped.
+    const absl::flat_hash_map<std::string, const Function*> base_functions =
+        base_catalog->functions_by_name();
+    absl::flat_hash_map<const Function*, int> function_entry_counts;
+    for (const auto& entry : base_functions) {
+      ++function_entry_counts[entry.second];
+    }
+    for (const auto& entry : base_functions) {
+      const Function* function = entry.second;
+      if (function_entry_counts[function] > 1 &&
+          entry.first == absl::AsciiStrToLower(function->alias_name())) {
+        continue;
+      }
+      catalog_->AddFunction(entry.first, function);
+    }
+    for (const auto& entry : base_catalog->table_valued_functions_by_name()) {
+      catalog_->AddTableValuedFunction(entry.first, entry.second);
+    }
+    for (const auto& entry : base_catalog->procedures_by_name()) {
+      catalog_->AddProcedure(entry.first, entry.second);
+    }
+    for (const auto& entry : base_catalog->constants_by_name()) {
+      catalog_->AddConstant(entry.first, entry.second);
+    }
+
+    for (const SimpleTableProto& table_proto : request.upserted_table()) {
+      std::unique_ptr<SimpleTable> table;
+      ZETASQL_RETURN_IF_ERROR(SimpleTable::Deserialize(
+          table_proto, const_pools_, catalog_->type_factory(), &table));
+      const std::string& name = table_proto.has_name_in_catalog()
+                                    ? table_proto.name_in_catalog()
+                                    : table_proto.name();
+      catalog_->AddOwnedTable(name, table.release());
+    }
+
+    if (request.has_file_descriptor_set_index()) {
+      const int index = request.file_descriptor_set_index();
+      if (index < 0 || index >= static_cast<int>(const_pools_.size())) {
+        return MakeSqlError()
+               << "Invalid file_descriptor_set_index " << index;
+      }
+      catalog_->SetDescriptorPool(const_pools_[index]);
+    }
+
+    base_state_ = std::move(base);
+    initialized_ = true;
+    return ::zetasql_base::OkStatus();
+  }
+
   SimpleCatalog* GetCatalog() {
     absl::MutexLock lock(&mutex_);
     CHECK(initialized_);
@@ -257,7 +478,7 @@ class RegisteredCatalogState : public BaseSavedState {
     std::unique_ptr<SimpleTable> table;
     ZETASQL_RETURN_IF_ERROR(
         MergeFileDescriptorSetsToPools(request.file_descriptor_set(),
-                                       &pools_, &const_pools_));
+                                       &pools_, &const_pools_, &underlays_));
     ZETASQL_RETURN_IF_ERROR(SimpleTable::Deserialize(request.table(),
                                              const_pools_,
                                              &factory_, &table));
@@ -267,6 +488,9 @@ class RegisteredCatalogState : public BaseSavedState {
 
  private:
   std::unique_ptr<SimpleCatalog> catalog_ GUARDED_BY(mutex_);
+  // Set by InitAsDiff. Keeps the base catalog (and the type factory owning
+  // the types of shared objects) alive while this overlay references them.
+  std::shared_ptr<RegisteredCatalogState> base_state_ GUARDED_BY(mutex_);
 };
 
 class RegisteredCatalogPool : public SharedStatePool<RegisteredCatalogState> {};
@@ -301,11 +525,89 @@ class RegisteredParseResumeLocationState : public GenericState {
 class RegisteredParseResumeLocationPool
     : public SharedStatePool<RegisteredParseResumeLocationState> {};
 
+// A client-created file mapped into the service, used to hand large
+// response payloads to a same-host client as offsets instead of inline
+// response bytes.
+class SharedMemoryArenaState : public GenericState {
+ public:
+  // Maps the first 'size' bytes of the file at 'path', which the client
+  // must already have created, sized and mapped on its side.
+  static zetasql_base::StatusOr<std::unique_ptr<SharedMemoryArenaState>> Create(
+      const std::string& path, int64_t size) {
+    if (size <= 0) {
+      return MakeSqlError()
+             << "Shared memory arena size must be positive, got " << size;
+    }
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+      return MakeSqlError() << "Cannot open shared memory arena file " << path
+                            << ": " << strerror(errno);
+    }
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) < 0) {
+      const int fstat_errno = errno;
+      close(fd);
+      return MakeSqlError() << "Cannot stat shared memory arena file " << path
+                            << ": " << strerror(fstat_errno);
+    }
+    if (statbuf.st_size < size) {
+      close(fd);
+      return MakeSqlError() << "Shared memory arena file " << path
+                            << " is smaller than the requested " << size
+                            << " bytes";
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                      /*offset=*/0);
+    const int mmap_errno = errno;
+    // The mapping keeps the file alive; the descriptor is no longer needed.
+    close(fd);
+    if (base == MAP_FAILED) {
+      return MakeSqlError() << "Cannot map shared memory arena file " << path
+                            << ": " << strerror(mmap_errno);
+    }
+    return std::unique_ptr<SharedMemoryArenaState>(
+        new SharedMemoryArenaState(base, size));
+  }
+
+  ~SharedMemoryArenaState() override { munmap(base_, size_); }
+
+  // Serializes 'message' into the arena and fills '*block' if it fits.
+  // Returns false without touching the arena if it does not; the caller
+  // should fall back to inline serialization. Each write starts at offset
+  // zero and overwrites the previous handoff, so an arena holds one
+  // response at a time.
+  bool TryWrite(const google::protobuf::Message& message,
+                SharedMemoryBlockProto* block) {
+    const size_t size = message.ByteSizeLong();
+    if (size > static_cast<size_t>(size_)) {
+      return false;
+    }
+    absl::MutexLock lock(&mutex_);
+    message.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(base_));
+    block->set_offset(0);
+    block->set_size(size);
+    return true;
+  }
+
+ private:
+  SharedMemoryArenaState(void* base, int64_t size)
+      : GenericState(), base_(base), size_(size) {}
+
+  // Serializes writers into the mapped region; the pointer itself is
+  // immutable.
+  absl::Mutex mutex_;
+  void* const base_;
+  const int64_t size_;
+};
+
+class SharedMemoryArenaPool : public SharedStatePool<SharedMemoryArenaState> {};
+
 ZetaSqlLocalServiceImpl::ZetaSqlLocalServiceImpl()
     : registered_catalogs_(new RegisteredCatalogPool()),
       prepared_expressions_(new PreparedExpressionPool()),
       registered_parse_resume_locations_(
-          new RegisteredParseResumeLocationPool()) {}
+          new RegisteredParseResumeLocationPool()),
+      shared_memory_arenas_(new SharedMemoryArenaPool()) {}
 
 ZetaSqlLocalServiceImpl::~ZetaSqlLocalServiceImpl() {}
 
@@ -325,7 +627,7 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::Prepare(const PrepareRequest& requ
 
   ZETASQL_RETURN_IF_ERROR(SerializeTypeUsingExistingPools(
       exp->output_type(), state->GetDescriptorPools(),
-      response->mutable_output_type()));
+      state->GetDescriptorPoolUnderlays(), response->mutable_output_type()));
 
   int64_t id = prepared_expressions_->Register(state.release());
   ZETASQL_RET_CHECK_NE(-1, id)
@@ -395,12 +697,148 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::EvaluateImpl(
 
   const Value& value = result.ValueOrDie();
   ZETASQL_RETURN_IF_ERROR(value.Serialize(response->mutable_value()));
-  ZETASQL_RETURN_IF_ERROR(SerializeTypeUsingExistingPools(value.type(), const_pools,
-                                                  response->mutable_type()));
+  ZETASQL_RETURN_IF_ERROR(SerializeTypeUsingExistingPools(
+      value.type(), const_pools, state->GetDescriptorPoolUnderlays(),
+      response->mutable_type()));
 
   return ::zetasql_base::OkStatus();
 }
 
+zetasql_base::Status ZetaSqlLocalServiceImpl::EvaluateBatch(
+    const EvaluateBatchRequest& request,
+    const std::function<zetasql_base::Status(const EvaluateBatchResponse&)>&
+        write_response) {
+  if (!request.has_prepared_expression_id()) {
+    return MakeSqlError() << "EvaluateBatch requires a prepared expression; "
+                             "call Prepare and set prepared_expression_id.";
+  }
+  int64_t id = request.prepared_expression_id();
+  std::shared_ptr<PreparedExpressionState> shared_state =
+      prepared_expressions_->Get(id);
+  PreparedExpressionState* state = shared_state.get();
+  if (state == nullptr) {
+    return MakeSqlError() << "Prepared expression " << id << " unknown.";
+  }
+
+  const auto& const_pools = state->GetDescriptorPools();
+  TypeFactory* factory = state->GetTypeFactory();
+  PreparedExpression* exp = state->GetPreparedExpression();
+
+  bool first = true;
+  for (const EvaluateBatchRequest::ParameterSet& parameter_set :
+       request.parameter_set()) {
+    ParameterValueMap columns, params;
+    ZETASQL_RETURN_IF_ERROR(RepeatedParametersToMap(parameter_set.columns(),
+                                            const_pools, factory, &columns));
+    ZETASQL_RETURN_IF_ERROR(RepeatedParametersToMap(parameter_set.params(),
+                                            const_pools, factory, &params));
+
+    auto result = exp->Execute(columns, params);
+    ZETASQL_RETURN_IF_ERROR(result.status());
+
+    EvaluateBatchResponse response;
+    ZETASQL_RETURN_IF_ERROR(result.ValueOrDie().Serialize(response.mutable_value()));
+    if (first) {
+      // The output type is fixed at Prepare time; serialize it only once.
+      ZETASQL_RETURN_IF_ERROR(SerializeTypeUsingExistingPools(
+          result.ValueOrDie().type(), const_pools,
+          state->GetDescriptorPoolUnderlays(), response.mutable_type()));
+      first = false;
+    }
+    ZETASQL_RETURN_IF_ERROR(write_response(response));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+// Number of rows per EvaluateQueryBatchResponse when the request does not
+// specify a batch size.
+static const int kDefaultEvaluateQueryBatchSize = 1024;
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::EvaluateQueryStream(
+    const EvaluateQueryRequest& request,
+    const std::function<zetasql_base::Status(const EvaluateQueryBatchResponse&)>&
+        write_batch) {
+  RegisteredCatalogState* catalog_state;
+  // Needed to hold the new state because shared_ptr doesn't support release().
+  std::unique_ptr<RegisteredCatalogState> new_catalog_state;
+
+  if (request.has_registered_catalog_id()) {
+    int64_t id = request.registered_catalog_id();
+    std::shared_ptr<RegisteredCatalogState> shared_state =
+        registered_catalogs_->Get(id);
+    catalog_state = shared_state.get();
+    if (catalog_state == nullptr) {
+      return MakeSqlError() << "Registered catalog " << id << " unknown.";
+    }
+  } else {
+    new_catalog_state = absl::make_unique<RegisteredCatalogState>();
+    catalog_state = new_catalog_state.get();
+    ZETASQL_RETURN_IF_ERROR(catalog_state->Init(request.simple_catalog(),
+                                        request.file_descriptor_set()));
+  }
+
+  return EvaluateQueryStreamImpl(request, catalog_state, write_batch);
+}
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::EvaluateQueryStreamImpl(
+    const EvaluateQueryRequest& request, RegisteredCatalogState* catalog_state,
+    const std::function<zetasql_base::Status(const EvaluateQueryBatchResponse&)>&
+        write_batch) {
+  const auto& const_pools = catalog_state->GetDescriptorPools();
+  TypeFactory* factory = catalog_state->GetTypeFactory();
+
+  AnalyzerOptions options;
+  ZETASQL_RETURN_IF_ERROR(AnalyzerOptions::Deserialize(request.options(), const_pools,
+                                               factory, &options));
+
+  ParameterValueMap params;
+  ZETASQL_RETURN_IF_ERROR(
+      RepeatedParametersToMap(request.params(), const_pools, factory, &params));
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.type_factory = factory;
+  PreparedQuery query(request.sql(), evaluator_options);
+  ZETASQL_RETURN_IF_ERROR(query.Prepare(options, catalog_state->GetCatalog()));
+
+  auto result = query.Execute(params);
+  ZETASQL_RETURN_IF_ERROR(result.status());
+  std::unique_ptr<EvaluatorTableIterator> iter =
+      std::move(result.ValueOrDie());
+
+  const int batch_size = request.batch_size() > 0
+                             ? request.batch_size()
+                             : kDefaultEvaluateQueryBatchSize;
+
+  // The first batch carries the column schema, even if the result is empty.
+  EvaluateQueryBatchResponse batch;
+  for (int i = 0; i < iter->NumColumns(); ++i) {
+    EvaluateQueryBatchResponse::Column* column = batch.add_columns();
+    column->set_name(iter->GetColumnName(i));
+    ZETASQL_RETURN_IF_ERROR(SerializeTypeUsingExistingPools(
+        iter->GetColumnType(i), const_pools,
+        catalog_state->GetDescriptorPoolUnderlays(), column->mutable_type()));
+  }
+
+  bool wrote_batch = false;
+  while (iter->NextRow()) {
+    EvaluateQueryBatchResponse::Row* row = batch.add_rows();
+    for (int i = 0; i < iter->NumColumns(); ++i) {
+      ZETASQL_RETURN_IF_ERROR(iter->GetValue(i).Serialize(row->add_cell()));
+    }
+    if (batch.rows_size() >= batch_size) {
+      ZETASQL_RETURN_IF_ERROR(write_batch(batch));
+      wrote_batch = true;
+      batch.Clear();
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(iter->Status());
+
+  if (batch.rows_size() > 0 || !wrote_batch) {
+    ZETASQL_RETURN_IF_ERROR(write_batch(batch));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ZetaSqlLocalServiceImpl::GetTableFromProto(
     const TableFromProtoRequest& request, SimpleTableProto* response) {
   TypeFactory factory;
@@ -455,6 +893,15 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::Analyze(const AnalyzeRequest& requ
                                         request.file_descriptor_set()));
   }
 
+  std::shared_ptr<SharedMemoryArenaState> arena;
+  if (request.has_shared_memory_arena_id()) {
+    int64_t id = request.shared_memory_arena_id();
+    arena = shared_memory_arenas_->Get(id);
+    if (arena == nullptr) {
+      return MakeSqlError() << "Shared memory arena " << id << " unknown.";
+    }
+  }
+
   RegisteredParseResumeLocationState* parse_resume_location_state;
   std::unique_ptr<RegisteredParseResumeLocationState>
       owned_parse_resume_location_state;
@@ -471,8 +918,13 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::Analyze(const AnalyzeRequest& requ
                             << " unknown.";
     }
     location = parse_resume_location_state->GetParseResumeLocation(&lock);
-    location->set_byte_position(
-        request.registered_parse_resume_location().byte_position());
+    // An explicit byte position overrides the one held by the server; if
+    // unset, analysis resumes where the previous call on this handle
+    // stopped, so the client only needs to send the handle.
+    if (request.registered_parse_resume_location().has_byte_position()) {
+      location->set_byte_position(
+          request.registered_parse_resume_location().byte_position());
+    }
   } else if (request.has_parse_resume_location()) {
     owned_parse_resume_location_state =
         absl::make_unique<RegisteredParseResumeLocationState>(
@@ -483,10 +935,29 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::Analyze(const AnalyzeRequest& requ
   }
 
   if (request.has_sql_expression()) {
-    return AnalyzeExpressionImpl(request, catalog_state, response);
+    ZETASQL_RETURN_IF_ERROR(AnalyzeExpressionImpl(request, catalog_state, response));
   } else {
-    return AnalyzeImpl(request, catalog_state, location, response);
+    ZETASQL_RETURN_IF_ERROR(AnalyzeImpl(request, catalog_state, location, response));
   }
+  if (arena != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(MaybeOffloadToSharedMemory(arena.get(), response));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::MaybeOffloadToSharedMemory(
+    SharedMemoryArenaState* arena, AnalyzeResponse* response) {
+  SharedMemoryBlockProto block;
+  if (response->has_resolved_statement()) {
+    if (arena->TryWrite(response->resolved_statement(), &block)) {
+      *response->mutable_resolved_statement_block() = block;
+    }
+  } else if (response->has_resolved_expression()) {
+    if (arena->TryWrite(response->resolved_expression(), &block)) {
+      *response->mutable_resolved_expression_block() = block;
+    }
+  }
+  return ::zetasql_base::OkStatus();
 }
 
 zetasql_base::Status ZetaSqlLocalServiceImpl::AnalyzeImpl(
@@ -511,16 +982,19 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::AnalyzeImpl(
     ZETASQL_RETURN_IF_ERROR(zetasql::AnalyzeStatement(
         sql, options, catalog_state->GetCatalog(), &factory, &output));
 
-    ZETASQL_RETURN_IF_ERROR(
-        SerializeResolvedOutput(output.get(), sql, response, catalog_state));
+    ZETASQL_RETURN_IF_ERROR(SerializeResolvedOutput(output.get(),
+                                            request.serialization_options(),
+                                            sql, response, catalog_state));
   } else if (location != nullptr) {
     bool at_end_of_input;
     ZETASQL_RETURN_IF_ERROR(zetasql::AnalyzeNextStatement(
         location, options, catalog_state->GetCatalog(), &factory, &output,
         &at_end_of_input));
 
-    ZETASQL_RETURN_IF_ERROR(SerializeResolvedOutput(output.get(), location->input(),
-                                            response, catalog_state));
+    ZETASQL_RETURN_IF_ERROR(SerializeResolvedOutput(output.get(),
+                                            request.serialization_options(),
+                                            location->input(), response,
+                                            catalog_state));
     response->set_resume_byte_position(location->byte_position());
   }
   return ::zetasql_base::OkStatus();
@@ -543,8 +1017,62 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::AnalyzeExpressionImpl(
     ZETASQL_RETURN_IF_ERROR(zetasql::AnalyzeExpression(
         sql, options, catalog_state->GetCatalog(), &factory, &output));
 
-    ZETASQL_RETURN_IF_ERROR(
-        SerializeResolvedOutput(output.get(), sql, response, catalog_state));
+    ZETASQL_RETURN_IF_ERROR(SerializeResolvedOutput(output.get(),
+                                            request.serialization_options(),
+                                            sql, response, catalog_state));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::AnalyzeBatch(
+    const AnalyzeBatchRequest& request,
+    const std::function<zetasql_base::Status(const AnalyzeResponse&)>&
+        write_response) {
+  RegisteredCatalogState* catalog_state;
+  // Needed to hold the new state because shared_ptr doesn't support release().
+  std::unique_ptr<RegisteredCatalogState> new_catalog_state;
+
+  if (request.has_registered_catalog_id()) {
+    int64_t id = request.registered_catalog_id();
+    std::shared_ptr<RegisteredCatalogState> shared_state =
+        registered_catalogs_->Get(id);
+    catalog_state = shared_state.get();
+    if (catalog_state == nullptr) {
+      return MakeSqlError() << "Registered catalog " << id << " unknown.";
+    }
+  } else {
+    new_catalog_state = absl::make_unique<RegisteredCatalogState>();
+    catalog_state = new_catalog_state.get();
+    ZETASQL_RETURN_IF_ERROR(catalog_state->Init(request.simple_catalog(),
+                                        request.file_descriptor_set()));
+  }
+
+  return AnalyzeBatchImpl(request, catalog_state, write_response);
+}
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::AnalyzeBatchImpl(
+    const AnalyzeBatchRequest& request, RegisteredCatalogState* catalog_state,
+    const std::function<zetasql_base::Status(const AnalyzeResponse&)>&
+        write_response) {
+  // Deserialized once and shared by every statement in the batch.
+  AnalyzerOptions options;
+  ZETASQL_RETURN_IF_ERROR(AnalyzerOptions::Deserialize(
+      request.options(), catalog_state->GetDescriptorPools(),
+      catalog_state->GetTypeFactory(), &options));
+
+  // One factory serves the whole batch; the types it allocates only need to
+  // live until the statement's response has been serialized.
+  TypeFactory factory;
+  for (const std::string& sql : request.sql_statement()) {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_RETURN_IF_ERROR(zetasql::AnalyzeStatement(
+        sql, options, catalog_state->GetCatalog(), &factory, &output));
+
+    AnalyzeResponse response;
+    ZETASQL_RETURN_IF_ERROR(SerializeResolvedOutput(output.get(),
+                                            request.serialization_options(),
+                                            sql, &response, catalog_state));
+    ZETASQL_RETURN_IF_ERROR(write_response(response));
   }
   return ::zetasql_base::OkStatus();
 }
@@ -570,26 +1098,34 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::BuildSql(const BuildSqlRequest& re
                                         request.file_descriptor_set()));
   }
   IdStringPool string_pool;
+  RestoredTypeCache type_cache;
   ResolvedNode::RestoreParams restore_params(
       catalog_state->GetDescriptorPools(), catalog_state->GetCatalog(),
       catalog_state->GetTypeFactory(), &string_pool);
+  restore_params.type_cache = &type_cache;
 
+  // Nodes restored below are carved out of the arena and their memory is
+  // released with it, after the nodes themselves are deleted.
+  zetasql_base::UnsafeArena arena(/*block_size=*/4096);
   std::unique_ptr<ResolvedNode> ast;
-  if (request.has_resolved_statement()) {
-    ast = std::move(ResolvedStatement::RestoreFrom(request.resolved_statement(),
-                                                   restore_params)
-                        .ValueOrDie());
-  } else if (request.has_resolved_expression()) {
-    ast = std::move(
-        ResolvedExpr::RestoreFrom(request.resolved_expression(), restore_params)
-            .ValueOrDie());
-  } else {
-    return ::zetasql_base::OkStatus();
+  {
+    ResolvedNodeArenaScope arena_scope(&arena);
+    if (request.has_resolved_statement()) {
+      ast = std::move(ResolvedStatement::RestoreFrom(
+                          request.resolved_statement(), restore_params)
+                          .ValueOrDie());
+    } else if (request.has_resolved_expression()) {
+      ast = std::move(ResolvedExpr::RestoreFrom(request.resolved_expression(),
+                                                restore_params)
+                          .ValueOrDie());
+    } else {
+      return ::zetasql_base::OkStatus();
+    }
   }
 
   zetasql::SQLBuilder sql_builder;
   ZETASQL_CHECK_OK(ast->Accept(&sql_builder));
-  response->set_sql(sql_builder.sql());
+  response->set_sql(sql_builder.release_sql());
   return ::zetasql_base::OkStatus();
 }
 
@@ -612,12 +1148,32 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::ExtractTableNamesFromStatement(
 zetasql_base::Status ZetaSqlLocalServiceImpl::ExtractTableNamesFromNextStatement(
     const ExtractTableNamesFromNextStatementRequest& request,
     ExtractTableNamesFromNextStatementResponse* response) {
-  auto parse_resume_location_state =
-    absl::make_unique<RegisteredParseResumeLocationState>(
-    request.parse_resume_location());
+  std::shared_ptr<RegisteredParseResumeLocationState> shared_state;
+  std::unique_ptr<RegisteredParseResumeLocationState>
+      owned_parse_resume_location_state;
+  RegisteredParseResumeLocationState* parse_resume_location_state;
+  if (request.has_registered_parse_resume_location()) {
+    int64_t id = request.registered_parse_resume_location().registered_id();
+    shared_state = registered_parse_resume_locations_->Get(id);
+    parse_resume_location_state = shared_state.get();
+    if (parse_resume_location_state == nullptr) {
+      return MakeSqlError() << "Registered parse resume location " << id
+                            << " unknown.";
+    }
+  } else {
+    owned_parse_resume_location_state =
+        absl::make_unique<RegisteredParseResumeLocationState>(
+            request.parse_resume_location());
+    parse_resume_location_state = owned_parse_resume_location_state.get();
+  }
   std::unique_ptr<absl::MutexLock> lock;
   ParseResumeLocation* location =
       parse_resume_location_state->GetParseResumeLocation(&lock);
+  if (request.has_registered_parse_resume_location() &&
+      request.registered_parse_resume_location().has_byte_position()) {
+    location->set_byte_position(
+        request.registered_parse_resume_location().byte_position());
+  }
 
   LanguageOptions language_options = request.has_options() ?
       LanguageOptions(request.options()) :
@@ -645,13 +1201,58 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::ExtractTableNamesFromNextStatement
   return ::zetasql_base::OkStatus();
 }
 
+namespace {
+
+// Strips recorded parse location ranges from a resolved AST before it is
+// serialized, for clients that record locations during analysis (e.g. to
+// improve error messages) but do not want them in the response.
+class ParseLocationStripper : public ResolvedASTVisitor {
+ public:
+  zetasql_base::Status DefaultVisit(const ResolvedNode* node) override {
+    // The nodes are owned by the AnalyzerOutput being serialized, which is
+    // discarded once the response is built, so stripping in place is safe.
+    const_cast<ResolvedNode*>(node)->ClearParseLocationRange();
+    return node->ChildrenAccept(this);
+  }
+};
+
+}  // namespace
+
 zetasql_base::Status ZetaSqlLocalServiceImpl::SerializeResolvedOutput(
-    const AnalyzerOutput* output, absl::string_view statement,
-    AnalyzeResponse* response, RegisteredCatalogState* state) {
+    const AnalyzerOutput* output,
+    const AstSerializationOptions& serialization_options,
+    absl::string_view statement, AnalyzeResponse* response,
+    RegisteredCatalogState* state) {
+  const ResolvedNode* root = output->resolved_statement() != nullptr
+                                 ? static_cast<const ResolvedNode*>(
+                                       output->resolved_statement())
+                                 : output->resolved_expr();
+  if (serialization_options.skip_parse_location_ranges()) {
+    ParseLocationStripper stripper;
+    ZETASQL_RETURN_IF_ERROR(root->Accept(&stripper));
+  }
+
   const std::vector<const google::protobuf::DescriptorPool*>& pools =
       state->GetDescriptorPools();
   FileDescriptorSetMap file_descriptor_set_map;
-  PopulateExistingPoolsToFileDescriptorSetMap(pools, &file_descriptor_set_map);
+  PopulateExistingPoolsToFileDescriptorSetMap(
+      pools, state->GetDescriptorPoolUnderlays(), &file_descriptor_set_map);
+
+  // The analyzer result may reference the generated descriptor pool: some
+  // built-in functions use the DatetimePart enum whose descriptor comes from
+  // it. The client knows to map the index just past the request pools to the
+  // generated pool, so register that index up front; it must not depend on
+  // how many shared underlay pools were registered above.
+  // TODO: Describe the descriptor pool passing contract in detail
+  // with a doc, and put a link here.
+  std::unique_ptr<Type::FileDescriptorEntry>& generated_pool_entry =
+      file_descriptor_set_map[google::protobuf::DescriptorPool::generated_pool()];
+  ZETASQL_RET_CHECK_EQ(generated_pool_entry.get(), nullptr)
+      << "Request descriptor pools include the generated pool, this shouldn't "
+         "happen.";
+  generated_pool_entry = absl::make_unique<Type::FileDescriptorEntry>();
+  generated_pool_entry->descriptor_set_index = static_cast<int>(pools.size());
+  const size_t num_known_pools = file_descriptor_set_map.size();
 
   if (output->resolved_statement() != nullptr) {
     ZETASQL_RETURN_IF_ERROR(output->resolved_statement()->SaveTo(
@@ -661,25 +1262,9 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::SerializeResolvedOutput(
         &file_descriptor_set_map, response->mutable_resolved_expression()));
   }
 
-  // If the file_descriptor_set_map contains more descriptor pools than those
-  // passed in the request, the additonal one must be the generated descriptor
-  // pool. The reason is that some built-in functions use the DatetimePart
-  // enum whose descriptor comes from the generated pool.
-  // TODO: Describe the descriptor pool passing contract in detail
-  // with a doc, and put a link here.
-  if (file_descriptor_set_map.size() != pools.size()) {
-    ZETASQL_RET_CHECK_EQ(file_descriptor_set_map.size(), pools.size() + 1)
-        << "Analyzer result of " << statement
-        << " uses unknown DescriptorPool, this shouldn't happen.";
-    const auto& entry =
-        file_descriptor_set_map.at(google::protobuf::DescriptorPool::generated_pool());
-    ZETASQL_RET_CHECK_NE(entry.get(), nullptr)
-        << "Analyzer result of " << statement
-        << " uses unknown DescriptorPool, this shouldn't happen.";
-    ZETASQL_RET_CHECK_EQ(entry->descriptor_set_index, pools.size())
-        << "Analyzer result of " << statement
-        << " uses unknown DescriptorPool, this shouldn't happen.";
-  }
+  ZETASQL_RET_CHECK_EQ(file_descriptor_set_map.size(), num_known_pools)
+      << "Analyzer result of " << statement
+      << " uses unknown DescriptorPool, this shouldn't happen.";
 
   return ::zetasql_base::OkStatus();
 }
@@ -703,6 +1288,26 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::RegisterCatalog(
   return ::zetasql_base::OkStatus();
 }
 
+zetasql_base::Status ZetaSqlLocalServiceImpl::RegisterCatalogDiff(
+    const RegisterCatalogDiffRequest& request, RegisterResponse* response) {
+  std::shared_ptr<RegisteredCatalogState> base =
+      registered_catalogs_->Get(request.base_registered_catalog_id());
+  if (base == nullptr) {
+    return MakeSqlError() << "Unknown catalog ID: "
+                          << request.base_registered_catalog_id();
+  }
+
+  std::unique_ptr<RegisteredCatalogState> state(new RegisteredCatalogState());
+  ZETASQL_RETURN_IF_ERROR(state->InitAsDiff(request, std::move(base)));
+
+  int64_t id = registered_catalogs_->Register(state.release());
+  ZETASQL_RET_CHECK_NE(-1, id) << "Failed to register catalog, this shouldn't happen.";
+
+  response->set_registered_id(id);
+
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ZetaSqlLocalServiceImpl::UnregisterCatalog(int64_t id) {
   if (registered_catalogs_->Delete(id)) {
     return ::zetasql_base::OkStatus();
@@ -730,9 +1335,47 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::UnregisterParseResumeLocation(
   return MakeSqlError() << "Unknown ParseResumeLocation ID: " << id;
 }
 
+zetasql_base::Status ZetaSqlLocalServiceImpl::AttachSharedMemoryArena(
+    const AttachSharedMemoryArenaRequest& request, RegisterResponse* response) {
+  auto arena = SharedMemoryArenaState::Create(request.path(), request.size());
+  ZETASQL_RETURN_IF_ERROR(arena.status());
+
+  int64_t id = shared_memory_arenas_->Register(arena.ValueOrDie().release());
+  ZETASQL_RET_CHECK_NE(-1, id)
+      << "Failed to register shared memory arena, this shouldn't happen.";
+
+  response->set_registered_id(id);
+
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ZetaSqlLocalServiceImpl::DetachSharedMemoryArena(int64_t id) {
+  if (shared_memory_arenas_->Delete(id)) {
+    return ::zetasql_base::OkStatus();
+  }
+  return MakeSqlError() << "Unknown shared memory arena ID: " << id;
+}
+
 zetasql_base::Status ZetaSqlLocalServiceImpl::GetBuiltinFunctions(
     const ZetaSQLBuiltinFunctionOptionsProto& proto,
     GetBuiltinFunctionsResponse* resp) {
+  // The response is a pure function of the options, and fleets of workers
+  // typically all ask for the same options at startup, so repeats are
+  // served from a cache instead of rebuilding and re-serializing thousands
+  // of functions. Differences in serialization (e.g. unknown fields) only
+  // cost a cache miss.
+  std::string cache_key;
+  ZETASQL_RET_CHECK(proto.SerializeToString(&cache_key));
+  {
+    absl::MutexLock lock(&builtin_functions_cache_mutex_);
+    const GetBuiltinFunctionsResponse* cached =
+        zetasql_base::FindOrNull(builtin_functions_cache_, cache_key);
+    if (cached != nullptr) {
+      *resp = *cached;
+      return ::zetasql_base::OkStatus();
+    }
+  }
+
   TypeFactory factory;
   std::map<std::string, std::unique_ptr<Function>> functions;
   ZetaSQLBuiltinFunctionOptions options(proto);
@@ -744,6 +1387,10 @@ zetasql_base::Status ZetaSqlLocalServiceImpl::GetBuiltinFunctions(
     ZETASQL_RETURN_IF_ERROR(function.second->Serialize(&map, resp->add_function()));
   }
 
+  {
+    absl::MutexLock lock(&builtin_functions_cache_mutex_);
+    builtin_functions_cache_.emplace(std::move(cache_key), *resp);
+  }
   return ::zetasql_base::OkStatus();
 }
 
@@ -18,6 +18,7 @@
 #define ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_H_
 
 #include <stddef.h>
+#include <functional>
 #include <memory>
 
 #include "zetasql/local_service/local_service.pb.h"
@@ -26,7 +27,10 @@
 #include "zetasql/public/parse_resume_location.h"
 #include "zetasql/public/parse_resume_location.pb.h"
 #include <cstdint>
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -37,6 +41,8 @@ class PreparedExpressionState;
 class RegisteredCatalogPool;
 class RegisteredCatalogState;
 class RegisteredParseResumeLocationPool;
+class SharedMemoryArenaPool;
+class SharedMemoryArenaState;
 
 // Implementation of ZetaSqlLocalService RPC service.
 class ZetaSqlLocalServiceImpl {
@@ -59,6 +65,34 @@ class ZetaSqlLocalServiceImpl {
                             PreparedExpressionState* state,
                             EvaluateResponse* response);
 
+  // Evaluates a prepared expression against every parameter set in 'request',
+  // in order, calling 'write_response' with the result of each as it is
+  // produced. The expression must have been registered with Prepare; the
+  // request fails otherwise. A parameter set that fails to evaluate aborts
+  // the batch and its error is returned; 'write_response' has already been
+  // called for the sets before it.
+  zetasql_base::Status EvaluateBatch(
+      const EvaluateBatchRequest& request,
+      const std::function<zetasql_base::Status(const EvaluateBatchResponse&)>&
+          write_response);
+
+  // Evaluates a SQL query and streams the result rows in batches, calling
+  // 'write_batch' once per batch. A non-OK status returned by 'write_batch'
+  // aborts evaluation and is returned to the caller. Transports whose writes
+  // block on the peer (e.g. gRPC response streams) thereby pace evaluation to
+  // the client's consumption rate, and the server never buffers more than one
+  // batch of rows.
+  zetasql_base::Status EvaluateQueryStream(
+      const EvaluateQueryRequest& request,
+      const std::function<zetasql_base::Status(
+          const EvaluateQueryBatchResponse&)>& write_batch);
+
+  zetasql_base::Status EvaluateQueryStreamImpl(
+      const EvaluateQueryRequest& request,
+      RegisteredCatalogState* catalog_state,
+      const std::function<zetasql_base::Status(
+          const EvaluateQueryBatchResponse&)>& write_batch);
+
   zetasql_base::Status GetTableFromProto(const TableFromProtoRequest& request,
                                  SimpleTableProto* response);
 
@@ -80,6 +114,23 @@ class ZetaSqlLocalServiceImpl {
                                      RegisteredCatalogState* catalog_state,
                                      AnalyzeResponse* response);
 
+  // Analyzes each statement in 'request' against one catalog, calling
+  // 'write_response' with the response for each statement, in request order,
+  // as it completes. The catalog, descriptor pools and analyzer options are
+  // deserialized once for the whole batch. A statement that fails to analyze
+  // aborts the batch and its error is returned; 'write_response' has already
+  // been called for the statements before it.
+  zetasql_base::Status AnalyzeBatch(
+      const AnalyzeBatchRequest& request,
+      const std::function<zetasql_base::Status(const AnalyzeResponse&)>&
+          write_response);
+
+  zetasql_base::Status AnalyzeBatchImpl(
+      const AnalyzeBatchRequest& request,
+      RegisteredCatalogState* catalog_state,
+      const std::function<zetasql_base::Status(const AnalyzeResponse&)>&
+          write_response);
+
   zetasql_base::Status BuildSql(const BuildSqlRequest& request,
                         BuildSqlResponse* response);
 
@@ -91,10 +142,11 @@ class ZetaSqlLocalServiceImpl {
       const ExtractTableNamesFromNextStatementRequest& request,
       ExtractTableNamesFromNextStatementResponse* response);
 
-  zetasql_base::Status SerializeResolvedOutput(const AnalyzerOutput* output,
-                                       absl::string_view statement,
-                                       AnalyzeResponse* response,
-                                       RegisteredCatalogState* state);
+  zetasql_base::Status SerializeResolvedOutput(
+      const AnalyzerOutput* output,
+      const AstSerializationOptions& serialization_options,
+      absl::string_view statement, AnalyzeResponse* response,
+      RegisteredCatalogState* state);
 
   zetasql_base::Status FormatSql(const FormatSqlRequest& request,
                          FormatSqlResponse* response);
@@ -102,6 +154,13 @@ class ZetaSqlLocalServiceImpl {
   zetasql_base::Status RegisterCatalog(const RegisterCatalogRequest& request,
                                RegisterResponse* response);
 
+  // Registers a new catalog as a diff against an already registered base
+  // catalog. Unchanged catalog objects are shared with the base, so the cost
+  // is proportional to the size of the diff. The base stays registered and
+  // usable independently.
+  zetasql_base::Status RegisterCatalogDiff(const RegisterCatalogDiffRequest& request,
+                                   RegisterResponse* response);
+
   zetasql_base::Status UnregisterCatalog(int64_t id);
 
   zetasql_base::Status RegisterParseResumeLocation(
@@ -112,11 +171,34 @@ class ZetaSqlLocalServiceImpl {
   zetasql_base::Status GetLanguageOptions(const LanguageOptionsRequest& request,
                                   LanguageOptionsProto* response);
 
+  // Maps the file backing a client-created shared-memory arena so that
+  // later requests naming the returned id can receive large payloads as
+  // offsets into the arena instead of inline bytes.
+  zetasql_base::Status AttachSharedMemoryArena(
+      const AttachSharedMemoryArenaRequest& request,
+      RegisterResponse* response);
+
+  zetasql_base::Status DetachSharedMemoryArena(int64_t id);
+
  private:
+  // Moves the resolved AST of 'response' into 'arena' if it fits, replacing
+  // the inline field with a SharedMemoryBlockProto. Leaves the response
+  // unchanged if the serialized AST is larger than the arena.
+  zetasql_base::Status MaybeOffloadToSharedMemory(SharedMemoryArenaState* arena,
+                                          AnalyzeResponse* response);
+
   std::unique_ptr<RegisteredCatalogPool> registered_catalogs_;
   std::unique_ptr<PreparedExpressionPool> prepared_expressions_;
   std::unique_ptr<RegisteredParseResumeLocationPool>
       registered_parse_resume_locations_;
+  std::unique_ptr<SharedMemoryArenaPool> shared_memory_arenas_;
+
+  // Responses served by GetBuiltinFunctions, keyed by the serialized
+  // options proto. The builtin function list is a pure function of the
+  // options and there are few distinct options in practice.
+  mutable absl::Mutex builtin_functions_cache_mutex_;
+  absl::flat_hash_map<std::string, GetBuiltinFunctionsResponse>
+      builtin_functions_cache_ GUARDED_BY(builtin_functions_cache_mutex_);
 
   // For testing.
   size_t NumSavedPreparedExpression() const;
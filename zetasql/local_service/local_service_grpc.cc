@@ -16,6 +16,9 @@
 
 #include "zetasql/local_service/local_service_grpc.h"
 
+#include <string>
+
+#include "zetasql/base/canonical_errors.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -80,108 +83,226 @@ grpc::Status ToGrpcStatus(zetasql_base::Status status) {
   return grpc::Status(grpc_code, status.error_message(), "");
 }
 
+// Asks gRPC to gzip the response. Resolved ASTs, FileDescriptorSets and row
+// data compress several-fold. The encoding is negotiated: the response is
+// sent uncompressed if the client did not advertise gzip support.
+void CompressResponse(grpc::ServerContext* context) {
+  context->set_compression_algorithm(GRPC_COMPRESS_GZIP);
+}
+
 }  // namespace
 
+void ZetaSqlLocalServiceGrpcImpl::RecordRpc(const std::string& method,
+                                            int64_t request_bytes,
+                                            int64_t response_bytes) {
+  absl::MutexLock lock(&stats_mutex_);
+  MethodStats& stats = rpc_stats_[method];
+  ++stats.calls;
+  stats.request_bytes += request_bytes;
+  stats.response_bytes += response_bytes;
+}
+
+std::map<std::string, ZetaSqlLocalServiceGrpcImpl::MethodStats>
+ZetaSqlLocalServiceGrpcImpl::GetRpcStats() const {
+  absl::MutexLock lock(&stats_mutex_);
+  return rpc_stats_;
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::Finish(
+    const std::string& method, const google::protobuf::Message& request,
+    const google::protobuf::Message& response, zetasql_base::Status status) {
+  RecordRpc(method, request.ByteSizeLong(), response.ByteSizeLong());
+  return ToGrpcStatus(status);
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Prepare(
     grpc::ServerContext* context, const PrepareRequest* req,
     PrepareResponse* resp) {
-  return ToGrpcStatus(service_.Prepare(*req, resp));
+  return Finish("Prepare", *req, *resp, service_.Prepare(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Unprepare(
     grpc::ServerContext* context, const UnprepareRequest* req,
     google::protobuf::Empty* unused) {
-  return ToGrpcStatus(service_.Unprepare(req->prepared_expression_id()));
+  return Finish("Unprepare", *req, *unused,
+                service_.Unprepare(req->prepared_expression_id()));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Evaluate(
     grpc::ServerContext* context, const EvaluateRequest* req,
     EvaluateResponse* resp) {
-  return ToGrpcStatus(service_.Evaluate(*req, resp));
+  CompressResponse(context);
+  return Finish("Evaluate", *req, *resp, service_.Evaluate(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateBatch(
+    grpc::ServerContext* context, const EvaluateBatchRequest* req,
+    grpc::ServerWriter<EvaluateBatchResponse>* writer) {
+  CompressResponse(context);
+  int64_t response_bytes = 0;
+  zetasql_base::Status status = service_.EvaluateBatch(
+      *req, [writer, &response_bytes](const EvaluateBatchResponse& resp) {
+        response_bytes += resp.ByteSizeLong();
+        if (!writer->Write(resp)) {
+          return zetasql_base::CancelledError("Stream closed by client");
+        }
+        return ::zetasql_base::OkStatus();
+      });
+  RecordRpc("EvaluateBatch", req->ByteSizeLong(), response_bytes);
+  return ToGrpcStatus(status);
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateQueryStream(
+    grpc::ServerContext* context, const EvaluateQueryRequest* req,
+    grpc::ServerWriter<EvaluateQueryBatchResponse>* writer) {
+  CompressResponse(context);
+  int64_t response_bytes = 0;
+  zetasql_base::Status status = service_.EvaluateQueryStream(
+      *req, [writer, &response_bytes](const EvaluateQueryBatchResponse& batch) {
+        response_bytes += batch.ByteSizeLong();
+        // Write() blocks on gRPC flow control, so a slow client paces
+        // evaluation instead of causing batches to pile up on the server.
+        if (!writer->Write(batch)) {
+          return zetasql_base::CancelledError("Stream closed by client");
+        }
+        return ::zetasql_base::OkStatus();
+      });
+  RecordRpc("EvaluateQueryStream", req->ByteSizeLong(), response_bytes);
+  return ToGrpcStatus(status);
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::GetTableFromProto(
     grpc::ServerContext* context, const TableFromProtoRequest* req,
     SimpleTableProto* resp) {
-  return ToGrpcStatus(service_.GetTableFromProto(*req, resp));
+  CompressResponse(context);
+  return Finish("GetTableFromProto", *req, *resp,
+                service_.GetTableFromProto(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Analyze(
     grpc::ServerContext* context, const AnalyzeRequest* req,
     AnalyzeResponse* resp) {
-  return ToGrpcStatus(service_.Analyze(*req, resp));
+  CompressResponse(context);
+  return Finish("Analyze", *req, *resp, service_.Analyze(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::AnalyzeBatch(
+    grpc::ServerContext* context, const AnalyzeBatchRequest* req,
+    grpc::ServerWriter<AnalyzeResponse>* writer) {
+  CompressResponse(context);
+  int64_t response_bytes = 0;
+  zetasql_base::Status status = service_.AnalyzeBatch(
+      *req, [writer, &response_bytes](const AnalyzeResponse& resp) {
+        response_bytes += resp.ByteSizeLong();
+        if (!writer->Write(resp)) {
+          return zetasql_base::CancelledError("Stream closed by client");
+        }
+        return ::zetasql_base::OkStatus();
+      });
+  RecordRpc("AnalyzeBatch", req->ByteSizeLong(), response_bytes);
+  return ToGrpcStatus(status);
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::BuildSql(
     grpc::ServerContext* context, const BuildSqlRequest* req,
     BuildSqlResponse* resp) {
-  return ToGrpcStatus(service_.BuildSql(*req, resp));
+  CompressResponse(context);
+  return Finish("BuildSql", *req, *resp, service_.BuildSql(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::ExtractTableNamesFromStatement(
     grpc::ServerContext* context,
     const ExtractTableNamesFromStatementRequest* req,
     ExtractTableNamesFromStatementResponse* resp) {
-  return ToGrpcStatus(service_.ExtractTableNamesFromStatement(*req, resp));
+  return Finish("ExtractTableNamesFromStatement", *req, *resp,
+                service_.ExtractTableNamesFromStatement(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::ExtractTableNamesFromNextStatement(
     grpc::ServerContext* context,
     const ExtractTableNamesFromNextStatementRequest* req,
     ExtractTableNamesFromNextStatementResponse* resp) {
-  return ToGrpcStatus(service_.ExtractTableNamesFromNextStatement(*req, resp));
+  return Finish("ExtractTableNamesFromNextStatement", *req, *resp,
+                service_.ExtractTableNamesFromNextStatement(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::FormatSql(
     grpc::ServerContext* context, const FormatSqlRequest* req,
     FormatSqlResponse* resp) {
-  return ToGrpcStatus(service_.FormatSql(*req, resp));
+  return Finish("FormatSql", *req, *resp, service_.FormatSql(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::RegisterCatalog(
     grpc::ServerContext* context, const RegisterCatalogRequest* req,
     RegisterResponse* resp) {
-  return ToGrpcStatus(service_.RegisterCatalog(*req, resp));
+  return Finish("RegisterCatalog", *req, *resp,
+                service_.RegisterCatalog(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::RegisterCatalogDiff(
+    grpc::ServerContext* context, const RegisterCatalogDiffRequest* req,
+    RegisterResponse* resp) {
+  return Finish("RegisterCatalogDiff", *req, *resp,
+                service_.RegisterCatalogDiff(*req, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::UnregisterCatalog(
     grpc::ServerContext* context, const UnregisterRequest* req,
     google::protobuf::Empty* unused) {
-  return ToGrpcStatus(service_.UnregisterCatalog(req->registered_id()));
+  return Finish("UnregisterCatalog", *req, *unused,
+                service_.UnregisterCatalog(req->registered_id()));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::RegisterParseResumeLocation(
     grpc::ServerContext* context,
     const ParseResumeLocationProto* parse_resume_location,
     RegisterResponse* resp) {
-  return ToGrpcStatus(
+  return Finish(
+      "RegisterParseResumeLocation", *parse_resume_location, *resp,
       service_.RegisterParseResumeLocation(*parse_resume_location, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::UnregisterParseResumeLocation(
     grpc::ServerContext* context, const UnregisterRequest* req,
     google::protobuf::Empty* unused) {
-  return ToGrpcStatus(
-      service_.UnregisterParseResumeLocation(req->registered_id()));
+  return Finish("UnregisterParseResumeLocation", *req, *unused,
+                service_.UnregisterParseResumeLocation(req->registered_id()));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::GetBuiltinFunctions(
     grpc::ServerContext* context,
     const ZetaSQLBuiltinFunctionOptionsProto* options,
     GetBuiltinFunctionsResponse* resp) {
-  return ToGrpcStatus(service_.GetBuiltinFunctions(*options, resp));
+  CompressResponse(context);
+  return Finish("GetBuiltinFunctions", *options, *resp,
+                service_.GetBuiltinFunctions(*options, resp));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::AddSimpleTable(
     grpc::ServerContext* context, const AddSimpleTableRequest* req,
     google::protobuf::Empty* unused) {
-  return ToGrpcStatus(service_.AddSimpleTable(*req));
+  return Finish("AddSimpleTable", *req, *unused, service_.AddSimpleTable(*req));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::GetLanguageOptions(
     grpc::ServerContext* context, const LanguageOptionsRequest* req,
     LanguageOptionsProto* resp) {
-  return ToGrpcStatus(service_.GetLanguageOptions(*req, resp));
+  return Finish("GetLanguageOptions", *req, *resp,
+                service_.GetLanguageOptions(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::AttachSharedMemoryArena(
+    grpc::ServerContext* context, const AttachSharedMemoryArenaRequest* req,
+    RegisterResponse* resp) {
+  return Finish("AttachSharedMemoryArena", *req, *resp,
+                service_.AttachSharedMemoryArena(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::DetachSharedMemoryArena(
+    grpc::ServerContext* context, const UnregisterRequest* req,
+    google::protobuf::Empty* unused) {
+  return Finish("DetachSharedMemoryArena", *req, *unused,
+                service_.DetachSharedMemoryArena(req->registered_id()));
 }
 
 }  // namespace local_service
@@ -17,12 +17,18 @@
 #ifndef ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_GRPC_H_
 #define ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_GRPC_H_
 
+#include <cstdint>
+#include <map>
+#include <string>
+
 #include "zetasql/local_service/local_service.grpc.pb.h"
 #include "zetasql/local_service/local_service.h"
 #include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/proto/options.pb.h"
 #include "zetasql/public/parse_resume_location.pb.h"
 #include "zetasql/public/simple_table.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 
 namespace zetasql {
 namespace local_service {
@@ -42,6 +48,14 @@ class ZetaSqlLocalServiceGrpcImpl
                         const EvaluateRequest* req,
                         EvaluateResponse* resp) override;
 
+  grpc::Status EvaluateBatch(
+      grpc::ServerContext* context, const EvaluateBatchRequest* req,
+      grpc::ServerWriter<EvaluateBatchResponse>* writer) override;
+
+  grpc::Status EvaluateQueryStream(
+      grpc::ServerContext* context, const EvaluateQueryRequest* req,
+      grpc::ServerWriter<EvaluateQueryBatchResponse>* writer) override;
+
   grpc::Status GetTableFromProto(grpc::ServerContext* context,
                                  const TableFromProtoRequest* req,
                                  SimpleTableProto* resp) override;
@@ -49,6 +63,11 @@ class ZetaSqlLocalServiceGrpcImpl
   grpc::Status Analyze(grpc::ServerContext* context, const AnalyzeRequest* req,
                        AnalyzeResponse* resp) override;
 
+  grpc::Status AnalyzeBatch(grpc::ServerContext* context,
+                            const AnalyzeBatchRequest* req,
+                            grpc::ServerWriter<AnalyzeResponse>* writer)
+      override;
+
   grpc::Status BuildSql(grpc::ServerContext* context,
                         const BuildSqlRequest* req,
                         BuildSqlResponse* resp) override;
@@ -71,6 +90,10 @@ class ZetaSqlLocalServiceGrpcImpl
                                const RegisterCatalogRequest* req,
                                RegisterResponse* resp) override;
 
+  grpc::Status RegisterCatalogDiff(grpc::ServerContext* context,
+                                   const RegisterCatalogDiffRequest* req,
+                                   RegisterResponse* resp) override;
+
   grpc::Status UnregisterCatalog(grpc::ServerContext* context,
                                  const UnregisterRequest* req,
                                  google::protobuf::Empty* unused) override;
@@ -97,8 +120,51 @@ class ZetaSqlLocalServiceGrpcImpl
                                   const LanguageOptionsRequest* req,
                                   LanguageOptionsProto* resp) override;
 
+  grpc::Status AttachSharedMemoryArena(grpc::ServerContext* context,
+                                       const AttachSharedMemoryArenaRequest* req,
+                                       RegisterResponse* resp) override;
+
+  grpc::Status DetachSharedMemoryArena(grpc::ServerContext* context,
+                                       const UnregisterRequest* req,
+                                       google::protobuf::Empty* unused) override;
+
+  // Returns the underlying transport-agnostic service. The JNI bridge
+  // dispatches direct (non-gRPC) calls to the same instance so that
+  // registered catalogs and prepared expressions are shared with calls
+  // arriving through the gRPC server.
+  ZetaSqlLocalServiceImpl& service() { return service_; }
+
+  // Cumulative marshalling cost of one RPC method. Byte counts are
+  // serialized proto sizes, measured before transport compression; bytes
+  // actually put on the wire may be smaller when the client negotiates a
+  // compressed encoding.
+  struct MethodStats {
+    int64_t calls = 0;
+    int64_t request_bytes = 0;
+    int64_t response_bytes = 0;
+  };
+
+  // Returns a snapshot of per-method marshalling stats accumulated since
+  // the service was created, keyed by bare RPC method name.
+  std::map<std::string, MethodStats> GetRpcStats() const
+      LOCKS_EXCLUDED(stats_mutex_);
+
  private:
+  // Records one finished call of 'method' into rpc_stats_.
+  void RecordRpc(const std::string& method, int64_t request_bytes,
+                 int64_t response_bytes) LOCKS_EXCLUDED(stats_mutex_);
+
+  // Records the marshalling cost of a finished unary call under 'method'
+  // and converts 'status' to the grpc equivalent.
+  grpc::Status Finish(const std::string& method,
+                      const google::protobuf::Message& request,
+                      const google::protobuf::Message& response,
+                      zetasql_base::Status status);
+
   ZetaSqlLocalServiceImpl service_;
+
+  mutable absl::Mutex stats_mutex_;
+  std::map<std::string, MethodStats> rpc_stats_ GUARDED_BY(stats_mutex_);
 };
 
 }  // namespace local_service
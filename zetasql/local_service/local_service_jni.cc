@@ -17,6 +17,7 @@
 #include "zetasql/local_service/local_service_jni.h"
 
 #include <errno.h>
+#include <grpcpp/security/server_credentials.h>
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
 #include <grpcpp/server_posix.h>
@@ -24,26 +25,113 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <string>
 
+#include "google/protobuf/empty.pb.h"
+#include "zetasql/base/status.h"
+#include "zetasql/local_service/local_service.h"
+#include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/local_service/local_service_grpc.h"
+#include "zetasql/proto/options.pb.h"
+#include "zetasql/public/parse_resume_location.pb.h"
+#include "zetasql/public/simple_table.pb.h"
 
 namespace zetasql {
 namespace local_service {
 namespace {
 
+// The service must remain for the lifetime of the process. It is shared
+// between the gRPC server and the direct call path of Call(), so state
+// registered through one path is visible to the other.
+static ZetaSqlLocalServiceGrpcImpl* GetGrpcService() {
+  static ZetaSqlLocalServiceGrpcImpl* service =
+      new ZetaSqlLocalServiceGrpcImpl();
+  return service;
+}
+
 static grpc::Server* GetServer() {
   static grpc::Server* server = []() {
-    // The service must remain for the lifetime of the server.
-    static ZetaSqlLocalServiceGrpcImpl* service =
-        new ZetaSqlLocalServiceGrpcImpl();
     grpc::ServerBuilder builder;
-    builder.RegisterService(service);
+    // Same-host clients that are not loaded into this process can connect
+    // over a unix domain socket instead of loopback TCP, which skips the
+    // TCP stack and its per-message latency. Access to the socket is
+    // controlled by the filesystem permissions of its path, which keeps the
+    // service locked down to the user that started it.
+    const char* uds_path = getenv("ZETASQL_LOCAL_SERVICE_UNIX_SOCKET");
+    if (uds_path != nullptr && uds_path[0] != '\0') {
+      builder.AddListeningPort(std::string("unix:") + uds_path,
+                               grpc::InsecureServerCredentials());
+    }
+    builder.RegisterService(GetGrpcService());
     return builder.BuildAndStart().release();
   }();
   return server;
 }
 
+// Global references resolved in JNI_OnLoad against the (possibly shaded)
+// provider class, used by Call() to report failures with a canonical
+// error code attached.
+static jclass service_exception_class = nullptr;
+static jmethodID service_exception_ctor = nullptr;
+
+static void ThrowServiceException(JNIEnv* env, int code,
+                                  const std::string& message) {
+  if (service_exception_class == nullptr ||
+      service_exception_ctor == nullptr) {
+    jclass e = env->FindClass("java/lang/IllegalStateException");
+    if (e != nullptr) {
+      env->ThrowNew(e, message.c_str());
+    }
+    return;
+  }
+  jthrowable exception = (jthrowable)env->NewObject(
+      service_exception_class, service_exception_ctor, code,
+      env->NewStringUTF(message.c_str()));
+  if (exception != nullptr) {
+    env->Throw(exception);
+  }
+}
+
+// Parses a RequestProto from <data, size>, invokes handler on it and
+// returns the serialized response in a direct ByteBuffer backed by
+// malloc'd memory, to be freed by ReleaseResponse(). Returns nullptr
+// with a ServiceException pending on failure.
+template <typename RequestProto, typename ResponseProto, typename Handler>
+static jobject DispatchCall(JNIEnv* env, const void* data, jint size,
+                            Handler handler) {
+  RequestProto request;
+  if (!request.ParseFromArray(data, size)) {
+    ThrowServiceException(
+        env, static_cast<int>(zetasql_base::StatusCode::kInvalidArgument),
+        "Failed to parse request proto");
+    return nullptr;
+  }
+  ResponseProto response;
+  zetasql_base::Status status = handler(request, &response);
+  if (!status.ok()) {
+    ThrowServiceException(env, static_cast<int>(status.code()),
+                          status.error_message());
+    return nullptr;
+  }
+  size_t response_size = response.ByteSizeLong();
+  void* buffer = malloc(response_size > 0 ? response_size : 1);
+  if (buffer == nullptr) {
+    ThrowServiceException(
+        env, static_cast<int>(zetasql_base::StatusCode::kResourceExhausted),
+        "Failed to allocate response buffer");
+    return nullptr;
+  }
+  response.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(buffer));
+  jobject byte_buffer = env->NewDirectByteBuffer(buffer, response_size);
+  if (byte_buffer == nullptr) {
+    free(buffer);
+  }
+  return byte_buffer;
+}
+
 static void ErrnoSocketException(JNIEnv* env) {
   char buf[128];
   char* outstr = strerror_r(errno, buf, sizeof(buf));
@@ -88,6 +176,159 @@ static jobject WrapFileDescriptor(JNIEnv* env, const int fd) {
 
 }  // namespace
 
+jobject Call(JNIEnv* env, jclass clazz, jstring method_name, jobject request,
+             jint request_length) {
+  void* data = env->GetDirectBufferAddress(request);
+  if (data == nullptr) {
+    ThrowServiceException(
+        env, static_cast<int>(zetasql_base::StatusCode::kInvalidArgument),
+        "Request buffer is not a direct ByteBuffer");
+    return nullptr;
+  }
+
+  const char* namestr = env->GetStringUTFChars(method_name, nullptr);
+  if (namestr == nullptr) {
+    return nullptr;
+  }
+  std::string name(namestr);
+  env->ReleaseStringUTFChars(method_name, namestr);
+
+  ZetaSqlLocalServiceImpl* service = &GetGrpcService()->service();
+  if (name == "Prepare") {
+    return DispatchCall<PrepareRequest, PrepareResponse>(
+        env, data, request_length,
+        [service](const PrepareRequest& req, PrepareResponse* resp) {
+          return service->Prepare(req, resp);
+        });
+  } else if (name == "Unprepare") {
+    return DispatchCall<UnprepareRequest, google::protobuf::Empty>(
+        env, data, request_length,
+        [service](const UnprepareRequest& req, google::protobuf::Empty*) {
+          return service->Unprepare(req.prepared_expression_id());
+        });
+  } else if (name == "Evaluate") {
+    return DispatchCall<EvaluateRequest, EvaluateResponse>(
+        env, data, request_length,
+        [service](const EvaluateRequest& req, EvaluateResponse* resp) {
+          return service->Evaluate(req, resp);
+        });
+  } else if (name == "GetTableFromProto") {
+    return DispatchCall<TableFromProtoRequest, SimpleTableProto>(
+        env, data, request_length,
+        [service](const TableFromProtoRequest& req, SimpleTableProto* resp) {
+          return service->GetTableFromProto(req, resp);
+        });
+  } else if (name == "Analyze") {
+    return DispatchCall<AnalyzeRequest, AnalyzeResponse>(
+        env, data, request_length,
+        [service](const AnalyzeRequest& req, AnalyzeResponse* resp) {
+          return service->Analyze(req, resp);
+        });
+  } else if (name == "BuildSql") {
+    return DispatchCall<BuildSqlRequest, BuildSqlResponse>(
+        env, data, request_length,
+        [service](const BuildSqlRequest& req, BuildSqlResponse* resp) {
+          return service->BuildSql(req, resp);
+        });
+  } else if (name == "ExtractTableNamesFromStatement") {
+    return DispatchCall<ExtractTableNamesFromStatementRequest,
+                        ExtractTableNamesFromStatementResponse>(
+        env, data, request_length,
+        [service](const ExtractTableNamesFromStatementRequest& req,
+                  ExtractTableNamesFromStatementResponse* resp) {
+          return service->ExtractTableNamesFromStatement(req, resp);
+        });
+  } else if (name == "ExtractTableNamesFromNextStatement") {
+    return DispatchCall<ExtractTableNamesFromNextStatementRequest,
+                        ExtractTableNamesFromNextStatementResponse>(
+        env, data, request_length,
+        [service](const ExtractTableNamesFromNextStatementRequest& req,
+                  ExtractTableNamesFromNextStatementResponse* resp) {
+          return service->ExtractTableNamesFromNextStatement(req, resp);
+        });
+  } else if (name == "FormatSql") {
+    return DispatchCall<FormatSqlRequest, FormatSqlResponse>(
+        env, data, request_length,
+        [service](const FormatSqlRequest& req, FormatSqlResponse* resp) {
+          return service->FormatSql(req, resp);
+        });
+  } else if (name == "RegisterCatalog") {
+    return DispatchCall<RegisterCatalogRequest, RegisterResponse>(
+        env, data, request_length,
+        [service](const RegisterCatalogRequest& req, RegisterResponse* resp) {
+          return service->RegisterCatalog(req, resp);
+        });
+  } else if (name == "UnregisterCatalog") {
+    return DispatchCall<UnregisterRequest, google::protobuf::Empty>(
+        env, data, request_length,
+        [service](const UnregisterRequest& req, google::protobuf::Empty*) {
+          return service->UnregisterCatalog(req.registered_id());
+        });
+  } else if (name == "RegisterParseResumeLocation") {
+    return DispatchCall<ParseResumeLocationProto, RegisterResponse>(
+        env, data, request_length,
+        [service](const ParseResumeLocationProto& req,
+                  RegisterResponse* resp) {
+          return service->RegisterParseResumeLocation(req, resp);
+        });
+  } else if (name == "UnregisterParseResumeLocation") {
+    return DispatchCall<UnregisterRequest, google::protobuf::Empty>(
+        env, data, request_length,
+        [service](const UnregisterRequest& req, google::protobuf::Empty*) {
+          return service->UnregisterParseResumeLocation(req.registered_id());
+        });
+  } else if (name == "GetBuiltinFunctions") {
+    return DispatchCall<ZetaSQLBuiltinFunctionOptionsProto,
+                        GetBuiltinFunctionsResponse>(
+        env, data, request_length,
+        [service](const ZetaSQLBuiltinFunctionOptionsProto& req,
+                  GetBuiltinFunctionsResponse* resp) {
+          return service->GetBuiltinFunctions(req, resp);
+        });
+  } else if (name == "AddSimpleTable") {
+    return DispatchCall<AddSimpleTableRequest, google::protobuf::Empty>(
+        env, data, request_length,
+        [service](const AddSimpleTableRequest& req, google::protobuf::Empty*) {
+          return service->AddSimpleTable(req);
+        });
+  } else if (name == "GetLanguageOptions") {
+    return DispatchCall<LanguageOptionsRequest, LanguageOptionsProto>(
+        env, data, request_length,
+        [service](const LanguageOptionsRequest& req,
+                  LanguageOptionsProto* resp) {
+          return service->GetLanguageOptions(req, resp);
+        });
+  } else if (name == "AttachSharedMemoryArena") {
+    return DispatchCall<AttachSharedMemoryArenaRequest, RegisterResponse>(
+        env, data, request_length,
+        [service](const AttachSharedMemoryArenaRequest& req,
+                  RegisterResponse* resp) {
+          return service->AttachSharedMemoryArena(req, resp);
+        });
+  } else if (name == "DetachSharedMemoryArena") {
+    return DispatchCall<UnregisterRequest, google::protobuf::Empty>(
+        env, data, request_length,
+        [service](const UnregisterRequest& req, google::protobuf::Empty*) {
+          return service->DetachSharedMemoryArena(req.registered_id());
+        });
+  }
+
+  ThrowServiceException(
+      env, static_cast<int>(zetasql_base::StatusCode::kUnimplemented),
+      "Method " + name + " is not supported by the direct call bridge");
+  return nullptr;
+}
+
+void ReleaseResponse(JNIEnv* env, jclass clazz, jobject response) {
+  if (response == nullptr) {
+    return;
+  }
+  void* data = env->GetDirectBufferAddress(response);
+  if (data != nullptr) {
+    free(data);
+  }
+}
+
 jobject GetSocketChannel(JNIEnv* env) {
   jclass impl = env->FindClass("sun/nio/ch/SocketChannelImpl");
   if (impl == nullptr) {
@@ -148,6 +389,8 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
   }
 
   const char* classnamestr = env->GetStringUTFChars(classname, nullptr);
+  std::string exception_class_name =
+      std::string(classnamestr) + "$ServiceException";
   jclass clazz = env->FindClass(classnamestr);
   env->ReleaseStringUTFChars(classname, classnamestr);
   classnamestr = nullptr;
@@ -155,9 +398,26 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
     return -1;
   }
 
+  jclass exception_class = env->FindClass(exception_class_name.c_str());
+  if (exception_class == nullptr) {
+    return -1;
+  }
+  service_exception_class = (jclass)env->NewGlobalRef(exception_class);
+  service_exception_ctor = env->GetMethodID(service_exception_class, "<init>",
+                                            "(ILjava/lang/String;)V");
+  if (service_exception_ctor == nullptr) {
+    return -1;
+  }
+
   static JNINativeMethod methods[] = {
       {(char*)"getSocketChannel", (char*)"()Ljava/nio/channels/SocketChannel;",
        (void*)GetSocketChannel},
+      {(char*)"call",
+       (char*)"(Ljava/lang/String;Ljava/nio/ByteBuffer;I)"
+              "Ljava/nio/ByteBuffer;",
+       (void*)Call},
+      {(char*)"releaseResponse", (char*)"(Ljava/nio/ByteBuffer;)V",
+       (void*)ReleaseResponse},
   };
   if (env->RegisterNatives(clazz, methods,
                            sizeof(methods) / sizeof(JNINativeMethod)) !=
@@ -26,6 +26,20 @@ namespace local_service {
 // and connects the other end to the local_service gRPC server.
 jobject GetSocketChannel(JNIEnv* env);
 
+// Serves a unary RPC without going through gRPC. Parses a serialized
+// <method_name>Request from the direct ByteBuffer `request` (the first
+// `request_length` bytes), dispatches it to the same service instance
+// backing the gRPC server, and returns the serialized response in a
+// direct ByteBuffer owning malloc'd memory. On failure throws a
+// ServiceException (nested in the provider class) carrying the
+// canonical error code and returns nullptr.
+jobject Call(JNIEnv* env, jclass clazz, jstring method_name, jobject request,
+             jint request_length);
+
+// Frees the native memory backing a ByteBuffer returned by Call(). The
+// buffer must not be used afterwards.
+void ReleaseResponse(JNIEnv* env, jclass clazz, jobject response);
+
 }  // namespace local_service
 }  // namespace zetasql
 
@@ -16,6 +16,10 @@
 
 #include "zetasql/local_service/local_service.h"
 
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <string>
 #include <utility>
 
@@ -40,6 +44,7 @@
 #include "zetasql/testdata/test_schema.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "zetasql/base/status.h"
 
@@ -80,16 +85,54 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.Evaluate(request, response);
   }
 
+  zetasql_base::Status EvaluateBatch(const EvaluateBatchRequest& request,
+                             std::vector<EvaluateBatchResponse>* responses) {
+    return service_.EvaluateBatch(
+        request, [responses](const EvaluateBatchResponse& response) {
+          responses->push_back(response);
+          return ::zetasql_base::OkStatus();
+        });
+  }
+
+  zetasql_base::Status EvaluateQueryStream(
+      const EvaluateQueryRequest& request,
+      std::vector<EvaluateQueryBatchResponse>* batches) {
+    return service_.EvaluateQueryStream(
+        request, [batches](const EvaluateQueryBatchResponse& batch) {
+          batches->push_back(batch);
+          return ::zetasql_base::OkStatus();
+        });
+  }
+
   zetasql_base::Status Analyze(const AnalyzeRequest& request,
                        AnalyzeResponse* response) {
     return service_.Analyze(request, response);
   }
 
+  zetasql_base::Status AnalyzeBatch(const AnalyzeBatchRequest& request,
+                            std::vector<AnalyzeResponse>* responses) {
+    return service_.AnalyzeBatch(
+        request, [responses](const AnalyzeResponse& response) {
+          responses->push_back(response);
+          return ::zetasql_base::OkStatus();
+        });
+  }
+
   zetasql_base::Status BuildSql(const BuildSqlRequest& request,
                         BuildSqlResponse* response) {
     return service_.BuildSql(request, response);
   }
 
+  zetasql_base::Status AttachSharedMemoryArena(
+      const AttachSharedMemoryArenaRequest& request,
+      RegisterResponse* response) {
+    return service_.AttachSharedMemoryArena(request, response);
+  }
+
+  zetasql_base::Status DetachSharedMemoryArena(int64_t id) {
+    return service_.DetachSharedMemoryArena(id);
+  }
+
   zetasql_base::Status ExtractTableNamesFromStatement(
       const ExtractTableNamesFromStatementRequest& request,
       ExtractTableNamesFromStatementResponse* response) {
@@ -107,10 +150,25 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.FormatSql(request, response);
   }
 
+  zetasql_base::Status RegisterCatalog(const RegisterCatalogRequest& request,
+                               RegisterResponse* response) {
+    return service_.RegisterCatalog(request, response);
+  }
+
+  zetasql_base::Status RegisterCatalogDiff(const RegisterCatalogDiffRequest& request,
+                                   RegisterResponse* response) {
+    return service_.RegisterCatalogDiff(request, response);
+  }
+
   zetasql_base::Status UnregisterCatalog(int64_t id) {
     return service_.UnregisterCatalog(id);
   }
 
+  zetasql_base::Status RegisterParseResumeLocation(
+      const ParseResumeLocationProto& location, RegisterResponse* response) {
+    return service_.RegisterParseResumeLocation(location, response);
+  }
+
   zetasql_base::Status UnregisterParseResumeLocation(int64_t id) {
     return service_.UnregisterParseResumeLocation(id);
   }
@@ -362,6 +420,50 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluatePrepared) {
   ZETASQL_ASSERT_OK(Unprepare(response.prepared_expression_id()));
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateBatch) {
+  PrepareRequest request;
+  request.set_sql("@p + 1");
+  auto* param = request.mutable_options()->add_query_parameters();
+  param->set_name("p");
+  param->mutable_type()->set_type_kind(TYPE_INT64);
+
+  PrepareResponse response;
+  ZETASQL_ASSERT_OK(Prepare(request, &response));
+
+  EvaluateBatchRequest batch_request;
+  batch_request.set_prepared_expression_id(response.prepared_expression_id());
+  for (int64_t value : {1, 2, 3}) {
+    auto* parameter_set = batch_request.add_parameter_set();
+    auto* batch_param = parameter_set->add_params();
+    batch_param->set_name("p");
+    batch_param->mutable_type()->set_type_kind(TYPE_INT64);
+    batch_param->mutable_value()->set_int64_value(value);
+  }
+
+  std::vector<EvaluateBatchResponse> responses;
+  ZETASQL_ASSERT_OK(EvaluateBatch(batch_request, &responses));
+  ASSERT_EQ(3, responses.size());
+  // The output type is serialized into the first response only.
+  EXPECT_EQ(TYPE_INT64, responses[0].type().type_kind());
+  EXPECT_FALSE(responses[1].has_type());
+  EXPECT_EQ(2, responses[0].value().int64_value());
+  EXPECT_EQ(3, responses[1].value().int64_value());
+  EXPECT_EQ(4, responses[2].value().int64_value());
+
+  ZETASQL_ASSERT_OK(Unprepare(response.prepared_expression_id()));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateBatchRequiresPreparedExpression) {
+  EvaluateBatchRequest request;
+  std::vector<EvaluateBatchResponse> responses;
+  EXPECT_FALSE(EvaluateBatch(request, &responses).ok());
+  EXPECT_TRUE(responses.empty());
+
+  request.set_prepared_expression_id(12345);
+  EXPECT_FALSE(EvaluateBatch(request, &responses).ok());
+  EXPECT_TRUE(responses.empty());
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, EvaluateWithWrongId) {
   EvaluateRequest evaluate_request;
   evaluate_request.set_prepared_expression_id(12345);
@@ -399,6 +501,56 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateFailuresNoRegister) {
   EXPECT_EQ(0, NumSavedPreparedExpression());
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryStream) {
+  EvaluateQueryRequest request;
+  request.mutable_simple_catalog();
+  request.set_sql("SELECT x FROM UNNEST([1, 2, 3, 4, 5]) AS x ORDER BY x");
+  request.set_batch_size(2);
+
+  std::vector<EvaluateQueryBatchResponse> batches;
+  ZETASQL_ASSERT_OK(EvaluateQueryStream(request, &batches));
+
+  // 5 rows in batches of 2 rows.
+  ASSERT_EQ(3, batches.size());
+  // Only the first batch carries the column schema.
+  ASSERT_EQ(1, batches[0].columns_size());
+  EXPECT_EQ("x", batches[0].columns(0).name());
+  EXPECT_EQ(TYPE_INT64, batches[0].columns(0).type().type_kind());
+  EXPECT_EQ(0, batches[1].columns_size());
+
+  EXPECT_EQ(2, batches[0].rows_size());
+  EXPECT_EQ(2, batches[1].rows_size());
+  EXPECT_EQ(1, batches[2].rows_size());
+  ASSERT_EQ(1, batches[1].rows(0).cell_size());
+  EXPECT_EQ(3, batches[1].rows(0).cell(0).int64_value());
+  EXPECT_EQ(5, batches[2].rows(0).cell(0).int64_value());
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryStreamEmptyResult) {
+  EvaluateQueryRequest request;
+  request.mutable_simple_catalog();
+  request.set_sql("SELECT x FROM UNNEST(ARRAY<INT64>[]) AS x");
+
+  std::vector<EvaluateQueryBatchResponse> batches;
+  ZETASQL_ASSERT_OK(EvaluateQueryStream(request, &batches));
+
+  // An empty result still produces one batch carrying the column schema.
+  ASSERT_EQ(1, batches.size());
+  ASSERT_EQ(1, batches[0].columns_size());
+  EXPECT_EQ("x", batches[0].columns(0).name());
+  EXPECT_EQ(0, batches[0].rows_size());
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryStreamWrongCatalogId) {
+  EvaluateQueryRequest request;
+  request.set_sql("SELECT 1 AS x");
+  request.set_registered_catalog_id(10086);
+
+  std::vector<EvaluateQueryBatchResponse> batches;
+  ASSERT_FALSE(EvaluateQueryStream(request, &batches).ok());
+  EXPECT_EQ(0, batches.size());
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, UnprepareUnknownId) {
   ASSERT_FALSE(Unprepare(10086).ok());
 }
@@ -661,6 +813,63 @@ TEST_F(ZetaSqlLocalServiceImplTest, ExtractTableNamesFromNextStatement) {
   EXPECT_THAT(response, EqualsProto(expectedResponse));
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, ExtractTableNamesFromRegisteredScript) {
+  ParseResumeLocationProto location;
+  location.set_input("select count(1) from foo.bar; select id from baz;");
+  RegisterResponse register_response;
+  ZETASQL_ASSERT_OK(RegisterParseResumeLocation(location, &register_response));
+  int64_t id = register_response.registered_id();
+
+  // Only the handle is sent; the server advances the held position, so the
+  // two calls return successive statements.
+  ExtractTableNamesFromNextStatementRequest request;
+  request.mutable_registered_parse_resume_location()->set_registered_id(id);
+
+  ExtractTableNamesFromNextStatementResponse response;
+  ZETASQL_ASSERT_OK(ExtractTableNamesFromNextStatement(request, &response));
+  ExtractTableNamesFromNextStatementResponse expectedResponse;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(
+      R"pb(table_name {
+             table_name_segment: "foo"
+             table_name_segment: "bar"
+           }
+           resume_byte_position: 29)pb",
+      &expectedResponse));
+  EXPECT_THAT(response, EqualsProto(expectedResponse));
+
+  ExtractTableNamesFromNextStatementResponse response2;
+  ZETASQL_ASSERT_OK(ExtractTableNamesFromNextStatement(request, &response2));
+  ExtractTableNamesFromNextStatementResponse expectedResponse2;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(
+      R"pb(table_name {
+             table_name_segment: "baz"
+           }
+           resume_byte_position: 49)pb",
+      &expectedResponse2));
+  EXPECT_THAT(response2, EqualsProto(expectedResponse2));
+
+  // An explicit byte position overrides the held one.
+  request.mutable_registered_parse_resume_location()->set_byte_position(0);
+  ExtractTableNamesFromNextStatementResponse response3;
+  ZETASQL_ASSERT_OK(ExtractTableNamesFromNextStatement(request, &response3));
+  EXPECT_THAT(response3, EqualsProto(expectedResponse));
+
+  ZETASQL_EXPECT_OK(UnregisterParseResumeLocation(id));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, ExtractTableNamesFromUnknownRegisteredId) {
+  ExtractTableNamesFromNextStatementRequest request;
+  request.mutable_registered_parse_resume_location()->set_registered_id(12345);
+
+  ExtractTableNamesFromNextStatementResponse response;
+  zetasql_base::Status status = ExtractTableNamesFromNextStatement(request, &response);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(
+      "generic::invalid_argument: "
+      "Registered parse resume location 12345 unknown.",
+      internal::StatusToString(status));
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, ExtractTableNamesWithNoSemicolon) {
   ExtractTableNamesFromNextStatementRequest request;
   ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(
@@ -765,6 +974,263 @@ TEST_F(ZetaSqlLocalServiceImplTest, Analyze) {
   EXPECT_EQ(40, response3.resume_byte_position());
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeWithSharedMemoryArena) {
+  // Create, size and map the arena file, as a same-host client would.
+  char arena_path[] = "/tmp/zetasql_arena_XXXXXX";
+  int fd = mkstemp(arena_path);
+  ASSERT_GE(fd, 0);
+  const int64_t kArenaSize = 1 << 20;
+  ASSERT_EQ(0, ftruncate(fd, kArenaSize));
+  void* arena_base = mmap(nullptr, kArenaSize, PROT_READ, MAP_SHARED, fd, 0);
+  ASSERT_NE(MAP_FAILED, arena_base);
+  close(fd);
+
+  AttachSharedMemoryArenaRequest attach_request;
+  attach_request.set_path(arena_path);
+  attach_request.set_size(kArenaSize);
+  RegisterResponse attach_response;
+  ZETASQL_ASSERT_OK(AttachSharedMemoryArena(attach_request, &attach_response));
+  const int64_t arena_id = attach_response.registered_id();
+
+  AnalyzeRequest request;
+  request.set_sql_statement("select 1;");
+  AnalyzeResponse inline_response;
+  ZETASQL_ASSERT_OK(Analyze(request, &inline_response));
+  ASSERT_TRUE(inline_response.has_resolved_statement());
+
+  // The same analysis through the arena hands the AST off as a block.
+  request.set_shared_memory_arena_id(arena_id);
+  AnalyzeResponse arena_response;
+  ZETASQL_ASSERT_OK(Analyze(request, &arena_response));
+  ASSERT_TRUE(arena_response.has_resolved_statement_block());
+  const SharedMemoryBlockProto& block =
+      arena_response.resolved_statement_block();
+
+  AnyResolvedStatementProto from_arena;
+  ASSERT_TRUE(from_arena.ParseFromArray(
+      static_cast<const char*>(arena_base) + block.offset(),
+      static_cast<int>(block.size())));
+  EXPECT_THAT(from_arena, EqualsProto(inline_response.resolved_statement()));
+
+  ZETASQL_ASSERT_OK(DetachSharedMemoryArena(arena_id));
+  munmap(arena_base, kArenaSize);
+  unlink(arena_path);
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeWrongSharedMemoryArenaId) {
+  AnalyzeRequest request;
+  request.set_sql_statement("select 1;");
+  request.set_shared_memory_arena_id(12345);
+
+  AnalyzeResponse response;
+  zetasql_base::Status status = Analyze(request, &response);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ("generic::invalid_argument: Shared memory arena 12345 unknown.",
+            internal::StatusToString(status));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AttachMissingSharedMemoryArenaFile) {
+  AttachSharedMemoryArenaRequest request;
+  request.set_path("/nonexistent/zetasql_arena");
+  request.set_size(1 << 20);
+
+  RegisterResponse response;
+  zetasql_base::Status status = AttachSharedMemoryArena(request, &response);
+  EXPECT_FALSE(status.ok());
+  EXPECT_TRUE(absl::StartsWith(
+      status.message(), "Cannot open shared memory arena file /nonexistent"))
+      << status;
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeRegisteredParseResumeLocation) {
+  const std::string catalog_proto_text = R"pb(
+    name: "foo"
+    table {
+      name: "bar"
+      serialization_id: 1
+      column {
+        name: "baz"
+        type { type_kind: TYPE_INT32 }
+        is_pseudo_column: false
+      }
+    })pb";
+
+  SimpleCatalogProto catalog;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(catalog_proto_text, &catalog));
+
+  ParseResumeLocationProto location;
+  location.set_input("select baz from bar;select baz from bar;");
+  RegisterResponse register_response;
+  ZETASQL_ASSERT_OK(RegisterParseResumeLocation(location, &register_response));
+  int64_t id = register_response.registered_id();
+
+  // The script was uploaded once at registration; each call carries only the
+  // handle and resumes from the position held by the server.
+  AnalyzeRequest request;
+  *request.mutable_simple_catalog() = catalog;
+  request.mutable_registered_parse_resume_location()->set_registered_id(id);
+
+  AnalyzeResponse response;
+  ZETASQL_EXPECT_OK(Analyze(request, &response));
+  EXPECT_EQ(20, response.resume_byte_position());
+
+  AnalyzeResponse response2;
+  ZETASQL_EXPECT_OK(Analyze(request, &response2));
+  EXPECT_EQ(40, response2.resume_byte_position());
+
+  ZETASQL_EXPECT_OK(UnregisterParseResumeLocation(id));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeSkipParseLocationRanges) {
+  const std::string catalog_proto_text = R"pb(
+    name: "foo"
+    table {
+      name: "bar"
+      serialization_id: 1
+      column {
+        name: "baz"
+        type { type_kind: TYPE_INT32 }
+        is_pseudo_column: false
+      }
+    })pb";
+
+  SimpleCatalogProto catalog;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(catalog_proto_text, &catalog));
+
+  AnalyzeRequest request;
+  *request.mutable_simple_catalog() = catalog;
+  request.mutable_options()->set_record_parse_locations(true);
+  request.set_sql_statement("select baz from bar;");
+
+  AnalyzeResponse response;
+  ZETASQL_EXPECT_OK(Analyze(request, &response));
+  EXPECT_TRUE(absl::StrContains(response.resolved_statement().DebugString(),
+                                "parse_location_range"));
+
+  request.mutable_serialization_options()->set_skip_parse_location_ranges(
+      true);
+  AnalyzeResponse stripped_response;
+  ZETASQL_EXPECT_OK(Analyze(request, &stripped_response));
+  EXPECT_FALSE(
+      absl::StrContains(stripped_response.resolved_statement().DebugString(),
+                        "parse_location_range"));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, RegisterCatalogDiff) {
+  const std::string catalog_proto_text = R"pb(
+    name: "foo"
+    table {
+      name: "bar"
+      serialization_id: 1
+      column {
+        name: "baz"
+        type { type_kind: TYPE_INT32 }
+        is_pseudo_column: false
+      }
+    })pb";
+
+  RegisterCatalogRequest register_request;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(
+      catalog_proto_text, register_request.mutable_simple_catalog()));
+  RegisterResponse register_response;
+  ZETASQL_EXPECT_OK(RegisterCatalog(register_request, &register_response));
+  int64_t base_id = register_response.registered_id();
+
+  RegisterCatalogDiffRequest diff_request;
+  diff_request.set_base_registered_catalog_id(base_id);
+  SimpleTableProto* new_table = diff_request.add_upserted_table();
+  new_table->set_name("qux");
+  new_table->set_serialization_id(2);
+  SimpleColumnProto* column = new_table->add_column();
+  column->set_name("c");
+  column->mutable_type()->set_type_kind(TYPE_INT64);
+  RegisterResponse diff_response;
+  ZETASQL_EXPECT_OK(RegisterCatalogDiff(diff_request, &diff_response));
+  int64_t diff_id = diff_response.registered_id();
+
+  // The overlay sees both the shared base table and the upserted one.
+  AnalyzeRequest analyze_request;
+  analyze_request.set_registered_catalog_id(diff_id);
+  analyze_request.set_sql_statement("select baz from bar;");
+  AnalyzeResponse analyze_response;
+  ZETASQL_EXPECT_OK(Analyze(analyze_request, &analyze_response));
+
+  analyze_request.set_sql_statement("select c from qux;");
+  ZETASQL_EXPECT_OK(Analyze(analyze_request, &analyze_response));
+
+  // The base catalog is unchanged and stays registered.
+  analyze_request.set_registered_catalog_id(base_id);
+  analyze_request.set_sql_statement("select c from qux;");
+  EXPECT_FALSE(Analyze(analyze_request, &analyze_response).ok());
+
+  // A removed table is no longer visible in the overlay.
+  RegisterCatalogDiffRequest removal_request;
+  removal_request.set_base_registered_catalog_id(base_id);
+  removal_request.add_removed_table_name("bar");
+  RegisterResponse removal_response;
+  ZETASQL_EXPECT_OK(RegisterCatalogDiff(removal_request, &removal_response));
+
+  analyze_request.set_registered_catalog_id(removal_response.registered_id());
+  analyze_request.set_sql_statement("select baz from bar;");
+  EXPECT_FALSE(Analyze(analyze_request, &analyze_response).ok());
+
+  ZETASQL_EXPECT_OK(UnregisterCatalog(diff_id));
+  ZETASQL_EXPECT_OK(UnregisterCatalog(removal_response.registered_id()));
+  ZETASQL_EXPECT_OK(UnregisterCatalog(base_id));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, RegisterCatalogDiffWrongBaseId) {
+  RegisterCatalogDiffRequest request;
+  request.set_base_registered_catalog_id(12345);
+  RegisterResponse response;
+  zetasql_base::Status status = RegisterCatalogDiff(request, &response);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ("generic::invalid_argument: Unknown catalog ID: 12345",
+            internal::StatusToString(status));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeBatch) {
+  const std::string catalog_proto_text = R"pb(
+    name: "foo"
+    table {
+      name: "bar"
+      serialization_id: 1
+      column {
+        name: "baz"
+        type { type_kind: TYPE_INT32 }
+        is_pseudo_column: false
+      }
+    })pb";
+
+  SimpleCatalogProto catalog;
+  ZETASQL_CHECK(google::protobuf::TextFormat::ParseFromString(catalog_proto_text, &catalog));
+
+  AnalyzeBatchRequest request;
+  *request.mutable_simple_catalog() = catalog;
+  request.add_sql_statement("select baz from bar;");
+  request.add_sql_statement("select baz as qux from bar;");
+  request.add_sql_statement("select 1;");
+
+  std::vector<AnalyzeResponse> responses;
+  ZETASQL_EXPECT_OK(AnalyzeBatch(request, &responses));
+  ASSERT_EQ(3, responses.size());
+  for (const AnalyzeResponse& response : responses) {
+    EXPECT_TRUE(response.has_resolved_statement());
+  }
+
+  // A failing statement aborts the batch; responses for the statements before
+  // it have already been delivered.
+  AnalyzeBatchRequest bad_request;
+  *bad_request.mutable_simple_catalog() = catalog;
+  bad_request.add_sql_statement("select baz from bar;");
+  bad_request.add_sql_statement("select oops from bar;");
+  bad_request.add_sql_statement("select 1;");
+
+  responses.clear();
+  EXPECT_FALSE(AnalyzeBatch(bad_request, &responses).ok());
+  EXPECT_EQ(1, responses.size());
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeExpression) {
   SimpleCatalogProto catalog;
 
@@ -1180,6 +1646,12 @@ TEST_F(ZetaSqlLocalServiceImplTest, GetBuiltinFunctions) {
   EXPECT_EQ(2, response.function_size());
   EXPECT_EQ(function1.DebugString(), response.function(0).DebugString());
   EXPECT_EQ(function2.DebugString(), response.function(1).DebugString());
+
+  // A repeated call with the same options is served from the cache and
+  // returns the same response.
+  GetBuiltinFunctionsResponse cached_response;
+  ASSERT_TRUE(GetBuiltinFunctions(proto, &cached_response).ok());
+  EXPECT_EQ(response.DebugString(), cached_response.DebugString());
 }
 
 }  // namespace local_service
@@ -18,6 +18,7 @@
 #define ZETASQL_LOCAL_SERVICE_STATE_H_
 
 #include <stddef.h>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <type_traits>
@@ -34,6 +35,11 @@ class GenericState;
 
 // Pool of saved states that can be shared by multiple statements.
 // The state class T must extend GenericState and must be thread safe.
+//
+// The id map is sharded so that concurrent RPCs touching different states
+// contend on different mutexes. Ids are assigned from a shared atomic
+// counter and map to shards round-robin, so a mixed Register/Get/Delete
+// workload spreads across all shards instead of serializing on one lock.
 template<class T>
 class SharedStatePool {
  public:
@@ -48,25 +54,29 @@ class SharedStatePool {
       return -1;
     }
 
-    absl::MutexLock lock(&mutex_);
-    int64_t id = next_id_++;
+    int64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
     if (!state->SetId(id)) {
       return -1;
     }
-    saved_states_[id].reset(state);
+    Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    shard.saved_states[id].reset(state);
     return id;
   }
 
   bool Has(int64_t id) const {
-    absl::MutexLock lock(&mutex_);
-    return zetasql_base::ContainsKey(saved_states_, id);
+    const Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    return zetasql_base::ContainsKey(shard.saved_states, id);
   }
 
   // Get a state object with given id, ownership is shared by the pool and all
   // threads that currently hold the state object.
   std::shared_ptr<T> Get(int64_t id) {
-    absl::MutexLock lock(&mutex_);
-    std::shared_ptr<T>* result = zetasql_base::FindOrNull(saved_states_, id);
+    Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    std::shared_ptr<T>* result =
+        zetasql_base::FindOrNull(shard.saved_states, id);
     if (result == nullptr) {
       return nullptr;
     } else {
@@ -77,23 +87,37 @@ class SharedStatePool {
   // Removes a state object from the pool. The state will be deleted immediately
   // if not held by any other threads, or after all threads releasing it.
   bool Delete(int64_t id) {
-    absl::MutexLock lock(&mutex_);
-    if (!zetasql_base::ContainsKey(saved_states_, id)) {
+    Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    if (!zetasql_base::ContainsKey(shard.saved_states, id)) {
       return false;
     }
-    saved_states_.erase(id);
+    shard.saved_states.erase(id);
     return true;
   }
 
   size_t NumSavedStates() {
-    absl::MutexLock lock(&mutex_);
-    return saved_states_.size();
+    size_t num_states = 0;
+    for (const Shard& shard : shards_) {
+      absl::MutexLock lock(&shard.mutex);
+      num_states += shard.saved_states.size();
+    }
+    return num_states;
   }
 
  private:
-  mutable absl::Mutex mutex_;
-  int64_t next_id_ GUARDED_BY(mutex_);
-  std::map<int64_t, std::shared_ptr<T>> saved_states_ GUARDED_BY(mutex_);
+  static constexpr int kNumShards = 16;
+
+  struct Shard {
+    mutable absl::Mutex mutex;
+    std::map<int64_t, std::shared_ptr<T>> saved_states GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(int64_t id) { return shards_[id % kNumShards]; }
+  const Shard& GetShard(int64_t id) const { return shards_[id % kNumShards]; }
+
+  std::atomic<int64_t> next_id_;
+  Shard shards_[kNumShards];
 
   static_assert(
       std::is_base_of<GenericState, T>::value,
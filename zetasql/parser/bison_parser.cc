@@ -330,9 +330,11 @@ zetasql_base::Status BisonParser::Parse(
     std::unique_ptr<ASTNode>* output,
     std::vector<std::unique_ptr<ASTNode>>* other_allocated_ast_nodes,
     ASTNodeKind* next_statement_kind_result, bool* next_statement_is_ctas,
-    int* statement_end_byte_offset) {
+    int* statement_end_byte_offset, bool minimal_syntax_errors) {
   id_string_pool_ = id_string_pool;
   arena_ = arena;
+  // Interned IdStrings are owned by the pool of the current parse.
+  id_string_intern_map_.clear();
   allocated_ast_nodes_ =
       absl::make_unique<std::vector<std::unique_ptr<ASTNode>>>();
   auto clean_up_allocated_ast_nodes =
@@ -346,6 +348,12 @@ zetasql_base::Status BisonParser::Parse(
   input_ = input;
   tokenizer_ = absl::make_unique<ZetaSqlFlexTokenizer>(
       mode, filename_.ToStringView(), input_, start_byte_offset);
+  if (mode != BisonParserMode::kNextStatementKind) {
+    // Lex ahead in chunks so the parser's inner loop consumes tokens from a
+    // flat buffer. kNextStatementKind only looks at the first few tokens, so
+    // lexing ahead there would be wasted work.
+    tokenizer_->set_batch_size(64);
+  }
   ASTNode* output_node = nullptr;
   std::string error_message;
   ParseLocationPoint error_location;
@@ -361,11 +369,21 @@ zetasql_base::Status BisonParser::Parse(
     if (mode != BisonParserMode::kNextStatementKind) {
       ZETASQL_RET_CHECK(output_node != nullptr);
 
-      // Make sure InitFields() is called for all ASTNodes that were created.
-      // We don't use the result of InitFields() in the grammar itself, so we
-      // don't need to do this during parsing.
-      for (const auto& ast_node : *allocated_ast_nodes_) {
-        ast_node->InitFields();
+      // Make sure InitFields() is called for all ASTNodes in the returned
+      // tree. We don't use the result of InitFields() in the grammar itself,
+      // so we don't need to do this during parsing. Nodes with trivial
+      // teardown are not individually tracked in 'allocated_ast_nodes_', so
+      // we walk the tree instead of the tracked-node list. InitFields() only
+      // consumes the node's own child list, so the visit order is irrelevant.
+      std::vector<ASTNode*> init_fields_stack;
+      init_fields_stack.push_back(output_node);
+      while (!init_fields_stack.empty()) {
+        ASTNode* node = init_fields_stack.back();
+        init_fields_stack.pop_back();
+        for (int i = 0; i < node->num_children(); ++i) {
+          init_fields_stack.push_back(node->mutable_child(i));
+        }
+        node->InitFields();
       }
 
       *output = nullptr;
@@ -377,6 +395,12 @@ zetasql_base::Status BisonParser::Parse(
           break;
         }
       }
+      if (*output == nullptr) {
+        // 'output_node' has trivial teardown and was not individually
+        // tracked. Its memory is owned by the arena; running the (no-op)
+        // destructor through the unique_ptr is harmless.
+        output->reset(output_node);
+      }
       ZETASQL_RET_CHECK_EQ(output->get(), output_node);
       *other_allocated_ast_nodes = std::move(*allocated_ast_nodes_);
     }
@@ -405,6 +429,12 @@ zetasql_base::Status BisonParser::Parse(
     // a simple "Unexpected X" error.
     if (absl::StartsWith(error_message, "syntax error, ") ||
         error_message.empty()) {
+      if (minimal_syntax_errors) {
+        // The caller only wants to know that (and where) parsing failed, so
+        // skip generating the improved message, which re-tokenizes the input
+        // from the start to describe the token at the error location.
+        return MakeSqlErrorAtPoint(error_location) << "Syntax error";
+      }
       // This was a Bison-generated syntax error. Generate a message that is to
       // our own liking.
       ZETASQL_ASSIGN_OR_RETURN(error_message, GenerateImprovedBisonSyntaxError(
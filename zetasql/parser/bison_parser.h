@@ -31,6 +31,7 @@
 #include "zetasql/parser/position.hh"
 #include "zetasql/public/id_string.h"
 #include "zetasql/public/parse_location.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "zetasql/base/status.h"
@@ -94,13 +95,19 @@ class BisonParser {
   // set to -1, and the input was guaranteed to be parsed to the end.
   //
   // If mode is kStatement, then 'statement_end_byte_offset' is not set.
+  //
+  // If 'minimal_syntax_errors' is true, Bison-generated syntax errors are
+  // returned as just "Syntax error" with the error location, skipping the
+  // re-tokenization of the input that describes the unexpected token and the
+  // expected alternatives. Hand-written errors from the grammar are constant
+  // strings and are returned as-is either way.
   zetasql_base::Status Parse(
       BisonParserMode mode, absl::string_view filename, absl::string_view input,
       int start_byte_offset, IdStringPool* id_string_pool, zetasql_base::UnsafeArena* arena,
       std::unique_ptr<zetasql::ASTNode>* output,
       std::vector<std::unique_ptr<ASTNode>>* other_allocated_ast_nodes,
       ASTNodeKind* next_statement_kind_result, bool* next_statement_is_ctas,
-      int* statement_end_byte_offset);
+      int* statement_end_byte_offset, bool minimal_syntax_errors = false);
 
   // Returns the characters in the input range given by 'bison_location'. The
   // returned characters will remain valid throughout Parse().
@@ -113,13 +120,18 @@ class BisonParser {
   }
 
   // Creates an ASTNode of type T with a unique id. Sets its location to
-  // the ZetaSQL location equivalent of 'bison_location'. Stores the returned
-  // pointer in allocated_ast_nodes_.
+  // the ZetaSQL location equivalent of 'bison_location'. If T requires
+  // destruction, stores the returned pointer in allocated_ast_nodes_;
+  // otherwise the node is simply dropped with the arena, making teardown of
+  // the tree O(1) in the number of such nodes.
   template <typename T>
   T* CreateASTNode(const zetasql_bison_parser::location& bison_location) {
     T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    result->SetArena(arena_);
     SetNodeLocation(bison_location, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    if (T::kOwnsHeapMemory) {
+      allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    }
     return result;
   }
 
@@ -131,8 +143,11 @@ class BisonParser {
       const zetasql_bison_parser::location& bison_location,
       absl::Span<ASTNode* const> children) {
     T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    result->SetArena(arena_);
     SetNodeLocation(bison_location, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    if (T::kOwnsHeapMemory) {
+      allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    }
     result->AddChildren(children);
     return result;
   }
@@ -146,8 +161,11 @@ class BisonParser {
       const zetasql_bison_parser::location& bison_location_end,
       absl::Span<ASTNode* const> children) {
     T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    result->SetArena(arena_);
     SetNodeLocation(bison_location_start, bison_location_end, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    if (T::kOwnsHeapMemory) {
+      allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    }
     result->AddChildren(children);
     return result;
   }
@@ -157,10 +175,24 @@ class BisonParser {
       const zetasql_bison_parser::location& location,
       absl::string_view name) {
     auto* identifier = CreateASTNode<ASTIdentifier>(location);
-    identifier->SetIdentifier(id_string_pool()->Make(name));
+    identifier->SetIdentifier(MakeIdString(name));
     return identifier;
   }
 
+  // Returns an IdString for 'name' allocated from the parse's IdStringPool,
+  // interning repeated spellings: the same identifier text occurring many
+  // times in one statement (e.g. repeated column prefixes in generated
+  // queries) shares a single allocation, and IdString equality between the
+  // occurrences hits the pointer-comparison fast path.
+  IdString MakeIdString(absl::string_view name) {
+    const auto it = id_string_intern_map_.find(name);
+    if (it != id_string_intern_map_.end()) return it->second;
+    const IdString result = id_string_pool()->Make(name);
+    // Key by the pool-owned copy, which lives as long as the map.
+    id_string_intern_map_.emplace(result.ToStringView(), result);
+    return result;
+  }
+
   // Sets the node location of 'node' to the ZetaSQL equivalent of
   // 'bison_location'.
   void SetNodeLocation(const zetasql_bison_parser::location& bison_location,
@@ -270,6 +302,11 @@ class BisonParser {
   // during Parse().
   absl::string_view input_;
 
+  // Interning map for MakeIdString. Keys are string_views into the IdString
+  // contents, which are owned by <id_string_pool_>. Only valid during
+  // Parse().
+  absl::flat_hash_map<absl::string_view, IdString> id_string_intern_map_;
+
   // 1-based position of the previous generated positional parameter.
   int previous_positional_parameter_position_ = 0;
 };
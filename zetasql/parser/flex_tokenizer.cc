@@ -39,6 +39,44 @@ zetasql_base::Status ZetaSqlFlexTokenizer::GetNextToken(
   return override_error_;
 }
 
+int ZetaSqlFlexTokenizer::GetNextTokenBatched(
+    zetasql_bison_parser::location* yylloc) {
+  buffered_tokens_.clear();
+  next_buffered_token_ = 0;
+  buffered_tokens_.reserve(batch_size_);
+
+  // Lex the first token of the batch directly into 'yylloc'; it is returned
+  // to the caller immediately.
+  const int first_token = GetNextTokenFlexImpl(yylloc);
+  prev_token_ = first_token;
+  if (first_token == 0 || !override_error_.ok() || force_terminate_) {
+    return first_token;
+  }
+
+  // Lex ahead. Errors found here belong to a token the parser has not seen
+  // yet, so they are deferred: 'override_error_' is restored and the error is
+  // stored on the buffered token instead.
+  zetasql_bison_parser::location location = *yylloc;
+  while (buffered_tokens_.size() < static_cast<size_t>(batch_size_) - 1) {
+    const int token = GetNextTokenFlexImpl(&location);
+    // The tokenizer rules are context sensitive on the previous token, so it
+    // must track the lexing frontier, not the parser's consumption point.
+    prev_token_ = token;
+    TokenWithLocation entry;
+    entry.token = token;
+    entry.location = location;
+    if (!override_error_.ok()) {
+      entry.deferred_error = override_error_;
+      override_error_ = ::zetasql_base::OkStatus();
+      buffered_tokens_.push_back(entry);
+      break;
+    }
+    buffered_tokens_.push_back(entry);
+    if (token == 0) break;
+  }
+  return first_token;
+}
+
 bool ZetaSqlFlexTokenizer::IsDotGeneralizedIdentifierPrefixToken(
     int bison_token) {
   if (bison_token ==
@@ -19,9 +19,11 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "zetasql/parser/position.hh"
 #include <cstdint>
+#include "absl/base/optimization.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
@@ -68,11 +70,35 @@ class ZetaSqlFlexTokenizer final : public ZetaSqlFlexTokenizerBase {
 
   // Returns the next token id, returning its location in 'yylloc'. On input,
   // 'yylloc' must be the location of the previous token that was returned.
+  // When batch mode is enabled (see set_batch_size), tokens are lexed ahead
+  // in chunks into a contiguous buffer and served from there, which keeps the
+  // per-token cost of the parser's inner loop down to an array read.
   int GetNextTokenFlex(zetasql_bison_parser::location* yylloc) {
+    if (next_buffered_token_ < buffered_tokens_.size() &&
+        ABSL_PREDICT_TRUE(!force_terminate_)) {
+      const TokenWithLocation& t = buffered_tokens_[next_buffered_token_++];
+      *yylloc = t.location;
+      if (!t.deferred_error.ok()) {
+        override_error_ = t.deferred_error;
+      }
+      prev_token_ = t.token;
+      return t.token;
+    }
+    if (batch_size_ > 1 && !force_terminate_) {
+      return GetNextTokenBatched(yylloc);
+    }
     prev_token_ = GetNextTokenFlexImpl(yylloc);
     return prev_token_;
   }
 
+  // Enables batch tokenization: GetNextTokenFlex will lex up to 'batch_size'
+  // tokens at a time into a flat buffer. A batch size of 1 (the default)
+  // lexes one token per call, as before. Lexing ahead is transparent to the
+  // parser: tokenizer errors found while buffering are attached to the token
+  // they were produced for and only surface when that token is consumed, and
+  // SetForceTerminate() discards any buffered tokens.
+  void set_batch_size(int batch_size) { batch_size_ = batch_size; }
+
   // This is the "nice" API for the tokenizer, to be used by GetParseTokens().
   // On input, 'location' must be the location of the previous token that was
   // generated. Returns the Bison token id in 'token' and the ZetaSQL location
@@ -106,6 +132,20 @@ class ZetaSqlFlexTokenizer final : public ZetaSqlFlexTokenizerBase {
   // Returns the next token id, returning its location in 'yylloc'.
   int GetNextTokenFlexImpl(zetasql_bison_parser::location* yylloc);
 
+  // A pre-lexed token, as stored in 'buffered_tokens_' by batch mode.
+  struct TokenWithLocation {
+    int token;
+    zetasql_bison_parser::location location;
+    // Error that the tokenizer produced when lexing this token, if any. It is
+    // kept out of 'override_error_' until the token is actually consumed so
+    // that lexing ahead does not mask earlier parser errors.
+    zetasql_base::Status deferred_error;
+  };
+
+  // Refills 'buffered_tokens_' with up to 'batch_size_' tokens and returns
+  // the first one, with its location in 'yylloc'.
+  int GetNextTokenBatched(zetasql_bison_parser::location* yylloc);
+
   // This is called by flex when it is wedged.
   void LexerError(const char* msg) override {
     override_error_ = MakeSqlError() << msg;
@@ -165,6 +205,14 @@ class ZetaSqlFlexTokenizer final : public ZetaSqlFlexTokenizerBase {
   // If this is set to true, the next token returned will be EOF, even if we're
   // not at the end of the input.
   bool force_terminate_ = false;
+
+  // Number of tokens that GetNextTokenFlex lexes ahead per refill. A value of
+  // 1 disables batching.
+  int batch_size_ = 1;
+
+  // Tokens lexed ahead by batch mode, and the index of the next one to serve.
+  std::vector<TokenWithLocation> buffered_tokens_;
+  size_t next_buffered_token_ = 0;
 };
 
 }  // namespace parser
@@ -16,11 +16,14 @@
 
 #include "zetasql/parser/keywords.h"
 
+#include <algorithm>
 #include <cctype>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "zetasql/base/logging.h"
 #include <cstdint>
@@ -41,105 +44,157 @@ namespace parser {
 
 namespace {
 
-// A case insensitive trie implementation. The ValueType is the type of value
-// stored inside the trie. The stored values are non-owned pointers to
-// ValueType. The case insensitivity is ASCII only. The maximum number of
-// prefixes that this can store is 64K.
+// A perfect (collision-free) hash table over a fixed, case insensitive
+// keyword set. The keyword set is known in full when the table is built, so
+// the construction uses hash-and-displace: keys are first partitioned into
+// buckets, and each bucket is assigned a displacement value such that all of
+// its keys land in distinct free slots of the final table. A successful
+// lookup therefore probes exactly one slot, and a miss is usually rejected by
+// the length pre-filter or an empty slot before any string comparison runs.
+// The case insensitivity is ASCII only.
 //
-// Benchmark results showed that the functions below are several times faster on
-// a hit than using dense_hash_map with a case insensitive hash function and
-// equality (140-180 ns versus 14 ns). The performance for a miss is about 7 ns
-// in the benchmark.
-template <typename ValueType>
-class CaseInsensitiveAsciiAlphaTrie {
+// This replaced a byte-at-a-time trie whose lookup cost grew with keyword
+// length; the hash computation touches each input byte once and the rest of
+// the lookup is two array reads plus at most one comparison.
+class KeywordHashTable {
  public:
-  CaseInsensitiveAsciiAlphaTrie() : nodes_(1, TrieNode()) {}
+  // Builds the table for 'keywords'. Crashes if there are duplicate keywords
+  // (ASCII case insensitively). The KeywordInfo objects must outlive the
+  // table.
+  explicit KeywordHashTable(std::vector<const KeywordInfo*> keywords) {
+    CHECK(!keywords.empty());
+    min_length_ = std::numeric_limits<size_t>::max();
+    for (const KeywordInfo* info : keywords) {
+      min_length_ = std::min(min_length_, info->keyword().size());
+      max_length_ = std::max(max_length_, info->keyword().size());
+    }
+
+    size_t num_buckets = 1;
+    while (num_buckets < keywords.size()) num_buckets *= 2;
+    bucket_mask_ = static_cast<uint32_t>(num_buckets - 1);
+    size_t num_slots = num_buckets * 2;
+    slot_mask_ = static_cast<uint32_t>(num_slots - 1);
+    displacements_.resize(num_buckets, 0);
+    slots_.resize(num_slots, nullptr);
+
+    // Partition the keys into buckets by hash.
+    std::vector<std::vector<const KeywordInfo*>> buckets(num_buckets);
+    for (const KeywordInfo* info : keywords) {
+      buckets[Hash(info->keyword()) & bucket_mask_].push_back(info);
+    }
 
-  // Inserts 'key' into the trie, with value 'value'. Crashes if a value for
-  // 'key' is already present.
-  void Insert(absl::string_view key, const ValueType* value) {
-    int node_index = 0;
-    for (int i = 0; i < key.size(); ++i) {
-      CHECK(isalpha(key[i]) || key[i] == '_') << key;
-      unsigned char c = absl::ascii_toupper(key[i]) - '0';
-      int next_node_index = nodes_[node_index].children[c];
-      if (next_node_index == 0) {
-        CHECK_LT(nodes_.size(), std::numeric_limits<uint16_t>::max());
-        next_node_index = nodes_.size();
-        nodes_[node_index].children[c] = next_node_index;
-        nodes_.emplace_back();
+    // Place large buckets first; they are the hardest to displace.
+    std::vector<int> bucket_order(num_buckets);
+    std::iota(bucket_order.begin(), bucket_order.end(), 0);
+    std::sort(bucket_order.begin(), bucket_order.end(), [&](int a, int b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<uint32_t> tentative_slots;
+    for (int bucket_index : bucket_order) {
+      const std::vector<const KeywordInfo*>& bucket = buckets[bucket_index];
+      if (bucket.empty()) continue;
+      bool placed = false;
+      for (uint32_t displacement = 0;
+           displacement <= std::numeric_limits<uint16_t>::max();
+           ++displacement) {
+        tentative_slots.clear();
+        bool ok = true;
+        for (const KeywordInfo* info : bucket) {
+          const uint32_t slot =
+              Displace(Hash(info->keyword()), displacement) & slot_mask_;
+          if (slots_[slot] != nullptr ||
+              std::find(tentative_slots.begin(), tentative_slots.end(),
+                        slot) != tentative_slots.end()) {
+            ok = false;
+            break;
+          }
+          tentative_slots.push_back(slot);
+        }
+        if (ok) {
+          for (size_t i = 0; i < bucket.size(); ++i) {
+            slots_[tentative_slots[i]] = bucket[i];
+          }
+          displacements_[bucket_index] = static_cast<uint16_t>(displacement);
+          placed = true;
+          break;
+        }
       }
-      node_index = next_node_index;
+      CHECK(placed) << "Could not build perfect hash for keyword set";
     }
-    CHECK(nodes_[node_index].value == nullptr) << "Duplicate key " << key;
-    nodes_[node_index].value = value;
   }
 
-  // Looks up 'key' in the trie. Returns nullptr for a non-match, or otherwise
-  // the matched key's value. 'key' must only contain alphanumeric ASCII
-  // characters or '_'.
-  const ValueType* Get(absl::string_view key) const {
-    int node_index = 0;
-    for (int i = 0; i < key.size(); ++i) {
-      unsigned char c = absl::ascii_toupper(key[i]) - '0';
-      if (c >= ABSL_ARRAYSIZE(nodes_[node_index].children)) return nullptr;
-      int next_node_index = nodes_[node_index].children[c];
-      if (next_node_index == 0) return nullptr;
-      node_index = next_node_index;
+  // Looks up 'key' in the table. Returns nullptr for a non-match, or
+  // otherwise the matched keyword's value.
+  const KeywordInfo* Get(absl::string_view key) const {
+    if (key.size() < min_length_ || key.size() > max_length_) return nullptr;
+    const uint32_t hash = Hash(key);
+    const uint32_t displacement = displacements_[hash & bucket_mask_];
+    const KeywordInfo* info = slots_[Displace(hash, displacement) & slot_mask_];
+    if (info == nullptr || !zetasql_base::CaseEqual(info->keyword(), key)) {
+      return nullptr;
     }
-    return nodes_[node_index].value;
+    return info;
   }
 
  private:
-  struct TrieNode {
-    // Child nodes for each supported byte value. Each value is an index into
-    // CaseInsensitiveAsciiAlphaTrie::nodes_. Value 0 means that the child
-    // is not present. The number of entries is enough to store all characters
-    // between '0' and '_' in ASCII. The entry at index i is for character
-    // '0' + i.
-    uint16_t children['_' - '0' + 1]{};
+  // FNV-1a over the uppercased bytes of 'key'.
+  static uint32_t Hash(absl::string_view key) {
+    uint32_t hash = 0x811c9dc5;
+    for (char c : key) {
+      hash ^= static_cast<uint8_t>(absl::ascii_toupper(c));
+      hash *= 0x01000193;
+    }
+    return hash;
+  }
 
-    // The stored value for this node, or NULL if this node is not in the trie.
-    ValueType* value = nullptr;
-  };
+  // Remixes 'hash' with a bucket displacement to produce a slot index.
+  static uint32_t Displace(uint32_t hash, uint32_t displacement) {
+    uint32_t mixed = hash ^ (displacement * 0x9e3779b9);
+    mixed ^= mixed >> 16;
+    mixed *= 0x85ebca6b;
+    mixed ^= mixed >> 13;
+    return mixed;
+  }
 
-  // All the nodes in the trie. Node with index 0 is the root.
-  std::vector<TrieNode> nodes_;
+  size_t min_length_ = 0;
+  size_t max_length_ = 0;
+  uint32_t bucket_mask_ = 0;
+  uint32_t slot_mask_ = 0;
+  std::vector<uint16_t> displacements_;
+  std::vector<const KeywordInfo*> slots_;
 };
 }  // namespace
 
-static std::unique_ptr<const CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>
-CreateReservedKeywordTrie() {
+static std::unique_ptr<const KeywordHashTable> CreateReservedKeywordTable() {
   const std::vector<KeywordInfo>& all_keywords = GetAllKeywords();
-  auto trie =
-      absl::make_unique<CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>();
+  std::vector<const KeywordInfo*> reserved_keywords;
   for (const KeywordInfo& keyword_info : all_keywords) {
     if (keyword_info.IsReserved()) {
-      trie->Insert(keyword_info.keyword(), &keyword_info);
+      reserved_keywords.push_back(&keyword_info);
     }
   }
-  return std::move(trie);
+  return absl::make_unique<KeywordHashTable>(std::move(reserved_keywords));
 }
 
 const KeywordInfo* GetReservedKeywordInfo(absl::string_view keyword) {
-  static const auto& trie = *CreateReservedKeywordTrie().release();
-  return trie.Get(keyword);
+  static const auto& table = *CreateReservedKeywordTable().release();
+  return table.Get(keyword);
 }
 
-std::unique_ptr<const CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>
-CreateKeywordTrie() {
+static std::unique_ptr<const KeywordHashTable> CreateKeywordTable() {
   const auto& all_keywords = GetAllKeywords();
-  auto trie =
-      absl::make_unique<CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>();
+  std::vector<const KeywordInfo*> keywords;
+  keywords.reserve(all_keywords.size());
   for (const auto& keyword_info : all_keywords) {
-    trie->Insert(keyword_info.keyword(), &keyword_info);
+    keywords.push_back(&keyword_info);
   }
-  return std::move(trie);
+  return absl::make_unique<KeywordHashTable>(std::move(keywords));
 }
 
 const KeywordInfo* GetKeywordInfo(absl::string_view keyword) {
-  static const auto& trie = *CreateKeywordTrie().release();
-  return trie.Get(keyword);
+  static const auto& table = *CreateKeywordTable().release();
+  return table.Get(keyword);
 }
 
 static std::unique_ptr<const std::unordered_map<int, const KeywordInfo*>>
@@ -395,10 +450,8 @@ const std::vector<KeywordInfo>& GetAllKeywords() {
   return keywords;
 }
 
-static std::unique_ptr<const CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>
-CreateKeywordInTokenizerTrie() {
-  auto trie =
-      absl::make_unique<CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>();
+static std::unique_ptr<const KeywordHashTable> CreateKeywordInTokenizerTable() {
+  std::vector<const KeywordInfo*> keywords;
   // These words are keywords in JavaCC, so we want to treat them as keywords in
   // the tokenizer API even though they are not always treated as keywords in
   // the Bison parser.
@@ -412,22 +465,20 @@ CreateKeywordInTokenizerTrie() {
            "current_timestamp_micros",
        }) {
     // We don't care about the KeywordInfo, but we have to create one because
-    // the trie needs a non-NULL value. We use an arbitrary bison token.
-    KeywordInfo* keyword_info = new KeywordInfo(keyword, KW_SELECT);
-    trie->Insert(keyword_info->keyword(), keyword_info);
+    // the table needs a non-NULL value. We use an arbitrary bison token.
+    keywords.push_back(new KeywordInfo(keyword, KW_SELECT));
   }
-  return std::move(trie);
+  return absl::make_unique<KeywordHashTable>(std::move(keywords));
 }
 
 bool IsKeywordInTokenizer(absl::string_view identifier) {
-  static const auto& trie = *CreateKeywordInTokenizerTrie().release();
-  return trie.Get(identifier) || GetKeywordInfo(identifier);
+  static const auto& table = *CreateKeywordInTokenizerTable().release();
+  return table.Get(identifier) || GetKeywordInfo(identifier);
 }
 
-static std::unique_ptr<const CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>
-CreateNonReservedIdentifiersThatMustBeBackquotedTrie() {
-  auto trie =
-      absl::make_unique<CaseInsensitiveAsciiAlphaTrie<const KeywordInfo>>();
+static std::unique_ptr<const KeywordHashTable>
+CreateNonReservedIdentifiersThatMustBeBackquotedTable() {
+  std::vector<const KeywordInfo*> keywords;
   // These non-reserved keywords are used in the grammar in a location where
   // identifiers also occur, and their meaning is different when they are
   // used without backquoting.
@@ -457,17 +508,16 @@ CreateNonReservedIdentifiersThatMustBeBackquotedTrie() {
            // mismatches when it is run.
        }) {
     // We don't care about the KeywordInfo, but we have to create one because
-    // the trie needs a non-NULL value. We use an arbitrary bison token.
-    KeywordInfo* keyword_info = new KeywordInfo(keyword, KW_SELECT);
-    trie->Insert(keyword_info->keyword(), keyword_info);
+    // the table needs a non-NULL value. We use an arbitrary bison token.
+    keywords.push_back(new KeywordInfo(keyword, KW_SELECT));
   }
-  return std::move(trie);
+  return absl::make_unique<KeywordHashTable>(std::move(keywords));
 }
 
 bool NonReservedIdentifierMustBeBackquoted(absl::string_view identifier) {
-  static const auto& trie =
-      *CreateNonReservedIdentifiersThatMustBeBackquotedTrie().release();
-  return trie.Get(identifier);
+  static const auto& table =
+      *CreateNonReservedIdentifiersThatMustBeBackquotedTable().release();
+  return table.Get(identifier);
 }
 
 }  // namespace parser
@@ -295,19 +295,41 @@ static const absl::flat_hash_map<ASTNodeKind, std::string>& GetNodeNamesMap() {
   return map;
 }
 
-ASTNode::~ASTNode() {}
+ASTNode::~ASTNode() {
+  if (children_ != inline_children_ && arena_ == nullptr) {
+    delete[] children_;
+  }
+}
+
+void ASTNode::GrowChildArray(int min_capacity) {
+  const int new_capacity = std::max(children_capacity_ * 2, min_capacity);
+  ASTNode** new_children =
+      arena_ != nullptr
+          ? static_cast<ASTNode**>(arena_->AllocAligned(
+                new_capacity * sizeof(ASTNode*),
+                zetasql_base::BaseArena::kDefaultAlignment))
+          : new ASTNode*[new_capacity];
+  std::copy(children_, children_ + num_children_, new_children);
+  if (children_ != inline_children_ && arena_ == nullptr) {
+    delete[] children_;
+  }
+  children_ = new_children;
+  children_capacity_ = new_capacity;
+}
 
 void ASTNode::AddChild(ASTNode* child) {
   DCHECK(child != nullptr);
-  children_.push_back(child);
+  if (num_children_ == children_capacity_) {
+    GrowChildArray(num_children_ + 1);
+  }
+  children_[num_children_++] = child;
   child->set_parent(this);
 }
 
 void ASTNode::AddChildren(absl::Span<ASTNode* const> children) {
   for (ASTNode* child : children) {
     if (child != nullptr) {
-      children_.push_back(child);
-      child->set_parent(this);
+      AddChild(child);
     }
   }
 }
@@ -348,7 +370,7 @@ void ASTNode::Accept(ParseTreeVisitor* visitor, void* data) const {
 }
 
 void ASTNode::ChildrenAccept(ParseTreeVisitor* visitor, void* data) const {
-  for (int i = 0; i < children_.size(); ++i) {
+  for (int i = 0; i < num_children_; ++i) {
     children_[i]->Accept(visitor, data);
   }
 }
@@ -394,7 +416,8 @@ void ASTNode::Dumper::Dump() {
     return;
   }
   ++current_depth_;
-  const auto& children = node_->children_;
+  const absl::Span<ASTNode* const> children(node_->children_,
+                                            node_->num_children_);
   for (ASTNode* n : children) {
     if (n != nullptr) {
       node_ = n;
@@ -133,14 +133,21 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
 
   // Access to child nodes with generic types.
   int num_children() const {
-    return children_.size();
+    return num_children_;
   }
   const ASTNode* child(int i) const { return children_[i]; }
   ASTNode* mutable_child(int i) { return children_[i]; }
 
+  // True if destroying a node of this static type may release owned heap
+  // memory. The parser skips destructor calls for arena-allocated nodes whose
+  // static type has trivial teardown, so that an entire parse tree is freed
+  // in O(1) when its arena is destroyed. Subclasses that own heap memory
+  // (e.g. a std::string member) must redefine this as true.
+  static constexpr bool kOwnsHeapMemory = false;
+
   // Returns the index of the first child of a node kind or -1 if not found.
   int find_child_index(ASTNodeKind kind) const {
-    for (int i = 0; i < children_.size(); i++) {
+    for (int i = 0; i < num_children_; i++) {
       if (children_[i]->node_kind_ == kind) {
         return i;
       }
@@ -460,14 +467,31 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
       const VisitResult& result, NonRecursiveParseTreeVisitor* visitor,
       std::stack<std::function<void()>>* stack);
 
+  // Called by the parser before any children are added, so that growth of the
+  // child array past the inline capacity is served from 'arena' instead of
+  // the heap. Arena-backed child arrays need no cleanup in the destructor.
+  void SetArena(zetasql_base::UnsafeArena* arena) { arena_ = arena; }
+
+  // Grows the child array to hold at least 'min_capacity' children.
+  void GrowChildArray(int min_capacity);
+
   ASTNodeKind node_kind_;
 
   ASTNode* parent_ = nullptr;
 
   ParseLocationRange parse_location_range_;
 
-  // Many nodes have one to two children, so InlinedVector saves allocations.
-  absl::InlinedVector<ASTNode*, 4> children_;
+  // Storage for child pointers. Many nodes have one to two children, so a
+  // small inline array saves allocations. If the list outgrows the inline
+  // capacity, the backing array is allocated from 'arena_' when one was
+  // attached via SetArena (the parser always attaches one), and from the heap
+  // otherwise.
+  static constexpr int kNumInlineChildren = 4;
+  ASTNode** children_ = inline_children_;
+  int num_children_ = 0;
+  int children_capacity_ = kNumInlineChildren;
+  zetasql_base::UnsafeArena* arena_ = nullptr;
+  ASTNode* inline_children_[kNumInlineChildren];
 };
 
 // This is a fake ASTNode implementation that exists only for tests,
@@ -2991,6 +3015,9 @@ class ASTLeaf : public ASTExpression {
                         image_, ")");
   }
 
+  // 'image_' owns heap memory, so leaf nodes cannot skip destruction.
+  static constexpr bool kOwnsHeapMemory = true;
+
   // image() references data with the same lifetime as this ASTLeaf object.
   absl::string_view image() const { return image_; }
   void set_image(std::string image) { image_ = std::move(image); }
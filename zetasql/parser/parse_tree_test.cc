@@ -157,6 +157,29 @@ static std::string CountNodeKinds(const std::vector<const ASTNode*>& nodes) {
   return ret;
 }
 
+TEST(ParseTreeTest, MinimalErrorMessageDetail) {
+  const std::string sql = "SELECT 1 1";
+  std::unique_ptr<ParserOutput> parser_output;
+
+  const zetasql_base::Status full_status =
+      ParseStatement(sql, ParserOptions(), &parser_output);
+  ASSERT_FALSE(full_status.ok());
+
+  ParserOptions minimal_options;
+  minimal_options.set_error_message_detail(
+      ParserOptions::ErrorMessageDetail::kMinimal);
+  const zetasql_base::Status minimal_status =
+      ParseStatement(sql, minimal_options, &parser_output);
+  ASSERT_FALSE(minimal_status.ok());
+
+  // The minimal message is generic, but the error location matches the one on
+  // the full message.
+  EXPECT_EQ("Syntax error", minimal_status.message());
+  EXPECT_NE("Syntax error", full_status.message());
+  EXPECT_EQ(internal::GetPayload<ErrorLocation>(full_status).DebugString(),
+            internal::GetPayload<ErrorLocation>(minimal_status).DebugString());
+}
+
 TEST(ParseTreeTest, NodeKindCategories_IfStatement) {
   const std::string sql = "if true then select 5; end if";
 
@@ -16,12 +16,16 @@
 
 #include "zetasql/parser/parser.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/parser/bison_parser.h"
 #include "zetasql/parser/bison_parser_mode.h"
+#include "zetasql/parser/flex_tokenizer.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_errors.h"
 #include "zetasql/parser/parse_tree_visitor.h"
@@ -42,6 +46,11 @@ namespace zetasql {
 using parser::BisonParserMode;
 using parser::BisonParser;
 
+static bool UseMinimalSyntaxErrors(const ParserOptions& parser_options) {
+  return parser_options.error_message_detail() ==
+         ParserOptions::ErrorMessageDetail::kMinimal;
+}
+
 ParserOptions::ParserOptions()
     : arena_(std::make_shared<zetasql_base::UnsafeArena>(/*block_size=*/4096)),
       id_string_pool_(std::make_shared<IdStringPool>(arena_)) {}
@@ -75,6 +84,63 @@ ParserOutput::ParserOutput(
 
 ParserOutput::~ParserOutput() {}
 
+// Holds one cached parse result. The statement text is stored here so that
+// the map key (a string_view into it) stays valid for the entry's lifetime.
+struct ParseStatementCache::Entry {
+  std::string statement_string;
+  std::shared_ptr<const ParserOutput> output;
+};
+
+ParseStatementCache::ParseStatementCache(int max_entries)
+    : max_entries_(max_entries) {
+  CHECK_GT(max_entries, 0);
+}
+
+ParseStatementCache::~ParseStatementCache() {}
+
+zetasql_base::Status ParseStatementCache::ParseStatement(
+    absl::string_view statement_string,
+    std::shared_ptr<const ParserOutput>* output) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = cache_map_.find(statement_string);
+    if (it != cache_map_.end()) {
+      // Move the entry to the front of the LRU list.
+      entries_.splice(entries_.begin(), entries_, it->second);
+      *output = it->second->output;
+      return ::zetasql_base::OkStatus();
+    }
+  }
+
+  // Parse outside the lock; concurrent misses on the same text may parse
+  // twice, but both produce equivalent trees and the last insert wins.
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_RETURN_IF_ERROR(
+      zetasql::ParseStatement(statement_string, ParserOptions(),
+                                &parser_output));
+  *output = std::move(parser_output);
+
+  absl::MutexLock lock(&mutex_);
+  Entry entry;
+  entry.statement_string = std::string(statement_string);
+  entry.output = *output;
+  entries_.push_front(std::move(entry));
+  auto insert_result = cache_map_.insert(
+      {absl::string_view(entries_.front().statement_string),
+       entries_.begin()});
+  if (!insert_result.second) {
+    // Another thread inserted the same statement concurrently; keep the
+    // existing entry and drop ours.
+    entries_.pop_front();
+    return ::zetasql_base::OkStatus();
+  }
+  if (static_cast<int>(entries_.size()) > max_entries_) {
+    cache_map_.erase(entries_.back().statement_string);
+    entries_.pop_back();
+  }
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ParseStatement(absl::string_view statement_string,
                             const ParserOptions& parser_options_in,
                             std::unique_ptr<ParserOutput>* output) {
@@ -95,7 +161,8 @@ zetasql_base::Status ParseStatement(absl::string_view statement_string,
       &ast_node, &other_allocated_ast_nodes,
       /*next_statement_kind_result=*/nullptr,
       /*next_statement_is_ctas=*/nullptr,
-      /*statement_end_byte_offset=*/nullptr);
+      /*statement_end_byte_offset=*/nullptr,
+      UseMinimalSyntaxErrors(parser_options));
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, statement_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
@@ -124,7 +191,8 @@ zetasql_base::Status ParseScript(absl::string_view script_string,
       &ast_node, &other_allocated_ast_nodes,
       /*next_statement_kind_result=*/nullptr,
       /*next_statement_is_ctas=*/nullptr,
-      /*statement_end_byte_offset=*/nullptr);
+      /*statement_end_byte_offset=*/nullptr,
+      UseMinimalSyntaxErrors(parser_options));
 
   std::unique_ptr<ASTScript> script;
   if (status.ok()) {
@@ -163,7 +231,8 @@ zetasql_base::Status ParseNextStatementInternal(ParseResumeLocation* resume_loca
       resume_location->byte_position(), parser_options.id_string_pool().get(),
       parser_options.arena().get(), &ast_node, &other_allocated_ast_nodes,
       nullptr /* next_statement_kind_result */,
-      nullptr /* next_statement_is_ctas */, &next_statement_byte_offset);
+      nullptr /* next_statement_is_ctas */, &next_statement_byte_offset,
+      UseMinimalSyntaxErrors(parser_options));
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, resume_location->input()));
 
@@ -205,6 +274,86 @@ zetasql_base::Status ParseNextStatement(ParseResumeLocation* resume_location,
                                     at_end_of_input);
 }
 
+zetasql_base::Status ParseAllStatements(
+    absl::string_view script_string, int max_threads,
+    std::vector<std::unique_ptr<ParserOutput>>* outputs) {
+  outputs->clear();
+
+  // Find the byte offsets where statements start with a plain tokenizer pass.
+  // The tokenizer understands strings and comments, so the split points are
+  // exactly the top-level semicolons. If the tokenizer hits an error, we stop
+  // scanning; the statement containing the error will then report it, with
+  // the proper error location, when it is parsed below.
+  std::vector<int> statement_starts;
+  {
+    ZetaSqlFlexTokenizer tokenizer(BisonParserMode::kTokenizer,
+                                     /*filename=*/absl::string_view(),
+                                     script_string, /*start_offset=*/0);
+    ParseLocationRange location;
+    bool pending_statement = true;
+    int pending_start = 0;
+    while (true) {
+      int token = 0;
+      if (!tokenizer.GetNextToken(&location, &token).ok() || token == 0) {
+        break;
+      }
+      if (pending_statement) {
+        // Only commit a statement start when a real token follows it, so that
+        // trailing whitespace or comments after the last semicolon do not
+        // produce a bogus empty statement.
+        statement_starts.push_back(pending_start);
+        pending_statement = false;
+      }
+      if (token == ';') {
+        pending_start = location.end().GetByteOffset();
+        pending_statement = true;
+      }
+    }
+  }
+
+  const int num_statements = static_cast<int>(statement_starts.size());
+  outputs->resize(num_statements);
+  std::vector<zetasql_base::Status> statuses(num_statements);
+
+  // Each worker claims statements through a shared counter and parses them
+  // with fresh per-statement arenas, which makes the statements fully
+  // independent.
+  std::atomic<int> next_statement_index{0};
+  const auto parse_claimed_statements = [&]() {
+    while (true) {
+      const int i = next_statement_index.fetch_add(1);
+      if (i >= num_statements) break;
+      ParseResumeLocation resume_location =
+          ParseResumeLocation::FromStringView(script_string);
+      resume_location.set_byte_position(statement_starts[i]);
+      bool at_end_of_input = false;
+      statuses[i] = ParseNextStatement(&resume_location, ParserOptions(),
+                                       &(*outputs)[i], &at_end_of_input);
+    }
+  };
+
+  const int num_threads =
+      std::max(1, std::min(max_threads, num_statements));
+  if (num_threads == 1) {
+    parse_claimed_statements();
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back(parse_claimed_statements);
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // Return the error for the earliest failing statement, if any.
+  for (const zetasql_base::Status& status : statuses) {
+    ZETASQL_RETURN_IF_ERROR(status);
+  }
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ParseType(absl::string_view type_string,
                        const ParserOptions& parser_options_in,
                        std::unique_ptr<ParserOutput>* output) {
@@ -220,7 +369,8 @@ zetasql_base::Status ParseType(absl::string_view type_string,
       parser_options.arena().get(), &ast_node, &other_allocated_ast_nodes,
       nullptr /* next_statement_kind_result */,
       nullptr /* next_statement_is_ctas */,
-      nullptr /* next_statement_byte_offset */);
+      nullptr /* next_statement_byte_offset */,
+      UseMinimalSyntaxErrors(parser_options));
   ZETASQL_RETURN_IF_ERROR(ConvertInternalErrorLocationToExternal(status, type_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
   ZETASQL_RET_CHECK(ast_node->IsType());
@@ -247,7 +397,8 @@ zetasql_base::Status ParseExpression(absl::string_view expression_string,
       parser_options.arena().get(), &ast_node, &other_allocated_ast_nodes,
       nullptr /* next_statement_kind_result */,
       nullptr /* next_statement_is_ctas */,
-      nullptr /* next_statement_byte_offset */);
+      nullptr /* next_statement_byte_offset */,
+      UseMinimalSyntaxErrors(parser_options));
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, expression_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
@@ -277,7 +428,8 @@ zetasql_base::Status ParseExpression(const ParseResumeLocation& resume_location,
       &ast_node, &other_allocated_ast_nodes,
       nullptr /* next_statement_kind_result */,
       nullptr /* next_statement_is_ctas */,
-      nullptr /* next_statement_byte_offset */);
+      nullptr /* next_statement_byte_offset */,
+      UseMinimalSyntaxErrors(parser_options));
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, resume_location.input()));
   ZETASQL_RET_CHECK(ast_node != nullptr);
@@ -311,7 +463,10 @@ ASTNodeKind ParseNextStatementKind(const ParseResumeLocation& resume_location,
       resume_location.input(), resume_location.byte_position(), &id_string_pool,
       &arena, nullptr /* result */, &other_allocated_ast_nodes,
       &next_statement_kind, next_statement_is_ctas,
-      nullptr /* next_statement_byte_offset */)
+      nullptr /* next_statement_byte_offset */,
+      // The error is ignored below, so don't spend time constructing a
+      // message for it.
+      /*minimal_syntax_errors=*/true)
       .IgnoreError();
   return next_statement_kind;
 }
@@ -17,6 +17,7 @@
 #ifndef ZETASQL_PARSER_PARSER_H_
 #define ZETASQL_PARSER_PARSER_H_
 
+#include <list>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,7 +26,10 @@
 #include "zetasql/base/arena.h"
 #include "zetasql/parser/ast_node_kind.h"
 #include "zetasql/public/options.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/status.h"
 
@@ -39,6 +43,10 @@ class ASTType;
 class IdStringPool;
 class ParseResumeLocation;
 
+namespace parser {
+class UnparserOutputSink;
+}  // namespace parser
+
 // ParserOptions contains options that affect parser behavior.
 class ParserOptions {
  public:
@@ -67,6 +75,26 @@ class ParserOptions {
   }
   std::shared_ptr<zetasql_base::UnsafeArena> arena() const { return arena_; }
 
+  // Controls how much detail is included in syntax error messages.
+  enum class ErrorMessageDetail {
+    // Describe the unexpected token and the set of expected tokens, e.g.
+    // 'Syntax error: Expected ")" or "," but got keyword AS'.
+    kFull,
+    // Return just "Syntax error" with the error location. Building the full
+    // message re-tokenizes the input to describe the token at the error
+    // location, which dominates the cost of a failed parse. Callers that
+    // parse frequently and only need to know whether (and where) the input
+    // failed to parse, such as interactive tools that parse on every
+    // keystroke, should use this.
+    kMinimal,
+  };
+  void set_error_message_detail(ErrorMessageDetail error_message_detail) {
+    error_message_detail_ = error_message_detail;
+  }
+  ErrorMessageDetail error_message_detail() const {
+    return error_message_detail_;
+  }
+
   // Creates a default-sized id_string_pool() and arena().
   // WARNING: After calling this, calling Parse functions concurrently with
   // the same ParserOptions is no longer allowed.
@@ -80,6 +108,8 @@ class ParserOptions {
   // Allocate all IdStrings in the parse tree in this pool.
   // The pool will also be referenced in ParserOutput to keep it alive.
   std::shared_ptr<IdStringPool> id_string_pool_;
+
+  ErrorMessageDetail error_message_detail_ = ErrorMessageDetail::kFull;
 };
 
 // Output of a parse operation. The output parse tree can be accessed via
@@ -135,6 +165,42 @@ class ParserOutput {
       node_;
 };
 
+// An opt-in LRU cache in front of ParseStatement, for workloads that re-parse
+// the same statement text repeatedly (e.g. parameterized statement shapes).
+// Entries are keyed by the statement text and hold shared immutable parse
+// trees; retaining an entry is cheap because a parse tree is just its arenas.
+// This class is thread-safe.
+//
+// Callers must not mutate the returned parse trees. The cache must outlive
+// none of the returned outputs: each returned shared_ptr keeps its entry's
+// tree (and arenas) alive independently of the cache.
+class ParseStatementCache {
+ public:
+  // 'max_entries' bounds the number of cached parse trees; the least recently
+  // used entry is evicted when the cache is full.
+  explicit ParseStatementCache(int max_entries);
+  ParseStatementCache(const ParseStatementCache&) = delete;
+  ParseStatementCache& operator=(const ParseStatementCache&) = delete;
+  ~ParseStatementCache();
+
+  // Returns the parse result for <statement_string> in <output>, parsing and
+  // caching it on a miss. Statements that fail to parse are not cached, and
+  // the error is returned as for ParseStatement.
+  zetasql_base::Status ParseStatement(absl::string_view statement_string,
+                              std::shared_ptr<const ParserOutput>* output);
+
+ private:
+  struct Entry;
+
+  const int max_entries_;
+  absl::Mutex mutex_;
+  // Most recently used entries are at the front of the list.
+  std::list<Entry> entries_ GUARDED_BY(mutex_);
+  // Keys point at the std::string stored in the Entry.
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> cache_map_
+      GUARDED_BY(mutex_);
+};
+
 // Parses <statement_string> and returns the parser output in <output> upon
 // success. The AST can be retrieved from output->statement().
 //
@@ -194,6 +260,27 @@ zetasql_base::Status ParseNextScriptStatement(ParseResumeLocation* resume_locati
                                       std::unique_ptr<ParserOutput>* output,
                                       bool* at_end_of_input);
 
+// Parses all statements in <script_string> and returns the outputs in
+// <outputs>, in statement order. Statements are separated by semicolons, like
+// for ParseNextStatement. Script statements are not supported.
+//
+// Statement boundaries are first located with a plain tokenizer pass (which
+// understands strings and comments), and the statements are then parsed
+// independently on up to <max_threads> threads. This is much faster than a
+// serial ParseNextStatement loop for scripts with many statements, e.g.
+// schema dump files. A <max_threads> of 1 parses serially on the calling
+// thread.
+//
+// Each statement is parsed with its own IdStringPool and arena, owned by its
+// ParserOutput. On error, returns the error for the earliest failing
+// statement, and the contents of <outputs> are unspecified.
+//
+// This can return errors annotated with an ErrorLocation payload that
+// indicates the input location of an error.
+zetasql_base::Status ParseAllStatements(
+    absl::string_view script_string, int max_threads,
+    std::vector<std::unique_ptr<ParserOutput>>* outputs);
+
 // Parses <type_string> as a type name and returns the parser output in <output>
 // upon success. The AST can be retrieved from output->type().
 //
@@ -222,6 +309,11 @@ zetasql_base::Status ParseExpression(const ParseResumeLocation& resume_location,
 // Works for any AST node.
 std::string Unparse(const ASTNode* root);
 
+// Like the above, but streams the canonical SQL to 'sink' in chunks of
+// roughly one line each instead of materializing it in one std::string. See
+// parser::UnparserOutputSink in parser/unparser.h.
+void Unparse(const ASTNode* root, parser::UnparserOutputSink* sink);
+
 // Parse the first few keywords from <input> (ignoring whitespace, comments and
 // hints) to determine what kind of statement it is (if it is valid).
 //
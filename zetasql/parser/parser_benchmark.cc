@@ -0,0 +1,171 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for the parser and tokenizer over representative statement
+// shapes: short OLTP-style DML, wide SELECT lists, deeply nested expressions,
+// and multi-statement scripts. Run with e.g.:
+//   bazel run -c opt //zetasql/parser:parser_benchmark
+//
+// Each benchmark reports bytes/second; the tokenizer benchmark also reports a
+// tokens/second counter and the parser benchmarks a statements/second
+// counter, so both throughput regressions and per-token/per-statement cost
+// regressions are visible.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "zetasql/parser/bison_parser_mode.h"
+#include "zetasql/parser/flex_tokenizer.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_location.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "zetasql/base/allocation_stats.h"
+#include "zetasql/base/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace zetasql {
+namespace parser {
+namespace {
+
+// Short INSERT like an OLTP workload would issue.
+constexpr char kShortDml[] =
+    "INSERT INTO Orders (order_id, customer_id, amount, created) "
+    "VALUES (17, 42, 99.95, '2019-07-01')";
+
+// Returns a SELECT with 'num_columns' distinct columns, all sharing a prefix,
+// like machine-generated reporting queries.
+std::string MakeWideSelect(int num_columns) {
+  std::vector<std::string> columns;
+  columns.reserve(num_columns);
+  for (int i = 0; i < num_columns; ++i) {
+    columns.push_back(absl::StrCat("t.metric_column_", i));
+  }
+  return absl::StrCat("SELECT ", absl::StrJoin(columns, ", "),
+                      " FROM MyTable t WHERE t.metric_column_0 > 0");
+}
+
+// Returns an expression nested 'depth' levels deep.
+std::string MakeNestedExpression(int depth) {
+  std::string sql = "SELECT ";
+  for (int i = 0; i < depth; ++i) sql += "(1 + ";
+  sql += "0";
+  for (int i = 0; i < depth; ++i) sql += ")";
+  return sql;
+}
+
+// Returns a script of 'num_statements' short DDL/DML statements.
+std::string MakeScript(int num_statements) {
+  std::string script;
+  for (int i = 0; i < num_statements; ++i) {
+    absl::StrAppend(&script, "CREATE TABLE Table_", i,
+                    " (id INT64, name STRING, value DOUBLE);\n");
+  }
+  return script;
+}
+
+// Reports per-iteration allocation counters next to the timing numbers;
+// allocation count is an early-warning signal for latency regressions.
+void ReportAllocationsPerOp(benchmark::State& state,
+                            const zetasql_base::AllocationTotals& allocated) {
+  state.counters["allocs_per_op"] = benchmark::Counter(
+      allocated.allocations, benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes_per_op"] =
+      benchmark::Counter(allocated.bytes, benchmark::Counter::kAvgIterations);
+}
+
+void BenchmarkParseStatement(benchmark::State& state, const std::string& sql) {
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    std::unique_ptr<ParserOutput> output;
+    const zetasql_base::Status status =
+        ParseStatement(sql, ParserOptions(), &output);
+    ZETASQL_CHECK_OK(status);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * sql.size());
+  state.counters["statements_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+
+void BM_ParseShortDml(benchmark::State& state) {
+  BenchmarkParseStatement(state, kShortDml);
+}
+BENCHMARK(BM_ParseShortDml);
+
+void BM_ParseWideSelect(benchmark::State& state) {
+  BenchmarkParseStatement(state, MakeWideSelect(state.range(0)));
+}
+BENCHMARK(BM_ParseWideSelect)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_ParseNestedExpression(benchmark::State& state) {
+  BenchmarkParseStatement(state, MakeNestedExpression(state.range(0)));
+}
+BENCHMARK(BM_ParseNestedExpression)->Arg(8)->Arg(64);
+
+void BM_ParseScript(benchmark::State& state) {
+  const std::string script = MakeScript(state.range(0));
+  int64_t num_statements = 0;
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    ParseResumeLocation resume_location =
+        ParseResumeLocation::FromStringView(script);
+    bool at_end_of_input = false;
+    while (!at_end_of_input) {
+      std::unique_ptr<ParserOutput> output;
+      const zetasql_base::Status status = ParseNextStatement(
+          &resume_location, ParserOptions(), &output, &at_end_of_input);
+      ZETASQL_CHECK_OK(status);
+      ++num_statements;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * script.size());
+  state.counters["statements_per_second"] =
+      benchmark::Counter(num_statements, benchmark::Counter::kIsRate);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+BENCHMARK(BM_ParseScript)->Arg(10)->Arg(1000);
+
+void BM_Tokenize(benchmark::State& state) {
+  const std::string sql = MakeWideSelect(state.range(0));
+  int64_t num_tokens = 0;
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    ZetaSqlFlexTokenizer tokenizer(BisonParserMode::kTokenizer,
+                                     /*filename=*/absl::string_view(), sql,
+                                     /*start_offset=*/0);
+    ParseLocationRange location;
+    int token = -1;
+    while (token != 0) {
+      ZETASQL_CHECK_OK(tokenizer.GetNextToken(&location, &token));
+      ++num_tokens;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * sql.size());
+  state.counters["tokens_per_second"] =
+      benchmark::Counter(num_tokens, benchmark::Counter::kIsRate);
+  ReportAllocationsPerOp(state, tracking.delta());
+}
+BENCHMARK(BM_Tokenize)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace parser
+}  // namespace zetasql
+
+BENCHMARK_MAIN();
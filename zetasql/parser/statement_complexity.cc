@@ -0,0 +1,94 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/statement_complexity.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "zetasql/parser/ast_node_kind.h"
+#include "zetasql/parser/parse_tree.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+
+std::string StatementComplexity::DebugString() const {
+  return absl::StrCat("StatementComplexity(num_nodes=", num_nodes,
+                      ", max_depth=", max_depth,
+                      ", max_expression_depth=", max_expression_depth,
+                      ", num_joins=", num_joins,
+                      ", num_subqueries=", num_subqueries,
+                      ", num_function_calls=", num_function_calls, ")");
+}
+
+StatementComplexity EstimateStatementComplexity(const ASTNode* node) {
+  StatementComplexity complexity;
+  if (node == nullptr) return complexity;
+
+  int num_queries = 0;
+
+  struct StackEntry {
+    const ASTNode* node;
+    int depth;
+    // Number of uninterrupted expression ancestors, including this node if it
+    // is an expression; reset to zero by non-expression nodes so that e.g. a
+    // chain of nested subqueries does not count as expression depth.
+    int expression_depth;
+  };
+
+  // Iterative depth-first traversal; recursion here would defeat the point
+  // of estimating adversarially deep trees cheaply.
+  std::vector<StackEntry> stack;
+  stack.push_back({node, 1, node->IsExpression() ? 1 : 0});
+  while (!stack.empty()) {
+    const StackEntry entry = stack.back();
+    const ASTNode* current = entry.node;
+    stack.pop_back();
+
+    ++complexity.num_nodes;
+    complexity.max_depth = std::max(complexity.max_depth, entry.depth);
+    complexity.max_expression_depth =
+        std::max(complexity.max_expression_depth, entry.expression_depth);
+    switch (current->node_kind()) {
+      case AST_JOIN:
+        ++complexity.num_joins;
+        break;
+      case AST_QUERY:
+        ++num_queries;
+        break;
+      case AST_FUNCTION_CALL:
+      case AST_ANALYTIC_FUNCTION_CALL:
+        ++complexity.num_function_calls;
+        break;
+      default:
+        break;
+    }
+
+    for (int i = current->num_children() - 1; i >= 0; --i) {
+      const ASTNode* child = current->child(i);
+      stack.push_back({child, entry.depth + 1,
+                       child->IsExpression() ? entry.expression_depth + 1 : 0});
+    }
+  }
+
+  // Every ASTQuery beyond the outermost one is a subquery (WITH entries,
+  // set operation arms and expression subqueries included).
+  complexity.num_subqueries = std::max(0, num_queries - 1);
+  return complexity;
+}
+
+}  // namespace zetasql
@@ -0,0 +1,71 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PARSER_STATEMENT_COMPLEXITY_H_
+#define ZETASQL_PARSER_STATEMENT_COMPLEXITY_H_
+
+#include <string>
+
+namespace zetasql {
+
+class ASTNode;
+
+// A cheap upper-bound characterization of how expensive a statement will be
+// to analyze, computed from its parse tree alone. Callers that want to bound
+// per-request analysis cost (e.g. for admission control) can parse a
+// statement, estimate its complexity, and route heavy statements to a
+// dedicated pool instead of discovering their cost mid-analysis.
+//
+// These are structural counts, not a cost model: analysis cost also depends
+// on catalog contents and enabled features, but every known pathological
+// input class shows up as an outlier in at least one of these fields.
+struct StatementComplexity {
+  // Total number of parse tree nodes. Grows with statement size roughly like
+  // a token count and bounds the amount of per-node resolution work.
+  int num_nodes = 0;
+
+  // Maximum nesting depth of the parse tree. Deep trees make the resolver's
+  // recursive descent (and any recursive tree processing) expensive.
+  int max_depth = 0;
+
+  // Maximum number of consecutively nested expression nodes, e.g. from deep
+  // parenthesization or long operator chains. Unlike max_depth, this is not
+  // inflated by query structure around the expressions.
+  int max_expression_depth = 0;
+
+  // Number of JOIN nodes. Join-heavy statements dominate both analysis and
+  // execution planning cost.
+  int num_joins = 0;
+
+  // Number of query nodes beyond the outermost one: subqueries, including
+  // those introduced by WITH clauses, UNION arms and expression subqueries.
+  int num_subqueries = 0;
+
+  // Number of function calls (including aggregate and analytic calls), each
+  // of which pays for signature matching during resolution.
+  int num_function_calls = 0;
+
+  std::string DebugString() const;
+};
+
+// Computes the StatementComplexity of the parse tree rooted at 'node' in a
+// single pass. Iterative, so it is safe on adversarially deep trees. 'node'
+// is typically ParserOutput::statement(), but any parse tree node works.
+StatementComplexity EstimateStatementComplexity(const ASTNode* node);
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PARSER_STATEMENT_COMPLEXITY_H_
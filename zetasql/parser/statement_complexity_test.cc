@@ -0,0 +1,130 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/statement_complexity.h"
+
+#include <memory>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/parser/parser.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+namespace {
+
+// Parses 'sql' and returns the complexity of the resulting statement.
+StatementComplexity Estimate(const std::string& sql,
+                             std::unique_ptr<ParserOutput>* parser_output) {
+  ZETASQL_CHECK_OK(ParseStatement(sql, ParserOptions(), parser_output));
+  return EstimateStatementComplexity((*parser_output)->statement());
+}
+
+TEST(StatementComplexityTest, NullNode) {
+  const StatementComplexity complexity = EstimateStatementComplexity(nullptr);
+  EXPECT_EQ(0, complexity.num_nodes);
+  EXPECT_EQ(0, complexity.max_depth);
+}
+
+TEST(StatementComplexityTest, SimpleSelect) {
+  std::unique_ptr<ParserOutput> parser_output;
+  const StatementComplexity complexity =
+      Estimate("SELECT 1", &parser_output);
+  EXPECT_GT(complexity.num_nodes, 0);
+  EXPECT_GT(complexity.max_depth, 0);
+  EXPECT_EQ(0, complexity.num_joins);
+  EXPECT_EQ(0, complexity.num_subqueries);
+  EXPECT_EQ(0, complexity.num_function_calls);
+}
+
+TEST(StatementComplexityTest, CountsJoins) {
+  std::unique_ptr<ParserOutput> parser_output;
+  const StatementComplexity complexity = Estimate(
+      "SELECT * FROM a JOIN b ON a.x = b.x JOIN c ON b.y = c.y",
+      &parser_output);
+  EXPECT_EQ(2, complexity.num_joins);
+}
+
+TEST(StatementComplexityTest, CountsSubqueries) {
+  std::unique_ptr<ParserOutput> parser_output;
+  // One subquery in the FROM clause, one expression subquery, and one WITH
+  // entry; the outermost query does not count.
+  const StatementComplexity complexity = Estimate(
+      "WITH w AS (SELECT 1 AS x) "
+      "SELECT (SELECT MAX(x) FROM w) FROM (SELECT x FROM w)",
+      &parser_output);
+  EXPECT_EQ(3, complexity.num_subqueries);
+}
+
+TEST(StatementComplexityTest, CountsFunctionCalls) {
+  std::unique_ptr<ParserOutput> parser_output;
+  const StatementComplexity complexity = Estimate(
+      "SELECT f(g(1), 2), COUNT(*) OVER () FROM t", &parser_output);
+  EXPECT_EQ(3, complexity.num_function_calls);
+}
+
+TEST(StatementComplexityTest, ExpressionDepthTracksNesting) {
+  // A chain of unary operators produces proportionally deep expression
+  // nesting. (Parentheses do not: the parser records them as a flag on the
+  // inner expression rather than as nodes.)
+  const int kDepth = 100;
+  std::string sql = "SELECT ";
+  for (int i = 0; i < kDepth; ++i) sql.append("NOT ");
+  sql.append("true");
+
+  std::unique_ptr<ParserOutput> parser_output;
+  const StatementComplexity complexity = Estimate(sql, &parser_output);
+  EXPECT_GE(complexity.max_expression_depth, kDepth / 2);
+  EXPECT_GE(complexity.max_depth, complexity.max_expression_depth);
+
+  // A flat statement of similar size stays shallow.
+  std::unique_ptr<ParserOutput> flat_output;
+  std::string flat_sql = "SELECT 1";
+  for (int i = 0; i < kDepth; ++i) absl::StrAppend(&flat_sql, ", ", i);
+  const StatementComplexity flat_complexity = Estimate(flat_sql, &flat_output);
+  EXPECT_LT(flat_complexity.max_expression_depth, 10);
+}
+
+TEST(StatementComplexityTest, NumNodesGrowsWithStatementSize) {
+  std::unique_ptr<ParserOutput> small_output;
+  std::unique_ptr<ParserOutput> large_output;
+  const StatementComplexity small_complexity =
+      Estimate("SELECT 1", &small_output);
+
+  std::string large_sql = "SELECT 1";
+  for (int i = 0; i < 1000; ++i) absl::StrAppend(&large_sql, " + ", i);
+  const StatementComplexity large_complexity =
+      Estimate(large_sql, &large_output);
+  EXPECT_GT(large_complexity.num_nodes, small_complexity.num_nodes + 1000);
+}
+
+TEST(StatementComplexityTest, DebugString) {
+  std::unique_ptr<ParserOutput> parser_output;
+  const StatementComplexity complexity =
+      Estimate("SELECT * FROM a JOIN b ON a.x = b.x", &parser_output);
+  EXPECT_EQ(absl::StrCat("StatementComplexity(num_nodes=",
+                         complexity.num_nodes,
+                         ", max_depth=", complexity.max_depth,
+                         ", max_expression_depth=",
+                         complexity.max_expression_depth,
+                         ", num_joins=1, num_subqueries=0",
+                         ", num_function_calls=0)"),
+            complexity.DebugString());
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -38,6 +38,12 @@ std::string Unparse(const ASTNode* node) {
   return unparsed_;
 }
 
+void Unparse(const ASTNode* node, parser::UnparserOutputSink* sink) {
+  parser::Unparser unparser(sink);
+  node->Accept(&unparser, nullptr);
+  unparser.FlushLine();
+}
+
 namespace parser {
 
 // Formatter ---------------------------------------------------------
@@ -141,10 +147,12 @@ bool Formatter::LastTokenIsSeparator() {
 }
 
 void Formatter::FlushLine() {
-  if ((unparsed_->empty() || unparsed_->back() == '\n') && buffer_.empty()) {
+  if (at_start_of_line_ && buffer_.empty()) {
     return;
   }
-  absl::StrAppend(unparsed_, buffer_, "\n");
+  buffer_.push_back('\n');
+  sink_->Append(buffer_);
+  at_start_of_line_ = true;
   buffer_.clear();
 }
 
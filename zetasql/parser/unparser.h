@@ -17,17 +17,46 @@
 #ifndef ZETASQL_PARSER_UNPARSER_H_
 #define ZETASQL_PARSER_UNPARSER_H_
 
+#include <memory>
 #include <string>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_visitor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 
 namespace zetasql {
 namespace parser {
 
+// Output sink for the Formatter/Unparser. Receives the formatted output in
+// chunks (roughly one line at a time), so large scripts can be streamed to a
+// file or an RPC stream without materializing the whole result in one buffer.
+class UnparserOutputSink {
+ public:
+  virtual ~UnparserOutputSink() {}
+
+  // Appends 'chunk' to the output. 'chunk' is only valid for the duration of
+  // the call.
+  virtual void Append(absl::string_view chunk) = 0;
+};
+
+// UnparserOutputSink that appends to a std::string, for callers that want the
+// whole output in memory.
+class StringUnparserOutputSink : public UnparserOutputSink {
+ public:
+  explicit StringUnparserOutputSink(std::string* unparsed)
+      : unparsed_(unparsed) {}
+
+  void Append(absl::string_view chunk) override {
+    absl::StrAppend(unparsed_, chunk);
+  }
+
+ private:
+  std::string* unparsed_;  // Not owned.
+};
+
 class Formatter {
  public:
   // Use it as a scoped object. It will indent and dedent automatically in the
@@ -54,7 +83,17 @@ class Formatter {
     Formatter* formatter_;
   };
 
-  explicit Formatter(std::string* unparsed) : unparsed_(unparsed) {}
+  explicit Formatter(std::string* unparsed)
+      : owned_string_sink_(new StringUnparserOutputSink(unparsed)),
+        sink_(owned_string_sink_.get()),
+        // Match the historical behavior for a pre-populated output std::string:
+        // an unterminated last line counts as an open line.
+        at_start_of_line_(unparsed->empty() || unparsed->back() == '\n') {}
+
+  // Streams the output to 'sink', which must outlive this object. One Append
+  // call is made per output line.
+  explicit Formatter(UnparserOutputSink* sink) : sink_(sink) {}
+
   Formatter(const Formatter&) = delete;
   Formatter& operator=(const Formatter&) = delete;
 
@@ -101,13 +140,27 @@ class Formatter {
   // in a variable since indentation_ is dynamically changing.
   int indentation_length_in_buffer_;
 
-  // Unparsed result, not owned.
-  std::string* unparsed_;
+  // Owned sink wrapping the output std::string when the std::string
+  // constructor is used.
+  std::unique_ptr<StringUnparserOutputSink> owned_string_sink_;
+
+  // Where flushed lines go. Not owned (points at owned_string_sink_ when the
+  // std::string constructor is used).
+  UnparserOutputSink* sink_;
+
+  // True if nothing was written yet or the last flushed chunk ended with a
+  // line break. Used by FlushLine() to avoid emitting empty lines.
+  bool at_start_of_line_ = true;
 };
 
 class Unparser : public ParseTreeVisitor {
  public:
   explicit Unparser(std::string* unparsed) : formatter_(unparsed) {}
+
+  // Streams the unparsed SQL to 'sink', one chunk per output line, instead of
+  // accumulating it in a std::string. 'sink' must outlive this object.
+  explicit Unparser(UnparserOutputSink* sink) : formatter_(sink) {}
+
   Unparser(const Unparser&) = delete;
   Unparser& operator=(const Unparser&) = delete;
   ~Unparser() override {}
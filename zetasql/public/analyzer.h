@@ -18,6 +18,7 @@
 #define ZETASQL_PUBLIC_ANALYZER_H_
 
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -27,12 +28,14 @@
 
 #include "zetasql/base/arena.h"
 #include "zetasql/base/atomic_sequence_num.h"
+#include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/proto/options.pb.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/id_string.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/options.pb.h"
+#include "zetasql/public/parse_location.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "absl/container/flat_hash_map.h"
@@ -55,6 +58,7 @@ class ResolvedExpr;
 class ResolvedLiteral;
 class ResolvedOption;
 class ResolvedStatement;
+class Resolver;
 
 // Performs a case-insensitive less-than vector<std::string> comparison, element
 // by element, using the C/POSIX locale for element comparisons. This function
@@ -453,6 +457,23 @@ class AnalyzerOptions {
     return record_parse_locations_;
   }
 
+  // Controls whether the resolved AST is validated after successful analysis.
+  // VALIDATE_SAMPLED keeps the validator's safety net on one in
+  // validation_sampling_rate() statements, counted process-wide across all
+  // AnalyzerOptions instances. Validation also remains subject to the
+  // --zetasql_validate_resolved_ast flag, which disables it entirely when
+  // false.
+  void set_validation_mode(ValidationMode mode) { validation_mode_ = mode; }
+  ValidationMode validation_mode() const { return validation_mode_; }
+
+  // In VALIDATE_SAMPLED mode, one in this many analyzed statements is
+  // validated. Must be at least 1.
+  void set_validation_sampling_rate(int rate) {
+    DCHECK_GE(rate, 1);
+    validation_sampling_rate_ = rate;
+  }
+  int validation_sampling_rate() const { return validation_sampling_rate_; }
+
   // Controls whether undeclared parameters are allowed. Undeclared parameters
   // don't appear in query_parameters(). Their type will be assigned by the
   // analyzer in the output AST and returned in
@@ -481,6 +502,45 @@ class AnalyzerOptions {
   void set_prune_unused_columns(bool value) { prune_unused_columns_ = value; }
   bool prune_unused_columns() const { return prune_unused_columns_; }
 
+  // If true, resolved AST nodes are allocated in arena() rather than as
+  // individual heap allocations, and their memory is released in bulk when
+  // the arena dies (AnalyzerOutput keeps the arena alive).  Node destructors
+  // still run, but destroying a large resolved AST does no per-node heap
+  // frees.  Requires arena() to be set (or defaulted) before analysis.
+  void set_allocate_resolved_ast_in_arena(bool value) {
+    allocate_resolved_ast_in_arena_ = value;
+  }
+  bool allocate_resolved_ast_in_arena() const {
+    return allocate_resolved_ast_in_arena_;
+  }
+
+  // If set, analysis fails with a resource-exhausted error shortly after this
+  // deadline passes. The deadline is checked at recursion boundaries in the
+  // resolver, so a pathological statement (e.g. deeply nested expressions)
+  // cannot consume unbounded CPU before failing. The check is amortized, so
+  // the error may be returned slightly after the deadline. This bounds the
+  // resolution phase only; parsing is not covered. Not preserved by
+  // Serialize()/Deserialize(). Default is no deadline.
+  void set_analysis_deadline(absl::Time deadline) {
+    analysis_deadline_ = deadline;
+  }
+  absl::Time analysis_deadline() const { return analysis_deadline_; }
+
+  // If set, analysis fails with a resource-exhausted error once the bytes
+  // allocated in arena() exceed this budget, instead of growing the arena
+  // until the process runs out of memory. The default id_string_pool()
+  // allocates in arena(), so IdStrings count against the budget; a caller-
+  // provided pool with its own arena does not. Like the analysis deadline,
+  // the budget is checked at resolver recursion boundaries, so it may be
+  // slightly exceeded before analysis fails, and parsing is not covered.
+  // Not preserved by Serialize()/Deserialize(). Default is no limit.
+  void set_max_analysis_memory_bytes(int64_t bytes) {
+    max_analysis_memory_bytes_ = bytes;
+  }
+  int64_t max_analysis_memory_bytes() const {
+    return max_analysis_memory_bytes_;
+  }
+
   void set_allowed_hints_and_options(const AllowedHintsAndOptions& allowed) {
     allowed_hints_and_options_ = allowed;
   }
@@ -527,6 +587,32 @@ class AnalyzerOptions {
   zetasql_base::Status AddSystemVariable(const std::vector<std::string>& name_path,
                                  const Type* type);
 
+  // Returns a 64-bit fingerprint of these options, usable as a cache key
+  // (e.g. for caching analysis artifacts keyed on the options they were
+  // produced under). Options that compare field-by-field equal produce the
+  // same fingerprint; different options produce different fingerprints
+  // modulo hash collisions. The value is deterministic across processes
+  // and builds.
+  //
+  // The fingerprint covers every option that affects analysis output and
+  // can be hashed deterministically: the language options (whose own
+  // fingerprint() is cached), declared parameters, expression columns,
+  // system variables, DDL pseudo-columns, allowed hints and options, and
+  // all scalar options. Types are fingerprinted by their DebugString().
+  //
+  // Not covered, because they cannot be hashed meaningfully: the
+  // expression-column and DDL pseudo-column callbacks (callers using
+  // callbacks must account for them in their cache keys separately),
+  // find_options(), column_id_sequence_number(), the arena and IdStringPool,
+  // and the analysis deadline and memory budget (which bound analysis cost
+  // but do not change its result).
+  //
+  // Unlike LanguageOptions::fingerprint(), this is recomputed on every
+  // call (mutable_language_options() and friends make staleness tracking
+  // unreliable here), so callers should compute it once per cache lookup
+  // rather than per comparison.
+  uint64_t fingerprint() const;
+
  private:
   // ======================================================================
   // NOTE: Please update options.proto and AnalyzerOptions.java accordingly
@@ -598,6 +684,11 @@ class AnalyzerOptions {
   // If set to true, record parse locations in ResolvedNodes.
   bool record_parse_locations_ = false;
 
+  // Controls post-analysis validation of the resolved AST.
+  // See set_validation_mode().
+  ValidationMode validation_mode_ = VALIDATE_FULL;
+  int validation_sampling_rate_ = 100;
+
   bool allow_undeclared_parameters_ = false;
 
   ParameterMode parameter_mode_ = PARAMETER_NAMED;
@@ -612,6 +703,18 @@ class AnalyzerOptions {
   // and then remove this option.
   bool prune_unused_columns_ = false;
 
+  // If true, resolved AST nodes are allocated in arena_ instead of
+  // individually on the heap.  See set_allocate_resolved_ast_in_arena().
+  bool allocate_resolved_ast_in_arena_ = false;
+
+  // Deadline for the resolution phase of analysis.  See
+  // set_analysis_deadline().  Default is no deadline.
+  absl::Time analysis_deadline_ = absl::InfiniteFuture();
+
+  // Budget for bytes allocated in arena_ during analysis.  See
+  // set_max_analysis_memory_bytes().  Default is no limit.
+  int64_t max_analysis_memory_bytes_ = std::numeric_limits<int64_t>::max();
+
   // This specifies the set of allowed hints and options, their expected
   // types, and whether to give errors on unrecognized names.
   // See the class definition for details.
@@ -773,6 +876,123 @@ zetasql_base::Status AnalyzeNextStatement(
     std::unique_ptr<const AnalyzerOutput>* output,
     bool* at_end_of_input);
 
+// An analyzer session amortizes per-statement setup cost when analyzing many
+// statements against the same Catalog with the same AnalyzerOptions.
+//
+// A session holds one long-lived Resolver — preserving its catalog lookup
+// memos and coercion caches across statements — plus a shared arena and
+// IdStringPool used for all statements.  Each AnalyzeNext() call behaves
+// like AnalyzeStatement() with the session's options and catalog.
+//
+// Because all statements share the session's arena and IdStringPool, memory
+// used for analysis is not released until the session and all returned
+// AnalyzerOutputs are destroyed, so sessions should be recycled periodically
+// in long-running processes.
+//
+// Sessions are not thread-safe, and the Catalog contents should not change
+// during the lifetime of a session.
+class AnalyzerSession {
+ public:
+  // Does not take ownership of <catalog> or <type_factory>, which must
+  // outlive this session and any AnalyzerOutputs it returns.  If <options>
+  // does not have an arena and IdStringPool set, default ones are created
+  // and shared by all statements analyzed in this session.
+  AnalyzerSession(const AnalyzerOptions& options, Catalog* catalog,
+                  TypeFactory* type_factory);
+  AnalyzerSession(const AnalyzerSession&) = delete;
+  AnalyzerSession& operator=(const AnalyzerSession&) = delete;
+  ~AnalyzerSession();
+
+  // Analyzes <sql> like AnalyzeStatement(), reusing the session's resolver
+  // state and arenas.
+  zetasql_base::Status AnalyzeNext(absl::string_view sql,
+                           std::unique_ptr<const AnalyzerOutput>* output);
+
+ private:
+  zetasql_base::Status AnalyzeNextImpl(absl::string_view sql,
+                               std::unique_ptr<const AnalyzerOutput>* output);
+
+  AnalyzerOptions options_;
+  Catalog* catalog_ = nullptr;           // Not owned.
+  TypeFactory* type_factory_ = nullptr;  // Not owned.
+  std::unique_ptr<Resolver> resolver_;
+};
+
+// Analyzes statements while caching resolved ASTs by statement shape.
+//
+// Two statements have the same shape if their text is identical after
+// replacing every literal token with a placeholder.  When a statement's
+// shape was analyzed before, the analyzer is skipped entirely: the cached
+// resolved AST is deep-copied and only the literal values are patched in.
+// This is much cheaper than re-analysis for workloads that run many
+// instances of a few statement shapes with different literal values.
+//
+// A statement is only cached when every literal token in it corresponds
+// one-to-one to resolved literals at the same parse location, which
+// guarantees that a literal's value could not have influenced resolution
+// anywhere else.  Statements where that does not hold (e.g. GROUP BY
+// ordinals, or array and struct constructors that fold several tokens into
+// one literal) fall back to full analysis on every call.  On a cache hit,
+// each new literal token is analyzed on its own and coerced to the cached
+// literal's type, so type checking and value validation (e.g. date format)
+// still apply; any patching failure also falls back to full analysis.
+//
+// Caveats: parse locations and deprecation warnings in a cache-hit output
+// refer to the text of the statement that produced the cache entry, whose
+// literals may have different lengths than the current statement's.  The
+// catalog is assumed to be stable for the lifetime of the cache.
+//
+// Not thread-safe.
+class StatementTemplateCache {
+ public:
+  // Does not take ownership of <catalog> or <type_factory>, which must
+  // outlive this cache and any AnalyzerOutputs it returns.  If <options>
+  // does not have an arena and IdStringPool set, default ones are created
+  // and shared by all statements analyzed through this cache.  Parse
+  // location recording is forced on, since literal patching depends on it.
+  StatementTemplateCache(const AnalyzerOptions& options, Catalog* catalog,
+                         TypeFactory* type_factory);
+  StatementTemplateCache(const StatementTemplateCache&) = delete;
+  StatementTemplateCache& operator=(const StatementTemplateCache&) = delete;
+  ~StatementTemplateCache();
+
+  // Analyzes <sql> like AnalyzeStatement(), serving statements whose shape
+  // was seen before by patching the cached resolved AST.  The output is
+  // returned as a shared_ptr because cache-miss outputs are retained as
+  // templates for later hits.
+  zetasql_base::Status AnalyzeStatement(
+      absl::string_view sql, std::shared_ptr<const AnalyzerOutput>* output);
+
+  // Number of statement shapes currently cached.
+  int cache_size() const { return templates_.size(); }
+
+  // Number of AnalyzeStatement() calls served by patching a cached AST.
+  int cache_hits() const { return cache_hits_; }
+
+ private:
+  struct StatementTemplate;
+
+  zetasql_base::Status AnalyzeStatementImpl(
+      absl::string_view sql, std::shared_ptr<const AnalyzerOutput>* output);
+
+  // Produces <output> by patching the current statement's literal values
+  // into a deep copy of <entry>'s resolved AST.  <literal_ranges> are the
+  // parse locations of the statement's literal tokens, in parse order.
+  // A failed status means the template could not be applied and the caller
+  // should fall back to full analysis.
+  zetasql_base::Status AnalyzeFromTemplate(
+      absl::string_view sql, const StatementTemplate& entry,
+      const std::vector<ParseLocationRange>& literal_ranges,
+      std::shared_ptr<const AnalyzerOutput>* output);
+
+  AnalyzerOptions options_;
+  Catalog* catalog_ = nullptr;           // Not owned.
+  TypeFactory* type_factory_ = nullptr;  // Not owned.
+  absl::flat_hash_map<std::string, std::unique_ptr<StatementTemplate>>
+      templates_;
+  int cache_hits_ = 0;
+};
+
 // Same as AnalyzeStatement(), but analyze from the parsed AST contained in a
 // ParserOutput instead of raw SQL std::string. For projects which are allowed to use
 // the parser directly, using this may save double parsing. If the
@@ -886,6 +1106,21 @@ zetasql_base::Status ExtractTableNamesFromNextStatement(
     ParseResumeLocation* resume_location, const AnalyzerOptions& options_in,
     TableNamesSet* table_names, bool* at_end_of_input);
 
+// Extracts the deduplicated set of table names referenced anywhere in <sql>,
+// a string of semicolon-separated statements, like calling
+// ExtractTableNamesFromNextStatement() in a loop and unioning the results.
+//
+// The statements are parsed and walked independently on up to <max_threads>
+// threads (see ParseAllStatements() in parser.h), so for long statement lists
+// this is much faster than the serial loop. It is intended for issuing one
+// batched catalog prefetch covering a whole script before analysis begins.
+// A <max_threads> of 1 extracts serially on the calling thread.
+//
+// On error, returns the error for the earliest failing statement.
+zetasql_base::Status ExtractTableNamesFromAllStatements(
+    absl::string_view sql, const AnalyzerOptions& options_in, int max_threads,
+    TableNamesSet* table_names);
+
 // Same as ExtractTableNamesFromStatement(), but extracts table names from the
 // parsed AST instead of a raw SQL std::string. For projects which are allowed to use
 // the parser directly, using this may save double parsing.
@@ -35,6 +35,8 @@
 #include "zetasql/public/value.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/base/case.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -125,6 +127,63 @@ void GetZetaSQLFunctions(TypeFactory* type_factory,
   }
 }
 
+namespace {
+
+// Holds one shared set of built-in functions along with the TypeFactory that
+// owns any types the function signatures reference.
+struct SharedBuiltinFunctionEntry {
+  TypeFactory type_factory;
+  NameToFunctionMap owned_functions;
+  std::map<std::string, const Function*> functions;
+};
+
+// Returns a key that uniquely identifies the set of functions produced by
+// GetZetaSQLFunctions for 'options'. LanguageOptions stores its features and
+// statement kinds in ordered sets, so its serialization is deterministic.
+std::string BuiltinFunctionOptionsKey(
+    const ZetaSQLBuiltinFunctionOptions& options) {
+  LanguageOptionsProto language_options_proto;
+  options.language_options.Serialize(&language_options_proto);
+  std::string key = language_options_proto.SerializeAsString();
+
+  std::set<FunctionSignatureId> include_ids(
+      options.include_function_ids.begin(), options.include_function_ids.end());
+  std::set<FunctionSignatureId> exclude_ids(
+      options.exclude_function_ids.begin(), options.exclude_function_ids.end());
+  absl::StrAppend(&key, "|include:");
+  for (FunctionSignatureId id : include_ids) {
+    absl::StrAppend(&key, id, ",");
+  }
+  absl::StrAppend(&key, "|exclude:");
+  for (FunctionSignatureId id : exclude_ids) {
+    absl::StrAppend(&key, id, ",");
+  }
+  return key;
+}
+
+}  // namespace
+
+const std::map<std::string, const Function*>& GetSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options) {
+  static absl::Mutex* mutex = new absl::Mutex;
+  static auto* entries =
+      new std::map<std::string, std::unique_ptr<SharedBuiltinFunctionEntry>>();
+
+  const std::string key = BuiltinFunctionOptionsKey(options);
+  absl::MutexLock l(mutex);
+  std::unique_ptr<SharedBuiltinFunctionEntry>& entry = (*entries)[key];
+  if (entry == nullptr) {
+    entry = absl::make_unique<SharedBuiltinFunctionEntry>();
+    GetZetaSQLFunctions(&entry->type_factory, options,
+                          &entry->owned_functions);
+    for (const auto& function_entry : entry->owned_functions) {
+      entry->functions.emplace(function_entry.first,
+                               function_entry.second.get());
+    }
+  }
+  return entry->functions;
+}
+
 bool FunctionMayHaveUnintendedArgumentCoercion(const Function* function) {
   if (function->NumSignatures() == 0 ||
       !function->ArgumentsAreCoercible()) {
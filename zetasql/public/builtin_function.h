@@ -48,6 +48,17 @@ void GetZetaSQLFunctions(
     TypeFactory* type_factory, const ZetaSQLBuiltinFunctionOptions& options,
     std::map<std::string, std::unique_ptr<Function>>* functions);
 
+// Returns a shared, immutable set of built-in ZetaSQL functions for
+// <options>. The set (and a TypeFactory backing any types it references) is
+// constructed on the first call for each distinct <options> and lives for the
+// lifetime of the process, so repeated catalog constructions with the same
+// options share one copy of the function objects instead of rebuilding them.
+//
+// The returned functions must not be mutated. Callers that need to own or
+// modify their functions should use GetZetaSQLFunctions() instead.
+const std::map<std::string, const Function*>& GetSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options);
+
 // If the function allows argument coercion, then checks the function
 // signatures to see if they are defined for floating point and
 // only one of signed/unsigned integer arguments (but not both integer
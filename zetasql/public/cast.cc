@@ -286,6 +286,205 @@ static zetasql_base::StatusOr<Value> NumericValueCast(const FromType& in) {
   }
 }
 
+// Bulk form of NumericCast for an array of primitive elements: converts the
+// underlying values in one tight loop with a single null check per element,
+// instead of re-entering CastValue (and re-dispatching on the type pair) for
+// every element.
+template <typename FromType, typename ToType>
+static zetasql_base::StatusOr<Value> NumericArrayCast(const Value& v,
+                                              const ArrayType* to_array_type) {
+  const Type* to_element_type = to_array_type->element_type();
+  std::vector<Value> casted_elements(v.num_elements());
+  zetasql_base::Status status;
+  for (int i = 0; i < v.num_elements(); ++i) {
+    const Value& element = v.element(i);
+    if (element.is_null()) {
+      casted_elements[i] = Value::Null(to_element_type);
+      continue;
+    }
+    ToType out;
+    functions::Convert<FromType, ToType>(element.Get<FromType>(), &out,
+                                         &status);
+    if (!status.ok()) return status;
+    casted_elements[i] = Value::Make<ToType>(out);
+  }
+  return InternalValue::ArrayChecked(to_array_type,
+                                     InternalValue::order_kind(v),
+                                     std::move(casted_elements));
+}
+
+// Fast paths for casting arrays of primitive numeric elements, dispatching on
+// the element type pair once per array. Returns false (leaving '*result'
+// untouched) for element type pairs without a bulk implementation; the caller
+// falls back to the generic element-by-element loop. The cast must already
+// have been validated as coercible.
+static bool TryNumericArrayCast(const Value& v, const ArrayType* to_array_type,
+                                zetasql_base::StatusOr<Value>* result) {
+  switch (FCT(v.type()->AsArray()->element_type()->kind(),
+              to_array_type->element_type()->kind())) {
+    case FCT(TYPE_INT32, TYPE_INT64):
+      *result = NumericArrayCast<int32_t, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_UINT32):
+      *result = NumericArrayCast<int32_t, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_UINT64):
+      *result = NumericArrayCast<int32_t, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_BOOL):
+      *result = NumericArrayCast<int32_t, bool>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_FLOAT):
+      *result = NumericArrayCast<int32_t, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_DOUBLE):
+      *result = NumericArrayCast<int32_t, double>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT32, TYPE_NUMERIC):
+      *result = NumericArrayCast<int32_t, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_UINT32, TYPE_INT32):
+      *result = NumericArrayCast<uint32_t, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_INT64):
+      *result = NumericArrayCast<uint32_t, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_UINT64):
+      *result = NumericArrayCast<uint32_t, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_BOOL):
+      *result = NumericArrayCast<uint32_t, bool>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_FLOAT):
+      *result = NumericArrayCast<uint32_t, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_DOUBLE):
+      *result = NumericArrayCast<uint32_t, double>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT32, TYPE_NUMERIC):
+      *result = NumericArrayCast<uint32_t, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_INT64, TYPE_INT32):
+      *result = NumericArrayCast<int64_t, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_UINT32):
+      *result = NumericArrayCast<int64_t, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_UINT64):
+      *result = NumericArrayCast<int64_t, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_BOOL):
+      *result = NumericArrayCast<int64_t, bool>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_FLOAT):
+      *result = NumericArrayCast<int64_t, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_DOUBLE):
+      *result = NumericArrayCast<int64_t, double>(v, to_array_type);
+      return true;
+    case FCT(TYPE_INT64, TYPE_NUMERIC):
+      *result = NumericArrayCast<int64_t, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_UINT64, TYPE_INT32):
+      *result = NumericArrayCast<uint64_t, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_INT64):
+      *result = NumericArrayCast<uint64_t, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_UINT32):
+      *result = NumericArrayCast<uint64_t, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_BOOL):
+      *result = NumericArrayCast<uint64_t, bool>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_FLOAT):
+      *result = NumericArrayCast<uint64_t, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_DOUBLE):
+      *result = NumericArrayCast<uint64_t, double>(v, to_array_type);
+      return true;
+    case FCT(TYPE_UINT64, TYPE_NUMERIC):
+      *result = NumericArrayCast<uint64_t, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_BOOL, TYPE_INT32):
+      *result = NumericArrayCast<bool, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_BOOL, TYPE_INT64):
+      *result = NumericArrayCast<bool, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_BOOL, TYPE_UINT32):
+      *result = NumericArrayCast<bool, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_BOOL, TYPE_UINT64):
+      *result = NumericArrayCast<bool, uint64_t>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_FLOAT, TYPE_INT32):
+      *result = NumericArrayCast<float, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_FLOAT, TYPE_INT64):
+      *result = NumericArrayCast<float, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_FLOAT, TYPE_UINT32):
+      *result = NumericArrayCast<float, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_FLOAT, TYPE_UINT64):
+      *result = NumericArrayCast<float, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_FLOAT, TYPE_DOUBLE):
+      *result = NumericArrayCast<float, double>(v, to_array_type);
+      return true;
+    case FCT(TYPE_FLOAT, TYPE_NUMERIC):
+      *result = NumericArrayCast<float, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_DOUBLE, TYPE_INT32):
+      *result = NumericArrayCast<double, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_DOUBLE, TYPE_INT64):
+      *result = NumericArrayCast<double, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_DOUBLE, TYPE_UINT32):
+      *result = NumericArrayCast<double, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_DOUBLE, TYPE_UINT64):
+      *result = NumericArrayCast<double, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_DOUBLE, TYPE_FLOAT):
+      *result = NumericArrayCast<double, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_DOUBLE, TYPE_NUMERIC):
+      *result = NumericArrayCast<double, NumericValue>(v, to_array_type);
+      return true;
+
+    case FCT(TYPE_NUMERIC, TYPE_INT32):
+      *result = NumericArrayCast<NumericValue, int32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_NUMERIC, TYPE_INT64):
+      *result = NumericArrayCast<NumericValue, int64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_NUMERIC, TYPE_UINT32):
+      *result = NumericArrayCast<NumericValue, uint32_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_NUMERIC, TYPE_UINT64):
+      *result = NumericArrayCast<NumericValue, uint64_t>(v, to_array_type);
+      return true;
+    case FCT(TYPE_NUMERIC, TYPE_FLOAT):
+      *result = NumericArrayCast<NumericValue, float>(v, to_array_type);
+      return true;
+    case FCT(TYPE_NUMERIC, TYPE_DOUBLE):
+      *result = NumericArrayCast<NumericValue, double>(v, to_array_type);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
 zetasql_base::Status CheckLegacyRanges(int64_t timestamp,
                                functions::TimestampScale precision,
                                const std::string& from_type_name,
@@ -777,6 +976,13 @@ zetasql_base::StatusOr<Value> CastValue(const Value& from_value,
                               << to_type->DebugString();
       }
 
+      // Arrays of primitive numeric elements are cast in bulk, dispatching on
+      // the element type pair once instead of once per element.
+      zetasql_base::StatusOr<Value> bulk_result;
+      if (TryNumericArrayCast(v, to_type->AsArray(), &bulk_result)) {
+        return bulk_result;
+      }
+
       const Type* to_element_type = to_type->AsArray()->element_type();
       std::vector<Value> casted_elements(v.num_elements());
       for (int i = 0; i < v.num_elements(); ++i) {
@@ -41,7 +41,7 @@ zetasql_base::Status Catalog::FindTable(
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return TableNotFoundError(path);
+      return NotFoundError("Table", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -49,7 +49,7 @@ zetasql_base::Status Catalog::FindTable(
   } else {
     ZETASQL_RETURN_IF_ERROR(GetTable(name, table, options));
     if (*table == nullptr) {
-      return TableNotFoundError(path);
+      return NotFoundError("Table", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -68,7 +68,7 @@ zetasql_base::Status Catalog::FindModel(const absl::Span<const std::string>& pat
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return ModelNotFoundError(path);
+      return NotFoundError("Model", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -76,7 +76,7 @@ zetasql_base::Status Catalog::FindModel(const absl::Span<const std::string>& pat
   } else {
     ZETASQL_RETURN_IF_ERROR(GetModel(name, model, options));
     if (*model == nullptr) {
-      return ModelNotFoundError(path);
+      return NotFoundError("Model", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -95,7 +95,7 @@ zetasql_base::Status Catalog::FindConnection(const absl::Span<const std::string>
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return ConnectionNotFoundError(path);
+      return NotFoundError("Connection", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -103,7 +103,7 @@ zetasql_base::Status Catalog::FindConnection(const absl::Span<const std::string>
   } else {
     ZETASQL_RETURN_IF_ERROR(GetConnection(name, connection, options));
     if (*connection == nullptr) {
-      return ConnectionNotFoundError(path);
+      return NotFoundError("Connection", path, options);
     }
     return zetasql_base::OkStatus();
   }
@@ -123,7 +123,7 @@ zetasql_base::Status Catalog::FindFunction(
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return FunctionNotFoundError(path);
+      return NotFoundError("Function", path, options);
     }
     const absl::Span<const std::string> path_suffix
       = path.subspan(1, path.size() - 1);
@@ -131,7 +131,7 @@ zetasql_base::Status Catalog::FindFunction(
   } else {
     ZETASQL_RETURN_IF_ERROR(GetFunction(name, function, options));
     if (*function == nullptr) {
-      return FunctionNotFoundError(path);
+      return NotFoundError("Function", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -151,7 +151,7 @@ zetasql_base::Status Catalog::FindTableValuedFunction(
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return TableValuedFunctionNotFoundError(path);
+      return NotFoundError("Table function", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -159,7 +159,7 @@ zetasql_base::Status Catalog::FindTableValuedFunction(
   } else {
     ZETASQL_RETURN_IF_ERROR(GetTableValuedFunction(name, function, options));
     if (*function == nullptr) {
-      return TableValuedFunctionNotFoundError(path);
+      return NotFoundError("Table function", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -178,7 +178,7 @@ zetasql_base::Status Catalog::FindProcedure(
     Catalog* catalog = nullptr;
     ZETASQL_RETURN_IF_ERROR(GetCatalog(name, &catalog, options));
     if (catalog == nullptr) {
-      return ProcedureNotFoundError(path);
+      return NotFoundError("Procedure", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -186,7 +186,7 @@ zetasql_base::Status Catalog::FindProcedure(
   } else {
     ZETASQL_RETURN_IF_ERROR(GetProcedure(name, procedure, options));
     if (*procedure == nullptr) {
-      return ProcedureNotFoundError(path);
+      return NotFoundError("Procedure", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -214,6 +214,8 @@ zetasql_base::Status Catalog::FindType(
         ZETASQL_RETURN_IF_ERROR(GetType(proto_name, type, options));
         if (*type != nullptr) {
           return ::zetasql_base::OkStatus();
+        } else if (options.speculative()) {
+          return NotFoundError("Type", path, options);
         } else {
           return ::zetasql_base::NotFoundErrorBuilder()
                  << "Type not found: " << ToIdentifierLiteral(proto_name)
@@ -221,7 +223,7 @@ zetasql_base::Status Catalog::FindType(
                  << " is not a nested catalog in catalog " << FullName();
         }
       }
-      return TypeNotFoundError(path);
+      return NotFoundError("Type", path, options);
     }
     const absl::Span<const std::string> path_suffix =
         path.subspan(1, path.size() - 1);
@@ -229,7 +231,7 @@ zetasql_base::Status Catalog::FindType(
   } else {
     ZETASQL_RETURN_IF_ERROR(GetType(name, type, options));
     if (*type == nullptr) {
-      return TypeNotFoundError(path);
+      return NotFoundError("Type", path, options);
     }
     return ::zetasql_base::OkStatus();
   }
@@ -242,7 +244,7 @@ zetasql_base::Status Catalog::FindConstant(const absl::Span<const std::string> p
   ZETASQL_RETURN_IF_ERROR(
       FindConstantWithPathPrefix(path, &num_names_consumed, constant, options));
   if (num_names_consumed < path.size()) {
-    return ConstantNotFoundError(path);
+    return NotFoundError("Constant", path, options);
   }
   return ::zetasql_base::OkStatus();
 }
@@ -268,7 +270,7 @@ zetasql_base::Status Catalog::FindConstantWithPathPrefix(
   // resolved constant or whatever other error occurred.
   return find_constant_with_path_prefix_status.code() ==
                  zetasql_base::StatusCode::kNotFound
-             ? ConstantNotFoundError(path)
+             ? NotFoundError("Constant", path, options)
              : find_constant_with_path_prefix_status;
 }
 
@@ -311,7 +313,7 @@ zetasql_base::Status Catalog::FindConstantWithPathPrefixImpl(
 
   // If no constant is found, reset <num_names_consumed> and return an error.
   *num_names_consumed = 0;
-  return ConstantNotFoundError(path);
+  return NotFoundError("Constant", path, options);
 }
 
 zetasql_base::Status Catalog::FindObject(absl::Span<const std::string> path,
@@ -469,6 +471,19 @@ zetasql_base::Status Catalog::GenericNotFoundError(
          << " not found in catalog " << FullName();
 }
 
+zetasql_base::Status Catalog::NotFoundError(const std::string& object_type,
+                                    absl::Span<const std::string> path,
+                                    const FindOptions& options) const {
+  if (options.speculative()) {
+    // The caller treats this error as control flow and never surfaces the
+    // message, so skip building the detailed message.  The static message
+    // is short enough that constructing and copying the Status does not
+    // allocate.
+    return zetasql_base::Status(zetasql_base::StatusCode::kNotFound, "Not found");
+  }
+  return GenericNotFoundError(object_type, path);
+}
+
 zetasql_base::Status Catalog::TableNotFoundError(absl::Span<const std::string> path)
     const {
   return GenericNotFoundError("Table", path);
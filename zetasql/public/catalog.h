@@ -128,6 +128,20 @@ class Catalog {
       return cycle_detector_;
     }
 
+    // Marks this lookup as speculative: the caller treats NOT_FOUND purely
+    // as control flow and never surfaces the error message to users.
+    // Catalogs may then return a NOT_FOUND Status with a cheap static
+    // message instead of building a detailed one naming the path and
+    // catalog.  The resolver sets this for lookups it probes as part of
+    // name resolution, where misses are the common case.
+    void set_speculative(bool speculative) {
+      speculative_ = speculative;
+    }
+
+    bool speculative() const {
+      return speculative_;
+    }
+
    private:
     // Possibly deadlines, Tasks for cancellation, etc.
 
@@ -136,6 +150,9 @@ class Catalog {
     // since Find*() calls may update the CycleDetector.
     // Not owned.
     CycleDetector* cycle_detector_ = nullptr;
+
+    // See set_speculative().
+    bool speculative_ = false;
   };
 
   // The FindX methods look up an object of type X from this Catalog on <path>.
@@ -368,6 +385,12 @@ class Catalog {
   // messages.
   zetasql_base::Status GenericNotFoundError(
       const std::string& object_type, absl::Span<const std::string> path) const;
+  // Like GenericNotFoundError, but skips building the detailed message for
+  // speculative lookups (see FindOptions::set_speculative), returning a
+  // NOT_FOUND Status with a cheap static message instead.
+  zetasql_base::Status NotFoundError(const std::string& object_type,
+                             absl::Span<const std::string> path,
+                             const FindOptions& options) const;
   // TODO: Remove these object-type specific functions, and have the
   // calling locations invoke the templatized version below instead.
   zetasql_base::Status TableNotFoundError(absl::Span<const std::string> path) const;
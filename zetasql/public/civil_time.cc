@@ -42,15 +42,31 @@ static const uint64_t kYearMask = 0x3FFFLL << kYearShift;  // 14 bits
 
 static constexpr int64_t kNanosPerSecond = 1000000000;
 
+// The validity checks below are on the hot path of every TIME/DATETIME
+// decode, so they fold the >= 0 check of each field into its upper-bound
+// check with an unsigned comparison and combine the fields with non-
+// short-circuiting '&', producing straight-line code without branches.
+
 inline bool IsValidNanoseconds(int64_t nanoseconds) {
-  return nanoseconds >= 0 && nanoseconds < kNanosPerSecond;
+  return static_cast<uint64_t>(nanoseconds) < kNanosPerSecond;
 }
 // A day is strictly 24 hours, an hour is 60 minutes and a minute is 60 seconds.
 // Leap seconds are not allowed.
 inline bool IsValidTimeFields(int64_t hour, int64_t minute, int64_t second,
                               int64_t nanosecond) {
-  return hour >= 0 && hour < 24 && minute >= 0 && minute < 60 && second >= 0 &&
-         second < 60 && IsValidNanoseconds(nanosecond);
+  return (static_cast<uint64_t>(hour) < 24) &
+         (static_cast<uint64_t>(minute) < 60) &
+         (static_cast<uint64_t>(second) < 60) &
+         IsValidNanoseconds(nanosecond);
+}
+
+// Number of days in each month of a non-leap year; index 0 is a 0-day
+// sentinel selected for out-of-range months so that the day check fails.
+static const int8_t kDaysInMonth[13] = {0,  31, 28, 31, 30, 31, 30,
+                                        31, 31, 30, 31, 30, 31};
+
+inline bool IsLeapYear(int64_t year) {
+  return (year % 4 == 0) & ((year % 100 != 0) | (year % 400 == 0));
 }
 
 // A day is strictly 24 hours, an hour is 60 minutes and a minute is 60 seconds.
@@ -58,11 +74,16 @@ inline bool IsValidTimeFields(int64_t hour, int64_t minute, int64_t second,
 inline bool IsValidDatetimeFields(int64_t year, int64_t month, int64_t day,
                                   int64_t hour, int64_t minute, int64_t second,
                                   int64_t nanosecond) {
-  // CivilDay helps to determine if the specified day is valid for the month,
-  // and in the case of February, the year.
-  const absl::CivilDay civil_day(year, month, day);
-  return year >= 1 && year <= 9999 && month >= 1 && month <= 12 && day >= 1 &&
-         day <= 31 && civil_day.day() == day &&
+  // The table lookup answers "is this day valid for the month (and, for
+  // February, the year)" without constructing an absl::CivilDay, which
+  // normalizes all the fields just to answer that range question.
+  const int64_t month_index =
+      static_cast<uint64_t>(month - 1) < 12 ? month : 0;
+  const int64_t days_in_month =
+      kDaysInMonth[month_index] + ((month_index == 2) & IsLeapYear(year));
+  return (static_cast<uint64_t>(year - 1) < 9999) & (month_index != 0) &
+         (static_cast<uint64_t>(day - 1) <
+          static_cast<uint64_t>(days_in_month)) &
          IsValidTimeFields(hour, minute, second, nanosecond);
 }
 
@@ -215,6 +236,22 @@ TimeValue TimeValue::FromPacked32SecondsAndMicros(int32_t bit_field_time_seconds
   return InternalFromPacked64SecondsAndNanos(bit_field, nanosecond);
 }
 
+TimeValue TimeValue::FromPacked32SecondsAndNanosUnchecked(
+    int32_t bit_field_time_seconds, int32_t nanosecond) {
+  const uint32_t bit_field = absl::bit_cast<uint32_t>(bit_field_time_seconds);
+  TimeValue ret;
+  ret.hour_ = static_cast<int8_t>(bit_field >> kHourShift);
+  ret.minute_ = static_cast<int8_t>((bit_field & kMinuteMask) >> kMinuteShift);
+  ret.second_ = static_cast<int8_t>(bit_field & kSecondMask);
+  ret.nanosecond_ = nanosecond;
+  ret.valid_ = true;
+  DCHECK(
+      IsValidTimeFields(ret.hour_, ret.minute_, ret.second_, ret.nanosecond_))
+      << "FromPacked32SecondsAndNanosUnchecked called with an unvalidated "
+      << "encoding: " << ret.DebugString();
+  return ret;
+}
+
 int32_t TimeValue::Packed32TimeSeconds() const {
   return (hour_ << kHourShift) |
          (minute_ << kMinuteShift) |
@@ -355,6 +392,26 @@ DatetimeValue DatetimeValue::FromPacked64SecondsAndNanos(
   return FromPacked64SecondsAndNanosInternal(bit_field, nanos64);
 }
 
+DatetimeValue DatetimeValue::FromPacked64SecondsAndNanosUnchecked(
+    int64_t bit_field_datetime_seconds, int32_t nanosecond) {
+  const uint64_t bit_field =
+      static_cast<uint64_t>(bit_field_datetime_seconds);
+  DatetimeValue ret;
+  ret.year_ = static_cast<int16_t>(bit_field >> kYearShift);
+  ret.month_ = static_cast<int8_t>((bit_field & kMonthMask) >> kMonthShift);
+  ret.day_ = static_cast<int8_t>((bit_field & kDayMask) >> kDayShift);
+  ret.hour_ = static_cast<int8_t>((bit_field & kHourMask) >> kHourShift);
+  ret.minute_ = static_cast<int8_t>((bit_field & kMinuteMask) >> kMinuteShift);
+  ret.second_ = static_cast<int8_t>(bit_field & kSecondMask);
+  ret.nanosecond_ = nanosecond;
+  ret.valid_ = true;
+  DCHECK(IsValidDatetimeFields(ret.year_, ret.month_, ret.day_, ret.hour_,
+                               ret.minute_, ret.second_, ret.nanosecond_))
+      << "FromPacked64SecondsAndNanosUnchecked called with an unvalidated "
+      << "encoding: " << ret.DebugString();
+  return ret;
+}
+
 DatetimeValue DatetimeValue::FromPacked64Micros(
     int64_t bit_field_datetime_micros) {
   uint64_t bit_field = static_cast<uint64_t>(bit_field_datetime_micros);
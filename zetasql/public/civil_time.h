@@ -171,6 +171,14 @@ class TimeValue {
   // Returns an invalid TimeValue if any time part is outside the valid range.
   static TimeValue FromPacked64Nanos(int64_t bit_field_time_nanos);
 
+  // Like FromPacked32SecondsAndNanos, but skips the per-field validation.
+  // The inputs must come from packing a TimeValue that was already validated
+  // (e.g. the encoding a Value stores internally); anything else produces a
+  // TimeValue with undefined time parts. Validity is DCHECKed in debug
+  // builds.
+  static TimeValue FromPacked32SecondsAndNanosUnchecked(
+      int32_t bit_field_time_seconds, int32_t nanosecond);
+
   // Return a debug std::string like:
   //   "03:04:05.123456789"
   // where trailing 000's in the sub-second part will be trimmed, and if
@@ -310,6 +318,14 @@ class DatetimeValue {
   static DatetimeValue FromPacked64SecondsAndNanos(
       int64_t bit_field_datetime_seconds, int32_t nanosecond);
 
+  // Like FromPacked64SecondsAndNanos, but skips the per-field validation.
+  // The inputs must come from packing a DatetimeValue that was already
+  // validated (e.g. the encoding a Value stores internally); anything else
+  // produces a DatetimeValue with undefined date and time parts. Validity is
+  // DCHECKed in debug builds.
+  static DatetimeValue FromPacked64SecondsAndNanosUnchecked(
+      int64_t bit_field_datetime_seconds, int32_t nanosecond);
+
   // It's impossible to encode all fields for Datetime with nano precision in a
   // single 8 byte integer, so there is no facotry function for building a
   // DatetimeValue from a single int64_t.
@@ -333,6 +333,60 @@ TEST(CivilTimeValuesTest, DatetimeEncodingDecodingTest) {
   }
 }
 
+TEST(CivilTimeValuesTest, UncheckedDecodingTest) {
+  // The unchecked decoders must agree with the checked ones on every
+  // already-validated encoding.
+  std::vector<TimeValue> time_cases = {
+      TimeValue(),                                      // 00:00:00
+      TimeValue::FromHMSAndMicros(23, 59, 59, 999999),  // 23:59:59.999999
+      TimeValue::FromHMSAndNanos(12, 34, 56, 123456789),
+  };
+  for (const auto& each : time_cases) {
+    ASSERT_TRUE(each.IsValid()) << each.DebugString();
+    TimeValue decoded = TimeValue::FromPacked32SecondsAndNanosUnchecked(
+        each.Packed32TimeSeconds(), each.Nanoseconds());
+    EXPECT_TRUE(decoded.IsValid());
+    EXPECT_EQ(each.DebugString(), decoded.DebugString());
+  }
+
+  std::vector<DatetimeValue> datetime_cases = {
+      DatetimeValue(),  // 1970-01-01 00:00:00
+      DatetimeValue::FromYMDHMSAndMicros(1, 1, 1, 0, 0, 0, 0),
+      DatetimeValue::FromYMDHMSAndMicros(9999, 12, 31, 23, 59, 59, 999999),
+      DatetimeValue::FromYMDHMSAndNanos(2016, 2, 29, 3, 4, 5, 123456789),
+  };
+  for (const auto& each : datetime_cases) {
+    ASSERT_TRUE(each.IsValid()) << each.DebugString();
+    DatetimeValue decoded =
+        DatetimeValue::FromPacked64SecondsAndNanosUnchecked(
+            each.Packed64DatetimeSeconds(), each.Nanoseconds());
+    EXPECT_TRUE(decoded.IsValid());
+    EXPECT_EQ(each.DebugString(), decoded.DebugString());
+  }
+}
+
+TEST(CivilTimeValuesTest, DayOfMonthValidation) {
+  // The last valid day of every month is accepted and the day after it is
+  // rejected, for a leap year, a non-leap year, and a century non-leap year.
+  static const int kDaysInMonthNonLeap[12] = {31, 28, 31, 30, 31, 30,
+                                              31, 31, 30, 31, 30, 31};
+  for (int year : {2015, 2016, 1900, 2000}) {
+    const bool leap_year = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    for (int month = 1; month <= 12; ++month) {
+      int last_day = kDaysInMonthNonLeap[month - 1];
+      if (month == 2 && leap_year) ++last_day;
+      EXPECT_TRUE(DatetimeValue::FromYMDHMSAndMicros(year, month, last_day, 0,
+                                                     0, 0, 0)
+                      .IsValid())
+          << year << "-" << month << "-" << last_day;
+      EXPECT_FALSE(DatetimeValue::FromYMDHMSAndMicros(year, month,
+                                                      last_day + 1, 0, 0, 0, 0)
+                       .IsValid())
+          << year << "-" << month << "-" << last_day + 1;
+    }
+  }
+}
+
 TEST(CivilTimeValuesTest, TimeValueNormalizationTest) {
   // The second member is the debug std::string for the normalized TimeValue.
   std::vector<std::pair<TimeValue, std::string>> test_cases = {
@@ -609,6 +609,33 @@ bool Coercer::ParameterCoercesTo(const Type* from_type, const Type* to_type,
 bool Coercer::TypeCoercesTo(const Type* from_type, const Type* to_type,
                             bool is_explicit,
                             SignatureMatchResult* result) const {
+  const std::tuple<const Type*, const Type*, bool> key(from_type, to_type,
+                                                       is_explicit);
+  const TypeCoercionVerdict* verdict =
+      zetasql_base::FindOrNull(type_coercion_verdicts_, key);
+  if (verdict == nullptr) {
+    TypeCoercionVerdict new_verdict;
+    SignatureMatchResult local_result;
+    new_verdict.coerces =
+        TypeCoercesToImpl(from_type, to_type, is_explicit, &local_result);
+    new_verdict.non_matched_arguments = local_result.non_matched_arguments();
+    new_verdict.non_literals_coerced = local_result.non_literals_coerced();
+    new_verdict.non_literals_distance = local_result.non_literals_distance();
+    verdict =
+        &type_coercion_verdicts_.emplace(key, new_verdict).first->second;
+  }
+  result->set_non_matched_arguments(result->non_matched_arguments() +
+                                    verdict->non_matched_arguments);
+  result->set_non_literals_coerced(result->non_literals_coerced() +
+                                   verdict->non_literals_coerced);
+  result->set_non_literals_distance(result->non_literals_distance() +
+                                    verdict->non_literals_distance);
+  return verdict->coerces;
+}
+
+bool Coercer::TypeCoercesToImpl(const Type* from_type, const Type* to_type,
+                                bool is_explicit,
+                                SignatureMatchResult* result) const {
   const CastFunctionProperty* property = zetasql_base::FindOrNull(
       GetZetaSQLCasts(), TypeKindPair(from_type->kind(), to_type->kind()));
   if (property == nullptr) {
@@ -17,6 +17,9 @@
 #ifndef ZETASQL_PUBLIC_COERCER_H_
 #define ZETASQL_PUBLIC_COERCER_H_
 
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/signature_match_result.h"
@@ -115,9 +118,16 @@ class Coercer {
   // either explicit or implicit coercion.  Does not consider if <from_type>
   // is a literal.  The <result> is updated appropriately to reflect
   // success or failure as described for CoercesTo().
+  //
+  // Verdicts are memoized in <type_coercion_verdicts_>; the full computation
+  // is in TypeCoercesToImpl().
   bool TypeCoercesTo(const Type* from_type, const Type* to_type,
                      bool is_explicit, SignatureMatchResult* result) const;
 
+  // Uncached implementation of TypeCoercesTo().
+  bool TypeCoercesToImpl(const Type* from_type, const Type* to_type,
+                         bool is_explicit, SignatureMatchResult* result) const;
+
   // Returns whether <struct_argument> can be coerced to <to_type>. We
   // consider <struct_argument> types individually to see whether they can be
   // coerced to <to_type> field types implicitly/explicitly. Field names are
@@ -186,12 +196,34 @@ class Coercer {
   // nested structs).
   void StripFieldAliasesFromStructType(const Type** struct_type) const;
 
+  // The SignatureMatchResult updates applied by one TypeCoercesTo() call,
+  // together with its verdict, so a memoized call can replay them.  Only the
+  // non-literal counters can be touched by TypeCoercesTo() (including its
+  // recursive struct and array field walks).
+  struct TypeCoercionVerdict {
+    bool coerces = false;
+    int non_matched_arguments = 0;
+    int non_literals_coerced = 0;
+    int non_literals_distance = 0;
+  };
+
   TypeFactory* type_factory_;  // Not owned.
 
   // Used for coercions between dates/strings and timestamps.  Not relevant
   // for other coercions.
   const absl::TimeZone default_timezone_;
   const LanguageOptions& language_options_;  // Not owned.
+
+  // Memo of TypeCoercesTo() verdicts keyed by (from-type, to-type,
+  // is_explicit).  Non-literal coercibility depends only on the types and the
+  // language options, which are fixed for the lifetime of a Coercer, so
+  // entries never need invalidation.  Without this, deeply nested struct
+  // types make TypeCoercesTo() recompute the same recursive field walks on
+  // every call.  Mutable because coercion checks are const.
+  mutable absl::flat_hash_map<std::tuple<const Type*, const Type*, bool>,
+                              TypeCoercionVerdict>
+      type_coercion_verdicts_;
+
   friend class CoercerTest;
 };
 
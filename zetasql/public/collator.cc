@@ -142,4 +142,30 @@ int64_t ZetaSqlCollator::CompareUtf8(const absl::string_view s1,
   return result;
 }
 
+void ZetaSqlCollator::GetSortKeyUtf8(absl::string_view s,
+                                       std::string* sort_key) const {
+  if (icu_collator_ == nullptr) {
+    // CompareUtf8() compares the strings as binary BLOBs, so the string is its
+    // own sort key.
+    sort_key->assign(s.data(), s.size());
+    return;
+  }
+
+  const icu::UnicodeString unicode_str = icu::UnicodeString::fromUTF8(
+      icu::StringPiece(s.data(), static_cast<int32_t>(s.size())));
+  // The first call computes the size of the sort key (which includes a
+  // terminating NUL byte), and the second call fills it in.
+  const int32_t size = icu_collator_->getSortKey(unicode_str, nullptr, 0);
+  if (size <= 0) {
+    sort_key->clear();
+    return;
+  }
+  sort_key->resize(size);
+  icu_collator_->getSortKey(unicode_str,
+                            reinterpret_cast<uint8_t*>(&(*sort_key)[0]), size);
+  // Drop the terminating NUL byte; every sort key ends with one, so it does
+  // not affect the comparison order.
+  sort_key->resize(size - 1);
+}
+
 }  // namespace zetasql
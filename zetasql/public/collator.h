@@ -71,6 +71,18 @@ class ZetaSqlCollator {
   int64_t CompareUtf8(const absl::string_view s1, const absl::string_view s2,
                     zetasql_base::Status* error) const;
 
+  // Computes the sort key for <s> and stores it in <*sort_key>.
+  //
+  // The sort keys of two strings compare lexicographically (e.g. with memcmp
+  // or std::string comparison) in the same order that CompareUtf8() compares
+  // the strings themselves. Callers that compare the same strings many times
+  // (e.g. when sorting) can compute each string's sort key once and compare
+  // the keys instead of invoking the collation rules per comparison.
+  //
+  // If <s> is not valid UTF-8, each ill-formed subsequence contributes to the
+  // sort key as the Unicode replacement character (U+FFFD).
+  void GetSortKeyUtf8(absl::string_view s, std::string* sort_key) const;
+
   // Returns true if this collator uses simple binary comparisons.
   // If true, engines can get equivalent behavior using binary comparison on
   // strings rather than using CompareUtf8, which may allow for more efficient
@@ -24,7 +24,8 @@
 namespace zetasql {
 
 enum class CompareType {
-  kCompare
+  kCompare,
+  kSortKey
 };
 
 class CollatorTest : public ::testing::TestWithParam<CompareType> {
@@ -40,6 +41,13 @@ class CollatorTest : public ::testing::TestWithParam<CompareType> {
         ZETASQL_EXPECT_OK(error);
         break;
       }
+      case CompareType::kSortKey: {
+        std::string key1, key2;
+        collator->GetSortKeyUtf8(s1, &key1);
+        collator->GetSortKeyUtf8(s2, &key2);
+        EXPECT_EQ(key1, key2) << s1 << "==" << s2;
+        break;
+      }
     }
   }
 
@@ -54,6 +62,13 @@ class CollatorTest : public ::testing::TestWithParam<CompareType> {
         ZETASQL_EXPECT_OK(error);
         break;
       }
+      case CompareType::kSortKey: {
+        std::string key1, key2;
+        collator->GetSortKeyUtf8(s1, &key1);
+        collator->GetSortKeyUtf8(s2, &key2);
+        EXPECT_LT(key1, key2) << s1 << "<" << s2;
+        break;
+      }
     }
   }
 };
@@ -165,6 +180,7 @@ TEST_P(CollatorTest, Comparison) {
 
 INSTANTIATE_TEST_SUITE_P(CollatorTest, CollatorTest,
                          ::testing::Values(
-                             CompareType::kCompare));
+                             CompareType::kCompare,
+                             CompareType::kSortKey));
 
 }  // namespace zetasql
@@ -19,12 +19,14 @@
 #include <ctype.h>
 #include <memory>
 #include <set>
+#include <utility>
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/public/proto/wire_format_annotation.pb.h"
 #include "zetasql/base/case.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
@@ -586,6 +588,53 @@ zetasql_base::Status ConvertTableToProto(
       row_type, is_value_table ? VALUE_TABLE : SQL_TABLE, file);
 }
 
+TypeToProtoCache::TypeToProtoCache(const ConvertTypeToProtoOptions& options)
+    : options_(options) {
+  // Generated protos are shared across calls, so a per-call output map cannot
+  // be filled in from cache hits.
+  CHECK(options_.output_field_descriptor_map == nullptr)
+      << "TypeToProtoCache does not support output_field_descriptor_map";
+}
+
+zetasql_base::Status TypeToProtoCache::ConvertStructToProto(
+    const StructType* struct_type, google::protobuf::FileDescriptorProto* file) {
+  return ConvertImpl(struct_type, DEFAULT_TABLE_TYPE, file);
+}
+
+zetasql_base::Status TypeToProtoCache::ConvertArrayToProto(
+    const ArrayType* array_type, google::protobuf::FileDescriptorProto* file) {
+  return ConvertImpl(array_type, DEFAULT_TABLE_TYPE, file);
+}
+
+zetasql_base::Status TypeToProtoCache::ConvertTableToProto(
+    const Type* row_type, bool is_value_table,
+    google::protobuf::FileDescriptorProto* file) {
+  return ConvertImpl(row_type, is_value_table ? VALUE_TABLE : SQL_TABLE, file);
+}
+
+zetasql_base::Status TypeToProtoCache::ConvertImpl(
+    const Type* type, TableType table_type, google::protobuf::FileDescriptorProto* file) {
+  absl::MutexLock lock(&mutex_);
+  std::unique_ptr<google::protobuf::FileDescriptorProto>& entry =
+      cache_[std::make_pair(type, table_type)];
+  if (entry == nullptr) {
+    auto generated = absl::make_unique<google::protobuf::FileDescriptorProto>();
+    if (table_type == VALUE_TABLE && type->IsProto()) {
+      // Same shortcut as in ConvertTableToProto above.
+      type->AsProto()->descriptor()->file()->CopyTo(generated.get());
+      ZETASQL_RETURN_IF_ERROR(AddValueTableAnnotationForProto(
+          type->AsProto()->descriptor()->full_name(), generated.get()));
+    } else {
+      TypeToProtoConverter converter(options_);
+      ZETASQL_RETURN_IF_ERROR(converter.MakeFileDescriptorProto(type, table_type,
+                                                        generated.get()));
+    }
+    entry = std::move(generated);
+  }
+  *file = *entry;
+  return ::zetasql_base::OkStatus();
+}
+
 // Recursive implementation of FindDescriptorProto.  Handles nested message
 // definitions.  <message_names> is the full_name with the package stripped
 // off, split into parts.
@@ -18,13 +18,18 @@
 #define ZETASQL_PUBLIC_CONVERT_TYPE_TO_PROTO_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
+#include "zetasql/public/proto/wire_format_annotation.pb.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/base/status.h"
@@ -247,6 +252,58 @@ zetasql_base::Status AddValueTableAnnotationForProto(
     const std::string& message_full_name,
     google::protobuf::FileDescriptorProto* file);
 
+// Caches the FileDescriptorProtos generated by the Convert... functions above,
+// keyed by Type pointer, so that converting the same type repeatedly (e.g.,
+// the same result schema once per output batch) is a hash lookup and a proto
+// copy after the first call, with the generated field numbering and message
+// names preserved exactly.  Types are interned by their TypeFactory, so
+// pointer keys are valid as long as every TypeFactory whose types are
+// converted through this cache outlives the cache.
+//
+// All conversions through one cache use the options given at construction.
+// Options with an output_field_descriptor_map are not supported, since that
+// map is a per-call output that cannot be filled in on a cache hit; callers
+// that need it should use the free functions above.
+//
+// This class is thread-safe.
+class TypeToProtoCache {
+ public:
+  explicit TypeToProtoCache(
+      const ConvertTypeToProtoOptions& options = ConvertTypeToProtoOptions());
+
+  // Not copyable or movable.
+  TypeToProtoCache(const TypeToProtoCache&) = delete;
+  TypeToProtoCache& operator=(const TypeToProtoCache&) = delete;
+
+  // These have the same contracts as the corresponding free functions above,
+  // except that <file> may be filled in from a previously generated result.
+  zetasql_base::Status ConvertStructToProto(const StructType* struct_type,
+                                    google::protobuf::FileDescriptorProto* file)
+      LOCKS_EXCLUDED(mutex_);
+  zetasql_base::Status ConvertArrayToProto(const ArrayType* array_type,
+                                   google::protobuf::FileDescriptorProto* file)
+      LOCKS_EXCLUDED(mutex_);
+  zetasql_base::Status ConvertTableToProto(const Type* row_type, bool is_value_table,
+                                   google::protobuf::FileDescriptorProto* file)
+      LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // Fills <file> with the conversion of <type> for <table_type>, generating
+  // and caching it on first use.
+  zetasql_base::Status ConvertImpl(const Type* type, TableType table_type,
+                           google::protobuf::FileDescriptorProto* file)
+      LOCKS_EXCLUDED(mutex_);
+
+  const ConvertTypeToProtoOptions options_;
+
+  absl::Mutex mutex_;
+  // The same Type can convert differently as a value table row type than as
+  // a plain struct/array, so the key includes the table type.
+  absl::flat_hash_map<std::pair<const Type*, TableType>,
+                      std::unique_ptr<google::protobuf::FileDescriptorProto>>
+      cache_ GUARDED_BY(mutex_);
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_PUBLIC_CONVERT_TYPE_TO_PROTO_H_
@@ -0,0 +1,78 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/descriptor_pool_snapshot.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "zetasql/common/proto_helper.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+// Process-level registry of live snapshots, keyed by the serialized
+// FileDescriptorSet. Weak references only: entries do not keep snapshots
+// alive, and expired entries are replaced in place on the next request.
+struct SnapshotRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, std::weak_ptr<const DescriptorPoolSnapshot>>
+      snapshots GUARDED_BY(mutex);
+};
+
+SnapshotRegistry* GetSnapshotRegistry() {
+  static SnapshotRegistry* registry = new SnapshotRegistry;
+  return registry;
+}
+
+}  // namespace
+
+// static
+zetasql_base::Status DescriptorPoolSnapshot::Get(
+    const google::protobuf::FileDescriptorSet& file_descriptor_set,
+    std::shared_ptr<const DescriptorPoolSnapshot>* snapshot) {
+  ZETASQL_RET_CHECK(snapshot != nullptr);
+  std::string key;
+  ZETASQL_RET_CHECK(file_descriptor_set.SerializeToString(&key));
+
+  SnapshotRegistry* registry = GetSnapshotRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  std::weak_ptr<const DescriptorPoolSnapshot>& entry =
+      registry->snapshots[key];
+  *snapshot = entry.lock();
+  if (*snapshot != nullptr) {
+    return ::zetasql_base::OkStatus();
+  }
+
+  // Cannot use make_shared with a private constructor.
+  std::shared_ptr<DescriptorPoolSnapshot> new_snapshot(
+      new DescriptorPoolSnapshot);
+  ZETASQL_RETURN_IF_ERROR(AddFileDescriptorSetToPool(&file_descriptor_set,
+                                             &new_snapshot->pool_));
+  *snapshot = std::move(new_snapshot);
+  entry = *snapshot;
+  return ::zetasql_base::OkStatus();
+}
+
+}  // namespace zetasql
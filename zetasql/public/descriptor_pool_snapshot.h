@@ -0,0 +1,85 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_DESCRIPTOR_POOL_SNAPSHOT_H_
+#define ZETASQL_PUBLIC_DESCRIPTOR_POOL_SNAPSHOT_H_
+
+#include <memory>
+#include <string>
+
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+
+// An immutable DescriptorPool built once from a FileDescriptorSet and shared
+// across consumers with refcounted lifetime.
+//
+// TypeFactory::MakeProtoType and MakeEnumType require their descriptors to
+// outlive the TypeFactory (see ownership notes in type.h). Services that
+// rebuild a DescriptorPool per catalog can instead hold a
+// std::shared_ptr<const DescriptorPoolSnapshot> next to each TypeFactory:
+// the shared_ptr guarantees the descriptors outlive the factory, and
+// catalogs built from byte-identical FileDescriptorSets share one snapshot
+// (and thus one descriptor universe) instead of each building their own.
+//
+// Snapshots are deduplicated in a process-level registry keyed by the
+// serialized FileDescriptorSet. The registry holds weak references only, so
+// a snapshot is destroyed when the last consumer releases it, and rebuilt on
+// the next request for the same set.
+//
+// This class is thread-safe; the underlying pool is never modified after
+// construction.
+class DescriptorPoolSnapshot {
+ public:
+  // Returns the process-wide snapshot for 'file_descriptor_set', building it
+  // on first use. The files in the set must be ordered so that every file
+  // appears after its dependencies, as produced by
+  // PopulateFileDescriptorSet(). Returns an error if the descriptors do not
+  // form a valid pool.
+  static zetasql_base::Status Get(
+      const google::protobuf::FileDescriptorSet& file_descriptor_set,
+      std::shared_ptr<const DescriptorPoolSnapshot>* snapshot);
+
+#ifndef SWIG
+  DescriptorPoolSnapshot(const DescriptorPoolSnapshot&) = delete;
+  DescriptorPoolSnapshot& operator=(const DescriptorPoolSnapshot&) = delete;
+#endif  // SWIG
+
+  // The pool holding the snapshot's descriptors. Never nullptr. Callers must
+  // not mutate the pool; descriptors looked up here are valid as long as the
+  // caller holds a shared_ptr to this snapshot.
+  const google::protobuf::DescriptorPool* pool() const { return &pool_; }
+
+  // Convenience lookups on pool(). Return nullptr if 'full_name' is not in
+  // the snapshot.
+  const google::protobuf::Descriptor* FindMessage(const std::string& full_name) const {
+    return pool_.FindMessageTypeByName(full_name);
+  }
+  const google::protobuf::EnumDescriptor* FindEnum(const std::string& full_name) const {
+    return pool_.FindEnumTypeByName(full_name);
+  }
+
+ private:
+  DescriptorPoolSnapshot() {}
+
+  google::protobuf::DescriptorPool pool_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_DESCRIPTOR_POOL_SNAPSHOT_H_
@@ -0,0 +1,118 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/descriptor_pool_snapshot.h"
+
+#include <memory>
+#include <set>
+
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "zetasql/common/proto_helper.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/type.h"
+#include "zetasql/testdata/test_schema.pb.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+static google::protobuf::FileDescriptorSet GetTestSchemaFileDescriptorSet() {
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  std::set<const google::protobuf::FileDescriptor*> file_descriptors;
+  ZETASQL_CHECK_OK(PopulateFileDescriptorSet(
+      zetasql_test::KitchenSinkPB::descriptor()->file(),
+      absl::optional<int64_t>(), &file_descriptor_set, &file_descriptors));
+  return file_descriptor_set;
+}
+
+TEST(DescriptorPoolSnapshotTest, ByteIdenticalSetsShareOneSnapshot) {
+  const google::protobuf::FileDescriptorSet file_descriptor_set =
+      GetTestSchemaFileDescriptorSet();
+
+  std::shared_ptr<const DescriptorPoolSnapshot> snapshot1;
+  ZETASQL_ASSERT_OK(DescriptorPoolSnapshot::Get(file_descriptor_set, &snapshot1));
+  std::shared_ptr<const DescriptorPoolSnapshot> snapshot2;
+  ZETASQL_ASSERT_OK(DescriptorPoolSnapshot::Get(file_descriptor_set, &snapshot2));
+
+  EXPECT_EQ(snapshot1.get(), snapshot2.get());
+
+  const google::protobuf::Descriptor* kitchen_sink =
+      snapshot1->FindMessage("zetasql_test.KitchenSinkPB");
+  ASSERT_TRUE(kitchen_sink != nullptr);
+  EXPECT_EQ(kitchen_sink->file()->pool(), snapshot1->pool());
+  EXPECT_TRUE(snapshot1->FindEnum("zetasql_test.TestEnum") != nullptr);
+  EXPECT_TRUE(snapshot1->FindMessage("zetasql_test.NoSuchMessage") == nullptr);
+}
+
+TEST(DescriptorPoolSnapshotTest, ReleasedSnapshotIsRebuilt) {
+  const google::protobuf::FileDescriptorSet file_descriptor_set =
+      GetTestSchemaFileDescriptorSet();
+
+  std::shared_ptr<const DescriptorPoolSnapshot> snapshot;
+  ZETASQL_ASSERT_OK(DescriptorPoolSnapshot::Get(file_descriptor_set, &snapshot));
+  const DescriptorPoolSnapshot* original = snapshot.get();
+
+  // The registry holds weak references only, so dropping the last consumer
+  // reference destroys the snapshot and the next request builds a new one.
+  snapshot.reset();
+  ZETASQL_ASSERT_OK(DescriptorPoolSnapshot::Get(file_descriptor_set, &snapshot));
+  EXPECT_TRUE(snapshot.get() != nullptr);
+  EXPECT_TRUE(snapshot->FindMessage("zetasql_test.KitchenSinkPB") != nullptr);
+  // 'original' is dangling here; this just documents that identity is not
+  // preserved across a full release.
+  (void)original;
+}
+
+TEST(DescriptorPoolSnapshotTest, SnapshotDescriptorsWorkWithTypeFactory) {
+  std::shared_ptr<const DescriptorPoolSnapshot> snapshot;
+  ZETASQL_ASSERT_OK(
+      DescriptorPoolSnapshot::Get(GetTestSchemaFileDescriptorSet(), &snapshot));
+
+  // Two "tenants" with their own TypeFactory sharing one descriptor universe.
+  TypeFactory factory1;
+  const ProtoType* proto_type1;
+  ZETASQL_ASSERT_OK(factory1.MakeProtoType(
+      snapshot->FindMessage("zetasql_test.KitchenSinkPB"), &proto_type1));
+
+  TypeFactory factory2;
+  const ProtoType* proto_type2;
+  ZETASQL_ASSERT_OK(factory2.MakeProtoType(
+      snapshot->FindMessage("zetasql_test.KitchenSinkPB"), &proto_type2));
+
+  EXPECT_EQ(proto_type1->descriptor(), proto_type2->descriptor());
+}
+
+TEST(DescriptorPoolSnapshotTest, InvalidSetReturnsError) {
+  // A file referencing a dependency that is not in the set cannot be built.
+  google::protobuf::FileDescriptorSet file_descriptor_set;
+  zetasql_test::KitchenSinkPB::descriptor()->file()->CopyTo(
+      file_descriptor_set.add_file());
+
+  std::shared_ptr<const DescriptorPoolSnapshot> snapshot;
+  EXPECT_THAT(
+      DescriptorPoolSnapshot::Get(file_descriptor_set, &snapshot),
+      StatusIs(zetasql_base::INVALID_ARGUMENT,
+               HasSubstr("Error(s) encountered during protocol buffer "
+                         "analysis")));
+}
+
+}  // namespace
+}  // namespace zetasql
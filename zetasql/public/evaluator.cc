@@ -17,11 +17,16 @@
 #include "zetasql/public/evaluator.h"
 
 #include <functional>
+#include <map>
 #include <unordered_map>
 #include <utility>
 
+#include "google/protobuf/descriptor.pb.h"
 #include "zetasql/base/logging.h"
+#include "zetasql/public/descriptor_pool_snapshot.h"
+#include "zetasql/public/id_string.h"
 #include "zetasql/public/options.pb.h"
+#include "zetasql/public/prepared_query_snapshot.pb.h"
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/strings.h"
 #include "zetasql/public/type.h"
@@ -38,7 +43,9 @@
 #include "zetasql/resolved_ast/validator.h"
 #include "absl/memory/memory.h"
 #include "zetasql/base/case.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/map_util.h"
@@ -152,6 +159,25 @@ class Evaluator {
   zetasql_base::StatusOr<std::string> ExplainAfterPrepare() const
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Returns the IteratorDebugString()s of the operators in the compiled plan
+  // that may buffer rows before returning their first output row.
+  // REQUIRES: Prepare() has been called successfully.
+  zetasql_base::StatusOr<std::vector<std::string>> GetBufferingOperators() const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the compiled plan annotated with the per-operator runtime counters
+  // from the most recent completed execution.
+  // REQUIRES: Prepare() has been called successfully, collect_operator_stats
+  // was set in the EvaluatorOptions, and at least one execution has finished.
+  zetasql_base::StatusOr<std::string> ExplainAfterExecute() const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the peak number of accounted intermediate-memory bytes from the
+  // most recent completed execution.
+  // REQUIRES: Same as ExplainAfterExecute().
+  zetasql_base::StatusOr<int64_t> GetPeakMemoryBytesAfterExecute() const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Returns NULL if this object is for a query instead of an expression.
   const Type* expression_output_type() const ABSL_LOCKS_EXCLUDED(mutex_);
 
@@ -281,9 +307,29 @@ class Evaluator {
         evaluator_options_.max_value_byte_size;
     evaluation_options.max_intermediate_byte_size =
         evaluator_options_.max_intermediate_byte_size;
+    evaluation_options.max_intra_op_parallelism =
+        evaluator_options_.max_intra_op_parallelism;
+    evaluation_options.scheduler = evaluator_options_.scheduler;
+    evaluation_options.scheduler_weight = evaluator_options_.scheduler_weight;
+    evaluation_options.scan_prefetch_queue_size =
+        evaluator_options_.scan_prefetch_queue_size;
+    evaluation_options.collect_operator_stats =
+        evaluator_options_.collect_operator_stats;
+    evaluation_options.skip_determinism_tracking =
+        evaluator_options_.skip_determinism_tracking;
 
     auto context = absl::make_unique<EvaluationContext>(evaluation_options);
 
+    if (evaluator_options_.yield_callback != nullptr) {
+      context->SetYieldCallback(evaluator_options_.yield_callback);
+    }
+
+    if (evaluator_options_.memory_usage_callback != nullptr) {
+      context->memory_accountant()->SetUsageCallback(
+          evaluator_options_.memory_usage_threshold_bytes,
+          evaluator_options_.memory_usage_callback);
+    }
+
     context->SetClockAndClearCurrentTimestamp(evaluator_options_.clock);
     if (evaluator_options_.default_time_zone.has_value()) {
       context->SetDefaultTimeZone(evaluator_options_.default_time_zone.value());
@@ -307,6 +353,18 @@ class Evaluator {
     --num_live_iterators_;
   }
 
+  // Copies the per-operator runtime counters accumulated in 'context' so that
+  // ExplainAfterExecute() can render them after the iterator returned by
+  // Execute() is destroyed. A no-op unless collect_operator_stats is set.
+  void StoreOperatorStats(const EvaluationContext& context) const
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    if (!context.options().collect_operator_stats) return;
+    absl::MutexLock l(&mutex_);
+    last_operator_stats_ = context.operator_stats();
+    last_peak_memory_bytes_ = context.memory_accountant()->peak_used_bytes();
+    has_operator_stats_ = true;
+  }
+
   // The original SQL.  Not present if expr_ or query_ was passed in directly.
   const std::string sql_;
   // True for queries, false for expressions. (Set by the constructor).
@@ -356,6 +414,16 @@ class Evaluator {
   // sanity checking that an iterator does not outlive the Evaluator.
   mutable int num_live_iterators_ GUARDED_BY(num_live_iterators_mutex_) = 0;
 
+  // The per-operator runtime counters from the most recent completed
+  // execution, keyed by the operators in 'compiled_relational_op_'. Only
+  // populated if collect_operator_stats is set in the EvaluatorOptions.
+  // Mutable so that they can be stored by the deletion callback of the
+  // iterator returned by ExecuteAfterPrepare().
+  mutable std::map<const RelationalOp*, EvaluationContext::OperatorStats>
+      last_operator_stats_ GUARDED_BY(mutex_);
+  mutable int64_t last_peak_memory_bytes_ GUARDED_BY(mutex_) = 0;
+  mutable bool has_operator_stats_ GUARDED_BY(mutex_) = false;
+
   // The last EvaluationContext that we created, only for use by unit tests. May
   // be NULL.
   std::unique_ptr<std::function<void(EvaluationContext*)>>
@@ -394,6 +462,9 @@ zetasql_base::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
   algebrizer_options.allow_hash_join = true;
   algebrizer_options.allow_order_by_limit_operator = true;
   algebrizer_options.push_down_filters = true;
+  algebrizer_options.fold_constant_function_calls = true;
+  algebrizer_options.deduplicate_computed_expressions = true;
+  algebrizer_options.reorder_commutative_operands = true;
 
   SystemVariablesAlgebrizerMap algebrizer_system_variables;
   if (is_query_) {
@@ -493,6 +564,20 @@ zetasql_base::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
         compiled_value_expr_->SetSchemasForEvaluation({&params_schema}));
   }
 
+  if (evaluator_options_.require_streaming) {
+    std::vector<std::string> buffering_ops;
+    const AlgebraNode* algebra_root =
+        is_query_ ? static_cast<const AlgebraNode*>(compiled_relational_op_.get())
+                  : static_cast<const AlgebraNode*>(compiled_value_expr_.get());
+    algebra_root->CollectMayBufferRowsOps(&buffering_ops);
+    if (!buffering_ops.empty()) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+             << "The plan requires buffering rows, but "
+             << "EvaluatorOptions.require_streaming is set. "
+             << "Buffering operator: " << buffering_ops[0];
+    }
+  }
+
   return ::zetasql_base::OkStatus();
 }
 
@@ -576,9 +661,23 @@ zetasql_base::Status Evaluator::Execute(
     const ParameterValueMap& columns, const ParameterValues& parameters,
     Value* expression_output_value,
     std::unique_ptr<EvaluatorTableIterator>* query_output_iterator) {
+  {
+    // Fast path: once prepared, execution only needs the shared lock.
+    // Evaluation state (parameter bindings, EvaluationContext) is created
+    // per call, so concurrent executions share the compiled plan without
+    // serializing on the exclusive lock below.
+    absl::ReaderMutexLock l(&mutex_);
+    if (is_prepared()) {
+      return ExecuteAfterPrepareLocked(columns, parameters,
+                                       expression_output_value,
+                                       query_output_iterator);
+    }
+  }
+
   {
     absl::MutexLock l(&mutex_);
-    // Call Prepare() implicitly if not done by the user.
+    // Call Prepare() implicitly if not done by the user. Re-check under the
+    // exclusive lock; another thread may have prepared concurrently.
     if (!is_prepared()) {
       ZETASQL_RET_CHECK(analyzer_options_.query_parameters().empty() &&
                 analyzer_options_.positional_query_parameters().empty() &&
@@ -757,7 +856,12 @@ zetasql_base::Status Evaluator::ExecuteAfterPrepareWithOrderedParamsLocked(
     }
 
     IncrementNumLiveIterators();
-    std::function<void()> deletion_cb = [this]() {
+    // 'context' is moved into the TupleIteratorAdaptor below but stays alive
+    // until after the deletion callback runs, so it is safe to harvest the
+    // operator stats from it there.
+    EvaluationContext* context_ptr = context.get();
+    std::function<void()> deletion_cb = [this, context_ptr]() {
+      StoreOperatorStats(*context_ptr);
       DecrementNumLiveIterators();
     };
     *query_output_iterator = absl::make_unique<TupleIteratorAdaptor>(
@@ -790,6 +894,105 @@ zetasql_base::StatusOr<std::string> Evaluator::ExplainAfterPrepare() const {
   }
 }
 
+zetasql_base::StatusOr<std::vector<std::string>> Evaluator::GetBufferingOperators()
+    const {
+  absl::ReaderMutexLock l(&mutex_);
+  ZETASQL_RET_CHECK(is_prepared()) << "Prepare must be called first";
+  std::vector<std::string> buffering_ops;
+  if (is_query_) {
+    ZETASQL_RET_CHECK(compiled_relational_op_ != nullptr);
+    compiled_relational_op_->CollectMayBufferRowsOps(&buffering_ops);
+  } else {
+    ZETASQL_RET_CHECK(compiled_value_expr_ != nullptr);
+    compiled_value_expr_->CollectMayBufferRowsOps(&buffering_ops);
+  }
+  return buffering_ops;
+}
+
+namespace {
+// Appends one line per RelationalOp in the tree rooted at 'node', indented by
+// depth in the tree and annotated with the operator's counters from 'stats'.
+// An operator that has no entry in 'stats' never created an iterator (e.g.,
+// the unvisited side of a short-circuited plan).
+void AppendOperatorStatsLines(
+    const AlgebraNode* node,
+    const std::map<const RelationalOp*, EvaluationContext::OperatorStats>&
+        stats,
+    int depth, std::string* out) {
+  const RelationalOp* relational_op = node->AsRelationalOp();
+  if (relational_op != nullptr) {
+    // The prefix of IteratorDebugString() (e.g., "SortTupleIterator") names
+    // the operator without recursively describing its inputs.
+    std::string name = relational_op->IteratorDebugString();
+    name = name.substr(0, name.find('('));
+    absl::StrAppend(out, std::string(2 * depth, ' '), name, ": ");
+    const auto it = stats.find(relational_op);
+    if (it == stats.end()) {
+      absl::StrAppend(out, "never started\n");
+    } else {
+      const EvaluationContext::OperatorStats& op_stats = it->second;
+      absl::StrAppend(
+          out, "iterators=", op_stats.num_iterators_created,
+          " rows=", op_stats.num_output_rows,
+          " batches=", op_stats.num_output_batches, " time=",
+          absl::FormatDuration(absl::Nanoseconds(op_stats.cumulative_nanos)),
+          "\n");
+    }
+    ++depth;
+  }
+  for (const AlgebraArg* arg : node->GetArgs()) {
+    if (arg->has_node()) {
+      AppendOperatorStatsLines(arg->node(), stats, depth, out);
+    }
+  }
+}
+}  // namespace
+
+zetasql_base::StatusOr<std::string> Evaluator::ExplainAfterExecute() const {
+  absl::ReaderMutexLock l(&mutex_);
+  ZETASQL_RET_CHECK(is_query_) << "Operator stats are only collected for queries";
+  ZETASQL_RET_CHECK(is_prepared()) << "Prepare must be called first";
+  ZETASQL_RET_CHECK(compiled_relational_op_ != nullptr);
+  if (!evaluator_options_.collect_operator_stats) {
+    return ::zetasql_base::FailedPreconditionErrorBuilder(ZETASQL_LOC)
+           << "ExplainAfterExecute() requires "
+           << "EvaluatorOptions.collect_operator_stats";
+  }
+  if (!has_operator_stats_) {
+    return ::zetasql_base::FailedPreconditionErrorBuilder(ZETASQL_LOC)
+           << "ExplainAfterExecute() requires a completed execution (the "
+           << "stats are recorded when the iterator returned by Execute() is "
+           << "destroyed)";
+  }
+  std::string result = compiled_relational_op_->DebugString();
+  absl::StrAppend(&result,
+                  "\n\nOperator stats (most recent execution; times include "
+                  "inputs):\n");
+  AppendOperatorStatsLines(compiled_relational_op_.get(), last_operator_stats_,
+                           /*depth=*/0, &result);
+  absl::StrAppend(&result, "Peak accounted intermediate memory: ",
+                  last_peak_memory_bytes_, " bytes\n");
+  return result;
+}
+
+zetasql_base::StatusOr<int64_t> Evaluator::GetPeakMemoryBytesAfterExecute() const {
+  absl::ReaderMutexLock l(&mutex_);
+  ZETASQL_RET_CHECK(is_query_) << "Operator stats are only collected for queries";
+  ZETASQL_RET_CHECK(is_prepared()) << "Prepare must be called first";
+  if (!evaluator_options_.collect_operator_stats) {
+    return ::zetasql_base::FailedPreconditionErrorBuilder(ZETASQL_LOC)
+           << "GetPeakMemoryBytesAfterExecute() requires "
+           << "EvaluatorOptions.collect_operator_stats";
+  }
+  if (!has_operator_stats_) {
+    return ::zetasql_base::FailedPreconditionErrorBuilder(ZETASQL_LOC)
+           << "GetPeakMemoryBytesAfterExecute() requires a completed "
+           << "execution (the peak is recorded when the iterator returned by "
+           << "Execute() is destroyed)";
+  }
+  return last_peak_memory_bytes_;
+}
+
 const Type* Evaluator::expression_output_type() const {
   absl::ReaderMutexLock l(&mutex_);
   CHECK(!is_query_) << "Only expressions have output types";
@@ -992,6 +1195,10 @@ const Type* PreparedExpression::output_type() const {
   return evaluator_->expression_output_type();
 }
 
+PreparedQuerySnapshot::PreparedQuerySnapshot() {}
+
+PreparedQuerySnapshot::~PreparedQuerySnapshot() {}
+
 PreparedQuery::PreparedQuery(const std::string& sql, const EvaluatorOptions& options)
     : evaluator_(new internal::Evaluator(sql, /*is_query=*/true, options)) {}
 
@@ -1048,6 +1255,20 @@ zetasql_base::StatusOr<std::string> PreparedQuery::ExplainAfterPrepare() const {
   return evaluator_->ExplainAfterPrepare();
 }
 
+zetasql_base::StatusOr<std::vector<std::string>>
+PreparedQuery::GetBufferingOperatorsAfterPrepare() const {
+  return evaluator_->GetBufferingOperators();
+}
+
+zetasql_base::StatusOr<std::string> PreparedQuery::ExplainAfterExecute() const {
+  return evaluator_->ExplainAfterExecute();
+}
+
+zetasql_base::StatusOr<int64_t> PreparedQuery::GetPeakMemoryBytesAfterExecute()
+    const {
+  return evaluator_->GetPeakMemoryBytesAfterExecute();
+}
+
 int PreparedQuery::num_columns() const {
   return evaluator_->query_output_columns().size();
 }
@@ -1070,6 +1291,78 @@ const ResolvedQueryStmt* PreparedQuery::resolved_query_stmt() const {
   return evaluator_->resolved_query_stmt();
 }
 
+const int PreparedQuery::kSnapshotVersion = 1;
+
+zetasql_base::Status PreparedQuery::ToSnapshot(
+    PreparedQuerySnapshotProto* snapshot) const {
+  const ResolvedQueryStmt* stmt = evaluator_->resolved_query_stmt();
+  snapshot->Clear();
+  snapshot->set_snapshot_version(kSnapshotVersion);
+  FileDescriptorSetMap file_descriptor_set_map;
+  ZETASQL_RETURN_IF_ERROR(stmt->SaveTo(&file_descriptor_set_map,
+                              snapshot->mutable_resolved_statement()));
+  // The map assigns each referenced DescriptorPool a dense index. Emit the
+  // FileDescriptorSets in index order so that LoadSnapshot() can rebuild the
+  // pool vector positionally.
+  std::vector<const google::protobuf::FileDescriptorSet*> file_descriptor_sets(
+      file_descriptor_set_map.size());
+  for (const auto& entry : file_descriptor_set_map) {
+    file_descriptor_sets[entry.second->descriptor_set_index] =
+        &entry.second->file_descriptor_set;
+  }
+  for (const google::protobuf::FileDescriptorSet* set : file_descriptor_sets) {
+    *snapshot->add_file_descriptor_set() = *set;
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::StatusOr<std::unique_ptr<PreparedQuerySnapshot>>
+PreparedQuery::LoadSnapshot(const PreparedQuerySnapshotProto& snapshot,
+                            Catalog* catalog, TypeFactory* type_factory) {
+  ZETASQL_RET_CHECK(catalog != nullptr);
+  ZETASQL_RET_CHECK(type_factory != nullptr);
+  if (snapshot.snapshot_version() != kSnapshotVersion) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+           << "Unsupported prepared query snapshot version "
+           << snapshot.snapshot_version() << "; this binary supports version "
+           << kSnapshotVersion;
+  }
+
+  auto result = absl::WrapUnique(new PreparedQuerySnapshot);
+
+  // Rebuild one DescriptorPool per serialized FileDescriptorSet.
+  // DescriptorPoolSnapshot deduplicates the pools process-wide, so many
+  // statements referencing the same descriptors share one pool.
+  std::vector<const google::protobuf::DescriptorPool*> pools;
+  pools.reserve(snapshot.file_descriptor_set_size());
+  for (const google::protobuf::FileDescriptorSet& file_descriptor_set :
+       snapshot.file_descriptor_set()) {
+    std::shared_ptr<const DescriptorPoolSnapshot> pool_snapshot;
+    ZETASQL_RETURN_IF_ERROR(
+        DescriptorPoolSnapshot::Get(file_descriptor_set, &pool_snapshot));
+    pools.push_back(pool_snapshot->pool());
+    result->pool_snapshots_.push_back(std::move(pool_snapshot));
+  }
+
+  // Deserialization looks every referenced table, function and named type up
+  // in <catalog>, which is the revalidation step: a snapshot whose referenced
+  // objects are gone or incompatible fails here rather than at execution.
+  result->string_pool_ = absl::make_unique<IdStringPool>();
+  ResolvedNode::RestoreParams restore_params(
+      std::move(pools), catalog, type_factory, result->string_pool_.get());
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedStatement> statement,
+                   ResolvedStatement::RestoreFrom(snapshot.resolved_statement(),
+                                                  restore_params));
+  if (statement->node_kind() != RESOLVED_QUERY_STMT) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+           << "Prepared query snapshot does not contain a query statement: "
+           << statement->node_kind_string();
+  }
+  result->stmt_ = absl::WrapUnique(
+      statement.release()->GetAs<ResolvedQueryStmt>());
+  return std::move(result);
+}
+
 void PreparedQuery::SetCreateEvaluationCallbackTestOnly(
     std::function<void(EvaluationContext*)> cb) {
   return evaluator_->SetCreateEvaluationCallbackTestOnly(cb);
@@ -104,9 +104,10 @@
 // Thread safety: PreparedExpression is thread-safe. The recommended way to use
 // PreparedExpression from multiple threads is to call Prepare() once and then
 // call ExecuteAfterPrepare() in parallel from multiple threads for concurrent
-// evaluations. (It is also possible to call Execute() in parallel multiple
-// times, but in that case, each of the executions have to consider whether to
-// call Prepare(), and there is some serialization there.)
+// evaluations. The compiled plan is shared; each execution gets its own
+// evaluation state, so a single PreparedExpression serves any number of
+// worker threads. (It is also possible to call Execute() in parallel multiple
+// times; once the expression is prepared, those calls no longer serialize.)
 //
 // Evaluating Queries
 // ------------------
@@ -133,6 +134,7 @@
 // using num_columns(), column_name(), column_type(), etc.  After Execute(), the
 // schema is also available from the EvaluatorTableIterator.
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -152,9 +154,13 @@
 
 namespace zetasql {
 
+class DescriptorPoolSnapshot;
 class EvaluationContext;
+class IdStringPool;
+class PreparedQuerySnapshotProto;
 class ResolvedExpr;
 class ResolvedQueryStmt;
+class WorkStealingScheduler;
 
 using ParameterValueMap = std::map<std::string, Value>;
 using ParameterValueList = std::vector<Value>;
@@ -211,6 +217,88 @@ struct EvaluatorOptions {
   // accounting charges each of them individually. In some cases, it is
   // necessary to set this option to a very large value.
   int64_t max_intermediate_byte_size = 128 * 1024 * 1024;
+
+  // The maximum number of threads that may be used to evaluate a single
+  // operation. The default (1) evaluates queries entirely on the calling
+  // thread. Larger values allow the evaluator to use background threads where
+  // it is safe to do so. The evaluator is fundamentally a single-threaded
+  // pull-based iterator tree, so currently this only overlaps table scans with
+  // the rest of query evaluation by prefetching rows on a background thread.
+  int64_t max_intra_op_parallelism = 1;
+
+  // If set, background work enabled by 'max_intra_op_parallelism' runs as
+  // tasks on this shared scheduler instead of on threads dedicated to the
+  // evaluation, so many concurrent evaluations (each with its own
+  // PreparedQuery or PreparedExpression) multiplex their background work over
+  // one fixed pool of worker threads. The scheduler dispatches each
+  // evaluation's tasks in proportion to 'scheduler_weight' (which must be
+  // positive), so a burst of heavy queries cannot starve light ones, and idle
+  // workers steal queued tasks to keep the pool busy. See
+  // reference_impl/work_stealing_scheduler.h. The calling thread still drives
+  // evaluation; combine this with 'yield_callback' to also multiplex the
+  // calling threads.
+  std::shared_ptr<WorkStealingScheduler> scheduler;
+  double scheduler_weight = 1.0;
+
+  // The maximum number of rows a prefetching table scan (enabled by
+  // 'max_intra_op_parallelism') keeps buffered ahead of the consumer. Deeper
+  // queues ride out longer per-row stalls in the catalog's
+  // EvaluatorTableIterator (e.g., one that fetches from remote storage) at
+  // the cost of buffering more rows in memory. Values less than 1 are
+  // treated as 1.
+  int64_t scan_prefetch_queue_size = 64;
+
+  // If set, this callback is invoked periodically (every few thousand rows)
+  // from within Execute() at points where it is safe to suspend evaluation.
+  // Evaluation is fundamentally synchronous, but a caller that multiplexes
+  // many concurrent evaluations over a small number of threads (e.g., on
+  // fibers or another userspace scheduler) can use the callback to yield the
+  // calling thread between rows instead of blocking it for the life of the
+  // query. The callback must return on the same thread it was invoked on, and
+  // may be invoked concurrently by executions proceeding in parallel. To abort
+  // a suspended execution, cancel it (e.g., by expiring the deadline in the
+  // AnalyzerOptions) before resuming; the cancellation check runs immediately
+  // after the callback returns.
+  std::function<void()> yield_callback;
+
+  // If true, Prepare() (and the implicit Prepare() performed by the first call
+  // to Execute()) fails if the plan contains an operator that buffers rows
+  // before returning its first output row, and can therefore use memory
+  // proportional to the size of its input (e.g., the sort implementing ORDER
+  // BY, or the build side of a join). When preparation succeeds with this
+  // option set, execution is fully pipelined: output rows are returned as soon
+  // as they are computed, and memory usage does not grow with the size of the
+  // input. Use PreparedQuery::GetBufferingOperatorsAfterPrepare() to see which
+  // operators in a plan buffer rows.
+  bool require_streaming = false;
+
+  // If set, 'memory_usage_callback' is invoked with the current number of
+  // bytes of accounted intermediate memory whenever usage rises to at least
+  // 'memory_usage_threshold_bytes' during an execution, and is re-armed when
+  // usage drops back below the threshold. This gives the caller a signal to
+  // react to memory pressure (e.g., cancel or deprioritize the statement)
+  // before evaluation fails with a terminal out-of-memory error at
+  // 'max_intermediate_byte_size'. The callback runs synchronously on the
+  // thread doing the evaluation and must be fast; it may be invoked
+  // concurrently by executions proceeding in parallel.
+  std::function<void(int64_t bytes_used)> memory_usage_callback;
+  int64_t memory_usage_threshold_bytes = 0;
+
+  // If true, each execution collects per-operator runtime counters (iterators
+  // created, rows and batches returned, cumulative time) while the query
+  // runs. Use PreparedQuery::ExplainAfterExecute() to render the plan
+  // annotated with the counters from the most recent execution. Collecting
+  // the counters adds a clock read per returned row, so this is off by
+  // default.
+  bool collect_operator_stats = false;
+
+  // If true, evaluation skips the bookkeeping that tracks whether the result
+  // is deterministic under ZetaSQL semantics, such as checking whether
+  // sorted rows are uniquely ordered. That tracking only feeds compliance and
+  // random query testing, so production callers can set this to avoid paying
+  // for it; it must be left unset together with
+  // 'scramble_undefined_orderings'.
+  bool skip_determinism_tracking = false;
 };
 
 class PreparedExpression {
@@ -376,6 +464,30 @@ class PreparedExpression {
   std::unique_ptr<internal::Evaluator> evaluator_;
 };
 
+// Holds a ResolvedQueryStmt loaded from a PreparedQuerySnapshotProto,
+// together with the descriptor pools and strings it references. Created by
+// PreparedQuery::LoadSnapshot(). Must outlive any PreparedQuery constructed
+// from stmt().
+class PreparedQuerySnapshot {
+ public:
+  PreparedQuerySnapshot(const PreparedQuerySnapshot&) = delete;
+  PreparedQuerySnapshot& operator=(const PreparedQuerySnapshot&) = delete;
+  ~PreparedQuerySnapshot();
+
+  // The loaded statement. Valid for the lifetime of this object.
+  const ResolvedQueryStmt* stmt() const { return stmt_.get(); }
+
+ private:
+  friend class PreparedQuery;
+  PreparedQuerySnapshot();
+
+  // Keeps the descriptors referenced by 'stmt_' alive.
+  std::vector<std::shared_ptr<const DescriptorPoolSnapshot>> pool_snapshots_;
+  // Owns the IdStrings in 'stmt_'.
+  std::unique_ptr<IdStringPool> string_pool_;
+  std::unique_ptr<const ResolvedQueryStmt> stmt_;
+};
+
 class PreparedQuery {
  public:
   // Constructor. Additional options can be provided by filling out the
@@ -466,6 +578,38 @@ class PreparedQuery {
   // called.
   zetasql_base::StatusOr<std::string> ExplainAfterPrepare() const;
 
+  // Returns a human-readable description of each operator in the compiled
+  // plan that may buffer rows before returning its first output row (e.g.,
+  // the sort implementing ORDER BY), in the order in which the operators
+  // appear in ExplainAfterPrepare(). An empty result means execution is fully
+  // pipelined: the first row is returned without materializing any
+  // intermediate results, and memory usage does not grow with the size of the
+  // input (see EvaluatorOptions::require_streaming). Do not try to interpret
+  // these strings with code, as the format can change at any time. Requires
+  // that Prepare has already been called.
+  zetasql_base::StatusOr<std::vector<std::string>>
+  GetBufferingOperatorsAfterPrepare() const;
+
+  // Returns the same plan representation as ExplainAfterPrepare(), annotated
+  // with the runtime counters (iterators created, rows and batches returned,
+  // cumulative time including time spent in inputs) and the peak accounted
+  // intermediate memory from the most recent completed execution. The
+  // counters are recorded when the iterator returned by Execute() is
+  // destroyed. Do not try to interpret this std::string with code, as the
+  // format can change at any time. Requires that
+  // EvaluatorOptions::collect_operator_stats was set, that Prepare has
+  // already been called, and that at least one execution has finished.
+  zetasql_base::StatusOr<std::string> ExplainAfterExecute() const;
+
+  // Returns the peak number of bytes of accounted intermediate memory (see
+  // EvaluatorOptions::max_intermediate_byte_size) used by the most recent
+  // completed execution, recorded when the iterator returned by Execute() is
+  // destroyed. Unlike ExplainAfterExecute(), the result is machine-readable,
+  // e.g., for benchmarks and monitoring. Requires that
+  // EvaluatorOptions::collect_operator_stats was set, that Prepare has
+  // already been called, and that at least one execution has finished.
+  zetasql_base::StatusOr<int64_t> GetPeakMemoryBytesAfterExecute() const;
+
   // Get the schema of the output table of this query. Anonymous column names
   // are empty. (There may be more than one column with the same name.)
   //
@@ -492,6 +636,36 @@ class PreparedQuery {
   // REQUIRES: Prepare() or Execute() has been called successfully.
   const ResolvedQueryStmt* resolved_query_stmt() const;
 
+  // The format version written into PreparedQuerySnapshotProto by
+  // ToSnapshot(). Incremented whenever the snapshot encoding changes
+  // incompatibly.
+  static const int kSnapshotVersion;
+
+  // Serializes the analyzed statement of this query into <snapshot>, along
+  // with the FileDescriptorSets for any proto or enum types it references.
+  // One process can prepare a statement once, ship the snapshot to other
+  // processes (or persist it), and those processes can prepare the same
+  // statement with LoadSnapshot() without repeating the parse and analysis
+  // work, which dominates preparation cost.
+  //
+  // REQUIRES: Prepare() or Execute() has been called successfully.
+  zetasql_base::Status ToSnapshot(PreparedQuerySnapshotProto* snapshot) const;
+
+  // Loads a snapshot written by ToSnapshot(), revalidating the statement
+  // against <catalog>: every table, function and named type the statement
+  // references is looked up in <catalog> again, and an error is returned if
+  // anything is missing or has changed incompatibly. Also returns an error
+  // for snapshots written with a different kSnapshotVersion.
+  //
+  // To evaluate the loaded statement, pass result->stmt() to the
+  // ResolvedQueryStmt constructor above and call Prepare(); that runs only
+  // validation and algebrization, skipping the parser and analyzer. The
+  // returned PreparedQuerySnapshot (like <catalog> and <type_factory>) must
+  // outlive any such PreparedQuery.
+  static zetasql_base::StatusOr<std::unique_ptr<PreparedQuerySnapshot>> LoadSnapshot(
+      const PreparedQuerySnapshotProto& snapshot, Catalog* catalog,
+      TypeFactory* type_factory);
+
  private:
   friend class PreparedQueryTest;
 
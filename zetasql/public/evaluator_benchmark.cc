@@ -0,0 +1,276 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Macro-benchmarks for the full query pipeline: AnalyzeStatement, algebrizing
+// the resolved AST, and executing the compiled plan, all driven through
+// PreparedQuery. The workload is a set of TPC-H-flavored queries (pricing
+// summary, top-orders join, forecast revenue filter) over SimpleTables with
+// deterministically generated contents, so changes anywhere in the pipeline
+// show up against a stable yardstick. Run with e.g.:
+//   bazel run -c opt //zetasql/public:evaluator_benchmark
+//
+// Three benchmark families report per-phase cost:
+// - BM_Prepare* times parsing, analysis and algebrization only.
+// - BM_Execute* times execution of an already-prepared query; the benchmark
+//   argument scales the table contents (see kLineitemRowsPerScale). Items
+//   per second counts input rows scanned, and the peak_memory_bytes counter
+//   reports the peak accounted intermediate memory of an execution (measured
+//   outside the timed loop, since collecting operator stats has a cost).
+// - BM_EndToEnd* times the entire pipeline per iteration.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "zetasql/base/logging.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/evaluator.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/base/status.h"
+#include "zetasql/base/statusor.h"
+
+namespace zetasql {
+namespace {
+
+// Table sizes for benchmark argument 1. Real TPC-H row counts (6M lineitems
+// at scale factor 1) would make iterations far too slow for a benchmark;
+// these keep the same ~4:1 lineitem:orders shape at benchmark-friendly sizes.
+constexpr int kLineitemRowsPerScale = 2000;
+constexpr int kOrdersRowsPerScale = 500;
+
+// TPC-H Q1 flavor: scan, filter, aggregate with a small group-by key, sort.
+constexpr char kPricingSummarySql[] = R"(
+    SELECT l_returnflag, l_linestatus,
+           SUM(l_quantity) AS sum_qty,
+           SUM(l_extendedprice) AS sum_base_price,
+           SUM(l_extendedprice * (1 - l_discount)) AS sum_disc_price,
+           AVG(l_quantity) AS avg_qty,
+           COUNT(*) AS count_order
+    FROM Lineitem
+    WHERE l_shipdate <= 10250
+    GROUP BY l_returnflag, l_linestatus
+    ORDER BY l_returnflag, l_linestatus)";
+
+// TPC-H Q3 flavor: join, aggregate with a large group-by key, top-k sort.
+constexpr char kTopOrdersSql[] = R"(
+    SELECT o_orderkey,
+           SUM(l_extendedprice * (1 - l_discount)) AS revenue
+    FROM Orders JOIN Lineitem ON l_orderkey = o_orderkey
+    WHERE o_orderpriority = '1-URGENT'
+    GROUP BY o_orderkey
+    ORDER BY revenue DESC
+    LIMIT 10)";
+
+// TPC-H Q6 flavor: scan with a selective filter and a scalar aggregate.
+constexpr char kForecastRevenueSql[] = R"(
+    SELECT SUM(l_extendedprice * l_discount) AS revenue
+    FROM Lineitem
+    WHERE l_shipdate >= 8766 AND l_shipdate < 9131
+      AND l_discount BETWEEN 0.05 AND 0.07
+      AND l_quantity < 24)";
+
+// Owns the benchmark tables and a catalog containing them. The contents are
+// a pure function of 'scale', so runs are comparable.
+class BenchmarkCatalog {
+ public:
+  explicit BenchmarkCatalog(int scale)
+      : lineitem_("Lineitem", {{"l_orderkey", types::Int64Type()},
+                               {"l_quantity", types::Int64Type()},
+                               {"l_extendedprice", types::DoubleType()},
+                               {"l_discount", types::DoubleType()},
+                               {"l_shipdate", types::Int64Type()},
+                               {"l_returnflag", types::StringType()},
+                               {"l_linestatus", types::StringType()}}),
+        orders_("Orders", {{"o_orderkey", types::Int64Type()},
+                           {"o_custkey", types::Int64Type()},
+                           {"o_orderpriority", types::StringType()}}),
+        catalog_("tpch_benchmark") {
+    static const char* const kReturnFlags[] = {"A", "N", "R"};
+    static const char* const kLineStatuses[] = {"O", "F"};
+    static const char* const kPriorities[] = {"1-URGENT", "2-HIGH", "3-MEDIUM",
+                                              "4-NOT SPECIFIED", "5-LOW"};
+
+    num_lineitem_rows_ = static_cast<int64_t>(kLineitemRowsPerScale) * scale;
+    const int64_t num_orders_rows =
+        static_cast<int64_t>(kOrdersRowsPerScale) * scale;
+
+    std::vector<std::vector<Value>> lineitem_rows;
+    lineitem_rows.reserve(num_lineitem_rows_);
+    for (int64_t i = 0; i < num_lineitem_rows_; ++i) {
+      lineitem_rows.push_back(
+          {Value::Int64(i / 4),             // ~4 line items per order
+           Value::Int64(1 + (i * 7) % 50),  // quantity
+           Value::Double(900.0 + (i * 13) % 10000),  // extended price
+           Value::Double(((i * 3) % 11) / 100.0),    // discount: 0.00-0.10
+           Value::Int64(8000 + (i * 17) % 2500),     // ship date, in days
+           Value::String(kReturnFlags[i % 3]),
+           Value::String(kLineStatuses[i % 2])});
+    }
+    lineitem_.SetContents(lineitem_rows);
+
+    std::vector<std::vector<Value>> orders_rows;
+    orders_rows.reserve(num_orders_rows);
+    for (int64_t i = 0; i < num_orders_rows; ++i) {
+      orders_rows.push_back({Value::Int64(i),
+                             Value::Int64((i * 31) % (num_orders_rows / 10 + 1)),
+                             Value::String(kPriorities[i % 5])});
+    }
+    orders_.SetContents(orders_rows);
+
+    catalog_.AddZetaSQLFunctions();
+    catalog_.AddTable(lineitem_.Name(), &lineitem_);
+    catalog_.AddTable(orders_.Name(), &orders_);
+  }
+
+  SimpleCatalog* catalog() { return &catalog_; }
+
+  // The number of Lineitem rows; every benchmark query scans all of them, so
+  // this is the items-per-iteration count.
+  int64_t num_lineitem_rows() const { return num_lineitem_rows_; }
+
+ private:
+  SimpleTable lineitem_;
+  SimpleTable orders_;
+  SimpleCatalog catalog_;
+  int64_t num_lineitem_rows_;
+};
+
+// Executes 'query' and drains the result, returning the number of output
+// rows.
+int64_t ExecuteAndDrain(PreparedQuery* query) {
+  auto status_or_iter = query->Execute();
+  ZETASQL_CHECK_OK(status_or_iter.status());
+  std::unique_ptr<EvaluatorTableIterator> iter =
+      std::move(status_or_iter).ValueOrDie();
+  int64_t num_rows = 0;
+  while (iter->NextRow()) {
+    benchmark::DoNotOptimize(iter->GetValue(0));
+    ++num_rows;
+  }
+  ZETASQL_CHECK_OK(iter->Status());
+  return num_rows;
+}
+
+// Times parsing, analysis and algebrization of 'sql' (everything up to, but
+// not including, execution). Table contents do not matter here, so a small
+// scale is used.
+void RunPrepare(benchmark::State& state, const std::string& sql) {
+  BenchmarkCatalog benchmark_catalog(/*scale=*/1);
+  for (auto _ : state) {
+    PreparedQuery query(sql, EvaluatorOptions());
+    ZETASQL_CHECK_OK(query.Prepare(AnalyzerOptions(), benchmark_catalog.catalog()));
+  }
+}
+
+// Times execution of 'sql', prepared once outside the timed loop, over
+// tables scaled by the benchmark argument. Reports input rows per second, the
+// number of output rows, and the peak accounted intermediate memory of an
+// execution.
+void RunExecute(benchmark::State& state, const std::string& sql) {
+  BenchmarkCatalog benchmark_catalog(state.range(0));
+  PreparedQuery query(sql, EvaluatorOptions());
+  ZETASQL_CHECK_OK(query.Prepare(AnalyzerOptions(), benchmark_catalog.catalog()));
+
+  int64_t num_output_rows = 0;
+  for (auto _ : state) {
+    num_output_rows = ExecuteAndDrain(&query);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          benchmark_catalog.num_lineitem_rows());
+  state.counters["output_rows"] = num_output_rows;
+
+  // Measure the peak accounted intermediate memory with a separate,
+  // stats-collecting query so that the timed loop does not pay for the
+  // collection.
+  EvaluatorOptions stats_options;
+  stats_options.collect_operator_stats = true;
+  PreparedQuery stats_query(sql, stats_options);
+  ZETASQL_CHECK_OK(
+      stats_query.Prepare(AnalyzerOptions(), benchmark_catalog.catalog()));
+  ExecuteAndDrain(&stats_query);
+  auto status_or_peak_bytes = stats_query.GetPeakMemoryBytesAfterExecute();
+  ZETASQL_CHECK_OK(status_or_peak_bytes.status());
+  state.counters["peak_memory_bytes"] = status_or_peak_bytes.ValueOrDie();
+}
+
+// Times the entire pipeline, from SQL text to drained result, as an embedder
+// issuing ad-hoc queries would experience it.
+void RunEndToEnd(benchmark::State& state, const std::string& sql) {
+  BenchmarkCatalog benchmark_catalog(state.range(0));
+  for (auto _ : state) {
+    PreparedQuery query(sql, EvaluatorOptions());
+    ZETASQL_CHECK_OK(query.Prepare(AnalyzerOptions(), benchmark_catalog.catalog()));
+    ExecuteAndDrain(&query);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          benchmark_catalog.num_lineitem_rows());
+}
+
+void BM_PreparePricingSummary(benchmark::State& state) {
+  RunPrepare(state, kPricingSummarySql);
+}
+BENCHMARK(BM_PreparePricingSummary);
+
+void BM_PrepareTopOrders(benchmark::State& state) {
+  RunPrepare(state, kTopOrdersSql);
+}
+BENCHMARK(BM_PrepareTopOrders);
+
+void BM_PrepareForecastRevenue(benchmark::State& state) {
+  RunPrepare(state, kForecastRevenueSql);
+}
+BENCHMARK(BM_PrepareForecastRevenue);
+
+void BM_ExecutePricingSummary(benchmark::State& state) {
+  RunExecute(state, kPricingSummarySql);
+}
+BENCHMARK(BM_ExecutePricingSummary)->Arg(1)->Arg(8);
+
+void BM_ExecuteTopOrders(benchmark::State& state) {
+  RunExecute(state, kTopOrdersSql);
+}
+BENCHMARK(BM_ExecuteTopOrders)->Arg(1)->Arg(8);
+
+void BM_ExecuteForecastRevenue(benchmark::State& state) {
+  RunExecute(state, kForecastRevenueSql);
+}
+BENCHMARK(BM_ExecuteForecastRevenue)->Arg(1)->Arg(8);
+
+void BM_EndToEndPricingSummary(benchmark::State& state) {
+  RunEndToEnd(state, kPricingSummarySql);
+}
+BENCHMARK(BM_EndToEndPricingSummary)->Arg(1);
+
+void BM_EndToEndTopOrders(benchmark::State& state) {
+  RunEndToEnd(state, kTopOrdersSql);
+}
+BENCHMARK(BM_EndToEndTopOrders)->Arg(1);
+
+void BM_EndToEndForecastRevenue(benchmark::State& state) {
+  RunEndToEnd(state, kForecastRevenueSql);
+}
+BENCHMARK(BM_EndToEndForecastRevenue)->Arg(1);
+
+}  // namespace
+}  // namespace zetasql
+
+BENCHMARK_MAIN();
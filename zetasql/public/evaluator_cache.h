@@ -0,0 +1,159 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_EVALUATOR_CACHE_H_
+#define ZETASQL_PUBLIC_EVALUATOR_CACHE_H_
+
+// An LRU cache of prepared statements, for callers that repeatedly evaluate
+// the same ad-hoc SQL. For small inputs the analyze+algebrize cost of
+// Prepare() often dwarfs the cost of Execute(), so re-preparing identical
+// statements on every evaluation wastes most of the evaluation budget.
+//
+// Example:
+//   PreparedExpressionCache cache(/*max_entries=*/512);
+//   ZETASQL_ASSIGN_OR_RETURN(
+//       std::shared_ptr<PreparedExpression> expression,
+//       cache.Get("col > 1", /*generation_token=*/"v1", analyzer_options,
+//                 &catalog, EvaluatorOptions()));
+//   ZETASQL_ASSIGN_OR_RETURN(Value value, expression->Execute(columns));
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/evaluator.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "zetasql/base/status_macros.h"
+#include "zetasql/base/statusor.h"
+
+namespace zetasql {
+
+// Caches prepared statements of type PreparedT (PreparedExpression or
+// PreparedQuery; use the aliases below) keyed by SQL text and a
+// caller-supplied generation token, evicting the least recently used entry
+// when there are more than 'max_entries'.
+//
+// The cache cannot detect changes to the catalog or to the AnalyzerOptions,
+// so the caller must pass a new generation token whenever either changes
+// (e.g., a counter bumped on catalog updates). Entries prepared under other
+// tokens then stop being returned and eventually fall out of the cache in LRU
+// order.
+//
+// The returned statements are shared with the cache and must not be
+// re-Prepare()d by the caller. Execute() on a prepared statement is
+// thread-safe, so a cached entry may be used by many threads at once, and
+// this class itself is thread-safe.
+template <typename PreparedT>
+class PreparedCache {
+ public:
+  explicit PreparedCache(int64_t max_entries) : max_entries_(max_entries) {
+    DCHECK_GT(max_entries, 0);
+  }
+  PreparedCache(const PreparedCache&) = delete;
+  PreparedCache& operator=(const PreparedCache&) = delete;
+
+  // Returns the cached statement for 'sql' and 'generation_token', preparing
+  // one with 'analyzer_options', 'catalog', and 'evaluator_options' and
+  // inserting it on a miss. On a miss, 'catalog' must outlive the returned
+  // statement (which may live until the entry is evicted and the last caller
+  // drops its reference); on a hit, 'catalog' and the option arguments are
+  // unused.
+  zetasql_base::StatusOr<std::shared_ptr<PreparedT>> Get(
+      const std::string& sql, const std::string& generation_token,
+      const AnalyzerOptions& analyzer_options, Catalog* catalog,
+      const EvaluatorOptions& evaluator_options) LOCKS_EXCLUDED(mutex_) {
+    const std::string key = MakeKey(sql, generation_token);
+    {
+      absl::MutexLock l(&mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_pos);
+        return it->second.prepared;
+      }
+    }
+    // Prepare without holding the mutex so that concurrent misses (for
+    // different statements) do not serialize on each other.
+    auto prepared = std::make_shared<PreparedT>(sql, evaluator_options);
+    ZETASQL_RETURN_IF_ERROR(prepared->Prepare(analyzer_options, catalog));
+
+    absl::MutexLock l(&mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      // Another thread prepared the same statement concurrently. Keep its
+      // entry and discard ours.
+      lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_pos);
+      return it->second.prepared;
+    }
+    lru_keys_.push_front(key);
+    entries_.emplace(key, Entry{prepared, lru_keys_.begin()});
+    if (static_cast<int64_t>(entries_.size()) > max_entries_) {
+      entries_.erase(lru_keys_.back());
+      lru_keys_.pop_back();
+    }
+    return prepared;
+  }
+
+  // Removes all entries. Statements returned by Get() remain valid as long as
+  // callers hold references to them.
+  void Clear() LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock l(&mutex_);
+    entries_.clear();
+    lru_keys_.clear();
+  }
+
+  int64_t num_entries() const LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock l(&mutex_);
+    return entries_.size();
+  }
+
+ private:
+  // The token cannot contain the separator, so the key is unambiguous for any
+  // 'sql'.
+  static std::string MakeKey(const std::string& sql,
+                             const std::string& generation_token) {
+    DCHECK_EQ(generation_token.find('\0'), std::string::npos);
+    return absl::StrCat(generation_token, absl::string_view("\0", 1), sql);
+  }
+
+  struct Entry {
+    std::shared_ptr<PreparedT> prepared;
+    // Position of this entry's key in 'lru_keys_'.
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  const int64_t max_entries_;
+
+  mutable absl::Mutex mutex_;
+  // Keys in order from most to least recently used.
+  std::list<std::string> lru_keys_ GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, Entry> entries_ GUARDED_BY(mutex_);
+};
+
+using PreparedExpressionCache = PreparedCache<PreparedExpression>;
+using PreparedQueryCache = PreparedCache<PreparedQuery>;
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_EVALUATOR_CACHE_H_
@@ -0,0 +1,129 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/evaluator_cache.h"
+
+#include <memory>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::_;
+using ::zetasql_base::testing::StatusIs;
+
+TEST(PreparedExpressionCacheTest, HitReturnsSharedStatement) {
+  PreparedExpressionCache cache(/*max_entries=*/2);
+  const AnalyzerOptions options;
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> expression,
+      cache.Get("1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(Value value, expression->Execute());
+  EXPECT_EQ(value, Value::Int64(3));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> second,
+      cache.Get("1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  EXPECT_EQ(second.get(), expression.get());
+  EXPECT_EQ(cache.num_entries(), 1);
+}
+
+TEST(PreparedExpressionCacheTest, NewGenerationTokenRePrepares) {
+  PreparedExpressionCache cache(/*max_entries=*/2);
+  const AnalyzerOptions options;
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> first,
+      cache.Get("1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> second,
+      cache.Get("1 + 2", /*generation_token=*/"g2", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  EXPECT_NE(second.get(), first.get());
+  EXPECT_EQ(cache.num_entries(), 2);
+}
+
+TEST(PreparedExpressionCacheTest, EvictsLeastRecentlyUsed) {
+  PreparedExpressionCache cache(/*max_entries=*/1);
+  const AnalyzerOptions options;
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> first,
+      cache.Get("1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  ZETASQL_ASSERT_OK(cache.Get("3 + 4", /*generation_token=*/"g1", options,
+                      /*catalog=*/nullptr, EvaluatorOptions())
+                .status());
+  EXPECT_EQ(cache.num_entries(), 1);
+
+  // The first statement was evicted, so getting it again re-prepares it. The
+  // evicted statement remains usable through the reference we still hold.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedExpression> reprepared,
+      cache.Get("1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  EXPECT_NE(reprepared.get(), first.get());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(Value value, first->Execute());
+  EXPECT_EQ(value, Value::Int64(3));
+}
+
+TEST(PreparedExpressionCacheTest, FailedPrepareIsNotCached) {
+  PreparedExpressionCache cache(/*max_entries=*/2);
+  const AnalyzerOptions options;
+
+  EXPECT_THAT(cache
+                  .Get("this is not an expression",
+                       /*generation_token=*/"g1", options,
+                       /*catalog=*/nullptr, EvaluatorOptions())
+                  .status(),
+              StatusIs(zetasql_base::INVALID_ARGUMENT, _));
+  EXPECT_EQ(cache.num_entries(), 0);
+}
+
+TEST(PreparedQueryCacheTest, CachesQueries) {
+  PreparedQueryCache cache(/*max_entries=*/2);
+  const AnalyzerOptions options;
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedQuery> query,
+      cache.Get("select 1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query->Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Value::Int64(3));
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_ASSERT_OK(iter->Status());
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<PreparedQuery> second,
+      cache.Get("select 1 + 2", /*generation_token=*/"g1", options,
+                /*catalog=*/nullptr, EvaluatorOptions()));
+  EXPECT_EQ(second.get(), query.get());
+  EXPECT_EQ(cache.num_entries(), 1);
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,109 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <memory>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/evaluator.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/prepared_query_snapshot.pb.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+TEST(PreparedQuerySnapshotTest, RoundTrip) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.type_factory = &type_factory;
+
+  // One process prepares the query and writes the snapshot.
+  PreparedQuery query("select 1 + 2 as x, concat('ab', 'c') as y",
+                      evaluator_options);
+  ZETASQL_ASSERT_OK(query.Prepare(analyzer_options, &catalog));
+
+  PreparedQuerySnapshotProto snapshot_proto;
+  ZETASQL_ASSERT_OK(query.ToSnapshot(&snapshot_proto));
+  EXPECT_EQ(snapshot_proto.snapshot_version(),
+            PreparedQuery::kSnapshotVersion);
+  EXPECT_TRUE(snapshot_proto.has_resolved_statement());
+
+  // Another process loads it and prepares without parsing or analyzing.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PreparedQuerySnapshot> snapshot,
+      PreparedQuery::LoadSnapshot(snapshot_proto, &catalog, &type_factory));
+  ASSERT_NE(snapshot->stmt(), nullptr);
+
+  PreparedQuery loaded_query(snapshot->stmt(), evaluator_options);
+  ZETASQL_ASSERT_OK(loaded_query.Prepare(analyzer_options, &catalog));
+  ASSERT_EQ(loaded_query.num_columns(), 2);
+  EXPECT_EQ(loaded_query.column_name(0), "x");
+  EXPECT_EQ(loaded_query.column_name(1), "y");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       loaded_query.Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(iter->GetValue(0), Value::Int64(3));
+  EXPECT_EQ(iter->GetValue(1), Value::String("abc"));
+  ASSERT_FALSE(iter->NextRow());
+  ZETASQL_ASSERT_OK(iter->Status());
+}
+
+TEST(PreparedQuerySnapshotTest, RejectsUnknownVersion) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+
+  PreparedQuerySnapshotProto snapshot_proto;
+  snapshot_proto.set_snapshot_version(PreparedQuery::kSnapshotVersion + 1);
+  EXPECT_THAT(
+      PreparedQuery::LoadSnapshot(snapshot_proto, &catalog, &type_factory)
+          .status(),
+      StatusIs(zetasql_base::INVALID_ARGUMENT, HasSubstr("snapshot version")));
+}
+
+TEST(PreparedQuerySnapshotTest, ToSnapshotClearsPreviousContents) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.type_factory = &type_factory;
+
+  PreparedQuery query("select 1 as x", evaluator_options);
+  ZETASQL_ASSERT_OK(query.Prepare(analyzer_options, &catalog));
+
+  PreparedQuerySnapshotProto snapshot_proto;
+  snapshot_proto.add_file_descriptor_set();
+  ZETASQL_ASSERT_OK(query.ToSnapshot(&snapshot_proto));
+  // The query references no proto or enum types, so the stale set is gone.
+  EXPECT_EQ(snapshot_proto.file_descriptor_set_size(), 0);
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -20,6 +20,8 @@
 #define ZETASQL_PUBLIC_EVALUATOR_TABLE_ITERATOR_H_
 
 #include "zetasql/public/value.h"
+#include "zetasql/public/value_batch.h"
+#include "absl/types/optional.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -128,6 +130,19 @@ class EvaluatorTableIterator {
     return zetasql_base::OkStatus();
   }
 
+  // Returns a best-effort estimate of the number of rows this iterator will
+  // return, or absl::nullopt if no estimate is available (the default). The
+  // estimate is only a hint: the evaluator may use it to make performance
+  // decisions (e.g., which side of a hash join to load into memory), and it
+  // never affects query results. It is read before the first call to
+  // NextRow().
+  //
+  // This method should return quickly. All non-trivial processing should be
+  // done by NextRow().
+  virtual absl::optional<int64_t> ApproximateRowCount() const {
+    return absl::nullopt;
+  }
+
   // Returns false if there is no next row. The caller must then check
   // 'Status()'. If NextRow() returns false, the only allowed operations on this
   // iterator are NumColumns(), GetColumnName(), GetColumnType(), and Status().
@@ -139,6 +154,31 @@ class EvaluatorTableIterator {
   // returned true.
   virtual const Value& GetValue(int i) const = 0;
 
+  // Reads up to 'max_rows' rows into 'batch', whose columns must match this
+  // iterator's columns in number and type.  Any previous contents of 'batch'
+  // are discarded.  Returns false if no rows were read; the caller must then
+  // check 'Status()'.  May not be mixed with NextRow() calls on the same
+  // iterator.
+  //
+  // Implementations backed by columnar storage should override this to fill
+  // 'batch' directly (e.g. with memcpy of column segments), which avoids
+  // constructing a Value per cell.  The default implementation falls back to
+  // NextRow()/GetValue().
+  virtual bool NextBatch(int max_rows, ValueBatch* batch) {
+    DCHECK_EQ(batch->num_columns(), NumColumns());
+    batch->Clear();
+    batch->Reserve(max_rows);
+    // Count rows locally; 'batch' cannot track them for zero-column scans.
+    int rows_read = 0;
+    while (rows_read < max_rows && NextRow()) {
+      for (int i = 0; i < NumColumns(); ++i) {
+        batch->mutable_column(i)->Append(GetValue(i));
+      }
+      ++rows_read;
+    }
+    return rows_read > 0;
+  }
+
   // Returns OK unless the last call to NextRow() returned false because of an
   // error (including cancellation).
   virtual zetasql_base::Status Status() const = 0;
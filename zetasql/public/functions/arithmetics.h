@@ -56,6 +56,22 @@
 #define __has_builtin(x) 0
 #endif
 
+// The __builtin_*_overflow intrinsics compute the infinite-precision result
+// and report whether it fits in the output type, which compilers lower to the
+// hardware overflow flag instead of the explicit range checks in
+// arithmetics_internal.h. GCC has supported them since version 5 but only
+// gained __has_builtin in version 10, so test the compiler version there.
+#if defined(__clang__)
+#define ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS     \
+  (__has_builtin(__builtin_add_overflow) &&        \
+   __has_builtin(__builtin_sub_overflow) &&        \
+   __has_builtin(__builtin_mul_overflow))
+#elif defined(__GNUC__) && __GNUC__ >= 5
+#define ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS 1
+#else
+#define ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS 0
+#endif
+
 namespace zetasql {
 namespace functions {
 
@@ -211,32 +227,56 @@ inline bool CheckSaturatedOverflow(T in1, T in2,
 
 template <typename T>
 bool Add(T in1, T in2, T* out, zetasql_base::Status* error) {
+#if ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS
+  if (ABSL_PREDICT_TRUE(!__builtin_add_overflow(in1, in2, out))) {
+    return true;
+  }
+  return internal::UpdateError(
+      error, internal::BinaryOverflowMessage(in1, in2, " + "));
+#else
   arithmetics_internal::Saturated<T> result(internal::safe_cast<T>(in1));
   result.Add(internal::safe_cast<T>(in2));
   *out = result.Value();
   return arithmetics_internal::CheckSaturatedOverflow(in1, in2, " + ", result,
                                                       out, error);
+#endif
 }
 
 template <>
 inline bool Subtract<int64_t>(int64_t in1, int64_t in2, int64_t* out,
                             zetasql_base::Status* error) {
+#if ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS
+  if (ABSL_PREDICT_TRUE(!__builtin_sub_overflow(in1, in2, out))) {
+    return true;
+  }
+  return internal::UpdateError(
+      error, internal::BinaryOverflowMessage(in1, in2, " - "));
+#else
   arithmetics_internal::Saturated<int64_t> result(
       internal::safe_cast<int64_t>(in1));
   result.Sub(internal::safe_cast<int64_t>(in2));
   *out = result.Value();
   return arithmetics_internal::CheckSaturatedOverflow(in1, in2, " - ", result,
                                                       out, error);
+#endif
 }
 
 template <typename T>
 inline bool Multiply(T in1, T in2, T *out,
                      zetasql_base::Status* error) {
+#if ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS
+  if (ABSL_PREDICT_TRUE(!__builtin_mul_overflow(in1, in2, out))) {
+    return true;
+  }
+  return internal::UpdateError(
+      error, internal::BinaryOverflowMessage(in1, in2, " * "));
+#else
   arithmetics_internal::Saturated<T> result(internal::safe_cast<T>(in1));
   result.Mul(internal::safe_cast<T>(in2));
   *out = result.Value();
   return arithmetics_internal::CheckSaturatedOverflow(in1, in2, " * ", result,
                                                       out, error);
+#endif
 }
 
 template <typename T>
@@ -284,6 +324,15 @@ inline bool UnaryMinus<int64_t, int64_t>(int64_t in, int64_t* out,
 template <>
 inline bool Subtract<uint64_t, int64_t>(uint64_t in1, uint64_t in2, int64_t *out,
                                     zetasql_base::Status* error) {
+#if ZETASQL_INTERNAL_HAS_OVERFLOW_BUILTINS
+  // The builtin checks whether the exact value of in1 - in2 is representable
+  // as int64_t, which is precisely the required semantics.
+  if (ABSL_PREDICT_TRUE(!__builtin_sub_overflow(in1, in2, out))) {
+    return true;
+  }
+  return internal::UpdateError(
+      error, internal::BinaryOverflowMessage(in1, in2, " - "));
+#else
   if (in1 >= in2) {
     uint64_t tmp = in1 - in2;
     if (!Convert<uint64_t, int64_t>(tmp, out, nullptr)) {
@@ -305,6 +354,7 @@ inline bool Subtract<uint64_t, int64_t>(uint64_t in1, uint64_t in2, int64_t *out
         error, internal::BinaryOverflowMessage(in1, in2, " - "));
   }
   return true;
+#endif
 }
 
 // TODO: Non-ZetaSQL-compliant temporary signature for
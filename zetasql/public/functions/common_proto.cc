@@ -18,13 +18,17 @@
 
 #include <string>
 
+#include "google/protobuf/timestamp.pb.h"
+#include "google/type/date.pb.h"
 #include "google/type/timeofday.pb.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/public/civil_time.h"
 #include "zetasql/public/functions/date_time_util.h"
 #include <cstdint>
+#include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_builder.h"
+#include "zetasql/base/status_macros.h"
 
 namespace zetasql {
 namespace functions {
@@ -84,5 +88,59 @@ zetasql_base::Status ConvertProto3TimeOfDayToTime(const google::type::TimeOfDay&
   return ::zetasql_base::OkStatus();
 }
 
+zetasql_base::Status ConvertProto3TimestampBytesToTimestamp(absl::string_view bytes,
+                                                    TimestampScale scale,
+                                                    int64_t* output) {
+  google::protobuf::Timestamp timestamp;
+  if (!timestamp.ParseFromArray(bytes.data(), bytes.size())) {
+    return MakeEvalError()
+           << "Invalid serialized google.protobuf.Timestamp input";
+  }
+  return ConvertProto3TimestampToTimestamp(timestamp, scale, output);
+}
+
+zetasql_base::Status ConvertTimestampToProto3TimestampBytes(int64_t input,
+                                                    TimestampScale scale,
+                                                    std::string* output) {
+  google::protobuf::Timestamp timestamp;
+  ZETASQL_RETURN_IF_ERROR(ConvertTimestampToProto3Timestamp(input, scale, &timestamp));
+  ZETASQL_RET_CHECK(timestamp.SerializeToString(output));
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ConvertProto3DateBytesToDate(absl::string_view bytes,
+                                          int32_t* output) {
+  google::type::Date date;
+  if (!date.ParseFromArray(bytes.data(), bytes.size())) {
+    return MakeEvalError() << "Invalid serialized google.type.Date input";
+  }
+  return ConvertProto3DateToDate(date, output);
+}
+
+zetasql_base::Status ConvertDateToProto3DateBytes(int32_t input, std::string* output) {
+  google::type::Date date;
+  ZETASQL_RETURN_IF_ERROR(ConvertDateToProto3Date(input, &date));
+  ZETASQL_RET_CHECK(date.SerializeToString(output));
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ConvertProto3TimeOfDayBytesToTime(absl::string_view bytes,
+                                               TimestampScale scale,
+                                               TimeValue* output) {
+  google::type::TimeOfDay time_of_day;
+  if (!time_of_day.ParseFromArray(bytes.data(), bytes.size())) {
+    return MakeEvalError() << "Invalid serialized google.type.TimeOfDay input";
+  }
+  return ConvertProto3TimeOfDayToTime(time_of_day, scale, output);
+}
+
+zetasql_base::Status ConvertTimeToProto3TimeOfDayBytes(TimeValue input,
+                                               std::string* output) {
+  google::type::TimeOfDay time_of_day;
+  ZETASQL_RETURN_IF_ERROR(ConvertTimeToProto3TimeOfDay(input, &time_of_day));
+  ZETASQL_RET_CHECK(time_of_day.SerializeToString(output));
+  return ::zetasql_base::OkStatus();
+}
+
 }  // namespace functions
 }  // namespace zetasql
@@ -28,6 +28,7 @@
 #include "google/protobuf/wrappers.pb.h"
 #include "google/type/latlng.pb.h"
 #include "google/type/timeofday.pb.h"
+#include "absl/strings/string_view.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/utf_util.h"
 #include "zetasql/public/civil_time.h"
@@ -66,6 +67,46 @@ zetasql_base::Status ConvertProto3TimeOfDayToTime(const google::type::TimeOfDay&
                                           TimestampScale scale,
                                           TimeValue* output);
 
+// The functions below convert directly between serialized messages of the
+// fixed proto3 shapes (google.protobuf.Timestamp, google.type.Date and
+// google.type.TimeOfDay) and ZetaSQL values.  The bytes are parsed into and
+// serialized from the generated message classes, so callers holding a proto
+// Value's bytes (e.g. cast implementations and evaluator function kernels)
+// can bridge to civil types without constructing a DynamicMessage for the
+// value's own descriptor.  This is safe for messages from any DescriptorPool
+// because the wire format depends only on the field numbers, which are fixed
+// for these types.
+
+// Converts a serialized google.protobuf.Timestamp to a timestamp value at
+// <scale>.  Returns an error if <bytes> does not parse or the timestamp is
+// out of range.
+zetasql_base::Status ConvertProto3TimestampBytesToTimestamp(absl::string_view bytes,
+                                                    TimestampScale scale,
+                                                    int64_t* output);
+
+// Converts a timestamp value at <scale> to a serialized
+// google.protobuf.Timestamp.
+zetasql_base::Status ConvertTimestampToProto3TimestampBytes(int64_t input,
+                                                    TimestampScale scale,
+                                                    std::string* output);
+
+// Converts a serialized google.type.Date to a date value.
+zetasql_base::Status ConvertProto3DateBytesToDate(absl::string_view bytes,
+                                          int32_t* output);
+
+// Converts a date value to a serialized google.type.Date.
+zetasql_base::Status ConvertDateToProto3DateBytes(int32_t input, std::string* output);
+
+// Converts a serialized google.type.TimeOfDay to a ZetaSQL TimeValue at
+// <scale>.
+zetasql_base::Status ConvertProto3TimeOfDayBytesToTime(absl::string_view bytes,
+                                               TimestampScale scale,
+                                               TimeValue* output);
+
+// Converts a ZetaSQL TimeValue to a serialized google.type.TimeOfDay.
+zetasql_base::Status ConvertTimeToProto3TimeOfDayBytes(TimeValue input,
+                                               std::string* output);
+
 // Converts a proto3 wrapper for a primitive type (defined
 // in google/protobuf/wrappers.proto) to a ZetaSQL type. Conversion
 // from google::protobuf::StringValue requires the std::string to be a valid UTF-8
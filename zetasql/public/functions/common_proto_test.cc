@@ -18,7 +18,9 @@
 
 #include <string>
 
+#include "google/protobuf/timestamp.pb.h"
 #include "google/protobuf/wrappers.pb.h"
+#include "google/type/date.pb.h"
 #include "google/type/timeofday.pb.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/public/civil_time.h"
@@ -155,6 +157,68 @@ TEST(CommonProtoTest, ConvertTimeOfDayToProto3) {
   }
 }
 
+TEST(CommonProtoTest, ConvertProto3TimestampBytes) {
+  // Round trip a timestamp through serialized google.protobuf.Timestamp and
+  // check consistency with the message-level converters.
+  const int64_t micros = 1514767425123456;  // 2018-01-01 00:43:45.123456 UTC.
+  std::string bytes;
+  ZETASQL_ASSERT_OK(ConvertTimestampToProto3TimestampBytes(micros, kMicroseconds,
+                                                   &bytes));
+  google::protobuf::Timestamp expected;
+  ZETASQL_ASSERT_OK(ConvertTimestampToProto3Timestamp(micros, kMicroseconds,
+                                              &expected));
+  EXPECT_EQ(expected.SerializeAsString(), bytes);
+
+  int64_t output = 0;
+  ZETASQL_ASSERT_OK(ConvertProto3TimestampBytesToTimestamp(bytes, kMicroseconds,
+                                                   &output));
+  EXPECT_EQ(micros, output);
+
+  EXPECT_THAT(ConvertProto3TimestampBytesToTimestamp("\xff", kMicroseconds,
+                                                     &output),
+              zetasql_base::testing::StatusIs(
+                  zetasql_base::OUT_OF_RANGE,
+                  testing::HasSubstr("Invalid serialized")));
+}
+
+TEST(CommonProtoTest, ConvertProto3DateBytes) {
+  const int32_t date = 17532;  // 2018-01-01.
+  std::string bytes;
+  ZETASQL_ASSERT_OK(ConvertDateToProto3DateBytes(date, &bytes));
+  google::type::Date expected;
+  ZETASQL_ASSERT_OK(ConvertDateToProto3Date(date, &expected));
+  EXPECT_EQ(expected.SerializeAsString(), bytes);
+
+  int32_t output = 0;
+  ZETASQL_ASSERT_OK(ConvertProto3DateBytesToDate(bytes, &output));
+  EXPECT_EQ(date, output);
+
+  EXPECT_THAT(ConvertProto3DateBytesToDate("\xff", &output),
+              zetasql_base::testing::StatusIs(
+                  zetasql_base::OUT_OF_RANGE,
+                  testing::HasSubstr("Invalid serialized")));
+}
+
+TEST(CommonProtoTest, ConvertProto3TimeOfDayBytes) {
+  const TimeValue time = TimeValue::FromHMSAndNanos(11, 30, 25, 123456);
+  std::string bytes;
+  ZETASQL_ASSERT_OK(ConvertTimeToProto3TimeOfDayBytes(time, &bytes));
+  google::type::TimeOfDay expected;
+  ZETASQL_ASSERT_OK(ConvertTimeToProto3TimeOfDay(time, &expected));
+  EXPECT_EQ(expected.SerializeAsString(), bytes);
+
+  TimeValue output;
+  ZETASQL_ASSERT_OK(ConvertProto3TimeOfDayBytesToTime(bytes, kNanoseconds, &output));
+  EXPECT_EQ(time.Packed64TimeNanos(), output.Packed64TimeNanos());
+
+  // An out-of-range TimeOfDay still fails validation after a successful parse.
+  google::type::TimeOfDay bad = MakeTimeOfDay(24, 00, 00, 00);
+  EXPECT_THAT(ConvertProto3TimeOfDayBytesToTime(bad.SerializeAsString(),
+                                                kNanoseconds, &output),
+              zetasql_base::testing::StatusIs(zetasql_base::OUT_OF_RANGE,
+                                        testing::HasSubstr("Invalid Proto3")));
+}
+
 TEST(CommonProtoTest, ConvertProto3Wrappers) {
   zetasql_base::Status status;
   google::protobuf::BoolValue bool_proto;
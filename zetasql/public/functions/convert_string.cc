@@ -16,9 +16,13 @@
 
 #include "zetasql/public/functions/convert_string.h"
 
+#include <cstring>
+#include <limits>
+
 #include "zetasql/common/string_util.h"
 #include "zetasql/public/functions/util.h"
 #include "zetasql/base/string_numbers.h"
+#include "absl/base/config.h"
 #include "absl/base/optimization.h"
 #include "zetasql/base/case.h"
 #include "absl/strings/escaping.h"
@@ -61,6 +65,79 @@ bool IsHex(absl::string_view str) {
 constexpr absl::string_view kTrueStringValue = "true";
 constexpr absl::string_view kFalseStringValue = "false";
 
+#ifdef ABSL_IS_LITTLE_ENDIAN
+// Returns true if all eight bytes of 'chars' (loaded little-endian from the
+// input) are ASCII decimal digits.
+bool AreEightDigits(uint64_t chars) {
+  return ((chars & 0xF0F0F0F0F0F0F0F0) |
+          (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// Converts the eight decimal digits in 'chars' to their numeric value.
+// REQUIRES: AreEightDigits(chars).
+uint64_t ParseEightDigits(uint64_t chars) {
+  chars = (chars & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+  chars = (chars & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+  return (chars & 0x0000FFFF0000FFFF) * 42949672960001 >> 32;
+}
+#endif
+
+// Parses 'str' as an unsigned decimal number of at most 'max_digits' digits.
+// Returns false if 'str' is empty, too long, or contains anything but digits.
+// With 'max_digits' at most std::numeric_limits<T>::digits10, the result
+// cannot overflow.
+bool ParseDigits(absl::string_view str, int max_digits, uint64_t* out) {
+  if (str.empty() || str.size() > max_digits) return false;
+  uint64_t result = 0;
+  size_t i = 0;
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  // Consume eight digits per iteration instead of one.
+  uint64_t chars;
+  for (; i + sizeof(chars) <= str.size(); i += sizeof(chars)) {
+    std::memcpy(&chars, str.data() + i, sizeof(chars));
+    if (!AreEightDigits(chars)) return false;
+    result = result * 100000000 + ParseEightDigits(chars);
+  }
+#endif
+  for (; i < str.size(); ++i) {
+    const char c = str[i];
+    if (c < '0' || c > '9') return false;
+    result = result * 10 + (c - '0');
+  }
+  *out = result;
+  return true;
+}
+
+// Fast paths for the common case of CAST from a plain decimal string: no
+// leading spaces, no hex, and few enough digits that overflow is impossible.
+// Return false without modifying '*out' on any other input, leaving it to the
+// general parsers below; they never succeed on input those would reject.
+template <typename T>
+bool FastParseUnsignedDecimal(absl::string_view str, T* out) {
+  uint64_t parsed;
+  if (!ParseDigits(str, std::numeric_limits<T>::digits10, &parsed)) {
+    return false;
+  }
+  *out = static_cast<T>(parsed);
+  return true;
+}
+
+template <typename T>
+bool FastParseSignedDecimal(absl::string_view str, T* out) {
+  bool negative = false;
+  if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+    negative = (str[0] == '-');
+    str.remove_prefix(1);
+  }
+  uint64_t parsed;
+  if (!ParseDigits(str, std::numeric_limits<T>::digits10, &parsed)) {
+    return false;
+  }
+  *out = negative ? -static_cast<T>(parsed) : static_cast<T>(parsed);
+  return true;
+}
+
 }  // anonymous namespace
 
 template <>
@@ -134,6 +211,7 @@ bool StringToNumeric(absl::string_view value, bool* out, zetasql_base::Status* e
 
 template <>
 bool StringToNumeric(absl::string_view value, int32_t* out, zetasql_base::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastParseSignedDecimal(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -147,6 +225,7 @@ bool StringToNumeric(absl::string_view value, int32_t* out, zetasql_base::Status
 
 template <>
 bool StringToNumeric(absl::string_view value, int64_t* out, zetasql_base::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastParseSignedDecimal(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -161,6 +240,7 @@ bool StringToNumeric(absl::string_view value, int64_t* out, zetasql_base::Status
 template <>
 bool StringToNumeric(absl::string_view value, uint32_t* out,
                      zetasql_base::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastParseUnsignedDecimal(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
@@ -175,6 +255,7 @@ bool StringToNumeric(absl::string_view value, uint32_t* out,
 template <>
 bool StringToNumeric(absl::string_view value, uint64_t* out,
                      zetasql_base::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastParseUnsignedDecimal(value, out))) return true;
   TrimLeadingSpaces(&value);
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
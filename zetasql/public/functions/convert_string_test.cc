@@ -146,6 +146,47 @@ void TestLongString() {
   EXPECT_TRUE(absl::EndsWith(error.message(), "\0\0\0..."));
 }
 
+// Exercises the digit-parsing fast path at various lengths, particularly
+// around the eight-character blocks it consumes at a time, and confirms the
+// inputs it rejects still parse through the general path.
+template <typename T>
+void TestDecimalStrings() {
+  zetasql_base::Status error;
+  std::string str;
+  T expected = 0;
+  for (int num_digits = 1; num_digits <= 20; ++num_digits) {
+    const int digit = num_digits % 10;
+    if (expected > (std::numeric_limits<T>::max() - digit) / 10) break;
+    expected = expected * 10 + digit;
+    str.push_back('0' + digit);
+
+    T out;
+    EXPECT_TRUE(StringToNumeric<T>(str, &out, &error)) << "str: " << str;
+    EXPECT_EQ(expected, out) << "str: " << str;
+    if (std::numeric_limits<T>::is_signed) {
+      EXPECT_TRUE(StringToNumeric<T>("-" + str, &out, &error));
+      EXPECT_EQ(-expected, out) << "str: -" << str;
+      EXPECT_TRUE(StringToNumeric<T>("+" + str, &out, &error));
+      EXPECT_EQ(expected, out) << "str: +" << str;
+    }
+    // Leading zeros and spaces are still accepted.
+    EXPECT_TRUE(StringToNumeric<T>("000000000000000000000" + str, &out,
+                                   &error));
+    EXPECT_EQ(expected, out) << "str: " << str;
+    EXPECT_TRUE(StringToNumeric<T>("  " + str, &out, &error));
+    EXPECT_EQ(expected, out) << "str: " << str;
+    // A non-digit anywhere is still an error.
+    for (int i = 0; i <= num_digits; ++i) {
+      std::string bad = str;
+      bad.insert(i, 1, 'e');
+      zetasql_base::Status bad_error;
+      EXPECT_FALSE(StringToNumeric<T>(bad, &out, &bad_error))
+          << "str: " << bad;
+      EXPECT_FALSE(bad_error.ok());
+    }
+  }
+}
+
 template <typename T>
 void TestAll() {
   TestRoundtrip<T>();
@@ -159,18 +200,22 @@ TEST(Convert, TestBool) {
 
 TEST(Convert, TestInt32) {
   TestAll<int32_t>();
+  TestDecimalStrings<int32_t>();
 }
 
 TEST(Convert, TestInt64) {
   TestAll<int64_t>();
+  TestDecimalStrings<int64_t>();
 }
 
 TEST(Convert, TestUint32) {
   TestAll<uint32_t>();
+  TestDecimalStrings<uint32_t>();
 }
 
 TEST(Convert, TestUint64) {
   TestAll<uint64_t>();
+  TestDecimalStrings<uint64_t>();
 }
 
 TEST(Convert, TestFloat) {
@@ -28,14 +28,18 @@
 #include "zetasql/public/functions/arithmetics.h"
 #include "zetasql/public/functions/date_time_util_internal.h"
 #include "zetasql/public/type.h"
+#include "absl/base/config.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/civil_time.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "zetasql/base/mathutil.h"
+#include "zetasql/base/no_destructor.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
 #include "zetasql/base/statusor.h"
@@ -172,12 +176,57 @@ static bool ParseCharacter(absl::string_view str, const char character,
   return true;
 }
 
+#ifdef ABSL_IS_LITTLE_ENDIAN
+// Returns true if every byte of <word> holds an ASCII digit. The nibble
+// checks are byte-local, so there is no carry between bytes to account for.
+static inline bool AllBytesAreDigits(uint64_t word) {
+  // Every byte must be of the form 0x3d ('0'..'9' are 0x30..0x39) ...
+  if ((word & 0xF0F0F0F0F0F0F0F0ull) != 0x3030303030303030ull) return false;
+  // ... with a low nibble of at most 9.
+  return (((word & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull) &
+          0xF0F0F0F0F0F0F0F0ull) == 0;
+}
+
+// Loads 8 bytes of <str> at offset <idx> as a little-endian word. The caller
+// must have checked that 8 bytes remain.
+static inline uint64_t Load64(absl::string_view str, int idx) {
+  uint64_t word;
+  memcpy(&word, str.data() + idx, sizeof(word));
+  return word;
+}
+#endif
+
 // Parse <str> starting at offset <idx> into <year>, <month>, and <day> parts,
 // advancing <idx> to point to the next unparsed digit. The valid format is
 // YYYY-[M]M-[D]D.
 // Returns success or failure.
 static bool ParsePrefixToDateParts(absl::string_view str, int* idx, int* year,
                                    int* month, int* day) {
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  // Fast path for the fixed-width form "YYYY-MM-DD", which is what machine-
+  // generated input (e.g. log ingestion) overwhelmingly produces. One word
+  // load validates "YYYY-MM-" in a few ALU ops; the fields are then read
+  // from fixed offsets. Any other shape falls through to the general
+  // per-character parser below.
+  if (static_cast<int64_t>(str.length()) - *idx >= 10) {
+    const uint64_t word = Load64(str, *idx);
+    // Bytes 4 and 7 are the '-' separators; the rest must be digits.
+    const uint64_t kSeparatorMask = 0xFF000000FF000000ull;
+    const uint64_t kSeparators = 0x2D0000002D000000ull;  // '-' is 0x2D.
+    const char* p = str.data() + *idx;
+    if ((word & kSeparatorMask) == kSeparators &&
+        AllBytesAreDigits((word & ~kSeparatorMask) |
+                          (0x3030303030303030ull & kSeparatorMask)) &&
+        absl::ascii_isdigit(p[8]) && absl::ascii_isdigit(p[9])) {
+      *year = (p[0] - '0') * 1000 + (p[1] - '0') * 100 + (p[2] - '0') * 10 +
+              (p[3] - '0');
+      *month = (p[5] - '0') * 10 + (p[6] - '0');
+      *day = (p[8] - '0') * 10 + (p[9] - '0');
+      *idx += 10;
+      return true;
+    }
+  }
+#endif
   // Minimum required length of a valid date is 8.
   if (!CheckRemainingLength(str, *idx, 8 /* remaining_length */) ||
       !ParseDigits(str, 4, 4, idx, year) ||
@@ -209,14 +258,38 @@ static const int64_t powers_of_ten[] = {1, 10, 100, 1000, 10000, 100000, 1000000
 static bool ParsePrefixToTimeParts(absl::string_view str, TimestampScale scale,
                                    int* idx, int* hour, int* minute,
                                    int* second, int* subsecond) {
-  if (!CheckRemainingLength(str, *idx, 5 /* remaining_length */) ||
-      !ParseDigits(str, 1, 2, idx, hour) ||
-      !CheckRemainingLength(str, *idx, 4 /* remaining_length */) ||
-      !ParseCharacter(str, ':', idx) ||
-      !ParseDigits(str, 1, 2, idx, minute) ||
-      !CheckRemainingLength(str, *idx, 2 /* remaining_length */) ||
-      !ParseCharacter(str, ':', idx) ||
-      !ParseDigits(str, 1, 2, idx, second)) {
+  bool parsed_fixed_width = false;
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  // Fast path for the fixed-width form "HH:MM:SS", which is exactly one
+  // word: one load validates both separators and all six digits, and the
+  // fields are then read from fixed offsets. Variable-width forms like
+  // "1:02:03" fall through to the general per-character parser below.
+  if (static_cast<int64_t>(str.length()) - *idx >= 8) {
+    const uint64_t word = Load64(str, *idx);
+    // Bytes 2 and 5 are the ':' separators; the rest must be digits.
+    const uint64_t kSeparatorMask = 0x0000FF0000FF0000ull;
+    const uint64_t kSeparators = 0x00003A00003A0000ull;  // ':' is 0x3A.
+    if ((word & kSeparatorMask) == kSeparators &&
+        AllBytesAreDigits((word & ~kSeparatorMask) |
+                          (0x3030303030303030ull & kSeparatorMask))) {
+      const char* p = str.data() + *idx;
+      *hour = (p[0] - '0') * 10 + (p[1] - '0');
+      *minute = (p[3] - '0') * 10 + (p[4] - '0');
+      *second = (p[6] - '0') * 10 + (p[7] - '0');
+      *idx += 8;
+      parsed_fixed_width = true;
+    }
+  }
+#endif
+  if (!parsed_fixed_width &&
+      (!CheckRemainingLength(str, *idx, 5 /* remaining_length */) ||
+       !ParseDigits(str, 1, 2, idx, hour) ||
+       !CheckRemainingLength(str, *idx, 4 /* remaining_length */) ||
+       !ParseCharacter(str, ':', idx) ||
+       !ParseDigits(str, 1, 2, idx, minute) ||
+       !CheckRemainingLength(str, *idx, 2 /* remaining_length */) ||
+       !ParseCharacter(str, ':', idx) ||
+       !ParseDigits(str, 1, 2, idx, second))) {
     return false;
   }
   if (*idx >= static_cast<int64_t>(str.length()))
@@ -1149,6 +1222,44 @@ static ::zetasql_base::StatusOr<absl::Weekday> GetFirstWeekDayOfWeek(
   }
 }
 
+// Returns the latest date falling on 'first_day_of_week' that is on or before
+// 'date'. Equivalent to converting to civil time and calling
+// PrevWeekdayOrToday(), but stays in epoch-day arithmetic: epoch day 0
+// (1970-01-01) was a Thursday, so the weekday of any date follows from the
+// date modulo 7. The result may be out of the valid date range (i.e., before
+// 0001-01-01); callers that hand it back to users must range-check it.
+static int32_t PrevWeekdayOrTodayEpochDays(int32_t date,
+                                           absl::Weekday first_day_of_week) {
+  int32_t target = 0;  // The target weekday, as days since Monday.
+  switch (first_day_of_week) {
+    case absl::Weekday::monday:
+      target = 0;
+      break;
+    case absl::Weekday::tuesday:
+      target = 1;
+      break;
+    case absl::Weekday::wednesday:
+      target = 2;
+      break;
+    case absl::Weekday::thursday:
+      target = 3;
+      break;
+    case absl::Weekday::friday:
+      target = 4;
+      break;
+    case absl::Weekday::saturday:
+      target = 5;
+      break;
+    case absl::Weekday::sunday:
+      target = 6;
+      break;
+  }
+  // The weekday of 'date', also as days since Monday. The inner modulus can
+  // be negative for dates before the epoch.
+  const int32_t weekday = ((date + 3) % 7 + 7) % 7;
+  return date - (weekday - target + 7) % 7;
+}
+
 // Does not do bounds checking. base_time (in the given timezone)
 // must be guaranteed valid.
 static zetasql_base::Status ExtractFromTimestampInternal(DateTimestampPart part,
@@ -1302,26 +1413,29 @@ static std::string MakeInvalidTimestampStrErrorMsg(absl::string_view timestamp_s
 }
 
 static zetasql_base::Status TruncateDateImpl(
-    int32_t date, DateTimestampPart part, bool enforce_range, int32_t* output) {
+    int32_t date, DateTimestampPart part, int32_t* output) {
   if (!IsValidDate(date)) {
     return MakeEvalError() << "Invalid date value: " << date;
   }
-  absl::CivilDay civil_day = EpochDaysToCivilDay(date);
   switch (part) {
-    case YEAR:
+    case YEAR: {
+      const absl::CivilDay civil_day = EpochDaysToCivilDay(date);
       *output = CivilDayToEpochDays(absl::CivilDay(civil_day.year(), 1, 1));
       break;
+    }
     case ISOYEAR: {
-      *output = CivilDayToEpochDays(
-          date_time_util_internal::GetFirstDayOfIsoYear(civil_day));
+      *output = CivilDayToEpochDays(date_time_util_internal::GetFirstDayOfIsoYear(
+          EpochDaysToCivilDay(date)));
       break;
     }
     case MONTH: {
+      const absl::CivilDay civil_day = EpochDaysToCivilDay(date);
       *output = CivilDayToEpochDays(
           absl::CivilDay(civil_day.year(), civil_day.month(), 1));
       break;
     }
     case QUARTER: {
+      const absl::CivilDay civil_day = EpochDaysToCivilDay(date);
       int m = civil_day.month();
       m = (m - 1) / 3 * 3 + 1;
       *output = CivilDayToEpochDays(absl::CivilDay(civil_day.year(), m, 1));
@@ -1335,10 +1449,11 @@ static zetasql_base::Status TruncateDateImpl(
     case WEEK_THURSDAY:
     case WEEK_FRIDAY:
     case WEEK_SATURDAY: {
+      // Week truncation needs only the weekday, so it stays in epoch-day
+      // arithmetic rather than converting through civil time.
       ZETASQL_ASSIGN_OR_RETURN(const absl::Weekday first_day_of_week,
                        GetFirstWeekDayOfWeek(part));
-      *output =
-          CivilDayToEpochDays(PrevWeekdayOrToday(civil_day, first_day_of_week));
+      *output = PrevWeekdayOrTodayEpochDays(date, first_day_of_week);
       break;
     }
     case DAY:
@@ -1352,7 +1467,7 @@ static zetasql_base::Status TruncateDateImpl(
   // of bounds (i.e., before 0001-01-01), so we check the truncated date
   // result here. The other date parts do not have the potential to underflow,
   // but we validate the result anyway as a sanity check.
-  if (enforce_range && !IsValidDate(*output)) {
+  if (!IsValidDate(*output)) {
     return MakeEvalError() << "Truncating date " << DateErrorString(date)
                            << " to " << DateTimestampPartToSQL(part)
                            << " resulted in an out of range date value: "
@@ -1988,6 +2103,153 @@ zetasql_base::Status FormatTimestampToString(absl::string_view format_string,
                                  /*expand_quarter=*/true, out);
 }
 
+// Appends 'value', which must be in [0, 99], to 'out' as two digits.
+static void Append02d(int value, std::string* out) {
+  out->push_back('0' + value / 10);
+  out->push_back('0' + value % 10);
+}
+
+DateTimestampFormatPlan::DateTimestampFormatPlan(Mode mode,
+                                                 absl::string_view format_string)
+    : mode_(mode), format_string_(format_string) {
+  // Parse 'format_string' into 'ops'. If we encounter anything that
+  // FormatCivilSecond() does not support, return with 'use_fast_path_' still
+  // false so that formatting uses the general implementation.
+  std::vector<Op> ops;
+  size_t estimated_size = 0;
+  std::string literal;
+  const auto flush_literal = [&ops, &literal, &estimated_size]() {
+    if (!literal.empty()) {
+      estimated_size += literal.size();
+      ops.push_back(Op{Op::kLiteral, std::move(literal)});
+      literal.clear();
+    }
+  };
+  for (size_t i = 0; i < format_string.size(); ++i) {
+    const char c = format_string[i];
+    if (c != '%') {
+      literal.push_back(c);
+      continue;
+    }
+    if (i + 1 >= format_string.size()) return;  // Trailing '%'.
+    Op::Kind kind;
+    switch (format_string[++i]) {
+      case '%':
+        literal.push_back('%');
+        continue;
+      case 'E':
+        // %E4Y is the only extension handled here.
+        if (format_string.substr(i + 1, 2) != "4Y") return;
+        i += 2;
+        kind = Op::kYear4;
+        break;
+      case 'Y':
+        kind = Op::kYear;
+        break;
+      case 'm':
+        kind = Op::kMonth;
+        break;
+      case 'd':
+        kind = Op::kDay;
+        break;
+      case 'H':
+        kind = Op::kHour;
+        break;
+      case 'M':
+        kind = Op::kMinute;
+        break;
+      case 'S':
+        kind = Op::kSecond;
+        break;
+      default:
+        return;  // Unsupported format element.
+    }
+    if (mode_ == Mode::kDate &&
+        (kind == Op::kHour || kind == Op::kMinute || kind == Op::kSecond)) {
+      // FORMAT_DATE escapes time-of-day elements so they pass through as
+      // literal text; let the general implementation handle that.
+      return;
+    }
+    flush_literal();
+    ops.push_back(Op{kind, std::string()});
+    estimated_size += 4;
+  }
+  flush_literal();
+  ops_ = std::move(ops);
+  estimated_size_ = estimated_size;
+  use_fast_path_ = true;
+}
+
+void DateTimestampFormatPlan::FormatCivilSecond(const absl::CivilSecond& cs,
+                                                std::string* out) const {
+  for (const Op& op : ops_) {
+    switch (op.kind) {
+      case Op::kLiteral:
+        out->append(op.literal);
+        break;
+      case Op::kYear:
+        absl::StrAppend(out, cs.year());
+        break;
+      case Op::kYear4: {
+        // The year is in [1, 9999] because the input was validated.
+        const int year = static_cast<int>(cs.year());
+        Append02d(year / 100, out);
+        Append02d(year % 100, out);
+        break;
+      }
+      case Op::kMonth:
+        Append02d(cs.month(), out);
+        break;
+      case Op::kDay:
+        Append02d(cs.day(), out);
+        break;
+      case Op::kHour:
+        Append02d(cs.hour(), out);
+        break;
+      case Op::kMinute:
+        Append02d(cs.minute(), out);
+        break;
+      case Op::kSecond:
+        Append02d(cs.second(), out);
+        break;
+    }
+  }
+}
+
+zetasql_base::Status DateTimestampFormatPlan::FormatTimestamp(
+    int64_t timestamp, absl::TimeZone timezone, std::string* out) const {
+  DCHECK(mode_ == Mode::kTimestamp);
+  if (!use_fast_path_) {
+    return FormatTimestampToString(format_string_, timestamp, timezone, out);
+  }
+  const absl::Time base_time = MakeTime(timestamp, kMicroseconds);
+  if (!IsValidTime(base_time)) {
+    return MakeEvalError() << "Invalid timestamp value: "
+                           << absl::ToUnixMicros(base_time);
+  }
+  out->clear();
+  out->reserve(estimated_size_);
+  FormatCivilSecond(timezone.At(base_time).cs, out);
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status DateTimestampFormatPlan::FormatDate(int32_t date,
+                                                 std::string* out) const {
+  DCHECK(mode_ == Mode::kDate);
+  if (!use_fast_path_) {
+    return FormatDateToString(format_string_, date, out);
+  }
+  if (!IsValidDate(date)) {
+    return MakeEvalError() << "Invalid date value: " << date;
+  }
+  out->clear();
+  out->reserve(estimated_size_);
+  // A date formats like a timestamp at midnight of that date in UTC, whose
+  // civil-time breakdown is just the civil day 'date' days after the epoch.
+  FormatCivilSecond(absl::CivilSecond(absl::CivilDay(1970, 1, 1) + date), out);
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ConvertTimestampToString(absl::Time input, TimestampScale scale,
                                       absl::TimeZone timezone, std::string* output) {
   NarrowTimestampScaleIfPossible(input, &scale);
@@ -2004,6 +2266,27 @@ zetasql_base::Status ConvertTimestampToString(absl::Time input, TimestampScale s
   return ConvertTimestampToString(input, scale, timezone, output);
 }
 
+namespace {
+
+// Cache of named time zones. The time library caches loaded zones internally,
+// but every absl::LoadTimeZone() call still copies the name into a
+// std::string and takes a global lock, which adds up when a timestamp
+// function evaluates its time zone argument once per row. The cache is
+// bounded because time zone names can come from table data.
+struct TimeZoneCache {
+  static constexpr int kMaxSize = 1000;
+
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, absl::TimeZone> zones ABSL_GUARDED_BY(mutex);
+};
+
+TimeZoneCache* GetTimeZoneCache() {
+  static zetasql_base::NoDestructor<TimeZoneCache> cache;
+  return cache.get();
+}
+
+}  // namespace
+
 zetasql_base::Status MakeTimeZone(absl::string_view timezone_string,
                           absl::TimeZone* timezone) {
   // An empty time zone is an error.  There is no inherent default.
@@ -2027,12 +2310,28 @@ zetasql_base::Status MakeTimeZone(absl::string_view timezone_string,
     return ::zetasql_base::OkStatus();
   }
 
-  // Otherwise, try to look the time zone up from the Abseil time library.
-  // This ultimately looks into the zoneinfo directory (typically
-  // /usr/share/zoneinfo, /usr/share/lib/zoneinfo, etc.).
+  // Otherwise, try to look the time zone up from the Abseil time library,
+  // memoizing successful lookups in the cache above. This ultimately looks
+  // into the zoneinfo directory (typically /usr/share/zoneinfo,
+  // /usr/share/lib/zoneinfo, etc.).
+  TimeZoneCache* cache = GetTimeZoneCache();
+  {
+    absl::MutexLock lock(&cache->mutex);
+    const auto it = cache->zones.find(timezone_string);
+    if (it != cache->zones.end()) {
+      *timezone = it->second;
+      return ::zetasql_base::OkStatus();
+    }
+  }
   if (!absl::LoadTimeZone(std::string(timezone_string), timezone)) {
     return MakeEvalError() << "Invalid time zone: " << timezone_string;
   }
+  {
+    absl::MutexLock lock(&cache->mutex);
+    if (cache->zones.size() < TimeZoneCache::kMaxSize) {
+      cache->zones.emplace(timezone_string, *timezone);
+    }
+  }
   return ::zetasql_base::OkStatus();
 }
 
@@ -2818,16 +3117,18 @@ zetasql_base::Status DiffDates(int32_t date1, int32_t date2, DateTimestampPart p
     case WEEK_THURSDAY:
     case WEEK_FRIDAY:
     case WEEK_SATURDAY:
-    case ISOWEEK:
-      // TODO: Refactor the WEEK implementation to not rely on
-      // a hacky version of TruncateDateImpl that can return a Date that
-      // is out of the valid range (and remove the <enforce_range> argument).
-      ZETASQL_RETURN_IF_ERROR(
-          TruncateDateImpl(date1, part, /*enforce_range=*/false, &date1));
-      ZETASQL_RETURN_IF_ERROR(
-          TruncateDateImpl(date2, part, /*enforce_range=*/false, &date2));
-      *output = (date1 - date2) / 7;
+    case ISOWEEK: {
+      // Truncate both dates to the first day of their week; the difference of
+      // the truncated dates is then an exact multiple of 7 days. A truncated
+      // date may be out of the valid range, but only the difference is
+      // returned to the user.
+      ZETASQL_ASSIGN_OR_RETURN(const absl::Weekday first_day_of_week,
+                       GetFirstWeekDayOfWeek(part));
+      *output = (PrevWeekdayOrTodayEpochDays(date1, first_day_of_week) -
+                 PrevWeekdayOrTodayEpochDays(date2, first_day_of_week)) /
+                7;
       break;
+    }
     case YEAR:
     case ISOYEAR:
     case QUARTER:
@@ -3424,7 +3725,7 @@ zetasql_base::Status TruncateTime(const TimeValue& time, DateTimestampPart part,
 }
 
 zetasql_base::Status TruncateDate(int32_t date, DateTimestampPart part, int32_t* output) {
-  return TruncateDateImpl(date, part, /*enforce_range=*/true, output);
+  return TruncateDateImpl(date, part, output);
 }
 
 zetasql_base::Status TimestampTrunc(int64_t timestamp, absl::TimeZone timezone,
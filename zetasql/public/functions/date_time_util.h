@@ -18,6 +18,7 @@
 #define ZETASQL_PUBLIC_FUNCTIONS_DATE_TIME_UTIL_H_
 
 #include <string>
+#include <vector>
 
 #include "google/protobuf/timestamp.pb.h"
 #include "google/type/date.pb.h"
@@ -244,6 +245,65 @@ zetasql_base::Status FormatTimestampToString(absl::string_view format_str,
 zetasql_base::Status FormatDateToString(absl::string_view format_string, int32_t date,
                                 bool expand_quarter, std::string* out);
 
+// A pre-parsed FORMAT_TIMESTAMP/FORMAT_DATE format string. Evaluators can
+// build one of these when the format argument of a function call is constant,
+// so that the format string is parsed once per query instead of once per row.
+// When the format string consists only of literal text and the fixed-width
+// elements %Y, %m, %d, %H, %M, %S, %E4Y and %% (with the time-of-day elements
+// excluded for dates, which escape them), formatting appends directly from
+// the civil-time breakdown of the input. Otherwise formatting falls back to
+// FormatTimestampToString()/FormatDateToString(); the result is identical
+// either way.
+class DateTimestampFormatPlan {
+ public:
+  enum class Mode { kDate, kTimestamp };
+
+  DateTimestampFormatPlan(Mode mode, absl::string_view format_string);
+
+  DateTimestampFormatPlan(const DateTimestampFormatPlan&) = delete;
+  DateTimestampFormatPlan& operator=(const DateTimestampFormatPlan&) = delete;
+
+  // Equivalent to FormatTimestampToString(<format_string>, timestamp,
+  // timezone, out), where <timestamp> is at microseconds scale. Requires
+  // Mode::kTimestamp.
+  zetasql_base::Status FormatTimestamp(int64_t timestamp, absl::TimeZone timezone,
+                               std::string* out) const;
+
+  // Equivalent to FormatDateToString(<format_string>, date, out). Requires
+  // Mode::kDate.
+  zetasql_base::Status FormatDate(int32_t date, std::string* out) const;
+
+ private:
+  struct Op {
+    enum Kind {
+      kLiteral,  // Emits 'literal'.
+      kYear,     // %Y: the year, with as many digits as it needs.
+      kYear4,    // %E4Y: the year, zero-padded to 4 digits.
+      kMonth,    // %m
+      kDay,      // %d
+      kHour,     // %H
+      kMinute,   // %M
+      kSecond,   // %S
+    };
+
+    Kind kind;
+    std::string literal;  // Only used by kLiteral.
+  };
+
+  // Appends the result of applying 'ops_' to 'cs' to 'out'. Only called when
+  // 'use_fast_path_' is true.
+  void FormatCivilSecond(const absl::CivilSecond& cs, std::string* out) const;
+
+  const Mode mode_;
+  const std::string format_string_;
+  // True if 'format_string_' only uses elements that FormatCivilSecond()
+  // supports, in which case 'ops_' is its parsed form.
+  bool use_fast_path_ = false;
+  std::vector<Op> ops_;
+  // An estimate of the output size, used to reserve space in the output.
+  size_t estimated_size_ = 0;
+};
+
 // Populates <out> using the <format_string> as defined by absl::FormatTime() in
 // base/time.h. Returns error status if conversion fails.
 //
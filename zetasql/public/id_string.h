@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "zetasql/base/arena.h"
+#include "zetasql/base/case.h"
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/strings/ascii.h"
@@ -117,6 +118,12 @@ class IdString {
     return WordsEqual(str_words, other_str_words, value_->size_words);
   }
 
+  // Equality against a plain std::string, without constructing an IdString.
+  bool Equals(absl::string_view other) const {
+    CheckAlive();
+    return value_->str == other;
+  }
+
   bool LessThan(IdString other) const {
     CheckAlive();
     other.CheckAlive();
@@ -150,6 +157,19 @@ class IdString {
     return true;
   }
 
+  // Case-insensitive equality against a plain std::string, without
+  // constructing an IdString.  Only ASCII case folding is applied, matching
+  // the IdString overload above.
+  bool CaseEquals(absl::string_view other) const {
+    CheckAlive();
+    if (size() != other.size()) return false;
+    const absl::string_view lower = value_->str_lower;
+    for (size_t i = 0; i < other.size(); ++i) {
+      if (lower[i] != absl::ascii_tolower(other[i])) return false;
+    }
+    return true;
+  }
+
   // Case-insensitive version of LessThan.
   bool CaseLessThan(IdString other) const {
     CheckAlive();
@@ -217,7 +237,9 @@ class IdString {
       // atomic value that can only be overwritten by an identical value.
       size_t h = hash_case_;
       if (h == 0) {
-        h = std::hash<std::string>()(std::string(str_lower));
+        // CaseHash ignores ASCII case, so hashing <str> directly gives the
+        // same value as hashing <str_lower> without touching that copy.
+        h = zetasql_base::CaseHash(str);
         hash_case_ = h;
       }
       return h;
@@ -323,27 +345,62 @@ inline void IdStringFormatter(std::string* out, IdString str) {
   absl::StrAppend(out, str.ToStringView());
 }
 
+// The hash and equality functors below are transparent (heterogeneous):
+// they also accept absl::string_view, so hash containers that support
+// heterogeneous lookup (e.g. the absl containers) can be probed with a
+// string_view without constructing an IdString.  The string_view overloads
+// of the hash functors must produce the same hash an equivalent IdString
+// would.
 struct IdStringHash {
+  using is_transparent = void;
+
   size_t operator()(IdString str) const {
     return str.Hash();
   }
+  size_t operator()(absl::string_view str) const {
+    // Must match IdString::Shared::Hash.
+    return std::hash<std::string>()(std::string(str));
+  }
 };
 struct IdStringCaseHash {
+  using is_transparent = void;
+
   size_t operator()(IdString str) const {
     return str.HashCase();
   }
+  size_t operator()(absl::string_view str) const {
+    // Matches IdString::Shared::HashCase, which also uses the
+    // case-insensitive CaseHash, so no lowercased temporary is needed.
+    return zetasql_base::CaseHash(str);
+  }
 };
 struct IdStringCaseEqualFunc {
+  using is_transparent = void;
+
   bool operator()(IdString a, IdString b) const {
     return IdStringCaseEqual(a, b);
   }
+  bool operator()(IdString a, absl::string_view b) const {
+    return a.CaseEquals(b);
+  }
+  bool operator()(absl::string_view a, IdString b) const {
+    return b.CaseEquals(a);
+  }
 };
 
 // Case-sensitive equality.
 struct IdStringEqualFunc {
+  using is_transparent = void;
+
   bool operator()(IdString a, IdString b) const {
     return a.Equals(b);
   }
+  bool operator()(IdString a, absl::string_view b) const {
+    return a.Equals(b);
+  }
+  bool operator()(absl::string_view a, IdString b) const {
+    return b.Equals(a);
+  }
 };
 
 template <class KeyEqual>
@@ -482,9 +539,13 @@ class IdStringPool {
 };
 
 inline IdString IdStringPool::MakeGlobal(absl::string_view str) {
-  static IdStringPool* global_pool = new IdStringPool;
-  static absl::Mutex global_pool_mutex;
-  absl::MutexLock lock(&global_pool_mutex);
+  // One global pool per thread, so concurrent MakeGlobal calls never
+  // contend on a shared pool mutex.  The pools are intentionally leaked
+  // (global IdString memory is never freed), which also keeps the returned
+  // IdStrings valid after their allocating thread exits.  IdString equality
+  // compares contents, so identical strings made on different threads still
+  // compare equal.
+  thread_local IdStringPool* global_pool = new IdStringPool;
   return global_pool->Make(str);
 }
 
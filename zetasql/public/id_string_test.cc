@@ -17,7 +17,9 @@
 #include "zetasql/public/id_string.h"
 
 #include <set>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
@@ -183,6 +185,10 @@ TEST(IdString, Equals) {
       EXPECT_EQ(test_id_string1[i].Equals(test_id_string2[j]),
                 test_cases[i] == test_cases[j])
           << "input1 = " << test_cases[i] << ", input2 = " << test_cases[j];
+      // The string_view overload must agree.
+      EXPECT_EQ(test_id_string1[i].Equals(absl::string_view(test_cases[j])),
+                test_cases[i] == test_cases[j])
+          << "input1 = " << test_cases[i] << ", input2 = " << test_cases[j];
     }
   }
 }
@@ -210,6 +216,11 @@ TEST(IdString, CaseEquals) {
       EXPECT_EQ(test_id_string1[i].CaseEquals(test_id_string2[j]),
                 zetasql_base::CaseEqual(test_cases[i], test_cases[j]))
           << "input1 = " << test_cases[i] << ", input2 = " << test_cases[j];
+      // The string_view overload must agree.
+      EXPECT_EQ(
+          test_id_string1[i].CaseEquals(absl::string_view(test_cases[j])),
+          zetasql_base::CaseEqual(test_cases[i], test_cases[j]))
+          << "input1 = " << test_cases[i] << ", input2 = " << test_cases[j];
     }
   }
 }
@@ -324,6 +335,26 @@ TEST(IdString, FlatHashSet) {
       absl::flat_hash_set<IdString, IdStringCaseHash, IdStringCaseEqualFunc>>();
 }
 
+TEST(IdString, FlatHashSetHeterogeneousLookup) {
+  absl::flat_hash_set<IdString, IdStringHash, IdStringEqualFunc> id_set;
+  absl::flat_hash_set<IdString, IdStringCaseHash, IdStringCaseEqualFunc>
+      id_set_case;
+  for (const IdString value : {ID("abC"), ID("xyz")}) {
+    id_set.insert(value);
+    id_set_case.insert(value);
+  }
+
+  // The sets can be probed with string_views directly, without constructing
+  // IdStrings for the lookup keys.
+  EXPECT_TRUE(zetasql_base::ContainsKey(id_set, absl::string_view("abC")));
+  EXPECT_FALSE(zetasql_base::ContainsKey(id_set, absl::string_view("ABC")));
+  EXPECT_FALSE(zetasql_base::ContainsKey(id_set, absl::string_view("bad")));
+  EXPECT_TRUE(zetasql_base::ContainsKey(id_set_case, absl::string_view("ABC")));
+  EXPECT_TRUE(zetasql_base::ContainsKey(id_set_case, absl::string_view("xYz")));
+  EXPECT_FALSE(
+      zetasql_base::ContainsKey(id_set_case, absl::string_view("bad")));
+}
+
 TEST(IdString, Set) {
   TestIdStringSet<
       std::set<IdString>,
@@ -333,6 +364,28 @@ TEST(IdString, Set) {
 static const char kPoolIsDeadMsg[] =
     "IdString was accessed after its IdStringPool .* was destructed";
 
+TEST(IdString, MakeGlobalFromManyThreads) {
+  // MakeGlobal uses a thread-local pool.  Strings made on other threads must
+  // stay alive after those threads exit and compare equal to strings with
+  // the same contents made elsewhere.
+  const IdString local = IdString::MakeGlobal("shared_value");
+  std::vector<IdString> from_threads(8);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < from_threads.size(); ++i) {
+    threads.emplace_back([i, &from_threads] {
+      from_threads[i] = IdString::MakeGlobal("shared_value");
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const IdString& from_thread : from_threads) {
+    from_thread.CheckAlive();
+    EXPECT_EQ(local, from_thread);
+    EXPECT_EQ("shared_value", from_thread.ToStringView());
+  }
+}
+
 TEST(IdStringPool, Lifetime) {
   IdString global = IdString::MakeGlobal("global");
   global.CheckAlive();
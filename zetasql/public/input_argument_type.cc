@@ -17,6 +17,7 @@
 #include "zetasql/public/input_argument_type.h"
 
 #include <algorithm>
+#include <memory>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/public/table_valued_function.h"
@@ -88,7 +89,7 @@ bool InputArgumentType::operator!=(const InputArgumentType& type) const {
 InputArgumentType::InputArgumentType(const Value& literal_value)
     : category_(kTypedLiteral),
       type_(literal_value.type()),
-      literal_value_(literal_value) {
+      literal_value_(std::make_shared<const Value>(literal_value)) {
   if (literal_value.type()->IsStruct()) {
     if (literal_value.is_null()) {
       // This is a NULL struct, so its field InputArgumentTypes are the
@@ -154,8 +155,8 @@ std::string InputArgumentType::DebugString(bool verbose) const {
   } else if (is_untyped_empty_array()) {
     absl::StrAppend(&prefix, verbose ? "untyped" : "", "empty array");
     return prefix;
-  } else if (literal_value_.has_value()) {
-    if (literal_value_.value().is_null()) {
+  } else if (literal_value_ != nullptr) {
+    if (literal_value_->is_null()) {
       absl::StrAppend(&prefix, "null ");
     } else if (type()->IsSimpleType()) {
       absl::StrAppend(&prefix, "literal ");
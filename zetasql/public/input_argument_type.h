@@ -27,7 +27,6 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "absl/container/flat_hash_set.h"
-#include "absl/types/optional.h"
 
 namespace zetasql {
 
@@ -45,10 +44,11 @@ class InputArgumentType {
   // Same as InputArgumentType::UntypedNull(). Consider using the latter.
   InputArgumentType() : category_(kUntypedNull), type_(types::Int64Type()) {}
 
-  // Constructor for literal arguments.  <literal_value> cannot be nullptr.
+  // Constructor for literal arguments.
   // A Value can be either a NULL or non-NULL Value of any ZetaSQL Type.
-  // The <literal_value> is not owned and must outlive all referencing
-  // InputArgumentTypes.
+  // The <literal_value> is copied once into shared storage, so copying the
+  // InputArgumentType afterwards (which overload resolution does per
+  // candidate signature) references that Value rather than copying it.
   explicit InputArgumentType(const Value& literal_value);
 
   // Constructor for non-literal and parameter arguments.
@@ -77,16 +77,13 @@ class InputArgumentType {
   // Check for or get a literal value.
   // WARNING: Untyped literals ("NULL" or "[]") are not included here.
   // They must be checked for separately using is_untyped() methods.
-  const Value* literal_value() const {
-    return literal_value_.has_value() ? &literal_value_.value() : nullptr;
-  }
-  bool is_literal() const { return literal_value_.has_value(); }
+  const Value* literal_value() const { return literal_value_.get(); }
+  bool is_literal() const { return literal_value_ != nullptr; }
   bool is_literal_null() const {
-    return literal_value_.has_value() && literal_value_.value().is_null();
+    return literal_value_ != nullptr && literal_value_->is_null();
   }
   bool is_literal_empty_array() const {
-    return literal_value_.has_value() &&
-           literal_value_.value().is_empty_array();
+    return literal_value_ != nullptr && literal_value_->is_empty_array();
   }
 
   // Check for an untyped literal value ("NULL" or "[]").
@@ -202,7 +199,12 @@ class InputArgumentType {
 
   Category category_ = kUntypedNull;
   const Type* type_ = nullptr;  // never nullptr, even for kUntyped categories
-  absl::optional<Value> literal_value_;  // only set for kTypedLiteral.
+
+  // Only set for kTypedLiteral. This is a shared pointer because the
+  // InputArgumentType is copyable and overload resolution copies it into
+  // per-candidate-signature containers; sharing makes those copies reference
+  // the literal Value instead of duplicating it.
+  std::shared_ptr<const Value> literal_value_;
 
   // Populated only for STRUCT type arguments. Stores the InputArgumentType of
   // the struct fields (in the same order). We need this for STRUCT coercion
@@ -227,6 +227,16 @@ TEST(InputArgumentTypeTest, TypeNameAndDebugString) {
   }
 }
 
+TEST(InputArgumentTypeTest, CopiesShareLiteralValue) {
+  // Overload resolution copies InputArgumentTypes into per-candidate
+  // containers, so copies must reference the same literal Value rather
+  // than duplicating it.
+  const InputArgumentType literal_string(Value::String("abc"));
+  const InputArgumentType copy = literal_string;
+  ASSERT_TRUE(copy.is_literal());
+  EXPECT_EQ(literal_string.literal_value(), copy.literal_value());
+}
+
 TEST(InputArgumentTypeTest, LongArgumentsString) {
   TypeFactory type_factory;
   const zetasql::StructType* struct_type = nullptr;
@@ -17,6 +17,7 @@
 #include "zetasql/public/language_options.h"
 
 #include "zetasql/base/logging.h"
+#include "zetasql/common/fingerprint.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/options.pb.h"
@@ -83,6 +84,31 @@ std::set<LanguageFeature> LanguageOptions::GetLanguageFeaturesForVersion(
 
 void LanguageOptions::SetLanguageVersion(LanguageVersion version) {
   enabled_language_features_ = GetLanguageFeaturesForVersion(version);
+  fingerprint_is_stale_ = true;
+}
+
+uint64_t LanguageOptions::fingerprint() const {
+  if (fingerprint_is_stale_) {
+    uint64_t fingerprint = kFingerprintSeed;
+    // The sets are ordered, so iterating gives a deterministic encoding.
+    // Each set is preceded by its size so sets cannot alias each other.
+    fingerprint =
+        FingerprintCombine(fingerprint, supported_statement_kinds_.size());
+    for (ResolvedNodeKind kind : supported_statement_kinds_) {
+      fingerprint = FingerprintCombine(fingerprint, kind);
+    }
+    fingerprint =
+        FingerprintCombine(fingerprint, enabled_language_features_.size());
+    for (LanguageFeature feature : enabled_language_features_) {
+      fingerprint = FingerprintCombine(fingerprint, feature);
+    }
+    fingerprint = FingerprintCombine(fingerprint, name_resolution_mode_);
+    fingerprint = FingerprintCombine(fingerprint, product_mode_);
+    fingerprint = FingerprintCombine(fingerprint, error_on_deprecated_syntax_);
+    fingerprint_ = fingerprint;
+    fingerprint_is_stale_ = false;
+  }
+  return fingerprint_;
 }
 
 LanguageOptions LanguageOptions::MaximumFeatures() {
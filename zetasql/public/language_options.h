@@ -17,6 +17,7 @@
 #ifndef ZETASQL_PUBLIC_LANGUAGE_OPTIONS_H_
 #define ZETASQL_PUBLIC_LANGUAGE_OPTIONS_H_
 
+#include <cstdint>
 #include <set>
 #include <string>
 
@@ -63,16 +64,19 @@ class LanguageOptions {
   void SetSupportedStatementKinds(
       const std::set<ResolvedNodeKind>& supported_statement_kinds) {
     supported_statement_kinds_ = supported_statement_kinds;
+    fingerprint_is_stale_ = true;
   }
 
   // Equivalent to SetSupportedStatementKinds({}).
   void SetSupportsAllStatementKinds() {
     supported_statement_kinds_.clear();
+    fingerprint_is_stale_ = true;
   }
 
   // Adds <kind> to the set of supported statement kinds.
   void AddSupportedStatementKind(ResolvedNodeKind kind) {
     zetasql_base::InsertIfNotPresent(&supported_statement_kinds_, kind);
+    fingerprint_is_stale_ = true;
   }
 
   // Returns whether or not <feature> is enabled.
@@ -96,6 +100,7 @@ class LanguageOptions {
   // Enables support for the specified <feature>.
   void EnableLanguageFeature(LanguageFeature feature) {
     zetasql_base::InsertIfNotPresent(&enabled_language_features_, feature);
+    fingerprint_is_stale_ = true;
   }
   // DEPRECATED.  This is the old name for EnableLanguageFeature.
   void EnableOptionalFeature(LanguageFeature feature) {
@@ -104,6 +109,7 @@ class LanguageOptions {
 
   void SetEnabledLanguageFeatures(const std::set<LanguageFeature>& features) {
     enabled_language_features_ = features;
+    fingerprint_is_stale_ = true;
   }
 
   const std::set<LanguageFeature>& GetEnabledLanguageFeatures() const {
@@ -116,6 +122,7 @@ class LanguageOptions {
 
   void DisableAllLanguageFeatures() {
     enabled_language_features_.clear();
+    fingerprint_is_stale_ = true;
   }
 
   // Enable all optional features that are enabled in the idealized ZetaSQL
@@ -137,6 +144,7 @@ class LanguageOptions {
 
   void set_name_resolution_mode(NameResolutionMode mode) {
     name_resolution_mode_ = mode;
+    fingerprint_is_stale_ = true;
   }
   NameResolutionMode name_resolution_mode() const {
     return name_resolution_mode_;
@@ -144,6 +152,7 @@ class LanguageOptions {
 
   void set_product_mode(ProductMode mode) {
     product_mode_ = mode;
+    fingerprint_is_stale_ = true;
   }
   ProductMode product_mode() const {
     return product_mode_;
@@ -156,11 +165,21 @@ class LanguageOptions {
 
   void set_error_on_deprecated_syntax(bool value) {
     error_on_deprecated_syntax_ = value;
+    fingerprint_is_stale_ = true;
   }
   ABSL_MUST_USE_RESULT bool error_on_deprecated_syntax() const {
     return error_on_deprecated_syntax_;
   }
 
+  // Returns a 64-bit fingerprint of these options: options that compare
+  // equal always produce the same fingerprint, and different options
+  // produce different fingerprints modulo hash collisions.  The value is
+  // deterministic across processes and builds, so it is usable as a
+  // persistent or distributed cache key.  The fingerprint is cached and
+  // only recomputed after a mutation, so repeated calls on unchanged
+  // options are cheap.
+  uint64_t fingerprint() const;
+
  private:
   // Enable all optional features that are enabled in the idealized ZetaSQL.
   // If 'for_development' is false, features that are still under development
@@ -199,6 +218,13 @@ class LanguageOptions {
   // deprecation_warnings.
   bool error_on_deprecated_syntax_ = false;
 
+  // Cached result of fingerprint(), recomputed lazily when stale.  This is
+  // not serialized.  Every mutator must set <fingerprint_is_stale_>; there
+  // are no mutable accessors to class state that could bypass this.
+  // 'mutable' because fingerprint() is logically const.
+  mutable uint64_t fingerprint_ = 0;
+  mutable bool fingerprint_is_stale_ = true;
+
   // Copyable
 };
 
@@ -246,8 +246,46 @@ TEST(LanguageOptions, GetEnabledLanguageFeaturesAsString) {
             options.GetEnabledLanguageFeaturesAsString());
 }
 
+TEST(LanguageOptions, Fingerprint) {
+  LanguageOptions options;
+  const uint64_t base_fingerprint = options.fingerprint();
+
+  // The fingerprint is stable across calls and across equal objects.
+  EXPECT_EQ(base_fingerprint, options.fingerprint());
+  EXPECT_EQ(base_fingerprint, LanguageOptions().fingerprint());
+
+  options.EnableLanguageFeature(FEATURE_ANALYTIC_FUNCTIONS);
+  const uint64_t feature_fingerprint = options.fingerprint();
+  EXPECT_NE(base_fingerprint, feature_fingerprint);
+
+  // Re-enabling an already-enabled feature is a no-op.
+  options.EnableLanguageFeature(FEATURE_ANALYTIC_FUNCTIONS);
+  EXPECT_EQ(feature_fingerprint, options.fingerprint());
+
+  // The fingerprint depends on contents, not on mutation history.
+  LanguageOptions equivalent_options;
+  equivalent_options.EnableLanguageFeature(FEATURE_TABLESAMPLE);
+  equivalent_options.EnableLanguageFeature(FEATURE_ANALYTIC_FUNCTIONS);
+  equivalent_options.DisableAllLanguageFeatures();
+  equivalent_options.EnableLanguageFeature(FEATURE_ANALYTIC_FUNCTIONS);
+  EXPECT_EQ(feature_fingerprint, equivalent_options.fingerprint());
+
+  // Every kind of field feeds the fingerprint.
+  options.set_product_mode(PRODUCT_EXTERNAL);
+  const uint64_t product_mode_fingerprint = options.fingerprint();
+  EXPECT_NE(feature_fingerprint, product_mode_fingerprint);
+  options.set_name_resolution_mode(NAME_RESOLUTION_STRICT);
+  EXPECT_NE(product_mode_fingerprint, options.fingerprint());
+  options.AddSupportedStatementKind(RESOLVED_EXPLAIN_STMT);
+  options.set_error_on_deprecated_syntax(true);
+
+  // Copies carry the fingerprint along.
+  const LanguageOptions options_copy = options;
+  EXPECT_EQ(options.fingerprint(), options_copy.fingerprint());
+}
+
 TEST(LanguageOptions, ClassAndProtoSize) {
-  EXPECT_EQ(16,
+  EXPECT_EQ(32,
       sizeof(LanguageOptions) -
       sizeof(std::set<ResolvedNodeKind>) -
       sizeof(std::set<LanguageFeature>))
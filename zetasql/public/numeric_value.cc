@@ -352,6 +352,80 @@ void Uint224::LongDivision(const Uint224& x) {
   *this = quotient;
 }
 
+// Powers of 10 up to 10^18, the largest that fits in a uint64_t batch of
+// parsed digits.
+const uint64_t kPowersOf10[19] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+};
+
+// Appends 'num_digits' decimal digits with combined value 'chunk' to 'value'.
+// Returns false if the result would exceed 'max_value'; the arithmetic cannot
+// overflow as long as 'max_value' * 10^18 - 1 fits in __int128.
+inline bool AppendDecimalDigits(uint64_t chunk, int num_digits,
+                                __int128 max_value, __int128* value) {
+  if (ABSL_PREDICT_FALSE(
+          *value > max_value / static_cast<__int128>(kPowersOf10[num_digits]))) {
+    return false;
+  }
+  *value = *value * static_cast<__int128>(kPowersOf10[num_digits]) + chunk;
+  return *value <= max_value;
+}
+
+// Lookup table for writing two decimal digits at a time; entry i holds the
+// characters of the two-digit number i.
+const char kTwoDigitChars[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+// Writes 'number' as exactly 'num_digits' decimal digits (zero padded) ending
+// at 'end', and returns a pointer to the first digit written. 'num_digits'
+// must be even and large enough to hold 'number'.
+inline char* PrependUint64Padded(uint64_t number, int num_digits, char* end) {
+  for (int i = 0; i < num_digits; i += 2) {
+    end -= 2;
+    memcpy(end, &kTwoDigitChars[(number % 100) * 2], 2);
+    number /= 100;
+  }
+  return end;
+}
+
+// Writes 'number' without leading zeros ending at 'end', and returns a
+// pointer to the first digit written. Writes "0" if 'number' is zero.
+inline char* PrependUint64(uint64_t number, char* end) {
+  while (number >= 100) {
+    end -= 2;
+    memcpy(end, &kTwoDigitChars[(number % 100) * 2], 2);
+    number /= 100;
+  }
+  if (number >= 10) {
+    end -= 2;
+    memcpy(end, &kTwoDigitChars[number * 2], 2);
+  } else {
+    *--end = number + '0';
+  }
+  return end;
+}
+
 }  // namespace
 
 zetasql_base::StatusOr<NumericValue> NumericValue::FromStringStrict(
@@ -367,46 +441,51 @@ size_t NumericValue::HashCode() const {
   return absl::Hash<NumericValue>()(*this);
 }
 
-std::string NumericValue::ToString() const {
+void NumericValue::AppendToString(std::string* output) const {
   const __int128 value = as_packed_int();
-  const __int128 abs_value = int128_abs(value);
-
-  // First convert the integer part.
-  std::string ret;
-  for (__int128 int_part = abs_value / kScalingFactor;
-       int_part != 0; int_part /= 10) {
-    int digit = int_part % 10;
-    ret.append(1, digit + '0');
-  }
-  if (ret.empty()) {
-    ret = "0";
-  }
   if (value < 0) {
-    ret.append(1, '-');
-  }
-  std::reverse(ret.begin(), ret.end());
-
-  // And now convert the fractional part.
-  std::string fract_str;
-  for (__int128 fract_part = abs_value % kScalingFactor;
-       fract_part != 0; fract_part /= 10) {
-    int digit = fract_part % 10;
-    fract_str.append(1, digit + '0');
-  }
-
-  if (!fract_str.empty()) {
-    // Potentially add zeroes that will end up immediately after the decimal
-    // point.
-    if (fract_str.size() < kMaxFractionalDigits) {
-      fract_str.append(kMaxFractionalDigits - fract_str.size(), '0');
+    output->push_back('-');
+  }
+  const unsigned __int128 abs_value =
+      static_cast<unsigned __int128>(int128_abs(value));
+  unsigned __int128 int_part = abs_value / kScalingFactor;
+  const uint32_t fract_part = static_cast<uint32_t>(abs_value % kScalingFactor);
+
+  // Convert the integer part, two digits per division. The integer part has
+  // at most 29 digits, so it is rendered as a uint64_t plus at most one
+  // 18-digit zero-padded chunk split off with a single __int128 division;
+  // values in the int64 range (the common case) take no __int128 divisions
+  // at all.
+  char buffer[32];
+  char* end = buffer + sizeof(buffer);
+  char* pos = end;
+  constexpr uint64_t kUint64ChunkSize = 1000000000000000000ull;  // 10^18
+  while (int_part > std::numeric_limits<uint64_t>::max()) {
+    pos = PrependUint64Padded(static_cast<uint64_t>(int_part % kUint64ChunkSize),
+                              18, pos);
+    int_part /= kUint64ChunkSize;
+  }
+  pos = PrependUint64(static_cast<uint64_t>(int_part), pos);
+  output->append(pos, end - pos);
+
+  // And now convert the fractional part, which is always 9 digits with
+  // trailing zeroes stripped.
+  if (fract_part != 0) {
+    char fract_buffer[kMaxFractionalDigits];
+    char* fract_end = fract_buffer + kMaxFractionalDigits;
+    PrependUint64Padded(fract_part % 100000000, 8, fract_end);
+    fract_buffer[0] = fract_part / 100000000 + '0';
+    while (fract_end[-1] == '0') {
+      --fract_end;
     }
-    // Skip zeroes that will end up at the end of the fractional part.
-    auto idx = fract_str.find_first_not_of('0');
-    std::reverse(fract_str.begin() + idx, fract_str.end());
-    ret.append(1, '.');
-    ret.append(fract_str.substr(idx));
+    output->push_back('.');
+    output->append(fract_buffer, fract_end - fract_buffer);
   }
+}
 
+std::string NumericValue::ToString() const {
+  std::string ret;
+  AppendToString(&ret);
   return ret;
 }
 
@@ -507,9 +586,13 @@ zetasql_base::StatusOr<NumericValue> NumericValue::FromStringInternal(
   num_integer_digits = std::max<int64_t>(0, num_integer_digits + exponent);
   num_fract_digits = std::max<int64_t>(0, num_fract_digits - exponent);
 
-  // Parse the numerical part now.
+  // Parse the numerical part now. Integer digits are accumulated into
+  // uint64_t batches of up to 18 digits so the loop performs one __int128
+  // multiplication per batch instead of one per digit.
   __int128 value = 0;
-  __int128 fractional_part = 0;
+  uint64_t int_chunk = 0;
+  int int_chunk_digits = 0;
+  uint64_t fractional_part = 0;
   int64_t int_count = 0;
   int64_t fract_count = 0;
 
@@ -528,13 +611,16 @@ zetasql_base::StatusOr<NumericValue> NumericValue::FromStringInternal(
 
     if (int_count < num_integer_digits) {
       ++int_count;
-      value = value * 10 + digit;
-
-      // After adding each digit, check if the integer part is outside the
-      // permitted range. The multiplication itself can't overflow, since we're
-      // operating on the lower bits prior to shifting by the scaling factor.
-      if (ABSL_PREDICT_FALSE(value > kMaxIntegerPart)) {
-        return MakeInvalidNumericError(str);
+      int_chunk = int_chunk * 10 + digit;
+      if (++int_chunk_digits == 18) {
+        // Flush the full batch, checking that the integer part stays inside
+        // the permitted range.
+        if (ABSL_PREDICT_FALSE(!AppendDecimalDigits(int_chunk, int_chunk_digits,
+                                                    kMaxIntegerPart, &value))) {
+          return MakeInvalidNumericError(str);
+        }
+        int_chunk = 0;
+        int_chunk_digits = 0;
       }
     } else if (fract_count < num_fract_digits) {
       if (fract_count >= kMaxFractionalDigits && is_strict && digit != 0) {
@@ -551,22 +637,27 @@ zetasql_base::StatusOr<NumericValue> NumericValue::FromStringInternal(
     }
   }
 
+  if (int_chunk_digits > 0 &&
+      ABSL_PREDICT_FALSE(!AppendDecimalDigits(int_chunk, int_chunk_digits,
+                                              kMaxIntegerPart, &value))) {
+    return MakeInvalidNumericError(str);
+  }
+
   if ((int_count == 0) && (fract_count == 0)) {
     return MakeInvalidNumericError(str);
   }
 
   // If the exponent was bigger than zero there might be extra zeroes that
   // should come after all digits in the std::string have been exhausted, account for
-  // them now.
-  for (; int_count < num_integer_digits; ++int_count) {
-    value *= 10;
-
-    // After shifting for each zero, check if the integer part is outside the
-    // permitted range. The multiplication itself can't overflow, since we're
-    // operating on the lower bits prior to shifting by the scaling factor.
-    if (ABSL_PREDICT_FALSE(value > kMaxIntegerPart)) {
+  // them now, checking that the integer part stays inside the permitted range.
+  while (int_count < num_integer_digits) {
+    const int num_zeroes = static_cast<int>(
+        std::min<int64_t>(num_integer_digits - int_count, 18));
+    if (ABSL_PREDICT_FALSE(
+            !AppendDecimalDigits(0, num_zeroes, kMaxIntegerPart, &value))) {
       return MakeInvalidNumericError(str);
     }
+    int_count += num_zeroes;
   }
 
   // Potentially add zeroes at the end of the fractional part.
@@ -582,9 +673,8 @@ zetasql_base::StatusOr<NumericValue> NumericValue::FromStringInternal(
       number_or_status : MakeInvalidNumericError(str);
 }
 
-zetasql_base::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
-  const __int128 value = as_packed_int();
-  const __int128 rh_value = rh.as_packed_int();
+bool NumericValue::MultiplyPacked(__int128 value, __int128 rh_value,
+                                  __int128* result) {
   int sign_a = int128_sign(value);
   int sign_b = int128_sign(rh_value);
   __int128 a = int128_abs(value);
@@ -613,8 +703,7 @@ zetasql_base::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) con
   // multiplication. The precision will be adjusted below.
   const int32_t kMaxSpillOver = 293873587;
   if (ABSL_PREDICT_FALSE(p2 > kMaxSpillOver)) {
-    return MakeEvalError() << "numeric overflow: " << ToString() << " * "
-                           << rh.ToString();
+    return true;
   }
 
   uint32_t p1_hi = static_cast<uint32_t>(p1 >> 32);
@@ -645,12 +734,76 @@ zetasql_base::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) con
                  (static_cast<__int128>(r0_hi) << 32) |
                  r0_lo;
 
-  auto numeric_value_status = FromPackedInt((sign_a * sign_b) < 0 ? -res : res);
-  if (!numeric_value_status.ok()) {
+  if (ABSL_PREDICT_FALSE(res > internal::kNumericMax)) {
+    return true;
+  }
+  *result = (sign_a * sign_b) < 0 ? -res : res;
+  return false;
+}
+
+zetasql_base::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
+  __int128 result;
+  if (ABSL_PREDICT_FALSE(
+          MultiplyPacked(as_packed_int(), rh.as_packed_int(), &result))) {
     return MakeEvalError() << "numeric overflow: " << ToString() << " * "
                            << rh.ToString();
   }
-  return numeric_value_status.ValueOrDie();
+  return NumericValue(result);
+}
+
+zetasql_base::Status NumericValue::AddBatch(absl::Span<const NumericValue> lhs,
+                                    absl::Span<const NumericValue> rhs,
+                                    absl::Span<NumericValue> result) {
+  CHECK_EQ(lhs.size(), rhs.size());
+  CHECK_EQ(lhs.size(), result.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    __int128 sum;
+    if (ABSL_PREDICT_FALSE(
+            internal::int128_add_overflow(lhs[i].as_packed_int(),
+                                          rhs[i].as_packed_int(), &sum) ||
+            sum > internal::kNumericMax || sum < internal::kNumericMin)) {
+      return MakeEvalError() << "numeric overflow: " << lhs[i].ToString()
+                             << " + " << rhs[i].ToString();
+    }
+    result[i] = NumericValue(sum);
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status NumericValue::SubtractBatch(absl::Span<const NumericValue> lhs,
+                                         absl::Span<const NumericValue> rhs,
+                                         absl::Span<NumericValue> result) {
+  CHECK_EQ(lhs.size(), rhs.size());
+  CHECK_EQ(lhs.size(), result.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    __int128 diff;
+    if (ABSL_PREDICT_FALSE(
+            internal::int128_add_overflow(lhs[i].as_packed_int(),
+                                          -rhs[i].as_packed_int(), &diff) ||
+            diff > internal::kNumericMax || diff < internal::kNumericMin)) {
+      return MakeEvalError() << "numeric overflow: " << lhs[i].ToString()
+                             << " - " << rhs[i].ToString();
+    }
+    result[i] = NumericValue(diff);
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status NumericValue::MultiplyBatch(absl::Span<const NumericValue> lhs,
+                                         absl::Span<const NumericValue> rhs,
+                                         absl::Span<NumericValue> result) {
+  CHECK_EQ(lhs.size(), rhs.size());
+  CHECK_EQ(lhs.size(), result.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    __int128 product;
+    if (ABSL_PREDICT_FALSE(MultiplyPacked(
+            lhs[i].as_packed_int(), rhs[i].as_packed_int(), &product))) {
+      return MakeEvalError() << "numeric overflow: " << lhs[i].ToString()
+                             << " * " << rhs[i].ToString();
+    }
+    result[i] = NumericValue(product);
+  }
+  return ::zetasql_base::OkStatus();
 }
 
 NumericValue NumericValue::Abs(NumericValue value) {
@@ -988,6 +1141,22 @@ void NumericValue::Aggregator::Add(NumericValue value) {
   }
 }
 
+void NumericValue::Aggregator::AddBatch(absl::Span<const NumericValue> values) {
+  // Local copies let the compiler keep the running sum in registers across
+  // loop iterations.
+  __int128 sum_lower = sum_lower_;
+  int64_t sum_upper = sum_upper_;
+  for (const NumericValue value : values) {
+    const __int128 v = value.as_packed_int();
+    if (ABSL_PREDICT_FALSE(
+            internal::int128_add_overflow(sum_lower, v, &sum_lower))) {
+      sum_upper += v < 0 ? -1 : 1;
+    }
+  }
+  sum_lower_ = sum_lower;
+  sum_upper_ = sum_upper;
+}
+
 zetasql_base::StatusOr<NumericValue> NumericValue::Aggregator::GetSum() const {
   if (sum_upper_ != 0) {
     return MakeEvalError() << "numeric overflow: SUM";
@@ -206,6 +206,14 @@ TEST_F(NumericValueTest, ToString) {
             NumericValue(std::numeric_limits<uint64_t>::max()).ToString());
 }
 
+TEST_F(NumericValueTest, AppendToString) {
+  std::string result = "result: ";
+  NumericValue::FromString("-12.345").ValueOrDie().AppendToString(&result);
+  result.push_back(',');
+  NumericValue::MaxValue().AppendToString(&result);
+  EXPECT_EQ(absl::StrCat("result: -12.345,", expected_max_string_), result);
+}
+
 TEST_F(NumericValueTest, FromString) {
   using FromStringFunc =
       std::function<zetasql_base::StatusOr<NumericValue>(absl::string_view)>;
@@ -731,6 +739,76 @@ TEST_F(NumericValueTest, Multiply_AllPrecisionCombinations) {
   }
 }
 
+TEST_F(NumericValueTest, BatchArithmetic) {
+  // The batch kernels must agree with the scalar operators on random inputs,
+  // including negative values and rounding in multiplication.
+  const int kNumValues = 1000;
+  // Scaling the random values down by 0.4 guarantees that no sum or
+  // difference of a pair can exceed the NUMERIC range.
+  const NumericValue scale = MkNumeric("0.4");
+  std::vector<NumericValue> lhs;
+  std::vector<NumericValue> rhs;
+  for (int i = 0; i < kNumValues; ++i) {
+    lhs.push_back(MakeRandomNumeric().Multiply(scale).ValueOrDie());
+    rhs.push_back(MakeRandomNumeric().Multiply(scale).ValueOrDie());
+  }
+
+  std::vector<NumericValue> result(kNumValues);
+  ZETASQL_ASSERT_OK(NumericValue::AddBatch(lhs, rhs, absl::MakeSpan(result)));
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(lhs[i].Add(rhs[i]).ValueOrDie(), result[i]);
+  }
+
+  ZETASQL_ASSERT_OK(NumericValue::SubtractBatch(lhs, rhs, absl::MakeSpan(result)));
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(lhs[i].Subtract(rhs[i]).ValueOrDie(), result[i]);
+  }
+
+  // Products of random 30-digit values usually overflow, so scale the
+  // multiplication inputs down to small values first.
+  std::vector<NumericValue> small_lhs;
+  std::vector<NumericValue> small_rhs;
+  for (int i = 0; i < kNumValues; ++i) {
+    small_lhs.push_back(
+        NumericValue(absl::Uniform<int64_t>(random_, -1000000, 1000000)));
+    small_rhs.push_back(MkNumeric("0.999999999"));
+  }
+  ZETASQL_ASSERT_OK(
+      NumericValue::MultiplyBatch(small_lhs, small_rhs, absl::MakeSpan(result)));
+  for (int i = 0; i < kNumValues; ++i) {
+    EXPECT_EQ(small_lhs[i].Multiply(small_rhs[i]).ValueOrDie(), result[i]);
+  }
+
+  // The result span may alias an input.
+  ZETASQL_ASSERT_OK(NumericValue::AddBatch(small_lhs, small_rhs,
+                                   absl::MakeSpan(small_lhs)));
+}
+
+TEST_F(NumericValueTest, BatchArithmeticOverflow) {
+  const std::vector<NumericValue> lhs = {NumericValue(1),
+                                         NumericValue::MaxValue()};
+  const std::vector<NumericValue> rhs = {NumericValue(2), NumericValue(2)};
+  std::vector<NumericValue> result(2);
+
+  EXPECT_THAT(
+      NumericValue::AddBatch(lhs, rhs, absl::MakeSpan(result)),
+      StatusIs(zetasql_base::OUT_OF_RANGE,
+               "numeric overflow: 99999999999999999999999999999.999999999 + "
+               "2"));
+  const std::vector<NumericValue> min_lhs = {NumericValue(1),
+                                             NumericValue::MinValue()};
+  EXPECT_THAT(
+      NumericValue::SubtractBatch(min_lhs, rhs, absl::MakeSpan(result)),
+      StatusIs(zetasql_base::OUT_OF_RANGE,
+               "numeric overflow: -99999999999999999999999999999.999999999 - "
+               "2"));
+  EXPECT_THAT(
+      NumericValue::MultiplyBatch(lhs, rhs, absl::MakeSpan(result)),
+      StatusIs(
+          zetasql_base::OUT_OF_RANGE,
+          "numeric overflow: 99999999999999999999999999999.999999999 * 2"));
+}
+
 TEST_F(NumericValueTest, UnaryMinus) {
   EXPECT_EQ(NumericValue(0), NumericValue::UnaryMinus(NumericValue(0)));
   EXPECT_EQ(NumericValue(-1), NumericValue::UnaryMinus(NumericValue(1)));
@@ -1273,6 +1351,41 @@ TEST_F(NumericValueTest, AggregatorMultipleValues) {
             a3.GetAverage(kCount).ValueOrDie());
 }
 
+TEST_F(NumericValueTest, AggregatorAddBatch) {
+  // AddBatch must be equivalent to repeated Add, including the int128
+  // overflow accounting in sum_upper_.
+  std::vector<NumericValue> values;
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(MakeRandomNumeric());
+  }
+  // Force several wrap-arounds of the lower 128 bits of the sum. Each
+  // quadruple cancels out, so the final sum stays in range.
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(NumericValue::MaxValue());
+    values.push_back(NumericValue::MaxValue());
+    values.push_back(NumericValue::MinValue());
+    values.push_back(NumericValue::MinValue());
+  }
+
+  NumericValue::Aggregator batch_aggregator;
+  batch_aggregator.AddBatch(values);
+
+  NumericValue::Aggregator scalar_aggregator;
+  for (NumericValue value : values) {
+    scalar_aggregator.Add(value);
+  }
+
+  EXPECT_EQ(scalar_aggregator.GetSum().ValueOrDie(),
+            batch_aggregator.GetSum().ValueOrDie());
+  EXPECT_EQ(scalar_aggregator.GetAverage(values.size()).ValueOrDie(),
+            batch_aggregator.GetAverage(values.size()).ValueOrDie());
+
+  // An empty batch is a no-op.
+  NumericValue::Aggregator empty_aggregator;
+  empty_aggregator.AddBatch({});
+  EXPECT_EQ(NumericValue(), empty_aggregator.GetSum().ValueOrDie());
+}
+
 TEST_F(NumericValueTest, AggregatorAverageRounding) {
   // 1/3 - rounding down.
   NumericValue::Aggregator a1;
@@ -20,6 +20,7 @@
 #include "zetasql/public/parse_location.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 
 #include "zetasql/base/logging.h"
@@ -55,24 +56,36 @@ ParseLocationTranslator::ParseLocationTranslator(absl::string_view input)
     : input_(input) {}
 
 void ParseLocationTranslator::CalculateLineOffsets() const {
-  if (line_offsets_.empty()) {
-    line_offsets_.push_back(0);  // Line 1 starts at offset 0.
-    int offset = 0;
-    while (offset < input_.size()) {
-      switch (input_[offset]) {
-        case '\n':
-          line_offsets_.push_back(++offset);
-          break;
-        case '\r':
-          if (offset + 1 < input_.size() && input_[offset + 1] == '\n') {
-            ++offset;
-          }
-          line_offsets_.push_back(++offset);
-          break;
-        default:
-          ++offset;
-          break;
-      }
+  if (!line_offsets_.empty()) return;
+  line_offsets_.push_back(0);  // Line 1 starts at offset 0.
+
+  // The index is built lazily, on the first line/column translation, but for
+  // multi-megabyte inputs even a single linear pass is measurable, so scan
+  // with memchr rather than byte at a time. "\r\n", "\r" and "\n" each
+  // terminate a line; "\r\n" counts as a single line break.
+  const char* const data = input_.data();
+  const char* const end = data + input_.size();
+  const char* next_lf =
+      static_cast<const char*>(memchr(data, '\n', input_.size()));
+  const char* next_cr =
+      static_cast<const char*>(memchr(data, '\r', input_.size()));
+  while (next_lf != nullptr || next_cr != nullptr) {
+    const char* line_break;
+    if (next_cr != nullptr && (next_lf == nullptr || next_cr < next_lf)) {
+      line_break =
+          (next_cr + 1 < end && next_cr[1] == '\n') ? next_cr + 1 : next_cr;
+    } else {
+      line_break = next_lf;
+    }
+    const char* line_start = line_break + 1;
+    line_offsets_.push_back(static_cast<int>(line_start - data));
+    if (next_lf != nullptr && next_lf < line_start) {
+      next_lf = static_cast<const char*>(
+          memchr(line_start, '\n', end - line_start));
+    }
+    if (next_cr != nullptr && next_cr < line_start) {
+      next_cr = static_cast<const char*>(
+          memchr(line_start, '\r', end - line_start));
     }
   }
 }
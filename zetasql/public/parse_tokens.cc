@@ -17,6 +17,7 @@
 #include "zetasql/public/parse_tokens.h"
 
 #include <ctype.h>
+#include <iterator>
 #include <memory>
 #include <utility>
 
@@ -357,6 +358,75 @@ std::string ParseToken::DebugString() const {
   return absl::StrCat(kind_str, ":", GetSQL());
 }
 
+ParseTokenCache::ParseTokenCache(const ParseTokenOptions& options)
+    : options_(options) {
+  CHECK_EQ(options.max_tokens, 0)
+      << "ParseTokenCache does not support max_tokens";
+  CHECK(!options.stop_at_end_of_statement)
+      << "ParseTokenCache does not support stop_at_end_of_statement";
+}
+
+zetasql_base::Status ParseTokenCache::GetParseTokens(
+    absl::string_view input, std::vector<ParseToken>* tokens) {
+  // Find the length of the common prefix with the previously tokenized input.
+  size_t common_prefix_length = 0;
+  while (common_prefix_length < input.size() &&
+         common_prefix_length < input_.size() &&
+         input[common_prefix_length] == input_[common_prefix_length]) {
+    ++common_prefix_length;
+  }
+
+  // All statements that end before the first changed byte are reused
+  // verbatim; re-lexing resumes at the start of the statement containing the
+  // change. Tokenizing a statement never reads past its terminating
+  // semicolon, so the reused tokens are exactly what a full pass would
+  // produce.
+  int num_reused_tokens = 0;
+  int resume_offset = 0;
+  size_t num_reused_statements = 0;
+  for (size_t i = 0; i < statement_starts_.size(); ++i) {
+    if (static_cast<size_t>(statement_starts_[i].second) >
+        common_prefix_length) {
+      break;
+    }
+    // Statement i is re-lexed from its start; statements before it are kept.
+    num_reused_tokens = statement_starts_[i].first;
+    resume_offset = statement_starts_[i].second;
+    num_reused_statements = i;
+  }
+
+  tokens_.resize(num_reused_tokens);
+  statement_starts_.resize(num_reused_statements);
+  input_ = std::string(input);
+
+  ParseResumeLocation resume_location =
+      ParseResumeLocation::FromStringView(input_);
+  resume_location.set_byte_position(resume_offset);
+  ParseTokenOptions statement_options = options_;
+  statement_options.stop_at_end_of_statement = true;
+  while (true) {
+    statement_starts_.emplace_back(static_cast<int>(tokens_.size()),
+                                   resume_location.byte_position());
+    std::vector<ParseToken> statement_tokens;
+    const zetasql_base::Status status = ::zetasql::GetParseTokens(
+        statement_options, &resume_location, &statement_tokens);
+    if (!status.ok()) {
+      // The cache no longer describes a fully tokenized input; drop it.
+      input_.clear();
+      tokens_.clear();
+      statement_starts_.clear();
+      return status;
+    }
+    const bool at_end = !statement_tokens.empty() &&
+                        statement_tokens.back().IsEndOfInput();
+    std::move(statement_tokens.begin(), statement_tokens.end(),
+              std::back_inserter(tokens_));
+    if (at_end) break;
+  }
+  *tokens = tokens_;
+  return ::zetasql_base::OkStatus();
+}
+
 ParseToken::ParseToken() : kind_(END_OF_INPUT) {}
 
 ParseToken::ParseToken(ParseLocationRange location_range, std::string image,
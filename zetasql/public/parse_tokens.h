@@ -204,6 +204,53 @@ zetasql_base::Status GetParseTokens(const ParseTokenOptions& options,
                             ParseResumeLocation* resume_location,
                             std::vector<ParseToken>* tokens);
 
+// Caches the token stream of a script so that re-tokenizing after an edit
+// only re-lexes from the statement containing the first changed byte onward.
+// Intended for editor-style tooling that repeatedly tokenizes slightly
+// different versions of the same large script, where a full re-lex per
+// keystroke is too slow.
+//
+// Statement starts are used as resume points because they are the only
+// offsets at which the tokenizer can safely restart: tokenization within a
+// statement is context sensitive, but never looks across a statement
+// boundary.
+//
+// Example:
+//   ParseTokenCache cache(options);
+//   ZETASQL_RETURN_IF_ERROR(cache.GetParseTokens(script_v1, &tokens));
+//   ... user edits the script ...
+//   ZETASQL_RETURN_IF_ERROR(cache.GetParseTokens(script_v2, &tokens));
+//
+// This class is not thread-safe.
+class ParseTokenCache {
+ public:
+  // 'options' applies to all calls. options.max_tokens and
+  // options.stop_at_end_of_statement must not be set; they are incompatible
+  // with caching whole token streams.
+  explicit ParseTokenCache(const ParseTokenOptions& options);
+  ParseTokenCache(const ParseTokenCache&) = delete;
+  ParseTokenCache& operator=(const ParseTokenCache&) = delete;
+
+  // Tokenizes all of <input>, reusing cached tokens for the statements that
+  // precede the first byte where <input> differs from the previous call's
+  // input. Output is identical to a full GetParseTokens() pass over <input>.
+  // On error the cache is cleared and the error is returned as for
+  // GetParseTokens().
+  zetasql_base::Status GetParseTokens(absl::string_view input,
+                              std::vector<ParseToken>* tokens);
+
+ private:
+  const ParseTokenOptions options_;
+
+  // The previously tokenized input and its token stream.
+  std::string input_;
+  std::vector<ParseToken> tokens_;
+
+  // For each statement, the index of its first token in 'tokens_' and its
+  // starting byte offset in 'input_', in statement order.
+  std::vector<std::pair<int, int>> statement_starts_;
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_PUBLIC_PARSE_TOKENS_H_
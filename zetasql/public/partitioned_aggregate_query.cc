@@ -0,0 +1,210 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/partitioned_aggregate_query.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/function.h"
+#include "zetasql/public/strings.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_node_kind.pb.h"
+#include "zetasql/resolved_ast/sql_builder.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "zetasql/base/map_util.h"
+#include "zetasql/base/source_location.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_builder.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+// Returns the name of the aggregate function that combines per-partition
+// results of 'function', or an error if its results cannot be merged by
+// re-aggregation.
+zetasql_base::StatusOr<std::string> GetMergeFunctionName(const Function* function) {
+  if (function->IsZetaSQLBuiltin()) {
+    const std::string& name = function->Name();
+    // Partial counts merge by summing; the other supported aggregates are
+    // associative and merge with themselves.
+    if (name == "$count_star" || name == "count" || name == "sum") {
+      return std::string("SUM");
+    }
+    if (name == "min") return std::string("MIN");
+    if (name == "max") return std::string("MAX");
+    if (name == "logical_and") return std::string("LOGICAL_AND");
+    if (name == "logical_or") return std::string("LOGICAL_OR");
+    if (name == "bit_and") return std::string("BIT_AND");
+    if (name == "bit_or") return std::string("BIT_OR");
+    if (name == "bit_xor") return std::string("BIT_XOR");
+  }
+  return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+         << "Cannot split query for partitioned execution: no merge function "
+         << "for aggregate function " << function->SQLName();
+}
+
+}  // namespace
+
+zetasql_base::StatusOr<std::unique_ptr<PartitionedAggregateQuery>>
+PartitionedAggregateQuery::Create(const std::string& sql,
+                                  const AnalyzerOptions& analyzer_options,
+                                  Catalog* catalog, TypeFactory* type_factory,
+                                  const Options& options) {
+  ZETASQL_RET_CHECK(catalog != nullptr);
+  ZETASQL_RET_CHECK(type_factory != nullptr);
+
+  std::unique_ptr<const AnalyzerOutput> analyzer_output;
+  ZETASQL_RETURN_IF_ERROR(AnalyzeStatement(sql, analyzer_options, catalog, type_factory,
+                                   &analyzer_output));
+  const ResolvedStatement* statement = analyzer_output->resolved_statement();
+  if (statement->node_kind() != RESOLVED_QUERY_STMT) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+           << "Cannot split statement for partitioned execution: not a "
+           << "query: " << statement->node_kind_string();
+  }
+  const ResolvedQueryStmt* query_stmt = statement->GetAs<ResolvedQueryStmt>();
+
+  // Peel a pass-through projection off the top; the aggregation must be the
+  // outermost operation below it, and the select list must not compute
+  // anything from the aggregation results (those expressions would have to
+  // run after the merge).
+  const ResolvedScan* scan = query_stmt->query();
+  if (scan->node_kind() == RESOLVED_PROJECT_SCAN) {
+    const ResolvedProjectScan* project = scan->GetAs<ResolvedProjectScan>();
+    if (!project->expr_list().empty()) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+             << "Cannot split query for partitioned execution: the select "
+             << "list computes expressions from aggregation results; compute "
+             << "them over the merged output instead";
+    }
+    scan = project->input_scan();
+  }
+  if (scan->node_kind() != RESOLVED_AGGREGATE_SCAN) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+           << "Cannot split query for partitioned execution: the outermost "
+           << "operation is not a GROUP BY aggregation";
+  }
+  const ResolvedAggregateScan* aggregate_scan =
+      scan->GetAs<ResolvedAggregateScan>();
+  if (!aggregate_scan->grouping_set_list().empty() ||
+      !aggregate_scan->rollup_column_list().empty()) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+           << "Cannot split query for partitioned execution: ROLLUP and "
+           << "grouping sets are not supported";
+  }
+
+  auto result = absl::WrapUnique(new PartitionedAggregateQuery);
+
+  // Assign each grouping key and aggregate a stable alias in the partial
+  // output; the merge fragment refers to the partial columns by these
+  // aliases.
+  std::map<int, std::string> column_aliases;   // Column id -> partial alias.
+  std::map<int, std::string> merge_functions;  // Aggregate column id only.
+  std::vector<std::unique_ptr<const ResolvedOutputColumn>> partial_outputs;
+  std::vector<std::string> group_by_aliases;
+  for (const auto& computed : aggregate_scan->group_by_list()) {
+    const std::string alias = absl::StrCat("g", group_by_aliases.size());
+    column_aliases[computed->column().column_id()] = alias;
+    group_by_aliases.push_back(alias);
+    result->partial_columns_.emplace_back(alias, computed->column().type());
+    partial_outputs.push_back(
+        MakeResolvedOutputColumn(alias, computed->column()));
+  }
+  int num_aggregates = 0;
+  for (const auto& computed : aggregate_scan->aggregate_list()) {
+    ZETASQL_RET_CHECK_EQ(computed->expr()->node_kind(),
+                 RESOLVED_AGGREGATE_FUNCTION_CALL);
+    const ResolvedAggregateFunctionCall* call =
+        computed->expr()->GetAs<ResolvedAggregateFunctionCall>();
+    if (call->distinct()) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+             << "Cannot split query for partitioned execution: DISTINCT "
+             << "aggregates cannot be merged across partitions";
+    }
+    if (call->having_modifier() != nullptr ||
+        !call->order_by_item_list().empty() || call->limit() != nullptr ||
+        call->null_handling_modifier() !=
+            ResolvedNonScalarFunctionCallBase::DEFAULT_NULL_HANDLING) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder(ZETASQL_LOC)
+             << "Cannot split query for partitioned execution: aggregate "
+             << "modifiers are not supported";
+    }
+    ZETASQL_ASSIGN_OR_RETURN(const std::string merge_function,
+                     GetMergeFunctionName(call->function()));
+    const std::string alias = absl::StrCat("a", num_aggregates++);
+    column_aliases[computed->column().column_id()] = alias;
+    merge_functions[computed->column().column_id()] = merge_function;
+    result->partial_columns_.emplace_back(alias, computed->column().type());
+    partial_outputs.push_back(
+        MakeResolvedOutputColumn(alias, computed->column()));
+  }
+
+  // Build the merge select list in the original output order, so the merged
+  // result has the same columns as the original query. Grouping keys pass
+  // through; aggregates are re-aggregated with their merge function.
+  std::string select_list;
+  for (const auto& output_column : query_stmt->output_column_list()) {
+    const int column_id = output_column->column().column_id();
+    const std::string* alias = zetasql_base::FindOrNull(column_aliases, column_id);
+    ZETASQL_RET_CHECK(alias != nullptr)
+        << "Output column is not produced by the aggregation: "
+        << output_column->column().DebugString();
+    const std::string* merge_function =
+        zetasql_base::FindOrNull(merge_functions, column_id);
+    std::string term = merge_function != nullptr
+                           ? absl::StrCat(*merge_function, "(", *alias, ")")
+                           : *alias;
+    if (!IsInternalAlias(output_column->name())) {
+      absl::StrAppend(&term, " AS ", ToIdentifierLiteral(output_column->name()));
+    }
+    absl::StrAppend(&select_list, select_list.empty() ? "" : ", ", term);
+  }
+  result->merge_sql_ =
+      absl::StrCat("SELECT ", select_list, " FROM ",
+                   ToIdentifierLiteral(options.partial_results_table_name));
+  if (!group_by_aliases.empty()) {
+    absl::StrAppend(&result->merge_sql_, " GROUP BY ",
+                    absl::StrJoin(group_by_aliases, ", "));
+  }
+
+  // The partial fragment is the aggregation itself, outputting the grouping
+  // keys and unmerged aggregates under the assigned aliases. Everything
+  // below the aggregation (joins, filters, subqueries) is carried along
+  // unchanged into the worker-side SQL.
+  ResolvedASTDeepCopyVisitor copier;
+  ZETASQL_RETURN_IF_ERROR(aggregate_scan->Accept(&copier));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedAggregateScan> scan_copy,
+                   copier.ConsumeRootNode<ResolvedAggregateScan>());
+  const std::unique_ptr<const ResolvedQueryStmt> partial_stmt =
+      MakeResolvedQueryStmt(std::move(partial_outputs),
+                            /*is_value_table=*/false, std::move(scan_copy));
+  SQLBuilder sql_builder;
+  ZETASQL_RETURN_IF_ERROR(partial_stmt->Accept(&sql_builder));
+  result->partial_sql_ = sql_builder.release_sql();
+
+  return std::move(result);
+}
+
+}  // namespace zetasql
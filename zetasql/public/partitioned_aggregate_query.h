@@ -0,0 +1,112 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_PARTITIONED_AGGREGATE_QUERY_H_
+#define ZETASQL_PUBLIC_PARTITIONED_AGGREGATE_QUERY_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/base/statusor.h"
+
+namespace zetasql {
+
+// Splits an aggregate query into two SQL fragments for partitioned execution
+// across hosts: a partial fragment that each worker runs over its partition
+// of the input, and a merge fragment that combines the collected partial rows
+// into the original query's result. Both fragments are plain SQL, so they
+// can be shipped between processes and executed with PreparedQuery (or
+// prepared once and distributed as snapshots, see
+// PreparedQuery::ToSnapshot()).
+//
+// Usage:
+//   1. Each worker prepares partial_sql() against a catalog whose tables
+//      expose only that worker's partition of the data, executes it, and
+//      sends the resulting rows to the coordinator.
+//   2. The coordinator concatenates the partial rows from all workers into a
+//      table named Options::partial_results_table_name with exactly the
+//      columns described by partial_columns() (e.g. a SimpleTable using
+//      SetContents()), registers that table in a catalog, and executes
+//      merge_sql() against it. The merged output has the same columns as the
+//      original query.
+//
+// This is correct for any partitioning of the input rows: the partial
+// fragment groups by the original grouping keys within each partition, and
+// the merge fragment re-aggregates the per-partition results per key using a
+// merge function for each aggregate (e.g. partial COUNT results merge with
+// SUM). The supported query shape is a SELECT whose output columns are
+// grouping keys and aggregate calls directly (no expressions computed from
+// aggregation results, HAVING, ROLLUP or grouping sets), where every
+// aggregate is one of COUNT, SUM, MIN, MAX, LOGICAL_AND, LOGICAL_OR,
+// BIT_AND, BIT_OR or BIT_XOR without DISTINCT or ordering modifiers.
+// Anything else fails Create() with an error naming the construct, so
+// callers can fall back to single-host execution. The shape below the
+// aggregation (joins, filters, subqueries) is unrestricted and runs entirely
+// inside the partial fragment.
+class PartitionedAggregateQuery {
+ public:
+  struct Options {
+    // Name of the table merge_sql() reads the concatenated partial rows
+    // from.
+    std::string partial_results_table_name = "partial_results";
+  };
+
+  // Analyzes <sql> against <catalog> and splits it into fragments. Returns
+  // an error if the query does not have the supported shape described in the
+  // class comment. Does not take ownership of <catalog> or <type_factory>;
+  // <type_factory> must outlive the returned object (the types in
+  // partial_columns() are allocated from it).
+  static zetasql_base::StatusOr<std::unique_ptr<PartitionedAggregateQuery>> Create(
+      const std::string& sql, const AnalyzerOptions& analyzer_options,
+      Catalog* catalog, TypeFactory* type_factory,
+      const Options& options = Options());
+
+  PartitionedAggregateQuery(const PartitionedAggregateQuery&) = delete;
+  PartitionedAggregateQuery& operator=(const PartitionedAggregateQuery&) =
+      delete;
+
+  // SQL each worker runs over its partition of the input.
+  const std::string& partial_sql() const { return partial_sql_; }
+
+  // Schema of the rows produced by partial_sql(), in order: the grouping
+  // keys (aliased g0, g1, ...) followed by the unmerged aggregates (aliased
+  // a0, a1, ...). The table merge_sql() reads must have exactly these
+  // columns.
+  using NameAndType = std::pair<std::string, const Type*>;
+  const std::vector<NameAndType>& partial_columns() const {
+    return partial_columns_;
+  }
+
+  // SQL the coordinator runs over the table of concatenated partial rows to
+  // produce the original query's result.
+  const std::string& merge_sql() const { return merge_sql_; }
+
+ private:
+  PartitionedAggregateQuery() = default;
+
+  std::string partial_sql_;
+  std::string merge_sql_;
+  std::vector<NameAndType> partial_columns_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_PARTITIONED_AGGREGATE_QUERY_H_
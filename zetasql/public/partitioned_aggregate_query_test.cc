@@ -0,0 +1,198 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/partitioned_aggregate_query.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/evaluator.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using ::testing::UnorderedElementsAreArray;
+using ::zetasql_base::testing::StatusIs;
+
+// Executes <sql> against a catalog holding a single table <table_name> with
+// the given columns and contents, returning the result rows.
+zetasql_base::StatusOr<std::vector<std::vector<Value>>> RunOverTable(
+    const std::string& sql, const std::string& table_name,
+    const std::vector<SimpleTable::NameAndType>& columns,
+    const std::vector<std::vector<Value>>& rows, TypeFactory* type_factory) {
+  SimpleCatalog catalog("catalog", type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+  SimpleTable table(table_name, columns);
+  table.SetContents(rows);
+  catalog.AddTable(&table);
+
+  EvaluatorOptions evaluator_options;
+  evaluator_options.type_factory = type_factory;
+  PreparedQuery query(sql, evaluator_options);
+  ZETASQL_RETURN_IF_ERROR(query.Prepare(analyzer_options, &catalog));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> iter,
+                   query.Execute());
+  std::vector<std::vector<Value>> result;
+  while (iter->NextRow()) {
+    std::vector<Value> row;
+    row.reserve(iter->NumColumns());
+    for (int i = 0; i < iter->NumColumns(); ++i) {
+      row.push_back(iter->GetValue(i));
+    }
+    result.push_back(std::move(row));
+  }
+  ZETASQL_RETURN_IF_ERROR(iter->Status());
+  return result;
+}
+
+TEST(PartitionedAggregateQueryTest, MatchesSingleHostExecution) {
+  TypeFactory type_factory;
+  const std::vector<SimpleTable::NameAndType> t_columns = {
+      {"k", types::StringType()}, {"x", types::Int64Type()}};
+  const std::vector<std::vector<Value>> partition1 = {
+      {Value::String("a"), Value::Int64(1)},
+      {Value::String("b"), Value::Int64(2)},
+      {Value::String("a"), Value::Int64(3)}};
+  const std::vector<std::vector<Value>> partition2 = {
+      {Value::String("a"), Value::Int64(5)},
+      {Value::String("c"), Value::NullInt64()}};
+  std::vector<std::vector<Value>> all_rows = partition1;
+  all_rows.insert(all_rows.end(), partition2.begin(), partition2.end());
+
+  const std::string sql =
+      "select k, count(*) as c, sum(x) as s, min(x) as mn from t group by k";
+
+  // Fragment the query against a catalog describing the full table schema.
+  SimpleCatalog catalog("catalog", &type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+  SimpleTable table("t", t_columns);
+  catalog.AddTable(&table);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PartitionedAggregateQuery> fragments,
+      PartitionedAggregateQuery::Create(sql, analyzer_options, &catalog,
+                                        &type_factory));
+
+  ASSERT_EQ(fragments->partial_columns().size(), 4);
+  EXPECT_EQ(fragments->partial_columns()[0].first, "g0");
+  EXPECT_EQ(fragments->partial_columns()[1].first, "a0");
+  // Partial counts merge by summing.
+  EXPECT_THAT(fragments->merge_sql(), HasSubstr("SUM(a0)"));
+  EXPECT_THAT(fragments->merge_sql(), HasSubstr("GROUP BY g0"));
+
+  // Run the partial fragment over each partition, as a worker would.
+  std::vector<std::vector<Value>> partial_rows;
+  for (const auto* partition : {&partition1, &partition2}) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        const std::vector<std::vector<Value>> rows,
+        RunOverTable(fragments->partial_sql(), "t", t_columns, *partition,
+                     &type_factory));
+    partial_rows.insert(partial_rows.end(), rows.begin(), rows.end());
+  }
+
+  // Merge the concatenated partial rows, as the coordinator would.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::vector<std::vector<Value>> merged,
+      RunOverTable(fragments->merge_sql(), "partial_results",
+                   fragments->partial_columns(), partial_rows, &type_factory));
+
+  // The merged result must match running the original query over all rows.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::vector<std::vector<Value>> expected,
+      RunOverTable(sql, "t", t_columns, all_rows, &type_factory));
+  EXPECT_THAT(merged, UnorderedElementsAreArray(expected));
+}
+
+TEST(PartitionedAggregateQueryTest, GlobalAggregationHasNoGroupBy) {
+  TypeFactory type_factory;
+  const std::vector<SimpleTable::NameAndType> t_columns = {
+      {"x", types::Int64Type()}};
+  SimpleCatalog catalog("catalog", &type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+  SimpleTable table("t", t_columns);
+  catalog.AddTable(&table);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PartitionedAggregateQuery> fragments,
+      PartitionedAggregateQuery::Create("select sum(x) as s from t",
+                                        analyzer_options, &catalog,
+                                        &type_factory));
+  EXPECT_THAT(fragments->merge_sql(), Not(HasSubstr("GROUP BY")));
+
+  const std::vector<std::vector<Value>> partition1 = {{Value::Int64(1)},
+                                                      {Value::Int64(2)}};
+  const std::vector<std::vector<Value>> partition2 = {{Value::Int64(39)}};
+  std::vector<std::vector<Value>> partial_rows;
+  for (const auto* partition : {&partition1, &partition2}) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        const std::vector<std::vector<Value>> rows,
+        RunOverTable(fragments->partial_sql(), "t", t_columns, *partition,
+                     &type_factory));
+    partial_rows.insert(partial_rows.end(), rows.begin(), rows.end());
+  }
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const std::vector<std::vector<Value>> merged,
+      RunOverTable(fragments->merge_sql(), "partial_results",
+                   fragments->partial_columns(), partial_rows, &type_factory));
+  ASSERT_EQ(merged.size(), 1);
+  EXPECT_EQ(merged[0][0], Value::Int64(42));
+}
+
+TEST(PartitionedAggregateQueryTest, RejectsNonMergeableAggregate) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  AnalyzerOptions analyzer_options;
+  catalog.AddZetaSQLFunctions(analyzer_options.language());
+  SimpleTable table("t", {{"x", types::Int64Type()}});
+  catalog.AddTable(&table);
+
+  EXPECT_THAT(PartitionedAggregateQuery::Create("select avg(x) as a from t",
+                                                analyzer_options, &catalog,
+                                                &type_factory)
+                  .status(),
+              StatusIs(zetasql_base::INVALID_ARGUMENT,
+                       HasSubstr("no merge function")));
+  EXPECT_THAT(
+      PartitionedAggregateQuery::Create("select count(distinct x) as c from t",
+                                        analyzer_options, &catalog,
+                                        &type_factory)
+          .status(),
+      StatusIs(zetasql_base::INVALID_ARGUMENT, HasSubstr("DISTINCT")));
+  EXPECT_THAT(
+      PartitionedAggregateQuery::Create("select x from t", analyzer_options,
+                                        &catalog, &type_factory)
+          .status(),
+      StatusIs(zetasql_base::INVALID_ARGUMENT,
+               HasSubstr("not a GROUP BY aggregation")));
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -16,6 +16,7 @@
 
 #include "zetasql/public/proto_util.h"
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -870,108 +871,90 @@ using ElementValueList = std::vector<std::vector<zetasql_base::StatusOr<Value>>>
 
 }  // namespace
 
-zetasql_base::Status ReadProtoFields(
-    absl::Span<const ProtoFieldInfo* const> field_infos,
-    const std::string& bytes,
-    ProtoFieldValueList* field_value_list) {
-  const bool use_optimization =
-      field_infos.size() == 1 &&
-      absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path);
-
-  if (use_optimization) {
-    ZETASQL_ASSIGN_OR_RETURN(zetasql_base::StatusOr<Value> value,
-                     ReadSingularProtoField(*field_infos[0], bytes));
-    field_value_list->push_back(std::move(value));
-    return zetasql_base::OkStatus();
-  }
-
-  field_value_list->resize(field_infos.size());
-
+static FieldInfoMap BuildFieldInfoMap(
+    absl::Span<const ProtoFieldInfo* const> field_infos) {
   FieldInfoMap field_info_map;
   for (int i = 0; i < field_infos.size(); ++i) {
-    const ProtoFieldInfo* field_info = field_infos[i];
-    field_info_map[field_info->descriptor->number()].push_back(i);
+    field_info_map[field_infos[i]->descriptor->number()].push_back(i);
   }
+  return field_info_map;
+}
 
-  // If get_has_bit is true, this is either empty or contains a single
-  // Value::Bool(true).
-  ElementValueList element_value_list(field_infos.size());
-  ZETASQL_RET_CHECK(!field_infos.empty());
-  const google::protobuf::FieldDescriptor* some_field = field_infos[0]->descriptor;
-    uint32_t tag_and_type;
-    google::protobuf::io::ArrayInputStream cord_stream(bytes.data(), bytes.size());
-    google::protobuf::io::CodedInputStream in(&cord_stream);
-    while (0 < (tag_and_type = in.ReadTag())) {
-      const int tag_number = WireFormatLite::GetTagFieldNumber(tag_and_type);
-      const std::vector<int>* info_idxs =
-          zetasql_base::FindOrNull(field_info_map, tag_number);
-      if (info_idxs == nullptr) {
-        if (ABSL_PREDICT_TRUE(WireFormatLite::SkipField(&in, tag_and_type))) {
-          continue;
-        }
-        return ::zetasql_base::OutOfRangeErrorBuilder()
-               << "Corrupted protocol buffer: "
-               << "Failed to skip field with tag number " << tag_number
-               << " in " << some_field->containing_type()->full_name();
-      }
-      // All of the field descriptors must come from the same
-      // google::protobuf::Descriptor, so for a particular tag number, they are all the
-      // same.
-      ZETASQL_RET_CHECK(!info_idxs->empty());
-      const google::protobuf::FieldDescriptor* descriptor =
-          field_infos[(*info_idxs)[0]]->descriptor;
-
-      PackedValuesVector wire_values;
-      // Protocol buffer parsers must be able to parse repeated fields that were
-      // compiled as packed as if they were not packed, and vice versa.  Both
-      // packed and non-packed field occurrences may appear within the same
-      // message.
-      if (descriptor->is_packable() && IsPackedWireType(tag_and_type)) {
-        if (ABSL_PREDICT_FALSE(!ReadPackedWireValues(
-                descriptor->number(), descriptor->type(), &in, &wire_values))) {
-          return ::zetasql_base::OutOfRangeErrorBuilder()
-                 << "Corrupted protocol buffer: "
-                 << "Failed to read packed elements for field "
-                 << descriptor->full_name();
-        }
-      } else {
-        WireValueType wire_value;
-        if (ABSL_PREDICT_FALSE(!ReadWireValue(descriptor->type(), tag_and_type,
-                                              bytes, &in, &wire_value))) {
-          return zetasql_base::OutOfRangeErrorBuilder()
-                 << "Corrupted protocol buffer: Failed to read value for field "
-                 << descriptor->full_name();
-        }
-        wire_values.push_back(std::move(wire_value));
-      }
-      ZETASQL_RET_CHECK(!wire_values.empty());
+// Reads the wire value(s) for one occurrence of a tag (whose tag-and-type
+// word 'tag_and_type' has already been consumed from 'in') and appends the
+// translated elements for every interested ProtoFieldInfo (the indexes in
+// 'info_idxs') to 'element_value_list'.
+static zetasql_base::Status ReadTagOccurrence(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const std::vector<int>& info_idxs, uint32_t tag_and_type,
+    const std::string& bytes,
+    google::protobuf::io::CodedInputStream* in,
+    ElementValueList* element_value_list) {
+  // All of the field descriptors must come from the same
+  // google::protobuf::Descriptor, so for a particular tag number, they are all the
+  // same.
+  ZETASQL_RET_CHECK(!info_idxs.empty());
+  const google::protobuf::FieldDescriptor* descriptor =
+      field_infos[info_idxs[0]]->descriptor;
+
+  PackedValuesVector wire_values;
+  // Protocol buffer parsers must be able to parse repeated fields that were
+  // compiled as packed as if they were not packed, and vice versa.  Both
+  // packed and non-packed field occurrences may appear within the same
+  // message.
+  if (descriptor->is_packable() && IsPackedWireType(tag_and_type)) {
+    if (ABSL_PREDICT_FALSE(!ReadPackedWireValues(
+            descriptor->number(), descriptor->type(), in, &wire_values))) {
+      return ::zetasql_base::OutOfRangeErrorBuilder()
+             << "Corrupted protocol buffer: "
+             << "Failed to read packed elements for field "
+             << descriptor->full_name();
+    }
+  } else {
+    WireValueType wire_value;
+    if (ABSL_PREDICT_FALSE(!ReadWireValue(descriptor->type(), tag_and_type,
+                                          bytes, in, &wire_value))) {
+      return zetasql_base::OutOfRangeErrorBuilder()
+             << "Corrupted protocol buffer: Failed to read value for field "
+             << descriptor->full_name();
+    }
+    wire_values.push_back(std::move(wire_value));
+  }
+  ZETASQL_RET_CHECK(!wire_values.empty());
 
-      for (int i = 0; i < info_idxs->size(); ++i) {
-        const int idx = (*info_idxs)[i];
-        const ProtoFieldInfo* info = field_infos[idx];
-        std::vector<zetasql_base::StatusOr<Value>>& elements = element_value_list[idx];
+  for (int i = 0; i < info_idxs.size(); ++i) {
+    const int idx = info_idxs[i];
+    const ProtoFieldInfo* info = field_infos[idx];
+    std::vector<zetasql_base::StatusOr<Value>>& elements = (*element_value_list)[idx];
 
-        if (info->get_has_bit) {
-          if (elements.empty()) {
-            elements.push_back(Value::Bool(true));
-          }
-        } else {
-          const Type* element_type = info->type->IsArray()
-                                         ? info->type->AsArray()->element_type()
-                                         : info->type;
-          for (const WireValueType& wire_value : wire_values) {
-            elements.push_back(TranslateWireValue(wire_value, descriptor,
-                                                  info->format, element_type));
-          }
-        }
+    if (info->get_has_bit) {
+      if (elements.empty()) {
+        elements.push_back(Value::Bool(true));
+      }
+    } else {
+      const Type* element_type = info->type->IsArray()
+                                     ? info->type->AsArray()->element_type()
+                                     : info->type;
+      for (const WireValueType& wire_value : wire_values) {
+        elements.push_back(TranslateWireValue(wire_value, descriptor,
+                                              info->format, element_type));
       }
     }
+  }
+  return zetasql_base::OkStatus();
+}
 
-  // Now that we have read all of the values we care about, use them to populate
-  // 'field_value_list'.
+// Assembles the final per-field results from the raw elements collected
+// during a scan: concatenates repeated elements into arrays, takes the last
+// occurrence of scalars, and fills in defaults, has bits, and
+// missing-required-field errors for fields with no occurrences.
+static zetasql_base::Status AssembleProtoFieldValueList(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    ElementValueList* element_value_list,
+    ProtoFieldValueList* field_value_list) {
   for (int i = 0; i < field_infos.size(); ++i) {
     const ProtoFieldInfo* info = field_infos[i];
-    std::vector<zetasql_base::StatusOr<Value>>& values = element_value_list[i];
+    std::vector<zetasql_base::StatusOr<Value>>& values = (*element_value_list)[i];
     if (info->get_has_bit) {
       (*field_value_list)[i] = Value::Bool(!values.empty());
     } else {
@@ -1012,6 +995,159 @@ zetasql_base::Status ReadProtoFields(
   return zetasql_base::OkStatus();
 }
 
+// Shared implementation of ReadProtoFields() and ReadProtoFieldsBatch().
+// Scans 'bytes' once and extracts the fields in 'field_infos'.
+// 'field_info_map' must map each tag number appearing in 'field_infos' to the
+// indexes of its ProtoFieldInfos; passing it in lets batch callers build it
+// once and reuse it for every row.
+static zetasql_base::Status ReadProtoFieldsInternal(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const FieldInfoMap& field_info_map,
+    const std::string& bytes,
+    ProtoFieldValueList* field_value_list) {
+  field_value_list->resize(field_infos.size());
+
+  // If get_has_bit is true, this is either empty or contains a single
+  // Value::Bool(true).
+  ElementValueList element_value_list(field_infos.size());
+  ZETASQL_RET_CHECK(!field_infos.empty());
+  const google::protobuf::FieldDescriptor* some_field = field_infos[0]->descriptor;
+    uint32_t tag_and_type;
+    google::protobuf::io::ArrayInputStream cord_stream(bytes.data(), bytes.size());
+    google::protobuf::io::CodedInputStream in(&cord_stream);
+    while (0 < (tag_and_type = in.ReadTag())) {
+      const int tag_number = WireFormatLite::GetTagFieldNumber(tag_and_type);
+      const std::vector<int>* info_idxs =
+          zetasql_base::FindOrNull(field_info_map, tag_number);
+      if (info_idxs == nullptr) {
+        if (ABSL_PREDICT_TRUE(WireFormatLite::SkipField(&in, tag_and_type))) {
+          continue;
+        }
+        return ::zetasql_base::OutOfRangeErrorBuilder()
+               << "Corrupted protocol buffer: "
+               << "Failed to skip field with tag number " << tag_number
+               << " in " << some_field->containing_type()->full_name();
+      }
+      ZETASQL_RETURN_IF_ERROR(ReadTagOccurrence(field_infos, *info_idxs, tag_and_type,
+                                        bytes, &in, &element_value_list));
+    }
+
+  // Now that we have read all of the values we care about, use them to populate
+  // 'field_value_list'.
+  return AssembleProtoFieldValueList(field_infos, &element_value_list,
+                                     field_value_list);
+}
+
+zetasql_base::Status BuildProtoWireOffsetIndex(const std::string& bytes,
+                                       ProtoWireOffsetIndex* index) {
+  ZETASQL_RET_CHECK(index->empty());
+  google::protobuf::io::ArrayInputStream cord_stream(bytes.data(), bytes.size());
+  google::protobuf::io::CodedInputStream in(&cord_stream);
+  uint32_t tag_and_type;
+  int offset = in.CurrentPosition();
+  while (0 < (tag_and_type = in.ReadTag())) {
+    const int tag_number = WireFormatLite::GetTagFieldNumber(tag_and_type);
+    (*index)[tag_number].push_back(offset);
+    if (ABSL_PREDICT_FALSE(!WireFormatLite::SkipField(&in, tag_and_type))) {
+      return ::zetasql_base::OutOfRangeErrorBuilder()
+             << "Corrupted protocol buffer: "
+             << "Failed to skip field with tag number " << tag_number;
+    }
+    offset = in.CurrentPosition();
+  }
+  return zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ReadProtoFieldsWithOffsetIndex(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const std::string& bytes,
+    const ProtoWireOffsetIndex& index,
+    ProtoFieldValueList* field_value_list) {
+  ZETASQL_RET_CHECK(!field_infos.empty());
+  field_value_list->resize(field_infos.size());
+
+  const FieldInfoMap field_info_map = BuildFieldInfoMap(field_infos);
+  ElementValueList element_value_list(field_infos.size());
+  // The iteration order over tag numbers does not matter: the element order
+  // that ReadProtoFields() guarantees only relates occurrences of the same
+  // tag, and those are visited in wire (offset) order here.
+  for (const auto& entry : field_info_map) {
+    const std::vector<int>* offsets = zetasql_base::FindOrNull(index, entry.first);
+    if (offsets == nullptr) continue;
+    for (const int offset : *offsets) {
+      google::protobuf::io::ArrayInputStream cord_stream(bytes.data(), bytes.size());
+      google::protobuf::io::CodedInputStream in(&cord_stream);
+      ZETASQL_RET_CHECK(in.Skip(offset)) << "Wire offset index does not match message";
+      const uint32_t tag_and_type = in.ReadTag();
+      ZETASQL_RET_CHECK_EQ(WireFormatLite::GetTagFieldNumber(tag_and_type), entry.first)
+          << "Wire offset index does not match message";
+      ZETASQL_RETURN_IF_ERROR(ReadTagOccurrence(field_infos, entry.second, tag_and_type,
+                                        bytes, &in, &element_value_list));
+    }
+  }
+
+  return AssembleProtoFieldValueList(field_infos, &element_value_list,
+                                     field_value_list);
+}
+
+zetasql_base::Status ReadProtoFields(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const std::string& bytes,
+    ProtoFieldValueList* field_value_list) {
+  const bool use_optimization =
+      field_infos.size() == 1 &&
+      absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path);
+
+  if (use_optimization) {
+    ZETASQL_ASSIGN_OR_RETURN(zetasql_base::StatusOr<Value> value,
+                     ReadSingularProtoField(*field_infos[0], bytes));
+    field_value_list->push_back(std::move(value));
+    return zetasql_base::OkStatus();
+  }
+
+  return ReadProtoFieldsInternal(field_infos, BuildFieldInfoMap(field_infos),
+                                 bytes, field_value_list);
+}
+
+zetasql_base::Status ReadProtoFieldsBatch(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    absl::Span<const std::string> rows,
+    std::vector<ProtoFieldValueList>* field_columns) {
+  ZETASQL_RET_CHECK(!field_infos.empty());
+  field_columns->clear();
+  field_columns->resize(field_infos.size());
+  for (ProtoFieldValueList& column : *field_columns) {
+    column.reserve(rows.size());
+  }
+
+  const bool use_optimization =
+      field_infos.size() == 1 &&
+      absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path);
+
+  FieldInfoMap field_info_map;
+  if (!use_optimization) {
+    field_info_map = BuildFieldInfoMap(field_infos);
+  }
+
+  ProtoFieldValueList row_values;
+  for (const std::string& bytes : rows) {
+    row_values.clear();
+    if (use_optimization) {
+      ZETASQL_ASSIGN_OR_RETURN(zetasql_base::StatusOr<Value> value,
+                       ReadSingularProtoField(*field_infos[0], bytes));
+      row_values.push_back(std::move(value));
+    } else {
+      ZETASQL_RETURN_IF_ERROR(ReadProtoFieldsInternal(field_infos, field_info_map,
+                                              bytes, &row_values));
+    }
+    for (int i = 0; i < field_infos.size(); ++i) {
+      (*field_columns)[i].push_back(std::move(row_values[i]));
+    }
+  }
+
+  return zetasql_base::OkStatus();
+}
+
 zetasql_base::Status ReadProtoField(
     const google::protobuf::FieldDescriptor* field_descr, FieldFormat::Format format,
     const Type* type, const Value& default_value, bool get_has_bit,
@@ -1065,4 +1201,248 @@ zetasql_base::Status ProtoHasField(
   return ::zetasql_base::OkStatus();
 }
 
+// Inverse of Int64ToAdjustedTimestampInt64: converts a timestamp in micros to
+// the integer stored in a field with timestamp format 'format'. Requires the
+// timestamp to be exactly representable at the format's precision, so the
+// written field reads back as the same timestamp.
+static zetasql_base::Status MicrosToFormattedTimestampInt64(FieldFormat::Format format,
+                                                    int64_t micros,
+                                                    int64_t* formatted) {
+  switch (format) {
+    case FieldFormat::TIMESTAMP_SECONDS:
+      if (micros % 1000000 != 0) {
+        return ::zetasql_base::OutOfRangeErrorBuilder()
+               << "Cannot encode timestamp with sub-second precision "
+               << "in a TIMESTAMP_SECONDS field: " << micros;
+      }
+      *formatted = micros / 1000000;
+      break;
+    case FieldFormat::TIMESTAMP_MILLIS:
+      if (micros % 1000 != 0) {
+        return ::zetasql_base::OutOfRangeErrorBuilder()
+               << "Cannot encode timestamp with sub-millisecond precision "
+               << "in a TIMESTAMP_MILLIS field: " << micros;
+      }
+      *formatted = micros / 1000;
+      break;
+    case FieldFormat::TIMESTAMP_MICROS:
+      *formatted = micros;
+      break;
+    default:
+      return ::zetasql_base::OutOfRangeErrorBuilder()
+             << "Invalid timestamp field format: " << format;
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+// Returns the integer to store on the wire for 'value', applying 'format'.
+// This is the inverse of the integer handling in TranslateWireValue().
+static zetasql_base::StatusOr<int64_t> WireInt64FromValue(const Value& value,
+                                                  FieldFormat::Format format) {
+  switch (value.type_kind()) {
+    case TYPE_INT32:
+      return value.int32_value();
+    case TYPE_INT64:
+      return value.int64_value();
+    case TYPE_UINT32:
+      return value.uint32_value();
+    case TYPE_ENUM:
+      return value.enum_value();
+    case TYPE_DATE: {
+      int32_t formatted_date;
+      ZETASQL_RETURN_IF_ERROR(functions::EncodeFormattedDate(value.date_value(), format,
+                                                     &formatted_date));
+      return formatted_date;
+    }
+    case TYPE_TIMESTAMP: {
+      int64_t formatted_timestamp;
+      ZETASQL_RETURN_IF_ERROR(MicrosToFormattedTimestampInt64(
+          format, value.ToUnixMicros(), &formatted_timestamp));
+      return formatted_timestamp;
+    }
+    case TYPE_TIME:
+      return value.ToPacked64TimeMicros();
+    case TYPE_DATETIME:
+      return value.ToPacked64DatetimeMicros();
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected type kind in WireInt64FromValue(): "
+                       << TypeKind_Name(value.type_kind());
+  }
+}
+
+ProtoBuilderPlan::ProtoBuilderPlan(const google::protobuf::Descriptor* descriptor,
+                                   absl::Span<const FieldAndFormat> fields) {
+  fields_.reserve(fields.size());
+  for (const FieldAndFormat& field_and_format : fields) {
+    const google::protobuf::FieldDescriptor* field = field_and_format.first;
+    CHECK_EQ(field->containing_type(), descriptor) << field->full_name();
+    TypeKind kind;
+    const zetasql_base::Status status = ProtoType::FieldDescriptorToTypeKindBase(
+        /*ignore_annotations=*/false, field, &kind);
+    CHECK(status.ok()) << field->full_name() << ": " << status.message();
+    fields_.push_back(FieldPlan{field, field_and_format.second, kind});
+  }
+}
+
+zetasql_base::Status ProtoBuilderPlan::BuildProto(absl::Span<const Value> values,
+                                          std::string* bytes) const {
+  ZETASQL_RET_CHECK_EQ(values.size(), fields_.size());
+  google::protobuf::io::StringOutputStream stream(bytes);
+  google::protobuf::io::CodedOutputStream out(&stream);
+  for (int i = 0; i < fields_.size(); ++i) {
+    const FieldPlan& field_plan = fields_[i];
+    const Value& value = values[i];
+    if (field_plan.descriptor->is_repeated()) {
+      ZETASQL_RET_CHECK_EQ(value.type_kind(), TYPE_ARRAY)
+          << field_plan.descriptor->full_name();
+      // A NULL array writes no occurrences, like an empty array.
+      if (value.is_null()) continue;
+      for (const Value& element : value.elements()) {
+        if (element.is_null()) {
+          return ::zetasql_base::OutOfRangeErrorBuilder()
+                 << "Cannot encode a null value in repeated proto field "
+                 << field_plan.descriptor->full_name();
+        }
+        ZETASQL_RETURN_IF_ERROR(WriteSingleValue(field_plan, element, &out));
+      }
+    } else {
+      if (value.is_null()) {
+        if (field_plan.descriptor->is_required()) {
+          return ::zetasql_base::OutOfRangeErrorBuilder()
+                 << "Cannot encode a null value in required proto field "
+                 << field_plan.descriptor->full_name();
+        }
+        continue;
+      }
+      ZETASQL_RETURN_IF_ERROR(WriteSingleValue(field_plan, value, &out));
+    }
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ProtoBuilderPlan::WriteSingleValue(
+    const FieldPlan& field_plan, const Value& value,
+    google::protobuf::io::CodedOutputStream* out) {
+  const google::protobuf::FieldDescriptor* field = field_plan.descriptor;
+  ZETASQL_RET_CHECK_EQ(value.type_kind(), field_plan.kind) << field->full_name();
+  const int number = field->number();
+  switch (field->type()) {
+    case google::protobuf::FieldDescriptor::TYPE_INT32:
+    case google::protobuf::FieldDescriptor::TYPE_SINT32:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED32: {
+      ZETASQL_ASSIGN_OR_RETURN(const int64_t v,
+                       WireInt64FromValue(value, field_plan.format));
+      if (v < std::numeric_limits<int32_t>::min() ||
+          v > std::numeric_limits<int32_t>::max()) {
+        return ::zetasql_base::OutOfRangeErrorBuilder()
+               << "Cannot encode value in proto field " << field->full_name()
+               << ": " << v;
+      }
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_INT32) {
+        WireFormatLite::WriteInt32(number, v, out);
+      } else if (field->type() == google::protobuf::FieldDescriptor::TYPE_SINT32) {
+        WireFormatLite::WriteSInt32(number, v, out);
+      } else {
+        WireFormatLite::WriteSFixed32(number, v, out);
+      }
+      return ::zetasql_base::OkStatus();
+    }
+    case google::protobuf::FieldDescriptor::TYPE_INT64:
+    case google::protobuf::FieldDescriptor::TYPE_SINT64:
+    case google::protobuf::FieldDescriptor::TYPE_SFIXED64: {
+      ZETASQL_ASSIGN_OR_RETURN(const int64_t v,
+                       WireInt64FromValue(value, field_plan.format));
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_INT64) {
+        WireFormatLite::WriteInt64(number, v, out);
+      } else if (field->type() == google::protobuf::FieldDescriptor::TYPE_SINT64) {
+        WireFormatLite::WriteSInt64(number, v, out);
+      } else {
+        WireFormatLite::WriteSFixed64(number, v, out);
+      }
+      return ::zetasql_base::OkStatus();
+    }
+    case google::protobuf::FieldDescriptor::TYPE_UINT32:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED32: {
+      uint32_t v;
+      if (field_plan.kind == TYPE_UINT32) {
+        v = value.uint32_value();
+      } else {
+        ZETASQL_ASSIGN_OR_RETURN(const int64_t wire_int,
+                         WireInt64FromValue(value, field_plan.format));
+        if (wire_int < 0 || wire_int > std::numeric_limits<uint32_t>::max()) {
+          return ::zetasql_base::OutOfRangeErrorBuilder()
+                 << "Cannot encode value in proto field " << field->full_name()
+                 << ": " << wire_int;
+        }
+        v = wire_int;
+      }
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_UINT32) {
+        WireFormatLite::WriteUInt32(number, v, out);
+      } else {
+        WireFormatLite::WriteFixed32(number, v, out);
+      }
+      return ::zetasql_base::OkStatus();
+    }
+    case google::protobuf::FieldDescriptor::TYPE_UINT64:
+    case google::protobuf::FieldDescriptor::TYPE_FIXED64: {
+      uint64_t v;
+      if (field_plan.kind == TYPE_UINT64) {
+        v = value.uint64_value();
+      } else {
+        // Mirrors the read side, which bit_casts uint64 wire values to int64_t
+        // for annotated date/time fields.
+        ZETASQL_ASSIGN_OR_RETURN(const int64_t wire_int,
+                         WireInt64FromValue(value, field_plan.format));
+        v = absl::bit_cast<uint64_t>(wire_int);
+      }
+      if (field->type() == google::protobuf::FieldDescriptor::TYPE_UINT64) {
+        WireFormatLite::WriteUInt64(number, v, out);
+      } else {
+        WireFormatLite::WriteFixed64(number, v, out);
+      }
+      return ::zetasql_base::OkStatus();
+    }
+    case google::protobuf::FieldDescriptor::TYPE_BOOL:
+      WireFormatLite::WriteBool(number, value.bool_value(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_ENUM:
+      WireFormatLite::WriteEnum(number, value.enum_value(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_FLOAT:
+      WireFormatLite::WriteFloat(number, value.float_value(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+      WireFormatLite::WriteDouble(number, value.double_value(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_STRING:
+      WireFormatLite::WriteString(number, value.string_value(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_BYTES:
+      if (field_plan.kind == TYPE_NUMERIC) {
+        WireFormatLite::WriteBytes(
+            number, value.numeric_value().SerializeAsProtoBytes(), out);
+      } else {
+        WireFormatLite::WriteBytes(number, value.bytes_value(), out);
+      }
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
+      // A proto Value already holds the serialized submessage.
+      WireFormatLite::WriteBytes(number, value.ToCord(), out);
+      return ::zetasql_base::OkStatus();
+    case google::protobuf::FieldDescriptor::TYPE_GROUP: {
+      // The stored bytes of a group-typed value are the group contents
+      // without delimiters, matching what ReadWireValue() extracts.
+      out->WriteVarint32(WireFormatLite::MakeTag(
+          number, WireFormatLite::WIRETYPE_START_GROUP));
+      const std::string group_bytes = value.ToCord();
+      out->WriteRaw(group_bytes.data(), group_bytes.size());
+      out->WriteVarint32(WireFormatLite::MakeTag(
+          number, WireFormatLite::WIRETYPE_END_GROUP));
+      return ::zetasql_base::OkStatus();
+    }
+  }
+  ZETASQL_RET_CHECK_FAIL() << "Unexpected field type in WriteSingleValue(): "
+                   << field->DebugString();
+}
+
 }  // namespace zetasql
@@ -17,8 +17,11 @@
 #ifndef ZETASQL_PUBLIC_PROTO_UTIL_H_
 #define ZETASQL_PUBLIC_PROTO_UTIL_H_
 
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
 #include "zetasql/public/type.h"
@@ -126,6 +129,41 @@ zetasql_base::Status ReadProtoFields(
     const std::string& bytes,
     ProtoFieldValueList* field_value_list);
 
+// Batch form of ReadProtoFields(). Each element of 'rows' is a serialized
+// proto of the common google::protobuf::Descriptor; each row's wire format is scanned
+// exactly once, extracting all fields in 'field_infos' together, and the
+// per-tag lookup structures are built once and shared across rows. The output
+// is columnar: on return, (*field_columns)[i][j] is the value (or error) of
+// field_infos[i] in rows[j], exactly as ReadProtoFields() would have produced
+// for that row.
+zetasql_base::Status ReadProtoFieldsBatch(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    absl::Span<const std::string> rows,
+    std::vector<ProtoFieldValueList>* field_columns);
+
+// Maps a field tag number to the byte offsets within a serialized proto at
+// which each occurrence of that tag begins, in wire order.
+using ProtoWireOffsetIndex = absl::flat_hash_map<int, std::vector<int>>;
+
+// Scans the (tag, value) pairs in 'bytes' once and records where every field
+// occurrence begins in 'index' (which must be empty). The index remains valid
+// for any byte-identical serialization of the message.
+zetasql_base::Status BuildProtoWireOffsetIndex(const std::string& bytes,
+                                       ProtoWireOffsetIndex* index);
+
+// Like ReadProtoFields(), but instead of scanning every (tag, value) pair in
+// 'bytes', uses 'index' (which must have been built from 'bytes') to jump
+// directly to the occurrences of the requested fields. Produces exactly the
+// same 'field_value_list' as ReadProtoFields(). Worthwhile when the same
+// message is read more than once (e.g., by expressions with different field
+// sets), since each read then skips the unrequested fields instead of
+// re-scanning the whole message from byte 0.
+zetasql_base::Status ReadProtoFieldsWithOffsetIndex(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const std::string& bytes,
+    const ProtoWireOffsetIndex& index,
+    ProtoFieldValueList* field_value_list);
+
 // Convenience form of ReadProtoFields() for reading a single field. Reads the
 // proto field matching tag and type of 'field_descr' from 'bytes' and returns
 // the result in 'output_value'. If 'tag' is missing in 'bytes', returns
@@ -158,6 +196,60 @@ zetasql_base::Status ProtoHasField(
     const std::string& bytes,
     bool* has_field);
 
+// A compiled plan for building serialized protos from per-field values
+// without materializing a google::protobuf::Message. The field layout (wire types,
+// expected value kinds and format annotations) is resolved from the
+// FieldDescriptors once at construction — e.g. at algebrize time — so that
+// per-row proto construction reduces to encoding each value straight to wire
+// bytes.
+//
+// Values are encoded with the inverse of the translation ReadProtoFields()
+// applies when reading, so a value written through a plan reads back
+// unchanged. The field descriptors must all belong to 'descriptor' and must
+// outlive the plan. The same field may appear more than once; occurrences are
+// written in plan order, so for scalar fields the last occurrence wins on
+// read. Repeated fields are written as unpacked occurrences, which every
+// conforming parser accepts regardless of the packed annotation.
+class ProtoBuilderPlan {
+ public:
+  typedef std::pair<const google::protobuf::FieldDescriptor*, FieldFormat::Format>
+      FieldAndFormat;
+
+  // Crashes if a field does not belong to 'descriptor' or has an invalid
+  // format annotation; callers algebrizing resolved ASTs have already
+  // validated both.
+  ProtoBuilderPlan(const google::protobuf::Descriptor* descriptor,
+                   absl::Span<const FieldAndFormat> fields);
+
+  // Not copyable or movable.
+  ProtoBuilderPlan(const ProtoBuilderPlan&) = delete;
+  ProtoBuilderPlan& operator=(const ProtoBuilderPlan&) = delete;
+
+  // Appends the wire encoding of 'values' (one per plan field, in plan order)
+  // to 'bytes'. Each value must match the field's type as computed by
+  // GetProtoFieldTypeAndDefault(), i.e. an array for a repeated field.
+  // NULL values write no field occurrence; a NULL value for a required field
+  // or a NULL array element is an error.
+  zetasql_base::Status BuildProto(absl::Span<const Value> values,
+                          std::string* bytes) const;
+
+ private:
+  struct FieldPlan {
+    const google::protobuf::FieldDescriptor* descriptor;
+    FieldFormat::Format format;
+    // The kind of scalar values written to this field (the array element kind
+    // for repeated fields).
+    TypeKind kind;
+  };
+
+  // Writes one occurrence of the (scalar, non-NULL) 'value' for 'field_plan'.
+  static zetasql_base::Status WriteSingleValue(const FieldPlan& field_plan,
+                                       const Value& value,
+                                       google::protobuf::io::CodedOutputStream* out);
+
+  std::vector<FieldPlan> fields_;
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_PUBLIC_PROTO_UTIL_H_
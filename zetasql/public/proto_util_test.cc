@@ -760,8 +760,338 @@ TEST_P(ReadProtoFieldsTest, SameFieldWithTwoFormats) {
   EXPECT_THAT(value_list[1], IsOkAndHolds(values::Date(10)));
 }
 
+TEST_P(ReadProtoFieldsTest, BatchReadFillsColumns) {
+  // Three rows with different field values. The middle row leaves int64_val
+  // unset to exercise the default-value and has-bit paths.
+  std::vector<std::string> rows(3);
+  for (int i = 0; i < 3; ++i) {
+    KitchenSinkPB row;
+    row.set_int64_key_1(10 + i);
+    row.set_int64_key_2(20 + i);
+    if (i != 1) row.set_int64_val(100 + i);
+    row.SerializePartialToString(&rows[i]);
+  }
+
+  ProtoFieldInfo key_info;
+  key_info.descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_key_1");
+  ASSERT_TRUE(key_info.descriptor != nullptr);
+  key_info.format = FieldFormat::DEFAULT_FORMAT;
+  key_info.type = types::Int64Type();
+  key_info.default_value = Value::Int64(0);
+
+  ProtoFieldInfo val_info = key_info;
+  val_info.descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_val");
+  ASSERT_TRUE(val_info.descriptor != nullptr);
+  val_info.default_value = Value::Int64(-1);
+
+  ProtoFieldInfo has_info = val_info;
+  has_info.get_has_bit = true;
+
+  const std::vector<const ProtoFieldInfo*> infos = {&key_info, &val_info,
+                                                    &has_info};
+
+  std::vector<ProtoFieldValueList> columns;
+  ZETASQL_ASSERT_OK(ReadProtoFieldsBatch(infos, rows, &columns));
+  ASSERT_EQ(columns.size(), infos.size());
+  for (const ProtoFieldValueList& column : columns) {
+    ASSERT_EQ(column.size(), rows.size());
+  }
+
+  EXPECT_THAT(columns[0][0], IsOkAndHolds(Value::Int64(10)));
+  EXPECT_THAT(columns[0][1], IsOkAndHolds(Value::Int64(11)));
+  EXPECT_THAT(columns[0][2], IsOkAndHolds(Value::Int64(12)));
+  EXPECT_THAT(columns[1][0], IsOkAndHolds(Value::Int64(100)));
+  EXPECT_THAT(columns[1][1], IsOkAndHolds(Value::Int64(-1)));
+  EXPECT_THAT(columns[1][2], IsOkAndHolds(Value::Int64(102)));
+  EXPECT_THAT(columns[2][0], IsOkAndHolds(Value::Bool(true)));
+  EXPECT_THAT(columns[2][1], IsOkAndHolds(Value::Bool(false)));
+  EXPECT_THAT(columns[2][2], IsOkAndHolds(Value::Bool(true)));
+
+  // Each cell is exactly what a per-row ReadProtoFields() produces.
+  for (int j = 0; j < rows.size(); ++j) {
+    ProtoFieldValueList row_values;
+    ZETASQL_ASSERT_OK(ReadProtoFields(infos, rows[j], &row_values));
+    ASSERT_EQ(row_values.size(), infos.size());
+    for (int i = 0; i < infos.size(); ++i) {
+      ASSERT_EQ(row_values[i].status(), columns[i][j].status());
+      if (row_values[i].ok()) {
+        EXPECT_EQ(row_values[i].ValueOrDie(), columns[i][j].ValueOrDie());
+      }
+    }
+  }
+}
+
+TEST_P(ReadProtoFieldsTest, BatchReadSingleField) {
+  // A single-field batch takes the same single-field fast path as
+  // ReadProtoFields() when --zetasql_read_proto_field_optimized_path is true.
+  std::vector<std::string> rows(2);
+  for (int i = 0; i < 2; ++i) {
+    KitchenSinkPB row;
+    row.set_int64_key_1(1);
+    row.set_int64_key_2(2);
+    row.set_int32_val(30 + i);
+    row.SerializePartialToString(&rows[i]);
+  }
+
+  ProtoFieldInfo info;
+  info.descriptor = kitchen_sink_.GetDescriptor()->FindFieldByName("int32_val");
+  ASSERT_TRUE(info.descriptor != nullptr);
+  info.format = FieldFormat::DEFAULT_FORMAT;
+  info.type = types::Int32Type();
+  info.default_value = Value::Int32(0);
+
+  std::vector<ProtoFieldValueList> columns;
+  ZETASQL_ASSERT_OK(ReadProtoFieldsBatch({&info}, rows, &columns));
+  ASSERT_EQ(columns.size(), 1);
+  ASSERT_EQ(columns[0].size(), 2);
+  EXPECT_THAT(columns[0][0], IsOkAndHolds(Value::Int32(30)));
+  EXPECT_THAT(columns[0][1], IsOkAndHolds(Value::Int32(31)));
+}
+
+TEST_P(ReadProtoFieldsTest, BatchReadReportsMissingRequiredFieldPerRow) {
+  // A row missing a required field yields an error in that row's cell without
+  // failing the rest of the batch.
+  std::vector<std::string> rows(2);
+  KitchenSinkPB row;
+  row.set_int64_key_1(1);
+  row.SerializePartialToString(&rows[0]);
+  row.set_int64_key_2(2);
+  row.SerializePartialToString(&rows[1]);
+
+  ProtoFieldInfo info;
+  info.descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_key_2");
+  ASSERT_TRUE(info.descriptor != nullptr);
+  info.format = FieldFormat::DEFAULT_FORMAT;
+  info.type = types::Int64Type();
+  info.default_value = Value::Int64(0);
+
+  ProtoFieldInfo other_info = info;
+  other_info.descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_key_1");
+  ASSERT_TRUE(other_info.descriptor != nullptr);
+
+  std::vector<ProtoFieldValueList> columns;
+  ZETASQL_ASSERT_OK(ReadProtoFieldsBatch({&info, &other_info}, rows, &columns));
+  ASSERT_EQ(columns.size(), 2);
+  EXPECT_THAT(columns[0][0],
+              StatusIs(zetasql_base::OUT_OF_RANGE,
+                       HasSubstr("Protocol buffer missing required field "
+                                 "zetasql_test.KitchenSinkPB.int64_key_2")));
+  EXPECT_THAT(columns[0][1], IsOkAndHolds(Value::Int64(2)));
+  EXPECT_THAT(columns[1][0], IsOkAndHolds(Value::Int64(1)));
+  EXPECT_THAT(columns[1][1], IsOkAndHolds(Value::Int64(1)));
+}
+
+TEST_P(ReadProtoFieldsTest, OffsetIndexReadMatchesFullScan) {
+  kitchen_sink_.set_int64_key_1(1);
+  // int64_key_2 is left unset to produce a missing-required-field error.
+  kitchen_sink_.set_int32_val(5);
+  kitchen_sink_.add_repeated_int32_val(7);
+  kitchen_sink_.add_repeated_int32_val(8);
+  kitchen_sink_.add_repeated_int32_val(9);
+
+  std::string bytes;
+  kitchen_sink_.SerializePartialToString(&bytes);
+
+  ProtoWireOffsetIndex index;
+  ZETASQL_ASSERT_OK(BuildProtoWireOffsetIndex(bytes, &index));
+
+  TypeFactory type_factory;
+  const ArrayType* int32_array_type;
+  ZETASQL_ASSERT_OK(type_factory.MakeArrayType(types::Int32Type(), &int32_array_type));
+
+  std::vector<ProtoFieldInfo> infos(5);
+  infos[0].descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_key_1");
+  infos[0].type = types::Int64Type();
+  infos[0].default_value = Value::Int64(0);
+  infos[1].descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int64_key_2");
+  infos[1].type = types::Int64Type();
+  infos[1].default_value = Value::Int64(0);
+  infos[2].descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("int32_val");
+  infos[2].type = types::Int32Type();
+  infos[2].default_value = Value::Int32(0);
+  infos[3].descriptor =
+      kitchen_sink_.GetDescriptor()->FindFieldByName("repeated_int32_val");
+  infos[3].type = int32_array_type;
+  infos[4] = infos[2];
+  infos[4].get_has_bit = true;
+
+  std::vector<const ProtoFieldInfo*> info_ptrs;
+  for (ProtoFieldInfo& info : infos) {
+    ASSERT_TRUE(info.descriptor != nullptr);
+    info.format = FieldFormat::DEFAULT_FORMAT;
+    info_ptrs.push_back(&info);
+  }
+
+  ProtoFieldValueList from_index;
+  ZETASQL_ASSERT_OK(
+      ReadProtoFieldsWithOffsetIndex(info_ptrs, bytes, index, &from_index));
+
+  ProtoFieldValueList from_scan;
+  ZETASQL_ASSERT_OK(ReadProtoFields(info_ptrs, bytes, &from_scan));
+
+  ASSERT_EQ(from_index.size(), from_scan.size());
+  for (int i = 0; i < from_index.size(); ++i) {
+    ASSERT_EQ(from_scan[i].status(), from_index[i].status());
+    if (from_scan[i].ok()) {
+      EXPECT_EQ(from_scan[i].ValueOrDie(), from_index[i].ValueOrDie());
+    }
+  }
+
+  // Spot-check a few results directly.
+  EXPECT_THAT(from_index[0], IsOkAndHolds(Value::Int64(1)));
+  EXPECT_THAT(from_index[1],
+              StatusIs(zetasql_base::OUT_OF_RANGE,
+                       HasSubstr("Protocol buffer missing required field "
+                                 "zetasql_test.KitchenSinkPB.int64_key_2")));
+  EXPECT_THAT(from_index[3],
+              IsOkAndHolds(Value::Array(
+                  int32_array_type,
+                  {Value::Int32(7), Value::Int32(8), Value::Int32(9)})));
+  EXPECT_THAT(from_index[4], IsOkAndHolds(Value::Bool(true)));
+}
+
 INSTANTIATE_TEST_SUITE_P(ReadProtoFieldsTestInstantiation, ReadProtoFieldsTest,
                          ::testing::Values(false, true));
 
+static const google::protobuf::FieldDescriptor* GetField(const std::string& name) {
+  const google::protobuf::FieldDescriptor* field =
+      KitchenSinkPB::descriptor()->FindFieldByName(name);
+  CHECK(field != nullptr) << name;
+  return field;
+}
+
+TEST(ProtoBuilderPlanTest, BuildsParseableProto) {
+  TypeFactory type_factory;
+  const ArrayType* int32_array_type;
+  ZETASQL_ASSERT_OK(type_factory.MakeArrayType(types::Int32Type(), &int32_array_type));
+  const ProtoType* nested_type;
+  ZETASQL_ASSERT_OK(type_factory.MakeProtoType(
+      KitchenSinkPB::Nested::descriptor(), &nested_type));
+
+  ProtoBuilderPlan plan(
+      KitchenSinkPB::descriptor(),
+      {{GetField("int64_key_1"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("int64_key_2"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("string_val"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("repeated_int32_val"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("date"), FieldFormat::DATE},
+       {GetField("timestamp_micros"), FieldFormat::TIMESTAMP_MICROS},
+       {GetField("nested_value"), FieldFormat::DEFAULT_FORMAT}});
+
+  KitchenSinkPB::Nested nested;
+  nested.set_nested_int64(5);
+  std::string nested_bytes;
+  ASSERT_TRUE(nested.SerializeToString(&nested_bytes));
+
+  std::string bytes;
+  ZETASQL_ASSERT_OK(plan.BuildProto(
+      {Value::Int64(1), Value::Int64(2), Value::String("foo"),
+       Value::Array(int32_array_type, {Value::Int32(7), Value::Int32(8)}),
+       Value::Date(10000), Value::TimestampFromUnixMicros(1111000),
+       Value::Proto(nested_type, nested_bytes)},
+      &bytes));
+
+  KitchenSinkPB parsed;
+  ASSERT_TRUE(parsed.ParseFromString(bytes));
+  EXPECT_EQ(1, parsed.int64_key_1());
+  EXPECT_EQ(2, parsed.int64_key_2());
+  EXPECT_EQ("foo", parsed.string_val());
+  ASSERT_EQ(2, parsed.repeated_int32_val_size());
+  EXPECT_EQ(7, parsed.repeated_int32_val(0));
+  EXPECT_EQ(8, parsed.repeated_int32_val(1));
+  EXPECT_EQ(10000, parsed.date());
+  EXPECT_EQ(1111000, parsed.timestamp_micros());
+  EXPECT_THAT(parsed.nested_value(), EqualsProto(nested));
+
+  // The annotated fields read back through ReadProtoField() as the original
+  // values.
+  Value read_value;
+  ZETASQL_ASSERT_OK(ReadProtoField(GetField("date"), FieldFormat::DATE,
+                           types::DateType(), Value::NullDate(), bytes,
+                           &read_value));
+  EXPECT_EQ(Value::Date(10000), read_value);
+  ZETASQL_ASSERT_OK(ReadProtoField(GetField("timestamp_micros"),
+                           FieldFormat::TIMESTAMP_MICROS,
+                           types::TimestampType(), Value::NullTimestamp(),
+                           bytes, &read_value));
+  EXPECT_EQ(Value::TimestampFromUnixMicros(1111000), read_value);
+}
+
+TEST(ProtoBuilderPlanTest, NullOptionalFieldsWriteNothing) {
+  ProtoBuilderPlan plan(
+      KitchenSinkPB::descriptor(),
+      {{GetField("int64_key_1"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("int64_key_2"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("int32_val"), FieldFormat::DEFAULT_FORMAT}});
+
+  std::string bytes;
+  ZETASQL_ASSERT_OK(plan.BuildProto(
+      {Value::Int64(1), Value::Int64(2), Value::NullInt32()}, &bytes));
+
+  KitchenSinkPB parsed;
+  ASSERT_TRUE(parsed.ParseFromString(bytes));
+  EXPECT_FALSE(parsed.has_int32_val());
+}
+
+TEST(ProtoBuilderPlanTest, NullRequiredFieldIsAnError) {
+  ProtoBuilderPlan plan(KitchenSinkPB::descriptor(),
+                        {{GetField("int64_key_1"), FieldFormat::DEFAULT_FORMAT}});
+
+  std::string bytes;
+  EXPECT_THAT(plan.BuildProto({Value::NullInt64()}, &bytes),
+              StatusIs(zetasql_base::OUT_OF_RANGE,
+                       HasSubstr("null value in required proto field "
+                                 "zetasql_test.KitchenSinkPB.int64_key_1")));
+}
+
+TEST(ProtoBuilderPlanTest, NullArrayElementIsAnError) {
+  TypeFactory type_factory;
+  const ArrayType* int32_array_type;
+  ZETASQL_ASSERT_OK(type_factory.MakeArrayType(types::Int32Type(), &int32_array_type));
+
+  ProtoBuilderPlan plan(
+      KitchenSinkPB::descriptor(),
+      {{GetField("repeated_int32_val"), FieldFormat::DEFAULT_FORMAT}});
+
+  std::string bytes;
+  EXPECT_THAT(
+      plan.BuildProto({Value::Array(int32_array_type,
+                                    {Value::Int32(7), Value::NullInt32()})},
+                      &bytes),
+      StatusIs(zetasql_base::OUT_OF_RANGE,
+               HasSubstr("null value in repeated proto field "
+                         "zetasql_test.KitchenSinkPB.repeated_int32_val")));
+}
+
+TEST(ProtoBuilderPlanTest, TimestampMillisRequiresMillisecondPrecision) {
+  ProtoBuilderPlan plan(
+      KitchenSinkPB::descriptor(),
+      {{GetField("int64_key_1"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("int64_key_2"), FieldFormat::DEFAULT_FORMAT},
+       {GetField("timestamp_millis"), FieldFormat::TIMESTAMP_MILLIS}});
+
+  std::string bytes;
+  ZETASQL_ASSERT_OK(plan.BuildProto({Value::Int64(1), Value::Int64(2),
+                             Value::TimestampFromUnixMicros(1234000)},
+                            &bytes));
+  KitchenSinkPB parsed;
+  ASSERT_TRUE(parsed.ParseFromString(bytes));
+  EXPECT_EQ(1234, parsed.timestamp_millis());
+
+  bytes.clear();
+  EXPECT_THAT(plan.BuildProto({Value::Int64(1), Value::Int64(2),
+                               Value::TimestampFromUnixMicros(1234567)},
+                              &bytes),
+              StatusIs(zetasql_base::OUT_OF_RANGE,
+                       HasSubstr("sub-millisecond precision")));
+}
+
 }  // namespace
 }  // namespace zetasql
@@ -31,6 +31,8 @@
 #include "absl/strings/ascii.h"
 #include "zetasql/base/case.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/source_location.h"
@@ -40,6 +42,23 @@
 #include "zetasql/base/statusor.h"
 
 namespace zetasql {
+namespace {
+
+// Probes <m>, whose keys are stored lowercased, for <name>.  SQL identifiers
+// are usually already lowercase, in which case the flat_hash_map supports a
+// heterogeneous string_view lookup and no temporary key std::string is made.
+template <typename Map>
+typename Map::mapped_type FindWithLoweredName(const Map& m,
+                                              absl::string_view name) {
+  for (char c : name) {
+    if (absl::ascii_isupper(c)) {
+      return zetasql_base::FindPtrOrNull(m, absl::AsciiStrToLower(name));
+    }
+  }
+  return zetasql_base::FindPtrOrNull(m, name);
+}
+
+}  // namespace
 
 SimpleCatalog::SimpleCatalog(const std::string& name, TypeFactory* type_factory)
     : name_(name), type_factory_(type_factory) {
@@ -49,23 +68,51 @@ zetasql_base::Status SimpleCatalog::GetTable(
     const std::string& name,
     const Table** table,
     const FindOptions& options) {
+  const std::string lower_name = absl::AsciiStrToLower(name);
+  TableLoader table_loader;
+  {
+    absl::ReaderMutexLock l(&mutex_);
+    *table = zetasql_base::FindPtrOrNull(tables_, lower_name);
+    if (*table != nullptr || table_loader_ == nullptr ||
+        zetasql_base::ContainsKey(tables_known_missing_, lower_name)) {
+      return ::zetasql_base::OkStatus();
+    }
+    // Avoid holding the mutex while running the loader, which may be slow and
+    // may itself look up other tables.
+    table_loader = table_loader_;
+  }
+
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const Table> loaded_table,
+                   table_loader(name));
   absl::MutexLock l(&mutex_);
-  *table = zetasql_base::FindPtrOrNull(tables_, absl::AsciiStrToLower(name));
+  if (loaded_table == nullptr) {
+    // Cache the miss so the loader is not consulted for this name again.
+    tables_known_missing_.insert(lower_name);
+    return ::zetasql_base::OkStatus();
+  }
+  // Another caller may have loaded the table in the meantime, since we unlock
+  // after checking above. We use LookupOrInsert to consistently hand out the
+  // same pointer, and only take ownership of the table we inserted.
+  *table = zetasql_base::LookupOrInsert(&tables_, lower_name,
+                                static_cast<const Table*>(loaded_table.get()));
+  if (*table == loaded_table.get()) {
+    owned_tables_.push_back(std::move(loaded_table));
+  }
   return ::zetasql_base::OkStatus();
 }
 
 zetasql_base::Status SimpleCatalog::GetModel(const std::string& name, const Model** model,
                                      const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *model = zetasql_base::FindPtrOrNull(models_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *model = FindWithLoweredName(models_, name);
   return ::zetasql_base::OkStatus();
 }
 
 zetasql_base::Status SimpleCatalog::GetConnection(const std::string& name,
                                           const Connection** connection,
                                           const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *connection = zetasql_base::FindPtrOrNull(connections_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *connection = FindWithLoweredName(connections_, name);
   return zetasql_base::OkStatus();
 }
 
@@ -73,8 +120,8 @@ zetasql_base::Status SimpleCatalog::GetFunction(
     const std::string& name,
     const Function** function,
     const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *function = zetasql_base::FindPtrOrNull(functions_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *function = FindWithLoweredName(functions_, name);
   return ::zetasql_base::OkStatus();
 }
 
@@ -82,9 +129,8 @@ zetasql_base::Status SimpleCatalog::GetTableValuedFunction(
     const std::string& name,
     const TableValuedFunction** function,
     const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *function =
-      zetasql_base::FindPtrOrNull(table_valued_functions_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *function = FindWithLoweredName(table_valued_functions_, name);
   return ::zetasql_base::OkStatus();
 }
 
@@ -92,8 +138,8 @@ zetasql_base::Status SimpleCatalog::GetProcedure(
     const std::string& name,
     const Procedure** procedure,
     const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *procedure = zetasql_base::FindPtrOrNull(procedures_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *procedure = FindWithLoweredName(procedures_, name);
   return ::zetasql_base::OkStatus();
 }
 
@@ -103,10 +149,10 @@ zetasql_base::Status SimpleCatalog::GetType(
     const FindOptions& options) {
   const google::protobuf::DescriptorPool* pool;
   {
-    absl::MutexLock l(&mutex_);
+    absl::ReaderMutexLock l(&mutex_);
     // Types contained in types_ have case-insensitive names, so we lowercase
     // the name as is done in AddType.
-    *type = zetasql_base::FindPtrOrNull(types_, absl::AsciiStrToLower(name));
+    *type = FindWithLoweredName(types_, name);
     if (*type != nullptr) {
       return ::zetasql_base::OkStatus();
     }
@@ -153,19 +199,55 @@ zetasql_base::Status SimpleCatalog::GetCatalog(
     const std::string& name,
     Catalog** catalog,
     const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *catalog = zetasql_base::FindPtrOrNull(catalogs_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *catalog = FindWithLoweredName(catalogs_, name);
   return ::zetasql_base::OkStatus();
 }
 
 zetasql_base::Status SimpleCatalog::GetConstant(const std::string& name,
                                         const Constant** constant,
                                         const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
-  *constant = zetasql_base::FindPtrOrNull(constants_, absl::AsciiStrToLower(name));
+  absl::ReaderMutexLock l(&mutex_);
+  *constant = FindWithLoweredName(constants_, name);
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status SimpleCatalog::FindFunction(
+    const absl::Span<const std::string>& path, const Function** function,
+    const FindOptions& options) {
+  // The key uses '\0' as the separator since names may themselves contain
+  // dots. Single-part paths go straight to GetFunction and gain nothing from
+  // the index.
+  std::string index_key;
+  {
+    absl::ReaderMutexLock l(&mutex_);
+    if (function_path_index_enabled_ && path.size() > 1) {
+      index_key =
+          absl::AsciiStrToLower(absl::StrJoin(path, absl::string_view("\0", 1)));
+      const Function* const* indexed =
+          zetasql_base::FindOrNull(function_path_index_, index_key);
+      if (indexed != nullptr) {
+        *function = *indexed;
+        return ::zetasql_base::OkStatus();
+      }
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(Catalog::FindFunction(path, function, options));
+  if (!index_key.empty() && *function != nullptr) {
+    absl::MutexLock l(&mutex_);
+    if (function_path_index_enabled_) {
+      function_path_index_.emplace(std::move(index_key), *function);
+    }
+  }
   return ::zetasql_base::OkStatus();
 }
 
+void SimpleCatalog::SetFunctionPathIndexEnabled(bool enabled) {
+  absl::MutexLock l(&mutex_);
+  function_path_index_enabled_ = enabled;
+  function_path_index_.clear();
+}
+
 std::string SimpleCatalog::SuggestTable(
     const absl::Span<const std::string>& mistyped_path) {
   if (mistyped_path.empty()) {
@@ -628,6 +710,29 @@ void SimpleCatalog::SetOwnedDescriptorPool(const google::protobuf::DescriptorPoo
   descriptor_pool_ = pool;
 }
 
+void SimpleCatalog::SetTableLoader(TableLoader table_loader) {
+  absl::MutexLock l(&mutex_);
+  table_loader_ = std::move(table_loader);
+  tables_known_missing_.clear();
+}
+
+SimpleCatalog* SimpleCatalog::GetOrCreateZetaSQLSubcatalog(
+    const std::string& space, TypeFactory* type_factory) {
+  absl::MutexLock l(&mutex_);
+  auto sub_entry = owned_zetasql_subcatalogs_.find(space);
+  if (sub_entry != owned_zetasql_subcatalogs_.end()) {
+    SimpleCatalog* catalog = sub_entry->second.get();
+    CHECK(catalog != nullptr) << "internal state corrupt: " << space;
+    return catalog;
+  }
+  auto new_catalog = absl::make_unique<SimpleCatalog>(space, type_factory);
+  AddCatalogLocked(space, new_catalog.get());
+  SimpleCatalog* catalog = new_catalog.get();
+  CHECK(owned_zetasql_subcatalogs_.emplace(space, std::move(new_catalog))
+            .second);
+  return catalog;
+}
+
 void SimpleCatalog::AddZetaSQLFunctions(
     const ZetaSQLBuiltinFunctionOptions& options) {
   std::map<std::string, std::unique_ptr<Function>> function_map;
@@ -639,28 +744,33 @@ void SimpleCatalog::AddZetaSQLFunctions(
     SimpleCatalog* catalog = this;
     if (path.size() > 1) {
       CHECK_LE(path.size(), 2);
-      absl::MutexLock l(&mutex_);
-      const std::string& space = path[0];
-      auto sub_entry = owned_zetasql_subcatalogs_.find(space);
-      if (sub_entry != owned_zetasql_subcatalogs_.end()) {
-        catalog = sub_entry->second.get();
-        CHECK(catalog != nullptr) << "internal state corrupt: " << space;
-      } else {
-        auto new_catalog =
-            absl::make_unique<SimpleCatalog>(space, type_factory);
-        AddCatalogLocked(space, new_catalog.get());
-        catalog = new_catalog.get();
-        CHECK(
-            owned_zetasql_subcatalogs_.emplace(space, std::move(new_catalog))
-                .second);
-      }
+      catalog = GetOrCreateZetaSQLSubcatalog(path[0], type_factory);
     }
     catalog->AddOwnedFunction(path.back(), std::move(function_pair.second));
   }
 }
 
+void SimpleCatalog::AddSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options) {
+  const std::map<std::string, const Function*>& function_map =
+      GetSharedZetaSQLFunctions(options);
+  // We have to call type_factory() while not holding mutex_.
+  TypeFactory* type_factory = this->type_factory();
+  for (const auto& function_pair : function_map) {
+    const std::vector<std::string>& path =
+        function_pair.second->FunctionNamePath();
+    SimpleCatalog* catalog = this;
+    if (path.size() > 1) {
+      CHECK_LE(path.size(), 2);
+      catalog = GetOrCreateZetaSQLSubcatalog(path[0], type_factory);
+    }
+    catalog->AddFunction(path.back(), function_pair.second);
+  }
+}
+
 void SimpleCatalog::ClearFunctions() {
   absl::MutexLock l(&mutex_);
+  function_path_index_.clear();
   functions_.clear();
   owned_functions_.clear();
   for (const auto& pair : owned_zetasql_subcatalogs_) {
@@ -671,6 +781,7 @@ void SimpleCatalog::ClearFunctions() {
 
 void SimpleCatalog::ClearTableValuedFunctions() {
   absl::MutexLock l(&mutex_);
+  function_path_index_.clear();
   table_valued_functions_.clear();
   owned_table_valued_functions_.clear();
   for (const auto& pair : owned_zetasql_subcatalogs_) {
@@ -760,6 +871,55 @@ void InsertValuesFromMap(const M& m, ValueContainer* value_container) {
   }
 }
 
+// Magic tag and helpers for the catalog snapshot format written by
+// SimpleCatalog::SerializeSnapshot. The layout is:
+//   kCatalogSnapshotMagic (8 bytes)
+//   fixed64 length + serialized SimpleCatalogProto (without top-level tables)
+//   fixed64 number of table records
+//   one record per top-level table:
+//     fixed64 name length + name bytes
+//     fixed64 proto length + serialized SimpleTableProto
+// All integers are little-endian.
+constexpr absl::string_view kCatalogSnapshotMagic = "ZSQLCAT1";
+
+void AppendSnapshotFixed64(uint64_t value, std::string* out) {
+  char bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  }
+  out->append(bytes, 8);
+}
+
+bool ReadSnapshotFixed64(absl::string_view* data, uint64_t* value) {
+  if (data->size() < 8) return false;
+  *value = 0;
+  for (int i = 0; i < 8; ++i) {
+    *value |= static_cast<uint64_t>(static_cast<unsigned char>((*data)[i]))
+              << (8 * i);
+  }
+  data->remove_prefix(8);
+  return true;
+}
+
+bool ReadSnapshotBytes(absl::string_view* data, absl::string_view* bytes) {
+  uint64_t length;
+  if (!ReadSnapshotFixed64(data, &length) || data->size() < length) {
+    return false;
+  }
+  *bytes = data->substr(0, length);
+  data->remove_prefix(length);
+  return true;
+}
+
+// State shared with the table loader installed by DeserializeSnapshot: one
+// contiguous block holding all table records, and an index from lowercase
+// table name to that table's serialized proto within the block.
+struct SnapshotTableRecords {
+  std::string records;
+  absl::flat_hash_map<std::string, absl::string_view> tables_by_name;
+  std::vector<const google::protobuf::DescriptorPool*> pools;
+};
+
 }  // namespace
 
 zetasql_base::Status SimpleCatalog::Deserialize(
@@ -773,6 +933,111 @@ zetasql_base::Status SimpleCatalog::Deserialize(
   return ::zetasql_base::OkStatus();
 }
 
+zetasql_base::Status SimpleCatalog::SerializeSnapshot(
+    FileDescriptorSetMap* file_descriptor_set_map, std::string* snapshot,
+    bool ignore_builtin, bool ignore_recursive) const {
+  SimpleCatalogProto proto;
+  ZETASQL_RETURN_IF_ERROR(Serialize(file_descriptor_set_map, &proto, ignore_builtin,
+                            ignore_recursive));
+
+  std::string table_records;
+  for (const SimpleTableProto& table_proto : proto.table()) {
+    const std::string& name = table_proto.has_name_in_catalog()
+                                  ? table_proto.name_in_catalog()
+                                  : table_proto.name();
+    AppendSnapshotFixed64(name.size(), &table_records);
+    table_records.append(name);
+    const std::string table_bytes = table_proto.SerializeAsString();
+    AppendSnapshotFixed64(table_bytes.size(), &table_records);
+    table_records.append(table_bytes);
+  }
+  const uint64_t num_tables = proto.table_size();
+  proto.clear_table();
+
+  snapshot->clear();
+  snapshot->append(kCatalogSnapshotMagic.data(), kCatalogSnapshotMagic.size());
+  const std::string catalog_bytes = proto.SerializeAsString();
+  AppendSnapshotFixed64(catalog_bytes.size(), snapshot);
+  snapshot->append(catalog_bytes);
+  AppendSnapshotFixed64(num_tables, snapshot);
+  snapshot->append(table_records);
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status SimpleCatalog::DeserializeSnapshot(
+    absl::string_view snapshot,
+    const std::vector<const google::protobuf::DescriptorPool*>& pools,
+    std::unique_ptr<SimpleCatalog>* result) {
+  if (snapshot.substr(0, kCatalogSnapshotMagic.size()) !=
+      kCatalogSnapshotMagic) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid catalog snapshot: bad magic";
+  }
+  snapshot.remove_prefix(kCatalogSnapshotMagic.size());
+
+  absl::string_view catalog_bytes;
+  if (!ReadSnapshotBytes(&snapshot, &catalog_bytes)) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid catalog snapshot: truncated catalog section";
+  }
+  SimpleCatalogProto proto;
+  if (!proto.ParseFromArray(catalog_bytes.data(), catalog_bytes.size())) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid catalog snapshot: malformed catalog section";
+  }
+
+  std::unique_ptr<SimpleCatalog> catalog(new SimpleCatalog(proto.name()));
+  ZETASQL_RETURN_IF_ERROR(DeserializeImpl(proto, pools, catalog.get()));
+
+  uint64_t num_tables;
+  if (!ReadSnapshotFixed64(&snapshot, &num_tables)) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid catalog snapshot: truncated table count";
+  }
+  // Copy the table records into one catalog-owned block and index it. The
+  // individual table protos are not parsed here; the loader below
+  // materializes each table on its first lookup.
+  auto records = std::make_shared<SnapshotTableRecords>();
+  records->pools = pools;
+  records->records.assign(snapshot.data(), snapshot.size());
+  records->tables_by_name.reserve(num_tables);
+  absl::string_view remaining = records->records;
+  for (uint64_t i = 0; i < num_tables; ++i) {
+    absl::string_view name;
+    absl::string_view table_bytes;
+    if (!ReadSnapshotBytes(&remaining, &name) ||
+        !ReadSnapshotBytes(&remaining, &table_bytes)) {
+      return ::zetasql_base::InvalidArgumentErrorBuilder()
+             << "Invalid catalog snapshot: truncated table record " << i;
+    }
+    records->tables_by_name.emplace(absl::AsciiStrToLower(name), table_bytes);
+  }
+
+  SimpleCatalog* catalog_ptr = catalog.get();
+  catalog->SetTableLoader(
+      [records, catalog_ptr](const std::string& name)
+          -> zetasql_base::StatusOr<std::unique_ptr<const Table>> {
+        const absl::string_view* table_bytes = zetasql_base::FindOrNull(
+            records->tables_by_name, absl::AsciiStrToLower(name));
+        if (table_bytes == nullptr) {
+          return std::unique_ptr<const Table>();
+        }
+        SimpleTableProto table_proto;
+        if (!table_proto.ParseFromArray(table_bytes->data(),
+                                        table_bytes->size())) {
+          return ::zetasql_base::InvalidArgumentErrorBuilder()
+                 << "Malformed table record in catalog snapshot: " << name;
+        }
+        std::unique_ptr<SimpleTable> table;
+        ZETASQL_RETURN_IF_ERROR(SimpleTable::Deserialize(
+            table_proto, records->pools, catalog_ptr->type_factory(), &table));
+        return std::unique_ptr<const Table>(table.release());
+      });
+
+  *result = std::move(catalog);
+  return ::zetasql_base::OkStatus();
+}
+
 zetasql_base::Status SimpleCatalog::Serialize(
     FileDescriptorSetMap* file_descriptor_set_map,
     SimpleCatalogProto* proto,
@@ -790,7 +1055,7 @@ zetasql_base::Status SimpleCatalog::SerializeImpl(
     bool ignore_builtin, bool ignore_recursive) const {
   seen_catalogs->insert(this);
 
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
 
   proto->Clear();
   proto->set_name(name_);
@@ -903,7 +1168,7 @@ zetasql_base::Status SimpleCatalog::GetCatalogs(
     absl::flat_hash_set<const Catalog*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   InsertValuesFromMap(catalogs_, output);
   return zetasql_base::OkStatus();
 }
@@ -912,7 +1177,7 @@ zetasql_base::Status SimpleCatalog::GetTables(
     absl::flat_hash_set<const Table*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   InsertValuesFromMap(tables_, output);
   return zetasql_base::OkStatus();
 }
@@ -921,7 +1186,7 @@ zetasql_base::Status SimpleCatalog::GetTypes(
     absl::flat_hash_set<const Type*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   InsertValuesFromMap(types_, output);
   return zetasql_base::OkStatus();
 }
@@ -930,48 +1195,48 @@ zetasql_base::Status SimpleCatalog::GetFunctions(
     absl::flat_hash_set<const Function*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::ReaderMutexLock lock(&mutex_);
   InsertValuesFromMap(functions_, output);
   return zetasql_base::OkStatus();
 }
 
 std::vector<std::string> SimpleCatalog::table_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<std::string> table_names;
   zetasql_base::AppendKeysFromMap(tables_, &table_names);
   return table_names;
 }
 
 std::vector<const Table*> SimpleCatalog::tables() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const Table*> tables;
   zetasql_base::AppendValuesFromMap(tables_, &tables);
   return tables;
 }
 
 std::vector<const Type*> SimpleCatalog::types() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const Type*> types;
   zetasql_base::AppendValuesFromMap(types_, &types);
   return types;
 }
 
 std::vector<std::string> SimpleCatalog::function_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<std::string> function_names;
   zetasql_base::AppendKeysFromMap(functions_, &function_names);
   return function_names;
 }
 
 std::vector<const Function*> SimpleCatalog::functions() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const Function*> functions;
   zetasql_base::AppendValuesFromMap(functions_, &functions);
   return functions;
 }
 
 std::vector<std::string> SimpleCatalog::table_valued_function_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<std::string> table_valued_function_names;
   zetasql_base::AppendKeysFromMap(table_valued_functions_, &table_valued_function_names);
   return table_valued_function_names;
@@ -979,47 +1244,89 @@ std::vector<std::string> SimpleCatalog::table_valued_function_names() const {
 
 std::vector<const TableValuedFunction*> SimpleCatalog::table_valued_functions()
     const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const TableValuedFunction*> table_valued_functions;
   zetasql_base::AppendValuesFromMap(table_valued_functions_, &table_valued_functions);
   return table_valued_functions;
 }
 
 std::vector<const Procedure*> SimpleCatalog::procedures() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const Procedure*> procedures;
   zetasql_base::AppendValuesFromMap(procedures_, &procedures);
   return procedures;
 }
 
 std::vector<std::string> SimpleCatalog::catalog_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<std::string> catalog_names;
   zetasql_base::AppendKeysFromMap(catalogs_, &catalog_names);
   return catalog_names;
 }
 
 std::vector<Catalog*> SimpleCatalog::catalogs() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<Catalog*> catalogs;
   zetasql_base::AppendValuesFromMap(catalogs_, &catalogs);
   return catalogs;
 }
 
 std::vector<std::string> SimpleCatalog::constant_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<std::string> constant_names;
   zetasql_base::AppendKeysFromMap(constants_, &constant_names);
   return constant_names;
 }
 
 std::vector<const Constant*> SimpleCatalog::constants() const {
-  absl::MutexLock l(&mutex_);
+  absl::ReaderMutexLock l(&mutex_);
   std::vector<const Constant*> constants;
   zetasql_base::AppendValuesFromMap(constants_, &constants);
   return constants;
 }
 
+absl::flat_hash_map<std::string, const Table*> SimpleCatalog::tables_by_name()
+    const {
+  absl::ReaderMutexLock l(&mutex_);
+  return tables_;
+}
+
+absl::flat_hash_map<std::string, const Type*> SimpleCatalog::types_by_name()
+    const {
+  absl::ReaderMutexLock l(&mutex_);
+  return types_;
+}
+
+absl::flat_hash_map<std::string, const Function*>
+SimpleCatalog::functions_by_name() const {
+  absl::ReaderMutexLock l(&mutex_);
+  return functions_;
+}
+
+absl::flat_hash_map<std::string, const TableValuedFunction*>
+SimpleCatalog::table_valued_functions_by_name() const {
+  absl::ReaderMutexLock l(&mutex_);
+  return table_valued_functions_;
+}
+
+absl::flat_hash_map<std::string, const Procedure*>
+SimpleCatalog::procedures_by_name() const {
+  absl::ReaderMutexLock l(&mutex_);
+  return procedures_;
+}
+
+absl::flat_hash_map<std::string, Catalog*> SimpleCatalog::catalogs_by_name()
+    const {
+  absl::ReaderMutexLock l(&mutex_);
+  return catalogs_;
+}
+
+absl::flat_hash_map<std::string, const Constant*>
+SimpleCatalog::constants_by_name() const {
+  absl::ReaderMutexLock l(&mutex_);
+  return constants_;
+}
+
 SimpleTable::SimpleTable(const std::string& name,
                          const std::vector<NameAndType>& columns,
                          const int64_t id)
@@ -1060,7 +1367,7 @@ const Column* SimpleTable::FindColumnByName(const std::string& name) const {
   if (name.empty()) {
     return nullptr;
   }
-  return zetasql_base::FindPtrOrNull(columns_map_, absl::AsciiStrToLower(name));
+  return FindWithLoweredName(columns_map_, name);
 }
 
 zetasql_base::Status SimpleTable::AddColumn(const Column* column, bool is_owned) {
@@ -1119,6 +1426,13 @@ void SimpleTable::SetContents(const std::vector<std::vector<Value>>& rows) {
     std::vector<const Column*> columns;
     std::vector<std::shared_ptr<const std::vector<Value>>> column_values;
     column_values.reserve(column_idxs.size());
+    // Enforce filters the evaluator pushes down (see SetColumnFilterMap) on
+    // every column of the scan, so filtered rows are skipped here rather
+    // than materialized and discarded above the scan.
+    absl::flat_hash_set<int> filter_column_idxs;
+    for (int i = 0; i < column_idxs.size(); ++i) {
+      filter_column_idxs.insert(i);
+    }
     for (const int column_idx : column_idxs) {
       columns.push_back(GetColumn(column_idx));
       column_values.push_back(column_major_contents_[column_idx]);
@@ -1126,7 +1440,7 @@ void SimpleTable::SetContents(const std::vector<std::vector<Value>>& rows) {
     std::unique_ptr<EvaluatorTableIterator> iter(
         new SimpleEvaluatorTableIterator(
             columns, column_values,
-            /*end_status=*/zetasql_base::OkStatus(), /*filter_column_idxs=*/{},
+            /*end_status=*/zetasql_base::OkStatus(), filter_column_idxs,
             /*cancel_cb=*/[]() {},
             /*set_deadline_cb=*/[](absl::Time t) {}, zetasql_base::Clock::RealClock()));
     return iter;
@@ -1315,14 +1629,14 @@ const Column* SimpleModel::FindInputByName(const std::string& name) const {
   if (name.empty()) {
     return nullptr;
   }
-  return zetasql_base::FindPtrOrNull(inputs_map_, absl::AsciiStrToLower(name));
+  return FindWithLoweredName(inputs_map_, name);
 }
 
 const Column* SimpleModel::FindOutputByName(const std::string& name) const {
   if (name.empty()) {
     return nullptr;
   }
-  return zetasql_base::FindPtrOrNull(outputs_map_, absl::AsciiStrToLower(name));
+  return FindWithLoweredName(outputs_map_, name);
 }
 zetasql_base::Status SimpleModel::AddInput(const Column* column, bool is_owned) {
   std::unique_ptr<const Column> column_owner;
@@ -17,6 +17,7 @@
 #ifndef ZETASQL_PUBLIC_SIMPLE_CATALOG_H_
 #define ZETASQL_PUBLIC_SIMPLE_CATALOG_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -37,10 +38,12 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
+#include "zetasql/base/statusor.h"
 
 namespace zetasql {
 
@@ -52,7 +55,9 @@ class SimpleTableProto;
 // SimpleCatalog is a concrete implementation of the Catalog interface.
 // It acts as a simple container for objects in the Catalog.
 //
-// This class is thread-safe.
+// This class is thread-safe. Lookups and other read-only methods take the
+// internal mutex in shared mode, so concurrent reads do not serialize against
+// each other (only against mutations).
 class SimpleCatalog : public EnumerableCatalog {
  public:
   // Construct a Catalog with catalog name <name>.
@@ -106,6 +111,25 @@ class SimpleCatalog : public EnumerableCatalog {
                            const FindOptions& options = FindOptions()) override
       LOCKS_EXCLUDED(mutex_);
 
+  // Overrides the default level-by-level resolution to first consult the
+  // flattened function-path index when it is enabled. See
+  // SetFunctionPathIndexEnabled.
+  zetasql_base::Status FindFunction(const absl::Span<const std::string>& path,
+                            const Function** function,
+                            const FindOptions& options = FindOptions()) override
+      LOCKS_EXCLUDED(mutex_);
+
+  // Enables or disables the flattened function-path index. When enabled,
+  // successful multi-part FindFunction resolutions are memoized under the
+  // normalized full path, and later lookups of the same path skip the
+  // level-by-level walk through nested catalogs. Only positive results are
+  // memoized, so functions and sub-catalogs may still be added afterwards.
+  // The index is cleared when this catalog's functions are cleared and when
+  // the index is disabled; this catalog cannot observe direct mutations of
+  // nested catalogs, so callers that clear functions in a nested catalog
+  // should disable and re-enable the index to flush it. Off by default.
+  void SetFunctionPathIndexEnabled(bool enabled) LOCKS_EXCLUDED(mutex_);
+
   // For suggestions we look from the last level of <mistyped_path>:
   //  - Whether the object exists directly in sub-catalogs.
   //  - If not above, whether there is a single name that's misspelled in the
@@ -258,6 +282,15 @@ class SimpleCatalog : public EnumerableCatalog {
                                  ZetaSQLBuiltinFunctionOptions())
       LOCKS_EXCLUDED(mutex_);
 
+  // Same as AddZetaSQLFunctions, but references the process-wide shared set
+  // of built-in functions for <options> (see GetSharedZetaSQLFunctions in
+  // builtin_function.h) instead of building a copy owned by this catalog.
+  // This makes constructing many catalogs with the same options much cheaper.
+  // The shared functions live for the lifetime of the process.
+  void AddSharedZetaSQLFunctions(const ZetaSQLBuiltinFunctionOptions& options =
+                                       ZetaSQLBuiltinFunctionOptions())
+      LOCKS_EXCLUDED(mutex_);
+
   // Set the google::protobuf::DescriptorPool to use when resolving Types.
   // All message and enum types declared in <pool> will be resolvable with
   // FindType or GetType, treating the full name as one identifier.
@@ -276,6 +309,26 @@ class SimpleCatalog : public EnumerableCatalog {
   void SetOwnedDescriptorPool(const google::protobuf::DescriptorPool* pool)
       LOCKS_EXCLUDED(mutex_);
 
+  // Sets a callback that is consulted when GetTable (and therefore FindTable)
+  // does not find the requested table in this catalog. This allows tables to
+  // be materialized on first reference rather than eagerly added up front.
+  //
+  // The callback returns the loaded table, or NULL if no such table exists.
+  // The catalog takes ownership of loaded tables and caches negative results,
+  // so the callback is invoked at most once per distinct table name (errors
+  // are returned to the caller and are not cached). The callback is invoked
+  // without holding the catalog mutex and may be invoked concurrently from
+  // multiple threads, so it must be thread-safe.
+  //
+  // Setting a new callback clears the cache of negative results. Tables
+  // explicitly added to the catalog take precedence over the callback, and
+  // the enumeration methods (tables(), table_names(), GetTables(), etc.)
+  // only reflect tables that have already been loaded.
+  using TableLoader =
+      std::function<zetasql_base::StatusOr<std::unique_ptr<const Table>>(
+          const std::string& name)>;
+  void SetTableLoader(TableLoader table_loader) LOCKS_EXCLUDED(mutex_);
+
   // Clear the set of functions stored in this Catalog and any subcatalogs
   // created for zetasql namespaces. Does not affect any other catalogs.
   // This can be called between calls to AddZetaSQLFunctions with different
@@ -312,6 +365,29 @@ class SimpleCatalog : public EnumerableCatalog {
                          bool ignore_recursive = true) const
       LOCKS_EXCLUDED(mutex_);
 
+  // Serializes this catalog into a snapshot format optimized for load time.
+  // The snapshot stores the catalog content minus the top-level tables as one
+  // SimpleCatalogProto section, followed by one length-prefixed record per
+  // top-level table, with all table data in a single contiguous block
+  // referenced by offset. <ignore_builtin> and <ignore_recursive> behave as
+  // in Serialize.
+  zetasql_base::Status SerializeSnapshot(FileDescriptorSetMap* file_descriptor_set_map,
+                                 std::string* snapshot,
+                                 bool ignore_builtin = true,
+                                 bool ignore_recursive = true) const
+      LOCKS_EXCLUDED(mutex_);
+
+  // Deserializes a catalog from a snapshot produced by SerializeSnapshot.
+  // Unlike Deserialize, table records are only indexed at load time; each
+  // table is parsed and materialized on its first lookup (using the table
+  // loader mechanism, see SetTableLoader), so loading a snapshot with many
+  // tables is fast. The returned catalog keeps a copy of the table records
+  // from <snapshot>. The DescriptorPools must outlive the result catalog.
+  static zetasql_base::Status DeserializeSnapshot(
+      absl::string_view snapshot,
+      const std::vector<const google::protobuf::DescriptorPool*>& pools,
+      std::unique_ptr<SimpleCatalog>* result);
+
   // Return a TypeFactory owned by this SimpleCatalog.
   TypeFactory* type_factory() LOCKS_EXCLUDED(mutex_);
 
@@ -346,6 +422,27 @@ class SimpleCatalog : public EnumerableCatalog {
   std::vector<std::string> catalog_names() const LOCKS_EXCLUDED(mutex_);
   std::vector<std::string> constant_names() const LOCKS_EXCLUDED(mutex_);
 
+  // Accessors for reading a copy of the (lower-case name, object) entries in
+  // this SimpleCatalog, including objects registered under names other than
+  // their own. Useful for building a catalog that shares objects with this
+  // one; the shared objects must outlive the catalog referencing them.
+  // Note: a Function with an alias appears under both its registered name and
+  // its alias.
+  absl::flat_hash_map<std::string, const Table*> tables_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, const Type*> types_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, const Function*> functions_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, const TableValuedFunction*>
+  table_valued_functions_by_name() const LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, const Procedure*> procedures_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, Catalog*> catalogs_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+  absl::flat_hash_map<std::string, const Constant*> constants_by_name() const
+      LOCKS_EXCLUDED(mutex_);
+
  private:
   zetasql_base::Status SerializeImpl(absl::flat_hash_set<const Catalog*>* seen_catalogs,
                              FileDescriptorSetMap* file_descriptor_set_map,
@@ -356,6 +453,13 @@ class SimpleCatalog : public EnumerableCatalog {
   // Implements AddCatalog() interface for callers that already own mutex_.
   void AddCatalogLocked(const std::string& name, Catalog* catalog)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the owned sub-Catalog for the zetasql namespace <space>,
+  // creating and registering it if necessary. Used when adding built-in
+  // functions whose name paths have multiple levels.
+  SimpleCatalog* GetOrCreateZetaSQLSubcatalog(const std::string& space,
+                                                TypeFactory* type_factory)
+      LOCKS_EXCLUDED(mutex_);
   // Helper methods for adding objects while holding <mutex_>.
   // TODO: Refactor the Add*() methods for other object types
   // to use a common locked implementation, similar to these for Function.
@@ -387,6 +491,12 @@ class SimpleCatalog : public EnumerableCatalog {
   std::unique_ptr<TypeFactory> owned_type_factory_ GUARDED_BY(mutex_);
 
   absl::flat_hash_map<std::string, const Table*> tables_ GUARDED_BY(mutex_);
+  // Callback consulted in GetTable when a table is not present in tables_.
+  // May be NULL. See SetTableLoader.
+  TableLoader table_loader_ GUARDED_BY(mutex_);
+  // Lowercase names for which table_loader_ already reported that no such
+  // table exists, so the loader is not consulted again for them.
+  absl::flat_hash_set<std::string> tables_known_missing_ GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, const Connection*> connections_
       GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, const Model*> models_ GUARDED_BY(mutex_);
@@ -399,6 +509,12 @@ class SimpleCatalog : public EnumerableCatalog {
   absl::flat_hash_map<std::string, const Type*> cached_proto_or_enum_types_
       GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, const Function*> functions_ GUARDED_BY(mutex_);
+  // Memo of successful multi-part FindFunction resolutions, keyed by the
+  // normalized full path. Only populated while function_path_index_enabled_.
+  // See SetFunctionPathIndexEnabled.
+  bool function_path_index_enabled_ GUARDED_BY(mutex_) = false;
+  absl::flat_hash_map<std::string, const Function*> function_path_index_
+      GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, const TableValuedFunction*>
       table_valued_functions_ GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, const Procedure*> procedures_ GUARDED_BY(mutex_);
@@ -17,7 +17,9 @@
 #include "zetasql/public/strings.h"
 
 #include <ctype.h>
+#include <string.h>
 
+#include <cstdint>
 #include <iterator>
 
 #include "zetasql/base/logging.h"
@@ -492,12 +494,88 @@ static bool CUnescapeInternal(absl::string_view source,
 // (from '"`) that matches escape_quote_char.
 // This allows writing "ab'cd" or 'ab"cd' or `ab"cd` without extra escaping.
 // ----------------------------------------------------------------------
+
+// SWAR helpers for CEscapeInternal.  Most strings passed to ToStringLiteral
+// and ToIdentifierLiteral need no escaping at all, so CEscapeInternal scans
+// for clean spans eight bytes at a time and copies them wholesale, falling
+// back to the byte-at-a-time loop only around bytes that need escaping.
+// The predicates are per-byte, so the word scan is endianness-independent.
+static const uint64_t kEscapeScanLsbs = 0x0101010101010101ull;
+static const uint64_t kEscapeScanMsbs = 0x8080808080808080ull;
+
+// Returns nonzero if any byte of 'word' equals 'c' (which must be < 0x80).
+static inline uint64_t AnyByteEquals(uint64_t word, unsigned char c) {
+  const uint64_t x = word ^ (kEscapeScanLsbs * c);
+  return (x - kEscapeScanLsbs) & ~x & kEscapeScanMsbs;
+}
+
+// Returns true if any byte of 'word' might need escaping by CEscapeInternal
+// with the same 'utf8_safe' and 'escape_quote_char' arguments.  Must stay in
+// sync with the switch in CEscapeInternal; bytes it reports clean are exactly
+// those the switch copies through unmodified.
+static inline bool AnyByteNeedsEscaping(uint64_t word, bool utf8_safe,
+                                        char escape_quote_char) {
+  // Control bytes (< 0x20) and DEL are the non-printable ASCII bytes; this
+  // covers \n, \r and \t as well.
+  uint64_t flagged = (word - kEscapeScanLsbs * 0x20) & ~word & kEscapeScanMsbs;
+  flagged |= AnyByteEquals(word, 0x7F);
+  flagged |= AnyByteEquals(word, '\\');
+  if (escape_quote_char != 0) {
+    flagged |= AnyByteEquals(word, escape_quote_char);
+  } else {
+    flagged |= AnyByteEquals(word, '\'');
+    flagged |= AnyByteEquals(word, '\"');
+    flagged |= AnyByteEquals(word, '`');
+  }
+  if (!utf8_safe) flagged |= word & kEscapeScanMsbs;
+  return flagged != 0;
+}
+
+// Scalar version of AnyByteNeedsEscaping for span tails.
+static inline bool ByteNeedsEscaping(unsigned char c, bool utf8_safe,
+                                     char escape_quote_char) {
+  switch (c) {
+    case '\n':
+    case '\r':
+    case '\t':
+    case '\\':
+      return true;
+    case '\'':
+    case '\"':
+    case '`':
+      return escape_quote_char == 0 || c == escape_quote_char;
+    default:
+      return (!utf8_safe || c < 0x80) && !absl::ascii_isprint(c);
+  }
+}
+
 static std::string CEscapeInternal(absl::string_view src, bool utf8_safe,
                               char escape_quote_char) {
   std::string dest;
   bool last_hex_escape = false;  // true if last output char was \xNN.
 
   for (const char* p = src.begin(); p < src.end(); ++p) {
+    if (!last_hex_escape) {
+      // Fast path: find the longest clean span starting at 'p' and append it
+      // in one piece.  (After a hex escape the next byte needs escaping when
+      // it is a hex digit, so the byte-wise loop below must look at it.)
+      const char* clean_end = p;
+      while (src.end() - clean_end >= 8) {
+        uint64_t word;
+        memcpy(&word, clean_end, 8);
+        if (AnyByteNeedsEscaping(word, utf8_safe, escape_quote_char)) break;
+        clean_end += 8;
+      }
+      while (clean_end < src.end() &&
+             !ByteNeedsEscaping(*clean_end, utf8_safe, escape_quote_char)) {
+        ++clean_end;
+      }
+      if (clean_end != p) {
+        dest.append(p, clean_end - p);
+        if (clean_end == src.end()) break;
+        p = clean_end;
+      }
+    }
     unsigned char c = *p;
     bool is_hex_escape = false;
     switch (c) {
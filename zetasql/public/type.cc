@@ -407,11 +407,50 @@ zetasql_base::Status Type::SerializeToProtoAndDistinctFileDescriptors(
       file_descriptor_set_map);
 }
 
+// Returns true if <type> transitively references any proto or enum
+// descriptors. Serializing such a type modifies the FileDescriptorSetMap and
+// embeds descriptor set indices in the TypeProto, so its serialized form
+// cannot be cached on the Type.
+static bool ReferencesProtoOrEnumDescriptors(const Type* type) {
+  switch (type->kind()) {
+    case TYPE_PROTO:
+    case TYPE_ENUM:
+      return true;
+    case TYPE_ARRAY:
+      return ReferencesProtoOrEnumDescriptors(
+          type->AsArray()->element_type());
+    case TYPE_STRUCT:
+      for (const StructField& field : type->AsStruct()->fields()) {
+        if (ReferencesProtoOrEnumDescriptors(field.type)) return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
 zetasql_base::Status Type::SerializeToProtoAndDistinctFileDescriptors(
     TypeProto* type_proto,
     absl::optional<int64_t> file_descriptor_sets_max_size_bytes,
     FileDescriptorSetMap* file_descriptor_set_map) const {
   ZETASQL_RET_CHECK(file_descriptor_set_map != nullptr);
+  absl::call_once(build_serialized_proto_once_, [this] {
+    if (ReferencesProtoOrEnumDescriptors(this)) return;
+    auto serialized_proto = absl::make_unique<TypeProto>();
+    FileDescriptorSetMap unused_map;
+    if (SerializeToProtoAndDistinctFileDescriptorsImpl(
+            serialized_proto.get(),
+            /*file_descriptor_sets_max_size_bytes=*/absl::optional<int64_t>(),
+            &unused_map)
+            .ok() &&
+        unused_map.empty()) {
+      cached_serialized_proto_ = std::move(serialized_proto);
+    }
+  });
+  if (cached_serialized_proto_ != nullptr) {
+    *type_proto = *cached_serialized_proto_;
+    return ::zetasql_base::OkStatus();
+  }
   type_proto->Clear();
   return SerializeToProtoAndDistinctFileDescriptorsImpl(
       type_proto, file_descriptor_sets_max_size_bytes, file_descriptor_set_map);
@@ -450,9 +489,9 @@ namespace {
 // Possible return values are HAS_FIELD if the field exists, HAS_PSEUDO_FIELD
 // if the named extension exists, or HAS_NO_FIELD if neither exists.
 Type::HasFieldResult HasProtoFieldOrNamedExtension(
-    const google::protobuf::Descriptor* descriptor, const std::string& name, int* field_id) {
+    const ProtoType* proto_type, const std::string& name, int* field_id) {
   const google::protobuf::FieldDescriptor* field =
-      ProtoType::FindFieldByNameIgnoreCase(descriptor, name);
+      proto_type->FindFieldByNameIgnoreCase(name);
   if (field != nullptr) {
     *field_id = field->number();
     return Type::HAS_FIELD;
@@ -478,13 +517,13 @@ Type::HasFieldResult Type::HasField(const std::string& name, int* field_id,
       result = HAS_FIELD;
     }
   } else if (this->IsProto()) {
-    const google::protobuf::Descriptor* descriptor = this->AsProto()->descriptor();
+    const ProtoType* proto_type = this->AsProto();
     if (include_pseudo_fields) {
       // Consider virtual fields in addition to physical fields, which means
       // there may be ambiguity between a built-in field and a virtual field.
-      result = HasProtoFieldOrNamedExtension(descriptor, name, &found_idx);
+      result = HasProtoFieldOrNamedExtension(proto_type, name, &found_idx);
       if (absl::StartsWithIgnoreCase(name, "has_") &&
-          HasProtoFieldOrNamedExtension(descriptor, name.substr(4),
+          HasProtoFieldOrNamedExtension(proto_type, name.substr(4),
                                         &found_idx) != HAS_NO_FIELD) {
         result =
             (result != HAS_NO_FIELD) ? HAS_AMBIGUOUS_FIELD : HAS_PSEUDO_FIELD;
@@ -492,7 +531,7 @@ Type::HasFieldResult Type::HasField(const std::string& name, int* field_id,
     } else {
       // Look for physical field only, so the result is always unambiguous.
       const google::protobuf::FieldDescriptor* field =
-          ProtoType::FindFieldByNameIgnoreCase(descriptor, name);
+          proto_type->FindFieldByNameIgnoreCase(name);
       if (field != nullptr) {
         found_idx = field->number();
         result = Type::HAS_FIELD;
@@ -654,10 +693,22 @@ static zetasql_base::Status PopulateDistinctFileDescriptorSets(
         file_descriptor_sets_max_size_bytes.value() - map_total_size +
         file_descriptor_entry->file_descriptor_set.ByteSizeLong();
   }
-  ZETASQL_RETURN_IF_ERROR(PopulateFileDescriptorSet(
-      file_descr, this_file_descriptor_set_max_size,
-      &file_descriptor_entry->file_descriptor_set,
-      &file_descriptor_entry->file_descriptors));
+  if (file_descr->pool() == google::protobuf::DescriptorPool::generated_pool()) {
+    // Files in the generated pool are immortal, so their dependency closures
+    // can be memoized process-wide.  Other pools may be destroyed (and their
+    // FileDescriptor addresses reused), so they take the uncached path.
+    static FileDescriptorClosureCache* generated_pool_closures =
+        new FileDescriptorClosureCache;
+    ZETASQL_RETURN_IF_ERROR(PopulateFileDescriptorSet(
+        file_descr, this_file_descriptor_set_max_size, generated_pool_closures,
+        &file_descriptor_entry->file_descriptor_set,
+        &file_descriptor_entry->file_descriptors));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(PopulateFileDescriptorSet(
+        file_descr, this_file_descriptor_set_max_size,
+        &file_descriptor_entry->file_descriptor_set,
+        &file_descriptor_entry->file_descriptors));
+  }
   *file_descriptor_set_index = file_descriptor_entry->descriptor_set_index;
   return zetasql_base::OkStatus();
 }
@@ -926,6 +977,14 @@ std::string StructType::DebugString(bool details) const {
   return DebugStringImpl(std::numeric_limits<int>::max(), field_debug_fn);
 }
 
+int64_t StructType::GetEstimatedOwnedMemoryBytesSize() const {
+  int64_t bytes = sizeof(*this);
+  for (const StructField& field : fields_) {
+    bytes += sizeof(field) + field.name.size();
+  }
+  return bytes;
+}
+
 const StructType::StructField* StructType::FindField(
     absl::string_view name, bool* is_ambiguous, int* found_idx) const {
   *is_ambiguous = false;
@@ -936,28 +995,24 @@ const StructType::StructField* StructType::FindField(
     return nullptr;
   }
 
-  int field_index;
-  {
-    absl::MutexLock lock(&mutex_);
-    if (ABSL_PREDICT_FALSE(field_name_to_index_map_.empty())) {
-      for (int i = 0; i < num_fields(); ++i) {
-        const std::string& field_name = field(i).name;
-        // Empty names indicate unnamed fields, not fields which can be looked
-        // up by name. They are not added to the map.
-        if (!field_name.empty()) {
-          auto result = field_name_to_index_map_.emplace(field_name, i);
-          // If the name has already been added to the map, we know any lookup
-          // on that name would be ambiguous.
-          if (!result.second) result.first->second = -1;
-        }
+  absl::call_once(build_field_map_once_, [this] {
+    for (int i = 0; i < num_fields(); ++i) {
+      const std::string& field_name = field(i).name;
+      // Empty names indicate unnamed fields, not fields which can be looked
+      // up by name. They are not added to the map.
+      if (!field_name.empty()) {
+        auto result = field_name_to_index_map_.emplace(field_name, i);
+        // If the name has already been added to the map, we know any lookup
+        // on that name would be ambiguous.
+        if (!result.second) result.first->second = -1;
       }
     }
-    const auto iter = field_name_to_index_map_.find(name);
-    if (ABSL_PREDICT_FALSE(iter == field_name_to_index_map_.end())) {
-      return nullptr;
-    }
-    field_index = iter->second;
+  });
+  const auto iter = field_name_to_index_map_.find(name);
+  if (ABSL_PREDICT_FALSE(iter == field_name_to_index_map_.end())) {
+    return nullptr;
   }
+  const int field_index = iter->second;
 
   if (ABSL_PREDICT_FALSE(field_index == -1)) {
     *is_ambiguous = true;
@@ -1275,6 +1330,21 @@ const google::protobuf::FieldDescriptor* ProtoType::FindFieldByNameIgnoreCase(
   return nullptr;
 }
 
+const google::protobuf::FieldDescriptor* ProtoType::FindFieldByNameIgnoreCase(
+    absl::string_view name) const {
+  absl::call_once(build_field_map_once_, [this] {
+    field_name_map_.reserve(descriptor_->field_count());
+    for (int i = 0; i < descriptor_->field_count(); ++i) {
+      const google::protobuf::FieldDescriptor* field = descriptor_->field(i);
+      // Protos with field names that differ only in case do not compile in
+      // c++ or java, so we don't worry about clashes here.
+      field_name_map_.emplace(field->name(), field);
+    }
+  });
+  const auto iter = field_name_map_.find(name);
+  return iter == field_name_map_.end() ? nullptr : iter->second;
+}
+
 bool ProtoType::HasFormatAnnotation(
     const google::protobuf::FieldDescriptor* field) {
   return GetFormatAnnotationImpl(field) != FieldFormat::DEFAULT_FORMAT;
@@ -1525,16 +1595,46 @@ TypeFactory::~TypeFactory() {
 }
 
 int TypeFactory::nesting_depth_limit() const {
-  absl::MutexLock l(&mutex_);
-  return nesting_depth_limit_;
+  return nesting_depth_limit_.load(std::memory_order_relaxed);
 }
 
 void TypeFactory::set_nesting_depth_limit(int value) {
   // We don't want to have to check the depth for simple types, so a depth of
   // 0 must be allowed.
   DCHECK_GE(value, 0);
-  absl::MutexLock l(&mutex_);
-  nesting_depth_limit_ = value;
+  nesting_depth_limit_.store(value, std::memory_order_relaxed);
+}
+
+int64_t TypeFactory::num_types() const {
+  absl::MutexLock lock(&mutex_);
+  return owned_types_.size();
+}
+
+int64_t TypeFactory::estimated_memory_bytes() const {
+  int64_t bytes = sizeof(TypeFactory);
+  {
+    absl::MutexLock lock(&mutex_);
+    bytes += owned_types_.capacity() * sizeof(const Type*);
+    for (const Type* type : owned_types_) {
+      bytes += type->GetEstimatedOwnedMemoryBytesSize();
+    }
+  }
+  {
+    absl::MutexLock lock(&array_types_mutex_);
+    bytes += cached_array_types_.capacity() *
+             sizeof(std::pair<const Type*, const ArrayType*>);
+  }
+  {
+    absl::MutexLock lock(&proto_types_mutex_);
+    bytes += cached_proto_types_.capacity() *
+             sizeof(std::pair<const google::protobuf::Descriptor*, const ProtoType*>);
+  }
+  {
+    absl::MutexLock lock(&enum_types_mutex_);
+    bytes += cached_enum_types_.capacity() *
+             sizeof(std::pair<const google::protobuf::EnumDescriptor*, const EnumType*>);
+  }
+  return bytes;
 }
 
 template <class TYPE>
@@ -1576,12 +1676,18 @@ const Type* TypeFactory::get_numeric() {
 
 const Type* TypeFactory::MakeSimpleType(TypeKind kind) {
   CHECK(Type::IsSimpleType(kind)) << kind;
+  // Simple types are created at most once and are immutable, so reads need
+  // no lock; the mutex only serializes first-time creation.
+  const Type* cached =
+      cached_simple_types_[kind].load(std::memory_order_acquire);
+  if (cached != nullptr) return cached;
   absl::MutexLock l(&mutex_);
-  if (cached_simple_types_[kind] == nullptr) {
-    cached_simple_types_[kind] =
-        TakeOwnershipLocked(new SimpleType(this, kind));
+  cached = cached_simple_types_[kind].load(std::memory_order_relaxed);
+  if (cached == nullptr) {
+    cached = TakeOwnershipLocked(new SimpleType(this, kind));
+    cached_simple_types_[kind].store(cached, std::memory_order_release);
   }
-  return cached_simple_types_[kind];
+  return cached;
 }
 
 zetasql_base::Status TypeFactory::MakeArrayType(
@@ -1598,7 +1704,15 @@ zetasql_base::Status TypeFactory::MakeArrayType(
              << "Array type would exceed nesting depth limit of "
              << depth_limit;
     }
+    absl::MutexLock l(&array_types_mutex_);
+    const ArrayType** cached =
+        zetasql_base::FindOrNull(cached_array_types_, element_type);
+    if (cached != nullptr) {
+      *result = *cached;
+      return ::zetasql_base::OkStatus();
+    }
     *result = TakeOwnership(new ArrayType(this, element_type));
+    zetasql_base::InsertOrDie(&cached_array_types_, element_type, *result);
     return ::zetasql_base::OkStatus();
   }
 }
@@ -1651,7 +1765,15 @@ zetasql_base::Status TypeFactory::MakeStructTypeFromVector(
 
 zetasql_base::Status TypeFactory::MakeProtoType(
     const google::protobuf::Descriptor* descriptor, const ProtoType** result) {
+  absl::MutexLock l(&proto_types_mutex_);
+  const ProtoType** cached =
+      zetasql_base::FindOrNull(cached_proto_types_, descriptor);
+  if (cached != nullptr) {
+    *result = *cached;
+    return ::zetasql_base::OkStatus();
+  }
   *result = TakeOwnership(new ProtoType(this, descriptor));
+  zetasql_base::InsertOrDie(&cached_proto_types_, descriptor, *result);
   return ::zetasql_base::OkStatus();
 }
 
@@ -1662,7 +1784,15 @@ zetasql_base::Status TypeFactory::MakeProtoType(
 
 zetasql_base::Status TypeFactory::MakeEnumType(
     const google::protobuf::EnumDescriptor* enum_descriptor, const EnumType** result) {
+  absl::MutexLock l(&enum_types_mutex_);
+  const EnumType** cached =
+      zetasql_base::FindOrNull(cached_enum_types_, enum_descriptor);
+  if (cached != nullptr) {
+    *result = *cached;
+    return ::zetasql_base::OkStatus();
+  }
   *result = TakeOwnership(new EnumType(this, enum_descriptor));
+  zetasql_base::InsertOrDie(&cached_enum_types_, enum_descriptor, *result);
   return ::zetasql_base::OkStatus();
 }
 
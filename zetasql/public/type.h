@@ -20,6 +20,7 @@
 // TODO Maybe store and re-use the same type object for all identical
 //   struct/array/proto/enum types?
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -35,6 +36,7 @@
 #include "zetasql/public/type.pb.h"
 #include "absl/base/attributes.h"
 #include <cstdint>
+#include "absl/base/call_once.h"
 #include "absl/base/macros.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -425,6 +427,12 @@ class Type {
   // this type. For simple types this is 0.
   virtual int nesting_depth() const { return 0; }
 
+  // Estimated size in bytes of this type object, including memory it owns
+  // (e.g. struct field name strings) but excluding other Type objects it
+  // points at, which are counted separately by the factory that owns them.
+  // Used by TypeFactory::estimated_memory_bytes().
+  virtual int64_t GetEstimatedOwnedMemoryBytesSize() const = 0;
+
  protected:
   // Types can only be created and destroyed by TypeFactory.
   Type(const TypeFactory* factory, TypeKind kind);
@@ -474,6 +482,15 @@ class Type {
   // supported LanguageFeatures.  Crashes if 'type' is not a simple type.
   bool IsSupportedSimpleType(const LanguageOptions& language_options) const;
 
+  // Lazily built cache of this type serialized as a TypeProto, used by
+  // SerializeToProtoAndDistinctFileDescriptors. It is only populated for
+  // types that do not transitively reference any proto or enum descriptors,
+  // for which the serialized form is independent of the caller's
+  // FileDescriptorSetMap. Types are immutable, so the cache never needs
+  // invalidation; it is built exactly once and read without a lock.
+  mutable absl::once_flag build_serialized_proto_once_;
+  mutable std::unique_ptr<TypeProto> cached_serialized_proto_;
+
   friend class TypeFactory;
   friend class ArrayType;
   friend class StructType;
@@ -493,6 +510,10 @@ class SimpleType : public Type {
   std::string TypeName(ProductMode mode) const override;
   std::string DebugString(bool details = false) const override;
 
+  int64_t GetEstimatedOwnedMemoryBytesSize() const override {
+    return sizeof(*this);
+  }
+
  protected:
   SimpleType(const TypeFactory* factory, TypeKind kind);
   ~SimpleType() override;
@@ -541,6 +562,10 @@ class ArrayType : public Type {
     return element_type_->nesting_depth() + 1;
   }
 
+  int64_t GetEstimatedOwnedMemoryBytesSize() const override {
+    return sizeof(*this);
+  }
+
  private:
   ArrayType(const TypeFactory* factory, const Type* element_type);
   ~ArrayType() override;
@@ -628,6 +653,8 @@ class StructType : public Type {
 
   int nesting_depth() const override { return nesting_depth_; }
 
+  int64_t GetEstimatedOwnedMemoryBytesSize() const override;
+
  private:
   // Caller must enforce that <nesting_depth> is accurate. No verification is
   // done.
@@ -661,11 +688,13 @@ class StructType : public Type {
   const int nesting_depth_;
 
   // Lazily built map from name to struct field index. Ambiguous lookups are
-  // designated with an index of -1. This is only built if FindField is called.
-  mutable absl::Mutex mutex_;
+  // designated with an index of -1. This is only built if FindField is
+  // called, and is built exactly once; it is immutable afterwards, so
+  // lookups read it without taking a lock.
+  mutable absl::once_flag build_field_map_once_;
   mutable absl::flat_hash_map<absl::string_view, int, zetasql_base::StringViewCaseHash,
                               zetasql_base::StringViewCaseEqual>
-      field_name_to_index_map_ GUARDED_BY(mutex_);
+      field_name_to_index_map_;
 
   friend class TypeFactory;
 };
@@ -703,6 +732,10 @@ class ProtoType : public Type {
   std::string TypeName() const;  // Proto-specific version does not need mode.
   std::string DebugString(bool details = false) const override;
 
+  int64_t GetEstimatedOwnedMemoryBytesSize() const override {
+    return sizeof(*this);
+  }
+
   // Get the ZetaSQL Type of the requested field of the proto, identified by
   // either tag number or name.  A new Type may be created so a type factory
   // is required.  If the field name or number is not found, then
@@ -788,6 +821,15 @@ class ProtoType : public Type {
   static const google::protobuf::FieldDescriptor* FindFieldByNameIgnoreCase(
       const google::protobuf::Descriptor* descriptor, const std::string& name);
 
+  // Same lookup on this proto type, backed by a lazily built index over the
+  // descriptor's field names. ProtoTypes are interned per descriptor in
+  // TypeFactory, so the index is built at most once per descriptor; lookups
+  // then avoid the linear descriptor scan done by the static overload.
+  // Callers that have the ProtoType in hand should prefer this form.
+  // Returns NULL if the name is not found.
+  const google::protobuf::FieldDescriptor* FindFieldByNameIgnoreCase(
+      absl::string_view name) const;
+
   // Get the zetasql Format from a FieldDescriptor.
   // Note that if a deprecated Encoding annotation exists and is valid,
   // this merges it over top of the Format annotation and acts as if the
@@ -896,6 +938,17 @@ class ProtoType : public Type {
 
   const google::protobuf::Descriptor* descriptor_;  // Not owned.
 
+  // Lazily built case-insensitive map from field name to FieldDescriptor.
+  // This is only built if the instance FindFieldByNameIgnoreCase is called,
+  // and is built exactly once; it is immutable afterwards, so lookups read
+  // it without taking a lock. Keys point at names owned by <descriptor_>.
+  mutable absl::once_flag build_field_map_once_;
+  mutable absl::flat_hash_map<absl::string_view,
+                              const google::protobuf::FieldDescriptor*,
+                              zetasql_base::StringViewCaseHash,
+                              zetasql_base::StringViewCaseEqual>
+      field_name_map_;
+
   friend class TypeFactory;
 };
 
@@ -947,6 +1000,10 @@ class EnumType : public Type {
   // upon success, and false if the name is not found.
   ABSL_MUST_USE_RESULT bool FindNumber(const std::string& name, int* number) const;
 
+  int64_t GetEstimatedOwnedMemoryBytesSize() const override {
+    return sizeof(*this);
+  }
+
  private:
   // Does not take ownership of <factory> or <enum_descr>.  The
   // <enum_descriptor> must outlive the type.  The <enum_descr> must not be
@@ -1035,6 +1092,8 @@ class TypeFactory {
 
   // Make an array type.
   // Arrays of arrays are not supported and will fail with an error.
+  // Array types are interned per element type, so repeated calls with the
+  // same element type return the same ArrayType object.
   zetasql_base::Status MakeArrayType(const Type* element_type,
                              const ArrayType** result);
   zetasql_base::Status MakeArrayType(const Type* element_type,
@@ -1059,6 +1118,9 @@ class TypeFactory {
   // which normally indicate the proto should be interpreted as
   // a different type.  Use MakeUnwrappedTypeFromProto instead
   // to get the unwrapped type.
+  //
+  // Proto types are interned per descriptor, so repeated calls with the same
+  // descriptor return the same ProtoType object.
   zetasql_base::Status MakeProtoType(const google::protobuf::Descriptor* descriptor,
                              const ProtoType** result);
   zetasql_base::Status MakeProtoType(const google::protobuf::Descriptor* descriptor,
@@ -1096,6 +1158,8 @@ class TypeFactory {
 
   // Make an enum type from a protocol buffer EnumDescriptor.
   // The <enum_descriptor> must outlive this TypeFactory.
+  // Enum types are interned per descriptor, so repeated calls with the same
+  // descriptor return the same EnumType object.
   zetasql_base::Status MakeEnumType(const google::protobuf::EnumDescriptor* enum_descriptor,
                             const EnumType** result);
   zetasql_base::Status MakeEnumType(const google::protobuf::EnumDescriptor* enum_descriptor,
@@ -1174,8 +1238,21 @@ class TypeFactory {
   // it cannot destruct. Use kint32max for no limit (the default).
   // The limit value must be >= 0. The default value of this field can be
   // overidden with FLAGS_zetasql_type_factory_nesting_depth_limit.
-  int nesting_depth_limit() const LOCKS_EXCLUDED(mutex_);
-  void set_nesting_depth_limit(int value) LOCKS_EXCLUDED(mutex_);
+  int nesting_depth_limit() const;
+  void set_nesting_depth_limit(int value);
+
+  // Memory introspection for long-lived processes.  Returns the number of
+  // types this factory owns, and an estimate of the bytes they occupy
+  // (including the factory's interning caches).
+  //
+  // Types are handed out as plain unrefcounted pointers and interned for the
+  // factory's lifetime, so a factory only grows; individual types cannot be
+  // safely evicted.  Callers that analyze many statements with novel types
+  // should scope a factory to a session and, when these counters grow too
+  // large, discard the whole factory together with the AnalyzerOutputs that
+  // reference its types.
+  int64_t num_types() const LOCKS_EXCLUDED(mutex_);
+  int64_t estimated_memory_bytes() const LOCKS_EXCLUDED(mutex_);
 
  private:
   // Store links to and from TypeFactories that this TypeFactory depends on.
@@ -1222,10 +1299,27 @@ class TypeFactory {
 
   // TODO: Should TypeFactory have a DescriptorPool?
   mutable absl::Mutex mutex_;
-  const Type* cached_simple_types_[TypeKind_ARRAYSIZE] GUARDED_BY(mutex_);
+  // Simple types are created at most once and are immutable afterwards, so
+  // reads take a lock-free fast path; <mutex_> only serializes creation.
+  std::atomic<const Type*> cached_simple_types_[TypeKind_ARRAYSIZE];
   std::vector<const Type*> owned_types_ GUARDED_BY(mutex_);
 
-  int nesting_depth_limit_ GUARDED_BY(mutex_);
+  // Interning caches for constructed types, sharded by type kind so that
+  // concurrent analysis threads building array, proto and enum types do not
+  // contend on a single lock.  Cache hits take only the shard lock;
+  // <mutex_> is additionally taken (inside the shard lock) when a new type
+  // is created and added to <owned_types_>.
+  mutable absl::Mutex array_types_mutex_;
+  absl::flat_hash_map<const Type*, const ArrayType*> cached_array_types_
+      GUARDED_BY(array_types_mutex_);
+  mutable absl::Mutex proto_types_mutex_;
+  absl::flat_hash_map<const google::protobuf::Descriptor*, const ProtoType*>
+      cached_proto_types_ GUARDED_BY(proto_types_mutex_);
+  mutable absl::Mutex enum_types_mutex_;
+  absl::flat_hash_map<const google::protobuf::EnumDescriptor*, const EnumType*>
+      cached_enum_types_ GUARDED_BY(enum_types_mutex_);
+
+  std::atomic<int> nesting_depth_limit_;
 };
 
 namespace types {
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <stack>
 #include <utility>
@@ -86,6 +87,8 @@ namespace zetasql {
 // Value
 // -------------------------------------------------------
 
+const int Value::kCappedDebugStringMaxElements;
+
 std::ostream& operator<<(std::ostream& out, const Value& value) {
   return out << value.FullDebugString();
 }
@@ -109,7 +112,7 @@ Value::Value(const Type* type)
       break;
     case TYPE_STRING:
     case TYPE_BYTES:
-      string_ptr_ = new StringRef();
+      string_ptr_ = StringRef::New(std::string());
       break;
     case TYPE_GEOGRAPHY:
       geography_ptr_ = new GeographyRef();
@@ -122,7 +125,7 @@ Value::Value(const Type* type)
       break;
     case TYPE_ARRAY:
     case TYPE_STRUCT:
-      list_ptr_ = new TypedList(type);
+      list_ptr_ = TypedList::New(type);
       break;
     case TYPE_PROTO:
       proto_ptr_ = new ProtoRep(type->AsProto(),
@@ -226,6 +229,13 @@ Value::Value(const ProtoType* proto_type, const std::string& value)
     : type_kind_(TYPE_PROTO),
       proto_ptr_(new ProtoRep(proto_type, std::move(value))) {}
 
+Value Value::BorrowedProto(const ProtoType* type, absl::string_view value) {
+  Value result;
+  result.type_kind_ = TYPE_PROTO;
+  result.proto_ptr_ = new ProtoRep(type, value, ProtoRep::Borrowed());
+  return result;
+}
+
 #ifdef NDEBUG
 static constexpr bool kDebugMode = false;
 #else
@@ -314,6 +324,21 @@ const std::vector<Value>& Value::elements() const {
   return list_ptr_->values();
 }
 
+std::vector<Value> Value::TakeAsVector() {
+  CHECK(type_kind_ == TYPE_ARRAY || type_kind_ == TYPE_STRUCT)
+      << "Not an array or struct: " << DebugString();
+  CHECK(!is_null()) << "Null value";
+  std::vector<Value> values;
+  if (list_ptr_->RefCountIsOne()) {
+    // Sole owner of the element list: move the vector out without copying.
+    values = std::move(list_ptr_->values());
+  } else {
+    values = list_ptr_->values();
+  }
+  Clear();
+  return values;
+}
+
 Value Value::TimestampFromUnixMicros(int64_t v) {
   CHECK(functions::IsValidTimestamp(v, functions::kMicroseconds)) << v;
   return Value(absl::FromUnixMicros(v));
@@ -460,7 +485,7 @@ std::string Value::ToCord() const {
     case TYPE_BYTES:
       return string_ptr_->value();
     case TYPE_PROTO:
-      return proto_ptr_->value();
+      return std::string(proto_ptr_->value());
     default:
       LOG(FATAL) << "Cannot coerce to Cord";
       return "";
@@ -510,11 +535,24 @@ google::protobuf::Message* Value::ToMessage(
 const Value& Value::FindFieldByName(absl::string_view name) const {
   CHECK(type()->IsStruct());
   CHECK(!is_null()) << "Null value";
+  const StructType* struct_type = type()->AsStruct();
   if (!name.empty()) {
-    // Find field position.
-    for (int i = 0; i < type()->AsStruct()->num_fields(); i++) {
-      if (type()->AsStruct()->field(i).name == name) {
-        return field(i);
+    // Find the field position through the struct type's cached name map. The
+    // map is case insensitive while this lookup is exact, so verify the found
+    // name, and fall back to a linear scan when the map reports an ambiguity
+    // (distinct fields whose names differ only in case).
+    bool is_ambiguous = false;
+    int found_idx = -1;
+    const StructType::StructField* struct_field =
+        struct_type->FindField(name, &is_ambiguous, &found_idx);
+    if (struct_field != nullptr && struct_field->name == name) {
+      return field(found_idx);
+    }
+    if (is_ambiguous) {
+      for (int i = 0; i < struct_type->num_fields(); i++) {
+        if (struct_type->field(i).name == name) {
+          return field(i);
+        }
       }
     }
   }
@@ -530,7 +568,7 @@ static bool TypesDiffer(const Value& x, const Value& y, std::string* reason) {
         absl::Substitute("Types differ: {$0} vs. {$1} respectively of "
                          "values {$2} and {$3}\n",
                          x.type()->DebugString(), y.type()->DebugString(),
-                         x.DebugString(), y.DebugString()));
+                         x.CappedDebugString(), y.CappedDebugString()));
   }
   return false;
 }
@@ -630,8 +668,8 @@ bool Value::EqualsInternal(const Value& x, const Value& y, bool allow_bags,
               Substitute(
                   "Number of array elements is {$0} and {$1} in respective "
                   "arrays {$2} and {$3}\n",
-                  x.num_elements(), y.num_elements(), x.DebugString(),
-                  y.DebugString()));
+                  x.num_elements(), y.num_elements(), x.CappedDebugString(),
+                  y.CappedDebugString()));
         }
         return false;
       }
@@ -659,8 +697,8 @@ bool Value::EqualsInternal(const Value& x, const Value& y, bool allow_bags,
               Substitute(
                   "Number of struct fields is {$0} and {$1} in respective "
                   "structs {$2} and {$3}\n",
-                  x.num_fields(), y.num_fields(), x.DebugString(),
-                  y.DebugString()));
+                  x.num_fields(), y.num_fields(), x.CappedDebugString(),
+                  y.CappedDebugString()));
         }
         return false;
       }
@@ -776,8 +814,8 @@ bool Value::EqualElementMultiSet(const Value& x, const Value& y,
       if (reason) {
         absl::StrAppend(
             reason, Substitute("Multiset element $0 of $1 is missing in $2\n",
-                               element.DebugString(), x.DebugString(),
-                               y.DebugString()));
+                               element.CappedDebugString(),
+                               x.CappedDebugString(), y.CappedDebugString()));
       }
       return false;
     }
@@ -788,8 +826,8 @@ bool Value::EqualElementMultiSet(const Value& x, const Value& y,
             Substitute(
                 "Number of occurrences of multiset element $0 is $1 and $2 "
                 "respectively in multisets $3 and $4\n",
-                element.DebugString(), p.second, it->second, x.DebugString(),
-                y.DebugString()));
+                element.CappedDebugString(), p.second, it->second,
+                x.CappedDebugString(), y.CappedDebugString()));
       }
       return false;
     }
@@ -804,8 +842,8 @@ bool Value::EqualElementMultiSet(const Value& x, const Value& y,
       if (x_multiset.find(element) == x_multiset.end()) {
         absl::StrAppend(
             reason, Substitute("Multiset element $0 of $1 is missing in $2\n",
-                               element.DebugString(), y.DebugString(),
-                               x.DebugString()));
+                               element.CappedDebugString(),
+                               y.CappedDebugString(), x.CappedDebugString()));
       }
     }
     DCHECK(!reason->empty());
@@ -1269,6 +1307,14 @@ static std::string CapitalizedNameForType(const Type* type) {
 }
 
 std::string Value::DebugString(bool verbose) const {
+  return DebugStringImpl(verbose, std::numeric_limits<int>::max());
+}
+
+std::string Value::CappedDebugString(bool verbose) const {
+  return DebugStringImpl(verbose, kCappedDebugStringMaxElements);
+}
+
+std::string Value::DebugStringImpl(bool verbose, int max_array_elements) const {
   std::map<const Value*, std::string> debug_string_map;
   std::vector<const Value*> inner_values;
   std::stack<const Value*> stack;
@@ -1287,11 +1333,13 @@ std::string Value::DebugString(bool verbose) const {
             stack.push(&value->fields()[i]);
           }
         } break;
-        case TYPE_ARRAY:
-          for (const auto& elem : value->elements()) {
-            stack.push(&elem);
+        case TYPE_ARRAY: {
+          const int push_count =
+              std::min(value->num_elements(), max_array_elements);
+          for (int i = 0; i < push_count; i++) {
+            stack.push(&value->element(i));
           }
-          break;
+        } break;
         default:
           break;
       }
@@ -1303,15 +1351,15 @@ std::string Value::DebugString(bool verbose) const {
   // std::string, storing the result on the map, using the map instead of a recursive
   // call to retrieve child values.
   for (int i = static_cast<int>(inner_values.size()) - 1; i >= 0; --i) {
-    debug_string_map[inner_values[i]] =
-        inner_values[i]->DebugStringInternal(verbose, debug_string_map);
+    debug_string_map[inner_values[i]] = inner_values[i]->DebugStringInternal(
+        verbose, max_array_elements, debug_string_map);
   }
 
   return debug_string_map[inner_values[0]];
 }
 
 std::string Value::DebugStringInternal(
-    bool verbose,
+    bool verbose, int max_array_elements,
     const std::map<const Value*, std::string>& debug_string_map) const {
   if (type_kind_ == kInvalidTypeKind) { return "Uninitialized value"; }
   if (!is_valid())
@@ -1385,8 +1433,13 @@ std::string Value::DebugStringInternal(
         // on arrays without also having structs, and we'll catch the stack
         // overflow on the struct.
         std::vector<std::string> elems;
-        for (const auto& t : elements()) {
-          elems.push_back(debug_string_map.at(&t));
+        const int render_count = std::min(num_elements(), max_array_elements);
+        for (int i = 0; i < render_count; i++) {
+          elems.push_back(debug_string_map.at(&element(i)));
+        }
+        if (num_elements() > max_array_elements) {
+          elems.push_back(absl::StrCat(
+              "..., and ", num_elements() - max_array_elements, " more"));
         }
         std::string order_str = order_kind() == kIgnoresOrder ? "unordered: " : "";
         s = absl::StrCat("[", order_str, absl::StrJoin(elems, ", "), "]");
@@ -184,6 +184,15 @@ class Value {
   const Value& element(int i) const;
   const std::vector<Value>& elements() const;
 
+#ifndef SWIG
+  // Destructively reads the elements of an array or the fields of a struct.
+  // If this Value holds the only reference to its element list, the vector
+  // is moved out without copying the elements; otherwise they are copied.
+  // This Value becomes invalid.
+  // REQUIRES: array or struct type, !is_null().
+  std::vector<Value> TakeAsVector();
+#endif
+
   // Returns true if 'this' equals 'that' or both are null. This is *not* SQL
   // equality which returns null when either value is null. Returns false if
   // 'this' and 'that' have different types. For floating point values, returns
@@ -238,6 +247,16 @@ class Value {
   std::string FullDebugString() const { return DebugString(true); }
   std::string DebugString(bool verbose = false) const;
 
+  // Like DebugString(), but renders at most kCappedDebugStringMaxElements
+  // elements of each array, followed by a marker with the number of omitted
+  // elements, e.g. "[1, 2, ..., and 98 more]".  Error messages and log lines
+  // should prefer this form; stringifying a very large array with
+  // DebugString() can take seconds and produce unusably long output.
+  std::string CappedDebugString(bool verbose = false) const;
+
+  // Maximum number of array elements rendered by CappedDebugString().
+  static const int kCappedDebugStringMaxElements = 10;
+
   // Returns a pretty-printed (e.g. wrapped) std::string for the value.
   // Suitable for printing in golden-tests and documentation.
   std::string Format() const;
@@ -346,6 +365,12 @@ class Value {
   static Value Enum(const EnumType* type, absl::string_view name);
   // Creates a protocol buffer value.
   static Value Proto(const ProtoType* type, const std::string& value);
+  // Creates a protocol buffer value that references <value> without copying
+  // it.  The caller must guarantee that the referenced bytes outlive this
+  // Value and every copy of it, e.g. rows held in a long-lived buffer by a
+  // table iterator.  This avoids copying each row's bytes when feeding
+  // serialized proto rows into the evaluator.
+  static Value BorrowedProto(const ProtoType* type, absl::string_view value);
 
   // Creates a struct of the specified 'type' and given 'values'. The size of
   // the 'values' vector must agree with the number of fields in 'type', and the
@@ -530,8 +555,12 @@ class Value {
   // an approximate hash code.
   size_t HashCodeInternal(FloatMargin float_margin) const;
 
+  // Shared implementation of DebugString() and CappedDebugString().
+  // 'max_array_elements' bounds how many elements of each array are rendered.
+  std::string DebugStringImpl(bool verbose, int max_array_elements) const;
+
   std::string DebugStringInternal(
-      bool verbose,
+      bool verbose, int max_array_elements,
       const std::map<const Value*, std::string>& debug_string_map) const;
 
   // type_kind_ is either zetasql::TypeKind or -1 for invalid values.
@@ -575,6 +604,77 @@ class Value {
 static_assert(sizeof(Value) == sizeof(int64_t) * 2, "Value size mismatch");
 #endif
 
+#ifndef SWIG
+// Incrementally builds an array value.  Elements are moved into the builder
+// and the accumulated vector is moved, not copied, into the final Value, so
+// building large arrays (e.g. ARRAY_AGG results with millions of elements)
+// performs no element copies.  Call Reserve() up front when the element
+// count is known to avoid repeated vector growth.
+class ArrayValueBuilder {
+ public:
+  explicit ArrayValueBuilder(const ArrayType* type) : type_(type) {}
+
+  ArrayValueBuilder(const ArrayValueBuilder&) = delete;
+  ArrayValueBuilder& operator=(const ArrayValueBuilder&) = delete;
+
+  const ArrayType* type() const { return type_; }
+  int num_elements() const { return static_cast<int>(values_.size()); }
+
+  // Reserves storage for 'num_elements' elements.
+  void Reserve(int num_elements) { values_.reserve(num_elements); }
+
+  // Adds one element.  The element's type must be the same as
+  // type()->element_type(), but this is only CHECK'd in debug mode when the
+  // array is built.
+  void Add(Value value) { values_.push_back(std::move(value)); }
+
+  // Returns the built array, moving the accumulated elements into it.  The
+  // builder is left empty and may be reused.
+  Value Build() {
+    std::vector<Value> values = std::move(values_);
+    values_.clear();
+    return Value::UnsafeArray(type_, std::move(values));
+  }
+
+ private:
+  const ArrayType* type_;  // not owned
+  std::vector<Value> values_;
+};
+
+// Incrementally builds a struct value; the counterpart of ArrayValueBuilder
+// for structs.  Fields must be added in declaration order; the field count
+// must match the type when the struct is built (CHECK'd in debug mode).
+class StructValueBuilder {
+ public:
+  explicit StructValueBuilder(const StructType* type) : type_(type) {
+    values_.reserve(type->num_fields());
+  }
+
+  StructValueBuilder(const StructValueBuilder&) = delete;
+  StructValueBuilder& operator=(const StructValueBuilder&) = delete;
+
+  const StructType* type() const { return type_; }
+  int num_fields() const { return static_cast<int>(values_.size()); }
+
+  // Adds the next field, in declaration order.  The field's type must be
+  // the same as the corresponding field of type(), but this is only CHECK'd
+  // in debug mode when the struct is built.
+  void Add(Value value) { values_.push_back(std::move(value)); }
+
+  // Returns the built struct, moving the accumulated fields into it.  The
+  // builder is left empty and may be reused (after re-adding all fields).
+  Value Build() {
+    std::vector<Value> values = std::move(values_);
+    values_.clear();
+    return Value::UnsafeStruct(type_, std::move(values));
+  }
+
+ private:
+  const StructType* type_;  // not owned
+  std::vector<Value> values_;
+};
+#endif  // SWIG
+
 // Allow Value to be logged.
 std::ostream& operator<<(std::ostream& out, const Value& value);
 
@@ -615,6 +715,9 @@ Value UnsafeStruct(const StructType* type, std::vector<Value>&& values);
 #endif
 Value Proto(const ProtoType* proto_type, const std::string& value);
 Value Proto(const ProtoType* proto_type, const google::protobuf::Message& msg);
+// The bytes referenced by <value> must outlive the returned Value and every
+// copy of it; see Value::BorrowedProto.
+Value BorrowedProto(const ProtoType* proto_type, absl::string_view value);
 Value EmptyArray(const ArrayType* type);
 Value Array(const ArrayType* type, absl::Span<const Value> values);
 #ifndef SWIG
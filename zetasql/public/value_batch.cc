@@ -0,0 +1,250 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/value_batch.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "absl/memory/memory.h"
+
+namespace zetasql {
+
+ColumnVector::ColumnVector(const Type* type)
+    : type_(type), representation_(RepresentationForType(type)) {
+  CHECK(type != nullptr);
+}
+
+ColumnVector::Representation ColumnVector::RepresentationForType(
+    const Type* type) {
+  switch (type->kind()) {
+    case TYPE_INT32:
+    case TYPE_DATE:
+    case TYPE_ENUM:
+      return kInt32Storage;
+    case TYPE_INT64:
+      return kInt64Storage;
+    case TYPE_UINT32:
+      return kUint32Storage;
+    case TYPE_UINT64:
+      return kUint64Storage;
+    case TYPE_BOOL:
+      return kBoolStorage;
+    case TYPE_FLOAT:
+      return kFloatStorage;
+    case TYPE_DOUBLE:
+      return kDoubleStorage;
+    case TYPE_STRING:
+    case TYPE_BYTES:
+      return kStringStorage;
+    default:
+      return kValueStorage;
+  }
+}
+
+void ColumnVector::Append(const Value& value) {
+  DCHECK(value.type()->Equals(type_)) << "Expected " << type_->DebugString()
+                                      << " but got "
+                                      << value.type()->DebugString();
+  if (value.is_null()) {
+    AppendNull();
+    return;
+  }
+  nulls_.push_back(false);
+  switch (type_->kind()) {
+    case TYPE_INT32:
+      int32_storage_.push_back(value.int32_value());
+      break;
+    case TYPE_DATE:
+      int32_storage_.push_back(value.date_value());
+      break;
+    case TYPE_ENUM:
+      int32_storage_.push_back(value.enum_value());
+      break;
+    case TYPE_INT64:
+      int64_storage_.push_back(value.int64_value());
+      break;
+    case TYPE_UINT32:
+      uint32_storage_.push_back(value.uint32_value());
+      break;
+    case TYPE_UINT64:
+      uint64_storage_.push_back(value.uint64_value());
+      break;
+    case TYPE_BOOL:
+      bool_storage_.push_back(value.bool_value());
+      break;
+    case TYPE_FLOAT:
+      float_storage_.push_back(value.float_value());
+      break;
+    case TYPE_DOUBLE:
+      double_storage_.push_back(value.double_value());
+      break;
+    case TYPE_STRING:
+      string_storage_.push_back(value.string_value());
+      break;
+    case TYPE_BYTES:
+      string_storage_.push_back(value.bytes_value());
+      break;
+    default:
+      value_storage_.push_back(value);
+      break;
+  }
+}
+
+void ColumnVector::AppendNull() {
+  nulls_.push_back(true);
+  // Keep row indexes aligned with a placeholder entry.
+  switch (representation_) {
+    case kInt32Storage:
+      int32_storage_.push_back(0);
+      break;
+    case kInt64Storage:
+      int64_storage_.push_back(0);
+      break;
+    case kUint32Storage:
+      uint32_storage_.push_back(0);
+      break;
+    case kUint64Storage:
+      uint64_storage_.push_back(0);
+      break;
+    case kBoolStorage:
+      bool_storage_.push_back(false);
+      break;
+    case kFloatStorage:
+      float_storage_.push_back(0);
+      break;
+    case kDoubleStorage:
+      double_storage_.push_back(0);
+      break;
+    case kStringStorage:
+      string_storage_.push_back(std::string());
+      break;
+    case kValueStorage:
+      value_storage_.push_back(Value::Null(type_));
+      break;
+  }
+}
+
+Value ColumnVector::GetValue(int row) const {
+  DCHECK_GE(row, 0);
+  DCHECK_LT(row, num_rows());
+  if (nulls_[row]) return Value::Null(type_);
+  switch (type_->kind()) {
+    case TYPE_INT32:
+      return Value::Int32(int32_storage_[row]);
+    case TYPE_DATE:
+      return Value::Date(int32_storage_[row]);
+    case TYPE_ENUM:
+      return Value::Enum(type_->AsEnum(), int32_storage_[row]);
+    case TYPE_INT64:
+      return Value::Int64(int64_storage_[row]);
+    case TYPE_UINT32:
+      return Value::Uint32(uint32_storage_[row]);
+    case TYPE_UINT64:
+      return Value::Uint64(uint64_storage_[row]);
+    case TYPE_BOOL:
+      return Value::Bool(bool_storage_[row]);
+    case TYPE_FLOAT:
+      return Value::Float(float_storage_[row]);
+    case TYPE_DOUBLE:
+      return Value::Double(double_storage_[row]);
+    case TYPE_STRING:
+      return Value::String(string_storage_[row]);
+    case TYPE_BYTES:
+      return Value::Bytes(string_storage_[row]);
+    default:
+      return value_storage_[row];
+  }
+}
+
+void ColumnVector::Clear() {
+  nulls_.clear();
+  int32_storage_.clear();
+  int64_storage_.clear();
+  uint32_storage_.clear();
+  uint64_storage_.clear();
+  bool_storage_.clear();
+  float_storage_.clear();
+  double_storage_.clear();
+  string_storage_.clear();
+  value_storage_.clear();
+}
+
+void ColumnVector::Reserve(int num_rows) {
+  nulls_.reserve(num_rows);
+  switch (representation_) {
+    case kInt32Storage:
+      int32_storage_.reserve(num_rows);
+      break;
+    case kInt64Storage:
+      int64_storage_.reserve(num_rows);
+      break;
+    case kUint32Storage:
+      uint32_storage_.reserve(num_rows);
+      break;
+    case kUint64Storage:
+      uint64_storage_.reserve(num_rows);
+      break;
+    case kBoolStorage:
+      bool_storage_.reserve(num_rows);
+      break;
+    case kFloatStorage:
+      float_storage_.reserve(num_rows);
+      break;
+    case kDoubleStorage:
+      double_storage_.reserve(num_rows);
+      break;
+    case kStringStorage:
+      string_storage_.reserve(num_rows);
+      break;
+    case kValueStorage:
+      value_storage_.reserve(num_rows);
+      break;
+  }
+}
+
+ValueBatch::ValueBatch(const std::vector<const Type*>& column_types) {
+  columns_.reserve(column_types.size());
+  for (const Type* type : column_types) {
+    columns_.push_back(absl::make_unique<ColumnVector>(type));
+  }
+}
+
+void ValueBatch::AppendRow(absl::Span<const Value> row) {
+  DCHECK_EQ(row.size(), columns_.size());
+  for (int i = 0; i < num_columns(); ++i) {
+    columns_[i]->Append(row[i]);
+  }
+}
+
+void ValueBatch::Clear() {
+  for (const std::unique_ptr<ColumnVector>& column : columns_) {
+    column->Clear();
+  }
+}
+
+void ValueBatch::Reserve(int num_rows) {
+  for (const std::unique_ptr<ColumnVector>& column : columns_) {
+    column->Reserve(num_rows);
+  }
+}
+
+}  // namespace zetasql
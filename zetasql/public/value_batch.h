@@ -0,0 +1,168 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Columnar value containers for batched table scans.
+//
+// ColumnVector stores the cells of one column contiguously, with a separate
+// null bitmap.  ValueBatch groups one ColumnVector per column into a batch
+// of rows.  EvaluatorTableIterator implementations backed by columnar
+// storage can fill batches directly (see NextBatch() in
+// evaluator_table_iterator.h), which avoids constructing a Value per cell
+// for scan-heavy queries.
+
+#ifndef ZETASQL_PUBLIC_VALUE_BATCH_H_
+#define ZETASQL_PUBLIC_VALUE_BATCH_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include <cstdint>
+#include "absl/types/span.h"
+#include "zetasql/base/logging.h"
+
+namespace zetasql {
+
+// A column of values of a single type, stored contiguously.
+//
+// Fixed-width types (integers, bool, float, double, date, enum) and
+// strings/bytes are stored in flat typed arrays with a separate null bitmap,
+// so consumers can process them without touching Value at all.  All other
+// types (timestamps, civil time, numeric, arrays, structs, protos,
+// geography) fall back to a vector of Values; GetValue() works uniformly
+// for every type.
+//
+// Row indexes passed to accessors must be in [0, num_rows()).  The typed
+// accessors (int64_values() etc.) may only be called when the column's type
+// kind matches; entries at null rows contain unspecified placeholder values
+// and must be ignored.
+class ColumnVector {
+ public:
+  explicit ColumnVector(const Type* type);
+
+  ColumnVector(const ColumnVector&) = delete;
+  ColumnVector& operator=(const ColumnVector&) = delete;
+
+  const Type* type() const { return type_; }
+
+  int num_rows() const { return static_cast<int>(nulls_.size()); }
+
+  bool is_null(int row) const { return nulls_[row]; }
+
+  // Appends 'value', which must have exactly this column's type.  NULL
+  // values are recorded in the null bitmap.
+  void Append(const Value& value);
+
+  // Appends a NULL cell.
+  void AppendNull();
+
+  // Materializes the cell at 'row' as a Value.
+  Value GetValue(int row) const;
+
+  // Typed accessors for columns with flat storage.  Each may only be called
+  // when the column's type kind matches the accessor (DATE columns use
+  // int32_values(), ENUM columns use enum_values()).
+  absl::Span<const int32_t> int32_values() const { return int32_storage_; }
+  absl::Span<const int64_t> int64_values() const { return int64_storage_; }
+  absl::Span<const uint32_t> uint32_values() const { return uint32_storage_; }
+  absl::Span<const uint64_t> uint64_values() const { return uint64_storage_; }
+  absl::Span<const float> float_values() const { return float_storage_; }
+  absl::Span<const double> double_values() const { return double_storage_; }
+  // bool columns share the packed representation of the null bitmap.
+  const std::vector<bool>& bool_values() const { return bool_storage_; }
+  const std::vector<std::string>& string_values() const {
+    return string_storage_;
+  }
+  absl::Span<const int32_t> enum_values() const { return int32_storage_; }
+
+  // Removes all rows.  The column's type is unchanged.
+  void Clear();
+
+  // Reserves storage for 'num_rows' rows.
+  void Reserve(int num_rows);
+
+ private:
+  // Which physical array holds this column's non-null cells.
+  enum Representation {
+    kInt32Storage,   // TYPE_INT32, TYPE_DATE, TYPE_ENUM
+    kInt64Storage,   // TYPE_INT64
+    kUint32Storage,  // TYPE_UINT32
+    kUint64Storage,  // TYPE_UINT64
+    kBoolStorage,    // TYPE_BOOL
+    kFloatStorage,   // TYPE_FLOAT
+    kDoubleStorage,  // TYPE_DOUBLE
+    kStringStorage,  // TYPE_STRING, TYPE_BYTES
+    kValueStorage,   // everything else
+  };
+
+  static Representation RepresentationForType(const Type* type);
+
+  const Type* type_;  // not owned
+  Representation representation_;
+
+  // Packed null bitmap, one bit per row.
+  std::vector<bool> nulls_;
+
+  // Exactly one of these is used, per 'representation_'.  Null rows hold a
+  // default-constructed placeholder so row indexes stay aligned.
+  std::vector<int32_t> int32_storage_;
+  std::vector<int64_t> int64_storage_;
+  std::vector<uint32_t> uint32_storage_;
+  std::vector<uint64_t> uint64_storage_;
+  std::vector<bool> bool_storage_;
+  std::vector<float> float_storage_;
+  std::vector<double> double_storage_;
+  std::vector<std::string> string_storage_;
+  std::vector<Value> value_storage_;
+};
+
+// A batch of rows in columnar form: one ColumnVector per column, all with
+// the same number of rows.
+class ValueBatch {
+ public:
+  explicit ValueBatch(const std::vector<const Type*>& column_types);
+
+  ValueBatch(const ValueBatch&) = delete;
+  ValueBatch& operator=(const ValueBatch&) = delete;
+
+  int num_columns() const { return static_cast<int>(columns_.size()); }
+
+  int num_rows() const {
+    return columns_.empty() ? 0 : columns_[0]->num_rows();
+  }
+
+  const ColumnVector& column(int i) const { return *columns_[i]; }
+  ColumnVector* mutable_column(int i) { return columns_[i].get(); }
+
+  // Appends one row.  'row' must have num_columns() values whose types
+  // match the corresponding columns.
+  void AppendRow(absl::Span<const Value> row);
+
+  // Removes all rows.  The column types are unchanged.
+  void Clear();
+
+  // Reserves storage for 'num_rows' rows in every column.
+  void Reserve(int num_rows);
+
+ private:
+  std::vector<std::unique_ptr<ColumnVector>> columns_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_VALUE_BATCH_H_
@@ -0,0 +1,163 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/value_batch.h"
+
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(ColumnVectorTest, AppendAndGetWithNulls) {
+  ColumnVector column(types::Int64Type());
+  column.Append(Value::Int64(1));
+  column.AppendNull();
+  column.Append(Value::Int64(3));
+
+  EXPECT_EQ(3, column.num_rows());
+  EXPECT_FALSE(column.is_null(0));
+  EXPECT_TRUE(column.is_null(1));
+  EXPECT_FALSE(column.is_null(2));
+  EXPECT_EQ(Value::Int64(1), column.GetValue(0));
+  EXPECT_EQ(Value::Null(types::Int64Type()), column.GetValue(1));
+  EXPECT_EQ(Value::Int64(3), column.GetValue(2));
+
+  // Appending a NULL Value is the same as AppendNull().
+  column.Append(Value::Null(types::Int64Type()));
+  EXPECT_TRUE(column.is_null(3));
+}
+
+TEST(ColumnVectorTest, TypedSpanAccess) {
+  ColumnVector column(types::Int64Type());
+  column.Append(Value::Int64(10));
+  column.AppendNull();
+  column.Append(Value::Int64(30));
+
+  // The typed span stays aligned with row indexes; the null row holds a
+  // placeholder that callers must ignore.
+  EXPECT_THAT(column.int64_values(), ElementsAre(10, 0, 30));
+}
+
+TEST(ColumnVectorTest, StringStorage) {
+  ColumnVector column(types::StringType());
+  column.Append(Value::String("abc"));
+  column.Append(Value::String(""));
+  column.AppendNull();
+
+  EXPECT_THAT(column.string_values(), ElementsAre("abc", "", ""));
+  EXPECT_EQ(Value::String("abc"), column.GetValue(0));
+  EXPECT_EQ(Value::Null(types::StringType()), column.GetValue(2));
+}
+
+TEST(ColumnVectorTest, ValueFallbackForComplexTypes) {
+  const ArrayType* array_type = types::Int64ArrayType();
+  ColumnVector column(array_type);
+  const Value array = values::Int64Array({1, 2});
+  column.Append(array);
+  column.AppendNull();
+
+  EXPECT_EQ(array, column.GetValue(0));
+  EXPECT_EQ(Value::Null(array_type), column.GetValue(1));
+}
+
+TEST(ColumnVectorTest, ClearKeepsType) {
+  ColumnVector column(types::DoubleType());
+  column.Append(Value::Double(1.5));
+  column.Clear();
+  EXPECT_EQ(0, column.num_rows());
+  EXPECT_EQ(types::DoubleType(), column.type());
+  column.Append(Value::Double(2.5));
+  EXPECT_EQ(Value::Double(2.5), column.GetValue(0));
+}
+
+TEST(ValueBatchTest, AppendRow) {
+  ValueBatch batch({types::Int64Type(), types::StringType()});
+  batch.AppendRow({Value::Int64(1), Value::String("a")});
+  batch.AppendRow({Value::NullInt64(), Value::String("b")});
+
+  EXPECT_EQ(2, batch.num_columns());
+  EXPECT_EQ(2, batch.num_rows());
+  EXPECT_EQ(Value::Int64(1), batch.column(0).GetValue(0));
+  EXPECT_EQ(Value::NullInt64(), batch.column(0).GetValue(1));
+  EXPECT_EQ(Value::String("b"), batch.column(1).GetValue(1));
+
+  batch.Clear();
+  EXPECT_EQ(0, batch.num_rows());
+  EXPECT_EQ(2, batch.num_columns());
+}
+
+// Minimal row-oriented iterator used to exercise the default NextBatch()
+// implementation.
+class VectorIterator : public EvaluatorTableIterator {
+ public:
+  explicit VectorIterator(std::vector<std::vector<Value>> rows)
+      : rows_(std::move(rows)) {}
+
+  int NumColumns() const override { return 2; }
+  std::string GetColumnName(int i) const override { return ""; }
+  const Type* GetColumnType(int i) const override {
+    return i == 0 ? types::Int64Type() : types::StringType();
+  }
+  bool NextRow() override { return ++row_ < static_cast<int>(rows_.size()); }
+  const Value& GetValue(int i) const override { return rows_[row_][i]; }
+  zetasql_base::Status Status() const override {
+    return zetasql_base::OkStatus();
+  }
+  zetasql_base::Status Cancel() override { return zetasql_base::OkStatus(); }
+
+ private:
+  std::vector<std::vector<Value>> rows_;
+  int row_ = -1;
+};
+
+TEST(ValueBatchTest, DefaultNextBatch) {
+  std::vector<std::vector<Value>> rows;
+  for (int i = 0; i < 5; ++i) {
+    rows.push_back({Value::Int64(i), Value::String(std::string(1, 'a' + i))});
+  }
+  VectorIterator iter(rows);
+
+  ValueBatch batch({types::Int64Type(), types::StringType()});
+  ASSERT_TRUE(iter.NextBatch(/*max_rows=*/2, &batch));
+  EXPECT_EQ(2, batch.num_rows());
+  EXPECT_THAT(batch.column(0).int64_values(), ElementsAre(0, 1));
+
+  ASSERT_TRUE(iter.NextBatch(/*max_rows=*/2, &batch));
+  EXPECT_THAT(batch.column(0).int64_values(), ElementsAre(2, 3));
+
+  // The last batch is short, and the batch after it is empty.
+  ASSERT_TRUE(iter.NextBatch(/*max_rows=*/2, &batch));
+  EXPECT_EQ(1, batch.num_rows());
+  EXPECT_THAT(batch.column(1).string_values(), ElementsAre("e"));
+
+  EXPECT_FALSE(iter.NextBatch(/*max_rows=*/2, &batch));
+  ZETASQL_EXPECT_OK(iter.Status());
+}
+
+}  // namespace
+}  // namespace zetasql
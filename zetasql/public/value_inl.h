@@ -24,6 +24,7 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -55,24 +56,89 @@ class Value::TypedList : public zetasql_base::SimpleReferenceCounted {
   TypedList(const TypedList&) = delete;
   TypedList& operator=(const TypedList&) = delete;
 
+  // Returns a TypedList for <type>, reusing an instance from the
+  // thread-local free list when one is available.  Every array and struct
+  // Value allocates a TypedList, so recycling spent instances avoids an
+  // allocator round trip per Value on hot evaluation paths.
+  static TypedList* New(const Type* type) {
+    CHECK(type != nullptr);
+    std::vector<TypedList*>& free_list = ThreadLocalFreeList();
+    if (free_list.empty()) return new TypedList(type);
+    TypedList* list = free_list.back();
+    free_list.pop_back();
+    list->type_ = type;
+    return list;
+  }
+
   const Type* type() const { return type_; }
   std::vector<Value>& values() { return values_; }
+
+  // Cached hash of the contents, or 0 if not yet computed.  Value hashing
+  // fills this lazily (see Value::HashValueInternal); the contents are
+  // immutable once the owning Value is constructed, so concurrent
+  // computations race benignly to store the same result.
+  size_t cached_hash() const {
+    return cached_hash_.load(std::memory_order_relaxed);
+  }
+  void set_cached_hash(size_t hash) const {
+    cached_hash_.store(hash, std::memory_order_relaxed);
+  }
+
+  // Cached physical byte size of the contents, computed on first use so
+  // repeated memory accounting of the same value (e.g. per insertion into a
+  // TupleDataDeque) is O(1) instead of a full walk of the nested value.
+  // Like cached_hash(), the contents are immutable once the owning Value is
+  // constructed, so concurrent computations race benignly to store the same
+  // result.  The size is always nonzero, so 0 means "not yet computed".
   uint64_t physical_byte_size() const {
-    if (physical_byte_size_.has_value()) {
-      return physical_byte_size_.value();
+    uint64_t size = physical_byte_size_.load(std::memory_order_relaxed);
+    if (size != 0) {
+      return size;
     }
-    uint64_t size = sizeof(TypedList);
+    size = sizeof(TypedList);
     for (const Value& value : values_) {
       size += value.physical_byte_size();
     }
-    physical_byte_size_ = size;
+    physical_byte_size_.store(size, std::memory_order_relaxed);
     return size;
   }
 
+ protected:
+  // Pushes this instance onto the thread-local free list for reuse by New(),
+  // following the free-list pattern documented on SimpleReferenceCounted.
+  // Instances with large element buffers are deleted instead so the free
+  // list cannot pin unbounded memory.
+  void OnRefCountIsZero() const override {
+    TypedList* list = const_cast<TypedList*>(this);
+    std::vector<TypedList*>& free_list = ThreadLocalFreeList();
+    if (free_list.size() >= kMaxFreeListSize ||
+        list->values_.capacity() > kMaxRecycledElements) {
+      delete this;
+      return;
+    }
+    Ref();  // Resurrect; the free list holds the only reference.
+    list->values_.clear();
+    list->physical_byte_size_.store(0, std::memory_order_relaxed);
+    list->cached_hash_.store(0, std::memory_order_relaxed);
+    free_list.push_back(list);
+  }
+
  private:
+  // The free list is intentionally leaked: it is bounded in size, and
+  // leaking it avoids destruction-order problems with Values destroyed
+  // during thread or process shutdown.
+  static std::vector<TypedList*>& ThreadLocalFreeList() {
+    thread_local std::vector<TypedList*>* free_list =
+        new std::vector<TypedList*>;
+    return *free_list;
+  }
+  static constexpr size_t kMaxFreeListSize = 256;
+  static constexpr size_t kMaxRecycledElements = 64;
+
   const Type* type_;  // not owned
   std::vector<Value> values_;
-  mutable absl::optional<uint64_t> physical_byte_size_;
+  mutable std::atomic<uint64_t> physical_byte_size_{0};
+  mutable std::atomic<size_t> cached_hash_{0};
 };
 
 // -------------------------------------------------------
@@ -84,8 +150,20 @@ class Value::TypedList : public zetasql_base::SimpleReferenceCounted {
 class Value::ProtoRep : public zetasql_base::SimpleReferenceCounted {
  public:
   using Cord = std::string;
+
+  // Tag type selecting the borrowed constructor below.
+  struct Borrowed {};
+
   ProtoRep(const ProtoType* type, Cord value)
-      : type_(type), value_(std::move(value)) {
+      : type_(type), owned_value_(std::move(value)), value_(owned_value_) {
+    CHECK(type != nullptr);
+    CHECK(type->descriptor() != nullptr);
+  }
+
+  // References 'value' without copying it.  The caller guarantees that the
+  // referenced bytes outlive every Value sharing this rep.
+  ProtoRep(const ProtoType* type, absl::string_view value, Borrowed)
+      : type_(type), value_(value) {
     CHECK(type != nullptr);
     CHECK(type->descriptor() != nullptr);
   }
@@ -94,12 +172,17 @@ class Value::ProtoRep : public zetasql_base::SimpleReferenceCounted {
   ProtoRep& operator=(const ProtoRep&) = delete;
 
   const ProtoType* type() const { return type_; }
-  const Cord& value() const { return value_; }
-  uint64_t physical_byte_size() const { return sizeof(ProtoRep) + value_.size(); }
+  absl::string_view value() const { return value_; }
+  // Borrowed bytes are externally owned and not counted here.
+  uint64_t physical_byte_size() const {
+    return sizeof(ProtoRep) + owned_value_.size();
+  }
 
  private:
   const ProtoType* type_;
-  const Cord value_;
+  const Cord owned_value_;
+  // Points at <owned_value_>, or at borrowed caller-owned bytes.
+  const absl::string_view value_;
 };
 
 class Value::GeographyRef final : public zetasql_base::SimpleReferenceCounted {
@@ -147,16 +230,77 @@ class Value::StringRef : public zetasql_base::SimpleReferenceCounted {
   StringRef(const StringRef&) = delete;
   StringRef& operator=(const StringRef&) = delete;
 
+  // Returns a StringRef holding <value>, reusing an instance from the
+  // thread-local free list when one is available.  Heap profiles show
+  // per-Value StringRef allocations dominating evaluator runs, and most
+  // string cells are short, so recycling spent instances (whose internal
+  // std::string buffers already hold short strings inline) removes the
+  // allocation entirely for the common case.
+  static StringRef* New(std::string value) {
+    std::vector<StringRef*>& free_list = ThreadLocalFreeList();
+    if (free_list.empty()) return new StringRef(std::move(value));
+    StringRef* ref = free_list.back();
+    free_list.pop_back();
+    ref->value_ = std::move(value);
+    return ref;
+  }
+
   const std::string& value() const {
     return value_;
   }
 
+  // Returns a hash of the string contents, computed once and cached so that
+  // repeated hashing of the same value (e.g. a join or DISTINCT key) does
+  // not rescan the string.  The contents are immutable, so concurrent
+  // computations race benignly to store the same result.
+  size_t hash_code() const {
+    size_t hash = cached_hash_.load(std::memory_order_relaxed);
+    if (hash == 0) {
+      hash = absl::Hash<std::string>()(value_);
+      // Reserve 0 to mean "not yet computed".
+      if (hash == 0) hash = 1;
+      cached_hash_.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+  }
+
   uint64_t physical_byte_size() const {
     return sizeof(StringRef) + value_.size() * sizeof(char);
   }
 
+ protected:
+  // Pushes this instance onto the thread-local free list for reuse by New(),
+  // following the free-list pattern documented on SimpleReferenceCounted.
+  // Instances with large string buffers are deleted instead so the free
+  // list cannot pin unbounded memory.
+  void OnRefCountIsZero() const override {
+    StringRef* ref = const_cast<StringRef*>(this);
+    std::vector<StringRef*>& free_list = ThreadLocalFreeList();
+    if (free_list.size() >= kMaxFreeListSize ||
+        ref->value_.capacity() > kMaxRecycledCapacity) {
+      delete this;
+      return;
+    }
+    Ref();  // Resurrect; the free list holds the only reference.
+    ref->value_.clear();
+    ref->cached_hash_.store(0, std::memory_order_relaxed);
+    free_list.push_back(ref);
+  }
+
  private:
-  const std::string value_;
+  // The free list is intentionally leaked: it is bounded in size, and
+  // leaking it avoids destruction-order problems with Values destroyed
+  // during thread or process shutdown.
+  static std::vector<StringRef*>& ThreadLocalFreeList() {
+    thread_local std::vector<StringRef*>* free_list =
+        new std::vector<StringRef*>;
+    return *free_list;
+  }
+  static constexpr size_t kMaxFreeListSize = 256;
+  static constexpr size_t kMaxRecycledCapacity = 256;
+
+  std::string value_;
+  mutable std::atomic<size_t> cached_hash_{0};
 };
 
 // -------------------------------------------------------
@@ -266,7 +410,7 @@ inline Value::Value(double value)
 
 inline Value::Value(TypeKind type_kind, std::string value)
     : type_kind_(static_cast<int16_t>(type_kind)),
-      string_ptr_(new StringRef(std::move(value))) {
+      string_ptr_(StringRef::New(std::move(value))) {
   CHECK(type_kind == TYPE_STRING ||
         type_kind == TYPE_BYTES);
 }
@@ -487,12 +631,16 @@ inline int32_t Value::enum_value() const {
 }
 
 inline TimeValue Value::time_value() const {
-  return TimeValue::FromPacked32SecondsAndNanos(
+  // The encoding was validated when this Value was constructed, so skip the
+  // per-field validation on this (hot) decode path.
+  return TimeValue::FromPacked32SecondsAndNanosUnchecked(
       bit_field_32_value_, subsecond_nanos_);
 }
 
 inline DatetimeValue Value::datetime_value() const {
-  return DatetimeValue::FromPacked64SecondsAndNanos(
+  // The encoding was validated when this Value was constructed, so skip the
+  // per-field validation on this (hot) decode path.
+  return DatetimeValue::FromPacked64SecondsAndNanosUnchecked(
       bit_field_64_value_, subsecond_nanos_);
 }
 
@@ -578,7 +726,9 @@ H Value::HashValueInternal(H h) const {
     }
     case TYPE_STRING:
     case TYPE_BYTES: {
-      return H::combine(std::move(h), string_ptr_->value());
+      // Combines a content hash cached in the StringRef, so repeated
+      // hashing of the same value does not rescan the string.
+      return H::combine(std::move(h), string_ptr_->hash_code());
     }
     case TYPE_DATE: {
       return H::combine(std::move(h), int32_value_);
@@ -599,20 +749,38 @@ H Value::HashValueInternal(H h) const {
       return H::combine(std::move(h), enum_value_);
     }
     case TYPE_ARRAY: {
-      // We must hash arrays as if unordered to support hash_map and hash_set of
-      // values containing arrays with order_kind()=kIgnoresOrder.
-      // absl::Hash lacks support for unordered containers, so we create a
-      // cheapo solution of just adding the hashcodes.
-      absl::Hash<Value> element_hasher;
-      size_t combined_hash = 1;
-      for (int i = 0; i < num_elements(); i++) {
-        combined_hash += element_hasher(element(i));
+      // The combined element hash is cached in the TypedList so that
+      // repeated hashing of the same value (e.g. a join or DISTINCT key)
+      // does not re-walk the elements.
+      size_t combined_hash = list_ptr_->cached_hash();
+      if (combined_hash == 0) {
+        // We must hash arrays as if unordered to support hash_map and
+        // hash_set of values containing arrays with
+        // order_kind()=kIgnoresOrder.
+        // absl::Hash lacks support for unordered containers, so we create a
+        // cheapo solution of just adding the hashcodes.
+        absl::Hash<Value> element_hasher;
+        combined_hash = 1;
+        for (int i = 0; i < num_elements(); i++) {
+          combined_hash += element_hasher(element(i));
+        }
+        // Reserve 0 to mean "not yet computed".
+        if (combined_hash == 0) combined_hash = 1;
+        list_ptr_->set_cached_hash(combined_hash);
       }
       return H::combine(std::move(h), type_kind_, combined_hash);
     }
     case TYPE_STRUCT: {
-      // combine is an ordered combine, which is what we want.
-      return H::combine(std::move(h), type_kind_, fields());
+      // The field hash is cached in the TypedList, like for arrays above.
+      size_t fields_hash = list_ptr_->cached_hash();
+      if (fields_hash == 0) {
+        // absl::Hash over the field vector is an ordered combine, which is
+        // what we want.
+        fields_hash = absl::Hash<std::vector<Value>>()(fields());
+        if (fields_hash == 0) fields_hash = 1;
+        list_ptr_->set_cached_hash(fields_hash);
+      }
+      return H::combine(std::move(h), type_kind_, fields_hash);
     }
     case TYPE_PROTO: {
       // No efficient way to compute a hash on protobufs, so just let equals
@@ -735,6 +903,10 @@ inline Value Proto(const ProtoType* proto_type, const google::protobuf::Message&
   CHECK(msg.SerializeToString(&bytes));
   return Value::Proto(proto_type, std::move(bytes));
 }
+inline Value BorrowedProto(const ProtoType* proto_type,
+                           absl::string_view value) {
+  return Value::BorrowedProto(proto_type, value);
+}
 inline Value EmptyArray(const ArrayType* type) {
   return Value::Array(type, {});
 }
@@ -971,6 +971,22 @@ TEST_F(ValueTest, StructNotNull) {
   EXPECT_EQ(value.DebugString(true), same_value.DebugString(true));
 }
 
+TEST_F(ValueTest, StructFindFieldByNameCaseSensitivity) {
+  // FindFieldByName is an exact-name lookup even though the underlying
+  // StructType::FindField map is case insensitive.
+  Value value = Struct({{"abc", Value::Int64(1)}, {"def", Value::Int64(2)}});
+  EXPECT_EQ(1, value.FindFieldByName("abc").int64_value());
+  EXPECT_FALSE(value.FindFieldByName("ABC").is_valid());
+  EXPECT_FALSE(value.FindFieldByName("aBc").is_valid());
+
+  // Fields whose names differ only in case are ambiguous for the
+  // case-insensitive map, but each is still found by its exact name.
+  Value collision = Struct({{"a", Value::Int64(1)}, {"A", Value::Int64(2)}});
+  EXPECT_EQ(1, collision.FindFieldByName("a").int64_value());
+  EXPECT_EQ(2, collision.FindFieldByName("A").int64_value());
+  EXPECT_FALSE(collision.FindFieldByName("junk").is_valid());
+}
+
 TEST_F(ValueTest, StructNull) {
   Value value = TestGetSQL(Value::Null(MakeStructType({{"a", Int64Type()}})));
   EXPECT_TRUE(value.is_null());
@@ -1020,6 +1036,24 @@ TEST_F(ValueTest, ArrayNotNull) {
   EXPECT_EQ("[1, 2]", value_copy.DebugString());
 }
 
+TEST_F(ValueTest, CappedDebugString) {
+  std::vector<int64_t> elements;
+  for (int i = 1; i <= Value::kCappedDebugStringMaxElements + 2; ++i) {
+    elements.push_back(i);
+  }
+  const Value large_array = Int64Array(elements);
+  EXPECT_EQ("[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, ..., and 2 more]",
+            large_array.CappedDebugString());
+  // The full rendering remains available explicitly.
+  EXPECT_EQ("[1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]",
+            large_array.DebugString());
+  // Arrays at or below the cap render identically in both forms.
+  const Value small_array = Int64Array({1, 2});
+  EXPECT_EQ(small_array.DebugString(), small_array.CappedDebugString());
+  EXPECT_EQ(small_array.FullDebugString(),
+            small_array.CappedDebugString(true /* verbose */));
+}
+
 TEST_F(ValueTest, ArrayNull) {
   Value value = TestGetSQL(Value::Null(MakeArrayType(Int64Type())));
   EXPECT_TRUE(value.is_null());
@@ -1505,6 +1539,29 @@ TEST_F(ValueTest, ArrayLessThan) {
   }
 }
 
+TEST_F(ValueTest, BorrowedProto) {
+  const ProtoType* proto_type = GetTestProtoType();
+  zetasql_test::KitchenSinkPB k;
+  k.set_int64_key_1(1);
+  k.set_int64_key_2(2);
+  std::string bytes;
+  ASSERT_TRUE(k.SerializeToString(&bytes));
+
+  // The borrowed value references <bytes> without copying and is
+  // indistinguishable from a copying proto value.
+  const Value copied = Value::Proto(proto_type, bytes);
+  const Value borrowed = Value::BorrowedProto(proto_type, bytes);
+  EXPECT_TRUE(borrowed.type()->Equals(proto_type));
+  EXPECT_FALSE(borrowed.is_null());
+  EXPECT_EQ(bytes, borrowed.ToCord());
+  EXPECT_TRUE(borrowed.Equals(copied));
+  EXPECT_EQ(copied.ShortDebugString(), borrowed.ShortDebugString());
+
+  // Copies share the borrowed rep; none of them copy the bytes.
+  const Value borrowed_copy = borrowed;
+  EXPECT_EQ(bytes, borrowed_copy.ToCord());
+}
+
 TEST_F(ValueTest, Proto) {
   const ProtoType* proto_type = GetTestProtoType();
   zetasql_test::KitchenSinkPB k;
@@ -2211,6 +2268,96 @@ TEST_F(ValueTest, PhysicalByteSize) {
             Struct({"b", "d"}, {bool_value, date_value}).physical_byte_size());
 }
 
+TEST_F(ValueTest, ArrayValueBuilder) {
+  ArrayValueBuilder builder(types::Int64ArrayType());
+  builder.Reserve(3);
+  for (int i = 0; i < 3; ++i) {
+    builder.Add(Value::Int64(i));
+  }
+  EXPECT_EQ(3, builder.num_elements());
+  EXPECT_EQ(values::Int64Array({0, 1, 2}), builder.Build());
+  // The builder is empty and reusable after Build().
+  EXPECT_EQ(0, builder.num_elements());
+  builder.Add(Value::Int64(7));
+  EXPECT_EQ(values::Int64Array({7}), builder.Build());
+}
+
+TEST_F(ValueTest, StructValueBuilder) {
+  const StructType* struct_type = test_values::MakeStructType(
+      {{"a", types::Int64Type()}, {"b", types::StringType()}});
+  StructValueBuilder builder(struct_type);
+  builder.Add(Value::Int64(1));
+  builder.Add(Value::String("x"));
+  EXPECT_EQ(2, builder.num_fields());
+  EXPECT_EQ(Value::Struct(struct_type, {Value::Int64(1), Value::String("x")}),
+            builder.Build());
+}
+
+TEST_F(ValueTest, TakeAsVector) {
+  // With a single reference the element vector is moved out, not copied.
+  Value array = values::Int64Array({1, 2, 3});
+  const Value* element_data = array.elements().data();
+  std::vector<Value> taken = array.TakeAsVector();
+  EXPECT_FALSE(array.is_valid());
+  ASSERT_EQ(3, taken.size());
+  EXPECT_EQ(Value::Int64(1), taken[0]);
+  EXPECT_EQ(element_data, taken.data());
+
+  // With a second reference the elements are copied and the other Value is
+  // untouched.
+  Value array2 = values::Int64Array({4, 5});
+  const Value array2_copy = array2;
+  std::vector<Value> taken2 = array2.TakeAsVector();
+  EXPECT_FALSE(array2.is_valid());
+  ASSERT_EQ(2, taken2.size());
+  EXPECT_EQ(Value::Int64(5), taken2[1]);
+  EXPECT_EQ(values::Int64Array({4, 5}), array2_copy);
+}
+
+// The hash of strings, arrays and structs is cached inside the shared
+// representation after the first computation.  A cached hash must match the
+// hash computed fresh by an equal value, and must survive copies (which
+// share the representation).
+TEST_F(ValueTest, CachedHashCode) {
+  const Value array1 = values::Int64Array({1, 2, 3});
+  const size_t array_hash = array1.HashCode();
+  EXPECT_EQ(array_hash, array1.HashCode());
+  EXPECT_EQ(array_hash, values::Int64Array({1, 2, 3}).HashCode());
+  const Value array_copy = array1;
+  EXPECT_EQ(array_hash, array_copy.HashCode());
+  EXPECT_NE(array_hash, values::Int64Array({1, 2, 4}).HashCode());
+
+  const Value string1 = Value::String("some join key");
+  const size_t string_hash = string1.HashCode();
+  EXPECT_EQ(string_hash, string1.HashCode());
+  EXPECT_EQ(string_hash, Value::String("some join key").HashCode());
+  EXPECT_NE(string_hash, Value::String("another join key").HashCode());
+}
+
+// Exercises the thread-local free lists that recycle StringRef and TypedList
+// storage: values built from recycled storage must not observe a previous
+// value's contents, and outstanding references must survive recycling of
+// unrelated values.
+TEST_F(ValueTest, RecycledValueStorage) {
+  const Value survivor = Value::String("survivor");
+  for (int i = 0; i < 1000; ++i) {
+    const std::string expected = absl::StrCat("value_", i);
+    Value string_value = Value::String(expected);
+    Value string_copy = string_value;
+    // Destroying the original must not disturb the copy's shared storage.
+    string_value = Value::Invalid();
+    EXPECT_EQ(expected, string_copy.string_value());
+
+    Value array_value = values::Int64Array({i, i + 1});
+    Value array_copy = array_value;
+    array_value = Value::Invalid();
+    EXPECT_EQ(2, array_copy.num_elements());
+    EXPECT_EQ(i, array_copy.element(0).int64_value());
+    EXPECT_EQ(i + 1, array_copy.element(1).int64_value());
+  }
+  EXPECT_EQ("survivor", survivor.string_value());
+}
+
 // Roundtrips Value through ValueProto and back.
 static void SerializeDeserialize(const Value& value) {
   ValueProto value_proto;
@@ -16,6 +16,10 @@
 
 // This file contains the code for evaluating aggregate functions.
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -36,6 +40,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
+#include "absl/hash/hash.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -262,9 +267,9 @@ class OrderByAccumulator : public IntermediateAggregateAccumulator {
                   bool* stop_accumulation, ::zetasql_base::Status* status) override {
     *stop_accumulation = false;
 
-    auto input = absl::make_unique<TupleData>(input_row);
-    input->AddSlots(1);
-    input->mutable_slot(input->num_slots() - 1)->SetValue(value);
+    TupleData input = input_row;
+    input.AddSlots(1);
+    input.mutable_slot(input.num_slots() - 1)->SetValue(value);
     return inputs_.PushBack(std::move(input), status);
   }
 
@@ -275,20 +280,25 @@ class OrderByAccumulator : public IntermediateAggregateAccumulator {
         TupleComparator::Create(keys_, slots_for_keys_, params_, context_));
     inputs_.Sort(*tuple_comparator, /*use_stable_sort=*/false);
 
-    const bool inputs_in_defined_order = tuple_comparator->IsUniquelyOrdered(
-        inputs_.GetTuplePtrs(), slots_for_values_);
+    // The result of IsUniquelyOrdered() only feeds the determinism bit, so
+    // conservatively treat the inputs as unordered when that bookkeeping is
+    // disabled instead of doing a pass over all of them.
+    const bool inputs_in_defined_order =
+        !context_->options().skip_determinism_tracking &&
+        tuple_comparator->IsUniquelyOrdered(inputs_.GetTuplePtrs(),
+                                            slots_for_values_);
 
     ZETASQL_RETURN_IF_ERROR(accumulator_->Reset());
 
     bool stop_accumulation;
     ::zetasql_base::Status status;
     while (!inputs_.IsEmpty()) {
-      std::unique_ptr<TupleData> input_row = inputs_.PopFront();
-      ZETASQL_RET_CHECK(!input_row->slots().empty());
-      const Value value = input_row->slots().back().value();
-      input_row->RemoveSlots(1);
+      TupleData input_row = inputs_.PopFront();
+      ZETASQL_RET_CHECK(!input_row.slots().empty());
+      const Value value = input_row.slots().back().value();
+      input_row.RemoveSlots(1);
 
-      if (!accumulator_->Accumulate(*input_row, value, &stop_accumulation,
+      if (!accumulator_->Accumulate(input_row, value, &stop_accumulation,
                                     &status)) {
         return status;
       }
@@ -383,17 +393,37 @@ class TopNAccumulator : public IntermediateAggregateAccumulator {
   std::unique_ptr<IntermediateAggregateAccumulator> accumulator_;
 };
 
-// Accumulator that only passes through distinct values.
+// Accumulator that only passes through distinct values. The values are
+// tracked either in a private hash set or in a DistinctValueTable shared by
+// all the groups of an aggregation (see AggregateArg::CreateAccumulator).
 class DistinctAccumulator : public IntermediateAggregateAccumulator {
  public:
+  // Creates an accumulator that owns its set of distinct values.
   DistinctAccumulator(
       std::unique_ptr<IntermediateAggregateAccumulator> accumulator,
       EvaluationContext* context)
-      : distinct_values_(context->memory_accountant()),
+      : owned_distinct_values_(
+            absl::make_unique<ValueHashSet>(context->memory_accountant())),
+        accumulator_(std::move(accumulator)) {}
+
+  // Creates an accumulator that tracks its distinct values in
+  // 'shared_distinct_values' (which must outlive this object) under a freshly
+  // allocated group id.
+  DistinctAccumulator(
+      DistinctValueTable* shared_distinct_values,
+      std::unique_ptr<IntermediateAggregateAccumulator> accumulator)
+      : shared_distinct_values_(shared_distinct_values),
+        group_id_(shared_distinct_values->AllocateGroupId()),
         accumulator_(std::move(accumulator)) {}
 
   ::zetasql_base::Status Reset() override {
-    distinct_values_.Clear();
+    if (shared_distinct_values_ != nullptr) {
+      // The entries for the old group id become unreachable; their bytes are
+      // returned to the accountant when the table is cleared.
+      group_id_ = shared_distinct_values_->AllocateGroupId();
+    } else {
+      owned_distinct_values_->Clear();
+    }
     return accumulator_->Reset();
   }
 
@@ -405,8 +435,15 @@ class DistinctAccumulator : public IntermediateAggregateAccumulator {
     *stop_accumulation = false;
 
     bool distinct;
-    if (!distinct_values_.Insert(value, &distinct, status)) {
-      return false;
+    if (shared_distinct_values_ != nullptr) {
+      if (!shared_distinct_values_->Insert(group_id_, value, &distinct,
+                                           status)) {
+        return false;
+      }
+    } else {
+      if (!owned_distinct_values_->Insert(value, &distinct, status)) {
+        return false;
+      }
     }
 
     if (distinct) {
@@ -424,7 +461,11 @@ class DistinctAccumulator : public IntermediateAggregateAccumulator {
   }
 
  private:
-  ValueHashSet distinct_values_;
+  // Exactly one of 'owned_distinct_values_' and 'shared_distinct_values_' is
+  // set.
+  std::unique_ptr<ValueHashSet> owned_distinct_values_;
+  DistinctValueTable* shared_distinct_values_ = nullptr;
+  int64_t group_id_ = -1;
   std::unique_ptr<IntermediateAggregateAccumulator> accumulator_;
 };
 
@@ -711,7 +752,9 @@ static zetasql_base::Status PopulateSlotsForKeysAndValues(
 
 ::zetasql_base::StatusOr<std::unique_ptr<AggregateArgAccumulator>>
 AggregateArg::CreateAccumulator(absl::Span<const TupleData* const> params,
-                                EvaluationContext* context) const {
+                                EvaluationContext* context,
+                                DistinctValueTable* shared_distinct_values)
+    const {
   // Build the underlying AggregateAccumulator.
   std::vector<Value> args(parameter_list_size());
   for (int i = 0; i < parameter_list_size(); ++i) {
@@ -780,8 +823,17 @@ AggregateArg::CreateAccumulator(absl::Span<const TupleData* const> params,
 
   // DISTINCT support.
   if (distinct()) {
-    accumulator =
-        absl::make_unique<DistinctAccumulator>(std::move(accumulator), context);
+    // A HAVING MAX/MIN modifier resets the accumulators below it whenever a
+    // new extremal value arrives, which would strand entries in a shared
+    // table until it is cleared, so those aggregations keep a private set.
+    if (shared_distinct_values != nullptr &&
+        having_modifier_kind() == kHavingNone) {
+      accumulator = absl::make_unique<DistinctAccumulator>(
+          shared_distinct_values, std::move(accumulator));
+    } else {
+      accumulator = absl::make_unique<DistinctAccumulator>(
+          std::move(accumulator), context);
+    }
   }
 
   // Support for aggregation functions that ignore NULLs.
@@ -836,6 +888,293 @@ zetasql_base::StatusOr<Value> AggregateArg::EvalAgg(
   return status_or_result.ValueOrDie();
 }
 
+// Returns true if both the starting and the ending tuple indexes of the
+// non-empty windows in 'windows' are non-decreasing. ROWS-based and
+// RANGE-based window frames always produce such sequences, but
+// EvalAggOverWindows() verifies this instead of assuming it so that it can
+// never return wrong results for an unexpected window sequence.
+static bool WindowsAreSliding(absl::Span<const AnalyticWindow> windows) {
+  int prev_start_tuple_id = 0;
+  int prev_end_tuple_id = 0;
+  for (const AnalyticWindow& window : windows) {
+    if (window.num_tuples == 0) continue;
+    const int end_tuple_id = window.start_tuple_id + window.num_tuples;
+    if (window.start_tuple_id < prev_start_tuple_id ||
+        end_tuple_id < prev_end_tuple_id) {
+      return false;
+    }
+    prev_start_tuple_id = window.start_tuple_id;
+    prev_end_tuple_id = end_tuple_id;
+  }
+  return true;
+}
+
+// Returns true if MIN and MAX aggregates over values of 'kind' can be
+// evaluated incrementally by EvalAggOverWindows(). Requires that
+// Value::LessThan() define the same ordering that BuiltinAggregateAccumulator
+// uses for 'kind' (NaNs are special-cased in IsBetterExtremalValue() below).
+// Arrays are excluded because two arrays can compare as equal without being
+// interchangeable as aggregation results.
+static bool SupportsIncrementalMinMax(TypeKind kind) {
+  switch (kind) {
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_UINT32:
+    case TYPE_UINT64:
+    case TYPE_BOOL:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_STRING:
+    case TYPE_BYTES:
+    case TYPE_DATE:
+    case TYPE_TIMESTAMP:
+    case TYPE_TIME:
+    case TYPE_DATETIME:
+    case TYPE_NUMERIC:
+    case TYPE_ENUM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if the non-NULL value 'a' beats the non-NULL value 'b' as the
+// result of a MIN or MAX aggregation. Mirrors BuiltinAggregateAccumulator,
+// which makes NaN the extremal value for both MIN and MAX and keeps the first
+// of two values that compare as equal.
+static bool IsBetterExtremalValue(const Value& a, const Value& b, bool is_max) {
+  if (a.type_kind() == TYPE_DOUBLE || a.type_kind() == TYPE_FLOAT) {
+    if (std::isnan(b.ToDouble())) return false;
+    if (std::isnan(a.ToDouble())) return true;
+  }
+  return is_max ? b.LessThan(a) : a.LessThan(b);
+}
+
+::zetasql_base::Status AggregateArg::EvalAggOverWindows(
+    absl::Span<const TupleData* const> partition,
+    absl::Span<const AnalyticWindow> windows,
+    absl::Span<const TupleData* const> params, EvaluationContext* context,
+    std::vector<Value>* results) const {
+  results->reserve(results->size() + windows.size());
+
+  // Determine whether this aggregation can be evaluated incrementally. The
+  // incremental implementations below reproduce the behavior of
+  // BuiltinAggregateAccumulator exactly, so any modifier that changes the
+  // accumulator stack (or SAFE mode, which converts per-window errors to
+  // NULLs) disqualifies the aggregation.
+  const BuiltinAggregateFunction* builtin_function =
+      aggregate_function()->function()->AsBuiltinAggregateFunction();
+  bool evaluate_incrementally =
+      builtin_function != nullptr && distinct() == kAll &&
+      having_expr() == nullptr && order_by_keys().empty() &&
+      limit() == nullptr && builtin_function->ignores_null() &&
+      error_mode() == ResolvedFunctionCallBase::DEFAULT_ERROR_MODE;
+  if (evaluate_incrementally) {
+    switch (builtin_function->kind()) {
+      case FunctionKind::kCount:
+        evaluate_incrementally = (num_input_fields() <= 1);
+        break;
+      case FunctionKind::kSum:
+        // The accumulator computes INT64 and UINT64 sums in 128 bits, which
+        // prefix sums can reproduce exactly. Other SUM types (and AVG) use
+        // accumulation methods whose results depend on the order and grouping
+        // of the additions, so they take the non-incremental path.
+        evaluate_incrementally =
+            num_input_fields() == 1 && (input_type()->kind() == TYPE_INT64 ||
+                                        input_type()->kind() == TYPE_UINT64);
+        break;
+      case FunctionKind::kMin:
+      case FunctionKind::kMax:
+        evaluate_incrementally =
+            num_input_fields() == 1 &&
+            SupportsIncrementalMinMax(input_type()->kind());
+        break;
+      default:
+        evaluate_incrementally = false;
+        break;
+    }
+  }
+  if (evaluate_incrementally) {
+    evaluate_incrementally = WindowsAreSliding(windows);
+  }
+
+  if (!evaluate_incrementally) {
+    for (const AnalyticWindow& window : windows) {
+      ZETASQL_ASSIGN_OR_RETURN(
+          Value value,
+          EvalAgg(partition.subspan(window.start_tuple_id, window.num_tuples),
+                  params, context));
+      results->push_back(std::move(value));
+    }
+    return ::zetasql_base::OkStatus();
+  }
+
+  // Checks the same output size limit as
+  // BuiltinAggregateAccumulator::GetFinalResult() before emitting a result.
+  const int64_t max_value_byte_size = context->options().max_value_byte_size;
+  const auto add_result =
+      [results, max_value_byte_size](Value value) -> ::zetasql_base::Status {
+    if (value.physical_byte_size() > max_value_byte_size) {
+      return ::zetasql_base::OutOfRangeErrorBuilder()
+             << "Aggregate values are limited to " << max_value_byte_size
+             << " bytes";
+    }
+    results->push_back(std::move(value));
+    return ::zetasql_base::OkStatus();
+  };
+
+  // Evaluate the argument once for every tuple covered by at least one
+  // window. Tuples outside every window are skipped (their values stay
+  // invalid) so that an argument expression that would fail on such a tuple
+  // does not return an error that the non-incremental path would not. Then
+  // compute prefix counts of non-NULL argument values so that the number of
+  // values aggregated by any window can be determined in constant time.
+  const int num_tuples = partition.size();
+  std::vector<Value> arg_values;
+  std::vector<int64_t> prefix_counts(num_tuples + 1, 0);
+  if (num_input_fields() == 1) {
+    arg_values.resize(num_tuples);
+    std::vector<const TupleData*> params_and_tuple(params.begin(),
+                                                   params.end());
+    params_and_tuple.push_back(nullptr);
+    int next_eval_tuple_id = 0;
+    for (const AnalyticWindow& window : windows) {
+      next_eval_tuple_id =
+          std::max(next_eval_tuple_id, window.start_tuple_id);
+      const int end_tuple_id = window.start_tuple_id + window.num_tuples;
+      for (; next_eval_tuple_id < end_tuple_id; ++next_eval_tuple_id) {
+        params_and_tuple.back() = partition[next_eval_tuple_id];
+        std::shared_ptr<TupleSlot::SharedProtoState> shared_state;
+        VirtualTupleSlot slot(&arg_values[next_eval_tuple_id], &shared_state);
+        ::zetasql_base::Status status;
+        if (!input_field(0)->Eval(params_and_tuple, context, &slot, &status)) {
+          return status;
+        }
+      }
+    }
+    for (int i = 0; i < num_tuples; ++i) {
+      prefix_counts[i + 1] =
+          prefix_counts[i] +
+          (arg_values[i].is_valid() && !arg_values[i].is_null() ? 1 : 0);
+    }
+  } else {
+    // COUNT(*) counts every tuple.
+    for (int i = 0; i < num_tuples; ++i) {
+      prefix_counts[i + 1] = i + 1;
+    }
+  }
+
+  switch (builtin_function->kind()) {
+    case FunctionKind::kCount: {
+      for (const AnalyticWindow& window : windows) {
+        ZETASQL_RETURN_IF_ERROR(add_result(Value::Int64(
+            prefix_counts[window.start_tuple_id + window.num_tuples] -
+            prefix_counts[window.start_tuple_id])));
+      }
+      break;
+    }
+    case FunctionKind::kSum: {
+      // 128-bit prefix sums are exact, so the 128-bit sum for a window (which
+      // is all that BuiltinAggregateAccumulator checks for overflow) is the
+      // difference of two prefix sums. NULL values contribute zero, and a
+      // window with no non-NULL values returns NULL.
+      if (input_type()->kind() == TYPE_INT64) {
+        std::vector<__int128> prefix_sums(num_tuples + 1, 0);
+        for (int i = 0; i < num_tuples; ++i) {
+          prefix_sums[i + 1] = prefix_sums[i];
+          if (prefix_counts[i + 1] != prefix_counts[i]) {
+            prefix_sums[i + 1] += arg_values[i].int64_value();
+          }
+        }
+        for (const AnalyticWindow& window : windows) {
+          const int end_tuple_id = window.start_tuple_id + window.num_tuples;
+          if (prefix_counts[end_tuple_id] ==
+              prefix_counts[window.start_tuple_id]) {
+            ZETASQL_RETURN_IF_ERROR(add_result(Value::NullInt64()));
+            continue;
+          }
+          const __int128 sum =
+              prefix_sums[end_tuple_id] - prefix_sums[window.start_tuple_id];
+          if (sum > std::numeric_limits<int64_t>::max() ||
+              sum < std::numeric_limits<int64_t>::min()) {
+            return ::zetasql_base::OutOfRangeErrorBuilder() << "int64 overflow";
+          }
+          ZETASQL_RETURN_IF_ERROR(add_result(Value::Int64(static_cast<int64_t>(sum))));
+        }
+      } else {
+        std::vector<unsigned __int128> prefix_sums(num_tuples + 1, 0);
+        for (int i = 0; i < num_tuples; ++i) {
+          prefix_sums[i + 1] = prefix_sums[i];
+          if (prefix_counts[i + 1] != prefix_counts[i]) {
+            prefix_sums[i + 1] += arg_values[i].uint64_value();
+          }
+        }
+        for (const AnalyticWindow& window : windows) {
+          const int end_tuple_id = window.start_tuple_id + window.num_tuples;
+          if (prefix_counts[end_tuple_id] ==
+              prefix_counts[window.start_tuple_id]) {
+            ZETASQL_RETURN_IF_ERROR(add_result(Value::NullUint64()));
+            continue;
+          }
+          const unsigned __int128 sum =
+              prefix_sums[end_tuple_id] - prefix_sums[window.start_tuple_id];
+          if (sum > std::numeric_limits<uint64_t>::max()) {
+            return ::zetasql_base::OutOfRangeErrorBuilder()
+                   << "uint64 overflow";
+          }
+          ZETASQL_RETURN_IF_ERROR(
+              add_result(Value::Uint64(static_cast<uint64_t>(sum))));
+        }
+      }
+      break;
+    }
+    case FunctionKind::kMin:
+    case FunctionKind::kMax: {
+      // Maintain the classic monotonic queue of candidate extremal values:
+      // indexes of tuples with non-NULL argument values, ordered such that
+      // each value beats all of the values behind it. A tuple is popped from
+      // the back when a better value arrives and from the front when the
+      // window start moves past it, so each tuple is pushed and popped at most
+      // once and the total cost is linear in the partition size.
+      const bool is_max = (builtin_function->kind() == FunctionKind::kMax);
+      std::deque<int> candidates;
+      int next_tuple_id = 0;
+      for (const AnalyticWindow& window : windows) {
+        const int end_tuple_id = window.start_tuple_id + window.num_tuples;
+        if (prefix_counts[end_tuple_id] ==
+            prefix_counts[window.start_tuple_id]) {
+          ZETASQL_RETURN_IF_ERROR(add_result(Value::Null(type())));
+          continue;
+        }
+        next_tuple_id = std::max(next_tuple_id, window.start_tuple_id);
+        for (; next_tuple_id < end_tuple_id; ++next_tuple_id) {
+          if (arg_values[next_tuple_id].is_null()) continue;
+          while (!candidates.empty() &&
+                 IsBetterExtremalValue(arg_values[next_tuple_id],
+                                       arg_values[candidates.back()],
+                                       is_max)) {
+            candidates.pop_back();
+          }
+          candidates.push_back(next_tuple_id);
+        }
+        while (!candidates.empty() &&
+               candidates.front() < window.start_tuple_id) {
+          candidates.pop_front();
+        }
+        ZETASQL_RET_CHECK(!candidates.empty());
+        ZETASQL_RETURN_IF_ERROR(add_result(arg_values[candidates.front()]));
+      }
+      break;
+    }
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected function kind in EvalAggOverWindows: "
+                       << BuiltinFunctionCatalog::GetDebugNameByKind(
+                              builtin_function->kind());
+  }
+
+  return ::zetasql_base::OkStatus();
+}
+
 std::string AggregateArg::DebugInternal(const std::string& indent,
                                         bool verbose) const {
   std::string result;
@@ -1025,7 +1364,7 @@ class AggregateTupleIterator : public TupleIterator {
     ++num_next_calls_;
 
     current_ = tuples_->PopFront();
-    return current_.get();
+    return &current_;
   }
 
   zetasql_base::Status Status() const override { return status_; }
@@ -1043,7 +1382,8 @@ class AggregateTupleIterator : public TupleIterator {
   // We store a TupleIterator instead of the debug std::string to avoid computing the
   // debug std::string unnecessarily.
   const std::unique_ptr<TupleIterator> input_iter_for_debug_string_;
-  std::unique_ptr<TupleData> current_;
+  // The last tuple returned by Next().
+  TupleData current_;
   EvaluationContext* context_;
   zetasql_base::Status status_;
   int64_t num_next_calls_ = 0;
@@ -1120,122 +1460,325 @@ class GroupValue {
       std::unique_ptr<TupleIterator> input_iter,
       input()->CreateIterator(params, /*num_extra_slots=*/0, context));
 
+  // One flat table dedups the (group, value) pairs of all DISTINCT
+  // aggregations instead of each group maintaining its own hash set.
+  // Declared before 'group_map' so that it outlives the accumulators that
+  // reference it.
+  DistinctValueTable shared_distinct_values(context->memory_accountant());
+
   // The key is owned by the GroupValue.
   absl::flat_hash_map<TupleDataPtr, std::unique_ptr<GroupValue>> group_map;
 
+  // Reused for every input row so that probing the map does not allocate; a
+  // heap-allocated copy of the key is only made when the row starts a new
+  // group.
+  TupleData probe_key_data(keys().size());
+
+  // Two-phase spilling state (see
+  // EvaluationOptions::allow_aggregation_spill_to_disk). When creating a new
+  // group exceeds the memory budget, the rows of groups that do not fit are
+  // written to one of 'kNumSpillPartitions' temporary files chosen by a radix
+  // of the grouping-key hash, and each file is later aggregated as its own
+  // (smaller) input in a subsequent pass. A partition whose groups still do
+  // not fit re-partitions by the next radix of the hash; once the radixes are
+  // exhausted the memory error is returned. Spilled records are the input
+  // row's slots followed by the evaluated key slots, so re-aggregating a
+  // partition does not re-evaluate the key expressions.
+  constexpr int kRadixBitsPerLevel = 4;
+  constexpr int kNumSpillPartitions = 1 << kRadixBitsPerLevel;
+  constexpr int kMaxRadixLevels =
+      std::numeric_limits<size_t>::digits / kRadixBitsPerLevel;
+  const bool allow_spill =
+      context->options().allow_aggregation_spill_to_disk && !keys().empty();
+  struct SpilledPartition {
+    std::unique_ptr<TupleSpillFile> file;
+    int radix_level = 0;
+  };
+  std::vector<std::unique_ptr<SpilledPartition>> pending_partitions;
+  TupleDataPool spill_pool;
+
+  auto tuples = absl::make_unique<TupleDataDeque>(context->memory_accountant());
+
+  // Compares output tuples by key. Used to sort 'tuples' at the end (see the
+  // TODO below) and to order any spilled output runs.
+  std::vector<int> slots_for_keys;
+  slots_for_keys.reserve(keys().size());
+  for (int i = 0; i < keys().size(); ++i) {
+    slots_for_keys.push_back(i);
+  }
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<TupleComparator> tuple_comparator,
+      TupleComparator::Create(keys(), slots_for_keys, params, context));
+
+  // Sorted runs of finished output tuples, spilled to disk when 'tuples'
+  // itself exceeds the memory budget. Every group is completed by exactly one
+  // pass, so it occurs in exactly one run (or in the in-memory remainder) and
+  // merging the sorted runs yields the sorted output.
+  std::vector<std::unique_ptr<TupleSpillFile>> output_runs;
+  const auto spill_output_run = [&]() -> zetasql_base::Status {
+    tuples->Sort(*tuple_comparator, /*use_stable_sort=*/false);
+    std::vector<const Type*> slot_types;
+    slot_types.reserve(keys().size() + aggregators().size());
+    for (const KeyArg* key : keys()) {
+      slot_types.push_back(key->type());
+    }
+    for (const AggregateArg* aggregator : aggregators()) {
+      slot_types.push_back(aggregator->type());
+    }
+    auto run = absl::make_unique<TupleSpillFile>(std::move(slot_types));
+    while (!tuples->IsEmpty()) {
+      ZETASQL_RETURN_IF_ERROR(run->WriteTuple(tuples->PopFront()));
+    }
+    output_runs.push_back(std::move(run));
+    return zetasql_base::OkStatus();
+  };
+
   ::zetasql_base::Status status;
+  // The first pass aggregates the input itself; each subsequent pass
+  // aggregates one spilled partition. Every pass appends the output tuples of
+  // the groups it completed to 'tuples'.
+  std::unique_ptr<SpilledPartition> current_partition;
   while (true) {
-    const TupleData* next_input = input_iter->Next();
-    if (next_input == nullptr) {
-      ZETASQL_RETURN_IF_ERROR(input_iter->Status());
-      break;
+    const int radix_level =
+        current_partition == nullptr ? 0 : current_partition->radix_level;
+    if (current_partition != nullptr) {
+      ZETASQL_RETURN_IF_ERROR(current_partition->file->StartRead());
     }
 
-    // Determine the key to 'group_to_accumulator_map'.
-    const std::vector<const TupleData*> params_and_input_tuple =
-        ConcatSpans(params, {next_input});
-    auto key_data = absl::make_unique<TupleData>(keys().size());
-    for (int i = 0; i < keys().size(); ++i) {
-      TupleSlot* slot = key_data->mutable_slot(i);
-      const KeyArg* key = keys()[i];
-      ::zetasql_base::Status status;
-      if (!key->value_expr()->EvalSimple(params_and_input_tuple, context, slot,
-                                         &status)) {
-        return status;
+    // Spill files opened by this pass, created on first use. 'spilling' is
+    // sticky within a pass: once one group fails to fit, every subsequent new
+    // group spills instead of retrying the accountant row by row.
+    std::vector<std::unique_ptr<TupleSpillFile>> spill_files(
+        kNumSpillPartitions);
+    bool spilling = false;
+
+    // Returns the record to spill for 'row': the row itself for partition
+    // passes (its trailing slots already hold the keys), or the row with the
+    // evaluated key slots appended for the first pass.
+    const auto make_spill_record = [&](const TupleData& row) -> TupleData {
+      if (current_partition != nullptr) return row;
+      TupleData record(row.num_slots() + static_cast<int>(keys().size()));
+      for (int i = 0; i < row.num_slots(); ++i) {
+        record.mutable_slot(i)->SetValue(row.slot(i).value());
       }
-    }
+      for (int i = 0; i < keys().size(); ++i) {
+        record.mutable_slot(row.num_slots() + i)
+            ->SetValue(probe_key_data.slot(i).value());
+      }
+      return record;
+    };
+
+    // Writes the spill record for the current row (whose key is in
+    // 'probe_key_data') to its partition file.
+    const auto spill_row = [&](const TupleData& record) -> zetasql_base::Status {
+      const size_t hash =
+          absl::Hash<TupleDataPtr>()(TupleDataPtr(&probe_key_data));
+      const int partition =
+          (hash >> (radix_level * kRadixBitsPerLevel)) &
+          (kNumSpillPartitions - 1);
+      std::unique_ptr<TupleSpillFile>& file = spill_files[partition];
+      if (file == nullptr) {
+        std::vector<const Type*> slot_types;
+        slot_types.reserve(record.num_slots());
+        for (int i = 0; i < record.num_slots(); ++i) {
+          ZETASQL_RET_CHECK(record.slot(i).value().is_valid());
+          slot_types.push_back(record.slot(i).value().type());
+        }
+        file = absl::make_unique<TupleSpillFile>(std::move(slot_types));
+      }
+      return file->WriteTuple(record);
+    };
+
+    std::unique_ptr<TupleData> partition_row;
+    while (true) {
+      const TupleData* next_input = nullptr;
+      if (current_partition == nullptr) {
+        next_input = input_iter->Next();
+        if (next_input == nullptr) {
+          ZETASQL_RETURN_IF_ERROR(input_iter->Status());
+          break;
+        }
 
-    // Look up the value in 'group_to_accumulator_map', initializing a new one
-    // if necessary.
-    AccumulatorList* accumulators = nullptr;
-    std::unique_ptr<GroupValue>* found_group_value =
-        zetasql_base::FindOrNull(group_map, TupleDataPtr(key_data.get()));
-    if (found_group_value == nullptr) {
-      // Create the new GroupValue.
-      const TupleData* key_data_ptr = key_data.get();
-      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<GroupValue> inserted_group_value,
-                       GroupValue::Create(std::move(key_data),
-                                          context->memory_accountant()));
-
-      // Initialize the accumulators.
-      accumulators = inserted_group_value->mutable_accumulator_list();
-      accumulators->reserve(aggregators().size());
-      for (const AggregateArg* aggregator : aggregators()) {
-        std::pair<std::unique_ptr<AggregateArgAccumulator>, bool>
-            accumulator_and_stop_bit;
-        ZETASQL_ASSIGN_OR_RETURN(accumulator_and_stop_bit.first,
-                         aggregator->CreateAccumulator(params, context));
-        accumulators->push_back(std::move(accumulator_and_stop_bit));
+        // Determine the key to 'group_to_accumulator_map'.
+        const std::vector<const TupleData*> params_and_input_tuple =
+            ConcatSpans(params, {next_input});
+        for (int i = 0; i < keys().size(); ++i) {
+          TupleSlot* slot = probe_key_data.mutable_slot(i);
+          const KeyArg* key = keys()[i];
+          ::zetasql_base::Status status;
+          if (!key->value_expr()->EvalSimple(params_and_input_tuple, context,
+                                             slot, &status)) {
+            return status;
+          }
+        }
+      } else {
+        if (partition_row != nullptr) {
+          spill_pool.Return(std::move(partition_row));
+        }
+        ZETASQL_ASSIGN_OR_RETURN(
+            const bool has_row,
+            current_partition->file->ReadTuple(/*num_extra_slots=*/0,
+                                               &spill_pool, &partition_row));
+        if (!has_row) break;
+        next_input = partition_row.get();
+
+        // Spilled records carry the evaluated keys in their trailing slots.
+        // The extra slots are ignored by the accumulators, which only
+        // reference slots of the input schema.
+        const int first_key_slot =
+            next_input->num_slots() - static_cast<int>(keys().size());
+        for (int i = 0; i < keys().size(); ++i) {
+          probe_key_data.mutable_slot(i)->SetValue(
+              next_input->slot(first_key_slot + i).value());
+        }
       }
 
-      // Insert the new GroupValue.
-      ZETASQL_RET_CHECK(group_map
-                    .emplace(TupleDataPtr(key_data_ptr),
-                             std::move(inserted_group_value))
-                    .second);
-    } else {
-      accumulators = (*found_group_value)->mutable_accumulator_list();
-      key_data.reset();
-    }
+      // Look up the value in 'group_to_accumulator_map', initializing a new one
+      // if necessary.
+      AccumulatorList* accumulators = nullptr;
+      std::unique_ptr<GroupValue>* found_group_value =
+          zetasql_base::FindOrNull(group_map, TupleDataPtr(&probe_key_data));
+      if (found_group_value == nullptr) {
+        if (spilling) {
+          ZETASQL_RETURN_IF_ERROR(spill_row(make_spill_record(*next_input)));
+          continue;
+        }
 
-    // Accumulate.
-    ZETASQL_RET_CHECK_EQ(accumulators->size(), aggregators().size());
-    bool all_accumulators_stopped = true;
-    for (auto& accumulator_and_stop_bit : *accumulators) {
-      bool& stop_bit = accumulator_and_stop_bit.second;
-      if (stop_bit) continue;
-      if (!accumulator_and_stop_bit.first->Accumulate(*next_input, &stop_bit,
-                                                      &status)) {
-        return status;
+        // Create the new GroupValue, which takes over the probe key. If
+        // spilling may be needed, the probe key is copied instead (cheap
+        // reference count bumps, and only for rows that start a new group) so
+        // that it is still available to route the row to a partition if the
+        // reservation fails.
+        std::unique_ptr<TupleData> key_data;
+        if (allow_spill) {
+          key_data = absl::make_unique<TupleData>(probe_key_data);
+        } else {
+          key_data = absl::make_unique<TupleData>(std::move(probe_key_data));
+          probe_key_data = TupleData(keys().size());
+        }
+        const TupleData* key_data_ptr = key_data.get();
+        auto group_value_or = GroupValue::Create(std::move(key_data),
+                                                 context->memory_accountant());
+        if (!group_value_or.ok()) {
+          if (!allow_spill || radix_level + 1 >= kMaxRadixLevels ||
+              group_value_or.status().code() !=
+                  zetasql_base::StatusCode::kResourceExhausted) {
+            return group_value_or.status();
+          }
+          spilling = true;
+          ZETASQL_RETURN_IF_ERROR(spill_row(make_spill_record(*next_input)));
+          continue;
+        }
+        std::unique_ptr<GroupValue> inserted_group_value =
+            std::move(group_value_or).ValueOrDie();
+
+        // Initialize the accumulators.
+        accumulators = inserted_group_value->mutable_accumulator_list();
+        accumulators->reserve(aggregators().size());
+        for (const AggregateArg* aggregator : aggregators()) {
+          std::pair<std::unique_ptr<AggregateArgAccumulator>, bool>
+              accumulator_and_stop_bit;
+          ZETASQL_ASSIGN_OR_RETURN(accumulator_and_stop_bit.first,
+                           aggregator->CreateAccumulator(
+                               params, context, &shared_distinct_values));
+          accumulators->push_back(std::move(accumulator_and_stop_bit));
+        }
+
+        // Insert the new GroupValue.
+        ZETASQL_RET_CHECK(group_map
+                      .emplace(TupleDataPtr(key_data_ptr),
+                               std::move(inserted_group_value))
+                      .second);
+      } else {
+        accumulators = (*found_group_value)->mutable_accumulator_list();
       }
-      if (!stop_bit) all_accumulators_stopped = false;
-    }
 
-    if (all_accumulators_stopped && keys().empty()) {
-      // We are doing full aggregation and all the accumulators have stopped, we
-      // can stop reading the input.
-      break;
+      // Accumulate.
+      ZETASQL_RET_CHECK_EQ(accumulators->size(), aggregators().size());
+      bool all_accumulators_stopped = true;
+      for (auto& accumulator_and_stop_bit : *accumulators) {
+        bool& stop_bit = accumulator_and_stop_bit.second;
+        if (stop_bit) continue;
+        if (!accumulator_and_stop_bit.first->Accumulate(*next_input, &stop_bit,
+                                                        &status)) {
+          return status;
+        }
+        if (!stop_bit) all_accumulators_stopped = false;
+      }
+
+      if (all_accumulators_stopped && keys().empty()) {
+        // We are doing full aggregation and all the accumulators have stopped,
+        // we can stop reading the input.
+        break;
+      }
     }
-  }
 
-  // Build the tuples that the iterator should return.
-  auto tuples = absl::make_unique<TupleDataDeque>(context->memory_accountant());
-  for (auto& entry : group_map) {
-    // Destruction of the 'group_value' will clear all memory used by its
-    // members.
-    std::unique_ptr<GroupValue> group_value = std::move(entry.second);
-    AccumulatorList& accumulators = *group_value->mutable_accumulator_list();
-
-    std::unique_ptr<TupleData> tuple = group_value->ConsumeKey();
-    tuple->AddSlots(accumulators.size() + num_extra_slots);
-
-    for (int i = 0; i < accumulators.size(); ++i) {
-      AggregateArgAccumulator& accumulator = *accumulators[i].first;
-      ZETASQL_ASSIGN_OR_RETURN(Value value, accumulator.GetFinalResult(
-                                        /*inputs_in_defined_order=*/false));
-      tuple->mutable_slot(keys().size() + i)->SetValue(value);
+    // Queue this pass's spill files as partitions for later passes.
+    for (std::unique_ptr<TupleSpillFile>& file : spill_files) {
+      if (file == nullptr) continue;
+      auto partition = absl::make_unique<SpilledPartition>();
+      partition->file = std::move(file);
+      partition->radix_level = radix_level + 1;
+      pending_partitions.push_back(std::move(partition));
     }
-    // This can free up considerable memory. E.g., for STRING_AGG.
-    accumulators.clear();
 
-    if (!tuples->PushBack(std::move(tuple), &status)) {
-      return status;
+    // The distinct sets are only needed while accumulating. Return their
+    // bytes to the accountant before building the output tuples.
+    shared_distinct_values.Clear();
+
+    // Build the output tuples for this pass's completed groups, freeing their
+    // memory before the next partition is aggregated.
+    for (auto& entry : group_map) {
+      // Destruction of the 'group_value' will clear all memory used by its
+      // members.
+      std::unique_ptr<GroupValue> group_value = std::move(entry.second);
+      AccumulatorList& accumulators = *group_value->mutable_accumulator_list();
+
+      std::unique_ptr<TupleData> tuple = group_value->ConsumeKey();
+      tuple->AddSlots(aggregators().size() + num_extra_slots);
+
+      for (int i = 0; i < accumulators.size(); ++i) {
+        AggregateArgAccumulator& accumulator = *accumulators[i].first;
+        ZETASQL_ASSIGN_OR_RETURN(Value value, accumulator.GetFinalResult(
+                                          /*inputs_in_defined_order=*/false));
+        tuple->mutable_slot(keys().size() + i)->SetValue(value);
+      }
+      // This can free up considerable memory. E.g., for STRING_AGG.
+      accumulators.clear();
+
+      if (!tuples->TryPushBack(tuple.get(), &status)) {
+        if (!allow_spill || tuples->IsEmpty()) {
+          // Spilling is disabled, or even a single tuple does not fit in the
+          // memory budget.
+          return status;
+        }
+        // Spill the accumulated output tuples to disk as a sorted run and try
+        // again with the freed memory.
+        ZETASQL_RETURN_IF_ERROR(spill_output_run());
+        if (!tuples->TryPushBack(tuple.get(), &status)) {
+          return status;
+        }
+      }
     }
+    group_map.clear();
+
+    if (pending_partitions.empty()) break;
+    current_partition = std::move(pending_partitions.back());
+    pending_partitions.pop_back();
   }
 
-  if (tuples->IsEmpty()) {
+  if (tuples->IsEmpty() && output_runs.empty()) {
     if (keys().empty()) {
       // We are doing full aggregation over empty input, so we must compute
       // trivial values for the aggregators.
-      auto tuple =
-          absl::make_unique<TupleData>(aggregators().size() + num_extra_slots);
+      TupleData tuple(aggregators().size() + num_extra_slots);
       for (int i = 0; i < aggregators().size(); ++i) {
         const AggregateArg* aggregator = aggregators()[i];
         ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<AggregateArgAccumulator> accumulator,
                          aggregator->CreateAccumulator(params, context));
         ZETASQL_ASSIGN_OR_RETURN(Value value, accumulator->GetFinalResult(
                                           /*inputs_in_defined_order=*/true));
-        tuple->mutable_slot(i)->SetValue(value);
+        tuple.mutable_slot(i)->SetValue(value);
       }
       if (!tuples->PushBack(std::move(tuple), &status)) {
         return status;
@@ -1249,6 +1792,31 @@ class GroupValue {
     }
   }
 
+  if (!output_runs.empty()) {
+    // The output did not fit in the memory budget, so sorted runs of groups
+    // were spilled to disk. Spill the in-memory remainder as a final run and
+    // stream a merge of the runs. The grouping keys are distinct, so the
+    // merged output is uniquely ordered and there is nothing to scramble.
+    if (!tuples->IsEmpty()) {
+      ZETASQL_RETURN_IF_ERROR(spill_output_run());
+    }
+    // We store a TupleIterator instead of the debug std::string to avoid having
+    // to compute the debug std::string unnecessarily.
+    std::shared_ptr<TupleIterator> input_iter_for_debug_string =
+        std::move(input_iter);
+    std::unique_ptr<TupleIterator> merge_iter =
+        absl::make_unique<SortedRunMergeTupleIterator>(
+            [input_iter_for_debug_string] {
+              return AggregateOp::GetIteratorDebugString(
+                  input_iter_for_debug_string->DebugString());
+            },
+            CreateOutputSchema(), std::move(tuple_comparator),
+            std::move(output_runs), num_extra_slots,
+            absl::GetFlag(FLAGS_zetasql_call_verify_not_aborted_rows_period),
+            [context] { return context->VerifyNotAborted(); });
+    return MaybeProfile(std::move(merge_iter), context);
+  }
+
   // Sort the tuples by key as described above.
   //
   // TODO: Consider eliminating this sort. The downside is that
@@ -1256,14 +1824,6 @@ class GroupValue {
   // groups, which can break the reference implementation compliance tests
   // (which are based on purely textual matching). It can also break some user
   // tests.
-  std::vector<int> slots_for_keys;
-  slots_for_keys.reserve(keys().size());
-  for (int i = 0; i < keys().size(); ++i) {
-    slots_for_keys.push_back(i);
-  }
-  ZETASQL_ASSIGN_OR_RETURN(
-      std::unique_ptr<TupleComparator> tuple_comparator,
-      TupleComparator::Create(keys(), slots_for_keys, params, context));
   tuples->Sort(*tuple_comparator, /*use_stable_sort=*/false);
 
   auto input_schema =
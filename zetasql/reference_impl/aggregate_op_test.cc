@@ -42,6 +42,7 @@
 #include <cstdint>
 #include "absl/memory/memory.h"
 #include "zetasql/base/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -787,6 +788,79 @@ TEST(CreateIteratorTest, AggregateAll) {
                HasSubstr("Out of memory")));
 }
 
+TEST(CreateIteratorTest, AggregateGroupBySpillsToDisk) {
+  VariableId a("a"), b("b"), k("k"), s("s");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(absl::make_unique<KeyArg>(k, std::move(deref_a)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+
+  std::vector<std::unique_ptr<ValueExpr>> args_for_s;
+  args_for_s.push_back(std::move(deref_b));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto arg_s,
+      AggregateArg::Create(s,
+                           absl::make_unique<BuiltinAggregateFunction>(
+                               FunctionKind::kSum, Int64Type(),
+                               /*num_input_fields=*/1, Int64Type()),
+                           std::move(args_for_s)));
+
+  std::vector<std::unique_ptr<AggregateArg>> aggregators;
+  aggregators.push_back(std::move(arg_s));
+
+  // Two rows per group, with the groups arriving in decreasing key order so
+  // that the output runs of later passes interleave with earlier ones.
+  const int kNumGroups = 50;
+  std::vector<std::vector<Value>> input_values;
+  input_values.reserve(2 * kNumGroups);
+  for (int i = kNumGroups; i >= 1; --i) {
+    input_values.push_back({Int64(i), Int64(10 * i)});
+    input_values.push_back({Int64(i), Int64(10 * i + 1)});
+  }
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto aggregate_op,
+      AggregateOp::Create(std::move(keys), std::move(aggregators),
+                          absl::WrapUnique(new TestRelationalOp(
+                              {a, b}, CreateTestTupleDatas(input_values),
+                              /*preserves_order=*/true))));
+  ZETASQL_ASSERT_OK(aggregate_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  // A budget this small can only hold a few of the groups, so the aggregation
+  // must spill partitions of its input and sorted runs of its output to disk.
+  EvaluationOptions options =
+      GetIntermediateMemoryEvaluationOptions(/*total_bytes=*/500);
+  options.allow_aggregation_spill_to_disk = true;
+  EvaluationContext context(options);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TupleIterator> iter,
+                       aggregate_op->CreateIterator(
+                           EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(), "AggregationTupleIterator(TestTupleIterator)");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), kNumGroups);
+  for (int i = 0; i < kNumGroups; ++i) {
+    EXPECT_EQ(Tuple(&iter->Schema(), &data[i]).DebugString(),
+              absl::StrCat("<k:", i + 1, ",s:", 20 * (i + 1) + 1, ">"))
+        << "row " << i;
+    // Check for the extra slot.
+    EXPECT_EQ(data[i].num_slots(), 3);
+  }
+
+  // The same budget is not enough when spilling is disabled.
+  EvaluationContext memory_context(
+      GetIntermediateMemoryEvaluationOptions(/*total_bytes=*/500));
+  EXPECT_THAT(aggregate_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1,
+                                           &memory_context),
+              StatusIs(zetasql_base::StatusCode::kResourceExhausted,
+                       HasSubstr("Out of memory")));
+}
+
 TEST(CreateIteratorTest, AggregateOrderBy) {
   TypeFactory type_factory;
   VariableId a("a"), b("b"), c("c"), d("d"), e("e"), f("f"), g("g"), h("h"),
@@ -1091,6 +1165,75 @@ TEST(CreateIteratorTest, AggregateOrderBy) {
                HasSubstr("Out of memory")));
 }
 
+TEST(CreateIteratorTest, AggregateOrderBySkipDeterminismTracking) {
+  VariableId a("a"), c("c"), e("e"), k("k");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_c0,
+                       DerefExpr::Create(c, types::StringType()));
+  std::vector<std::unique_ptr<KeyArg>> order_by_keys_c0;
+  order_by_keys_c0.push_back(
+      absl::make_unique<KeyArg>(c, std::move(deref_c0), KeyArg::kDescending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_c_for_e, DerefExpr::Create(c, StringType()));
+  std::vector<std::unique_ptr<ValueExpr>> args_for_e;
+  args_for_e.push_back(std::move(deref_c_for_e));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto agg_e,
+      AggregateArg::Create(
+          e,
+          absl::make_unique<BuiltinAggregateFunction>(
+              FunctionKind::kArrayAgg, StringArrayType(),
+              /*num_input_fields=*/1, StringType(), false /* ignores_null */),
+          std::move(args_for_e), AggregateArg::kAll, nullptr /* having_expr */,
+          AggregateArg::kHavingNone, std::move(order_by_keys_c0)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(absl::make_unique<KeyArg>(k, std::move(deref_a)));
+
+  std::vector<std::unique_ptr<AggregateArg>> aggregators;
+  aggregators.push_back(std::move(agg_e));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto aggregate_op,
+      AggregateOp::Create(
+          std::move(keys), std::move(aggregators),
+          absl::WrapUnique(new TestRelationalOp(
+              {a, c},
+              CreateTestTupleDatas({{Int64(0), String("x")},
+                                    {Int64(0), String("y")},
+                                    {Int64(0), String("z")}}),
+              /*preserves_order=*/true))));
+  ZETASQL_ASSERT_OK(aggregate_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  // The order by keys uniquely order the aggregated values, so by default the
+  // ARRAY_AGG result is marked as ordered.
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TupleIterator> iter,
+                       aggregate_op->CreateIterator(
+                           EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 1);
+  EXPECT_EQ(Tuple(&iter->Schema(), &data[0]).DebugString(),
+            "<k:0,e:[\"z\", \"y\", \"x\"]>");
+
+  // With determinism tracking disabled, the uniqueness check is skipped and
+  // the result is conservatively marked as unordered. The elements are still
+  // returned in the order by order.
+  EvaluationOptions skip_options;
+  skip_options.skip_determinism_tracking = true;
+  EvaluationContext skip_context(skip_options);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter, aggregate_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0,
+                                         &skip_context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(data, ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 1);
+  EXPECT_EQ(Tuple(&iter->Schema(), &data[0]).DebugString(),
+            "<k:0,e:[unordered: \"z\", \"y\", \"x\"]>");
+}
+
 TEST(CreateIteratorTest, AggregateLimit) {
   TypeFactory type_factory;
   VariableId a("a"), b("b"), c("c"), d("d"), e("e"), k("k"), f("f"), g("g"),
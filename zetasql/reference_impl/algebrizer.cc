@@ -16,6 +16,7 @@
 
 #include "zetasql/reference_impl/algebrizer.h"
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <unordered_set>
@@ -35,6 +36,7 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/common.h"
+#include "zetasql/reference_impl/evaluation.h"
 #include "zetasql/reference_impl/function.h"
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
@@ -50,6 +52,7 @@
 #include "zetasql/base/canonical_errors.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
+#include "zetasql/base/trace.h"
 
 using zetasql::types::BoolType;
 using zetasql::types::Int64Type;
@@ -91,6 +94,121 @@ static zetasql_base::Status CheckHints(
   return ::zetasql_base::OkStatus();
 }
 
+// Returns true if 'kind' identifies a deterministic scalar function whose
+// result depends only on its arguments (in particular, not on the
+// EvaluationContext), so that a call with all-constant arguments can be
+// evaluated once at algebrization time. Array functions are safe to list
+// here because they flag order-dependent output through the context, which
+// MaybeFoldConstantExpr() checks before folding.
+static bool IsConstantFoldableFunction(FunctionKind kind) {
+  switch (kind) {
+    case FunctionKind::kAdd:
+    case FunctionKind::kSubtract:
+    case FunctionKind::kMultiply:
+    case FunctionKind::kDivide:
+    case FunctionKind::kDiv:
+    case FunctionKind::kSafeAdd:
+    case FunctionKind::kSafeSubtract:
+    case FunctionKind::kSafeMultiply:
+    case FunctionKind::kSafeDivide:
+    case FunctionKind::kSafeNegate:
+    case FunctionKind::kMod:
+    case FunctionKind::kUnaryMinus:
+    case FunctionKind::kAnd:
+    case FunctionKind::kNot:
+    case FunctionKind::kOr:
+    case FunctionKind::kEqual:
+    case FunctionKind::kLess:
+    case FunctionKind::kLessOrEqual:
+    case FunctionKind::kIsNull:
+    case FunctionKind::kIsTrue:
+    case FunctionKind::kIsFalse:
+    case FunctionKind::kLeast:
+    case FunctionKind::kGreatest:
+    case FunctionKind::kArrayConcat:
+    case FunctionKind::kArrayLength:
+    case FunctionKind::kArrayReverse:
+    case FunctionKind::kArrayAtOrdinal:
+    case FunctionKind::kArrayAtOffset:
+    case FunctionKind::kSafeArrayAtOrdinal:
+    case FunctionKind::kSafeArrayAtOffset:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Attempts to evaluate 'expr', whose inputs must all be constant, and
+// replace it with a ConstExpr holding the result. If the evaluation fails
+// (e.g., for division by zero) or has nondeterministic output, returns 'expr'
+// unchanged: a failing expression must keep failing at evaluation time
+// because it might never actually be evaluated (e.g., inside an untaken IF
+// branch). Because folding runs bottom-up during algebrization, a whole
+// parameter-free subtree (e.g., a constructed lookup array) collapses into a
+// single ConstExpr that is evaluated once per Prepare() instead of once per
+// Execute().
+static zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> MaybeFoldConstantExpr(
+    std::unique_ptr<ValueExpr> expr) {
+  ZETASQL_RETURN_IF_ERROR(expr->SetSchemasForEvaluation(/*params_schemas=*/{}));
+  EvaluationContext context((EvaluationOptions()));
+  TupleSlot slot;
+  ::zetasql_base::Status status;
+  if (!expr->EvalSimple(/*params=*/{}, &context, &slot, &status) ||
+      !context.IsDeterministicOutput()) {
+    return std::move(expr);
+  }
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> folded,
+                   ConstExpr::Create(slot.value()));
+  return folded;
+}
+
+// Minimum number of elements in a constant IN list for which membership is
+// tested with a hash set (see AlgebrizeIn) instead of a chain of equality
+// comparisons.
+static const int kMinInListSizeForHashSet = 8;
+
+// Returns a rough estimate of the cost of evaluating 'node' once, used to
+// order commutative AND/OR operands. Constants are free, other scalar
+// expressions cost the number of algebra nodes they contain, and any operand
+// that contains a relational operator (i.e., a subquery) is more expensive
+// than every scalar-only operand.
+static int64_t EstimateScalarEvaluationCost(const AlgebraNode* node) {
+  const ValueExpr* value_expr = node->AsValueExpr();
+  if (value_expr != nullptr && value_expr->IsConstant()) return 0;
+  int64_t cost = 1;
+  if (node->AsRelationalOp() != nullptr) {
+    // A subquery is assumed to dominate any scalar computation.
+    cost += 10000;
+  }
+  for (const AlgebraArg* arg : node->GetArgs()) {
+    if (arg->has_node()) {
+      cost += EstimateScalarEvaluationCost(arg->node());
+    }
+  }
+  return cost;
+}
+
+// Returns true if the tree rooted at 'node' contains a call to a function
+// whose volatility is VOLATILE (e.g., RAND()). Two occurrences of such an
+// expression may produce different values, so they must not be deduplicated.
+static bool ContainsVolatileFunction(const ResolvedNode* node) {
+  if (node->node_kind() == RESOLVED_FUNCTION_CALL &&
+      node->GetAs<ResolvedFunctionCall>()
+              ->function()
+              ->function_options()
+              .volatility == FunctionEnums::VOLATILE) {
+    return true;
+  }
+  std::vector<const ResolvedNode*> child_nodes;
+  node->GetChildNodes(&child_nodes);
+  for (const ResolvedNode* child_node : child_nodes) {
+    if (ContainsVolatileFunction(child_node)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Algebrizer::Algebrizer(const LanguageOptions& language_options,
                        const AlgebrizerOptions& algebrizer_options,
                        TypeFactory* type_factory, Parameters* parameters,
@@ -128,14 +246,53 @@ zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeCast(
 
 zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeFunctionCall(
     const ResolvedFunctionCall* function_call) {
-  int num_arguments = function_call->argument_list_size();
-  std::vector<std::unique_ptr<ValueExpr>> arguments;
-  for (int i = 0; i < num_arguments; ++i) {
-    const ResolvedExpr* argument_expr = function_call->argument_list(i);
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> argument,
-                     AlgebrizeExpression(argument_expr));
-    arguments.push_back(std::move(argument));
+  // Left-associative operator chains (e.g., 'a+b+c+...') resolve to function
+  // calls that nest arbitrarily deeply through their first argument.
+  // Algebrizing the first argument through AlgebrizeExpression() would use
+  // one C++ stack frame per call, which forces large thread stacks for
+  // worst-case inputs. Instead, collect the chain of calls and algebrize it
+  // bottom-up with an explicit loop so that the recursion depth is
+  // independent of the chain length.
+  std::vector<const ResolvedFunctionCall*> chain = {function_call};
+  while (chain.back()->argument_list_size() > 0 &&
+         chain.back()->argument_list(0)->node_kind() ==
+             RESOLVED_FUNCTION_CALL) {
+    chain.push_back(
+        chain.back()->argument_list(0)->GetAs<ResolvedFunctionCall>());
+  }
+
+  std::unique_ptr<ValueExpr> algebrized_first_argument;
+  while (true) {
+    const ResolvedFunctionCall* call = chain.back();
+    chain.pop_back();
+
+    std::vector<std::unique_ptr<ValueExpr>> arguments;
+    for (int i = 0; i < call->argument_list_size(); ++i) {
+      if (i == 0 && algebrized_first_argument != nullptr) {
+        // The first argument is the call algebrized by the previous
+        // iteration.
+        arguments.push_back(std::move(algebrized_first_argument));
+        continue;
+      }
+      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> argument,
+                       AlgebrizeExpression(call->argument_list(i)));
+      arguments.push_back(std::move(argument));
+    }
+
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_call,
+                     AlgebrizeFunctionCallWithAlgebrizedArguments(
+                         call, std::move(arguments)));
+    if (chain.empty()) return algebrized_call;
+    // The result becomes the first argument of the next (enclosing) call in
+    // the chain.
+    algebrized_first_argument = std::move(algebrized_call);
   }
+}
+
+zetasql_base::StatusOr<std::unique_ptr<ValueExpr>>
+Algebrizer::AlgebrizeFunctionCallWithAlgebrizedArguments(
+    const ResolvedFunctionCall* function_call,
+    std::vector<std::unique_ptr<ValueExpr>> arguments) {
   const std::string& name = function_call->function()->FullName(false);
   const ResolvedFunctionCallBase::ErrorMode& error_mode =
       function_call->error_mode();
@@ -196,9 +353,21 @@ zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeFunction
   } else if (name == "$between") {
     return AlgebrizeBetween(function_call->type(), std::move(arguments));
   } else if (name == "$make_array") {
+    bool can_fold = algebrizer_options_.fold_constant_function_calls;
+    for (const std::unique_ptr<ValueExpr>& argument : arguments) {
+      if (!argument->IsConstant()) {
+        can_fold = false;
+        break;
+      }
+    }
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> new_array_expr,
                      NewArrayExpr::Create(function_call->type()->AsArray(),
                                           std::move(arguments)));
+    if (can_fold) {
+      // An array of constants (e.g., an embedded lookup table) is built once
+      // here instead of on every evaluation.
+      return MaybeFoldConstantExpr(std::move(new_array_expr));
+    }
     return new_array_expr;
   } else if (name == "$in_array") {
     return AlgebrizeInArray(std::move(arguments[0]), std::move(arguments[1]));
@@ -210,10 +379,47 @@ zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeFunction
     }
     kind = status_or_kind.ValueOrDie();
   }
+  if (algebrizer_options_.reorder_commutative_operands &&
+      (kind == FunctionKind::kAnd || kind == FunctionKind::kOr) &&
+      arguments.size() > 1) {
+    // Cheap operands go first so that they get a chance to short-circuit the
+    // call (see ScalarFunctionBody::ShortCircuitValue) before expensive ones
+    // run. The sort is stable so equally-priced operands keep their source
+    // order. AND and OR are commutative and ZetaSQL does not define the
+    // evaluation order of their operands, so reordering them is legal.
+    std::vector<std::pair<int64_t, std::unique_ptr<ValueExpr>>> ranked;
+    ranked.reserve(arguments.size());
+    for (std::unique_ptr<ValueExpr>& argument : arguments) {
+      ranked.emplace_back(EstimateScalarEvaluationCost(argument.get()),
+                          std::move(argument));
+    }
+    std::stable_sort(
+        ranked.begin(), ranked.end(),
+        [](const std::pair<int64_t, std::unique_ptr<ValueExpr>>& a,
+           const std::pair<int64_t, std::unique_ptr<ValueExpr>>& b) {
+          return a.first < b.first;
+        });
+    for (int i = 0; i < arguments.size(); ++i) {
+      arguments[i] = std::move(ranked[i].second);
+    }
+  }
+  bool can_fold = algebrizer_options_.fold_constant_function_calls &&
+                  IsConstantFoldableFunction(kind);
+  if (can_fold) {
+    for (const std::unique_ptr<ValueExpr>& argument : arguments) {
+      if (!argument->IsConstant()) {
+        can_fold = false;
+        break;
+      }
+    }
+  }
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> function_call_expr,
                    BuiltinScalarFunction::CreateCall(
                        kind, language_options_, function_call->type(),
                        std::move(arguments), error_mode));
+  if (can_fold) {
+    return MaybeFoldConstantExpr(std::move(function_call_expr));
+  }
   return function_call_expr;
 }
 
@@ -411,6 +617,38 @@ zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeCoalesce
 zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeIn(
     const Type* output_type, std::vector<std::unique_ptr<ValueExpr>> args) {
   ZETASQL_RET_CHECK_GE(args.size(), 2);
+
+  // If the list consists of constants of a simple type, test membership with
+  // a single hash set probe (see InListExpr) instead of building a chain of
+  // OR and equality calls that is evaluated in time linear in the size of the
+  // list. Short lists stay on the chain, which beats hashing for a handful of
+  // elements.
+  const Type* needle_type = args[0]->output_type();
+  bool use_in_list_expr =
+      args.size() - 1 >= kMinInListSizeForHashSet &&
+      needle_type->IsSimpleType() &&
+      ValidateTypeSupportsEqualityComparison(needle_type).ok();
+  if (use_in_list_expr) {
+    for (int i = 1; i < args.size(); ++i) {
+      if (!args[i]->IsConstant() ||
+          !args[i]->output_type()->Equals(needle_type)) {
+        use_in_list_expr = false;
+        break;
+      }
+    }
+  }
+  if (use_in_list_expr) {
+    std::vector<Value> values;
+    values.reserve(args.size() - 1);
+    for (int i = 1; i < args.size(); ++i) {
+      // IsConstant() is only true for ConstExpr, so the cast is safe.
+      values.push_back(static_cast<const ConstExpr*>(args[i].get())->value());
+    }
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> in_list_expr,
+                     InListExpr::Create(std::move(args[0]), values));
+    return in_list_expr;
+  }
+
   const VariableId x = variable_gen_->GetNewVariableName("x");
   std::vector<std::unique_ptr<ValueExpr>> or_args;
   for (int i = 0; i < args.size() - 1; ++i) {
@@ -604,7 +842,7 @@ zetasql_base::StatusOr<std::unique_ptr<AggregateArg>> Algebrizer::AlgebrizeAggre
       std::move(limit), aggregate_function->error_mode());
 }
 
-zetasql_base::StatusOr<std::unique_ptr<NewStructExpr>> Algebrizer::MakeStruct(
+zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::MakeStruct(
     const ResolvedMakeStruct* make_struct) {
   DCHECK(make_struct->type()->IsStruct());
   const StructType* struct_type = make_struct->type()->AsStruct();
@@ -612,17 +850,26 @@ zetasql_base::StatusOr<std::unique_ptr<NewStructExpr>> Algebrizer::MakeStruct(
   // Build a list of arguments.
   std::vector<std::unique_ptr<ExprArg>> arguments;
   DCHECK_EQ(struct_type->num_fields(), make_struct->field_list_size());
+  bool can_fold = algebrizer_options_.fold_constant_function_calls;
   for (int i = 0; i < struct_type->num_fields(); ++i) {
     const ResolvedExpr* field_expr = make_struct->field_list()[i].get();
     DCHECK(field_expr->type()->Equals(struct_type->field(i).type));
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> algebrized_field_expr,
                      AlgebrizeExpression(field_expr));
+    can_fold = can_fold && algebrized_field_expr->IsConstant();
     // Record the field value.
     arguments.push_back(
         absl::make_unique<ExprArg>(std::move(algebrized_field_expr)));
   }
   // Build the row value.
-  return NewStructExpr::Create(struct_type, std::move(arguments));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> new_struct_expr,
+                   NewStructExpr::Create(struct_type, std::move(arguments)));
+  if (can_fold) {
+    // A struct of constants is built once here instead of on every
+    // evaluation.
+    return MaybeFoldConstantExpr(std::move(new_struct_expr));
+  }
+  return new_struct_expr;
 }
 
 zetasql_base::StatusOr<std::unique_ptr<FieldValueExpr>>
@@ -2192,19 +2439,12 @@ Algebrizer::ApplyAlgebrizedFilterConjuncts(
     // No FilterOp needed, just use the input directly.
     rel_op = std::move(input);
   } else {
-    std::unique_ptr<ValueExpr> filter;
-    if (algebrized_conjuncts.size() == 1) {
-      filter = std::move(algebrized_conjuncts[0]);
-    } else {
-      ZETASQL_ASSIGN_OR_RETURN(
-          filter, BuiltinScalarFunction::CreateCall(
-                      FunctionKind::kAnd, language_options_, types::BoolType(),
-                      std::move(algebrized_conjuncts),
-                      ResolvedFunctionCallBase::DEFAULT_ERROR_MODE));
-    }
-
-    ZETASQL_ASSIGN_OR_RETURN(rel_op,
-                     FilterOp::Create(std::move(filter), std::move(input)));
+    // The conjuncts are passed to the FilterOp individually (rather than
+    // combined into an AND function call) so that its iterator can evaluate
+    // them one at a time and adaptively reorder them by observed cost and
+    // selectivity.
+    ZETASQL_ASSIGN_OR_RETURN(rel_op, FilterOp::Create(std::move(algebrized_conjuncts),
+                                              std::move(input)));
   }
   return rel_op;
 }
@@ -3064,9 +3304,15 @@ zetasql_base::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProje
       std::unique_ptr<RelationalOp> input,
       AlgebrizeScan(resolved_project->input_scan(), &input_active_conjuncts));
 
-  // Assign variables to the new columns and algebrize their definitions.
+  // Assign variables to the new columns and algebrize their definitions. If
+  // deduplication is enabled, a column whose algebrized definition is
+  // byte-identical to that of an earlier column becomes a reference to the
+  // earlier column's variable instead of a second computation. This is legal
+  // because each element of a ComputeOp's map may refer to the variables of
+  // the previous elements.
   std::vector<std::unique_ptr<ExprArg>> arguments;
   arguments.reserve(defined_columns_and_exprs.size());
+  absl::flat_hash_map<std::string, VariableId> definitions_to_variables;
   for (const auto& entry : defined_columns_and_exprs) {
     const ResolvedColumn& column = entry.first;
     const ResolvedExpr* expr = entry.second;
@@ -3074,6 +3320,18 @@ zetasql_base::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProje
                      AlgebrizeExpression(expr));
     const VariableId variable =
         column_to_variable_->AssignNewVariableToColumn(&column);
+    if (algebrizer_options_.deduplicate_computed_expressions &&
+        !argument->IsConstant() && !ContainsVolatileFunction(expr)) {
+      // A constant is cheaper to evaluate than a variable reference, so
+      // constants are not deduplicated.
+      const auto insert_result = definitions_to_variables.emplace(
+          argument->DebugString(/*verbose=*/true), variable);
+      if (!insert_result.second) {
+        ZETASQL_ASSIGN_OR_RETURN(
+            argument,
+            DerefExpr::Create(insert_result.first->second, expr->type()));
+      }
+    }
     arguments.push_back(
         absl::make_unique<ExprArg>(variable, std::move(argument)));
   }
@@ -3738,6 +3996,7 @@ zetasql_base::Status Algebrizer::AlgebrizeStatement(
     const ResolvedStatement* ast_root, std::unique_ptr<ValueExpr>* output,
     Parameters* parameters, ParameterMap* column_map,
     SystemVariablesAlgebrizerMap* system_variables_map) {
+  ZETASQL_TRACE_SPAN("Algebrizer::AlgebrizeStatement");
   ZETASQL_RETURN_IF_ERROR(VerifyParameters(parameters));
 
   Algebrizer single_use_algebrizer(language_options, algebrizer_options,
@@ -3804,6 +4063,7 @@ zetasql_base::Status Algebrizer::AlgebrizeQueryStatementAsRelation(
     std::vector<VariableId>* output_column_variables, Parameters* parameters,
     ParameterMap* column_map,
     SystemVariablesAlgebrizerMap* system_variables_map) {
+  ZETASQL_TRACE_SPAN("Algebrizer::AlgebrizeQueryStatementAsRelation");
   ZETASQL_RETURN_IF_ERROR(VerifyParameters(parameters));
   Algebrizer single_use_algebrizer(language_options, algebrizer_options,
                                    type_factory, parameters, column_map,
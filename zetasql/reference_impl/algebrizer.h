@@ -72,6 +72,29 @@ struct AlgebrizerOptions {
   // LIMIT instead of LimitOp(SortOp), which saves memory.
   bool allow_order_by_limit_operator = false;
 
+  // If true, the algebrizer evaluates calls to deterministic,
+  // context-independent scalar functions whose arguments are all constants and
+  // replaces them with the resulting constant. Calls whose evaluation fails
+  // are left in place so that the error is still raised (or not) at evaluation
+  // time.
+  bool fold_constant_function_calls = false;
+
+  // If true, when several computed columns in the same projection have
+  // byte-identical deterministic definitions, the algebrizer computes the
+  // definition once and turns the later occurrences into references to the
+  // first occurrence's variable. Definitions that (transitively) call a
+  // volatile function such as RAND() are never deduplicated because each
+  // occurrence may produce a different value.
+  bool deduplicate_computed_expressions = false;
+
+  // If true, the algebrizer reorders the operands of AND and OR by estimated
+  // evaluation cost, cheapest first, so that inexpensive operands get a
+  // chance to short-circuit the call before expensive ones (e.g., operands
+  // containing subqueries) run. AND and OR are commutative and ZetaSQL does
+  // not define the evaluation order of their operands, so this is always
+  // legal.
+  bool reorder_commutative_operands = false;
+
   // If true, the algebrizer attempts to push down filters into the highest
   // ancestor node that is either a join or an EvaluatorTableScanOp node. In the
   // latter case, the filter remains in its original location because
@@ -178,7 +201,16 @@ class Algebrizer {
   zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> AlgebrizeFunctionCall(
       const ResolvedFunctionCall* function_call);
 
-  zetasql_base::StatusOr<std::unique_ptr<NewStructExpr>> MakeStruct(
+  // Helper for AlgebrizeFunctionCall() that builds the ValueExpr for
+  // 'function_call' from its already-algebrized 'arguments'. Split out so
+  // that chains of calls nested through their first argument can be
+  // algebrized iteratively instead of recursively.
+  zetasql_base::StatusOr<std::unique_ptr<ValueExpr>>
+  AlgebrizeFunctionCallWithAlgebrizedArguments(
+      const ResolvedFunctionCall* function_call,
+      std::vector<std::unique_ptr<ValueExpr>> arguments);
+
+  zetasql_base::StatusOr<std::unique_ptr<ValueExpr>> MakeStruct(
       const ResolvedMakeStruct* make_struct);
 
   zetasql_base::StatusOr<std::unique_ptr<FieldValueExpr>> AlgebrizeGetStructField(
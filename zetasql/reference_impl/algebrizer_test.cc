@@ -1008,9 +1008,195 @@ INSTANTIATE_TEST_SUITE_P(AlgebrizerTestSelectFunctionsTest,
                          AlgebrizerTestFunctions,
                          ValuesIn(AlgebrizerTestFunctions::AllFunctionTests()));
 
+class ConstantFoldingAlgebrizerTest : public AlgebrizerTestBase {
+ protected:
+  void SetUp() override {
+    algebrizer_options_.fold_constant_function_calls = true;
+    AlgebrizerTestBase::SetUp();
+  }
+};
+
+TEST_F(ConstantFoldingAlgebrizerTest, FoldsConstantCalls) {
+  Function fn_add("$add", Function::kZetaSQLFunctionGroupName,
+                  Function::SCALAR);
+  FunctionSignature int64_int64_int64(Int64Type(), {Int64Type(), Int64Type()},
+                                      -1 /* context_id */);
+  std::unique_ptr<const ResolvedExpr> add = MakeResolvedFunctionCall(
+      Int64Type(), &fn_add, int64_int64_int64,
+      MakeNodeVectorP<const ResolvedExpr>(
+          MakeResolvedLiteral(Value::Int64(13)),
+          MakeResolvedLiteral(Value::Int64(7))),
+      DEFAULT_ERROR_MODE);
+  TestAlgebrizeExpression(add.get(), "ConstExpr(Int64(20))");
+}
+
+TEST_F(ConstantFoldingAlgebrizerTest, DoesNotFoldFailingCalls) {
+  // Division by zero must remain a runtime error because the call might never
+  // actually be evaluated, so the call is algebrized unchanged.
+  Function fn_divide("$divide", Function::kZetaSQLFunctionGroupName,
+                     Function::SCALAR);
+  FunctionSignature double_double_double(DoubleType(),
+                                         {DoubleType(), DoubleType()},
+                                         -1 /* context_id */);
+  std::unique_ptr<const ResolvedExpr> divide = MakeResolvedFunctionCall(
+      DoubleType(), &fn_divide, double_double_double,
+      MakeNodeVectorP<const ResolvedExpr>(
+          MakeResolvedLiteral(Value::Double(1)),
+          MakeResolvedLiteral(Value::Double(0))),
+      DEFAULT_ERROR_MODE);
+  TestAlgebrizeExpression(divide.get(),
+                          "Divide(ConstExpr(Double(1)), ConstExpr(Double(0)))");
+}
+
+TEST_F(ConstantFoldingAlgebrizerTest, FoldsConstantArrayConstruction) {
+  // An array of constants is built once at algebrization time instead of on
+  // every evaluation.
+  Function fn_make_array("$make_array", Function::kZetaSQLFunctionGroupName,
+                         Function::SCALAR);
+  FunctionSignature array_int64_int64(Int64ArrayType(),
+                                      {Int64Type(), Int64Type()},
+                                      -1 /* context_id */);
+  std::unique_ptr<const ResolvedExpr> make_array = MakeResolvedFunctionCall(
+      Int64ArrayType(), &fn_make_array, array_int64_int64,
+      MakeNodeVectorP<const ResolvedExpr>(
+          MakeResolvedLiteral(Value::Int64(13)),
+          MakeResolvedLiteral(Value::Int64(7))),
+      DEFAULT_ERROR_MODE);
+  TestAlgebrizeExpression(
+      make_array.get(),
+      absl::StrCat("ConstExpr(", Int64Array({13, 7}).DebugString(true), ")"));
+}
+
+TEST_F(ConstantFoldingAlgebrizerTest, FoldsConstantStruct) {
+  const Value struct_value =
+      Struct({{"a", Value::Int64(5)}, {"b", Value::String("x")}});
+  std::unique_ptr<const ResolvedExpr> make_struct = MakeResolvedMakeStruct(
+      struct_value.type(), MakeNodeVectorP<const ResolvedExpr>(
+                               MakeResolvedLiteral(Value::Int64(5)),
+                               MakeResolvedLiteral(Value::String("x"))));
+  TestAlgebrizeExpression(
+      make_struct.get(),
+      absl::StrCat("ConstExpr(", struct_value.DebugString(true), ")"));
+}
+
+class OperandReorderingAlgebrizerTest : public AlgebrizerTestBase {
+ protected:
+  void SetUp() override {
+    algebrizer_options_.reorder_commutative_operands = true;
+    AlgebrizerTestBase::SetUp();
+  }
+};
+
+TEST_F(OperandReorderingAlgebrizerTest, MovesCheapAndOperandFirst) {
+  // @p < 1 AND false: the constant operand moves in front of the comparison
+  // so that it can short-circuit the call.
+  Function fn_less("$less", Function::kZetaSQLFunctionGroupName,
+                   Function::SCALAR);
+  FunctionSignature bool_int64_int64(BoolType(), {Int64Type(), Int64Type()},
+                                     -1 /* context_id */);
+  auto less = MakeResolvedFunctionCall(
+      BoolType(), &fn_less, bool_int64_int64,
+      MakeNodeVectorP<const ResolvedExpr>(
+          MakeResolvedParameter(Int64Type(), "p"),
+          MakeResolvedLiteral(Value::Int64(1))),
+      DEFAULT_ERROR_MODE);
+  Function fn_and("$and", Function::kZetaSQLFunctionGroupName,
+                  Function::SCALAR);
+  FunctionSignature bool_bool_bool(BoolType(), {BoolType(), BoolType()},
+                                   -1 /* context_id */);
+  std::unique_ptr<const ResolvedExpr> and_call = MakeResolvedFunctionCall(
+      BoolType(), &fn_and, bool_bool_bool,
+      MakeNodeVectorP<const ResolvedExpr>(
+          std::move(less), MakeResolvedLiteral(Value::Bool(false))),
+      DEFAULT_ERROR_MODE);
+  TestAlgebrizeExpression(
+      and_call.get(),
+      "And(ConstExpr(Bool(false)), Less(DerefExpr(p), ConstExpr(Int64(1))))");
+}
+
+class DeduplicatingAlgebrizerTest : public AlgebrizerTestBase {
+ protected:
+  void SetUp() override {
+    algebrizer_options_.deduplicate_computed_expressions = true;
+    AlgebrizerTestBase::SetUp();
+  }
+
+  // Creates a project scan over a single row that computes two columns $col1
+  // and $col2 with identical definitions: a call to 'function' with the
+  // parameter @p and the literal 1 as arguments.
+  std::unique_ptr<ResolvedProjectScan> CreateProjectWithTwoIdenticalColumns(
+      const Function* function) {
+    FunctionSignature int64_int64_int64(Int64Type(), {Int64Type(), Int64Type()},
+                                        -1 /* context_id */);
+    std::vector<std::unique_ptr<const ResolvedComputedColumn>> exprs;
+    for (int column_id = 1; column_id <= 2; ++column_id) {
+      ResolvedColumn column(column_id, "$query",
+                            absl::StrCat("$col", column_id), Int64Type());
+      auto call = MakeResolvedFunctionCall(
+          Int64Type(), function, int64_int64_int64,
+          MakeNodeVectorP<const ResolvedExpr>(
+              MakeResolvedParameter(Int64Type(), "p"),
+              MakeResolvedLiteral(Value::Int64(1))),
+          DEFAULT_ERROR_MODE);
+      exprs.push_back(MakeResolvedComputedColumn(column, std::move(call)));
+    }
+    return CreateResolvedProjectScan(std::move(exprs),
+                                     MakeResolvedSingleRowScan());
+  }
+};
+
+TEST_F(DeduplicatingAlgebrizerTest, DeduplicatesIdenticalComputedColumns) {
+  // SELECT @p + 1, @p + 1: the second computed column becomes a reference to
+  // the first one instead of a second addition.
+  Function fn_add("$add", Function::kZetaSQLFunctionGroupName,
+                  Function::SCALAR);
+  std::unique_ptr<ResolvedProjectScan> project =
+      CreateProjectWithTwoIdenticalColumns(&fn_add);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const AlgebraNode> algebrized,
+                       AlgebrizeAndNestInStruct(project.get()));
+  EXPECT_THAT(algebrized->DebugString(), HasSubstr("$col2 := $col1"));
+}
+
+TEST_F(DeduplicatingAlgebrizerTest, DoesNotDeduplicateVolatileCalls) {
+  // Each occurrence of a volatile function call may produce a different
+  // value, so both columns must remain separate computations.
+  Function fn_rand("rand", Function::kZetaSQLFunctionGroupName,
+                   Function::SCALAR,
+                   FunctionOptions().set_volatility(FunctionEnums::VOLATILE));
+  std::unique_ptr<ResolvedProjectScan> project =
+      CreateProjectWithTwoIdenticalColumns(&fn_rand);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const AlgebraNode> algebrized,
+                       AlgebrizeAndNestInStruct(project.get()));
+  EXPECT_THAT(algebrized->DebugString(),
+              testing::Not(HasSubstr("$col2 := $col1")));
+}
+
 // Tests that the algebrizer does not crash on unknown functions.
 // TODO: add a test that calls the top-level Algebrize() method
 // on a query that uses an unknown function to prevent crashes upon errors.
+TEST_F(ExpressionAlgebrizerTest, LeftNestedFunctionCallChain) {
+  // 1 + 2 + 3 + 4 resolves to calls that nest through their first argument.
+  // Such chains are algebrized iteratively; verify that the bottom-up loop
+  // rebuilds the same tree as plain recursion would.
+  Function fn_add("$add", Function::kZetaSQLFunctionGroupName,
+                  Function::SCALAR);
+  FunctionSignature int64_int64_int64(Int64Type(), {Int64Type(), Int64Type()},
+                                      -1 /* context_id */);
+  std::unique_ptr<const ResolvedExpr> chain =
+      MakeResolvedLiteral(Value::Int64(1));
+  for (int i = 2; i <= 4; ++i) {
+    chain = MakeResolvedFunctionCall(
+        Int64Type(), &fn_add, int64_int64_int64,
+        MakeNodeVectorP<const ResolvedExpr>(
+            std::move(chain), MakeResolvedLiteral(Value::Int64(i))),
+        DEFAULT_ERROR_MODE);
+  }
+  TestAlgebrizeExpression(
+      chain.get(),
+      "Add(Add(Add(ConstExpr(Int64(1)), ConstExpr(Int64(2))), "
+      "ConstExpr(Int64(3))), ConstExpr(Int64(4)))");
+}
+
 TEST_F(ExpressionAlgebrizerTest, UnknownFunction) {
   FunctionSignature bool_int64(BoolType(), {Int64Type()}, -1 /* context_id */);
   Function bogus_function("ThisIsNotAValidFunctionName", "function_group",
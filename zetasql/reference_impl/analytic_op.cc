@@ -18,10 +18,12 @@
 
 #include <algorithm>
 #include <cmath>
+#include <deque>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -36,6 +38,7 @@
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/variable_id.h"
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include <cstdint>
 #include "absl/container/flat_hash_set.h"
@@ -43,6 +46,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "zetasql/base/source_location.h"
@@ -1361,11 +1365,15 @@ zetasql_base::Status WindowFrameArg::GetWindows(
     bool window_frame_is_empty;
     ZETASQL_RETURN_IF_ERROR(IsStaticallyEmpty(params, partition.size(), context,
                                       &window_frame_is_empty));
+    // The uniqueness check is skipped when determinism tracking is disabled
+    // because its only consumer is EvaluationContext::IsDeterministicOutput(),
+    // which is meaningless in that mode.
     if ((start_boundary_arg_->IsUnbounded() &&
          end_boundary_arg_->IsUnbounded()) ||
         (start_boundary_arg_->IsCurrentRow() &&
          end_boundary_arg_->IsCurrentRow()) ||
         window_frame_is_empty ||
+        context->options().skip_determinism_tracking ||
         comparator->IsUniquelyOrdered(partition, value_slot_idxs)) {
       *is_deterministic = true;
     } else {
@@ -1494,15 +1502,11 @@ zetasql_base::Status AggregateAnalyticArg::Eval(
       *partition_schema_, partition, order_keys, params, context, &windows,
       &window_frame_is_deterministic));
 
-  for (const AnalyticWindow& window : windows) {
-    // Call AggregateArg::EvalAgg to evaluate the argument expressions and
-    // compute the aggregate on each window.
-    const absl::Span<const TupleData* const> window_tuples =
-        partition.subspan(window.start_tuple_id, window.num_tuples);
-    ZETASQL_ASSIGN_OR_RETURN(const Value agg_value,
-                     aggregator_->EvalAgg(window_tuples, params, context));
-    values->emplace_back(agg_value);
-  }
+  // Compute the aggregate on each window. For simple aggregations over
+  // sliding windows this uses an incremental algorithm instead of evaluating
+  // every window from scratch.
+  ZETASQL_RETURN_IF_ERROR(aggregator_->EvalAggOverWindows(partition, windows, params,
+                                                  context, values));
 
   // We conservatively treat aggregation results as non-deterministic
   // if the windows are not deterministic.
@@ -1712,6 +1716,18 @@ namespace {
 // 'analytic_args.size()' extra slots by 'partition_keys'. Evaluates all of the
 // 'analytic_args' on each partition and adds corresponding values to the
 // tuples.
+//
+// Partitions are independent work units, so when
+// EvaluationOptions::max_intra_op_parallelism is greater than 1 (and there is
+// a PARTITION BY), up to that many partitions are evaluated concurrently: the
+// calling thread loads partitions from 'input_iter' and queues them, each
+// queued partition is evaluated by a task on the shared WorkStealingScheduler
+// (or on a dedicated thread if no scheduler is configured), and the output is
+// consumed in partition order. The background work only calls
+// AnalyticArg::Eval(), which touches the EvaluationContext through the
+// MemoryAccountant (thread-safe) and the non-determinism and
+// used-top-n-accumulator flags (atomic); everything else, including advancing
+// 'input_iter', stays on the calling thread.
 class AnalyticTupleIterator : public TupleIterator {
  public:
   AnalyticTupleIterator(absl::Span<const TupleData* const> params,
@@ -1729,12 +1745,36 @@ class AnalyticTupleIterator : public TupleIterator {
         input_iter_(std::move(input_iter)),
         partition_comparator_(std::move(partition_comparator)),
         output_schema_(std::move(output_schema)),
-        remaining_current_partition_(context->memory_accountant()),
-        context_(context) {}
+        context_(context),
+        parallel_(context->options().max_intra_op_parallelism > 1 &&
+                  !partition_keys_.empty()),
+        max_pending_partitions_(
+            std::max<int64_t>(context->options().max_intra_op_parallelism, 1)),
+        first_analytic_arg_slot_(input_iter_->Schema().num_variables()) {
+    if (parallel_) {
+      query_handle_ = context->scheduler_query_handle();
+    }
+  }
 
   AnalyticTupleIterator(const AnalyticTupleIterator&) = delete;
   AnalyticTupleIterator& operator=(const AnalyticTupleIterator&) = delete;
 
+  ~AnalyticTupleIterator() override {
+    // Wait for outstanding partition evaluations (which reference this
+    // iterator's members) to finish before destroying anything.
+    {
+      absl::MutexLock l(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](int* num) { return *num == 0; }, &num_tasks_in_flight_));
+    }
+    for (std::unique_ptr<PendingPartition>& pending : pending_partitions_) {
+      if (pending->thread.joinable()) pending->thread.join();
+    }
+    if (current_partition_ != nullptr && current_partition_->thread.joinable()) {
+      current_partition_->thread.join();
+    }
+  }
+
   const TupleSchema& Schema() const override { return *output_schema_; }
 
   TupleData* Next() override {
@@ -1750,14 +1790,24 @@ class AnalyticTupleIterator : public TupleIterator {
     }
     ++num_next_calls_;
 
-    if (!remaining_current_partition_.IsEmpty()) {
+    if (current_partition_ != nullptr &&
+        !current_partition_->tuples.IsEmpty()) {
       // We have loaded a partition and are consuming it.
       output_empty_ = false;
-      current_ = remaining_current_partition_.PopFront();
-      return current_.get();
+      current_ = current_partition_->tuples.PopFront();
+      return &current_;
+    }
+
+    // Load the next partition, and in parallel mode enough further partitions
+    // to keep 'max_pending_partitions_' evaluations in flight.
+    while (!input_exhausted_ &&
+           pending_partitions_.size() < max_pending_partitions_) {
+      if (!LoadAndSchedulePartition()) return nullptr;
+      if (!parallel_ && !pending_partitions_.empty()) break;
     }
 
-    if (is_last_partition_) {
+    if (pending_partitions_.empty()) {
+      // There are no partitions left.
       if (!output_empty_) {
         // Partitioning by a floating point type is a non-deterministic
         // operation unless the output is empty.
@@ -1770,93 +1820,157 @@ class AnalyticTupleIterator : public TupleIterator {
       return nullptr;
     }
 
-    // Load a new partition.
-    std::unique_ptr<TupleData> first_tuple_in_current_partition;
+    // Consume the oldest pending partition, waiting for its evaluation to
+    // finish if necessary.
+    if (current_partition_ != nullptr && current_partition_->thread.joinable()) {
+      current_partition_->thread.join();
+    }
+    current_partition_ = std::move(pending_partitions_.front());
+    pending_partitions_.pop_front();
+    {
+      absl::MutexLock l(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](PendingPartition* partition) { return partition->done; },
+          current_partition_.get()));
+    }
+    if (!current_partition_->status.ok()) {
+      status_ = current_partition_->status;
+      return nullptr;
+    }
+
+    output_empty_ = false;
+    current_ = current_partition_->tuples.PopFront();
+    return &current_;
+  }
+
+  zetasql_base::Status Status() const override { return status_; }
+
+  std::string DebugString() const override {
+    return AnalyticOp::GetIteratorDebugString(input_iter_->DebugString());
+  }
+
+ private:
+  // A partition whose analytic arguments are being (or have been) evaluated.
+  struct PendingPartition {
+    explicit PendingPartition(MemoryAccountant* accountant)
+        : tuples(accountant) {}
+
+    TupleDataDeque tuples;
+    // Set by the evaluation, which runs on a worker in parallel mode. Guarded
+    // by the iterator's 'mutex_' until 'done' is observed true.
+    zetasql_base::Status status;
+    bool done = false;
+    // The thread evaluating this partition. Unused in serial mode or when the
+    // evaluation runs on a shared scheduler.
+    std::thread thread;
+  };
+
+  // Loads the next partition from 'input_iter_' and starts evaluating its
+  // analytic arguments: inline in serial mode, or on a scheduler task or
+  // background thread in parallel mode. Appends the partition to
+  // 'pending_partitions_'. Returns false and populates 'status_' on error.
+  // Sets 'input_exhausted_' (possibly without appending a partition) when the
+  // input has no more tuples.
+  bool LoadAndSchedulePartition() {
+    TupleData first_tuple_in_partition;
     if (first_tuple_in_next_partition_ == nullptr) {
       // We are loading the first tuple of the first partition.
       const TupleData* input_data = input_iter_->Next();
       if (input_data == nullptr) {
         status_ = input_iter_->Status();
-        return nullptr;
+        input_exhausted_ = true;
+        return status_.ok();
       }
-      first_tuple_in_current_partition =
-          absl::make_unique<TupleData>(*input_data);
+      first_tuple_in_partition = *input_data;
     } else {
-      first_tuple_in_current_partition =
-          std::move(first_tuple_in_next_partition_);
+      first_tuple_in_partition = std::move(*first_tuple_in_next_partition_);
+      first_tuple_in_next_partition_.reset();
     }
-    TupleData* first_tuple_in_current_partition_ptr =
-        first_tuple_in_current_partition.get();
-    if (!remaining_current_partition_.PushBack(
-            std::move(first_tuple_in_current_partition), &status_)) {
-      return nullptr;
+
+    auto partition =
+        absl::make_unique<PendingPartition>(context_->memory_accountant());
+    if (!partition->tuples.PushBack(std::move(first_tuple_in_partition),
+                                    &status_)) {
+      return false;
     }
+    // Stable across the pushes below because pushing at the back of a
+    // TupleDataDeque does not move existing entries.
+    const TupleData* first_tuple_in_partition_ptr = partition->tuples.Back();
 
-    // We have determined the first tuple of the next partition. Now load the
-    // rest.
+    // We have determined the first tuple of the partition. Now load the rest.
     while (true) {
       const TupleData* input_data = input_iter_->Next();
       if (input_data == nullptr) {
         status_ = input_iter_->Status();
-        if (!status_.ok()) return nullptr;
-        is_last_partition_ = true;
+        if (!status_.ok()) return false;
+        input_exhausted_ = true;
         break;
       }
 
       const bool comparator_equals =
-          !(*partition_comparator_)(*first_tuple_in_current_partition_ptr,
+          !(*partition_comparator_)(*first_tuple_in_partition_ptr,
                                     *input_data) &&
           !(*partition_comparator_)(*input_data,
-                                    *first_tuple_in_current_partition_ptr);
+                                    *first_tuple_in_partition_ptr);
       if (!comparator_equals) {
-        // We are done loading the current partition. 'input_data' belongs in
-        // the next partition.
+        // We are done loading this partition. 'input_data' belongs in the
+        // next partition.
         first_tuple_in_next_partition_ =
             absl::make_unique<TupleData>(*input_data);
         break;
       }
-      // 'input_data' belongs in the current partition (which we are still
-      // loading).
-      if (!remaining_current_partition_.PushBack(
-              absl::make_unique<TupleData>(*input_data), &status_)) {
-        return nullptr;
+      // 'input_data' belongs in the partition (which we are still loading).
+      if (!partition->tuples.PushBack(*input_data, &status_)) {
+        return false;
       }
     }
 
-    zetasql_base::Status status = PopulateAnalyticArgSlots();
-    if (!status.ok()) {
-      status_ = status;
-      return nullptr;
+    PendingPartition* partition_ptr = partition.get();
+    pending_partitions_.push_back(std::move(partition));
+    if (!parallel_) {
+      partition_ptr->status = PopulateAnalyticArgSlots(&partition_ptr->tuples);
+      partition_ptr->done = true;
+      return true;
     }
-
-    output_empty_ = false;
-    current_ = remaining_current_partition_.PopFront();
-    return current_.get();
+    {
+      absl::MutexLock l(&mutex_);
+      ++num_tasks_in_flight_;
+    }
+    if (query_handle_ != nullptr) {
+      query_handle_->Schedule(
+          [this, partition_ptr] { EvaluatePartition(partition_ptr); });
+    } else {
+      partition_ptr->thread =
+          std::thread([this, partition_ptr] { EvaluatePartition(partition_ptr); });
+    }
+    return true;
   }
 
-  zetasql_base::Status Status() const override { return status_; }
-
-  std::string DebugString() const override {
-    return AnalyticOp::GetIteratorDebugString(input_iter_->DebugString());
+  // Evaluates the analytic arguments of 'partition' and marks it done. Runs
+  // as a scheduler task or on a background thread in parallel mode.
+  void EvaluatePartition(PendingPartition* partition) {
+    zetasql_base::Status status =
+        PopulateAnalyticArgSlots(&partition->tuples);  // No lock held.
+    absl::MutexLock l(&mutex_);
+    partition->status = status;
+    partition->done = true;
+    --num_tasks_in_flight_;
   }
 
- private:
   // For each AnalyticArg in 'analytic_args', populates the corresponding slot
-  // in all the rows in 'current_partition_'.
-  zetasql_base::Status PopulateAnalyticArgSlots() {
+  // in all the rows in 'partition'.
+  zetasql_base::Status PopulateAnalyticArgSlots(TupleDataDeque* partition) const {
     for (int arg_idx = 0; arg_idx < analytic_args_.size(); ++arg_idx) {
       const AnalyticArg* analytic_arg = analytic_args_[arg_idx];
 
-      std::vector<const TupleData*> current_partition_ptrs =
-          remaining_current_partition_.GetTuplePtrs();
+      std::vector<const TupleData*> partition_ptrs = partition->GetTuplePtrs();
 
       std::vector<Value> values;
-      ZETASQL_RETURN_IF_ERROR(analytic_arg->Eval(current_partition_ptrs, order_keys_,
-                                         params_, context_, &values));
+      ZETASQL_RETURN_IF_ERROR(analytic_arg->Eval(partition_ptrs, order_keys_, params_,
+                                         context_, &values));
 
-      const int slot_idx = input_iter_->Schema().num_variables() + arg_idx;
-      ZETASQL_RETURN_IF_ERROR(
-          remaining_current_partition_.SetSlot(slot_idx, std::move(values)));
+      const int slot_idx = first_analytic_arg_slot_ + arg_idx;
+      ZETASQL_RETURN_IF_ERROR(partition->SetSlot(slot_idx, std::move(values)));
     }
     return zetasql_base::OkStatus();
   }
@@ -1868,20 +1982,38 @@ class AnalyticTupleIterator : public TupleIterator {
   std::unique_ptr<TupleIterator> input_iter_;
   std::unique_ptr<TupleComparator> partition_comparator_;
   std::unique_ptr<TupleSchema> output_schema_;
-  // The last tuple returned. NULL if Next() has never been called.
-  std::unique_ptr<TupleData> current_;
-  // The partition we are currently consuming, augmented by the values
-  // of the analytic arguments. Empty if Next() has never been called.
-  TupleDataDeque remaining_current_partition_;
-  // True if 'current_partition_' is the last one.
-  bool is_last_partition_ = false;
+  // The last tuple returned by Next().
+  TupleData current_;
   bool output_empty_ = true;
-  // NULL if we haven't loaded any partitions yet or 'is_last_partition_' is
+  // NULL if we haven't loaded any partitions yet or 'input_exhausted_' is
   // true.
   std::unique_ptr<TupleData> first_tuple_in_next_partition_;
+  // True after 'input_iter_' has returned NULL.
+  bool input_exhausted_ = false;
   EvaluationContext* context_;
   zetasql_base::Status status_;
   int64_t num_next_calls_ = 0;
+
+  // True if independent partitions are evaluated concurrently (see the class
+  // comment).
+  const bool parallel_;
+  // The maximum number of partitions being loaded or evaluated at once.
+  const size_t max_pending_partitions_;
+  // The slot index of the first analytic argument. Cached because worker
+  // tasks must not touch 'input_iter_' while the calling thread advances it.
+  const int first_analytic_arg_slot_;
+  // NULL unless parallel evaluations run on a shared scheduler.
+  WorkStealingScheduler::QueryHandle* query_handle_ = nullptr;
+  // Partitions in input order that have been loaded but not consumed.
+  // Only the calling thread modifies the deque itself; the 'status' and
+  // 'done' members of queued partitions are guarded by 'mutex_'.
+  std::deque<std::unique_ptr<PendingPartition>> pending_partitions_;
+  // The partition currently being consumed (fully evaluated).
+  std::unique_ptr<PendingPartition> current_partition_;
+  absl::Mutex mutex_;
+  // The number of evaluations queued or running on workers. Guarded by
+  // 'mutex_'.
+  int num_tasks_in_flight_ = 0;
 };
 }  // namespace
 
@@ -40,6 +40,7 @@
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/tuple_test_util.h"
 #include "zetasql/reference_impl/variable_id.h"
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/testing/using_test_value.cc"
 #include "gmock/gmock.h"
@@ -3524,5 +3525,235 @@ TEST_P(AnalyticOpTest, AnalyticOpTest) {
                        HasSubstr("Out of memory")));
 }
 
+// With max_intra_op_parallelism > 1 and a PARTITION BY, AnalyticTupleIterator
+// evaluates partitions on background threads (or on the shared scheduler) and
+// merges their output in partition order. The result must be identical to the
+// serial evaluation.
+TEST(AnalyticOpParallelismTest, ParallelPartitionsMatchSerialOutput) {
+  VariableId a("a"), b("b"), c("c");
+  VariableId rank("rank"), sum("sum");
+  const std::vector<VariableId> input_variables = {a, b, c};
+
+  // Enough partitions that the pipeline has to cycle: more partitions than the
+  // number of partitions it is allowed to evaluate concurrently.
+  const int kNumPartitions = 20;
+  const int kRowsPerPartition = 3;
+  std::vector<std::vector<Value>> input_values;
+  for (int p = 0; p < kNumPartitions; ++p) {
+    for (int i = 0; i < kRowsPerPartition; ++i) {
+      input_values.push_back(
+          {Int64(p), Int64(i), Int64(p * kRowsPerPartition + i)});
+    }
+  }
+  const std::vector<TupleData> input_tuples =
+      CreateTestTupleDatas(input_values);
+
+  // Builds RANK() and SUM(c) (over ROWS BETWEEN UNBOUNDED PRECEDING AND
+  // CURRENT ROW) partitioned by 'a' and ordered by 'b'. Recreated for each
+  // evaluation because AnalyticOp::Create() consumes its arguments.
+  auto create_analytic_op = [&]() -> std::unique_ptr<RelationalOp> {
+    auto input_op = absl::make_unique<TestRelationalOp>(
+        input_variables, input_tuples, /*preserves_order=*/true);
+
+    std::unique_ptr<AnalyticArg> rank_arg =
+        NonAggregateAnalyticArg::Create(
+            rank, nullptr /* window_frame */, absl::make_unique<RankFunction>(),
+            {} /* non_const_arguments */, {} /* const_arguments */,
+            DEFAULT_ERROR_MODE)
+            .ValueOrDie();
+
+    std::vector<std::unique_ptr<ValueExpr>> sum_args;
+    sum_args.push_back(DerefExpr::Create(c, Int64Type()).ValueOrDie());
+    std::unique_ptr<AggregateArg> agg =
+        AggregateArg::Create(sum,
+                             absl::make_unique<BuiltinAggregateFunction>(
+                                 FunctionKind::kSum, Int64Type(),
+                                 /*num_input_fields=*/1, Int64Type()),
+                             std::move(sum_args))
+            .ValueOrDie();
+    std::unique_ptr<AnalyticArg> sum_arg =
+        AggregateAnalyticArg::Create(
+            AnalyticWindowTest::CreateWindowFrameFromParam(
+                AnalyticWindowTest::CreateUnboundedPrecedingCurrentRow(
+                    WindowFrameArg::kRows)),
+            std::move(agg), DEFAULT_ERROR_MODE)
+            .ValueOrDie();
+
+    std::vector<std::unique_ptr<KeyArg>> partition_keys;
+    partition_keys.emplace_back(absl::make_unique<KeyArg>(
+        a, DerefExpr::Create(a, Int64Type()).ValueOrDie(),
+        KeyArg::kNotApplicable));
+    std::vector<std::unique_ptr<KeyArg>> order_keys;
+    order_keys.emplace_back(absl::make_unique<KeyArg>(
+        b, DerefExpr::Create(b, Int64Type()).ValueOrDie(), KeyArg::kAscending));
+
+    std::vector<std::unique_ptr<AnalyticArg>> analytic_args;
+    analytic_args.push_back(std::move(rank_arg));
+    analytic_args.push_back(std::move(sum_arg));
+
+    std::unique_ptr<RelationalOp> analytic_op =
+        AnalyticOp::Create(std::move(partition_keys), std::move(order_keys),
+                           std::move(analytic_args), std::move(input_op),
+                           /*preserves_order=*/true)
+            .ValueOrDie();
+    ZETASQL_EXPECT_OK(analytic_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+    return analytic_op;
+  };
+
+  const std::vector<VariableId> output_variables = {a, b, c, rank, sum};
+  const TupleSchema output_schema(output_variables);
+
+  auto evaluate = [&](const EvaluationOptions& options) {
+    EvaluationContext context(options);
+    std::unique_ptr<RelationalOp> analytic_op = create_analytic_op();
+    std::unique_ptr<TupleIterator> iter =
+        analytic_op
+            ->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context)
+            .ValueOrDie();
+    EXPECT_EQ(iter->DebugString(), "AnalyticTupleIterator(TestTupleIterator)");
+    std::vector<TupleData> data =
+        ReadFromTupleIterator(iter.get()).ValueOrDie();
+    std::vector<std::string> debug_strings;
+    debug_strings.reserve(data.size());
+    for (const TupleData& tuple : data) {
+      debug_strings.push_back(Tuple(&output_schema, &tuple).DebugString());
+    }
+    return debug_strings;
+  };
+
+  // Serial reference run.
+  const std::vector<std::string> expected = evaluate(EvaluationOptions());
+  ASSERT_EQ(expected.size(), kNumPartitions * kRowsPerPartition);
+
+  // Parallel mode with threads dedicated to this evaluation.
+  EvaluationOptions thread_options;
+  thread_options.max_intra_op_parallelism = 2;
+  EXPECT_THAT(evaluate(thread_options), ElementsAreArray(expected));
+
+  // Parallel mode with partitions evaluated as tasks on a shared scheduler.
+  EvaluationOptions scheduler_options;
+  scheduler_options.max_intra_op_parallelism = 4;
+  scheduler_options.scheduler = std::make_shared<WorkStealingScheduler>(
+      /*num_threads=*/2);
+  EXPECT_THAT(evaluate(scheduler_options), ElementsAreArray(expected));
+
+  // Destroying the iterator with partitions still in flight must not leave
+  // dangling background work.
+  EvaluationContext context(scheduler_options);
+  std::unique_ptr<RelationalOp> analytic_op = create_analytic_op();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      analytic_op->CreateIterator(EmptyParams(),
+                                  /*num_extra_slots=*/0, &context));
+  ASSERT_TRUE(iter->Next() != nullptr);
+  iter.reset();
+}
+
+// Exercises the incremental sliding-window evaluation in
+// AggregateArg::EvalAggOverWindows() for COUNT, SUM, MIN and MAX, including
+// NULL argument values and the NaN handling of MIN/MAX over doubles.
+TEST(SlidingWindowAggregationTest, CountSumMinMax) {
+  VariableId b("b"), c("c"), d("d");
+  VariableId count_c("count_c"), sum_c("sum_c"), min_c("min_c"),
+      max_c("max_c"), min_d("min_d"), max_d("max_d");
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<VariableId> input_variables = {b, c, d};
+  const std::vector<TupleData> input_tuples =
+      CreateTestTupleDatas({{Int64(1), NullInt64(), Double(1)},
+                            {Int64(2), Int64(5), Double(nan)},
+                            {Int64(3), Int64(1), Double(2)},
+                            {Int64(4), Int64(7), NullDouble()},
+                            {Int64(5), Int64(3), Double(0.5)}});
+  auto input_op = absl::make_unique<TestRelationalOp>(
+      input_variables, input_tuples, /*preserves_order=*/true);
+
+  // Builds <kind>(<arg>) OVER (ORDER BY b
+  //                            ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING).
+  const auto create_analytic_arg =
+      [](const VariableId& var, FunctionKind kind, const Type* input_type,
+         const VariableId& arg) -> std::unique_ptr<AnalyticArg> {
+    std::vector<std::unique_ptr<ValueExpr>> args;
+    args.push_back(DerefExpr::Create(arg, input_type).ValueOrDie());
+    const Type* output_type =
+        (kind == FunctionKind::kCount) ? Int64Type() : input_type;
+    auto agg = AggregateArg::Create(
+                   var,
+                   absl::make_unique<BuiltinAggregateFunction>(
+                       kind, output_type, /*num_input_fields=*/1, input_type),
+                   std::move(args))
+                   .ValueOrDie();
+    return AggregateAnalyticArg::Create(
+               AnalyticWindowTest::CreateWindowFrameFromParam(
+                   AnalyticWindowTest::CreateOffsetPrecedingOffsetFollowing(
+                       WindowFrameArg::kRows, 1, 1)),
+               std::move(agg), DEFAULT_ERROR_MODE)
+        .ValueOrDie();
+  };
+
+  std::vector<std::unique_ptr<AnalyticArg>> analytic_args;
+  analytic_args.push_back(
+      create_analytic_arg(count_c, FunctionKind::kCount, Int64Type(), c));
+  analytic_args.push_back(
+      create_analytic_arg(sum_c, FunctionKind::kSum, Int64Type(), c));
+  analytic_args.push_back(
+      create_analytic_arg(min_c, FunctionKind::kMin, Int64Type(), c));
+  analytic_args.push_back(
+      create_analytic_arg(max_c, FunctionKind::kMax, Int64Type(), c));
+  analytic_args.push_back(
+      create_analytic_arg(min_d, FunctionKind::kMin, DoubleType(), d));
+  analytic_args.push_back(
+      create_analytic_arg(max_d, FunctionKind::kMax, DoubleType(), d));
+
+  std::vector<std::unique_ptr<KeyArg>> order_keys;
+  order_keys.emplace_back(absl::make_unique<KeyArg>(
+      b, DerefExpr::Create(b, Int64Type()).ValueOrDie(), KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto analytic_op,
+      AnalyticOp::Create(/*partition_keys=*/{}, std::move(order_keys),
+                         std::move(analytic_args), std::move(input_op),
+                         /*preserves_order=*/true));
+  ZETASQL_ASSERT_OK(analytic_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  std::vector<VariableId> expected_variables = input_variables;
+  std::vector<TupleData> expected_tuples = input_tuples;
+
+  // c: {null, 5, 1, 7, 3}
+  AddColumn(count_c, {Int64(1), Int64(2), Int64(3), Int64(3), Int64(2)},
+            &expected_variables, &expected_tuples);
+  AddColumn(sum_c, {Int64(5), Int64(6), Int64(13), Int64(11), Int64(10)},
+            &expected_variables, &expected_tuples);
+  AddColumn(min_c, {Int64(5), Int64(1), Int64(1), Int64(1), Int64(3)},
+            &expected_variables, &expected_tuples);
+  AddColumn(max_c, {Int64(5), Int64(5), Int64(7), Int64(7), Int64(7)},
+            &expected_variables, &expected_tuples);
+
+  // d: {1, nan, 2, null, 0.5}. NaN is both the minimum and the maximum of any
+  // window that contains it.
+  AddColumn(min_d,
+            {Double(nan), Double(nan), Double(nan), Double(0.5), Double(0.5)},
+            &expected_variables, &expected_tuples);
+  AddColumn(max_d, {Double(nan), Double(nan), Double(nan), Double(2),
+                    Double(0.5)},
+            &expected_variables, &expected_tuples);
+
+  const TupleSchema expected_output_schema(expected_variables);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      analytic_op->CreateIterator(EmptyParams(),
+                                  /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), expected_tuples.size());
+  for (int i = 0; i < expected_tuples.size(); ++i) {
+    // Compare debug strings because NaN does not compare equal to itself.
+    EXPECT_EQ(Tuple(&expected_output_schema, &data[i]).DebugString(),
+              Tuple(&expected_output_schema, &expected_tuples[i]).DebugString())
+        << "row " << i;
+  }
+}
+
 }  // namespace
 }  // namespace zetasql
@@ -0,0 +1,141 @@
+#
+# Copyright 2019 ZetaSQL Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Compares two benchmark JSON result files and flags regressions.
+
+The benchmark binaries in this repository (e.g.
+//zetasql/reference_impl:function_benchmark,
+//zetasql/public:evaluator_benchmark) emit machine-readable results with the
+standard benchmark-library flags:
+
+  bazel run -c opt //zetasql/reference_impl:function_benchmark -- \\
+      --benchmark_format=json > baseline.json
+
+This tool compares a candidate run against a checked-in baseline produced the
+same way, and fails (exit code 1) if any benchmark's time per operation, or
+any compared counter (by default allocs_per_op and alloc_bytes_per_op),
+regressed by more than --threshold_percent:
+
+  bazel run //zetasql/reference_impl:benchmark_compare -- \\
+      --baseline=baseline.json --candidate=candidate.json \\
+      --threshold_percent=5
+
+Benchmarks present in only one of the two files are reported but do not fail
+the comparison, so benchmarks can be added or retired without updating the
+baseline in the same change.
+"""
+
+import json
+
+from absl import app
+from absl import flags
+
+FLAGS = flags.FLAGS
+
+flags.DEFINE_string('baseline', None,
+                    'Path to the baseline benchmark JSON file.')
+flags.DEFINE_string('candidate', None,
+                    'Path to the candidate benchmark JSON file.')
+flags.DEFINE_float(
+    'threshold_percent', 5.0,
+    'Fail if a metric regressed by more than this percentage.')
+flags.DEFINE_list(
+    'counters', ['allocs_per_op', 'alloc_bytes_per_op'],
+    'Per-benchmark counters to compare, in addition to time per operation. '
+    'Counters missing from a benchmark are skipped.')
+
+flags.mark_flag_as_required('baseline')
+flags.mark_flag_as_required('candidate')
+
+
+def _load_benchmarks(path):
+  """Returns {benchmark name: benchmark result dict} from a JSON file."""
+  with open(path) as f:
+    data = json.load(f)
+  benchmarks = {}
+  for benchmark in data.get('benchmarks', []):
+    # Skip aggregate rows (mean/median/stddev of repetitions); compare the
+    # aggregate-free names so repetition counts need not match.
+    if benchmark.get('run_type') == 'aggregate':
+      continue
+    benchmarks[benchmark['name']] = benchmark
+  return benchmarks
+
+
+def _metrics(benchmark, counters):
+  """Returns {metric name: value} for the metrics we compare.
+
+  Time per operation is normalized to nanoseconds regardless of the
+  time_unit the benchmark reported in.
+  """
+  to_nanos = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+  scale = to_nanos[benchmark.get('time_unit', 'ns')]
+  metrics = {'cpu_ns_per_op': benchmark['cpu_time'] * scale}
+  for counter in counters:
+    if counter in benchmark:
+      metrics[counter] = benchmark[counter]
+  return metrics
+
+
+def _format_change(baseline_value, candidate_value):
+  if baseline_value == 0:
+    return 'baseline=0'
+  change = 100.0 * (candidate_value - baseline_value) / baseline_value
+  return '%+.1f%% (%g -> %g)' % (change, baseline_value, candidate_value)
+
+
+def main(argv):
+  if len(argv) > 1:
+    raise app.UsageError('Too many command-line arguments.')
+
+  baseline = _load_benchmarks(FLAGS.baseline)
+  candidate = _load_benchmarks(FLAGS.candidate)
+
+  only_baseline = sorted(set(baseline) - set(candidate))
+  only_candidate = sorted(set(candidate) - set(baseline))
+  for name in only_baseline:
+    print('MISSING (in baseline only): %s' % name)
+  for name in only_candidate:
+    print('NEW (in candidate only): %s' % name)
+
+  regressions = []
+  for name in sorted(set(baseline) & set(candidate)):
+    baseline_metrics = _metrics(baseline[name], FLAGS.counters)
+    candidate_metrics = _metrics(candidate[name], FLAGS.counters)
+    for metric in sorted(baseline_metrics):
+      if metric not in candidate_metrics:
+        continue
+      baseline_value = baseline_metrics[metric]
+      candidate_value = candidate_metrics[metric]
+      change = _format_change(baseline_value, candidate_value)
+      if (baseline_value > 0 and
+          candidate_value > baseline_value *
+          (1 + FLAGS.threshold_percent / 100.0)):
+        regressions.append('%s %s: %s' % (name, metric, change))
+        print('REGRESSION: %s %s: %s' % (name, metric, change))
+      else:
+        print('ok: %s %s: %s' % (name, metric, change))
+
+  if regressions:
+    print('\n%d metric(s) regressed by more than %g%%.' %
+          (len(regressions), FLAGS.threshold_percent))
+    return 1
+  print('\nNo regressions above %g%%.' % FLAGS.threshold_percent)
+  return 0
+
+
+if __name__ == '__main__':
+  app.run(main)
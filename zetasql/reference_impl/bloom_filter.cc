@@ -0,0 +1,60 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/bloom_filter.h"
+
+#include <algorithm>
+
+#include "zetasql/base/logging.h"
+
+namespace zetasql {
+
+BloomFilter::BloomFilter(int64_t expected_entries) {
+  DCHECK_GE(expected_entries, 0);
+  // Allocate about 10 bits per expected entry, rounded up to a power of two
+  // (and at least one word) so that a bit index is a simple mask of the hash.
+  uint64_t num_bits = 64;
+  while (num_bits < static_cast<uint64_t>(expected_entries) * 10) {
+    num_bits *= 2;
+  }
+  bit_index_mask_ = num_bits - 1;
+  bits_.resize(num_bits / 64, 0);
+}
+
+void BloomFilter::Insert(uint64_t hash) {
+  // Double hashing: derive the probe stride from the high bits of the hash,
+  // which the masking below would otherwise ignore. The stride is forced to
+  // be odd so that it is coprime with the power-of-two filter size and the
+  // probes do not cycle through a subset of the bits.
+  const uint64_t stride = (hash >> 32) | 1;
+  for (int i = 0; i < kNumProbes; ++i) {
+    const uint64_t bit = (hash + i * stride) & bit_index_mask_;
+    bits_[bit / 64] |= uint64_t{1} << (bit % 64);
+  }
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  const uint64_t stride = (hash >> 32) | 1;
+  for (int i = 0; i < kNumProbes; ++i) {
+    const uint64_t bit = (hash + i * stride) & bit_index_mask_;
+    if ((bits_[bit / 64] & (uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace zetasql
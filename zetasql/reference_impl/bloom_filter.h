@@ -0,0 +1,62 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_REFERENCE_IMPL_BLOOM_FILTER_H_
+#define ZETASQL_REFERENCE_IMPL_BLOOM_FILTER_H_
+
+#include <vector>
+
+#include <cstdint>
+
+namespace zetasql {
+
+// A Bloom filter over 64-bit hash values. MayContain() always returns true
+// for a hash that was inserted, and returns true with small probability
+// (roughly 1%) for a hash that was not. It is intended as a small,
+// cache-resident pre-filter in front of an exact (and typically much larger)
+// hash set: a negative answer skips the exact probe entirely.
+class BloomFilter {
+ public:
+  // Creates a filter sized for 'expected_entries' insertions.
+  explicit BloomFilter(int64_t expected_entries);
+  BloomFilter(const BloomFilter&) = delete;
+  BloomFilter& operator=(const BloomFilter&) = delete;
+
+  void Insert(uint64_t hash);
+
+  bool MayContain(uint64_t hash) const;
+
+  // The size of the bit array in bytes, for memory accounting.
+  int64_t num_bytes() const {
+    return static_cast<int64_t>(bits_.size()) * sizeof(uint64_t);
+  }
+
+ private:
+  // The number of bits set/tested per hash. Together with the ~10 bits
+  // allocated per expected entry, this gives a false positive rate of
+  // roughly 1%.
+  static const int kNumProbes = 7;
+
+  // The number of bits in the filter minus one. The number of bits is a power
+  // of two so that masking with this value reduces a hash to a bit index.
+  uint64_t bit_index_mask_;
+
+  std::vector<uint64_t> bits_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_BLOOM_FILTER_H_
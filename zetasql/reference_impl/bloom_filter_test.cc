@@ -0,0 +1,75 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/bloom_filter.h"
+
+#include "gtest/gtest.h"
+
+namespace zetasql {
+namespace {
+
+// A cheap 64-bit mixer so that the test probes the filter with well-spread
+// hashes, as Value::HashCode() would.
+static uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+  const int kNumEntries = 10000;
+  BloomFilter filter(kNumEntries);
+  for (int i = 0; i < kNumEntries; ++i) {
+    filter.Insert(Mix(i));
+  }
+  for (int i = 0; i < kNumEntries; ++i) {
+    EXPECT_TRUE(filter.MayContain(Mix(i))) << i;
+  }
+}
+
+TEST(BloomFilterTest, FewFalsePositives) {
+  const int kNumEntries = 10000;
+  BloomFilter filter(kNumEntries);
+  for (int i = 0; i < kNumEntries; ++i) {
+    filter.Insert(Mix(i));
+  }
+  int num_false_positives = 0;
+  for (int i = kNumEntries; i < 2 * kNumEntries; ++i) {
+    if (filter.MayContain(Mix(i))) ++num_false_positives;
+  }
+  // The filter is sized for a false positive rate of roughly 1%; leave ample
+  // headroom so the test is not flaky.
+  EXPECT_LT(num_false_positives, kNumEntries / 20);
+}
+
+TEST(BloomFilterTest, EmptyFilterContainsNothing) {
+  BloomFilter filter(/*expected_entries=*/0);
+  int num_false_positives = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (filter.MayContain(Mix(i))) ++num_false_positives;
+  }
+  EXPECT_EQ(num_false_positives, 0);
+}
+
+TEST(BloomFilterTest, SizeGrowsWithExpectedEntries) {
+  EXPECT_LT(BloomFilter(10).num_bytes(), BloomFilter(100000).num_bytes());
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -16,10 +16,12 @@
 
 #include "zetasql/reference_impl/evaluation.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/common/errors.h"
 #include "zetasql/common/internal_value.h"
 #include "zetasql/public/functions/date_time_util.h"
 #include "zetasql/public/functions/datetime.pb.h"
@@ -73,7 +75,7 @@ zetasql_base::Status ValidateFirstColumnPrimaryKey(
       return ::zetasql_base::InvalidArgumentErrorBuilder()
              << "The first column of table " << table_name
              << " has duplicate Value "
-             << first_column.DebugString(true /* verbose */);
+             << first_column.CappedDebugString(true /* verbose */);
     }
   }
 
@@ -82,7 +84,8 @@ zetasql_base::Status ValidateFirstColumnPrimaryKey(
 
 EvaluationContext::EvaluationContext(const EvaluationOptions& options)
     : options_(options),
-      memory_accountant_(options.max_intermediate_byte_size),
+      memory_accountant_(options.max_intermediate_byte_size,
+                         options.shared_memory_pool),
       deterministic_output_(true) {}
 
 ::zetasql_base::Status EvaluationContext::AddTableAsArray(
@@ -104,7 +107,53 @@ EvaluationContext::EvaluationContext(const EvaluationOptions& options)
   return zetasql_base::OkStatus();
 }
 
+::zetasql_base::StatusOr<std::shared_ptr<const RE2>>
+EvaluationContext::GetOrCreateCompiledRegexp(absl::string_view pattern) {
+  const auto it = compiled_regexps_.find(pattern);
+  if (it != compiled_regexps_.end()) {
+    return it->second;
+  }
+  auto regexp = std::make_shared<const RE2>(
+      re2::StringPiece(pattern.data(), pattern.size()), RE2::Quiet);
+  if (!regexp->ok()) {
+    return MakeEvalError() << "Cannot parse regular expression: "
+                           << regexp->error();
+  }
+  if (compiled_regexps_.size() < kMaxCompiledRegexps) {
+    compiled_regexps_.emplace(std::string(pattern), regexp);
+  }
+  return regexp;
+}
+
+::zetasql_base::StatusOr<std::shared_ptr<const ProtoWireOffsetIndex>>
+EvaluationContext::GetProtoWireOffsetIndex(const Value& value) {
+  const InternalValue::ProtoRep* proto_rep = InternalValue::GetProtoRep(value);
+  ZETASQL_RET_CHECK(proto_rep != nullptr);
+  const auto it = proto_wire_offset_indexes_.find(proto_rep);
+  if (it == proto_wire_offset_indexes_.end()) {
+    // First read of this message: just remember it. An index is only worth
+    // building if the message is read again.
+    if (proto_wire_offset_indexes_.size() < kMaxProtoWireOffsetIndexes) {
+      proto_wire_offset_indexes_.emplace(
+          proto_rep,
+          std::make_pair(value, std::shared_ptr<ProtoWireOffsetIndex>()));
+    }
+    return std::shared_ptr<const ProtoWireOffsetIndex>();
+  }
+  if (it->second.second == nullptr) {
+    auto index = std::make_shared<ProtoWireOffsetIndex>();
+    ZETASQL_RETURN_IF_ERROR(BuildProtoWireOffsetIndex(value.ToCord(), index.get()));
+    it->second.second = std::move(index);
+  }
+  return std::shared_ptr<const ProtoWireOffsetIndex>(it->second.second);
+}
+
 zetasql_base::Status EvaluationContext::VerifyNotAborted() const {
+  // Yield before checking for cancellation so that a scheduler that suspends
+  // the statement in the callback can cancel it before resuming.
+  if (yield_cb_ != nullptr) {
+    yield_cb_();
+  }
   if (cancelled_) {
     return zetasql_base::CancelledErrorBuilder() << "The statement has been cancelled";
   }
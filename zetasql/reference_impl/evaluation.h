@@ -17,25 +17,34 @@
 #ifndef ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 #define ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "zetasql/common/internal_value.h"
 #include "zetasql/public/civil_time.h"
 #include "zetasql/public/language_options.h"
+#include "zetasql/public/proto_util.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/tuple.h"
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include <cstdint>
 #include "absl/container/flat_hash_map.h"
 #include "absl/flags/declare.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/status.h"
+#include "zetasql/base/statusor.h"
 #include "zetasql/base/clock.h"
+#include "re2/re2.h"
 
 // See description in the cc file.
 ABSL_DECLARE_FLAG(int64_t, zetasql_call_verify_not_aborted_rows_period);
@@ -64,6 +73,15 @@ struct EvaluationOptions {
   // ReorderingTupleIterator in tuple.h for details.
   bool scramble_undefined_orderings = false;
 
+  // If true, the reference implementation skips the bookkeeping that tracks
+  // whether the output of evaluation is deterministic under ZetaSQL semantics
+  // (e.g., checking whether sorted tuples are uniquely ordered). This saves a
+  // linear pass over the buffered tuples in some operators, but it makes
+  // EvaluationContext::IsDeterministicOutput() meaningless, so it must not be
+  // set for compliance and random query tests or for any other caller that
+  // reads that bit.
+  bool skip_determinism_tracking = false;
+
   // If true, the reference implementation will always perform stable sorting
   // where sorting is required. This is useful for obtaining deterministic
   // results in the (text-based) reference implementation compliance tests,
@@ -81,6 +99,48 @@ struct EvaluationOptions {
   // always says its results are ordered according to ZetaSQL semantics.
   bool use_top_n_accumulator_when_possible = false;
 
+  // If true, an ORDER BY without a limit may spill sorted runs of tuples to
+  // temporary files when accumulating them would exceed
+  // 'max_intermediate_byte_size', and then stream a merge of the runs. This
+  // allows sorting inputs that do not fit in the intermediate memory budget.
+  // Not safe to use in compliance or random query tests because the merged
+  // output always says it is ordered according to ZetaSQL semantics.
+  bool allow_sort_spill_to_disk = false;
+
+  // If true, GROUP BY aggregation may switch to two-phase processing when
+  // creating a new group would exceed 'max_intermediate_byte_size': rows of
+  // groups that do not fit are radix-partitioned by grouping-key hash into
+  // temporary files, and each partition (holding a fraction of the remaining
+  // groups) is aggregated on its own after the in-memory groups are
+  // finalized. This allows GROUP BY with more groups than fit in the
+  // intermediate memory budget. See AggregateOp::CreateIterator for details.
+  bool allow_aggregation_spill_to_disk = false;
+
+  // The maximum number of threads that may be used to evaluate a single
+  // operation. If greater than 1, table scans prefetch rows on a background
+  // thread while the rest of the plan executes on the calling thread. See
+  // PrefetchingTupleIterator in relational_op.cc for details.
+  int64_t max_intra_op_parallelism = 1;
+
+  // The maximum number of rows a prefetching table scan (enabled by
+  // 'max_intra_op_parallelism' above) keeps buffered ahead of the consumer.
+  // Deeper queues ride out longer stalls in the underlying
+  // EvaluatorTableIterator (e.g., one that fetches from remote storage) at
+  // the cost of buffering more untracked rows. Values less than 1 are
+  // treated as 1.
+  int64_t scan_prefetch_queue_size = 64;
+
+  // If non-NULL, background work enabled by 'max_intra_op_parallelism' runs
+  // as tasks on this shared scheduler instead of on threads dedicated to this
+  // evaluation, so many concurrent evaluations multiplex their background
+  // work over one fixed pool. 'scheduler_weight' (which must be positive)
+  // sets this evaluation's share of the pool relative to the other
+  // evaluations registered with the scheduler. The scheduler must outlive the
+  // EvaluationContext (the shared_ptr ensures this for the common case of
+  // per-query contexts sharing a process-wide scheduler).
+  std::shared_ptr<WorkStealingScheduler> scheduler;
+  double scheduler_weight = 1.0;
+
   // Limit on the maximum number of in-memory bytes used by values. Exceeding
   // this limit results in an error. See the implementation of
   // Value::physical_byte_size for more details.
@@ -90,9 +150,23 @@ struct EvaluationOptions {
   // storing accumulated Tuples (e.g., during an ORDER BY query). Exceeding this
   // limit results in an error.
   int64_t max_intermediate_byte_size = 128 * 1024 * 1024;
+
+  // If non-NULL, the intermediate memory budget is drawn from this pool
+  // (ignoring 'max_intermediate_byte_size') so that multiple evaluations, each
+  // with its own EvaluationContext, can share one budget. The pool must
+  // outlive the EvaluationContext. See SharedMemoryPool in tuple.h.
+  SharedMemoryPool* shared_memory_pool = nullptr;
+
+  // If true, the EvaluationContext accumulates per-operator runtime counters
+  // (iterators created, rows and batches returned, cumulative time) while
+  // iterators run. See EvaluationContext::operator_stats() and
+  // RelationalOp::MaybeProfile() in operator.h. Adds a clock read per
+  // returned row, so it is off by default.
+  bool collect_operator_stats = false;
 };
 
 class ProtoFieldReader;
+class RelationalOp;
 
 // Contains state about the evaluation in progress.
 class EvaluationContext {
@@ -102,6 +176,10 @@ class EvaluationContext {
   // for a long time.
   using CancelCallback = std::function<zetasql_base::Status()>;
 
+  // A YieldCallback is invoked periodically from within evaluation at points
+  // where it is safe to suspend the calling thread. See SetYieldCallback().
+  using YieldCallback = std::function<void()>;
+
   explicit EvaluationContext(const EvaluationOptions& options);
   EvaluationContext(const EvaluationContext&) = delete;
   EvaluationContext& operator=(const EvaluationContext&) = delete;
@@ -109,6 +187,34 @@ class EvaluationContext {
   const EvaluationOptions& options() const { return options_; }
 
   MemoryAccountant* memory_accountant() { return &memory_accountant_; }
+  const MemoryAccountant* memory_accountant() const {
+    return &memory_accountant_;
+  }
+
+  // Runtime counters for one RelationalOp, accumulated across all of the
+  // iterators the operator creates during evaluation (an operator on the
+  // right-hand side of a correlated join can create many). Only populated if
+  // 'options().collect_operator_stats' is true.
+  struct OperatorStats {
+    int64_t num_iterators_created = 0;
+    // Tuples and non-empty batches returned by the operator's iterators.
+    int64_t num_output_rows = 0;
+    int64_t num_output_batches = 0;
+    // Wall time spent inside Next()/NextBatch(), including time spent in the
+    // operator's inputs.
+    int64_t cumulative_nanos = 0;
+  };
+
+  // Returns the stats for 'op', creating a zeroed entry if necessary. The
+  // returned pointer remains valid for the life of this EvaluationContext.
+  OperatorStats* mutable_operator_stats(const RelationalOp* op) {
+    return &operator_stats_[op];
+  }
+
+  // The stats collected so far for each profiled operator.
+  const std::map<const RelationalOp*, OperatorStats>& operator_stats() const {
+    return operator_stats_;
+  }
 
   // Returns the contents of table 'table_name' or Value::Invalid().
   Value GetTableAsArray(const std::string& table_name) {
@@ -124,6 +230,28 @@ class EvaluationContext {
                                  bool is_value_table, Value array,
                                  const LanguageOptions& language_options);
 
+  // Returns a compiled regular expression for 'pattern', compiling it on first
+  // use and serving repeat requests from a cache owned by this context.
+  // Functions whose pattern argument is not constant (and thus cannot compile
+  // it at algebrization time) would otherwise recompile the same pattern for
+  // every row. Returns an error if 'pattern' is not a valid re2 pattern.
+  ::zetasql_base::StatusOr<std::shared_ptr<const RE2>> GetOrCreateCompiledRegexp(
+      absl::string_view pattern);
+
+  // Returns the wire-format offset index for 'value' (which must be a
+  // non-NULL proto), or nullptr if one should not be used. The first request
+  // for a given message returns nullptr so that messages read only once pay
+  // nothing; from the second request on, an index is built (once) and
+  // returned, letting readers jump directly to the fields they need instead
+  // of re-scanning the message from byte 0 for every distinct field set. Each
+  // cache entry holds a reference to 'value', so its internally
+  // reference-counted representation (which serves as the cache key) cannot
+  // be freed and reused while this context is alive. Bounded by
+  // kMaxProtoWireOffsetIndexes; messages seen after the cache fills up always
+  // get nullptr.
+  ::zetasql_base::StatusOr<std::shared_ptr<const ProtoWireOffsetIndex>>
+  GetProtoWireOffsetIndex(const Value& value);
+
   // Indicates that the result of evaluation is non-deterministic.
   void SetNonDeterministicOutput() { deterministic_output_ = false; }
 
@@ -215,25 +343,57 @@ class EvaluationContext {
     return statement_eval_deadline_;
   }
 
-  // Register a callback to be notified when CancelStatement() is called. As
-  // with all non-const methods in this thread compatible class, using this
-  // method in a multithreaded setting requires external synchronization of
-  // this object. In practice, this is called by iterators that need to
-  // propagate the cancellation request to user code.
+  // Register a callback to be notified when CancelStatement() is called. In
+  // practice, this is called by iterators that need to propagate the
+  // cancellation request to user code. Unlike most of this thread compatible
+  // class, the callback list is guarded by a mutex so that registration (which
+  // happens on the evaluation thread as iterators are created) is safe against
+  // a concurrent CancelStatement() from another thread. The callback itself
+  // may be invoked from the cancelling thread, so it must be thread-safe.
   void RegisterCancelCallback(const CancelCallback& cb) {
+    absl::MutexLock l(&cancel_mutex_);
     cancel_cbs_.push_back(cb);
   }
 
+  // Sets a callback that is invoked by VerifyNotAborted(), which iterators
+  // call periodically (every FLAGS_zetasql_call_verify_not_aborted_rows_period
+  // rows) while evaluation is in progress. Evaluation is fundamentally
+  // synchronous, but a caller that multiplexes many concurrent evaluations
+  // over a small number of threads (e.g., on fibers or another userspace
+  // scheduler) can use the callback to yield the calling thread between rows
+  // instead of blocking it for the life of the statement. The callback must
+  // return on the same thread it was invoked on; the cancellation and deadline
+  // checks run immediately after it returns, so a scheduler can abort a
+  // suspended statement by cancelling it before resuming.
+  void SetYieldCallback(const YieldCallback& cb) { yield_cb_ = cb; }
+
+  // Returns the handle that schedules this evaluation's background work on
+  // 'options().scheduler', registering this evaluation with the scheduler
+  // (at 'options().scheduler_weight') on the first call. Returns NULL if no
+  // scheduler is configured.
+  WorkStealingScheduler::QueryHandle* scheduler_query_handle() {
+    if (scheduler_query_handle_ == nullptr && options_.scheduler != nullptr) {
+      scheduler_query_handle_ =
+          options_.scheduler->RegisterQuery(options_.scheduler_weight);
+    }
+    return scheduler_query_handle_.get();
+  }
+
   // Cancels the current statement and invokes all of the cancellation
-  // callbacks. Cancellation support is best-effort, in that iterators should be
-  // periodicially polling the cancellation state (by calling VerifyNotAborted)
-  // and cancelling if they discover the statement has been cancelled. The
-  // callbacks are just a way of notifying user code that the statement has been
-  // cancelled if we are stuck in a user's EvaluatorTableIterator.
+  // callbacks. Unlike the rest of this thread compatible class, this method
+  // may be called from another thread while evaluation is in progress: the
+  // cancellation flag is atomic and the callback list is guarded by a mutex.
+  // Iterators poll the flag (by calling VerifyNotAborted()) at least once per
+  // FLAGS_zetasql_call_verify_not_aborted_rows_period rows of work, so the
+  // latency between cancellation and the evaluation actually stopping is
+  // bounded by roughly that many rows of work per operator. The callbacks are
+  // just a way of notifying user code that the statement has been cancelled if
+  // we are stuck in a user's EvaluatorTableIterator.
   ::zetasql_base::Status CancelStatement() {
     cancelled_ = true;
     // Call all the callbacks, returning the first non-OK error code.
     zetasql_base::Status ret = zetasql_base::OkStatus();
+    absl::MutexLock l(&cancel_mutex_);
     for (const CancelCallback& cb : cancel_cbs_) {
       zetasql_base::Status status = cb();
       if (ret.ok() && !status.ok()) {
@@ -248,11 +408,16 @@ class EvaluationContext {
   void ClearDeadlineAndCancellationState() {
     SetStatementEvaluationDeadline(absl::InfiniteFuture());
     cancelled_ = false;
+    absl::MutexLock l(&cancel_mutex_);
     cancel_cbs_.clear();
   }
 
-  // Returns an error if the statement has been aborted. This function is
-  // expensive (it gets the current time).
+  // Returns an error if the statement has been aborted. Also invokes the yield
+  // callback, if one is set; see SetYieldCallback(). This function is
+  // expensive (it gets the current time), which is why iterators only call it
+  // every FLAGS_zetasql_call_verify_not_aborted_rows_period rows. Any loop
+  // that can do a lot of work without pulling rows through another iterator
+  // (materializing, spilling, draining) must make its own periodic calls.
   ::zetasql_base::Status VerifyNotAborted() const;
 
   int num_proto_deserializations() const { return num_proto_deserializations_; }
@@ -311,13 +476,43 @@ class EvaluationContext {
   MemoryAccountant memory_accountant_;
   // Tables added by AddTableAsArray().
   std::map<std::string, Value> tables_;
-  // Indicates that the result of evaluation is non-deterministic.
-  bool deterministic_output_;
+  // Compiled regular expressions cached by GetOrCreateCompiledRegexp(), keyed
+  // by pattern text. Bounded by kMaxCompiledRegexps; patterns compiled after
+  // the cache fills up are returned without being cached.
+  static constexpr int kMaxCompiledRegexps = 1000;
+  absl::flat_hash_map<std::string, std::shared_ptr<const RE2>>
+      compiled_regexps_;
+  // Proto values whose fields have been read at least once, keyed by their
+  // reference-counted representation. The index (second member) is built
+  // lazily on the second read; the stored Value keeps the key alive. See
+  // GetProtoWireOffsetIndex().
+  static constexpr int kMaxProtoWireOffsetIndexes = 1000;
+  absl::flat_hash_map<const InternalValue::ProtoRep*,
+                      std::pair<Value, std::shared_ptr<ProtoWireOffsetIndex>>>
+      proto_wire_offset_indexes_;
+  // Indicates that the result of evaluation is non-deterministic. Atomic
+  // because background partition evaluations (see AnalyticOp) may report
+  // non-determinism from worker threads.
+  std::atomic<bool> deterministic_output_;
   LanguageOptions language_options_;
   // Default is no deadline.
   absl::Time statement_eval_deadline_ = absl::InfiniteFuture();
-  bool cancelled_ = false;
+  // Atomic because CancelStatement() may set it from another thread while the
+  // evaluation thread polls it through VerifyNotAborted().
+  std::atomic<bool> cancelled_{false};
+  // Guards 'cancel_cbs_' against RegisterCancelCallback() racing with
+  // CancelStatement() from another thread.
+  absl::Mutex cancel_mutex_;
   std::vector<CancelCallback> cancel_cbs_;
+  YieldCallback yield_cb_;  // may be null
+  // Lazily created by scheduler_query_handle(). 'options_.scheduler' is
+  // declared above, so it outlives the handle; iterators that schedule tasks
+  // wait for them before they are destroyed, so the handle's destructor does
+  // not block on iterator work.
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> scheduler_query_handle_;
+  // std::map (rather than a hash map) because entries must not move: iterators
+  // hold pointers into this map while they run.
+  std::map<const RelationalOp*, OperatorStats> operator_stats_;
 
   // Used to obtain the current timestamp.
   zetasql_base::Clock* clock_ = zetasql_base::Clock::RealClock();
@@ -344,8 +539,10 @@ class EvaluationContext {
   absl::flat_hash_map<const ProtoFieldReader*, bool>
       last_get_field_value_call_read_fields_from_proto_map_;
 
-  // Records whether a TopNAccumulator was used. Only for unit tests.
-  bool used_top_n_accumulator_ = false;
+  // Records whether a TopNAccumulator was used. Only for unit tests. Atomic
+  // because accumulators may be created by background partition evaluations
+  // (see AnalyticOp).
+  std::atomic<bool> used_top_n_accumulator_{false};
 };
 
 // Returns true if we should suppress 'error' (which must not be OK) in
@@ -666,6 +666,19 @@ std::unique_ptr<BuiltinScalarFunction> BuiltinScalarFunction::CreateUnvalidated(
   return std::move(result.ValueOrDie());
 }
 
+// Returns a pre-parsed format plan if the first argument of 'arguments' (the
+// format string) is a non-null string constant, or NULL otherwise.
+static std::unique_ptr<const functions::DateTimestampFormatPlan>
+MaybeCreateFormatPlan(const std::vector<std::unique_ptr<ValueExpr>>& arguments,
+                      functions::DateTimestampFormatPlan::Mode mode) {
+  if (arguments.empty() || !arguments[0]->IsConstant()) return nullptr;
+  const Value& format =
+      static_cast<const ConstExpr*>(arguments[0].get())->value();
+  if (format.is_null() || !format.type()->IsString()) return nullptr;
+  return absl::make_unique<const functions::DateTimestampFormatPlan>(
+      mode, format.string_value());
+}
+
 zetasql_base::StatusOr<BuiltinScalarFunction*>
 BuiltinScalarFunction::CreateValidatedRaw(
     FunctionKind kind, const LanguageOptions& language_options,
@@ -774,13 +787,19 @@ BuiltinScalarFunction::CreateValidatedRaw(
     case FunctionKind::kExtractDatetimeFrom:
       return new ExtractDatetimeFromFunction(kind, output_type);
     case FunctionKind::kFormatDate:
-      return new FormatDateFunction(kind, output_type);
+      return new FormatDateFunction(
+          kind, output_type,
+          MaybeCreateFormatPlan(
+              arguments, functions::DateTimestampFormatPlan::Mode::kDate));
     case FunctionKind::kFormatDatetime:
       return new FormatDatetimeFunction(kind, output_type);
     case FunctionKind::kFormatTime:
       return new FormatTimeFunction(kind, output_type);
     case FunctionKind::kFormatTimestamp:
-      return new FormatTimestampFunction(kind, output_type);
+      return new FormatTimestampFunction(
+          kind, output_type,
+          MaybeCreateFormatPlan(
+              arguments, functions::DateTimestampFormatPlan::Mode::kTimestamp));
     case FunctionKind::kTimestamp:
       return new TimestampConversionFunction(kind, output_type);
     case FunctionKind::kDate:
@@ -1387,6 +1406,17 @@ zetasql_base::StatusOr<Value> CastFunction::Eval(absl::Span<const Value> args,
   return status_or;
 }
 
+Value LogicalFunction::ShortCircuitValue() const {
+  switch (kind()) {
+    case FunctionKind::kAnd:
+      return Value::Bool(false);
+    case FunctionKind::kOr:
+      return Value::Bool(true);
+    default:
+      return Value();
+  }
+}
+
 bool LogicalFunction::Eval(absl::Span<const Value> args,
                            EvaluationContext* context, Value* result,
                            ::zetasql_base::Status* status) const {
@@ -1449,6 +1479,53 @@ namespace {
 // does an OR of all input values including NULLs and returns false for empty
 // input.
 
+// Accumulates Values in fixed-size chunks so that appending never relocates
+// previously accumulated values, unlike a single std::vector whose doubling
+// growth moves every element on each reallocation. ConsumeValues() assembles
+// the chunks into one vector with a single exact-sized allocation. Large
+// ARRAY_AGG and STRING_AGG groups otherwise spend most of their time in
+// realloc+copy.
+class ChunkedValueList {
+ public:
+  void push_back(const Value& value) {
+    if (chunks_.empty() || chunks_.back().size() == kChunkSize) {
+      chunks_.emplace_back();
+      chunks_.back().reserve(kChunkSize);
+    }
+    chunks_.back().push_back(value);
+    ++num_values_;
+  }
+
+  bool empty() const { return num_values_ == 0; }
+
+  int64_t num_values() const { return num_values_; }
+
+  const std::vector<std::vector<Value>>& chunks() const { return chunks_; }
+
+  void clear() {
+    chunks_.clear();
+    num_values_ = 0;
+  }
+
+  // Moves the accumulated values into a single vector, leaving this list
+  // empty.
+  std::vector<Value> ConsumeValues() {
+    std::vector<Value> values;
+    values.reserve(num_values_);
+    for (std::vector<Value>& chunk : chunks_) {
+      std::move(chunk.begin(), chunk.end(), std::back_inserter(values));
+    }
+    clear();
+    return values;
+  }
+
+ private:
+  static const int kChunkSize = 1024;
+
+  std::vector<std::vector<Value>> chunks_;
+  int64_t num_values_ = 0;
+};
+
 // Accumulator implementation for BuiltinAggregateFunction.
 class BuiltinAggregateAccumulator : public AggregateAccumulator {
  public:
@@ -1493,6 +1570,11 @@ class BuiltinAggregateAccumulator : public AggregateAccumulator {
 
   ::zetasql_base::StatusOr<Value> GetFinalResultInternal(bool inputs_in_defined_order);
 
+  // Joins the STRING_AGG pieces with the delimiter into a single string
+  // reserved from the tracked cumulative length. 'kind' is TYPE_STRING or
+  // TYPE_BYTES.
+  std::string JoinStringAggPieces(TypeKind kind) const;
+
   MemoryAccountant* accountant() { return context_->memory_accountant(); }
 
   const BuiltinAggregateFunction* function_;
@@ -1517,8 +1599,13 @@ class BuiltinAggregateAccumulator : public AggregateAccumulator {
   unsigned __int128 out_uint128_ = 0;  // Sum
   NumericValue out_numeric_;           // Min, Max
   NumericValue::Aggregator numeric_aggregator_;  // Avg, Sum
-  std::string out_string_ = "";                  // Max, Min, StringAgg
+  std::string out_string_ = "";                  // Max, Min
   std::string delimiter_ = ",";                  // StringAgg
+  // StringAgg: the input pieces are kept in chunks (copying a string Value
+  // only increments a refcount) and joined once at finalization.
+  ChunkedValueList string_agg_pieces_;
+  // Cumulative length of the final STRING_AGG result, including delimiters.
+  int64_t string_agg_num_bytes_ = 0;
   // OrAgg, AndAgg, LogicalOr, LogicalAnd.
   bool has_null_ = false;
   bool has_true_ = false;
@@ -1528,7 +1615,7 @@ class BuiltinAggregateAccumulator : public AggregateAccumulator {
   int64_t bit_int64_ = 0;
   uint32_t bit_uint32_ = 0;
   uint64_t bit_uint64_ = 0;
-  std::vector<Value> array_agg_;  // ArrayAgg and ArrayConcatAgg.
+  ChunkedValueList array_agg_;  // ArrayAgg and ArrayConcatAgg.
   // An output array for Min, Max.
   Value min_max_out_array_;
 };
@@ -1559,7 +1646,8 @@ zetasql_base::Status BuiltinAggregateAccumulator::Reset() {
       array_agg_.clear();
       break;
     case FunctionKind::kStringAgg: {
-      out_string_.clear();
+      string_agg_pieces_.clear();
+      string_agg_num_bytes_ = 0;
       if (!args_.empty()) {
         if (args_[0].is_null()) {
           return ::zetasql_base::InvalidArgumentErrorBuilder()
@@ -1683,6 +1771,22 @@ zetasql_base::Status BuiltinAggregateAccumulator::Reset() {
   return zetasql_base::OkStatus();
 }
 
+std::string BuiltinAggregateAccumulator::JoinStringAggPieces(
+    TypeKind kind) const {
+  std::string result;
+  result.reserve(string_agg_num_bytes_);
+  bool first = true;
+  for (const std::vector<Value>& chunk : string_agg_pieces_.chunks()) {
+    for (const Value& piece : chunk) {
+      if (!first) result.append(delimiter_);
+      first = false;
+      result.append(kind == TYPE_STRING ? piece.string_value()
+                                        : piece.bytes_value());
+    }
+  }
+  return result;
+}
+
 bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
                                              bool* stop_accumulation,
                                              ::zetasql_base::Status* status) {
@@ -1912,19 +2016,21 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
     case FCT(FunctionKind::kStringAgg, TYPE_STRING): {
       if (count_ > 1) {
         additional_bytes_to_request = delimiter_.size();
-        absl::StrAppend(&out_string_, delimiter_);
+        string_agg_num_bytes_ += delimiter_.size();
       }
       additional_bytes_to_request += value.string_value().size();
-      absl::StrAppend(&out_string_, value.string_value());
+      string_agg_num_bytes_ += value.string_value().size();
+      string_agg_pieces_.push_back(value);
       break;
     }
     case FCT(FunctionKind::kStringAgg, TYPE_BYTES): {
       if (count_ > 1) {
         additional_bytes_to_request = delimiter_.size();
-        absl::StrAppend(&out_string_, delimiter_);
+        string_agg_num_bytes_ += delimiter_.size();
       }
-      additional_bytes_to_request = value.bytes_value().size();
-      absl::StrAppend(&out_string_, value.bytes_value());
+      additional_bytes_to_request += value.bytes_value().size();
+      string_agg_num_bytes_ += value.bytes_value().size();
+      string_agg_pieces_.push_back(value);
       break;
     }
     case FCT(FunctionKind::kOrAgg, TYPE_BOOL):
@@ -1979,11 +2085,11 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
                  ? Value::Null(function_->output_type())
                  : InternalValue::ArrayNotChecked(output_type->AsArray(),
                                                   inputs_in_defined_order,
-                                                  std::move(array_agg_));
+                                                  array_agg_.ConsumeValues());
     case FunctionKind::kArrayConcatAgg: {
       std::vector<Value> values;
       bool found_non_null_inputs = false;
-      for (const Value& input_array : array_agg_) {
+      for (const Value& input_array : array_agg_.ConsumeValues()) {
         // ARRAY_CONCAT_AGG ignores NULLs.
         if (input_array.is_null()) continue;
         found_non_null_inputs = true;
@@ -2095,7 +2201,8 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
       if (count_ > 1) {
         context_->SetNonDeterministicOutput();
       }
-      return count_ > 0 ? Value::String(out_string_) : Value::NullString();
+      return count_ > 0 ? Value::String(JoinStringAggPieces(TYPE_STRING))
+                        : Value::NullString();
     case FCT(FunctionKind::kMax, TYPE_BYTES):
     case FCT(FunctionKind::kMin, TYPE_BYTES):
       return count_ > 0 ? Value::Bytes(out_string_) : Value::NullBytes();
@@ -2103,7 +2210,8 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
       if (count_ > 1) {
         context_->SetNonDeterministicOutput();
       }
-      return count_ > 0 ? Value::Bytes(out_string_) : Value::NullBytes();
+      return count_ > 0 ? Value::Bytes(JoinStringAggPieces(TYPE_BYTES))
+                        : Value::NullBytes();
     case FCT(FunctionKind::kMax, TYPE_DATE):
     case FCT(FunctionKind::kMin, TYPE_DATE):
       return count_ > 0 ? Value::Date(out_int64_) : Value::NullDate();
@@ -2241,7 +2349,7 @@ bool BinaryStatAccumulator::Accumulate(const Value& value,
   if (value.type_kind() != TYPE_STRUCT || value.num_fields() != 2) {
     *status = zetasql_base::InternalErrorBuilder().LogError().EmitStackTrace()
               << "Unexpected value type in BinaryStatAccumulator::Accumulate: "
-              << value.DebugString();
+              << value.CappedDebugString();
     return false;
   }
 
@@ -2356,6 +2464,13 @@ zetasql_base::StatusOr<Value> ConcatFunction::Eval(absl::Span<const Value> args,
   }
 }
 
+zetasql_base::StatusOr<Value> MakeProtoFunction::Eval(
+    absl::Span<const Value> args, EvaluationContext* context) const {
+  std::string bytes;
+  ZETASQL_RETURN_IF_ERROR(plan_.BuildProto(args, &bytes));
+  return Value::Proto(output_type()->AsProto(), bytes);
+}
+
 zetasql_base::StatusOr<Value> NullaryFunction::Eval(absl::Span<const Value> args,
                                             EvaluationContext* context) const {
   switch (kind()) {
@@ -2429,9 +2544,14 @@ zetasql_base::StatusOr<Value> FormatDateFunction::Eval(
   DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   std::string result_string;
-  ZETASQL_RETURN_IF_ERROR(functions::FormatDateToString(
-      args[0].string_value(), args[1].date_value(),
-      &result_string));
+  if (format_plan_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(
+        format_plan_->FormatDate(args[1].date_value(), &result_string));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(functions::FormatDateToString(
+        args[0].string_value(), args[1].date_value(),
+        &result_string));
+  }
   return Value::String(result_string);
 }
 
@@ -2464,13 +2584,19 @@ zetasql_base::StatusOr<Value> FormatTimestampFunction::Eval(
     return Value::Null(output_type());
   }
   std::string result_string;
+  absl::TimeZone timezone;
   if (args.size() == 2) {
-    ZETASQL_RETURN_IF_ERROR(functions::FormatTimestampToString(
-        args[0].string_value(), args[1].ToUnixMicros(),
-        context->GetDefaultTimeZone(), &result_string));
+    timezone = context->GetDefaultTimeZone();
+  } else {
+    ZETASQL_RETURN_IF_ERROR(
+        functions::MakeTimeZone(args[2].string_value(), &timezone));
+  }
+  if (format_plan_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(format_plan_->FormatTimestamp(args[1].ToUnixMicros(),
+                                                  timezone, &result_string));
   } else {
     ZETASQL_RETURN_IF_ERROR(functions::FormatTimestampToString(
-        args[0].string_value(), args[1].ToUnixMicros(), args[2].string_value(),
+        args[0].string_value(), args[1].ToUnixMicros(), timezone,
         &result_string));
   }
   return Value::String(result_string);
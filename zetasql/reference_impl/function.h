@@ -28,8 +28,10 @@
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/function.h"
+#include "zetasql/public/functions/date_time_util.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
+#include "zetasql/public/proto_util.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/evaluation.h"
@@ -303,6 +305,10 @@ class BuiltinAggregateFunction : public AggregateFunctionBody {
 
   std::string debug_name() const override;
 
+  const BuiltinAggregateFunction* AsBuiltinAggregateFunction() const override {
+    return this;
+  }
+
   ::zetasql_base::StatusOr<std::unique_ptr<AggregateAccumulator>> CreateAccumulator(
       absl::Span<const Value> args, EvaluationContext* context) const override;
 
@@ -378,6 +384,9 @@ class LogicalFunction : public BuiltinScalarFunction {
   using BuiltinScalarFunction::BuiltinScalarFunction;
   bool Eval(absl::Span<const Value> args, EvaluationContext* context,
             Value* result, ::zetasql_base::Status* status) const override;
+  // FALSE decides AND and TRUE decides OR; ZetaSQL does not define the
+  // evaluation order of their operands, so stopping early is legal.
+  Value ShortCircuitValue() const override;
 };
 
 class ExistsFunction : public BuiltinScalarFunction {
@@ -491,12 +500,14 @@ class MakeProtoFunction : public SimpleBuiltinScalarFunction {
   MakeProtoFunction(const ProtoType* output_type,
                     const std::vector<FieldAndFormat>& fields)
       : SimpleBuiltinScalarFunction(FunctionKind::kMakeProto, output_type),
-        fields_(fields) {}
+        plan_(output_type->descriptor(), fields) {}
   zetasql_base::StatusOr<Value> Eval(absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 
  private:
-  std::vector<FieldAndFormat> fields_;  // Not owned.
+  // Field layout compiled once at construction; per row, Eval() encodes the
+  // argument values straight to wire bytes without materializing a Message.
+  ProtoBuilderPlan plan_;
 };
 
 class NullaryFunction : public SimpleBuiltinScalarFunction {
@@ -515,9 +526,18 @@ class DateTimeUnaryFunction : public SimpleBuiltinScalarFunction {
 
 class FormatDateFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // 'format_plan' may be NULL; it is set when the format argument of the call
+  // is constant, in which case it is parsed once here instead of per row.
+  FormatDateFunction(FunctionKind kind, const Type* output_type,
+                     std::unique_ptr<const functions::DateTimestampFormatPlan>
+                         format_plan)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        format_plan_(std::move(format_plan)) {}
   zetasql_base::StatusOr<Value> Eval(absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  std::unique_ptr<const functions::DateTimestampFormatPlan> format_plan_;
 };
 
 class FormatDatetimeFunction : public SimpleBuiltinScalarFunction {
@@ -536,9 +556,18 @@ class FormatTimeFunction : public SimpleBuiltinScalarFunction {
 
 class FormatTimestampFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // 'format_plan' may be NULL; it is set when the format argument of the call
+  // is constant, in which case it is parsed once here instead of per row.
+  FormatTimestampFunction(
+      FunctionKind kind, const Type* output_type,
+      std::unique_ptr<const functions::DateTimestampFormatPlan> format_plan)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        format_plan_(std::move(format_plan)) {}
   zetasql_base::StatusOr<Value> Eval(absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  std::unique_ptr<const functions::DateTimestampFormatPlan> format_plan_;
 };
 
 class TimestampFromIntFunction : public SimpleBuiltinScalarFunction {
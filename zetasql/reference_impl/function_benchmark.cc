@@ -0,0 +1,200 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for BuiltinScalarFunction::Eval(), driven by the compliance
+// function test corpus in //zetasql/compliance:functions_testlib. Each
+// benchmark replays one function family's corpus (arithmetic, cast, date and
+// timestamp arithmetic, timestamp conversion, date/timestamp formatting), so
+// a regression in one kernel shows up in that family's timing instead of as a
+// vague slowdown of the compliance suite. Run with e.g.:
+//   bazel run -c opt //zetasql/reference_impl:function_benchmark
+//
+// Each benchmark reports items/second, where an item is one Eval() call, and
+// a corpus_size counter giving the number of calls replayed per iteration
+// (so ns per call is time/iteration divided by corpus_size). Corpus entries
+// for functions this implementation does not register (e.g. the string
+// functions) and entries whose function cannot be constructed for the
+// corpus result type are skipped at setup time.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "zetasql/base/logging.h"
+#include "zetasql/compliance/functions_testlib.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/evaluation.h"
+#include "zetasql/reference_impl/function.h"
+#include "zetasql/testing/test_function.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+namespace {
+
+// One corpus entry prepared for evaluation: the function to call and the
+// argument values to call it with.
+struct PreparedCall {
+  std::unique_ptr<BuiltinScalarFunction> function;
+  std::vector<Value> args;
+};
+
+// Prepares the corpus entry in 'params' for evaluation as a call to 'kind',
+// appending it to 'calls'. Entries whose function cannot be constructed (e.g.
+// because the argument types are not supported by 'kind') are dropped.
+void AddPreparedCall(FunctionKind kind, const QueryParamsWithResult& params,
+                     std::vector<PreparedCall>* calls) {
+  const Value& result = params.results().begin()->second.result;
+  if (!result.is_valid()) return;
+  auto status_or_function = BuiltinScalarFunction::CreateValidated(
+      kind, LanguageOptions::MaximumFeatures(), result.type(),
+      /*arguments=*/{});
+  if (!status_or_function.ok()) return;
+  calls->push_back(
+      {std::move(status_or_function.ValueOrDie()), params.params()});
+}
+
+// Prepares a corpus of named function calls, resolving each function name the
+// same way the algebrizer does. Calls to functions that are not registered in
+// this implementation are dropped.
+std::vector<PreparedCall> PrepareCalls(
+    const std::vector<FunctionTestCall>& tests) {
+  std::vector<PreparedCall> calls;
+  for (const FunctionTestCall& test : tests) {
+    auto status_or_kind =
+        BuiltinFunctionCatalog::GetKindByName(test.function_name);
+    if (!status_or_kind.ok()) continue;
+    AddPreparedCall(status_or_kind.ValueOrDie(), test.params, &calls);
+  }
+  return calls;
+}
+
+// Prepares a corpus of operator/cast test cases, which carry no function name,
+// as calls to 'kind'.
+std::vector<PreparedCall> PrepareCalls(
+    FunctionKind kind, const std::vector<QueryParamsWithResult>& tests) {
+  std::vector<PreparedCall> calls;
+  for (const QueryParamsWithResult& test : tests) {
+    AddPreparedCall(kind, test, &calls);
+  }
+  return calls;
+}
+
+void Append(std::vector<PreparedCall> more, std::vector<PreparedCall>* calls) {
+  for (PreparedCall& call : more) {
+    calls->push_back(std::move(call));
+  }
+}
+
+// Replays 'calls' once per benchmark iteration. Both successful and
+// error-returning calls are timed; building the error status is part of the
+// cost the corpus exercises.
+void RunCalls(benchmark::State& state, const std::vector<PreparedCall>& calls) {
+  CHECK(!calls.empty());
+  EvaluationContext context{EvaluationOptions()};
+  context.SetLanguageOptions(LanguageOptions::MaximumFeatures());
+  zetasql_base::ScopedAllocationTracking tracking;
+  for (auto _ : state) {
+    for (const PreparedCall& call : calls) {
+      Value result;
+      ::zetasql_base::Status status;
+      benchmark::DoNotOptimize(
+          call.function->Eval(call.args, &context, &result, &status));
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * calls.size());
+  state.counters["corpus_size"] = calls.size();
+  const zetasql_base::AllocationTotals allocated = tracking.delta();
+  state.counters["allocs_per_op"] = benchmark::Counter(
+      allocated.allocations, benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes_per_op"] =
+      benchmark::Counter(allocated.bytes, benchmark::Counter::kAvgIterations);
+}
+
+void BM_EvalArithmetic(benchmark::State& state) {
+  std::vector<PreparedCall> calls;
+  Append(PrepareCalls(FunctionKind::kAdd, GetFunctionTestsAdd()), &calls);
+  Append(PrepareCalls(FunctionKind::kSubtract, GetFunctionTestsSubtract()),
+         &calls);
+  Append(PrepareCalls(FunctionKind::kMultiply, GetFunctionTestsMultiply()),
+         &calls);
+  Append(PrepareCalls(FunctionKind::kDivide, GetFunctionTestsDivide()), &calls);
+  Append(PrepareCalls(FunctionKind::kDiv, GetFunctionTestsDiv()), &calls);
+  Append(PrepareCalls(FunctionKind::kMod, GetFunctionTestsModulo()), &calls);
+  Append(PrepareCalls(FunctionKind::kUnaryMinus, GetFunctionTestsUnaryMinus()),
+         &calls);
+  Append(PrepareCalls(FunctionKind::kSafeAdd, GetFunctionTestsSafeAdd()),
+         &calls);
+  Append(
+      PrepareCalls(FunctionKind::kSafeSubtract, GetFunctionTestsSafeSubtract()),
+      &calls);
+  Append(
+      PrepareCalls(FunctionKind::kSafeMultiply, GetFunctionTestsSafeMultiply()),
+      &calls);
+  Append(PrepareCalls(FunctionKind::kSafeDivide, GetFunctionTestsSafeDivide()),
+         &calls);
+  Append(PrepareCalls(FunctionKind::kSafeNegate, GetFunctionTestsSafeNegate()),
+         &calls);
+  RunCalls(state, calls);
+}
+BENCHMARK(BM_EvalArithmetic);
+
+void BM_EvalCast(benchmark::State& state) {
+  std::vector<PreparedCall> calls;
+  Append(PrepareCalls(FunctionKind::kCast, GetFunctionTestsCast()), &calls);
+  Append(PrepareCalls(FunctionKind::kCast, GetFunctionTestsSafeCast()), &calls);
+  RunCalls(state, calls);
+}
+BENCHMARK(BM_EvalCast);
+
+void BM_EvalDateArithmetic(benchmark::State& state) {
+  std::vector<PreparedCall> calls;
+  Append(PrepareCalls(GetFunctionTestsDateAddSub()), &calls);
+  Append(PrepareCalls(GetFunctionTestsDateTrunc()), &calls);
+  RunCalls(state, calls);
+}
+BENCHMARK(BM_EvalDateArithmetic);
+
+void BM_EvalTimestampArithmetic(benchmark::State& state) {
+  std::vector<PreparedCall> calls;
+  Append(PrepareCalls(GetFunctionTestsTimestampAddSub()), &calls);
+  Append(PrepareCalls(GetFunctionTestsTimestampTrunc()), &calls);
+  Append(PrepareCalls(GetFunctionTestsDateAndTimestampDiff()), &calls);
+  RunCalls(state, calls);
+}
+BENCHMARK(BM_EvalTimestampArithmetic);
+
+void BM_EvalTimestampConversion(benchmark::State& state) {
+  RunCalls(state, PrepareCalls(GetFunctionTestsTimestampConversion()));
+}
+BENCHMARK(BM_EvalTimestampConversion);
+
+void BM_EvalFormatDateTimestamp(benchmark::State& state) {
+  std::vector<PreparedCall> calls;
+  Append(PrepareCalls(GetFunctionTestsFormatDateTimestamp()), &calls);
+  Append(PrepareCalls(GetFunctionTestsFormatDatetime()), &calls);
+  Append(PrepareCalls(GetFunctionTestsFormatTime()), &calls);
+  RunCalls(state, calls);
+}
+BENCHMARK(BM_EvalFormatDateTimestamp);
+
+}  // namespace
+}  // namespace zetasql
+
+BENCHMARK_MAIN();
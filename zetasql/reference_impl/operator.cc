@@ -178,6 +178,18 @@ std::string AlgebraNode::DebugString(bool verbose) const {
   return this->DebugInternal("\n", verbose);
 }
 
+void AlgebraNode::CollectMayBufferRowsOps(std::vector<std::string>* ops) const {
+  const RelationalOp* relational_op = AsRelationalOp();
+  if (relational_op != nullptr && relational_op->may_buffer_rows()) {
+    ops->push_back(relational_op->IteratorDebugString());
+  }
+  for (const AlgebraArg* arg : GetArgs()) {
+    if (arg->has_node()) {
+      arg->node()->CollectMayBufferRowsOps(ops);
+    }
+  }
+}
+
 std::string AlgebraNode::ArgDebugString(absl::Span<const std::string> arg_names,
                                         absl::Span<const ArgPrintMode> arg_mode,
                                         const std::string& indent,
@@ -52,6 +52,7 @@
 #include "zetasql/public/evaluator_table_iterator.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
+#include "zetasql/reference_impl/bloom_filter.h"
 #include "zetasql/reference_impl/evaluation.h"
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/reference_impl/tuple_comparator.h"
@@ -61,6 +62,7 @@
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include <cstdint>
+#include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
@@ -80,12 +82,16 @@ class AggregateFunctionCallExpr;
 class AlgebraNode;
 class AnalyticFunctionBody;
 class AnalyticFunctionCallExpr;
+class DerefExpr;
 class ExprArg;
 class KeyArg;
 class RelationalArg;
 class RelationalOp;
 class ValueExpr;
 
+// Declared in function.h.
+class BuiltinAggregateFunction;
+
 // -------------------------------------------------------
 // Base classes
 // -------------------------------------------------------
@@ -605,10 +611,15 @@ class AggregateArg : public ExprArg {
       const TupleSchema& group_schema,
       absl::Span<const TupleSchema* const> params_schemas);
 
-  // Returns an accumulator corresponding this aggregation operations.
+  // Returns an accumulator corresponding this aggregation operations. If
+  // 'shared_distinct_values' is non-NULL, a DISTINCT aggregation tracks its
+  // distinct values there (under a freshly allocated group id) instead of in
+  // a private hash set; the table must outlive the accumulator. Useful for
+  // callers that create one accumulator per group to avoid maintaining a
+  // separate hash set for every group.
   ::zetasql_base::StatusOr<std::unique_ptr<AggregateArgAccumulator>> CreateAccumulator(
-      absl::Span<const TupleData* const> params,
-      EvaluationContext* context) const;
+      absl::Span<const TupleData* const> params, EvaluationContext* context,
+      DistinctValueTable* shared_distinct_values = nullptr) const;
 
   // Convenience method that creates an accumulator, accumulates all the rows in
   // 'group', and then returns the result.
@@ -616,6 +627,18 @@ class AggregateArg : public ExprArg {
                                 absl::Span<const TupleData* const> params,
                                 EvaluationContext* context) const;
 
+  // Evaluates this aggregate over each window in 'windows' (each one a
+  // contiguous range of tuples in 'partition') and appends one result per
+  // window to 'results'. For simple COUNT, SUM, MIN, and MAX aggregations over
+  // sliding windows, uses an incremental algorithm that is linear in the size
+  // of the partition instead of quadratic; otherwise falls back to calling
+  // EvalAgg() once per window.
+  ::zetasql_base::Status EvalAggOverWindows(
+      absl::Span<const TupleData* const> partition,
+      absl::Span<const AnalyticWindow> windows,
+      absl::Span<const TupleData* const> params, EvaluationContext* context,
+      std::vector<Value>* results) const;
+
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
@@ -975,6 +998,12 @@ class AlgebraNode {
   absl::Span<const AlgebraArg* const> GetArgs() const { return args_; }
   absl::Span<AlgebraArg* const> GetMutableArgs() { return args_; }
 
+  // Appends to 'ops' the IteratorDebugString() of every RelationalOp in the
+  // tree rooted at this node (including this one, if applicable) for which
+  // may_buffer_rows() is true. Operators are appended in pre-order, which
+  // matches the order in which they appear in DebugString().
+  void CollectMayBufferRowsOps(std::vector<std::string>* ops) const;
+
   // Returns a singleton argument of the given 'kind'.
   const AlgebraArg* GetArg(int kind) const;
   AlgebraArg* GetMutableArg(int kind);
@@ -1083,6 +1112,12 @@ class ValueExpr : public AlgebraNode {
   const ValueExpr* AsValueExpr() const override { return this; }
   ValueExpr* AsMutableValueExpr() override { return this; }
 
+  // Downcasts to DerefExpr, returning nullptr if this expression is not a
+  // simple dereference of a variable. Allows JoinOp to match its equality
+  // expressions against the known orderings of its inputs (see
+  // RelationalOp::SortedOutputVariables()).
+  virtual const DerefExpr* AsDerefExpr() const { return nullptr; }
+
   const Type* output_type() const override { return output_type_; }
 
   virtual bool IsConstant() const { return false; }
@@ -1151,12 +1186,47 @@ class RelationalOp : public AlgebraNode {
   // Relational operators typically do not preserve order.
   virtual bool may_preserve_order() const { return false; }
 
+  // Returns true if the iterator for this operator may buffer an unbounded
+  // number of input tuples (i.e., proportional to the size of the input)
+  // before returning its first output tuple. Operators for which this returns
+  // false are pipelined: they return tuples as their inputs produce them, and
+  // their memory usage does not grow with the number of input tuples.
+  virtual bool may_buffer_rows() const { return false; }
+
+  // Returns the variables by which this operator's output is known to be
+  // sorted, or an empty vector if no ordering is known. Only orderings that
+  // are ascending with the default ordering of NULLs and no collation are
+  // reported. A non-empty result allows JoinOp to join this operator's output
+  // with a merge join instead of a hash join (see JoinOp::CreateIterator).
+  // Note that the reported ordering does not survive the scrambling of
+  // undefined orderings (see EvaluationOptions).
+  virtual std::vector<VariableId> SortedOutputVariables() const { return {}; }
+
  protected:
   // Depending on the EvaluationOptions in 'context', either returns 'iter' or a
-  // ReorderingTupleIterator that wraps 'iter'.
+  // ReorderingTupleIterator that wraps 'iter'. Also applies MaybeProfile() and
+  // MaybeTrace().
   zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> MaybeReorder(
       std::unique_ptr<TupleIterator> iter, EvaluationContext* context) const;
 
+  // If 'context' collects operator stats (see
+  // EvaluationOptions::collect_operator_stats), returns a wrapper around
+  // 'iter' that accumulates this operator's runtime counters in 'context';
+  // otherwise returns 'iter' unchanged. CreateIterator() implementations that
+  // do not end with MaybeReorder() must wrap their result with this method so
+  // that every operator is profiled.
+  std::unique_ptr<TupleIterator> MaybeProfile(
+      std::unique_ptr<TupleIterator> iter, EvaluationContext* context) const;
+
+  // If a trace sink is registered (see zetasql_base::SetTraceSink()) when the
+  // iterator is created, returns a wrapper around 'iter' that emits trace
+  // spans for the iterator's open, Next()/NextBatch() calls, and close;
+  // otherwise returns 'iter' unchanged. Applied by MaybeReorder(), so
+  // CreateIterator() implementations that do not end with MaybeReorder()
+  // should wrap their result with this method.
+  std::unique_ptr<TupleIterator> MaybeTrace(
+      std::unique_ptr<TupleIterator> iter) const;
+
  private:
   // If false, the operator's output is never marked as ordered.
   bool is_order_preserving_ = false;
@@ -1305,7 +1375,11 @@ class JoinOp : public RelationalOp {
   // attempts to represent the join condition in terms of HashJoinEqualityExprs
   // and an arbitrary bool-Value'd ValueExpr for the remainder. If
   // HashJoinEqualityExprs are present, the join algorithm is a hash join where
-  // the right-hand side is the build side.
+  // the right-hand side is the build side, except that if both inputs are
+  // known to be sorted by the equality expressions (see
+  // RelationalOp::SortedOutputVariables()), the join algorithm is a merge
+  // join that streams both sides instead of loading the right-hand side into
+  // memory.
   struct HashJoinEqualityExprs {
     std::unique_ptr<ExprArg> left_expr;
     std::unique_ptr<ExprArg> right_expr;
@@ -1345,6 +1419,13 @@ class JoinOp : public RelationalOp {
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
+  // Every join kind except cross/outer apply loads the entire right-hand side
+  // into memory before returning the first tuple. Cross/outer apply instead
+  // re-evaluate the right-hand side for each left tuple.
+  bool may_buffer_rows() const override {
+    return join_kind_ != kCrossApply && join_kind_ != kOuterApply;
+  }
+
  private:
   enum ArgKind {
     kLeftOutput,
@@ -1422,6 +1503,9 @@ class AggregateOp : public RelationalOp {
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
+  // All groups are accumulated before the first output tuple is returned.
+  bool may_buffer_rows() const override { return true; }
+
  private:
   enum ArgKind { kKey, kAggregator, kInput };
 
@@ -1482,6 +1566,10 @@ class AnalyticOp : public RelationalOp {
 
   bool may_preserve_order() const override { return true; }
 
+  // The input is buffered a partition at a time, and a partition may span the
+  // entire input.
+  bool may_buffer_rows() const override { return true; }
+
  private:
   enum ArgKind { kPartitionKey, kOrderKey, kAnalytic, kInput };
 
@@ -1548,6 +1636,14 @@ class SortOp : public RelationalOp {
 
   bool may_preserve_order() const override { return true; }
 
+  // The entire input is sorted before the first output tuple is returned
+  // (though with 'limit' only 'limit' + 'offset' tuples are retained).
+  bool may_buffer_rows() const override { return true; }
+
+  // Returns the longest prefix of the sort keys that is ascending with the
+  // default ordering of NULLs and no collation.
+  std::vector<VariableId> SortedOutputVariables() const override;
+
  private:
   enum ArgKind { kKey, kValue, kLimit, kOffset, kInput };
 
@@ -1743,7 +1839,8 @@ class ComputeOp : public RelationalOp {
   RelationalOp* mutable_input();
 };
 
-// Discards tuples of 'input' on which 'predicate' evaluates to false or NULL.
+// Discards tuples of 'input' on which the predicate (the AND of the
+// conjuncts) does not evaluate to true.
 class FilterOp : public RelationalOp {
  public:
   FilterOp(const FilterOp&) = delete;
@@ -1756,6 +1853,19 @@ class FilterOp : public RelationalOp {
       std::unique_ptr<ValueExpr> predicate,
       std::unique_ptr<RelationalOp> input);
 
+  // Variant that takes the top-level AND conjuncts of the predicate
+  // separately. 'conjuncts' must be non-empty. The iterator evaluates the
+  // conjuncts one at a time and discards a tuple as soon as one of them does
+  // not return true, so later conjuncts are not evaluated for that tuple.
+  // (ZetaSQL does not specify the evaluation order of AND, so this is a
+  // valid evaluation of the combined predicate.) The iterator also tracks the
+  // cost and selectivity of each conjunct over an initial sample of tuples
+  // and then reorders the conjuncts so that cheap, selective ones are
+  // evaluated first.
+  static ::zetasql_base::StatusOr<std::unique_ptr<FilterOp>> Create(
+      std::vector<std::unique_ptr<ValueExpr>> conjuncts,
+      std::unique_ptr<RelationalOp> input);
+
   ::zetasql_base::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
@@ -1772,13 +1882,13 @@ class FilterOp : public RelationalOp {
                             bool verbose) const override;
 
  private:
-  enum ArgKind { kPredicate, kInput };
+  enum ArgKind { kConjunct, kInput };
 
-  FilterOp(std::unique_ptr<ValueExpr> predicate,
+  FilterOp(std::vector<std::unique_ptr<ValueExpr>> conjuncts,
            std::unique_ptr<RelationalOp> input);
 
-  const ValueExpr* predicate() const;
-  ValueExpr* mutable_predicate();
+  absl::Span<const ExprArg* const> conjuncts() const;
+  absl::Span<ExprArg* const> mutable_conjuncts();
 
   const RelationalOp* input() const;
   RelationalOp* mutable_input();
@@ -1913,6 +2023,8 @@ class DerefExpr : public ValueExpr {
 
   const VariableId& name() const { return name_; }
 
+  const DerefExpr* AsDerefExpr() const override { return this; }
+
   ::zetasql_base::Status SetSchemasForEvaluation(
       absl::Span<const TupleSchema* const> params_schemas) override;
 
@@ -2335,6 +2447,13 @@ class ScalarFunctionBody : public FunctionBody {
   // returning ::zetasql_base::StatusOr<Value> for performance reasons.
   virtual bool Eval(absl::Span<const Value> args, EvaluationContext* context,
                     Value* result, ::zetasql_base::Status* status) const = 0;
+
+  // If any argument of this function evaluates to the returned value, the
+  // whole call evaluates to that value regardless of the other arguments
+  // (FALSE for AND, TRUE for OR), so ScalarFunctionCallExpr stops evaluating
+  // arguments as soon as it sees it. Returns an invalid Value for functions
+  // without such a deciding value.
+  virtual Value ShortCircuitValue() const { return Value(); }
 };
 
 // Accumulator interface for aggregating a bunch of values.
@@ -2395,6 +2514,13 @@ class AggregateFunctionBody : public FunctionBody {
   const int num_input_fields() const { return num_input_fields_; }
   const Type* input_type() const { return input_type_; }
 
+  // Returns this as a BuiltinAggregateFunction, or NULL if this is some other
+  // kind of aggregate function. Used by AggregateArg::EvalAggOverWindows() to
+  // recognize aggregations that it can evaluate incrementally.
+  virtual const BuiltinAggregateFunction* AsBuiltinAggregateFunction() const {
+    return nullptr;
+  }
+
   // 'args' contains the constant arguments for the aggregation
   // function (e.g., the delimeter for STRING_AGG).
   virtual ::zetasql_base::StatusOr<std::unique_ptr<AggregateAccumulator>>
@@ -2440,6 +2566,59 @@ class ScalarFunctionCallExpr : public ValueExpr {
 
   std::unique_ptr<const ScalarFunctionBody> function_;
   const ResolvedFunctionCallBase::ErrorMode error_mode_;
+  // Cached copy of function_->ShortCircuitValue().
+  const Value short_circuit_value_;
+};
+
+// Implements 'needle IN (v1, ..., vn)' for a fixed list of constant values
+// of a simple type. The values are loaded into a hash set once at creation
+// time, so a probe is O(1) instead of O(n) as with the equivalent chain of OR
+// and equality calls. For large lists, a Bloom filter in front of the hash
+// set answers most non-matching probes from a small, cache-resident bit
+// array.
+class InListExpr : public ValueExpr {
+ public:
+  // All elements of 'values' must have the same type as
+  // 'needle->output_type()', which must be a simple type that supports
+  // equality comparison.
+  static ::zetasql_base::StatusOr<std::unique_ptr<InListExpr>> Create(
+      std::unique_ptr<ValueExpr> needle, absl::Span<const Value> values);
+
+  ::zetasql_base::Status SetSchemasForEvaluation(
+      absl::Span<const TupleSchema* const> params_schemas) override;
+
+  bool Eval(absl::Span<const TupleData* const> params,
+            EvaluationContext* context, VirtualTupleSlot* result,
+            ::zetasql_base::Status* status) const override;
+
+  std::string DebugInternal(const std::string& indent,
+                            bool verbose) const override;
+
+ private:
+  enum ArgKind { kNeedle };
+
+  InListExpr(std::unique_ptr<ValueExpr> needle, absl::Span<const Value> values);
+
+  InListExpr(const InListExpr&) = delete;
+  InListExpr& operator=(const InListExpr&) = delete;
+
+  const ValueExpr* needle() const { return GetArg(kNeedle)->value_expr(); }
+
+  // The non-NULL values of the list. NaN elements are dropped because SQL
+  // equality never matches NaN; NULL elements only matter through
+  // 'has_null_'.
+  absl::flat_hash_set<Value> values_;
+
+  // True if the list contains a NULL element, in which case a needle that
+  // matches no element yields NULL instead of false.
+  bool has_null_ = false;
+
+  // The number of elements in the original list, for DebugInternal().
+  int64_t num_list_elements_;
+
+  // Pre-filter in front of 'values_'. NULL for small lists, where the exact
+  // probe is already cheap.
+  std::unique_ptr<BloomFilter> bloom_filter_;
 };
 
 // Defines an aggregate function call with the given 'exprs' and 'arguments'.
@@ -2775,10 +2954,21 @@ class DMLValueExpr : public ValueExpr {
       absl::Span<const TupleData* const> params, int64_t actual_num_rows_modified,
       EvaluationContext* context, bool print_array_elements = false) const;
 
-  // Returns a vector of Values corresponding to 't'. The elements of the
-  // returned vector correspond to 'column_list'.
-  ::zetasql_base::StatusOr<std::vector<Value>> GetScannedTupleAsColumnValues(
-      const ResolvedColumnList& column_list, const Tuple& t) const;
+  // Returns the slot index in 'schema' of each column in 'column_list'.
+  // Resolving the slots once per statement and reading them for every row is
+  // much cheaper than the two hash lookups per value that GetColumnValue()
+  // does.
+  ::zetasql_base::StatusOr<std::vector<int>> GetSlotsForColumns(
+      const ResolvedColumnList& column_list, const TupleSchema& schema) const;
+
+  // Returns one vector of Values per tuple in 'tuples', with the elements of
+  // each vector corresponding to 'column_list'. The column slots are resolved
+  // once for all of 'tuples' (which must use 'schema').
+  ::zetasql_base::StatusOr<std::vector<std::vector<Value>>>
+  GetScannedTuplesAsColumnValues(
+      const ResolvedColumnList& column_list, const TupleSchema& schema,
+      absl::Span<const std::unique_ptr<TupleData>> tuples,
+      EvaluationContext* context) const;
 
   // Returns the value of 'column' in 't'.
   ::zetasql_base::StatusOr<Value> GetColumnValue(const ResolvedColumn& column,
@@ -2815,9 +3005,11 @@ class DMLValueExpr : public ValueExpr {
   // The returned value is a struct with two fields: an int64_t representing the
   // number of rows modified by the statement, and an array of structs, where
   // each element of the array represents a row of the modified table.
+  // Consumes 'dml_output_rows'; callers pass the rows by value so that they
+  // can be moved into the output instead of copied.
   ::zetasql_base::StatusOr<Value> GetDMLOutputValue(
       int64_t num_rows_modified,
-      const std::vector<std::vector<Value>>& dml_output_rows,
+      std::vector<std::vector<Value>> dml_output_rows,
       EvaluationContext* context) const;
 
   const bool is_value_table_;
@@ -3308,9 +3500,10 @@ class DMLInsertValueExpr : public DMLValueExpr {
       const std::vector<std::vector<Value>>& rows_to_insert,
       EvaluationContext* context, PrimaryKeyRowMap* row_map) const;
 
-  // Returns the DML output value corresponding to the arguments.
+  // Returns the DML output value corresponding to the arguments. Consumes
+  // the row values in '*row_map' by moving them into the output.
   ::zetasql_base::StatusOr<Value> GetDMLOutputValue(int64_t num_rows_modified,
-                                            const PrimaryKeyRowMap& row_map,
+                                            PrimaryKeyRowMap* row_map,
                                             EvaluationContext* context) const;
 };
 
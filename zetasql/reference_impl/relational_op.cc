@@ -18,9 +18,13 @@
 // warrant their own files.
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -32,12 +36,14 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/public/value.h"
+#include "zetasql/public/value.pb.h"
 #include "zetasql/reference_impl/evaluation.h"
 #include "zetasql/reference_impl/function.h"
 #include "zetasql/reference_impl/operator.h"
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/variable_id.h"
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
 #include <cstdint>
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -46,6 +52,8 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "zetasql/base/source_location.h"
@@ -53,6 +61,7 @@
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
 #include "zetasql/base/statusor.h"
+#include "zetasql/base/trace.h"
 
 using zetasql::types::EmptyStructType;
 using zetasql::values::Bool;
@@ -103,14 +112,138 @@ zetasql_base::Status RelationalOp::set_is_order_preserving(bool is_order_preserv
   return iter;
 }
 
+namespace {
+// Wraps another iterator and accumulates runtime counters for the operator
+// that created it. See EvaluationOptions::collect_operator_stats. The wrapper
+// is transparent: it forwards DebugString() and the order-related methods to
+// the underlying iterator.
+class ProfilingTupleIterator : public TupleIterator {
+ public:
+  ProfilingTupleIterator(std::unique_ptr<TupleIterator> iter,
+                         EvaluationContext::OperatorStats* stats)
+      : iter_(std::move(iter)), stats_(stats) {
+    ++stats_->num_iterators_created;
+  }
+
+  ProfilingTupleIterator(const ProfilingTupleIterator&) = delete;
+  ProfilingTupleIterator& operator=(const ProfilingTupleIterator&) = delete;
+
+  const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+  TupleData* Next() override {
+    const int64_t start = absl::GetCurrentTimeNanos();
+    TupleData* data = iter_->Next();
+    stats_->cumulative_nanos += absl::GetCurrentTimeNanos() - start;
+    if (data != nullptr) ++stats_->num_output_rows;
+    return data;
+  }
+
+  bool NextBatch(int max_rows, std::vector<TupleData>* batch) override {
+    const int64_t start = absl::GetCurrentTimeNanos();
+    const bool has_rows = iter_->NextBatch(max_rows, batch);
+    stats_->cumulative_nanos += absl::GetCurrentTimeNanos() - start;
+    if (has_rows) {
+      ++stats_->num_output_batches;
+      stats_->num_output_rows += batch->size();
+    }
+    return has_rows;
+  }
+
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return iter_->ApproximateRowCount();
+  }
+
+  zetasql_base::Status Status() const override { return iter_->Status(); }
+
+  bool PreservesOrder() const override { return iter_->PreservesOrder(); }
+
+  zetasql_base::Status DisableReordering() override {
+    return iter_->DisableReordering();
+  }
+
+  std::string DebugString() const override { return iter_->DebugString(); }
+
+ private:
+  std::unique_ptr<TupleIterator> iter_;
+  EvaluationContext::OperatorStats* stats_;
+};
+
+// Wraps another iterator and emits trace spans (see zetasql/base/trace.h) for
+// its lifecycle: an open span at construction carrying the iterator's debug
+// string as detail (so tools can attribute the per-row spans that follow), a
+// span around each Next()/NextBatch() call, and a close span at destruction.
+// Like ProfilingTupleIterator, the wrapper is otherwise transparent.
+class TracingTupleIterator : public TupleIterator {
+ public:
+  explicit TracingTupleIterator(std::unique_ptr<TupleIterator> iter)
+      : iter_(std::move(iter)) {
+    ZETASQL_TRACE_SPAN("TupleIterator::Open", [this] { return iter_->DebugString(); });
+  }
+
+  TracingTupleIterator(const TracingTupleIterator&) = delete;
+  TracingTupleIterator& operator=(const TracingTupleIterator&) = delete;
+
+  ~TracingTupleIterator() override { ZETASQL_TRACE_SPAN("TupleIterator::Close"); }
+
+  const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+  TupleData* Next() override {
+    ZETASQL_TRACE_SPAN("TupleIterator::Next");
+    return iter_->Next();
+  }
+
+  bool NextBatch(int max_rows, std::vector<TupleData>* batch) override {
+    ZETASQL_TRACE_SPAN("TupleIterator::NextBatch");
+    return iter_->NextBatch(max_rows, batch);
+  }
+
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return iter_->ApproximateRowCount();
+  }
+
+  zetasql_base::Status Status() const override { return iter_->Status(); }
+
+  bool PreservesOrder() const override { return iter_->PreservesOrder(); }
+
+  zetasql_base::Status DisableReordering() override {
+    return iter_->DisableReordering();
+  }
+
+  std::string DebugString() const override { return iter_->DebugString(); }
+
+ private:
+  std::unique_ptr<TupleIterator> iter_;
+};
+}  // namespace
+
 ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> RelationalOp::MaybeReorder(
     std::unique_ptr<TupleIterator> iter, EvaluationContext* context) const {
+  iter = MaybeTrace(MaybeProfile(std::move(iter), context));
   if (context->options().scramble_undefined_orderings) {
     iter = absl::make_unique<ReorderingTupleIterator>(std::move(iter));
   }
   return iter;
 }
 
+std::unique_ptr<TupleIterator> RelationalOp::MaybeProfile(
+    std::unique_ptr<TupleIterator> iter, EvaluationContext* context) const {
+  if (!context->options().collect_operator_stats) return iter;
+  return absl::make_unique<ProfilingTupleIterator>(
+      std::move(iter), context->mutable_operator_stats(this));
+}
+
+std::unique_ptr<TupleIterator> RelationalOp::MaybeTrace(
+    std::unique_ptr<TupleIterator> iter) const {
+  // Sampled once at iterator creation: a sink registered mid-query does not
+  // see spans from iterators created before it.
+  if (zetasql_base::GetTraceSink() == nullptr) return iter;
+  return absl::make_unique<TracingTupleIterator>(std::move(iter));
+}
+
 // -------------------------------------------------------
 // InArrayColumnFilterArg
 // -------------------------------------------------------
@@ -138,11 +271,14 @@ InArrayColumnFilterArg::Create(const VariableId& variable, int column_idx,
 
   std::vector<Value> values;
   if (!array.value().is_null()) {
-    values.reserve(array.value().elements().size());
-    for (const Value& value : array.value().elements()) {
+    // Take the elements out of the slot; this moves rather than copies them
+    // when the slot holds the only reference to the array.
+    std::vector<Value> elements = array.mutable_value()->TakeAsVector();
+    values.reserve(elements.size());
+    for (Value& value : elements) {
       // Check for NULL or NaN.
       if (value.SqlEquals(value) == values::True()) {
-        values.push_back(value);
+        values.push_back(std::move(value));
       }
     }
   }
@@ -470,6 +606,10 @@ class EvaluatorTableTupleIterator : public TupleIterator {
     return &current_;
   }
 
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return evaluator_table_iter_->ApproximateRowCount();
+  }
+
   zetasql_base::Status Status() const override { return status_; }
 
   std::string DebugString() const override {
@@ -485,6 +625,199 @@ class EvaluatorTableTupleIterator : public TupleIterator {
   TupleData current_;
   zetasql_base::Status status_;
 };
+
+// Advances 'iter' on a background thread that prefetches tuples into a bounded
+// queue, overlapping the scan with the evaluation of the rest of the plan on
+// the calling thread. Used when EvaluationOptions::max_intra_op_parallelism is
+// greater than 1. The background thread does not start until the first call to
+// Next() or StartPrefetch(), so it never runs concurrently with calls that
+// must precede those (e.g., DisableReordering()). The background thread only
+// advances 'iter', so
+// 'iter' must be safe to advance off-thread: EvaluatorTableTupleIterator
+// qualifies because it only reads the statement evaluation deadline from the
+// EvaluationContext (which is fixed before evaluation begins) and otherwise
+// does not touch the context or the MemoryAccountant, which are not
+// thread-safe. The prefetched tuples are not tracked by the MemoryAccountant,
+// but their number is bounded by 'max_prefetched_tuples' (from
+// EvaluationOptions::scan_prefetch_queue_size).
+//
+// If 'query_handle' is non-NULL, the prefetching runs as tasks on the
+// handle's shared WorkStealingScheduler instead of on a dedicated thread: a
+// task fills the queue and returns (freeing its worker for other queries'
+// tasks), and Next() reschedules it as the queue drains. At most one task is
+// in flight at a time, so 'iter' is still advanced by one thread at a time.
+class PrefetchingTupleIterator : public TupleIterator {
+ public:
+  PrefetchingTupleIterator(std::unique_ptr<TupleIterator> iter,
+                           WorkStealingScheduler::QueryHandle* query_handle,
+                           int64_t max_prefetched_tuples)
+      : iter_(std::move(iter)),
+        query_handle_(query_handle),
+        max_prefetched_tuples_(std::max<int64_t>(1, max_prefetched_tuples)) {}
+
+  PrefetchingTupleIterator(const PrefetchingTupleIterator&) = delete;
+  PrefetchingTupleIterator& operator=(const PrefetchingTupleIterator&) = delete;
+
+  ~PrefetchingTupleIterator() override {
+    if (started_) {
+      {
+        absl::MutexLock l(&mutex_);
+        cancelled_ = true;
+        if (query_handle_ != nullptr) {
+          // Wait for an in-flight prefetch task to observe the cancellation;
+          // after that no task can touch this iterator again.
+          mutex_.Await(absl::Condition(
+              +[](PrefetchingTupleIterator* iter) {
+                return !iter->task_pending_;
+              },
+              this));
+        }
+      }
+      if (query_handle_ == nullptr) thread_.join();
+    }
+  }
+
+  const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+  // Starts the background production of tuples. Called by Next(), and by
+  // consumers (e.g., UnionAllTupleIterator) that want the prefetching to
+  // overlap with other work done before they read this iterator.
+  void StartPrefetch() override {
+    if (started_) return;
+    started_ = true;
+    if (query_handle_ == nullptr) {
+      thread_ = std::thread([this] { PrefetchLoop(); });
+    } else {
+      absl::MutexLock l(&mutex_);
+      MaybeSchedulePrefetchTaskLocked();
+    }
+  }
+
+  TupleData* Next() override {
+    StartPrefetch();
+    absl::MutexLock l(&mutex_);
+    if (query_handle_ != nullptr) MaybeSchedulePrefetchTaskLocked();
+    mutex_.Await(absl::Condition(
+        +[](PrefetchingTupleIterator* iter) {
+          return !iter->queue_.empty() || iter->done_;
+        },
+        this));
+    if (queue_.empty()) {
+      status_ = final_status_;
+      return nullptr;
+    }
+    current_ = std::move(queue_.front());
+    queue_.pop_front();
+    if (query_handle_ != nullptr) MaybeSchedulePrefetchTaskLocked();
+    return &current_;
+  }
+
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return iter_->ApproximateRowCount();
+  }
+
+  zetasql_base::Status Status() const override { return status_; }
+
+  bool PreservesOrder() const override { return iter_->PreservesOrder(); }
+
+  zetasql_base::Status DisableReordering() override {
+    ZETASQL_RET_CHECK(!started_)
+        << "DisableReordering() cannot be called after Next() or "
+           "StartPrefetch()";
+    return iter_->DisableReordering();
+  }
+
+  std::string DebugString() const override {
+    return absl::StrCat("PrefetchingTupleIterator(", iter_->DebugString(), ")");
+  }
+
+ private:
+  // Runs on the background thread. Copies tuples from 'iter_' into 'queue_'
+  // until 'iter_' is exhausted, an error occurs, or this iterator is
+  // destroyed.
+  void PrefetchLoop() {
+    while (true) {
+      const TupleData* data = iter_->Next();  // No lock held.
+      absl::MutexLock l(&mutex_);
+      if (data == nullptr) {
+        final_status_ = iter_->Status();
+        done_ = true;
+        return;
+      }
+      mutex_.Await(absl::Condition(
+          +[](PrefetchingTupleIterator* iter) {
+            return iter->queue_.size() < iter->max_prefetched_tuples_ ||
+                   iter->cancelled_;
+          },
+          this));
+      if (cancelled_) return;
+      queue_.push_back(*data);
+    }
+  }
+
+  // Schedules a prefetch task if there is room in the queue and no task is
+  // already queued or running.
+  void MaybeSchedulePrefetchTaskLocked() {
+    if (task_pending_ || done_ || cancelled_ ||
+        queue_.size() >= max_prefetched_tuples_) {
+      return;
+    }
+    task_pending_ = true;
+    query_handle_->Schedule([this] { PrefetchTask(); });
+  }
+
+  // Runs as a scheduler task. Copies tuples from 'iter_' into 'queue_' until
+  // the queue is full, 'iter_' is exhausted, or this iterator is destroyed,
+  // then returns so its worker can run other tasks; Next() reschedules it as
+  // the consumer drains the queue. 'task_pending_' guarantees at most one
+  // instance runs at a time, so 'iter_' is never advanced concurrently.
+  void PrefetchTask() {
+    while (true) {
+      {
+        absl::MutexLock l(&mutex_);
+        if (cancelled_ || queue_.size() >= max_prefetched_tuples_) {
+          task_pending_ = false;
+          return;
+        }
+      }
+      const TupleData* data = iter_->Next();  // No lock held.
+      absl::MutexLock l(&mutex_);
+      if (data == nullptr) {
+        final_status_ = iter_->Status();
+        done_ = true;
+        task_pending_ = false;
+        return;
+      }
+      queue_.push_back(*data);
+    }
+  }
+
+  // Only accessed by the background thread or the in-flight prefetch task
+  // (and the calling thread before prefetching starts).
+  const std::unique_ptr<TupleIterator> iter_;
+
+  // NULL unless prefetching runs on a shared scheduler.
+  WorkStealingScheduler::QueryHandle* const query_handle_;
+
+  // The maximum number of tuples kept buffered ahead of the consumer.
+  const int64_t max_prefetched_tuples_;
+
+  // Only accessed by the calling thread.
+  bool started_ = false;
+  std::thread thread_;  // Unused if 'query_handle_' is non-NULL.
+  TupleData current_;
+  zetasql_base::Status status_;
+
+  // Guarded by 'mutex_'.
+  absl::Mutex mutex_;
+  std::deque<TupleData> queue_;
+  bool done_ = false;
+  bool cancelled_ = false;
+  // True while a prefetch task is queued or running on the scheduler. Always
+  // false if 'query_handle_' is NULL.
+  bool task_pending_ = false;
+  zetasql_base::Status final_status_;
+};
 }  // namespace
 
 ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>>
@@ -517,6 +850,11 @@ EvaluatorTableScanOp::CreateIterator(absl::Span<const TupleData* const> params,
       absl::make_unique<EvaluatorTableTupleIterator>(
           table_->Name(), CreateOutputSchema(), num_extra_slots, context,
           std::move(evaluator_table_iter));
+  if (context->options().max_intra_op_parallelism > 1) {
+    tuple_iter = absl::make_unique<PrefetchingTupleIterator>(
+        std::move(tuple_iter), context->scheduler_query_handle(),
+        context->options().scan_prefetch_queue_size);
+  }
   return MaybeReorder(std::move(tuple_iter), context);
 }
 
@@ -609,17 +947,14 @@ std::string LetOp::GetIteratorDebugString(
 }
 
 namespace {
-// Wrapper that owns 'params' while 'iter' uses them.
+// Wrapper that owns the TupleDatas computed for the assigned variables while
+// 'iter' uses them.
 class LetOpTupleIterator : public TupleIterator {
  public:
-  // 'deque' tracks the memory required by 'params'. There is no harm in having
-  // copied the Values because the big ones are internally reference counted.
+  // 'deque' owns the computed TupleDatas and tracks the memory they require.
   LetOpTupleIterator(std::unique_ptr<TupleDataDeque> deque,
-                     absl::Span<const std::shared_ptr<const TupleData>> params,
                      std::unique_ptr<TupleIterator> iter)
-      : deque_(std::move(deque)),
-        params_(params.begin(), params.end()),
-        iter_(std::move(iter)) {}
+      : deque_(std::move(deque)), iter_(std::move(iter)) {}
 
   LetOpTupleIterator(const LetOpTupleIterator&) = delete;
   LetOpTupleIterator& operator=(const LetOpTupleIterator&) = delete;
@@ -628,6 +963,12 @@ class LetOpTupleIterator : public TupleIterator {
 
   TupleData* Next() override { return iter_->Next(); }
 
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return iter_->ApproximateRowCount();
+  }
+
   zetasql_base::Status Status() const override { return iter_->Status(); }
 
   bool PreservesOrder() const override { return iter_->PreservesOrder(); }
@@ -642,7 +983,6 @@ class LetOpTupleIterator : public TupleIterator {
 
  private:
   const std::unique_ptr<TupleDataDeque> deque_;
-  const std::vector<std::shared_ptr<const TupleData>> params_;
   std::unique_ptr<TupleIterator> iter_;
 };
 }  // namespace
@@ -663,26 +1003,29 @@ class LetOpTupleIterator : public TupleIterator {
 
   ::zetasql_base::Status status;
   for (const ExprArg* a : assign()) {
-    auto new_data = absl::make_unique<TupleData>(/*num_slots=*/1);
+    TupleData new_data(/*num_slots=*/1);
     if (!a->value_expr()->EvalSimple(all_params, context,
-                                     new_data->mutable_slot(0), &status)) {
+                                     new_data.mutable_slot(0), &status)) {
       return status;
     }
 
-    all_params.push_back(new_data.get());
     if (!new_params->PushBack(std::move(new_data), &status)) {
       return status;
     }
+    // The pointer stays valid because later pushes do not move entries.
+    all_params.push_back(new_params->Back());
   }
 
-  std::vector<std::shared_ptr<const TupleData>> all_params_copies =
-      DeepCopyTupleDatas(all_params);
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> iter,
-                   body()->CreateIterator(StripSharedPtrs(all_params_copies),
-                                          num_extra_slots, context));
-  iter = absl::make_unique<LetOpTupleIterator>(
-      std::move(new_params), all_params_copies, std::move(iter));
-  return iter;
+  // The caller's 'params' must outlive the returned iterator (as for any
+  // RelationalOp), so the body can reference them and the computed TupleDatas
+  // in 'new_params' directly; each bound Value is stored once, in
+  // 'new_params', instead of being copied per reference.
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<TupleIterator> iter,
+      body()->CreateIterator(all_params, num_extra_slots, context));
+  iter = absl::make_unique<LetOpTupleIterator>(std::move(new_params),
+                                               std::move(iter));
+  return MaybeProfile(std::move(iter), context);
 }
 
 std::unique_ptr<TupleSchema> LetOp::CreateOutputSchema() const {
@@ -826,7 +1169,7 @@ class SortTupleIterator : public TupleIterator {
     if (tuples_->IsEmpty()) return nullptr;
 
     current_ = tuples_->PopFront();
-    return current_.get();
+    return &current_;
   }
 
   zetasql_base::Status Status() const override { return status_; }
@@ -850,7 +1193,7 @@ class SortTupleIterator : public TupleIterator {
   // key.
   zetasql_base::Status ReorderTuplesWithSameKey() {
     // Scramble the sorted order.
-    std::vector<std::unique_ptr<TupleData>> tuples;
+    std::vector<TupleData> tuples;
     tuples.reserve(tuples_->GetSize());
     while (!tuples_->IsEmpty()) {
       tuples.push_back(tuples_->PopFront());
@@ -858,11 +1201,11 @@ class SortTupleIterator : public TupleIterator {
     std::vector<int> scrambled_idxs;
     scrambled_idxs.reserve(tuples.size());
     for (int start_idx = 0; start_idx < tuples.size();) {
-      const TupleData& start_tuple = *tuples[start_idx];
+      const TupleData& start_tuple = tuples[start_idx];
       int equal_length = 1;
       while (start_idx + equal_length < tuples.size()) {
         const int tuple_idx = start_idx + equal_length;
-        const TupleData& tuple = *tuples[tuple_idx];
+        const TupleData& tuple = tuples[tuple_idx];
         const bool start_equals_tuple = !(*comparator_)(start_tuple, tuple) &&
                                         !(*comparator_)(tuple, start_tuple);
         if (!start_equals_tuple) {
@@ -906,11 +1249,13 @@ class SortTupleIterator : public TupleIterator {
   const std::unique_ptr<TupleComparator> comparator_;
   std::unique_ptr<TupleDataDeque> tuples_;
   int64_t num_next_calls_ = 0;
-  std::unique_ptr<TupleData> current_;
+  // The last tuple returned by Next().
+  TupleData current_;
   EvaluationContext* context_;
   bool enable_reordering_ = true;
   zetasql_base::Status status_;
 };
+
 }  // namespace
 
 ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> SortOp::CreateIterator(
@@ -981,33 +1326,79 @@ class SortTupleIterator : public TupleIterator {
 
   // If 'limit_offset' is set, 'top_n_outputs' contains the top
   // 'limit_offset.limit + limit_offset.offset' rows. Otherwise, 'outputs'
-  // contains all the rows.
-  auto top_n_outputs = absl::make_unique<TupleDataOrderedQueue>(
-      *comparator, context->memory_accountant());
+  // contains all the rows, except for any sorted runs spilled to disk in
+  // 'spilled_runs' (which can only happen if
+  // EvaluationOptions::allow_sort_spill_to_disk is set).
+  std::unique_ptr<TupleDataTopNQueue> top_n_outputs;
+  if (limit_offset.has_value()) {
+    top_n_outputs = absl::make_unique<TupleDataTopNQueue>(
+        *comparator, limit_offset->limit + limit_offset->offset,
+        context->memory_accountant());
+  }
   auto outputs =
       absl::make_unique<TupleDataDeque>(context->memory_accountant());
+  std::vector<std::unique_ptr<TupleSpillFile>> spilled_runs;
+
+  const bool use_stable_sort =
+      context->options().always_use_stable_sort || is_stable_sort_;
+
+  const int64_t verify_not_aborted_period =
+      absl::GetFlag(FLAGS_zetasql_call_verify_not_aborted_rows_period);
+
+  // Sorts 'outputs', writes its contents to a new run in 'spilled_runs', and
+  // clears 'outputs' (returning its bytes to the memory accountant).
+  const auto spill_sorted_run = [&]() -> zetasql_base::Status {
+    outputs->Sort(*comparator, use_stable_sort);
+    std::vector<const Type*> slot_types;
+    slot_types.reserve(keys().size() + values().size());
+    for (const KeyArg* key : keys()) {
+      slot_types.push_back(key->type());
+    }
+    for (const ExprArg* value : values()) {
+      slot_types.push_back(value->type());
+    }
+    auto run = absl::make_unique<TupleSpillFile>(std::move(slot_types));
+    int64_t num_spilled_rows = 0;
+    while (!outputs->IsEmpty()) {
+      if (num_spilled_rows % verify_not_aborted_period == 0) {
+        ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+      }
+      ++num_spilled_rows;
+      ZETASQL_RETURN_IF_ERROR(run->WriteTuple(outputs->PopFront()));
+    }
+    spilled_runs.push_back(std::move(run));
+    return zetasql_base::OkStatus();
+  };
+
   zetasql_base::Status status;
+  // The last entry is reset to the current input tuple on every row; keeping
+  // the vector around avoids allocating a new one per row.
+  std::vector<const TupleData*> params_and_input_tuple(params.begin(),
+                                                       params.end());
+  params_and_input_tuple.push_back(nullptr);
+  int64_t num_input_rows = 0;
   while (true) {
+    if (num_input_rows % verify_not_aborted_period == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
+    ++num_input_rows;
     const TupleData* next_input = input_iter->Next();
     if (next_input == nullptr) {
       ZETASQL_RETURN_IF_ERROR(input_iter->Status());
       break;
     }
+    params_and_input_tuple.back() = next_input;
 
-    const std::vector<const TupleData*> params_and_input_tuple =
-        ConcatSpans(params, {next_input});
-
-    auto next_output = absl::make_unique<TupleData>(
-        keys().size() + values().size() + num_extra_slots);
+    TupleData next_output(keys().size() + values().size() + num_extra_slots);
     for (int i = 0; i < keys().size(); ++i) {
-      TupleSlot* slot = next_output->mutable_slot(i);
+      TupleSlot* slot = next_output.mutable_slot(i);
       if (!keys()[i]->value_expr()->EvalSimple(params_and_input_tuple, context,
                                                slot, &status)) {
         return status;
       }
     }
     for (int i = 0; i < values().size(); ++i) {
-      TupleSlot* slot = next_output->mutable_slot(keys().size() + i);
+      TupleSlot* slot = next_output.mutable_slot(keys().size() + i);
       if (!values()[i]->value_expr()->EvalSimple(params_and_input_tuple,
                                                  context, slot, &status)) {
         return status;
@@ -1015,31 +1406,43 @@ class SortTupleIterator : public TupleIterator {
     }
 
     if (limit_offset.has_value()) {
-      if (!top_n_outputs->Insert(std::move(next_output), &status)) {
+      // The queue is bounded, so this drops tuples that are not among the top
+      // 'limit_offset.limit + limit_offset.offset'.
+      if (!top_n_outputs->Insert(
+              absl::make_unique<TupleData>(std::move(next_output)), &status)) {
         return status;
       }
-      if (top_n_outputs->GetSize() >
-          limit_offset->limit + limit_offset->offset) {
-        top_n_outputs->PopBack();
-      }
     } else {
-      if (!outputs->PushBack(std::move(next_output), &status)) {
-        return status;
+      if (!outputs->TryPushBack(&next_output, &status)) {
+        if (!context->options().allow_sort_spill_to_disk ||
+            outputs->IsEmpty()) {
+          // Spilling is disabled, or even a single tuple does not fit in the
+          // memory budget.
+          return status;
+        }
+        // Spill the accumulated tuples to disk as a sorted run and try again
+        // with the freed memory.
+        ZETASQL_RETURN_IF_ERROR(spill_sorted_run());
+        if (!outputs->TryPushBack(&next_output, &status)) {
+          return status;
+        }
       }
     }
   }
 
-  // If there is a limit set, drop the first 'offset' entries from
-  // 'top_n_outputs' and dump the rest into 'outputs'.
+  // If there is a limit set, dump the top 'limit' entries of 'top_n_outputs'
+  // into 'outputs' in ascending order, dropping the first 'offset' entries
+  // (which are the ones left in the queue afterwards).
   bool is_uniquely_ordered;
   if (limit_offset.has_value()) {
     ZETASQL_RET_CHECK(outputs->IsEmpty());
-    for (int i = 0; i < limit_offset->offset && !top_n_outputs->IsEmpty();
-         ++i) {
-      top_n_outputs->PopFront();
-    }
-    while (!top_n_outputs->IsEmpty()) {
-      if (!outputs->PushBack(top_n_outputs->PopFront(), &status)) {
+    int64_t num_dumped_rows = 0;
+    while (top_n_outputs->GetSize() > limit_offset->offset) {
+      if (num_dumped_rows % verify_not_aborted_period == 0) {
+        ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+      }
+      ++num_dumped_rows;
+      if (!outputs->PushFront(std::move(*top_n_outputs->PopBack()), &status)) {
         return status;
       }
     }
@@ -1050,12 +1453,44 @@ class SortTupleIterator : public TupleIterator {
     // ignoring failures.
     is_uniquely_ordered = true;
   } else {
-    ZETASQL_RET_CHECK(top_n_outputs->IsEmpty());
-    outputs->Sort(*comparator,
-                  context->options().always_use_stable_sort || is_stable_sort_);
-    const std::vector<const TupleData*> output_ptrs = outputs->GetTuplePtrs();
-    is_uniquely_ordered =
-        comparator->IsUniquelyOrdered(output_ptrs, slots_for_values);
+    ZETASQL_RET_CHECK(top_n_outputs == nullptr);
+    if (!spilled_runs.empty()) {
+      // The input did not fit in the memory budget, so sorted runs were
+      // spilled to disk. Spill the in-memory remainder as a final run and
+      // stream a merge of the runs. Like the limit case above, this path
+      // always claims the output is ordered, which is safe because
+      // 'allow_sort_spill_to_disk' is only set as an optimization, and is not
+      // set for compliance or random query tests.
+      if (!outputs->IsEmpty()) {
+        ZETASQL_RETURN_IF_ERROR(spill_sorted_run());
+      }
+      // We store a TupleIterator instead of the debug std::string to avoid having
+      // to compute the debug std::string unnecessarily.
+      std::shared_ptr<TupleIterator> input_iter_for_debug_string =
+          std::move(input_iter);
+      std::unique_ptr<TupleIterator> merge_iter =
+          absl::make_unique<SortedRunMergeTupleIterator>(
+              [input_iter_for_debug_string] {
+                return SortOp::GetIteratorDebugString(
+                    input_iter_for_debug_string->DebugString());
+              },
+              CreateOutputSchema(), std::move(comparator),
+              std::move(spilled_runs), num_extra_slots,
+              absl::GetFlag(FLAGS_zetasql_call_verify_not_aborted_rows_period),
+              [context] { return context->VerifyNotAborted(); });
+      return MaybeProfile(std::move(merge_iter), context);
+    }
+    outputs->Sort(*comparator, use_stable_sort);
+    if (context->options().scramble_undefined_orderings) {
+      const std::vector<const TupleData*> output_ptrs = outputs->GetTuplePtrs();
+      is_uniquely_ordered =
+          comparator->IsUniquelyOrdered(output_ptrs, slots_for_values);
+    } else {
+      // 'is_uniquely_ordered' is only consulted below to decide whether to
+      // disable the scrambling of tuples with equal keys, so there is no point
+      // in paying for the check when scrambling is off.
+      is_uniquely_ordered = false;
+    }
   }
   // We are done with 'top_n_outputs'. Deallocate it and crash if we ever
   // try to access it again.
@@ -1085,7 +1520,7 @@ class SortTupleIterator : public TupleIterator {
     iter = absl::make_unique<ReorderingTupleIterator>(std::move(iter));
   }
 
-  return iter;
+  return MaybeProfile(std::move(iter), context);
 }
 
 std::unique_ptr<TupleSchema> SortOp::CreateOutputSchema() const {
@@ -1100,6 +1535,19 @@ std::unique_ptr<TupleSchema> SortOp::CreateOutputSchema() const {
   return absl::make_unique<TupleSchema>(vars);
 }
 
+std::vector<VariableId> SortOp::SortedOutputVariables() const {
+  std::vector<VariableId> vars;
+  for (const KeyArg* key : keys()) {
+    if (key->order() != KeyArg::kAscending ||
+        key->null_order() != KeyArg::kDefaultNullOrder ||
+        key->collation() != nullptr) {
+      break;
+    }
+    vars.push_back(key->variable());
+  }
+  return vars;
+}
+
 std::string SortOp::IteratorDebugString() const {
   return GetIteratorDebugString(input()->IteratorDebugString());
 }
@@ -1228,10 +1676,14 @@ class ComputeTupleIterator : public TupleIterator {
                        std::unique_ptr<TupleSchema> output_schema,
                        EvaluationContext* context)
       : expr_args_(expr_args.begin(), expr_args.end()),
-        params_(params.begin(), params.end()),
+        params_and_current_(params.begin(), params.end()),
         iter_(std::move(iter)),
         output_schema_(std::move(output_schema)),
-        context_(context) {}
+        context_(context) {
+    // The last entry is reset to the current input tuple on every row; keeping
+    // the vector around avoids allocating a new one per row.
+    params_and_current_.push_back(nullptr);
+  }
 
   ComputeTupleIterator(const ComputeTupleIterator&) = delete;
   ComputeTupleIterator& operator=(const ComputeTupleIterator&) = delete;
@@ -1252,14 +1704,13 @@ class ComputeTupleIterator : public TupleIterator {
       return nullptr;
     }
 
+    params_and_current_.back() = current;
     for (int i = 0; i < expr_args_.size(); ++i) {
       TupleSlot* slot =
           current->mutable_slot(iter_->Schema().num_variables() + i);
       ::zetasql_base::Status status;
-      if (!expr_args_[i]->value_expr()->EvalSimple(
-              ConcatSpans(absl::Span<const TupleData* const>(params_),
-                          {current}),
-              context_, slot, &status)) {
+      if (!expr_args_[i]->value_expr()->EvalSimple(params_and_current_,
+                                                   context_, slot, &status)) {
         status_ = status;
         return nullptr;
       }
@@ -1268,6 +1719,37 @@ class ComputeTupleIterator : public TupleIterator {
     return current;
   }
 
+  bool NextBatch(int max_rows, std::vector<TupleData>* batch) override {
+    if (!iter_->NextBatch(max_rows, batch)) {
+      status_ = iter_->Status();
+      return false;
+    }
+    // Evaluate each expression over the whole batch.
+    for (TupleData& data : *batch) {
+      if (data.num_slots() < Schema().num_variables()) {
+        status_ = zetasql_base::InternalErrorBuilder()
+                  << "ComputeTupleIterator::NextBatch() found "
+                  << data.num_slots() << " slots but expected at least "
+                  << Schema().num_variables();
+        return false;
+      }
+      params_and_current_.back() = &data;
+      for (int i = 0; i < expr_args_.size(); ++i) {
+        TupleSlot* slot =
+            data.mutable_slot(iter_->Schema().num_variables() + i);
+        ::zetasql_base::Status status;
+        if (!expr_args_[i]->value_expr()->EvalSimple(params_and_current_,
+                                                     context_, slot, &status)) {
+          status_ = status;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
   zetasql_base::Status Status() const override { return status_; }
 
   std::string DebugString() const override {
@@ -1276,7 +1758,8 @@ class ComputeTupleIterator : public TupleIterator {
 
  private:
   const std::vector<const ExprArg*> expr_args_;
-  const std::vector<const TupleData*> params_;
+  // The params followed by one entry for the current input tuple.
+  std::vector<const TupleData*> params_and_current_;
 
   std::unique_ptr<TupleIterator> iter_;
   std::unique_ptr<TupleSchema> output_schema_;
@@ -1350,7 +1833,16 @@ std::string FilterOp::GetIteratorDebugString(
 
 ::zetasql_base::StatusOr<std::unique_ptr<FilterOp>> FilterOp::Create(
     std::unique_ptr<ValueExpr> predicate, std::unique_ptr<RelationalOp> input) {
-  return absl::WrapUnique(new FilterOp(std::move(predicate), std::move(input)));
+  std::vector<std::unique_ptr<ValueExpr>> conjuncts;
+  conjuncts.push_back(std::move(predicate));
+  return Create(std::move(conjuncts), std::move(input));
+}
+
+::zetasql_base::StatusOr<std::unique_ptr<FilterOp>> FilterOp::Create(
+    std::vector<std::unique_ptr<ValueExpr>> conjuncts,
+    std::unique_ptr<RelationalOp> input) {
+  ZETASQL_RET_CHECK(!conjuncts.empty());
+  return absl::WrapUnique(new FilterOp(std::move(conjuncts), std::move(input)));
 }
 
 ::zetasql_base::Status FilterOp::SetSchemasForEvaluation(
@@ -1359,23 +1851,38 @@ std::string FilterOp::GetIteratorDebugString(
 
   const std::unique_ptr<const TupleSchema> input_schema =
       input()->CreateOutputSchema();
-  return mutable_predicate()->SetSchemasForEvaluation(
-      ConcatSpans(params_schemas, {input_schema.get()}));
+  for (ExprArg* conjunct : mutable_conjuncts()) {
+    ZETASQL_RETURN_IF_ERROR(conjunct->mutable_value_expr()->SetSchemasForEvaluation(
+        ConcatSpans(params_schemas, {input_schema.get()})));
+  }
+  return zetasql_base::OkStatus();
 }
 
 namespace {
 // Filters out all tuples from an underlying iterator that don't match a
-// predicate.
+// predicate, given as a list of conjuncts that must all evaluate to true.
+//
+// The conjuncts are evaluated one at a time, stopping at the first one that
+// does not return true. While the first kConjunctSampleTuples input tuples
+// are being filtered, the iterator records how long each conjunct takes to
+// evaluate and how often it discards a tuple; after that it reorders the
+// conjuncts so that the ones with the lowest evaluation cost per discarded
+// tuple run first.
 class FilterTupleIterator : public TupleIterator {
  public:
   FilterTupleIterator(absl::Span<const TupleData* const> params,
-                      const ValueExpr* predicate,
+                      std::vector<const ValueExpr*> conjuncts,
                       std::unique_ptr<TupleIterator> iter,
                       EvaluationContext* context)
-      : predicate_(predicate),
-        params_(params.begin(), params.end()),
+      : conjuncts_(std::move(conjuncts)),
+        stats_(conjuncts_.size()),
+        params_and_current_(params.begin(), params.end()),
         iter_(std::move(iter)),
-        context_(context) {}
+        context_(context) {
+    // The last entry is reset to the current input tuple on every row; keeping
+    // the vector around avoids allocating a new one per row.
+    params_and_current_.push_back(nullptr);
+  }
 
   FilterTupleIterator(const FilterTupleIterator&) = delete;
   FilterTupleIterator& operator=(const FilterTupleIterator&) = delete;
@@ -1390,21 +1897,35 @@ class FilterTupleIterator : public TupleIterator {
         return nullptr;
       }
 
-      TupleSlot slot;
-      ::zetasql_base::Status status;
-      if (!predicate_->EvalSimple(
-              ConcatSpans(absl::Span<const TupleData* const>(params_),
-                          {current}),
-              context_, &slot, &status)) {
-        status_ = status;
-        return nullptr;
+      bool matches;
+      if (!EvaluateConjuncts(current, &matches)) return nullptr;
+      if (matches) return current;
+    }
+  }
+
+  bool NextBatch(int max_rows, std::vector<TupleData>* batch) override {
+    batch->clear();
+    // Keep pulling input batches until one of them has a matching tuple.
+    while (batch->empty()) {
+      if (!iter_->NextBatch(max_rows, &input_batch_)) {
+        status_ = iter_->Status();
+        return false;
       }
-      if (slot.value() == Bool(true)) {
-        return current;
+      // Evaluate the conjuncts over the whole batch and compact the matching
+      // tuples into 'batch'.
+      for (TupleData& data : input_batch_) {
+        bool matches;
+        if (!EvaluateConjuncts(&data, &matches)) return false;
+        if (matches) {
+          batch->push_back(std::move(data));
+        }
       }
     }
+    return true;
   }
 
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
   zetasql_base::Status Status() const override { return status_; }
 
   std::string DebugString() const override {
@@ -1412,9 +1933,94 @@ class FilterTupleIterator : public TupleIterator {
   }
 
  private:
-  const ValueExpr* predicate_;
-  const std::vector<const TupleData*> params_;
+  // Number of input tuples over which per-conjunct statistics are collected
+  // before the conjuncts are reordered.
+  static const int64_t kConjunctSampleTuples = 1000;
+
+  // Statistics for one conjunct over the sampled tuples.
+  struct ConjunctStats {
+    int64_t num_evaluations = 0;
+    // Evaluations that did not return true (i.e., discarded the tuple).
+    int64_t num_discards = 0;
+    // Total time spent evaluating the conjunct.
+    int64_t nanos = 0;
+  };
+
+  // Evaluates the conjuncts against 'current' in the current order, stopping
+  // at the first one that does not return true. Returns false and sets
+  // 'status_' on error. Otherwise sets 'matches' to whether all conjuncts
+  // returned true.
+  bool EvaluateConjuncts(const TupleData* current, bool* matches) {
+    params_and_current_.back() = current;
+    const bool sampling =
+        conjuncts_.size() > 1 && num_sampled_tuples_ < kConjunctSampleTuples;
+    *matches = true;
+    for (int i = 0; i < conjuncts_.size() && *matches; ++i) {
+      TupleSlot slot;
+      ::zetasql_base::Status status;
+      const int64_t start_nanos = sampling ? absl::GetCurrentTimeNanos() : 0;
+      if (!conjuncts_[i]->EvalSimple(params_and_current_, context_, &slot,
+                                     &status)) {
+        status_ = status;
+        return false;
+      }
+      *matches = (slot.value() == Bool(true));
+      if (sampling) {
+        ConjunctStats& stats = stats_[i];
+        stats.nanos += absl::GetCurrentTimeNanos() - start_nanos;
+        ++stats.num_evaluations;
+        if (!*matches) ++stats.num_discards;
+      }
+    }
+    if (sampling && ++num_sampled_tuples_ == kConjunctSampleTuples) {
+      ReorderConjuncts();
+    }
+    return true;
+  }
+
+  // Reorders 'conjuncts_' based on the sampled statistics: conjuncts that
+  // discarded at least one sampled tuple run first, ordered by evaluation
+  // cost per discarded tuple; the rest run last, cheapest first. Ties
+  // preserve the original order.
+  void ReorderConjuncts() {
+    struct RankedConjunct {
+      bool never_discards;
+      double cost;
+      const ValueExpr* conjunct;
+    };
+    std::vector<RankedConjunct> ranked;
+    ranked.reserve(conjuncts_.size());
+    for (int i = 0; i < conjuncts_.size(); ++i) {
+      const ConjunctStats& stats = stats_[i];
+      RankedConjunct ranked_conjunct;
+      ranked_conjunct.never_discards = (stats.num_discards == 0);
+      ranked_conjunct.cost =
+          static_cast<double>(stats.nanos) /
+          std::max<int64_t>(1, ranked_conjunct.never_discards
+                                   ? stats.num_evaluations
+                                   : stats.num_discards);
+      ranked_conjunct.conjunct = conjuncts_[i];
+      ranked.push_back(ranked_conjunct);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const RankedConjunct& a, const RankedConjunct& b) {
+                       if (a.never_discards != b.never_discards) {
+                         return b.never_discards;
+                       }
+                       return a.cost < b.cost;
+                     });
+    for (int i = 0; i < conjuncts_.size(); ++i) {
+      conjuncts_[i] = ranked[i].conjunct;
+    }
+  }
+
+  std::vector<const ValueExpr*> conjuncts_;
+  std::vector<ConjunctStats> stats_;
+  int64_t num_sampled_tuples_ = 0;
+  // The params followed by one entry for the current input tuple.
+  std::vector<const TupleData*> params_and_current_;
   std::unique_ptr<TupleIterator> iter_;
+  std::vector<TupleData> input_batch_;
   zetasql_base::Status status_;
   EvaluationContext* context_;
 };
@@ -1425,8 +2031,13 @@ zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> FilterOp::CreateIterator(
     EvaluationContext* context) const {
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> iter,
                    input()->CreateIterator(params, num_extra_slots, context));
-  iter = absl::make_unique<FilterTupleIterator>(params, predicate(),
-                                                std::move(iter), context);
+  std::vector<const ValueExpr*> conjunct_exprs;
+  conjunct_exprs.reserve(conjuncts().size());
+  for (const ExprArg* conjunct : conjuncts()) {
+    conjunct_exprs.push_back(conjunct->value_expr());
+  }
+  iter = absl::make_unique<FilterTupleIterator>(
+      params, std::move(conjunct_exprs), std::move(iter), context);
   return MaybeReorder(std::move(iter), context);
 }
 
@@ -1440,23 +2051,32 @@ std::string FilterOp::IteratorDebugString() const {
 
 std::string FilterOp::DebugInternal(const std::string& indent,
                                     bool verbose) const {
-  return absl::StrCat(
-      "FilterOp(",
-      ArgDebugString({"condition", "input"}, {k1, k1}, indent, verbose), ")");
+  // A single conjunct is printed as a bare condition for compatibility with
+  // predicates that were not split into conjuncts.
+  const ArgPrintMode conjunct_mode = conjuncts().size() == 1 ? k1 : kN;
+  return absl::StrCat("FilterOp(",
+                      ArgDebugString({"condition", "input"},
+                                     {conjunct_mode, k1}, indent, verbose),
+                      ")");
 }
 
-FilterOp::FilterOp(std::unique_ptr<ValueExpr> predicate,
+FilterOp::FilterOp(std::vector<std::unique_ptr<ValueExpr>> conjuncts,
                    std::unique_ptr<RelationalOp> input) {
-  SetArg(kPredicate, absl::make_unique<ExprArg>(std::move(predicate)));
+  std::vector<std::unique_ptr<ExprArg>> conjunct_args;
+  conjunct_args.reserve(conjuncts.size());
+  for (std::unique_ptr<ValueExpr>& conjunct : conjuncts) {
+    conjunct_args.push_back(absl::make_unique<ExprArg>(std::move(conjunct)));
+  }
+  SetArgs<ExprArg>(kConjunct, std::move(conjunct_args));
   SetArg(kInput, absl::make_unique<RelationalArg>(std::move(input)));
 }
 
-const ValueExpr* FilterOp::predicate() const {
-  return GetArg(kPredicate)->node()->AsValueExpr();
+absl::Span<const ExprArg* const> FilterOp::conjuncts() const {
+  return GetArgs<ExprArg>(kConjunct);
 }
 
-ValueExpr* FilterOp::mutable_predicate() {
-  return GetMutableArg(kPredicate)->mutable_node()->AsMutableValueExpr();
+absl::Span<ExprArg* const> FilterOp::mutable_conjuncts() {
+  return GetMutableArgs<ExprArg>(kConjunct);
 }
 
 const RelationalOp* FilterOp::input() const {
@@ -1497,7 +2117,10 @@ std::string LimitOp::GetIteratorDebugString(
 
 namespace {
 // Skips the first 'offset' tuples from 'iter' and then returns the next 'count'
-// tuples.
+// tuples. As soon as the limit is satisfied (or the input is exhausted), drops
+// the input iterator so that any state held by the operators beneath it --
+// sorted runs, join hash tables, prefetch threads -- is freed promptly rather
+// than living until this iterator is destroyed.
 class LimitTupleIterator : public TupleIterator {
  public:
   LimitTupleIterator(int64_t count, int64_t offset, EvaluationContext* context,
@@ -1510,9 +2133,13 @@ class LimitTupleIterator : public TupleIterator {
   LimitTupleIterator(const LimitTupleIterator&) = delete;
   LimitTupleIterator& operator=(const LimitTupleIterator&) = delete;
 
-  const TupleSchema& Schema() const override { return iter_->Schema(); }
+  const TupleSchema& Schema() const override {
+    return iter_ != nullptr ? iter_->Schema() : *schema_;
+  }
 
   TupleData* Next() override {
+    if (iter_ == nullptr) return nullptr;
+
     // Skip the first 'offset_' tuples from 'iter_'.
     while (next_iter_row_number_ < offset_) {
       TupleData* current = iter_->Next();
@@ -1539,15 +2166,21 @@ class LimitTupleIterator : public TupleIterator {
     return current;
   }
 
+  void StartPrefetch() override {
+    if (iter_ != nullptr) iter_->StartPrefetch();
+  }
+
   zetasql_base::Status Status() const override { return status_; }
 
   std::string DebugString() const override {
-    return LimitOp::GetIteratorDebugString(iter_->DebugString());
+    return LimitOp::GetIteratorDebugString(
+        iter_ != nullptr ? iter_->DebugString() : input_debug_string_);
   }
 
  private:
-  // Update 'status_' and 'context_' to indicate that the iterator is done. If
-  // 'iter_' is done, 'iter_status' contains its status.
+  // Update 'status_' and 'context_' to indicate that the iterator is done,
+  // and release 'iter_'. If 'iter_' is done, 'iter_status' contains its
+  // status.
   void Finish(absl::optional<zetasql_base::Status> iter_status) {
     if (iter_status.has_value()) {
       status_ = iter_status.value();
@@ -1564,7 +2197,10 @@ class LimitTupleIterator : public TupleIterator {
         const TupleData* current = iter_->Next();
         if (current == nullptr) {
           status_ = iter_->Status();
-          if (!status_.ok()) return;
+          if (!status_.ok()) {
+            ReleaseInputIterator();
+            return;
+          }
           iter_status = status_;
           break;
         }
@@ -1574,12 +2210,25 @@ class LimitTupleIterator : public TupleIterator {
         context_->SetNonDeterministicOutput();
       }
     }
+    ReleaseInputIterator();
+  }
+
+  // Frees 'iter_' (and with it whatever the operators beneath it were
+  // holding), caching what is needed to keep answering Schema() and
+  // DebugString().
+  void ReleaseInputIterator() {
+    schema_ = absl::make_unique<TupleSchema>(iter_->Schema().variables());
+    input_debug_string_ = iter_->DebugString();
+    iter_.reset();
   }
 
   const int64_t count_;
   const int64_t offset_;
   EvaluationContext* context_;
   std::unique_ptr<TupleIterator> iter_;
+  // Set by ReleaseInputIterator() when 'iter_' is dropped.
+  std::unique_ptr<TupleSchema> schema_;
+  std::string input_debug_string_;
   // The row number of the next tuple returned by iter_->Next().
   int64_t next_iter_row_number_ = 0;
   zetasql_base::Status status_;
@@ -1622,7 +2271,7 @@ zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> LimitOp::CreateIterator(
       !(underlying_iter_preserves_order && is_order_preserving())) {
     iter = absl::make_unique<ReorderingTupleIterator>(std::move(iter));
   }
-  return iter;
+  return MaybeProfile(std::move(iter), context);
 }
 
 std::unique_ptr<TupleSchema> LimitOp::CreateOutputSchema() const {
@@ -2029,11 +2678,11 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
         WrapWithJoinedBits(right_tuples->GetTuplePtrs());
 
     auto right_tuple_map = absl::make_unique<RightTupleMap>();
+    TupleData key(right_equality_exprs.size());
     for (auto& tuple_and_bit : right_tuples_and_bits) {
-      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleData> key,
-                       CreateTupleMapKey(params, *tuple_and_bit.tuple,
-                                         right_equality_exprs, context));
-      (*right_tuple_map)[*key].push_back(&tuple_and_bit);
+      ZETASQL_RETURN_IF_ERROR(CreateTupleMapKey(params, *tuple_and_bit.tuple,
+                                        right_equality_exprs, context, &key));
+      (*right_tuple_map)[key].push_back(&tuple_and_bit);
     }
     return absl::WrapUnique(new UncorrelatedHashedRightInput(
         params, left_equality_exprs, std::move(schema), std::move(right_tuples),
@@ -2049,30 +2698,30 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
     if (left_input == nullptr) {
       matching_right_tuple_list_ = absl::nullopt;
     } else {
-      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleData> key,
-                       CreateTupleMapKey(params_, *left_input->data,
-                                         left_equality_exprs_, context_));
-      const auto it = right_tuple_map_->find(*key);
+      ZETASQL_RETURN_IF_ERROR(CreateTupleMapKey(params_, *left_input->data,
+                                        left_equality_exprs_, context_,
+                                        &probe_key_));
+      const auto it = right_tuple_map_->find(probe_key_);
       if (it == right_tuple_map_->end()) {
         // No matching tuples.
         matching_right_tuple_list_ = nullptr;
       } else {
         const TupleData& other_key = it->first;
         matching_right_tuple_list_ = &it->second;
-        // We have to compare 'key' against 'other_key', because TupleData::==()
-        // uses Value::Equals(), which is more permissive than SQL equality. In
-        // particular, SQL specifies that the result of NULL = NULL is NULL and
-        // that the result of NaN = NaN is false, but NULL.Equals(NULL) and
-        // NaN.Equals(NaN) are both true.
-        ZETASQL_RET_CHECK_EQ(key->num_slots(), other_key.num_slots());
+        // We have to compare 'probe_key_' against 'other_key', because
+        // TupleData::==() uses Value::Equals(), which is more permissive than
+        // SQL equality. In particular, SQL specifies that the result of NULL =
+        // NULL is NULL and that the result of NaN = NaN is false, but
+        // NULL.Equals(NULL) and NaN.Equals(NaN) are both true.
+        ZETASQL_RET_CHECK_EQ(probe_key_.num_slots(), other_key.num_slots());
+        const ComparisonFunction equals_function(FunctionKind::kEqual,
+                                                 types::BoolType());
         zetasql_base::Status status;
-        for (int i = 0; i < key->num_slots(); ++i) {
-          const ComparisonFunction equals_function(FunctionKind::kEqual,
-                                                   types::BoolType());
+        for (int i = 0; i < probe_key_.num_slots(); ++i) {
           Value equals_result;
           if (!equals_function.Eval(
-                  {key->slot(i).value(), other_key.slot(i).value()}, context_,
-                  &equals_result, &status)) {
+                  {probe_key_.slot(i).value(), other_key.slot(i).value()},
+                  context_, &equals_result, &status)) {
             return status;
           }
           if (equals_result != values::Bool(true)) {
@@ -2154,6 +2803,7 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
         right_tuples_(std::move(right_tuples)),
         right_tuples_and_bits_(std::move(right_tuples_and_bits)),
         right_tuple_map_(std::move(right_tuple_map)),
+        probe_key_(left_equality_exprs.size()),
         iter_for_debug_string_(std::move(iter_for_debug_string)),
         context_(context) {}
 
@@ -2161,17 +2811,22 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
   UncorrelatedHashedRightInput& operator=(const UncorrelatedHashedRightInput&) =
       delete;
 
-  // Returns the TupleMap key corresponding to 'row' and 'args'.
-  static zetasql_base::StatusOr<std::unique_ptr<TupleData>> CreateTupleMapKey(
+  // Populates 'key' with the TupleMap key corresponding to 'row' and 'args'.
+  // 'key' must have one slot per arg; it is passed in by the caller (rather
+  // than allocated here) so that probes can reuse the same TupleData.
+  static zetasql_base::Status CreateTupleMapKey(
       absl::Span<const TupleData* const> params, const TupleData& row,
-      absl::Span<const ExprArg* const> args, EvaluationContext* context) {
-    auto key = absl::make_unique<TupleData>(args.size());
+      absl::Span<const ExprArg* const> args, EvaluationContext* context,
+      TupleData* key) {
+    ZETASQL_RET_CHECK_EQ(key->num_slots(), args.size());
+    const std::vector<const TupleData*> params_and_row =
+        ConcatSpans(params, {&row});
     for (int i = 0; i < args.size(); ++i) {
       const ExprArg* arg = args[i];
       TupleSlot* slot = key->mutable_slot(i);
       zetasql_base::Status status;
-      if (!arg->value_expr()->EvalSimple(ConcatSpans(params, {&row}), context,
-                                         slot, &status)) {
+      if (!arg->value_expr()->EvalSimple(params_and_row, context, slot,
+                                         &status)) {
         return status;
       }
       // Represent non-negative INT64 values with UINT64 values to support
@@ -2183,7 +2838,7 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
         }
       }
     }
-    return key;
+    return zetasql_base::OkStatus();
   }
 
   const std::vector<const TupleData*> params_;
@@ -2200,6 +2855,10 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
   // therefore GetNumMatchingTuples()/etc. should iterate over everything.
   absl::optional<RightTupleList*> matching_right_tuple_list_ = nullptr;
 
+  // Reused by ResetForLeftInput() for every probe of 'right_tuple_map_' to
+  // avoid allocating a fresh TupleData per left tuple.
+  TupleData probe_key_;
+
   // We store a TupleIterator instead of the debug std::string to avoid computing the
   // debug std::string unnecessarily.
   const std::unique_ptr<TupleIterator> iter_for_debug_string_;
@@ -2207,28 +2866,370 @@ class UncorrelatedHashedRightInput : public RightInputForJoin {
   EvaluationContext* context_;
 };
 
+// Represents the right-hand side of a merge join: a stream of tuples sorted
+// by the values of the join equality expressions, consumed in lockstep with
+// the (also sorted) left-hand side. Unlike UncorrelatedHashedRightInput, this
+// class does not load the right-hand side into memory; it only buffers the
+// tuples whose keys are equal to those of the current left tuple (a single
+// tuple when the keys are unique) and, for right outer and full outer joins,
+// the tuples that did not join with anything. For those join kinds,
+// ResetForLeftInput(NULL) exposes only the tuples that did not join rather
+// than the entire right-hand side; this is equivalent because
+// JoinTupleIterator skips joined tuples using DidMatchingTupleJoin().
+//
+// Requires that the left tuples are passed to ResetForLeftInput() in
+// ascending key order.
+class MergeJoinRightInput : public RightInputForJoin {
+ public:
+  static zetasql_base::StatusOr<std::unique_ptr<MergeJoinRightInput>> Create(
+      absl::Span<const TupleData* const> params,
+      std::vector<const ExprArg*> left_equality_exprs,
+      std::vector<const ExprArg*> right_equality_exprs,
+      std::unique_ptr<TupleSchema> schema,
+      std::unique_ptr<TupleIterator> right_iter, bool collect_unjoined_tuples,
+      EvaluationContext* context) {
+    ZETASQL_RET_CHECK_EQ(left_equality_exprs.size(), right_equality_exprs.size());
+    ZETASQL_RET_CHECK(!left_equality_exprs.empty());
+
+    // Build a comparator that orders key TupleDatas the way the inputs are
+    // sorted (see RelationalOp::SortedOutputVariables()). The KeyArgs only
+    // carry the sort direction; their expressions are never evaluated.
+    std::vector<std::unique_ptr<KeyArg>> keys;
+    std::vector<int> slots_for_keys;
+    keys.reserve(left_equality_exprs.size());
+    slots_for_keys.reserve(left_equality_exprs.size());
+    for (int i = 0; i < left_equality_exprs.size(); ++i) {
+      const DerefExpr* deref =
+          left_equality_exprs[i]->value_expr()->AsDerefExpr();
+      ZETASQL_RET_CHECK(deref != nullptr);
+      ZETASQL_ASSIGN_OR_RETURN(auto key_expr,
+                       DerefExpr::Create(deref->name(),
+                                         left_equality_exprs[i]->type()));
+      keys.push_back(absl::make_unique<KeyArg>(
+          deref->name(), std::move(key_expr), KeyArg::kAscending));
+      slots_for_keys.push_back(i);
+    }
+    std::vector<const KeyArg*> key_ptrs;
+    key_ptrs.reserve(keys.size());
+    for (const std::unique_ptr<KeyArg>& key : keys) {
+      key_ptrs.push_back(key.get());
+    }
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<TupleComparator> comparator,
+        TupleComparator::Create(key_ptrs, slots_for_keys, params, context));
+
+    return absl::WrapUnique(new MergeJoinRightInput(
+        params, std::move(left_equality_exprs), std::move(right_equality_exprs),
+        std::move(keys), std::move(comparator), std::move(schema),
+        std::move(right_iter), collect_unjoined_tuples, context));
+  }
+
+  bool IsCorrelated() const override { return false; }
+
+  const TupleSchema& Schema() const override { return *schema_; }
+
+  zetasql_base::Status ResetForLeftInput(const Tuple* left_input) override {
+    if (left_input == nullptr) {
+      // We are done with the left-hand side. Everything that is still
+      // buffered or unread did not join.
+      ZETASQL_RETURN_IF_ERROR(ReleaseBlock());
+      ZETASQL_RETURN_IF_ERROR(DiscardPending());
+      while (!right_done_) {
+        ZETASQL_RETURN_IF_ERROR(ReadNextRightTuple());
+        ZETASQL_RETURN_IF_ERROR(DiscardPending());
+      }
+      matching_tuples_ = unjoined_tuples_.GetTuplePtrs();
+      return zetasql_base::OkStatus();
+    }
+
+    matching_tuples_.clear();
+    ZETASQL_RETURN_IF_ERROR(EvaluateKey(*left_input->data, left_equality_exprs_,
+                                &left_key_));
+    while (true) {
+      if (!block_tuples_.IsEmpty()) {
+        if ((*comparator_)(left_key_, block_key_)) {
+          // The left tuple is before the current block; it has no matches,
+          // but later left tuples may still match the block.
+          return zetasql_base::OkStatus();
+        }
+        if (!(*comparator_)(block_key_, left_key_)) {
+          // The keys are equal in the sort order. Check SQL equality, which
+          // is stricter (e.g. for NULL and NaN).
+          ZETASQL_ASSIGN_OR_RETURN(const bool joins, SqlEquals(left_key_, block_key_));
+          if (joins) matching_tuples_ = block_tuples_.GetTuplePtrs();
+          return zetasql_base::OkStatus();
+        }
+        // The left tuple is past the current block.
+        ZETASQL_RETURN_IF_ERROR(ReleaseBlock());
+      }
+      if (pending_tuple_ == nullptr) {
+        if (right_done_) return zetasql_base::OkStatus();
+        ZETASQL_RETURN_IF_ERROR(ReadNextRightTuple());
+        continue;
+      }
+      if ((*comparator_)(pending_key_, left_key_)) {
+        // The right tuple is before the left tuple; it can never join.
+        ZETASQL_RETURN_IF_ERROR(DiscardPending());
+        continue;
+      }
+      if ((*comparator_)(left_key_, pending_key_)) {
+        // The right tuple is past the left tuple; the left has no matches.
+        return zetasql_base::OkStatus();
+      }
+      ZETASQL_ASSIGN_OR_RETURN(const bool joins, SqlEquals(left_key_, pending_key_));
+      if (!joins) {
+        // The keys sort as equal but are not SQL-equal (NULL or NaN); the
+        // left tuple has no matches, but keep the right tuple because later
+        // left tuples may sort equal to it too.
+        return zetasql_base::OkStatus();
+      }
+      // Buffer the full run of right tuples with this key as the new block.
+      ZETASQL_RETURN_IF_ERROR(StartBlockFromPending());
+      matching_tuples_ = block_tuples_.GetTuplePtrs();
+      return zetasql_base::OkStatus();
+    }
+  }
+
+  int64_t GetNumMatchingTuples() const override {
+    return matching_tuples_.size();
+  }
+
+  const TupleData& GetMatchingTuple(int64_t index) const override {
+    return *matching_tuples_[index];
+  }
+
+  zetasql_base::Status RecordMatchingTupleJoined(int64_t index) override {
+    // Matching tuples always come from the current block; the unjoined
+    // tuples exposed by ResetForLeftInput(NULL) never join again.
+    ZETASQL_RET_CHECK_LT(index, block_joined_bits_.size());
+    block_joined_bits_[index] = true;
+    return zetasql_base::OkStatus();
+  }
+
+  zetasql_base::StatusOr<bool> DidMatchingTupleJoin(int64_t index) const override {
+    if (index < block_joined_bits_.size()) return block_joined_bits_[index];
+    return false;
+  }
+
+  std::string DebugString() const override {
+    return right_iter_->DebugString();
+  }
+
+ private:
+  MergeJoinRightInput(absl::Span<const TupleData* const> params,
+                      std::vector<const ExprArg*> left_equality_exprs,
+                      std::vector<const ExprArg*> right_equality_exprs,
+                      std::vector<std::unique_ptr<KeyArg>> keys,
+                      std::unique_ptr<TupleComparator> comparator,
+                      std::unique_ptr<TupleSchema> schema,
+                      std::unique_ptr<TupleIterator> right_iter,
+                      bool collect_unjoined_tuples, EvaluationContext* context)
+      : params_(params.begin(), params.end()),
+        left_equality_exprs_(std::move(left_equality_exprs)),
+        right_equality_exprs_(std::move(right_equality_exprs)),
+        keys_(std::move(keys)),
+        comparator_(std::move(comparator)),
+        schema_(std::move(schema)),
+        right_iter_(std::move(right_iter)),
+        collect_unjoined_tuples_(collect_unjoined_tuples),
+        left_key_(left_equality_exprs_.size()),
+        pending_key_(right_equality_exprs_.size()),
+        block_key_(right_equality_exprs_.size()),
+        block_tuples_(context->memory_accountant()),
+        unjoined_tuples_(context->memory_accountant()),
+        context_(context) {}
+
+  MergeJoinRightInput(const MergeJoinRightInput&) = delete;
+  MergeJoinRightInput& operator=(const MergeJoinRightInput&) = delete;
+
+  // Populates 'key' (which must have one slot per arg) with the values of
+  // 'args' evaluated on 'row'.
+  zetasql_base::Status EvaluateKey(const TupleData& row,
+                           absl::Span<const ExprArg* const> args,
+                           TupleData* key) {
+    ZETASQL_RET_CHECK_EQ(key->num_slots(), args.size());
+    const std::vector<const TupleData*> params_and_row =
+        ConcatSpans(absl::Span<const TupleData* const>(params_), {&row});
+    for (int i = 0; i < args.size(); ++i) {
+      TupleSlot* slot = key->mutable_slot(i);
+      zetasql_base::Status status;
+      if (!args[i]->value_expr()->EvalSimple(params_and_row, context_, slot,
+                                             &status)) {
+        return status;
+      }
+    }
+    return zetasql_base::OkStatus();
+  }
+
+  // Returns true if 'key1' and 'key2' are equal under SQL equality, which is
+  // stricter than both TupleData::==() and the ordering done by
+  // 'comparator_'. In particular, SQL specifies that the result of NULL =
+  // NULL is NULL and that the result of NaN = NaN is false.
+  zetasql_base::StatusOr<bool> SqlEquals(const TupleData& key1, const TupleData& key2) {
+    const ComparisonFunction equals_function(FunctionKind::kEqual,
+                                             types::BoolType());
+    zetasql_base::Status status;
+    for (int i = 0; i < key1.num_slots(); ++i) {
+      Value equals_result;
+      if (!equals_function.Eval({key1.slot(i).value(), key2.slot(i).value()},
+                                context_, &equals_result, &status)) {
+        return status;
+      }
+      if (equals_result != values::Bool(true)) return false;
+    }
+    return true;
+  }
+
+  // Reads the next right tuple and its key into 'pending_tuple_' and
+  // 'pending_key_', or sets 'right_done_' if the stream is exhausted.
+  zetasql_base::Status ReadNextRightTuple() {
+    ZETASQL_RET_CHECK(pending_tuple_ == nullptr);
+    TupleData* tuple = right_iter_->Next();
+    if (tuple == nullptr) {
+      ZETASQL_RETURN_IF_ERROR(right_iter_->Status());
+      right_done_ = true;
+      return zetasql_base::OkStatus();
+    }
+    ZETASQL_RETURN_IF_ERROR(EvaluateKey(*tuple, right_equality_exprs_, &pending_key_));
+    pending_tuple_ = absl::make_unique<TupleData>(*tuple);
+    return zetasql_base::OkStatus();
+  }
+
+  // Moves 'pending_tuple_' (if any) to 'unjoined_tuples_', or frees it if
+  // unjoined tuples do not need to be collected.
+  zetasql_base::Status DiscardPending() {
+    if (pending_tuple_ == nullptr) return zetasql_base::OkStatus();
+    if (collect_unjoined_tuples_) {
+      zetasql_base::Status status;
+      if (!unjoined_tuples_.PushBack(std::move(*pending_tuple_), &status)) {
+        return status;
+      }
+    }
+    pending_tuple_.reset();
+    return zetasql_base::OkStatus();
+  }
+
+  // Starts a new block with 'pending_tuple_' and extends it with all
+  // directly following right tuples whose keys sort as equal.
+  zetasql_base::Status StartBlockFromPending() {
+    ZETASQL_RET_CHECK(block_tuples_.IsEmpty());
+    ZETASQL_RET_CHECK(pending_tuple_ != nullptr);
+    block_key_ = pending_key_;
+    zetasql_base::Status status;
+    if (!block_tuples_.PushBack(std::move(*pending_tuple_), &status)) {
+      return status;
+    }
+    pending_tuple_.reset();
+    while (!right_done_) {
+      ZETASQL_RETURN_IF_ERROR(ReadNextRightTuple());
+      if (pending_tuple_ == nullptr) break;
+      if ((*comparator_)(pending_key_, block_key_) ||
+          (*comparator_)(block_key_, pending_key_)) {
+        break;
+      }
+      if (!block_tuples_.PushBack(std::move(*pending_tuple_), &status)) {
+        return status;
+      }
+      pending_tuple_.reset();
+    }
+    block_joined_bits_.assign(block_tuples_.GetSize(), false);
+    return zetasql_base::OkStatus();
+  }
+
+  // Drops the current block, moving its tuples that never joined to
+  // 'unjoined_tuples_' if they need to be collected.
+  zetasql_base::Status ReleaseBlock() {
+    int64_t i = 0;
+    zetasql_base::Status status;
+    while (!block_tuples_.IsEmpty()) {
+      TupleData tuple = block_tuples_.PopFront();
+      if (collect_unjoined_tuples_ && !block_joined_bits_[i] &&
+          !unjoined_tuples_.PushBack(std::move(tuple), &status)) {
+        return status;
+      }
+      ++i;
+    }
+    block_joined_bits_.clear();
+    return zetasql_base::OkStatus();
+  }
+
+  const std::vector<const TupleData*> params_;
+  // The join equality expressions, reordered to match the sort order of the
+  // inputs.
+  const std::vector<const ExprArg*> left_equality_exprs_;
+  const std::vector<const ExprArg*> right_equality_exprs_;
+  // Owns the KeyArgs referenced by 'comparator_'.
+  const std::vector<std::unique_ptr<KeyArg>> keys_;
+  const std::unique_ptr<TupleComparator> comparator_;
+  const std::unique_ptr<TupleSchema> schema_;
+  const std::unique_ptr<TupleIterator> right_iter_;
+  const bool collect_unjoined_tuples_;
+
+  // The key of the last left tuple passed to ResetForLeftInput(), reused for
+  // every left tuple to avoid allocating a fresh TupleData each time.
+  TupleData left_key_;
+
+  // The next right tuple (and its key) that is not part of the current block,
+  // or NULL if it has been consumed.
+  std::unique_ptr<TupleData> pending_tuple_;
+  TupleData pending_key_;
+  bool right_done_ = false;
+
+  // The buffered right tuples whose keys sort as equal to 'block_key_', and
+  // which of them have joined with some left tuple.
+  TupleData block_key_;
+  TupleDataDeque block_tuples_;
+  std::vector<bool> block_joined_bits_;
+
+  // The right tuples that can no longer join with any left tuple and did not
+  // join with one. Only populated if 'collect_unjoined_tuples_' is true
+  // (i.e., for right outer and full outer joins).
+  TupleDataDeque unjoined_tuples_;
+
+  // What GetMatchingTuple() exposes: the current block if the current left
+  // tuple joins with it, 'unjoined_tuples_' after ResetForLeftInput(NULL),
+  // and nothing otherwise. The TupleDatas are owned by those members.
+  std::vector<const TupleData*> matching_tuples_;
+
+  EvaluationContext* context_;
+};
+
 // Reads the input tuples from 'op' and populates them in 'tuples'. If
 // 'iter_for_debug_string' is non-NULL, populates it with the iterator. (We pass
 // around the iterator instead of the debug std::string to avoid computing the debug
 // std::string unnecessarily.)
-zetasql_base::Status ExtractFromRelationalOp(
-    const RelationalOp* op, absl::Span<const TupleData* const> params,
-    EvaluationContext* context, TupleDataDeque* tuples,
-    std::unique_ptr<TupleIterator>* iter_for_debug_string) {
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> iter,
-                   op->CreateIterator(params, /*num_extra_slots=*/0, context));
+zetasql_base::Status ExtractFromTupleIterator(TupleIterator* iter,
+                                      EvaluationContext* context,
+                                      TupleDataDeque* tuples) {
   tuples->Clear();
   zetasql_base::Status status;
+  int64_t num_rows = 0;
   while (true) {
+    if (num_rows %
+            absl::GetFlag(FLAGS_zetasql_call_verify_not_aborted_rows_period) ==
+        0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
+    ++num_rows;
     TupleData* tuple = iter->Next();
     if (tuple == nullptr) {
       ZETASQL_RETURN_IF_ERROR(iter->Status());
       break;
     }
-    if (!tuples->PushBack(absl::make_unique<TupleData>(*tuple), &status)) {
+    if (!tuples->PushBack(*tuple, &status)) {
       return status;
     }
   }
+  return zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ExtractFromRelationalOp(
+    const RelationalOp* op, absl::Span<const TupleData* const> params,
+    EvaluationContext* context, TupleDataDeque* tuples,
+    std::unique_ptr<TupleIterator>* iter_for_debug_string) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> iter,
+                   op->CreateIterator(params, /*num_extra_slots=*/0, context));
+  ZETASQL_RETURN_IF_ERROR(ExtractFromTupleIterator(iter.get(), context, tuples));
 
   if (iter_for_debug_string != nullptr) {
     *iter_for_debug_string = std::move(iter);
@@ -2317,7 +3318,13 @@ class JoinTupleIterator : public TupleIterator {
  public:
   using JoinKind = JoinOp::JoinKind;
 
-  JoinTupleIterator(JoinKind join_kind,
+  // If 'swapped_inputs' is true, 'left_iter' streams the logical right-hand
+  // side of the join and 'right_input' holds the logical left-hand side. This
+  // is used for inner hash joins that build their hash table on the left-hand
+  // side (see JoinOp::CreateIterator()); the join condition and the output
+  // tuples still see the sides in their logical order. Only supported for
+  // kInnerJoin with empty 'left_outputs' and 'right_outputs'.
+  JoinTupleIterator(JoinKind join_kind, bool swapped_inputs,
                     absl::Span<const TupleData* const> params,
                     const ValueExpr* join_expr,
                     std::unique_ptr<TupleIterator> left_iter,
@@ -2327,7 +3334,9 @@ class JoinTupleIterator : public TupleIterator {
                     std::unique_ptr<TupleSchema> output_schema,
                     int num_extra_slots, EvaluationContext* context)
       : join_kind_(join_kind),
-        params_(params.begin(), params.end()),
+        swapped_inputs_(swapped_inputs),
+        params_and_one_input_(params.begin(), params.end()),
+        params_and_two_inputs_(params.begin(), params.end()),
         join_expr_(join_expr),
         left_iter_(std::move(left_iter)),
         left_outputs_(left_outputs.begin(), left_outputs.end()),
@@ -2335,6 +3344,15 @@ class JoinTupleIterator : public TupleIterator {
         right_outputs_(right_outputs.begin(), right_outputs.end()),
         output_schema_(std::move(output_schema)),
         context_(context) {
+    DCHECK(!swapped_inputs_ || (join_kind_ == JoinKind::kInnerJoin &&
+                                left_outputs_.empty() &&
+                                right_outputs_.empty()));
+    // The trailing entries are reset to the current input tuples on every call
+    // to JoinTuples(); keeping the vectors around avoids allocating new ones
+    // for every pair of tuples considered.
+    params_and_one_input_.push_back(nullptr);
+    params_and_two_inputs_.push_back(nullptr);
+    params_and_two_inputs_.push_back(nullptr);
     output_tuple_.AddSlots(output_schema_->num_variables() + num_extra_slots);
   }
 
@@ -2420,6 +3438,11 @@ class JoinTupleIterator : public TupleIterator {
   zetasql_base::Status Status() const override { return status_; }
 
   std::string DebugString() const override {
+    // With swapped inputs, 'right_input_' holds the logical left-hand side.
+    if (swapped_inputs_) {
+      return JoinOp::GetIteratorDebugString(
+          join_kind_, right_input_->DebugString(), left_iter_->DebugString());
+    }
     return JoinOp::GetIteratorDebugString(join_kind_, left_iter_->DebugString(),
                                           right_input_->DebugString());
   }
@@ -2663,14 +3686,22 @@ class JoinTupleIterator : public TupleIterator {
     }
     ++num_join_tuples_calls_;
 
+    if (swapped_inputs_) {
+      // The streamed input is the logical right-hand side and the stored
+      // input is the logical left-hand side. The rest of this function deals
+      // in logical sides.
+      std::swap(left_input, right_input);
+    }
+
     ZETASQL_RET_CHECK(left_input != nullptr || right_input != nullptr);
     if (left_input != nullptr && right_input != nullptr) {
       TupleSlot slot;
       ::zetasql_base::Status status;
-      if (!join_expr_->EvalSimple(
-              ConcatSpans(absl::Span<const TupleData* const>(params_),
-                          {left_input->data, right_input->data}),
-              context_, &slot, &status)) {
+      params_and_two_inputs_[params_and_two_inputs_.size() - 2] =
+          left_input->data;
+      params_and_two_inputs_.back() = right_input->data;
+      if (!join_expr_->EvalSimple(params_and_two_inputs_, context_, &slot,
+                                  &status)) {
         return status;
       }
       if (slot.value() != Bool(true)) {
@@ -2708,15 +3739,14 @@ class JoinTupleIterator : public TupleIterator {
             ->SetValue(Value::Null(left_outputs_[i]->type()));
       }
     } else {
+      params_and_one_input_.back() = left_input->data;
       for (int i = 0; i < left_outputs_.size(); ++i) {
         const ExprArg* arg = left_outputs_[i];
 
         TupleSlot* slot = output_tuple_.mutable_slot(next_slot_idx + i);
         ::zetasql_base::Status status;
-        if (!arg->value_expr()->EvalSimple(
-                ConcatSpans(absl::Span<const TupleData* const>(params_),
-                            {left_input->data}),
-                context_, slot, &status)) {
+        if (!arg->value_expr()->EvalSimple(params_and_one_input_, context_,
+                                           slot, &status)) {
           return status;
         }
       }
@@ -2752,15 +3782,14 @@ class JoinTupleIterator : public TupleIterator {
             ->SetValue(Value::Null(right_outputs_[i]->type()));
       }
     } else {
+      params_and_one_input_.back() = right_input->data;
       for (int i = 0; i < right_outputs_.size(); ++i) {
         const ExprArg* arg = right_outputs_[i];
 
         TupleSlot* slot = output_tuple_.mutable_slot(next_slot_idx + i);
         ::zetasql_base::Status status;
-        if (!arg->value_expr()->EvalSimple(
-                ConcatSpans(absl::Span<const TupleData* const>(params_),
-                            {right_input->data}),
-                context_, slot, &status)) {
+        if (!arg->value_expr()->EvalSimple(params_and_one_input_, context_,
+                                           slot, &status)) {
           return status;
         }
       }
@@ -2771,7 +3800,15 @@ class JoinTupleIterator : public TupleIterator {
   }
 
   const JoinKind join_kind_;
-  const std::vector<const TupleData*> params_;
+  // If true, 'left_iter_' streams the logical right-hand side and
+  // 'right_input_' holds the logical left-hand side. See the constructor
+  // comment.
+  const bool swapped_inputs_;
+  // The params followed by one entry for the current left or right input
+  // tuple, and the params followed by entries for the current left and right
+  // input tuples.
+  std::vector<const TupleData*> params_and_one_input_;
+  std::vector<const TupleData*> params_and_two_inputs_;
   const ValueExpr* join_expr_;
   std::unique_ptr<TupleIterator> left_iter_;
   const std::vector<const ExprArg*> left_outputs_;
@@ -2806,35 +3843,156 @@ class JoinTupleIterator : public TupleIterator {
   int64_t num_join_tuples_calls_ = 0;
 };
 
+// Returns true if a join with the given equality expressions can be evaluated
+// as a merge join of inputs that are sorted by 'left_sorted_vars' and
+// 'right_sorted_vars' (see RelationalOp::SortedOutputVariables()), i.e., if
+// there is an ordering of the equality expressions such that the i-th left
+// expression dereferences 'left_sorted_vars[i]' and the i-th right expression
+// dereferences 'right_sorted_vars[i]'. If so, populates 'merge_order' with the
+// positions of the equality expressions in that ordering. Requires both sides
+// of each equality expression to have the same type so that one comparator
+// can order the keys of both inputs; in particular, this excludes equalities
+// of the form INT64 = UINT64 (which hash joins support through coercion).
+static bool CanMergeJoinOnSortedInputs(
+    absl::Span<const ExprArg* const> left_equality_exprs,
+    absl::Span<const ExprArg* const> right_equality_exprs,
+    const std::vector<VariableId>& left_sorted_vars,
+    const std::vector<VariableId>& right_sorted_vars,
+    std::vector<int>* merge_order) {
+  const int num_keys = left_equality_exprs.size();
+  if (num_keys == 0 || left_sorted_vars.size() < num_keys ||
+      right_sorted_vars.size() < num_keys) {
+    return false;
+  }
+  merge_order->clear();
+  std::vector<bool> used(num_keys, false);
+  for (int i = 0; i < num_keys; ++i) {
+    int found_expr = -1;
+    for (int j = 0; j < num_keys; ++j) {
+      if (used[j]) continue;
+      const DerefExpr* left_deref =
+          left_equality_exprs[j]->value_expr()->AsDerefExpr();
+      const DerefExpr* right_deref =
+          right_equality_exprs[j]->value_expr()->AsDerefExpr();
+      if (left_deref != nullptr && left_deref->name() == left_sorted_vars[i] &&
+          right_deref != nullptr &&
+          right_deref->name() == right_sorted_vars[i] &&
+          left_equality_exprs[j]->type()->Equals(
+              right_equality_exprs[j]->type())) {
+        found_expr = j;
+        break;
+      }
+    }
+    if (found_expr == -1) return false;
+    used[found_expr] = true;
+    merge_order->push_back(found_expr);
+  }
+  return true;
+}
+
 }  // namespace
 
 zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> JoinOp::CreateIterator(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
   std::unique_ptr<RightInputForJoin> right_hand_side;
+  // The iterator that is streamed against 'right_hand_side'. Normally this is
+  // the left-hand side, but an inner hash join may swap the sides (see below).
+  std::unique_ptr<TupleIterator> stream_iter;
+  bool swapped_inputs = false;
   switch (join_kind_) {
     case kInnerJoin:
     case kLeftOuterJoin:
     case kRightOuterJoin:
     case kFullOuterJoin: {
+      // If both inputs are known to be sorted by the equality expressions, we
+      // can stream them with a merge join instead of loading the right-hand
+      // side into memory. Scrambling undefined orderings destroys the input
+      // orderings (see ReorderingTupleIterator), so don't attempt this if it
+      // is enabled.
+      std::vector<int> merge_order;
+      if (!context->options().scramble_undefined_orderings &&
+          CanMergeJoinOnSortedInputs(hash_join_equality_left_exprs(),
+                                     hash_join_equality_right_exprs(),
+                                     left_input()->SortedOutputVariables(),
+                                     right_input()->SortedOutputVariables(),
+                                     &merge_order)) {
+        ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> right_iter,
+                         right_input()->CreateIterator(
+                             params, /*num_extra_slots=*/0, context));
+        std::vector<const ExprArg*> ordered_left_exprs;
+        std::vector<const ExprArg*> ordered_right_exprs;
+        ordered_left_exprs.reserve(merge_order.size());
+        ordered_right_exprs.reserve(merge_order.size());
+        for (int expr_idx : merge_order) {
+          ordered_left_exprs.push_back(
+              hash_join_equality_left_exprs()[expr_idx]);
+          ordered_right_exprs.push_back(
+              hash_join_equality_right_exprs()[expr_idx]);
+        }
+        const bool collect_unjoined_tuples =
+            join_kind_ == kRightOuterJoin || join_kind_ == kFullOuterJoin;
+        ZETASQL_ASSIGN_OR_RETURN(
+            right_hand_side,
+            MergeJoinRightInput::Create(
+                params, std::move(ordered_left_exprs),
+                std::move(ordered_right_exprs),
+                right_input()->CreateOutputSchema(), std::move(right_iter),
+                collect_unjoined_tuples, context));
+        break;
+      }
+      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<TupleIterator> right_iter,
+                       right_input()->CreateIterator(
+                           params, /*num_extra_slots=*/0, context));
+      // For an inner hash join, the build side (the side that is loaded into
+      // memory) is chosen here rather than at algebrize time: if both input
+      // iterators provide row-count estimates and the left-hand side is
+      // smaller, build the hash table on the left and stream the right. An
+      // inner join is symmetric, so this changes only the output order (which
+      // is undefined for a hash join) and the amount of memory charged to the
+      // accountant for the materialized side.
+      if (join_kind_ == kInnerJoin && !hash_join_equality_left_exprs().empty() &&
+          left_outputs().empty() && right_outputs().empty()) {
+        ZETASQL_ASSIGN_OR_RETURN(stream_iter,
+                         left_input()->CreateIterator(
+                             params, /*num_extra_slots=*/0, context));
+        const absl::optional<int64_t> left_count =
+            stream_iter->ApproximateRowCount();
+        const absl::optional<int64_t> right_count =
+            right_iter->ApproximateRowCount();
+        if (left_count.has_value() && right_count.has_value() &&
+            left_count.value() < right_count.value()) {
+          swapped_inputs = true;
+          // 'stream_iter' currently holds the left-hand side; materialize it
+          // as the build side and stream the right-hand side instead.
+          std::swap(stream_iter, right_iter);
+        }
+      }
       auto tuples =
           absl::make_unique<TupleDataDeque>(context->memory_accountant());
-      std::unique_ptr<TupleIterator> iter_for_right_debug_string;
-      ZETASQL_RETURN_IF_ERROR(ExtractFromRelationalOp(right_input(), params, context,
-                                              tuples.get(),
-                                              &iter_for_right_debug_string));
+      std::unique_ptr<TupleIterator> build_iter = std::move(right_iter);
+      ZETASQL_RETURN_IF_ERROR(
+          ExtractFromTupleIterator(build_iter.get(), context, tuples.get()));
+      const RelationalOp* build_input =
+          swapped_inputs ? left_input() : right_input();
       if (hash_join_equality_left_exprs().empty()) {
         right_hand_side = absl::make_unique<UncorrelatedRightInput>(
-            right_input()->CreateOutputSchema(), std::move(tuples),
-            std::move(iter_for_right_debug_string));
+            build_input->CreateOutputSchema(), std::move(tuples),
+            std::move(build_iter));
       } else {
+        // The first expression list is evaluated against the streamed tuples
+        // to probe the hash table; the second is evaluated against the
+        // materialized tuples to build it.
         ZETASQL_ASSIGN_OR_RETURN(
             right_hand_side,
             UncorrelatedHashedRightInput::Create(
-                params, hash_join_equality_left_exprs(),
-                hash_join_equality_right_exprs(),
-                right_input()->CreateOutputSchema(), std::move(tuples),
-                std::move(iter_for_right_debug_string), context));
+                params,
+                swapped_inputs ? hash_join_equality_right_exprs()
+                               : hash_join_equality_left_exprs(),
+                swapped_inputs ? hash_join_equality_left_exprs()
+                               : hash_join_equality_right_exprs(),
+                build_input->CreateOutputSchema(), std::move(tuples),
+                std::move(build_iter), context));
       }
       break;
     }
@@ -2846,14 +4004,16 @@ zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> JoinOp::CreateIterator(
     }
   }
 
-  ZETASQL_ASSIGN_OR_RETURN(
-      std::unique_ptr<TupleIterator> left_iter,
-      left_input()->CreateIterator(params, /*num_extra_slots=*/0, context));
+  if (stream_iter == nullptr) {
+    ZETASQL_ASSIGN_OR_RETURN(stream_iter,
+                     left_input()->CreateIterator(params, /*num_extra_slots=*/0,
+                                                  context));
+  }
 
   std::unique_ptr<TupleIterator> iter = absl::make_unique<JoinTupleIterator>(
-      join_kind_, params, remaining_join_expr(), std::move(left_iter),
-      left_outputs(), std::move(right_hand_side), right_outputs(),
-      CreateOutputSchema(), num_extra_slots, context);
+      join_kind_, swapped_inputs, params, remaining_join_expr(),
+      std::move(stream_iter), left_outputs(), std::move(right_hand_side),
+      right_outputs(), CreateOutputSchema(), num_extra_slots, context);
   return MaybeReorder(std::move(iter), context);
 }
 
@@ -3068,6 +4228,12 @@ namespace {
 //   the corresponding field of the array element (which must be a struct if
 //   'field_list' is non-empty). This functionality is useful for scanning an
 //   table represented as an array (e.g., in the compliance tests).
+//
+// The output tuples borrow their element Values from 'array_value': copying a
+// Value only increments a refcount on its internal representation, so no
+// element data is materialized per tuple. Slots whose types require
+// SharedProtoState reuse the allocation from the previous element when no
+// consumer retained it, so the scan does not allocate per element either.
 class ArrayScanTupleIterator : public TupleIterator {
  public:
   ArrayScanTupleIterator(
@@ -3083,6 +4249,19 @@ class ArrayScanTupleIterator : public TupleIterator {
         field_list_(field_list.begin(), field_list.end()),
         current_(schema_->num_variables() + num_extra_slots),
         context_(context) {
+    // Precompute which slots must carry SharedProtoState. The types are fixed
+    // for the whole scan, so Next() does not have to look at them per element.
+    const Type* element_type = array_value_.type()->AsArray()->element_type();
+    field_needs_shared_state_.reserve(field_list_.size());
+    for (const ArrayScanOp::FieldArg* field : field_list_) {
+      field_needs_shared_state_.push_back(
+          TupleSlot::ShouldStoreSharedProtoStateFor(
+              element_type->AsStruct()
+                  ->field(field->field_index())
+                  .type->kind()));
+    }
+    element_needs_shared_state_ =
+        TupleSlot::ShouldStoreSharedProtoStateFor(element_type->kind());
     context_->RegisterCancelCallback([this] { return Cancel(); });
   }
 
@@ -3119,17 +4298,20 @@ class ArrayScanTupleIterator : public TupleIterator {
 
     const Value& element = array_value_.element(next_element_idx_);
     for (int i = 0; i < field_list_.size(); ++i) {
-      current_.mutable_slot(i)->SetValue(
-          element.field(field_list_[i]->field_index()));
+      SetSlotToBorrowedValue(element.field(field_list_[i]->field_index()),
+                             field_needs_shared_state_[i],
+                             current_.mutable_slot(i));
     }
     int next_value_idx = field_list_.size();
     if (include_element_) {
-      current_.mutable_slot(next_value_idx)->SetValue(element);
-
+      SetSlotToBorrowedValue(element, element_needs_shared_state_,
+                             current_.mutable_slot(next_value_idx));
       ++next_value_idx;
     }
     if (include_position_) {
-      current_.mutable_slot(next_value_idx)->SetValue(Int64(next_element_idx_));
+      // An INT64 never stores SharedProtoState, so write the Value directly.
+      *current_.mutable_slot(next_value_idx)->mutable_value() =
+          Int64(next_element_idx_);
     }
     ++next_element_idx_;
 
@@ -3148,14 +4330,39 @@ class ArrayScanTupleIterator : public TupleIterator {
   }
 
  private:
+  // Writes 'value' (borrowed from 'array_value_') to 'slot'. Unlike
+  // TupleSlot::SetValue(), if 'slot' must carry SharedProtoState and no one
+  // else still references the state from the previous element, this clears
+  // and reuses that allocation instead of making a new one.
+  static void SetSlotToBorrowedValue(const Value& value,
+                                     bool needs_shared_state,
+                                     TupleSlot* slot) {
+    *slot->mutable_value() = value;
+    if (needs_shared_state) {
+      std::shared_ptr<TupleSlot::SharedProtoState>* shared =
+          slot->mutable_shared_proto_state();
+      if (*shared != nullptr && shared->use_count() == 1) {
+        (*shared)->reset();
+      } else {
+        *shared = std::make_shared<TupleSlot::SharedProtoState>();
+      }
+    }
+  }
+
   const Value array_value_;
   const std::unique_ptr<TupleSchema> schema_;
   const bool include_element_;
   const bool include_position_;
   const std::vector<const ArrayScanOp::FieldArg*> field_list_;
+  // Whether the corresponding slots must carry SharedProtoState, precomputed
+  // from the static types of the array elements and their fields.
+  std::vector<bool> field_needs_shared_state_;
+  bool element_needs_shared_state_ = false;
   TupleData current_;
   int next_element_idx_ = 0;
-  bool cancelled_ = false;
+  // Atomic because Cancel() runs on whatever thread called
+  // EvaluationContext::CancelStatement().
+  std::atomic<bool> cancelled_{false};
   zetasql_base::Status status_;
   EvaluationContext* context_;
 };
@@ -3314,6 +4521,14 @@ namespace {
 // Iterates over the tuples from 'iters'. For each one, produces an output tuple
 // with values given by evaluating the ValueExprs in the corresponding element
 // of 'values'.
+//
+// The inputs are drained sequentially, but the first call to Next() calls
+// StartPrefetch() on all of them, so inputs that can produce tuples in the
+// background (e.g., table scans when
+// EvaluationOptions::max_intra_op_parallelism is greater than 1) fill their
+// bounded prefetch queues concurrently instead of sitting idle until the
+// preceding inputs are exhausted. This overlaps the I/O of the union's
+// branches while keeping all expression evaluation on the calling thread.
 class UnionAllTupleIterator : public TupleIterator {
  public:
   UnionAllTupleIterator(
@@ -3322,19 +4537,32 @@ class UnionAllTupleIterator : public TupleIterator {
       std::unique_ptr<TupleSchema> output_schema, int num_extra_slots,
       std::vector<std::unique_ptr<TupleIterator>> iters,
       EvaluationContext* context)
-      : params_(params.begin(), params.end()),
+      : params_and_current_(params.begin(), params.end()),
         values_(values.begin(), values.end()),
         output_schema_(std::move(output_schema)),
         iters_(std::move(iters)),
         data_(output_schema_->num_variables() + num_extra_slots),
-        context_(context) {}
+        context_(context) {
+    // The last entry is reset to the current input tuple on every row; keeping
+    // the vector around avoids allocating a new one per row.
+    params_and_current_.push_back(nullptr);
+  }
 
   UnionAllTupleIterator(const UnionAllTupleIterator&) = delete;
   UnionAllTupleIterator& operator=(const UnionAllTupleIterator&) = delete;
 
   const TupleSchema& Schema() const override { return *output_schema_; }
 
+  void StartPrefetch() override {
+    if (started_prefetch_) return;
+    started_prefetch_ = true;
+    for (const std::unique_ptr<TupleIterator>& iter : iters_) {
+      iter->StartPrefetch();
+    }
+  }
+
   TupleData* Next() override {
+    StartPrefetch();
     const TupleData* next_input = GetNextInput();
     if (next_input == nullptr) {
       // 'status_' already updated.
@@ -3350,13 +4578,12 @@ class UnionAllTupleIterator : public TupleIterator {
       return nullptr;
     }
 
+    params_and_current_.back() = next_input;
     for (int i = 0; i < values.size(); ++i) {
       TupleSlot* slot = data_.mutable_slot(i);
       ::zetasql_base::Status status;
-      if (!values[i]->value_expr()->EvalSimple(
-              ConcatSpans(absl::Span<const TupleData* const>(params_),
-                          {next_input}),
-              context_, slot, &status)) {
+      if (!values[i]->value_expr()->EvalSimple(params_and_current_, context_,
+                                               slot, &status)) {
         status_ = status;
         return nullptr;
       }
@@ -3397,12 +4624,14 @@ class UnionAllTupleIterator : public TupleIterator {
     }
   }
 
-  const std::vector<const TupleData*> params_;
+  // The params followed by one entry for the current input tuple.
+  std::vector<const TupleData*> params_and_current_;
   const std::vector<absl::Span<const ExprArg* const>> values_;
   const std::unique_ptr<TupleSchema> output_schema_;
 
   std::vector<std::unique_ptr<TupleIterator>> iters_;
   int iter_idx_ = 0;  // Index of the current iterator in 'iters_'.
+  bool started_prefetch_ = false;
   TupleData data_;
   zetasql_base::Status status_;
   EvaluationContext* context_;
@@ -3527,7 +4756,10 @@ RelationalOp* UnionAllOp::mutable_rel(int i) {
 ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> RootOp::CreateIterator(
     absl::Span<const TupleData* const> params, int num_extra_slots,
     EvaluationContext* context) const {
-  return input()->CreateIterator(params, num_extra_slots, context);
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<TupleIterator> iter,
+      input()->CreateIterator(params, num_extra_slots, context));
+  return MaybeProfile(std::move(iter), context);
 }
 
 std::unique_ptr<TupleSchema> RootOp::CreateOutputSchema() const {
@@ -40,6 +40,7 @@
 #include "zetasql/reference_impl/tuple.h"
 #include "zetasql/reference_impl/tuple_test_util.h"
 #include "zetasql/reference_impl/variable_id.h"
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/testdata/test_schema.pb.h"
 #include "zetasql/testing/test_value.h"
@@ -676,6 +677,179 @@ TEST_F(CreateIteratorTest, EvaluatorTableScanOp) {
   EXPECT_FALSE(iter->PreservesOrder());
 }
 
+TEST_F(CreateIteratorTest, EvaluatorTableScanOpPushedDownFilter) {
+  VariableId x("x"), y("y");
+  SimpleTable table("TestTable", {{"column0", types::Int64Type()},
+                                  {"column1", types::StringType()}});
+  table.SetContents({{Int64(10), String("foo1")},
+                     {Int64(20), String("foo2")},
+                     {Int64(30), String("foo3")}});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto element, ConstExpr::Create(Int64(20)));
+  std::vector<std::unique_ptr<ValueExpr>> elements;
+  elements.push_back(std::move(element));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto filter, InListColumnFilterArg::Create(x, /*column_idx=*/0,
+                                                 std::move(elements)));
+  std::vector<std::unique_ptr<ColumnFilterArg>> and_filters;
+  and_filters.push_back(std::move(filter));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto scan_op,
+      EvaluatorTableScanOp::Create(&table, /*alias=*/"", {0, 1},
+                                   {"column0", "column1"}, {x, y},
+                                   std::move(and_filters)));
+  ZETASQL_ASSERT_OK(scan_op->SetSchemasForEvaluation(/*params_schemas=*/{}));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  // The SimpleTable iterator enforces the pushed-down filter, so the
+  // non-matching rows are skipped inside the scan instead of being
+  // materialized and discarded above it.
+  ASSERT_EQ(data.size(), 1);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(20), IsNull()),
+                          IsTupleSlotWith(String("foo2"), IsNull()), _));
+}
+
+TEST_F(CreateIteratorTest, EvaluatorTableScanOpPrefetch) {
+  VariableId x("x"), y("y");
+  SimpleTable table("TestTable", {{"column0", types::Int64Type()},
+                                  {"column1", types::StringType()}});
+  // Use enough rows that the background thread has to block on the bounded
+  // prefetch queue.
+  const int kNumRows = 200;
+  std::vector<std::vector<Value>> contents;
+  contents.reserve(kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    contents.push_back({Int64(i), String(absl::StrCat("foo", i))});
+  }
+  table.SetContents(contents);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto scan_op,
+      EvaluatorTableScanOp::Create(&table, /*alias=*/"", {0, 1},
+                                   {"column0", "column1"}, {x, y},
+                                   /*and_filters=*/{}));
+
+  EvaluationOptions options;
+  options.max_intra_op_parallelism = 2;
+  EvaluationContext context(options);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(),
+            "PrefetchingTupleIterator(EvaluatorTableTupleIterator(TestTable))");
+  EXPECT_TRUE(iter->PreservesOrder());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    EXPECT_THAT(
+        data[i].slots(),
+        ElementsAre(IsTupleSlotWith(Int64(i), IsNull()),
+                    IsTupleSlotWith(String(absl::StrCat("foo", i)), IsNull()),
+                    _))
+        << "row " << i;
+  }
+
+  // Destroying the iterator before it is exhausted must join the background
+  // thread cleanly.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  ASSERT_TRUE(iter->Next() != nullptr);
+  iter.reset();
+}
+
+TEST_F(CreateIteratorTest, EvaluatorTableScanOpPrefetchQueueSize) {
+  VariableId x("x");
+  SimpleTable table("TestTable", {{"column0", types::Int64Type()}});
+  const int kNumRows = 50;
+  std::vector<std::vector<Value>> contents;
+  contents.reserve(kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    contents.push_back({Int64(i)});
+  }
+  table.SetContents(contents);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto scan_op,
+                       EvaluatorTableScanOp::Create(&table, /*alias=*/"", {0},
+                                                    {"column0"}, {x},
+                                                    /*and_filters=*/{}));
+
+  // A queue of depth 1 forces the background thread to block after every
+  // prefetched row; the rows must still come back complete and in order.
+  EvaluationOptions options;
+  options.max_intra_op_parallelism = 2;
+  options.scan_prefetch_queue_size = 1;
+  EvaluationContext context(options);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    EXPECT_EQ(data[i].slot(0).value(), Int64(i)) << "row " << i;
+  }
+}
+
+TEST_F(CreateIteratorTest, EvaluatorTableScanOpPrefetchOnSharedScheduler) {
+  VariableId x("x"), y("y");
+  SimpleTable table("TestTable", {{"column0", types::Int64Type()},
+                                  {"column1", types::StringType()}});
+  const int kNumRows = 200;
+  std::vector<std::vector<Value>> contents;
+  contents.reserve(kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    contents.push_back({Int64(i), String(absl::StrCat("foo", i))});
+  }
+  table.SetContents(contents);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto scan_op,
+      EvaluatorTableScanOp::Create(&table, /*alias=*/"", {0, 1},
+                                   {"column0", "column1"}, {x, y},
+                                   /*and_filters=*/{}));
+
+  // With a scheduler configured, the prefetching runs as tasks on the shared
+  // pool instead of on a thread dedicated to this evaluation.
+  EvaluationOptions options;
+  options.max_intra_op_parallelism = 2;
+  options.scheduler = std::make_shared<WorkStealingScheduler>(
+      /*num_threads=*/2);
+  EvaluationContext context(options);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(),
+            "PrefetchingTupleIterator(EvaluatorTableTupleIterator(TestTable))");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    EXPECT_THAT(
+        data[i].slots(),
+        ElementsAre(IsTupleSlotWith(Int64(i), IsNull()),
+                    IsTupleSlotWith(String(absl::StrCat("foo", i)), IsNull()),
+                    _))
+        << "row " << i;
+  }
+
+  // Destroying the iterator before it is exhausted must wait for the
+  // in-flight prefetch task cleanly.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  ASSERT_TRUE(iter->Next() != nullptr);
+  iter.reset();
+}
+
 TEST_F(CreateIteratorTest, EvaluatorTableScanOpWithColumnFilter) {
   VariableId x("x"), y("y"), z("z");
   EvaluatorTestTable table(
@@ -1615,6 +1789,83 @@ TEST_F(CreateIteratorTest, FullOuterAllRightTuplesJoin) {
                        HasSubstr("Out of memory")));
 }
 
+TEST_F(CreateIteratorTest, InnerHashJoinBuildsOnSmallerSide) {
+  VariableId x("x"), y("y");
+
+  // Creates x = y inner hash joins of a two-row left-hand side and a four-row
+  // right-hand side. If 'provide_row_count_hints' is true, the inputs report
+  // row-count estimates, which lets the join build its hash table on the
+  // smaller (left) side and stream the right-hand side.
+  const auto create_join_op =
+      [&x, &y](bool provide_row_count_hints)
+      -> zetasql_base::StatusOr<std::unique_ptr<JoinOp>> {
+    auto input1 = absl::WrapUnique(new TestRelationalOp(
+        {x}, CreateTestTupleDatas({{Int64(1)}, {Int64(2)}}),
+        /*preserves_order=*/true, provide_row_count_hints));
+    auto input2 = absl::WrapUnique(new TestRelationalOp(
+        {y}, CreateTestTupleDatas({{Int64(2)}, {Int64(3)}, {Int64(1)},
+                                   {Int64(2)}}),
+        /*preserves_order=*/true, provide_row_count_hints));
+
+    ZETASQL_ASSIGN_OR_RETURN(auto deref_x, DerefExpr::Create(x, Int64Type()));
+    ZETASQL_ASSIGN_OR_RETURN(auto deref_y, DerefExpr::Create(y, Int64Type()));
+    std::vector<JoinOp::HashJoinEqualityExprs> equality_exprs(1);
+    equality_exprs[0].left_expr =
+        absl::make_unique<ExprArg>(std::move(deref_x));
+    equality_exprs[0].right_expr =
+        absl::make_unique<ExprArg>(std::move(deref_y));
+
+    ZETASQL_ASSIGN_OR_RETURN(auto condition, ConstExpr::Create(Bool(true)));
+    return JoinOp::Create(JoinOp::kInnerJoin, std::move(equality_exprs),
+                          std::move(condition), std::move(input1),
+                          std::move(input2),
+                          /*left_outputs=*/{}, /*right_outputs=*/{});
+  };
+
+  EvaluationContext context((EvaluationOptions()));
+
+  // Without row-count estimates the right-hand side is the build side, so the
+  // output order follows the left-hand side.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto join_op,
+                       create_join_op(/*provide_row_count_hints=*/false));
+  ZETASQL_ASSERT_OK(join_op->SetSchemasForEvaluation(/*params_schemas=*/{}));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      join_op->CreateIterator({}, /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(1), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()), _));
+  EXPECT_THAT(data[2].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()), _));
+
+  // With row-count estimates the smaller left-hand side becomes the build
+  // side and the right-hand side is streamed, so the output order follows the
+  // right-hand side. The joined rows are the same.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(join_op,
+                       create_join_op(/*provide_row_count_hints=*/true));
+  ZETASQL_ASSERT_OK(join_op->SetSchemasForEvaluation(/*params_schemas=*/{}));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter, join_op->CreateIterator({}, /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(data, ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(1), IsNull()), _));
+  EXPECT_THAT(data[2].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()), _));
+}
+
 TEST_F(CreateIteratorTest, CrossApply) {
   VariableId x("x"), x2("x2"), y("y"), z("z"), p("p");
 
@@ -2319,146 +2570,652 @@ TEST_F(CreateIteratorTest, FullOuterHashJoin) {
                        HasSubstr("Out of memory")));
 }
 
-TEST_F(CreateIteratorTest, SortOpTotalOrder) {
-  VariableId a("a"), b("b"), c("c"), param("param"), k("k"), v1("v1"), v2("v2"),
-      v3("v3");
-
-  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+// A TestRelationalOp that reports its rows as being sorted by its variables
+// (see RelationalOp::SortedOutputVariables()) and whose iterator returns
+// 'end_status' once the rows are exhausted.
+class SortedTestRelationalOp : public TestRelationalOp {
+ public:
+  SortedTestRelationalOp(const std::vector<VariableId>& variables,
+                         const std::vector<TupleData>& values,
+                         const zetasql_base::Status& end_status)
+      : TestRelationalOp(variables, values, /*preserves_order=*/true),
+        variables_(variables),
+        values_(values),
+        end_status_(end_status) {}
+
+  ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+      absl::Span<const TupleData* const> /*params*/, int num_extra_slots,
+      EvaluationContext* context) const override {
+    std::vector<TupleData> iter_values = values_;
+    for (TupleData& data : iter_values) {
+      data.AddSlots(num_extra_slots);
+    }
+    std::unique_ptr<TupleIterator> iter = absl::make_unique<TestTupleIterator>(
+        variables_, iter_values, /*preserves_order=*/true, end_status_);
+    return iter;
+  }
 
-  std::vector<std::unique_ptr<KeyArg>> keys;
-  keys.push_back(
-      absl::make_unique<KeyArg>(k, std::move(deref_a), KeyArg::kDescending));
+  std::vector<VariableId> SortedOutputVariables() const override {
+    return variables_;
+  }
 
-  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
-  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_c, DerefExpr::Create(c, proto_type_));
-  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_param, DerefExpr::Create(param, Int64Type()));
+ private:
+  const std::vector<VariableId> variables_;
+  const std::vector<TupleData> values_;
+  const zetasql_base::Status end_status_;
+};
 
-  std::vector<std::unique_ptr<ExprArg>> values;
-  values.push_back(absl::make_unique<ExprArg>(v1, std::move(deref_b)));
-  values.push_back(absl::make_unique<ExprArg>(v2, std::move(deref_c)));
-  values.push_back(absl::make_unique<ExprArg>(v3, std::move(deref_param)));
+TEST_F(CreateIteratorTest, InnerMergeJoin) {
+  VariableId x1("x1"), x2("x2"), y1("y1"), y2("y2");
 
-  std::vector<std::vector<const SharedProtoState*>> shared_states;
-  auto input = absl::WrapUnique(new TestRelationalOp(
-      {a, b, c},
-      CreateTestTupleDatas({{NullInt64(), Int64(10), GetProtoValue(1)},
-                            {Int64(2), Int64(20), GetProtoValue(2)},
-                            {Int64(3), Int64(30), GetProtoValue(3)}},
-                           &shared_states),
-      /*preserves_order=*/true));
+  std::vector<std::vector<const SharedProtoState*>> shared_states1;
+  auto input1 = absl::make_unique<SortedTestRelationalOp>(
+      std::vector<VariableId>{x1, x2},
+      CreateTestTupleDatas({{Int64(1), Int64(10)},
+                            {Int64(2), Int64(20)},
+                            {Int64(2), Int64(21)},
+                            {Int64(4), Int64(40)}},
+                           &shared_states1),
+      /*end_status=*/zetasql_base::OkStatus());
+
+  // The right-hand side returns an error if it is read to the end. A merge
+  // join stops reading it after the last key of the left-hand side, so this
+  // error verifies that the right-hand side is streamed instead of being
+  // loaded into memory.
+  std::vector<std::vector<const SharedProtoState*>> shared_states2;
+  auto input2 = absl::make_unique<SortedTestRelationalOp>(
+      std::vector<VariableId>{y1, y2},
+      CreateTestTupleDatas({{Int64(2), Int64(200)},
+                            {Int64(2), Int64(201)},
+                            {Int64(3), Int64(300)},
+                            {Int64(4), Int64(400)},
+                            {Int64(6), Int64(600)}},
+                           &shared_states2),
+      /*end_status=*/zetasql_base::Status(zetasql_base::INTERNAL,
+                                          "Right-hand side read to the end"));
 
-  ZETASQL_ASSERT_OK_AND_ASSIGN(
-      auto sort_op,
-      SortOp::Create(std::move(keys), std::move(values),
-                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
-                     /*is_order_preserving=*/true,
-                     /*is_stable_sort=*/false));
-  EXPECT_EQ(sort_op->IteratorDebugString(),
-            "SortTupleIterator(TestTupleIterator)");
-  EXPECT_EQ(sort_op->DebugString(),
-            "SortOp(ordered\n"
-            "+-keys: {\n"
-            "| +-$k := $a DESC},\n"
-            "+-values: {\n"
-            "| +-$v1 := $b,\n"
-            "| +-$v2 := $c,\n"
-            "| +-$v3 := $param},\n"
-            "+-input: TestRelationalOp)");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x1, DerefExpr::Create(x1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y1, DerefExpr::Create(y1, Int64Type()));
 
-  std::unique_ptr<TupleSchema> output_schema = sort_op->CreateOutputSchema();
-  EXPECT_THAT(output_schema->variables(), ElementsAre(k, v1, v2, v3));
+  VariableId a("a"), b("b");
+  JoinOp::HashJoinEqualityExprs equality_expr;
+  equality_expr.left_expr = absl::make_unique<ExprArg>(a, std::move(deref_x1));
+  equality_expr.right_expr = absl::make_unique<ExprArg>(b, std::move(deref_y1));
 
-  EvaluationContext context((EvaluationOptions()));
+  std::vector<JoinOp::HashJoinEqualityExprs> equality_exprs;
+  equality_exprs.push_back(std::move(equality_expr));
 
-  TupleSchema params_schema({param});
-  ZETASQL_ASSERT_OK(sort_op->SetSchemasForEvaluation({&params_schema}));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr, ConstExpr::Create(Bool(true)));
 
-  TupleData params_data = CreateTestTupleData({Int64(100)});
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto join_op,
+      JoinOp::Create(JoinOp::kInnerJoin, std::move(equality_exprs),
+                     std::move(true_expr), std::move(input1), std::move(input2),
+                     /*left_outputs=*/{}, /*right_outputs=*/{}));
+  ZETASQL_ASSERT_OK(join_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
 
+  EvaluationContext context((EvaluationOptions()));
   ZETASQL_ASSERT_OK_AND_ASSIGN(
       std::unique_ptr<TupleIterator> iter,
-      sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1, &context));
-
-  EXPECT_EQ(iter->DebugString(), "SortTupleIterator(TestTupleIterator)");
+      join_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(),
+            "JoinTupleIterator(INNER, "
+            "left=TestTupleIterator, right=TestTupleIterator)");
   EXPECT_TRUE(iter->PreservesOrder());
   ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
                        ReadFromTupleIterator(iter.get()));
-  ASSERT_EQ(data.size(), 3);
+  ASSERT_EQ(data.size(), 5);
   EXPECT_THAT(data[0].slots(),
-              ElementsAre(IsTupleSlotWith(Int64(3), IsNull()),
-                          IsTupleSlotWith(Int64(30), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(3),
-                                          HasRawPointer(shared_states[2][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
-  EXPECT_THAT(data[1].slots(),
               ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
                           IsTupleSlotWith(Int64(20), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(2),
-                                          HasRawPointer(shared_states[1][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
-  EXPECT_THAT(data[2].slots(),
-              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
-                          IsTupleSlotWith(Int64(10), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(1),
-                                          HasRawPointer(shared_states[0][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
-
-  // Do it again with cancellation.
-  context.ClearDeadlineAndCancellationState();
-  ZETASQL_ASSERT_OK_AND_ASSIGN(
-      iter,
-      sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1, &context));
-  ZETASQL_ASSERT_OK(context.CancelStatement());
-  zetasql_base::Status status;
-  data = ReadFromTupleIteratorFull(iter.get(), &status);
-  EXPECT_TRUE(data.empty());
-  EXPECT_THAT(status, StatusIs(zetasql_base::CANCELLED, _));
-
-  // Check that enabling scrambling has no effect because the output is uniquely
-  // ordered.
-  EvaluationContext scramble_context(GetScramblingEvaluationOptions());
-  ZETASQL_ASSERT_OK_AND_ASSIGN(
-      iter, sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1,
-                                    &scramble_context));
-  EXPECT_EQ(iter->DebugString(), "SortTupleIterator(TestTupleIterator)");
-  EXPECT_TRUE(iter->PreservesOrder());
-  ZETASQL_ASSERT_OK_AND_ASSIGN(data, ReadFromTupleIterator(iter.get()));
-  ASSERT_EQ(data.size(), 3);
-  EXPECT_THAT(data[0].slots(),
-              ElementsAre(IsTupleSlotWith(Int64(3), IsNull()),
-                          IsTupleSlotWith(Int64(30), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(3),
-                                          HasRawPointer(shared_states[2][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
+                          IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(200), IsNull()), _));
   EXPECT_THAT(data[1].slots(),
               ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
                           IsTupleSlotWith(Int64(20), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(2),
-                                          HasRawPointer(shared_states[1][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
+                          IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(201), IsNull()), _));
   EXPECT_THAT(data[2].slots(),
-              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
-                          IsTupleSlotWith(Int64(10), IsNull()),
-                          IsTupleSlotWith(GetProtoValue(1),
-                                          HasRawPointer(shared_states[0][2])),
-                          IsTupleSlotWith(Int64(100), IsNull()), _));
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(21), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(200), IsNull()), _));
+  EXPECT_THAT(data[3].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(21), IsNull()),
+                          IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(201), IsNull()), _));
+  EXPECT_THAT(data[4].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(4), IsNull()),
+                          IsTupleSlotWith(Int64(40), IsNull()),
+                          IsTupleSlotWith(Int64(4), IsNull()),
+                          IsTupleSlotWith(Int64(400), IsNull()), _));
 
-  // Check that if the memory bound is too low, we return an error.
-  EvaluationContext memory_context(GetIntermediateMemoryEvaluationOptions(
-      /*total_bytes=*/500));
-  EXPECT_THAT(sort_op->CreateIterator({&params_data},
-                                      /*num_extra_slots=*/1, &memory_context),
-              StatusIs(zetasql_base::StatusCode::kResourceExhausted,
-                       HasSubstr("Out of memory")));
+  // Scrambling destroys the input orderings, so the join must fall back to a
+  // hash join, which loads the entire right-hand side into memory and
+  // therefore returns the error from the right-hand side.
+  EvaluationContext scramble_context(GetScramblingEvaluationOptions());
+  EXPECT_THAT(join_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1,
+                                      &scramble_context),
+              StatusIs(zetasql_base::INTERNAL,
+                       "Right-hand side read to the end"));
 }
 
-TEST_F(CreateIteratorTest, SortOpIgnoresOrder) {
-  VariableId a("a"), b("b"), k("k"), v("v");
+TEST_F(CreateIteratorTest, FullOuterMergeJoin) {
+  VariableId x1("x1"), x2("x2"), x1_prime("x1'"), x2_prime("x2'"), y1("y1"),
+      y2("y2"), y1_prime("y1'"), y2_prime("y2'");
 
-  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::vector<const SharedProtoState*>> shared_states1;
+  auto input1 = absl::make_unique<SortedTestRelationalOp>(
+      std::vector<VariableId>{x1, x2},
+      CreateTestTupleDatas({{NullInt64(), Int64(5)},
+                            {Int64(1), Int64(10)},
+                            {Int64(2), Int64(20)},
+                            {Int64(4), Int64(40)}},
+                           &shared_states1),
+      /*end_status=*/zetasql_base::OkStatus());
 
-  std::vector<std::unique_ptr<KeyArg>> keys;
-  keys.push_back(
+  std::vector<std::vector<const SharedProtoState*>> shared_states2;
+  auto input2 = absl::make_unique<SortedTestRelationalOp>(
+      std::vector<VariableId>{y1, y2},
+      CreateTestTupleDatas({{NullInt64(), Int64(99)},
+                            {Int64(0), Int64(100)},
+                            {Int64(1), Int64(101)},
+                            {Int64(1), Int64(102)},
+                            {Int64(3), Int64(103)},
+                            {Int64(4), Int64(104)}},
+                           &shared_states2),
+      /*end_status=*/zetasql_base::OkStatus());
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x1, DerefExpr::Create(x1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y1, DerefExpr::Create(y1, Int64Type()));
+
+  VariableId a("a"), b("b");
+  JoinOp::HashJoinEqualityExprs equality_expr;
+  equality_expr.left_expr = absl::make_unique<ExprArg>(a, std::move(deref_x1));
+  equality_expr.right_expr = absl::make_unique<ExprArg>(b, std::move(deref_y1));
+
+  std::vector<JoinOp::HashJoinEqualityExprs> equality_exprs;
+  equality_exprs.push_back(std::move(equality_expr));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr, ConstExpr::Create(Bool(true)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x1_output,
+                       DerefExpr::Create(x1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_x2_output,
+                       DerefExpr::Create(x2, Int64Type()));
+
+  std::vector<std::unique_ptr<ExprArg>> left_outputs;
+  left_outputs.push_back(
+      absl::make_unique<ExprArg>(x1_prime, std::move(deref_x1_output)));
+  left_outputs.push_back(
+      absl::make_unique<ExprArg>(x2_prime, std::move(deref_x2_output)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y1_output,
+                       DerefExpr::Create(y1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_y2_output,
+                       DerefExpr::Create(y2, Int64Type()));
+
+  std::vector<std::unique_ptr<ExprArg>> right_outputs;
+  right_outputs.push_back(
+      absl::make_unique<ExprArg>(y1_prime, std::move(deref_y1_output)));
+  right_outputs.push_back(
+      absl::make_unique<ExprArg>(y2_prime, std::move(deref_y2_output)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto join_op,
+      JoinOp::Create(JoinOp::kFullOuterJoin, std::move(equality_exprs),
+                     std::move(true_expr), std::move(input1), std::move(input2),
+                     std::move(left_outputs), std::move(right_outputs)));
+  ZETASQL_ASSERT_OK(join_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      join_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(),
+            "JoinTupleIterator(FULL OUTER, "
+            "left=TestTupleIterator, right=TestTupleIterator)");
+  EXPECT_TRUE(iter->PreservesOrder());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 8);
+  // The NULL key on the left-hand side does not join with the NULL key on the
+  // right-hand side.
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(5), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()),
+                          IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(101), IsNull()), _));
+  EXPECT_THAT(data[2].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()),
+                          IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(102), IsNull()), _));
+  EXPECT_THAT(data[3].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()), _));
+  EXPECT_THAT(data[4].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(4), IsNull()),
+                          IsTupleSlotWith(Int64(40), IsNull()),
+                          IsTupleSlotWith(Int64(4), IsNull()),
+                          IsTupleSlotWith(Int64(104), IsNull()), _));
+  // The right-hand tuples that did not join are left-padded with NULLs in the
+  // order in which they were read.
+  EXPECT_THAT(data[5].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(99), IsNull()), _));
+  EXPECT_THAT(data[6].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(0), IsNull()),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+  EXPECT_THAT(data[7].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(3), IsNull()),
+                          IsTupleSlotWith(Int64(103), IsNull()), _));
+}
+
+TEST_F(CreateIteratorTest, SortOpSortedOutputVariables) {
+  VariableId a("a"), b("b"), k1("k1"), k2("k2"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_key1, DerefExpr::Create(a, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b_key1, DerefExpr::Create(b, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys1;
+  keys1.push_back(absl::make_unique<KeyArg>(k1, std::move(deref_a_key1),
+                                            KeyArg::kAscending));
+  keys1.push_back(absl::make_unique<KeyArg>(k2, std::move(deref_b_key1),
+                                            KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_value1, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ExprArg>> values1;
+  values1.push_back(absl::make_unique<ExprArg>(v, std::move(deref_a_value1)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states;
+  auto input1 = absl::WrapUnique(new TestRelationalOp(
+      {a, b}, CreateTestTupleDatas({{Int64(1), Int64(2)}}, &shared_states),
+      /*preserves_order=*/true));
+  // The input does not report any sorted output variables.
+  EXPECT_TRUE(input1->SortedOutputVariables().empty());
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op1,
+      SortOp::Create(std::move(keys1), std::move(values1),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input1),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  EXPECT_THAT(sort_op1->SortedOutputVariables(), ElementsAre(k1, k2));
+
+  // Only the longest prefix of ascending keys with the default ordering of
+  // NULLs is reported.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_key2, DerefExpr::Create(a, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b_key2, DerefExpr::Create(b, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys2;
+  keys2.push_back(absl::make_unique<KeyArg>(k1, std::move(deref_a_key2),
+                                            KeyArg::kAscending));
+  keys2.push_back(absl::make_unique<KeyArg>(k2, std::move(deref_b_key2),
+                                            KeyArg::kDescending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_value2, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ExprArg>> values2;
+  values2.push_back(absl::make_unique<ExprArg>(v, std::move(deref_a_value2)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states2;
+  auto input2 = absl::WrapUnique(new TestRelationalOp(
+      {a, b}, CreateTestTupleDatas({{Int64(1), Int64(2)}}, &shared_states2),
+      /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op2,
+      SortOp::Create(std::move(keys2), std::move(values2),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input2),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  EXPECT_THAT(sort_op2->SortedOutputVariables(), ElementsAre(k1));
+}
+
+TEST_F(CreateIteratorTest, SortOpCollectMayBufferRowsOps) {
+  VariableId a("a"), k("k"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_key, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
+      absl::make_unique<KeyArg>(k, std::move(deref_a_key), KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_value, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(absl::make_unique<ExprArg>(v, std::move(deref_a_value)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states;
+  auto input = absl::WrapUnique(new TestRelationalOp(
+      {a}, CreateTestTupleDatas({{Int64(1)}}, &shared_states),
+      /*preserves_order=*/true));
+  EXPECT_FALSE(input->may_buffer_rows());
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op,
+      SortOp::Create(std::move(keys), std::move(values),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  EXPECT_TRUE(sort_op->may_buffer_rows());
+
+  // The input streams, so the sort is the only operator in the tree that may
+  // buffer rows.
+  std::vector<std::string> buffering_ops;
+  sort_op->CollectMayBufferRowsOps(&buffering_ops);
+  EXPECT_THAT(buffering_ops,
+              ElementsAre("SortTupleIterator(TestTupleIterator)"));
+}
+
+TEST_F(CreateIteratorTest, SortOpInvokesYieldCallback) {
+  VariableId a("a"), k("k"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_key, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
+      absl::make_unique<KeyArg>(k, std::move(deref_a_key), KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_value, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(absl::make_unique<ExprArg>(v, std::move(deref_a_value)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states;
+  auto input = absl::WrapUnique(new TestRelationalOp(
+      {a}, CreateTestTupleDatas({{Int64(2)}, {Int64(1)}}, &shared_states),
+      /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op,
+      SortOp::Create(std::move(keys), std::move(values),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  ZETASQL_ASSERT_OK(sort_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationContext context((EvaluationOptions()));
+  int num_yields = 0;
+  context.SetYieldCallback([&num_yields]() { ++num_yields; });
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  EXPECT_EQ(data.size(), 2);
+  EXPECT_GT(num_yields, 0);
+
+  // A scheduler that suspends the statement in the yield callback can abort it
+  // by cancelling before resuming. The materialization loop checks for
+  // cancellation, so the error surfaces from CreateIterator() itself.
+  context.ClearDeadlineAndCancellationState();
+  context.SetYieldCallback([&context]() {
+    const zetasql_base::Status status = context.CancelStatement();
+    EXPECT_TRUE(status.ok()) << status;
+  });
+  EXPECT_THAT(
+      sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context),
+      StatusIs(zetasql_base::CANCELLED, _));
+}
+
+TEST_F(CreateIteratorTest, SortOpCollectsOperatorStats) {
+  VariableId a("a"), k("k"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_key, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
+      absl::make_unique<KeyArg>(k, std::move(deref_a_key), KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_value, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(absl::make_unique<ExprArg>(v, std::move(deref_a_value)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states;
+  auto input = absl::WrapUnique(new TestRelationalOp(
+      {a}, CreateTestTupleDatas({{Int64(2)}, {Int64(1)}}, &shared_states),
+      /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op,
+      SortOp::Create(std::move(keys), std::move(values),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  ZETASQL_ASSERT_OK(sort_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationOptions options;
+  options.collect_operator_stats = true;
+  EvaluationContext context(options);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  EXPECT_EQ(data.size(), 2);
+
+  const auto& stats = context.operator_stats();
+  const auto it = stats.find(sort_op.get());
+  ASSERT_TRUE(it != stats.end());
+  EXPECT_EQ(it->second.num_iterators_created, 1);
+  EXPECT_EQ(it->second.num_output_rows, 2);
+  EXPECT_GE(it->second.cumulative_nanos, 0);
+}
+
+TEST_F(CreateIteratorTest, SortOpTotalOrder) {
+  VariableId a("a"), b("b"), c("c"), param("param"), k("k"), v1("v1"), v2("v2"),
+      v3("v3");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
+      absl::make_unique<KeyArg>(k, std::move(deref_a), KeyArg::kDescending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_c, DerefExpr::Create(c, proto_type_));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_param, DerefExpr::Create(param, Int64Type()));
+
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(absl::make_unique<ExprArg>(v1, std::move(deref_b)));
+  values.push_back(absl::make_unique<ExprArg>(v2, std::move(deref_c)));
+  values.push_back(absl::make_unique<ExprArg>(v3, std::move(deref_param)));
+
+  std::vector<std::vector<const SharedProtoState*>> shared_states;
+  auto input = absl::WrapUnique(new TestRelationalOp(
+      {a, b, c},
+      CreateTestTupleDatas({{NullInt64(), Int64(10), GetProtoValue(1)},
+                            {Int64(2), Int64(20), GetProtoValue(2)},
+                            {Int64(3), Int64(30), GetProtoValue(3)}},
+                           &shared_states),
+      /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op,
+      SortOp::Create(std::move(keys), std::move(values),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  EXPECT_EQ(sort_op->IteratorDebugString(),
+            "SortTupleIterator(TestTupleIterator)");
+  EXPECT_EQ(sort_op->DebugString(),
+            "SortOp(ordered\n"
+            "+-keys: {\n"
+            "| +-$k := $a DESC},\n"
+            "+-values: {\n"
+            "| +-$v1 := $b,\n"
+            "| +-$v2 := $c,\n"
+            "| +-$v3 := $param},\n"
+            "+-input: TestRelationalOp)");
+
+  std::unique_ptr<TupleSchema> output_schema = sort_op->CreateOutputSchema();
+  EXPECT_THAT(output_schema->variables(), ElementsAre(k, v1, v2, v3));
+
+  EvaluationContext context((EvaluationOptions()));
+
+  TupleSchema params_schema({param});
+  ZETASQL_ASSERT_OK(sort_op->SetSchemasForEvaluation({&params_schema}));
+
+  TupleData params_data = CreateTestTupleData({Int64(100)});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1, &context));
+
+  EXPECT_EQ(iter->DebugString(), "SortTupleIterator(TestTupleIterator)");
+  EXPECT_TRUE(iter->PreservesOrder());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(3), IsNull()),
+                          IsTupleSlotWith(Int64(30), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(3),
+                                          HasRawPointer(shared_states[2][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(2),
+                                          HasRawPointer(shared_states[1][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+  EXPECT_THAT(data[2].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(1),
+                                          HasRawPointer(shared_states[0][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+
+  // Do it again with cancellation.
+  context.ClearDeadlineAndCancellationState();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter,
+      sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK(context.CancelStatement());
+  zetasql_base::Status status;
+  data = ReadFromTupleIteratorFull(iter.get(), &status);
+  EXPECT_TRUE(data.empty());
+  EXPECT_THAT(status, StatusIs(zetasql_base::CANCELLED, _));
+
+  // Check that enabling scrambling has no effect because the output is uniquely
+  // ordered.
+  EvaluationContext scramble_context(GetScramblingEvaluationOptions());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      iter, sort_op->CreateIterator({&params_data}, /*num_extra_slots=*/1,
+                                    &scramble_context));
+  EXPECT_EQ(iter->DebugString(), "SortTupleIterator(TestTupleIterator)");
+  EXPECT_TRUE(iter->PreservesOrder());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(data, ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(3), IsNull()),
+                          IsTupleSlotWith(Int64(30), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(3),
+                                          HasRawPointer(shared_states[2][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(2),
+                                          HasRawPointer(shared_states[1][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+  EXPECT_THAT(data[2].slots(),
+              ElementsAre(IsTupleSlotWith(NullInt64(), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()),
+                          IsTupleSlotWith(GetProtoValue(1),
+                                          HasRawPointer(shared_states[0][2])),
+                          IsTupleSlotWith(Int64(100), IsNull()), _));
+
+  // Check that if the memory bound is too low, we return an error.
+  EvaluationContext memory_context(GetIntermediateMemoryEvaluationOptions(
+      /*total_bytes=*/500));
+  EXPECT_THAT(sort_op->CreateIterator({&params_data},
+                                      /*num_extra_slots=*/1, &memory_context),
+              StatusIs(zetasql_base::StatusCode::kResourceExhausted,
+                       HasSubstr("Out of memory")));
+}
+
+TEST_F(CreateIteratorTest, SortOpSpillsToDisk) {
+  VariableId a("a"), b("b"), k("k"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
+      absl::make_unique<KeyArg>(k, std::move(deref_a), KeyArg::kAscending));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+
+  std::vector<std::unique_ptr<ExprArg>> values;
+  values.push_back(absl::make_unique<ExprArg>(v, std::move(deref_b)));
+
+  // The rows arrive in decreasing key order so that every spilled run must be
+  // interleaved with the runs spilled after it.
+  const int kNumRows = 20;
+  std::vector<std::vector<Value>> input_values;
+  input_values.reserve(kNumRows);
+  for (int i = kNumRows; i >= 1; --i) {
+    input_values.push_back({Int64(i), Int64(10 * i)});
+  }
+  auto input = absl::WrapUnique(new TestRelationalOp(
+      {a, b}, CreateTestTupleDatas(input_values), /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto sort_op,
+      SortOp::Create(std::move(keys), std::move(values),
+                     /*limit=*/nullptr, /*offset=*/nullptr, std::move(input),
+                     /*is_order_preserving=*/true,
+                     /*is_stable_sort=*/false));
+  ZETASQL_ASSERT_OK(sort_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  // A budget this small can only hold a few of the tuples, so the sort must
+  // spill multiple runs to disk and merge them.
+  EvaluationOptions options =
+      GetIntermediateMemoryEvaluationOptions(/*total_bytes=*/500);
+  options.allow_sort_spill_to_disk = true;
+  EvaluationContext context(options);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1, &context));
+  EXPECT_EQ(iter->DebugString(), "SortTupleIterator(TestTupleIterator)");
+  EXPECT_TRUE(iter->PreservesOrder());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), kNumRows);
+  for (int i = 0; i < kNumRows; ++i) {
+    EXPECT_THAT(data[i].slots(),
+                ElementsAre(IsTupleSlotWith(Int64(i + 1), IsNull()),
+                            IsTupleSlotWith(Int64(10 * (i + 1)), IsNull()), _))
+        << "row " << i;
+  }
+
+  // The same budget is not enough when spilling is disabled.
+  EvaluationContext memory_context(
+      GetIntermediateMemoryEvaluationOptions(/*total_bytes=*/500));
+  EXPECT_THAT(sort_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/1,
+                                      &memory_context),
+              StatusIs(zetasql_base::StatusCode::kResourceExhausted,
+                       HasSubstr("Out of memory")));
+}
+
+TEST_F(CreateIteratorTest, SortOpIgnoresOrder) {
+  VariableId a("a"), b("b"), k("k"), v("v");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+
+  std::vector<std::unique_ptr<KeyArg>> keys;
+  keys.push_back(
       absl::make_unique<KeyArg>(k, std::move(deref_a), KeyArg::kDescending));
 
   ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
@@ -3145,6 +3902,39 @@ TEST_F(CreateIteratorTest, ScanArrayOfStructs) {
   EXPECT_EQ(data[0].num_slots(), 3);
 }
 
+TEST_F(CreateIteratorTest, ScanArrayOfStructsSharedProtoStates) {
+  VariableId x("x"), v1("v1");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto array_expr,
+      ConstExpr::Create(
+          Array({Struct({"foo"}, {Int64(1)}), Struct({"foo"}, {Int64(2)})})));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto scan_op,
+      ArrayScanOp::Create(x, VariableId(), {{v1, 0}}, std::move(array_expr)));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      scan_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 2);
+  // The struct-typed element slots carry SharedProtoState; the INT64 field
+  // slots do not.
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Struct({"foo"}, {Int64(1)}),
+                                          Pointee(Eq(nullopt)))));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Struct({"foo"}, {Int64(2)}),
+                                          Pointee(Eq(nullopt)))));
+  // 'data[0]' still references the state written for the first element, so the
+  // scan must not have reused that state for the second element.
+  EXPECT_NE(data[0].slots()[1].mutable_shared_proto_state()->get(),
+            data[1].slots()[1].mutable_shared_proto_state()->get());
+}
+
 TEST_F(CreateIteratorTest, TableScanAsArray) {
   VariableId v1("v1"), v2("v2");
   Value table = Array({
@@ -3319,6 +4109,113 @@ TEST_F(CreateIteratorTest, UnionAllOp) {
   EXPECT_FALSE(iter->PreservesOrder());
 }
 
+// A TestRelationalOp whose iterator records calls to
+// TupleIterator::StartPrefetch() in '*started_prefetch'.
+class PrefetchRecordingRelationalOp : public TestRelationalOp {
+ public:
+  PrefetchRecordingRelationalOp(const std::vector<VariableId>& variables,
+                                const std::vector<TupleData>& values,
+                                bool* started_prefetch)
+      : TestRelationalOp(variables, values, /*preserves_order=*/true),
+        started_prefetch_(started_prefetch) {}
+
+  ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+      absl::Span<const TupleData* const> params, int num_extra_slots,
+      EvaluationContext* context) const override {
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<TupleIterator> iter,
+        TestRelationalOp::CreateIterator(params, num_extra_slots, context));
+    std::unique_ptr<TupleIterator> recording_iter =
+        absl::make_unique<PrefetchRecordingIterator>(std::move(iter),
+                                                     started_prefetch_);
+    return recording_iter;
+  }
+
+ private:
+  class PrefetchRecordingIterator : public TupleIterator {
+   public:
+    PrefetchRecordingIterator(std::unique_ptr<TupleIterator> iter,
+                              bool* started_prefetch)
+        : iter_(std::move(iter)), started_prefetch_(started_prefetch) {}
+
+    const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+    TupleData* Next() override { return iter_->Next(); }
+
+    void StartPrefetch() override { *started_prefetch_ = true; }
+
+    zetasql_base::Status Status() const override { return iter_->Status(); }
+
+    std::string DebugString() const override { return iter_->DebugString(); }
+
+   private:
+    std::unique_ptr<TupleIterator> iter_;
+    bool* started_prefetch_;
+  };
+
+  bool* started_prefetch_;
+};
+
+TEST_F(CreateIteratorTest, UnionAllOpStartsPrefetchOnAllInputs) {
+  VariableId a("a"), a1("a1"), a2("a2");
+
+  const std::vector<TupleData> datas =
+      CreateTestTupleDatas({{Int64(1)}, {Int64(2)}});
+
+  bool input1_prefetching = false;
+  bool input2_prefetching = false;
+  auto input1 = absl::make_unique<PrefetchRecordingRelationalOp>(
+      std::vector<VariableId>{a1}, std::vector<TupleData>{datas[0]},
+      &input1_prefetching);
+  auto input2 = absl::make_unique<PrefetchRecordingRelationalOp>(
+      std::vector<VariableId>{a2}, std::vector<TupleData>{datas[1]},
+      &input2_prefetching);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a1, DerefExpr::Create(a1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a2, DerefExpr::Create(a2, Int64Type()));
+
+  UnionAllOp::Input union_input1;
+  union_input1.first = std::move(input1);
+  union_input1.second.push_back(
+      absl::make_unique<ExprArg>(a, std::move(deref_a1)));
+
+  UnionAllOp::Input union_input2;
+  union_input2.first = std::move(input2);
+  union_input2.second.push_back(
+      absl::make_unique<ExprArg>(a, std::move(deref_a2)));
+
+  std::vector<UnionAllOp::Input> union_inputs;
+  union_inputs.push_back(std::move(union_input1));
+  union_inputs.push_back(std::move(union_input2));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto union_all_op,
+                       UnionAllOp::Create(std::move(union_inputs)));
+  ZETASQL_ASSERT_OK(union_all_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      union_all_op->CreateIterator(EmptyParams(),
+                                   /*num_extra_slots=*/1, &context));
+  // Prefetching must not start before the first call to Next(), so that it
+  // cannot interfere with calls that must precede Next() (e.g.,
+  // DisableReordering()).
+  EXPECT_FALSE(input1_prefetching);
+  EXPECT_FALSE(input2_prefetching);
+
+  // The first call to Next() starts prefetching on all inputs, including the
+  // ones that are not being drained yet.
+  ASSERT_TRUE(iter->Next() != nullptr) << iter->Status();
+  EXPECT_TRUE(input1_prefetching);
+  EXPECT_TRUE(input2_prefetching);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 1);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()), _));
+}
+
 TEST_F(CreateIteratorTest, ComputeOp) {
   VariableId a("a"), b("b"), param("param"), minus("minus"), plus("plus");
   std::vector<TupleData> test_values =
@@ -3482,6 +4379,256 @@ TEST_F(CreateIteratorTest, FilterOp) {
   EXPECT_FALSE(iter->PreservesOrder());
 }
 
+TEST_F(CreateIteratorTest, FilterOpNextBatch) {
+  VariableId a("a"), b("b"), param("param");
+  const std::vector<TupleData> test_values =
+      CreateTestTupleDatas({{Int64(1), Int64(10)},
+                            {Int64(3), Int64(30)},
+                            {Int64(2), Int64(20)},
+                            {Int64(4), Int64(40)}});
+  auto input = absl::WrapUnique(
+      new TestRelationalOp({a, b}, test_values, /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_param, DerefExpr::Create(param, Int64Type()));
+
+  std::vector<std::unique_ptr<ValueExpr>> args;
+  args.push_back(std::move(deref_a));
+  args.push_back(std::move(deref_param));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto predicate,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kLess, BoolType()),
+                           std::move(args), DEFAULT_ERROR_MODE));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto filter_op, FilterOp::Create(std::move(predicate), std::move(input)));
+
+  TupleSchema params_schema({param});
+  const TupleData params_data = CreateTestTupleData({Int64(3)});
+  ZETASQL_ASSERT_OK(filter_op->SetSchemasForEvaluation({&params_schema}));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TupleIterator> iter,
+                       filter_op->CreateIterator(
+                           {&params_data}, /*num_extra_slots=*/1, &context));
+  // The first batch covers the first three input tuples, two of which match
+  // the predicate and are compacted to the front of the batch.
+  std::vector<TupleData> batch;
+  ASSERT_TRUE(iter->NextBatch(/*max_rows=*/3, &batch));
+  ASSERT_EQ(batch.size(), 2);
+  EXPECT_THAT(batch[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()), _));
+  EXPECT_THAT(batch[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()), _));
+  // The remaining input tuple does not match, so the iterator is exhausted.
+  EXPECT_FALSE(iter->NextBatch(/*max_rows=*/3, &batch));
+  ZETASQL_EXPECT_OK(iter->Status());
+}
+
+TEST_F(CreateIteratorTest, FilterOpConjuncts) {
+  VariableId a("a"), b("b"), param("param");
+  const std::vector<TupleData> test_values =
+      CreateTestTupleDatas({{Int64(0), Int64(10)},
+                            {Int64(2), Int64(20)},
+                            {Int64(-4), Int64(30)},
+                            {Int64(5), Int64(40)}});
+  auto input = absl::WrapUnique(
+      new TestRelationalOp({a, b}, test_values, /*preserves_order=*/true));
+
+  // First conjunct: 0 < a.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto zero, ConstExpr::Create(Int64(0)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ValueExpr>> less_args;
+  less_args.push_back(std::move(zero));
+  less_args.push_back(std::move(deref_a));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto first_conjunct,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kLess, BoolType()),
+                           std::move(less_args), DEFAULT_ERROR_MODE));
+
+  // Second conjunct: DIV(100, a) < param. It divides by zero on the first
+  // input tuple, but the first conjunct discards that tuple before this one
+  // is evaluated.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto hundred, ConstExpr::Create(Int64(100)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a_again, DerefExpr::Create(a, Int64Type()));
+  std::vector<std::unique_ptr<ValueExpr>> div_args;
+  div_args.push_back(std::move(hundred));
+  div_args.push_back(std::move(deref_a_again));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto div_expr,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kDiv, Int64Type()),
+                           std::move(div_args), DEFAULT_ERROR_MODE));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_param, DerefExpr::Create(param, Int64Type()));
+  std::vector<std::unique_ptr<ValueExpr>> less_param_args;
+  less_param_args.push_back(std::move(div_expr));
+  less_param_args.push_back(std::move(deref_param));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto second_conjunct,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kLess, BoolType()),
+                           std::move(less_param_args), DEFAULT_ERROR_MODE));
+
+  std::vector<std::unique_ptr<ValueExpr>> conjuncts;
+  conjuncts.push_back(std::move(first_conjunct));
+  conjuncts.push_back(std::move(second_conjunct));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto filter_op, FilterOp::Create(std::move(conjuncts), std::move(input)));
+  EXPECT_EQ(
+      "FilterOp(\n"
+      "+-condition: {\n"
+      "| +-Less(ConstExpr(0), $a),\n"
+      "| +-Less(Div(ConstExpr(100), $a), $param)},\n"
+      "+-input: TestRelationalOp)",
+      filter_op->DebugString());
+
+  TupleSchema params_schema({param});
+  const TupleData params_data = CreateTestTupleData({Int64(60)});
+  ZETASQL_ASSERT_OK(filter_op->SetSchemasForEvaluation({&params_schema}));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TupleIterator> iter,
+                       filter_op->CreateIterator(
+                           {&params_data}, /*num_extra_slots=*/1, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 2);
+  EXPECT_THAT(data[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()), _));
+  EXPECT_THAT(data[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(5), IsNull()),
+                          IsTupleSlotWith(Int64(40), IsNull()), _));
+}
+
+TEST_F(CreateIteratorTest, ComputeOpNextBatch) {
+  VariableId a("a"), b("b"), plus("plus");
+  std::vector<TupleData> test_values =
+      CreateTestTupleDatas({{Int64(1), Int64(10)}, {Int64(2), Int64(20)}});
+  auto input = absl::WrapUnique(
+      new TestRelationalOp({a, b}, test_values, /*preserves_order=*/true));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+
+  std::vector<std::unique_ptr<ValueExpr>> plus_args;
+  plus_args.push_back(std::move(deref_a));
+  plus_args.push_back(std::move(deref_b));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto plus_expr,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kAdd, Int64Type()),
+                           std::move(plus_args), DEFAULT_ERROR_MODE));
+
+  std::vector<std::unique_ptr<ExprArg>> args;
+  args.push_back(absl::make_unique<ExprArg>(plus, std::move(plus_expr)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto compute_op,
+                       ComputeOp::Create(std::move(args), std::move(input)));
+  ZETASQL_ASSERT_OK(compute_op->SetSchemasForEvaluation(/*params_schemas=*/{}));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      compute_op->CreateIterator(/*params=*/{}, /*num_extra_slots=*/0,
+                                 &context));
+  std::vector<TupleData> batch;
+  ASSERT_TRUE(iter->NextBatch(TupleIterator::kDefaultBatchSize, &batch));
+  ASSERT_EQ(batch.size(), 2);
+  EXPECT_THAT(batch[0].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(1), IsNull()),
+                          IsTupleSlotWith(Int64(10), IsNull()),
+                          IsTupleSlotWith(Int64(11), IsNull())));
+  EXPECT_THAT(batch[1].slots(),
+              ElementsAre(IsTupleSlotWith(Int64(2), IsNull()),
+                          IsTupleSlotWith(Int64(20), IsNull()),
+                          IsTupleSlotWith(Int64(22), IsNull())));
+  EXPECT_FALSE(iter->NextBatch(TupleIterator::kDefaultBatchSize, &batch));
+  ZETASQL_EXPECT_OK(iter->Status());
+}
+
+// A TestRelationalOp whose iterator records its own destruction in
+// '*iterator_destroyed'.
+class DestructionRecordingRelationalOp : public TestRelationalOp {
+ public:
+  DestructionRecordingRelationalOp(const std::vector<VariableId>& variables,
+                                   const std::vector<TupleData>& values,
+                                   bool* iterator_destroyed)
+      : TestRelationalOp(variables, values, /*preserves_order=*/true),
+        iterator_destroyed_(iterator_destroyed) {}
+
+  ::zetasql_base::StatusOr<std::unique_ptr<TupleIterator>> CreateIterator(
+      absl::Span<const TupleData* const> params, int num_extra_slots,
+      EvaluationContext* context) const override {
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<TupleIterator> iter,
+        TestRelationalOp::CreateIterator(params, num_extra_slots, context));
+    std::unique_ptr<TupleIterator> recording_iter =
+        absl::make_unique<DestructionRecordingIterator>(std::move(iter),
+                                                        iterator_destroyed_);
+    return recording_iter;
+  }
+
+ private:
+  class DestructionRecordingIterator : public TupleIterator {
+   public:
+    DestructionRecordingIterator(std::unique_ptr<TupleIterator> iter,
+                                 bool* iterator_destroyed)
+        : iter_(std::move(iter)), iterator_destroyed_(iterator_destroyed) {}
+
+    ~DestructionRecordingIterator() override { *iterator_destroyed_ = true; }
+
+    const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+    TupleData* Next() override { return iter_->Next(); }
+
+    zetasql_base::Status Status() const override { return iter_->Status(); }
+
+    std::string DebugString() const override { return iter_->DebugString(); }
+
+   private:
+    std::unique_ptr<TupleIterator> iter_;
+    bool* iterator_destroyed_;
+  };
+
+  bool* iterator_destroyed_;
+};
+
+TEST_F(CreateIteratorTest, LimitOpReleasesInputWhenSatisfied) {
+  VariableId a("a");
+  const std::vector<TupleData> test_values =
+      CreateTestTupleDatas({{Int64(1)}, {Int64(2)}, {Int64(3)}});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto row_count_expr, ConstExpr::Create(Int64(1)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto offset_expr, ConstExpr::Create(Int64(0)));
+
+  bool iterator_destroyed = false;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto limit_op,
+      LimitOp::Create(std::move(row_count_expr), std::move(offset_expr),
+                      absl::make_unique<DestructionRecordingRelationalOp>(
+                          std::vector<VariableId>{a}, test_values,
+                          &iterator_destroyed),
+                      /*is_order_preserving=*/true));
+  ZETASQL_ASSERT_OK(limit_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleIterator> iter,
+      limit_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                       ReadFromTupleIterator(iter.get()));
+  ASSERT_EQ(data.size(), 1);
+  EXPECT_EQ(Tuple(&iter->Schema(), &data[0]).DebugString(), "<a:1>");
+  // The input iterator must have been dropped as soon as the limit was
+  // reached, before this iterator itself is destroyed.
+  EXPECT_TRUE(iterator_destroyed);
+  // Schema() and DebugString() still work after the input is released (the
+  // Tuple above already exercised Schema()).
+  EXPECT_EQ(iter->DebugString(), "LimitTupleIterator(TestTupleIterator)");
+}
+
 TEST_F(CreateIteratorTest, LimitOp_OrderedInput) {
   VariableId a("a"), b("b"), row_count("row_count"), offset("offset");
   const std::vector<TupleData> test_values =
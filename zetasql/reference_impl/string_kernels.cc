@@ -0,0 +1,233 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/string_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "zetasql/common/errors.h"
+#include "unicode/utf8.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+StringArena::StringArena(size_t block_size) : block_size_(block_size) {
+  CHECK_GT(block_size_, 0);
+}
+
+char* StringArena::Allocate(size_t size) {
+  if (current_block_ < 0 ||
+      current_offset_ + size > block_sizes_[current_block_]) {
+    ++current_block_;
+    const size_t needed = std::max(size, block_size_);
+    if (current_block_ == blocks_.size()) {
+      blocks_.push_back(std::unique_ptr<char[]>(new char[needed]));
+      block_sizes_.push_back(needed);
+    } else if (block_sizes_[current_block_] < needed) {
+      // A reused block from a previous batch that is too small for this
+      // value; regrow it in place.
+      blocks_[current_block_].reset(new char[needed]);
+      block_sizes_[current_block_] = needed;
+    }
+    current_offset_ = 0;
+  }
+  char* region = blocks_[current_block_].get() + current_offset_;
+  current_offset_ += size;
+  bytes_used_ += size;
+  return region;
+}
+
+absl::string_view StringArena::Add(absl::string_view data) {
+  if (data.empty()) return absl::string_view();
+  char* region = Allocate(data.size());
+  std::memcpy(region, data.data(), data.size());
+  return absl::string_view(region, data.size());
+}
+
+absl::string_view StringArena::AddPieces(
+    absl::Span<const absl::string_view> pieces) {
+  size_t total_size = 0;
+  for (const absl::string_view piece : pieces) total_size += piece.size();
+  if (total_size == 0) return absl::string_view();
+  char* region = Allocate(total_size);
+  char* out = region;
+  for (const absl::string_view piece : pieces) {
+    std::memcpy(out, piece.data(), piece.size());
+    out += piece.size();
+  }
+  return absl::string_view(region, total_size);
+}
+
+void StringArena::Clear() {
+  current_block_ = -1;
+  current_offset_ = 0;
+  bytes_used_ = 0;
+}
+
+namespace {
+
+// Returns the number of code points in 's' (counting each ill-formed byte
+// sequence as one, like U8_FWD_1 does).
+int64_t Utf8Length(absl::string_view s) {
+  const char* data = s.data();
+  int32_t i = 0;
+  const int32_t length = static_cast<int32_t>(s.size());
+  int64_t num_chars = 0;
+  while (i < length) {
+    U8_FWD_1(data, i, length);
+    ++num_chars;
+  }
+  return num_chars;
+}
+
+// Returns the byte offset of the code point 'num_chars' past 'byte_offset'
+// in 's', saturating at the end of 's'.
+int32_t Utf8Advance(absl::string_view s, int32_t byte_offset,
+                    int64_t num_chars) {
+  const char* data = s.data();
+  int32_t i = byte_offset;
+  const int32_t length = static_cast<int32_t>(s.size());
+  while (num_chars > 0 && i < length) {
+    U8_FWD_1(data, i, length);
+    --num_chars;
+  }
+  return i;
+}
+
+// Computes SUBSTR of one value, with offsets in bytes ('is_bytes' true) or
+// code points. Shared range semantics: 1-based 'pos', negative 'pos' counts
+// from the end, 'length' < 0 already rejected.
+absl::string_view SubstrOneValue(absl::string_view value, int64_t pos,
+                                 bool has_length, int64_t length,
+                                 bool is_bytes) {
+  const int64_t value_length =
+      is_bytes ? static_cast<int64_t>(value.size()) : Utf8Length(value);
+  int64_t start;  // 0-based offset of the first included unit.
+  if (pos > 0) {
+    start = pos - 1;
+  } else if (pos == 0) {
+    start = 0;
+  } else {
+    start = std::max<int64_t>(value_length + pos, 0);
+  }
+  if (start >= value_length) return absl::string_view();
+  const int64_t max_units = value_length - start;
+  const int64_t num_units = has_length ? std::min(length, max_units)
+                                       : max_units;
+  if (num_units <= 0) return absl::string_view();
+
+  if (is_bytes) {
+    return value.substr(start, num_units);
+  }
+  const int32_t start_offset = Utf8Advance(value, 0, start);
+  const int32_t end_offset = Utf8Advance(value, start_offset, num_units);
+  return absl::string_view(value.data() + start_offset,
+                           end_offset - start_offset);
+}
+
+}  // namespace
+
+zetasql_base::Status ConcatBatch(
+    absl::Span<const absl::Span<const absl::string_view>> arg_columns,
+    StringArena* arena, std::vector<absl::string_view>* results) {
+  ZETASQL_RET_CHECK(!arg_columns.empty());
+  const size_t num_rows = arg_columns[0].size();
+  for (const auto& column : arg_columns) {
+    ZETASQL_RET_CHECK_EQ(column.size(), num_rows);
+  }
+  results->reserve(results->size() + num_rows);
+  std::vector<absl::string_view> pieces(arg_columns.size());
+  for (size_t row = 0; row < num_rows; ++row) {
+    for (size_t arg = 0; arg < arg_columns.size(); ++arg) {
+      pieces[arg] = arg_columns[arg][row];
+    }
+    results->push_back(arena->AddPieces(pieces));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status SubstrBatch(absl::Span<const absl::string_view> values,
+                         int64_t pos, bool has_length, int64_t length,
+                         bool is_bytes,
+                         std::vector<absl::string_view>* results) {
+  if (has_length && length < 0) {
+    return MakeEvalError() << "Third argument in SUBSTR() cannot be negative";
+  }
+  results->reserve(results->size() + values.size());
+  for (const absl::string_view value : values) {
+    results->push_back(
+        SubstrOneValue(value, pos, has_length, length, is_bytes));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status ReplaceBatch(absl::Span<const absl::string_view> values,
+                          absl::string_view old_str, absl::string_view new_str,
+                          StringArena* arena,
+                          std::vector<absl::string_view>* results) {
+  results->reserve(results->size() + values.size());
+  std::vector<absl::string_view> pieces;
+  for (const absl::string_view value : values) {
+    if (old_str.empty()) {
+      results->push_back(value);
+      continue;
+    }
+    size_t match = value.find(old_str);
+    if (match == absl::string_view::npos) {
+      // Unchanged rows view the input; no arena bytes are spent.
+      results->push_back(value);
+      continue;
+    }
+    pieces.clear();
+    size_t prev = 0;
+    while (match != absl::string_view::npos) {
+      pieces.push_back(value.substr(prev, match - prev));
+      pieces.push_back(new_str);
+      prev = match + old_str.size();
+      match = value.find(old_str, prev);
+    }
+    pieces.push_back(value.substr(prev));
+    results->push_back(arena->AddPieces(pieces));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+zetasql_base::Status SplitBatch(absl::Span<const absl::string_view> values,
+                        absl::string_view delimiter,
+                        std::vector<absl::string_view>* pieces,
+                        std::vector<int64_t>* row_offsets) {
+  if (delimiter.empty()) {
+    return MakeEvalError() << "Delimiter of SPLIT function must be non-empty";
+  }
+  row_offsets->reserve(row_offsets->size() + values.size() + 1);
+  row_offsets->push_back(static_cast<int64_t>(pieces->size()));
+  for (const absl::string_view value : values) {
+    size_t prev = 0;
+    size_t match = value.find(delimiter);
+    while (match != absl::string_view::npos) {
+      pieces->push_back(value.substr(prev, match - prev));
+      prev = match + delimiter.size();
+      match = value.find(delimiter, prev);
+    }
+    pieces->push_back(value.substr(prev));
+    row_offsets->push_back(static_cast<int64_t>(pieces->size()));
+  }
+  return ::zetasql_base::OkStatus();
+}
+
+}  // namespace zetasql
@@ -0,0 +1,116 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Batch kernels for string functions. The kernels operate over spans of
+// string_views (one entry per row, e.g. viewing a ColumnVector's string
+// storage) and write all result bytes into a caller-owned StringArena, so a
+// batch of rows costs one arena block allocation instead of one std::string
+// per row. Null handling stays with the caller: kernels see only the rows to
+// compute.
+
+#ifndef ZETASQL_REFERENCE_IMPL_STRING_KERNELS_H_
+#define ZETASQL_REFERENCE_IMPL_STRING_KERNELS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+
+// An append-only buffer for per-batch string results. Bytes are written into
+// large blocks and handed out as string_views that remain valid until
+// Clear(). Blocks never move once allocated, so growing the arena does not
+// invalidate previously returned views.
+class StringArena {
+ public:
+  explicit StringArena(size_t block_size = 64 * 1024);
+
+  StringArena(const StringArena&) = delete;
+  StringArena& operator=(const StringArena&) = delete;
+
+  // Copies 'data' into the arena and returns a view of the copy.
+  absl::string_view Add(absl::string_view data);
+
+  // Concatenates 'pieces' into the arena contiguously and returns a view of
+  // the result, without materializing an intermediate string.
+  absl::string_view AddPieces(absl::Span<const absl::string_view> pieces);
+
+  // Discards all returned views and reuses the existing blocks for
+  // subsequent batches.
+  void Clear();
+
+  // Total bytes handed out since the last Clear().
+  size_t bytes_used() const { return bytes_used_; }
+
+ private:
+  // Returns a writable region of at least 'size' bytes.
+  char* Allocate(size_t size);
+
+  const size_t block_size_;
+  // Blocks are heap arrays so they never move when 'blocks_' grows.
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Capacity of each entry of 'blocks_' (the last block may be oversized for
+  // a single large value).
+  std::vector<size_t> block_sizes_;
+  int current_block_ = -1;
+  size_t current_offset_ = 0;
+  size_t bytes_used_ = 0;
+};
+
+// CONCAT over a batch: 'arg_columns' holds one column per argument, all of
+// equal row count; appends one result view per row to 'results'.
+zetasql_base::Status ConcatBatch(
+    absl::Span<const absl::Span<const absl::string_view>> arg_columns,
+    StringArena* arena, std::vector<absl::string_view>* results);
+
+// SUBSTR(value, pos[, length]) over a batch with constant 'pos' and
+// 'length'. 'pos' is 1-based; a negative 'pos' counts from the end and 0
+// behaves as 1. A negative 'length' is an error; 'has_length' false means
+// "to the end of the value". Offsets are code points for STRING inputs
+// ('is_bytes' false) and bytes for BYTES inputs. Substrings view the input
+// directly; the arena is not used.
+zetasql_base::Status SubstrBatch(absl::Span<const absl::string_view> values,
+                         int64_t pos, bool has_length, int64_t length,
+                         bool is_bytes,
+                         std::vector<absl::string_view>* results);
+
+// REPLACE(value, old_str, new_str) over a batch with constant 'old_str' and
+// 'new_str'. An empty 'old_str' leaves values unchanged. Rows without a
+// match view the input directly; only changed rows write to the arena.
+zetasql_base::Status ReplaceBatch(absl::Span<const absl::string_view> values,
+                          absl::string_view old_str, absl::string_view new_str,
+                          StringArena* arena,
+                          std::vector<absl::string_view>* results);
+
+// SPLIT(value, delimiter) over a batch with a constant non-empty
+// 'delimiter' (an empty delimiter is an error, as in the SQL function). The
+// result is a flattened list layout: the pieces of row i are
+// (*pieces)[(*row_offsets)[i]] .. (*pieces)[(*row_offsets)[i + 1] - 1], with
+// 'row_offsets' getting values.size() + 1 entries. Pieces view the input
+// directly; the arena is not used.
+zetasql_base::Status SplitBatch(absl::Span<const absl::string_view> values,
+                        absl::string_view delimiter,
+                        std::vector<absl::string_view>* pieces,
+                        std::vector<int64_t>* row_offsets);
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_STRING_KERNELS_H_
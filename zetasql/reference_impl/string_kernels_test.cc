@@ -0,0 +1,133 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/string_kernels.h"
+
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+TEST(StringArenaTest, ViewsStayValidAcrossBlockGrowth) {
+  // A tiny block size forces many block allocations.
+  StringArena arena(/*block_size=*/8);
+  std::vector<absl::string_view> views;
+  for (int i = 0; i < 100; ++i) {
+    views.push_back(arena.Add(std::string(5, 'a' + (i % 26))));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(views[i], std::string(5, 'a' + (i % 26)));
+  }
+  EXPECT_EQ(arena.bytes_used(), 500);
+
+  // Values larger than the block size get their own block.
+  const std::string big(1000, 'x');
+  EXPECT_EQ(arena.Add(big), big);
+
+  arena.Clear();
+  EXPECT_EQ(arena.bytes_used(), 0);
+  EXPECT_EQ(arena.Add("reused"), "reused");
+}
+
+TEST(StringKernelsTest, ConcatBatch) {
+  const std::vector<absl::string_view> left = {"a", "", "hello "};
+  const std::vector<absl::string_view> right = {"b", "", "world"};
+  const std::vector<absl::Span<const absl::string_view>> args = {left, right};
+
+  StringArena arena;
+  std::vector<absl::string_view> results;
+  ZETASQL_ASSERT_OK(ConcatBatch(args, &arena, &results));
+  EXPECT_THAT(results, ElementsAre("ab", "", "hello world"));
+}
+
+TEST(StringKernelsTest, SubstrBatchCodePoints) {
+  // "日本語abc" is three 3-byte code points followed by three ASCII bytes.
+  const std::vector<absl::string_view> values = {"日本語abc", "abcdef", ""};
+
+  std::vector<absl::string_view> results;
+  ZETASQL_ASSERT_OK(SubstrBatch(values, /*pos=*/2, /*has_length=*/true, /*length=*/3,
+                        /*is_bytes=*/false, &results));
+  EXPECT_THAT(results, ElementsAre("本語a", "bcd", ""));
+
+  // Negative position counts from the end; no length reads to the end.
+  results.clear();
+  ZETASQL_ASSERT_OK(SubstrBatch(values, /*pos=*/-2, /*has_length=*/false,
+                        /*length=*/0, /*is_bytes=*/false, &results));
+  EXPECT_THAT(results, ElementsAre("bc", "ef", ""));
+
+  // Position 0 behaves as position 1.
+  results.clear();
+  ZETASQL_ASSERT_OK(SubstrBatch(values, /*pos=*/0, /*has_length=*/true, /*length=*/1,
+                        /*is_bytes=*/false, &results));
+  EXPECT_THAT(results, ElementsAre("日", "a", ""));
+}
+
+TEST(StringKernelsTest, SubstrBatchBytes) {
+  const std::vector<absl::string_view> values = {"abcdef"};
+  std::vector<absl::string_view> results;
+  ZETASQL_ASSERT_OK(SubstrBatch(values, /*pos=*/3, /*has_length=*/true, /*length=*/2,
+                        /*is_bytes=*/true, &results));
+  EXPECT_THAT(results, ElementsAre("cd"));
+
+  EXPECT_THAT(SubstrBatch(values, /*pos=*/1, /*has_length=*/true,
+                          /*length=*/-1, /*is_bytes=*/true, &results),
+              StatusIs(zetasql_base::OUT_OF_RANGE,
+                       HasSubstr("cannot be negative")));
+}
+
+TEST(StringKernelsTest, ReplaceBatch) {
+  const std::vector<absl::string_view> values = {"banana", "none here", ""};
+
+  StringArena arena;
+  std::vector<absl::string_view> results;
+  ZETASQL_ASSERT_OK(ReplaceBatch(values, "an", "AN", &arena, &results));
+  EXPECT_THAT(results, ElementsAre("bANANa", "none here", ""));
+  // Only the changed row spends arena bytes.
+  EXPECT_EQ(arena.bytes_used(), 6);
+
+  // An empty old_str leaves values unchanged.
+  results.clear();
+  ZETASQL_ASSERT_OK(ReplaceBatch(values, "", "x", &arena, &results));
+  EXPECT_THAT(results, ElementsAre("banana", "none here", ""));
+}
+
+TEST(StringKernelsTest, SplitBatch) {
+  const std::vector<absl::string_view> values = {"a,b,c", "no delimiter", "",
+                                                 ",x,"};
+
+  std::vector<absl::string_view> pieces;
+  std::vector<int64_t> row_offsets;
+  ZETASQL_ASSERT_OK(SplitBatch(values, ",", &pieces, &row_offsets));
+  EXPECT_THAT(pieces, ElementsAre("a", "b", "c", "no delimiter", "", "", "x",
+                                  ""));
+  EXPECT_THAT(row_offsets, ElementsAre(0, 3, 4, 5, 8));
+
+  EXPECT_THAT(SplitBatch(values, "", &pieces, &row_offsets),
+              StatusIs(zetasql_base::OUT_OF_RANGE, HasSubstr("non-empty")));
+}
+
+}  // namespace
+}  // namespace zetasql
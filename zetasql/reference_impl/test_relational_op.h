@@ -25,11 +25,16 @@ namespace zetasql {
 
 class TestRelationalOp : public RelationalOp {
  public:
+  // If 'provide_row_count_hint' is true, the iterators report the number of
+  // values from TupleIterator::ApproximateRowCount(); by default they report
+  // no estimate.
   TestRelationalOp(const std::vector<VariableId>& variables,
-                   const std::vector<TupleData>& values, bool preserves_order)
+                   const std::vector<TupleData>& values, bool preserves_order,
+                   bool provide_row_count_hint = false)
       : variables_(variables),
         values_(values),
-        preserves_order_(preserves_order) {}
+        preserves_order_(preserves_order),
+        provide_row_count_hint_(provide_row_count_hint) {}
 
   TestRelationalOp(const TestRelationalOp&) = delete;
   TestRelationalOp& operator=(const TestRelationalOp&) = delete;
@@ -51,7 +56,10 @@ class TestRelationalOp : public RelationalOp {
 
     std::unique_ptr<TupleIterator> iter = absl::make_unique<TestTupleIterator>(
         variables_, iter_values, preserves_order_,
-        /*end_status=*/zetasql_base::OkStatus());
+        /*end_status=*/zetasql_base::OkStatus(),
+        provide_row_count_hint_
+            ? absl::make_optional<int64_t>(values_.size())
+            : absl::nullopt);
     return iter;
   }
 
@@ -72,6 +80,7 @@ class TestRelationalOp : public RelationalOp {
   const std::vector<VariableId> variables_;
   const std::vector<TupleData> values_;
   const bool preserves_order_;
+  const bool provide_row_count_hint_;
 };
 
 }  // namespace zetasql
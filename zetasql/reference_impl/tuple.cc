@@ -17,6 +17,7 @@
 #include "zetasql/reference_impl/tuple.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/public/value.h"
@@ -35,17 +36,17 @@ TupleSchema::TupleSchema(absl::Span<const VariableId> variables)
     : variables_(variables.begin(), variables.end()) {
   vars_to_idxs_.reserve(variables_.size());
   for (int i = 0; i < variables_.size(); ++i) {
-    vars_to_idxs_.insert(i);
+    vars_to_idxs_.emplace(variables_[i].name(), i);
   }
 }
 
 absl::optional<int> TupleSchema::FindIndexForVariable(
     const VariableId& variable) const {
-  auto iter = vars_to_idxs_.find(variable);
+  auto iter = vars_to_idxs_.find(variable.name());
   if (iter == vars_to_idxs_.end()) {
     return absl::nullopt;
   } else {
-    return *iter;
+    return iter->second;
   }
 }
 
@@ -58,6 +59,22 @@ std::string TupleSchema::DebugString() const {
   return absl::StrCat("<", absl::StrJoin(vars, ","), ">");
 }
 
+// -------------------------------------------------------
+// ProtoFieldRegistry
+// -------------------------------------------------------
+
+zetasql_base::Status ReadRegisteredProtoFields(
+    const ProtoFieldRegistry& registry, absl::Span<const std::string> rows,
+    std::vector<ProtoFieldValueList>* field_columns) {
+  std::vector<const ProtoFieldInfo*> field_infos;
+  field_infos.reserve(registry.GetRegisteredFields().size());
+  for (const ProtoFieldAccessInfo* access_info :
+       registry.GetRegisteredFields()) {
+    field_infos.push_back(&access_info->field_info);
+  }
+  return ReadProtoFieldsBatch(field_infos, rows, field_columns);
+}
+
 // -------------------------------------------------------
 // TupleSlot
 // -------------------------------------------------------
@@ -131,7 +148,7 @@ zetasql_base::Status TupleDataDeque::SetSlot(int slot_idx, std::vector<Value> va
   int64_t i = 0;
   for (Entry& entry : datas_) {
     int64_t& byte_size = entry.first;
-    TupleData* tuple = entry.second.get();
+    TupleData* tuple = &entry.second;
 
     TupleSlot* slot = tuple->mutable_slot(slot_idx);
     const int64_t old_slot_size = slot->GetPhysicalByteSize();
@@ -151,6 +168,8 @@ zetasql_base::Status TupleDataDeque::SetSlot(int slot_idx, std::vector<Value> va
 
 void TupleDataDeque::Sort(const TupleComparator& comparator,
                           bool use_stable_sort) {
+  // RadixSort() is stable, so it is valid regardless of 'use_stable_sort'.
+  if (RadixSort(comparator)) return;
   auto entry_comparator = [&comparator](const Entry& entry1,
                                         const Entry& entry2) {
     return comparator(entry1.second, entry2.second);
@@ -162,6 +181,121 @@ void TupleDataDeque::Sort(const TupleComparator& comparator,
   }
 }
 
+// Below this size a comparison sort is at least as fast as the radix sort's
+// eight counting passes, and the radix sort's temporary vectors are not worth
+// allocating.
+static const int64_t kMinEntriesForRadixSort = 64;
+
+bool TupleDataDeque::RadixSort(const TupleComparator& comparator) {
+  const absl::optional<TupleComparator::RadixSortSpec> spec =
+      comparator.GetRadixSortSpec();
+  if (!spec.has_value()) return false;
+  const size_t num_entries = datas_.size();
+  if (num_entries < kMinEntriesForRadixSort ||
+      num_entries > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  // Order-preserving unsigned keys paired with the positions of their
+  // entries. The pairs use untracked memory, but only 16 bytes per entry,
+  // comparable to what std::stable_sort allocates for its merge buffer.
+  std::vector<std::pair<uint64_t, uint32_t>> keys;
+  keys.reserve(num_entries);
+  // Positions of the entries with a NULL key, in deque order. All NULL keys
+  // compare equal, so these entries keep their relative order and sort as a
+  // block before or after all non-NULL keys.
+  std::vector<uint32_t> null_positions;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    const Value& value = datas_[i].second.slot(spec->slot).value();
+    if (value.is_null()) {
+      null_positions.push_back(i);
+      continue;
+    }
+    int64_t key;
+    switch (spec->type_kind) {
+      case TYPE_INT64:
+        key = value.int64_value();
+        break;
+      case TYPE_DATE:
+        key = value.date_value();
+        break;
+      case TYPE_TIMESTAMP:
+        // Nanosecond precision is required for equivalence with
+        // Value::LessThan(). Timestamps outside the range representable as
+        // int64_t nanoseconds are left to the comparison sort.
+        if (!value.ToUnixNanos(&key).ok()) return false;
+        break;
+      default:
+        return false;
+    }
+    // Flipping the sign bit maps the signed order onto the unsigned order;
+    // complementing then reverses it for descending keys.
+    uint64_t unsigned_key = static_cast<uint64_t>(key) ^ (1ull << 63);
+    if (spec->descending) unsigned_key = ~unsigned_key;
+    keys.emplace_back(unsigned_key, i);
+  }
+
+  // LSD radix sort on the keys, one byte per pass starting from the least
+  // significant. Each pass is a stable counting sort, so the overall sort is
+  // stable. Passes in which every key has the same byte (common in the high
+  // bytes of small keys) are skipped.
+  std::vector<std::pair<uint64_t, uint32_t>> scratch(keys.size());
+  for (int shift = 0; shift < 64; shift += 8) {
+    uint32_t counts[256] = {0};
+    for (const auto& key : keys) {
+      ++counts[(key.first >> shift) & 0xff];
+    }
+    if (!keys.empty() &&
+        counts[(keys[0].first >> shift) & 0xff] == keys.size()) {
+      continue;
+    }
+    uint32_t offset = 0;
+    for (int byte = 0; byte < 256; ++byte) {
+      const uint32_t count = counts[byte];
+      counts[byte] = offset;
+      offset += count;
+    }
+    for (auto& key : keys) {
+      scratch[counts[(key.first >> shift) & 0xff]++] = key;
+    }
+    keys.swap(scratch);
+  }
+
+  // Permute the entries into sorted order, with the NULL-key block on the
+  // side the key's null ordering puts it.
+  std::deque<Entry> sorted;
+  if (spec->nulls_first) {
+    for (const uint32_t position : null_positions) {
+      sorted.push_back(std::move(datas_[position]));
+    }
+  }
+  for (const auto& key : keys) {
+    sorted.push_back(std::move(datas_[key.second]));
+  }
+  if (!spec->nulls_first) {
+    for (const uint32_t position : null_positions) {
+      sorted.push_back(std::move(datas_[position]));
+    }
+  }
+  datas_.swap(sorted);
+  return true;
+}
+
+// -------------------------------------------------------
+// TupleIterator
+// -------------------------------------------------------
+
+bool TupleIterator::NextBatch(int max_rows, std::vector<TupleData>* batch) {
+  batch->clear();
+  batch->reserve(max_rows);
+  while (batch->size() < max_rows) {
+    const TupleData* data = Next();
+    if (data == nullptr) break;
+    batch->push_back(*data);
+  }
+  return !batch->empty();
+}
+
 // -------------------------------------------------------
 // ReorderingTupleIterator
 // -------------------------------------------------------
@@ -169,6 +303,18 @@ void TupleDataDeque::Sort(const TupleComparator& comparator,
 TupleData* ReorderingTupleIterator::Next() {
   called_next_ = true;
 
+  if (!reorder_) {
+    // DisableReordering() was called (necessarily before the first call to
+    // this method, so 'current_batch_' is empty). Stream tuples through
+    // without reading ahead so that a consumer that stops early does not
+    // cause us to pull tuples it will never look at.
+    TupleData* data = iter_->Next();
+    if (data == nullptr) {
+      status_ = iter_->Status();
+    }
+    return data;
+  }
+
   if (num_read_from_current_batch_ == current_batch_.size()) {
     // Done with the current batch.
     if (done_status_.has_value()) {
@@ -21,6 +21,10 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -35,15 +39,19 @@
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/variable_id.h"
 #include <cstdint>
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
-#include "zetasql/base/flat_set.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_builder.h"
+#include "zetasql/base/status_macros.h"
 #include "zetasql/base/statusor.h"
 
 namespace zetasql {
@@ -67,25 +75,12 @@ class TupleSchema {
   std::string DebugString() const;
 
  private:
-  using VariableStorage = std::vector<VariableId>;
-  struct VariableIdComparator {
-    using is_transparent = void;
-    bool operator()(int x, const VariableId& y) const {
-      return (*storage)[x] < y;
-    }
-    bool operator()(const VariableId& x, int y) const {
-      return x < (*storage)[y];
-    }
-    bool operator()(int x, int y) const {
-      return (*storage)[x] < (*storage)[y];
-    }
-
-    const VariableStorage* storage;
-  };
-  using VariableIndex = zetasql_base::flat_set<int, VariableIdComparator>;
-
-  VariableStorage variables_;
-  VariableIndex vars_to_idxs_{VariableIdComparator{&variables_}};
+  std::vector<VariableId> variables_;
+  // Hash index from variable name to its index in 'variables_', so that
+  // FindIndexForVariable() is O(1) even for wide schemas. The keys reference
+  // the names stored in 'variables_', which is not modified after
+  // construction.
+  absl::flat_hash_map<absl::string_view, int> vars_to_idxs_;
 };
 
 // Represents a field access on a proto-valued expression. (A subfield access
@@ -138,6 +133,17 @@ class ProtoFieldRegistry {
   std::vector<const ProtoFieldAccessInfo*> registered_access_infos_;
 };
 
+// Reads every field registered in 'registry' (which must have at least one
+// field) from each of the serialized protos in 'rows', scanning each row's
+// wire format exactly once. The output is columnar: on return,
+// (*field_columns)[i][j] holds the value of the field with RegisterField()
+// index i for rows[j]. Useful for operators that materialize many rows from
+// the same proto-valued column, which would otherwise pay one full scan of
+// each row per referenced field.
+zetasql_base::Status ReadRegisteredProtoFields(
+    const ProtoFieldRegistry& registry, absl::Span<const std::string> rows,
+    std::vector<ProtoFieldValueList>* field_columns);
+
 // Key type for ProtoFieldValueMap (defined below). An entry in that map
 // represents the deserialized proto field values for a particular proto Value
 // (representing by a pointer to its internally reference-counted data) and
@@ -385,7 +391,7 @@ class VirtualTupleSlot {
   void SetValueAndMaybeSharedProtoState(
       Value&& value,
       std::shared_ptr<TupleSlot::SharedProtoState>* shared_proto_state) {
-    *value_ = value;
+    *value_ = std::move(value);
     MaybeUpdateSharedProtoStateAfterSettingValue(shared_proto_state);
   }
 
@@ -406,7 +412,7 @@ class VirtualTupleSlot {
   // Move 'value' into this object. If we should be storing SharedProtoState for
   // 'value', initializes it.
   void SetValue(Value&& value) {
-    *value_ = value;
+    *value_ = std::move(value);
     MaybeResetSharedProtoState();
   }
 
@@ -453,7 +459,7 @@ inline void TupleSlot::SetValue(const Value& value) {
 
 inline void TupleSlot::SetValue(Value&& value) {
   VirtualTupleSlot slot(this);
-  slot.SetValue(value);
+  slot.SetValue(std::move(value));
 }
 
 inline void TupleSlot::CopyFromSlot(const TupleSlot& other) {
@@ -588,51 +594,352 @@ inline std::vector<const TupleData*> StripSharedPtrs(
   return ret;
 }
 
+// A thread-safe memory budget that can be shared by several MemoryAccountants
+// (e.g., by multiple queries evaluating concurrently against one budget). The
+// accountants act as shards of the pool: each one acquires bytes from the pool
+// in large chunks and serves individual requests from its local reservation,
+// so the shared counter is only touched once per chunk instead of once per
+// tuple. The counter uses relaxed atomics because it does not guard any other
+// data; it only bounds the total number of bytes in use.
+class SharedMemoryPool {
+ public:
+  // Constructs a SharedMemoryPool from which at most 'total_num_bytes' can be
+  // acquired at once.
+  explicit SharedMemoryPool(int64_t total_num_bytes)
+      : total_num_bytes_(total_num_bytes), remaining_bytes_(total_num_bytes) {}
+
+  SharedMemoryPool(const SharedMemoryPool&) = delete;
+  SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+  ~SharedMemoryPool() {
+    DCHECK_EQ(remaining_bytes_.load(std::memory_order_relaxed),
+              total_num_bytes_);
+  }
+
+  // Moves up to 'num_bytes' from the pool to the caller. Returns the number of
+  // bytes actually acquired, which is less than 'num_bytes' if the pool does
+  // not have that many left (and zero if it is exhausted).
+  int64_t AcquireBytes(int64_t num_bytes) {
+    DCHECK_GE(num_bytes, 0);
+    int64_t remaining = remaining_bytes_.load(std::memory_order_relaxed);
+    while (true) {
+      const int64_t granted = std::min(num_bytes, remaining);
+      if (granted <= 0) return 0;
+      if (remaining_bytes_.compare_exchange_weak(remaining, remaining - granted,
+                                                 std::memory_order_relaxed)) {
+        return granted;
+      }
+    }
+  }
+
+  // Returns 'num_bytes' so they are available to future calls to
+  // AcquireBytes().
+  void ReleaseBytes(int64_t num_bytes) {
+    DCHECK_GE(num_bytes, 0);
+    remaining_bytes_.fetch_add(num_bytes, std::memory_order_relaxed);
+    DCHECK_LE(remaining_bytes_.load(std::memory_order_relaxed),
+              total_num_bytes_);
+  }
+
+  int64_t total_num_bytes() const { return total_num_bytes_; }
+
+  int64_t remaining_bytes() const {
+    return remaining_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const int64_t total_num_bytes_;
+  std::atomic<int64_t> remaining_bytes_;
+};
+
 // Tracks the amount of memory used for tuples in places that accumulate a bunch
-// of them.
+// of them. Thread-safe: concurrent workers (e.g., AnalyticOp evaluating
+// independent partitions in parallel) may request and return bytes on the same
+// accountant. When threads mostly do independent accounting, prefer giving
+// each thread its own MemoryAccountant backed by the same SharedMemoryPool so
+// that they stay off a shared mutex.
 class MemoryAccountant {
  public:
+  // The number of bytes a MemoryAccountant acquires from (and the local
+  // surplus beyond which it releases bytes back to) its SharedMemoryPool.
+  static constexpr int64_t kSharedPoolChunkBytes = 1 << 20;
+
   // Constructs a MemoryAccountant that can allocate at most 'total_num_bytes'
-  // at once.
-  explicit MemoryAccountant(int64_t total_num_bytes)
-      : total_num_bytes_(total_num_bytes), remaining_bytes_(total_num_bytes) {}
+  // at once. If 'shared_pool' is non-NULL, 'total_num_bytes' is ignored and
+  // the accountant instead draws on the pool's budget; requests can then fail
+  // slightly early because other accountants sharing the pool may each hold up
+  // to 2 * kSharedPoolChunkBytes of unused local reservation.
+  explicit MemoryAccountant(int64_t total_num_bytes,
+                            SharedMemoryPool* shared_pool = nullptr)
+      : total_num_bytes_(shared_pool != nullptr ? shared_pool->total_num_bytes()
+                                                : total_num_bytes),
+        remaining_bytes_(shared_pool != nullptr ? 0 : total_num_bytes),
+        shared_pool_(shared_pool) {}
 
   MemoryAccountant(const MemoryAccountant&) = delete;
   MemoryAccountant& operator=(const MemoryAccountant&) = delete;
-  ~MemoryAccountant() { DCHECK_EQ(remaining_bytes_, total_num_bytes_); }
+  ~MemoryAccountant() {
+    if (shared_pool_ != nullptr) {
+      DCHECK_EQ(remaining_bytes_, bytes_from_pool_);
+      shared_pool_->ReleaseBytes(remaining_bytes_);
+    } else {
+      DCHECK_EQ(remaining_bytes_, total_num_bytes_);
+    }
+  }
 
   // If there are 'num_bytes' available, updates the number of remaining bytes
   // accordingly and returns true. Else returns false and populates
   // 'status'. Does not return zetasql_base::Status for performance reasons.
   bool RequestBytes(int64_t num_bytes, zetasql_base::Status* status) {
     DCHECK_GE(num_bytes, 0);
+    absl::MutexLock l(&mutex_);
     if (num_bytes > remaining_bytes_) {
-      *status = zetasql_base::ResourceExhaustedErrorBuilder()
-                << "Out of memory: requested " << num_bytes
-                << " bytes but only " << remaining_bytes_
-                << " are available out of a total of " << total_num_bytes_;
-      return false;
+      if (shared_pool_ != nullptr) {
+        // Top up the local reservation. Acquiring a full chunk (instead of
+        // just the deficit) keeps the pool's shared counter off the per-tuple
+        // hot path; AcquireBytes() grants whatever is left if the pool cannot
+        // cover the full chunk.
+        const int64_t acquired = shared_pool_->AcquireBytes(
+            std::max(num_bytes - remaining_bytes_, kSharedPoolChunkBytes));
+        remaining_bytes_ += acquired;
+        bytes_from_pool_ += acquired;
+      }
+      if (num_bytes > remaining_bytes_) {
+        *status = zetasql_base::ResourceExhaustedErrorBuilder()
+                  << "Out of memory: requested " << num_bytes
+                  << " bytes but only " << remaining_bytes_
+                  << " are available out of a total of " << total_num_bytes_;
+        return false;
+      }
     }
     remaining_bytes_ -= num_bytes;
+    peak_used_bytes_ = std::max(peak_used_bytes_, used_bytes_locked());
+    if (usage_callback_ != nullptr && usage_callback_armed_ &&
+        used_bytes_locked() >= usage_threshold_bytes_) {
+      usage_callback_armed_ = false;
+      usage_callback_(used_bytes_locked());
+    }
     return true;
   }
 
   // Returns 'num_bytes' so they are available to future calls to
   // RequestBytes().
   void ReturnBytes(int64_t num_bytes) {
+    absl::MutexLock l(&mutex_);
     remaining_bytes_ += num_bytes;
-    DCHECK_LE(remaining_bytes_, total_num_bytes_);
+    if (shared_pool_ != nullptr) {
+      DCHECK_LE(remaining_bytes_, bytes_from_pool_);
+      // Cap the local surplus so that an accountant that has released most of
+      // its memory does not hold back bytes that other accountants sharing
+      // the pool may need.
+      if (remaining_bytes_ > 2 * kSharedPoolChunkBytes) {
+        const int64_t excess = remaining_bytes_ - kSharedPoolChunkBytes;
+        shared_pool_->ReleaseBytes(excess);
+        remaining_bytes_ -= excess;
+        bytes_from_pool_ -= excess;
+      }
+    } else {
+      DCHECK_LE(remaining_bytes_, total_num_bytes_);
+    }
+    if (usage_callback_ != nullptr && !usage_callback_armed_ &&
+        used_bytes_locked() < usage_threshold_bytes_) {
+      usage_callback_armed_ = true;
+    }
+  }
+
+  int64_t remaining_bytes() const {
+    absl::MutexLock l(&mutex_);
+    return remaining_bytes_;
+  }
+
+  // The number of bytes this accountant can allocate at once.
+  int64_t total_num_bytes() const { return total_num_bytes_; }
+
+  // The number of bytes currently charged to this accountant.
+  int64_t used_bytes() const {
+    absl::MutexLock l(&mutex_);
+    return used_bytes_locked();
+  }
+
+  // The largest number of bytes that were simultaneously charged to this
+  // accountant so far.
+  int64_t peak_used_bytes() const {
+    absl::MutexLock l(&mutex_);
+    return peak_used_bytes_;
   }
 
-  int64_t remaining_bytes() const { return remaining_bytes_; }
+  using UsageCallback = std::function<void(int64_t used_bytes)>;
+
+  // Registers 'callback' to be invoked from RequestBytes() when used_bytes()
+  // rises to at least 'threshold_bytes'. The callback is re-armed when usage
+  // drops back below the threshold, so it can fire once per upward crossing.
+  // It runs synchronously on the thread calling RequestBytes() and must not
+  // call back into this accountant.
+  void SetUsageCallback(int64_t threshold_bytes, UsageCallback callback) {
+    DCHECK_GE(threshold_bytes, 0);
+    absl::MutexLock l(&mutex_);
+    usage_threshold_bytes_ = threshold_bytes;
+    usage_callback_ = std::move(callback);
+    usage_callback_armed_ = true;
+  }
 
  private:
+  int64_t used_bytes_locked() const EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return (shared_pool_ != nullptr ? bytes_from_pool_ : total_num_bytes_) -
+           remaining_bytes_;
+  }
+
   const int64_t total_num_bytes_;
-  int64_t remaining_bytes_;
+  // Guards all mutable state below.
+  mutable absl::Mutex mutex_;
+  int64_t remaining_bytes_ GUARDED_BY(mutex_);
+  // The shared pool backing this accountant, or NULL if it has its own budget.
+  SharedMemoryPool* shared_pool_ = nullptr;
+  // The number of bytes currently acquired from 'shared_pool_'. Always zero if
+  // 'shared_pool_' is NULL.
+  int64_t bytes_from_pool_ GUARDED_BY(mutex_) = 0;
+  int64_t peak_used_bytes_ GUARDED_BY(mutex_) = 0;
+  // See SetUsageCallback(). 'usage_callback_armed_' is false after the
+  // callback fires until usage drops back below the threshold.
+  int64_t usage_threshold_bytes_ GUARDED_BY(mutex_) = 0;
+  UsageCallback usage_callback_ GUARDED_BY(mutex_);
+  bool usage_callback_armed_ GUARDED_BY(mutex_) = true;
+};
+
+// A freelist of TupleDatas, keyed by the number of slots, that allows an
+// iterator to reuse tuple storage instead of heap-allocating a new TupleData
+// for every row. Not thread-safe.
+class TupleDataPool {
+ public:
+  TupleDataPool() {}
+  TupleDataPool(const TupleDataPool&) = delete;
+  TupleDataPool& operator=(const TupleDataPool&) = delete;
+
+  // Returns a TupleData with 'num_slots' slots, reusing one from a previous
+  // call to Return() if possible.
+  std::unique_ptr<TupleData> Borrow(int num_slots) {
+    std::vector<std::unique_ptr<TupleData>>* free_list =
+        &free_lists_[num_slots];
+    if (free_list->empty()) {
+      return absl::make_unique<TupleData>(num_slots);
+    }
+    std::unique_ptr<TupleData> data = std::move(free_list->back());
+    free_list->pop_back();
+    return data;
+  }
+
+  // Makes 'data' available to future calls to Borrow(). Drops the values in
+  // 'data' (so that they do not stay alive while the TupleData sits in the
+  // pool) but retains its slot storage.
+  void Return(std::unique_ptr<TupleData> data) {
+    for (int i = 0; i < data->num_slots(); ++i) {
+      *data->mutable_slot(i)->mutable_value() = Value();
+    }
+    free_lists_[data->num_slots()].push_back(std::move(data));
+  }
+
+ private:
+  absl::flat_hash_map<int, std::vector<std::unique_ptr<TupleData>>>
+      free_lists_;
+};
+
+// Stores a sequence of TupleDatas in a temporary file for operators that
+// spill to disk under memory pressure (e.g., the external sort in SortOp and
+// partitioned aggregation in AggregateOp). Each tuple is framed as a sequence
+// of length-prefixed serialized ValueProtos, one per slot in 'slot_types'.
+// The file is created with std::tmpfile(), so the operating system removes it
+// when this object is destroyed.
+class TupleSpillFile {
+ public:
+  explicit TupleSpillFile(std::vector<const Type*> slot_types)
+      : slot_types_(std::move(slot_types)), file_(std::tmpfile()) {}
+
+  TupleSpillFile(const TupleSpillFile&) = delete;
+  TupleSpillFile& operator=(const TupleSpillFile&) = delete;
+
+  ~TupleSpillFile() {
+    if (file_ != nullptr) std::fclose(file_);
+  }
+
+  // Appends 'data' to the file. Only the first slot_types_.size() slots are
+  // written; any extra slots contain invalid Values and are recreated by
+  // ReadTuple().
+  zetasql_base::Status WriteTuple(const TupleData& data) {
+    ZETASQL_RET_CHECK(file_ != nullptr)
+        << "Failed to create temporary file for spilling";
+    ZETASQL_RET_CHECK_GE(data.num_slots(), slot_types_.size());
+    for (int i = 0; i < slot_types_.size(); ++i) {
+      ValueProto value_proto;
+      ZETASQL_RETURN_IF_ERROR(data.slot(i).value().Serialize(&value_proto));
+      const std::string bytes = value_proto.SerializeAsString();
+      const uint64_t num_bytes = bytes.size();
+      ZETASQL_RET_CHECK_EQ(std::fwrite(&num_bytes, sizeof(num_bytes), 1, file_), 1)
+          << "Failed to write to temporary file for spilling";
+      if (num_bytes > 0) {
+        ZETASQL_RET_CHECK_EQ(std::fwrite(bytes.data(), 1, num_bytes, file_),
+                     num_bytes)
+            << "Failed to write to temporary file for spilling";
+      }
+    }
+    return zetasql_base::OkStatus();
+  }
+
+  // Rewinds the file so that ReadTuple() starts from the first tuple.
+  zetasql_base::Status StartRead() {
+    ZETASQL_RET_CHECK(file_ != nullptr)
+        << "Failed to create temporary file for spilling";
+    std::rewind(file_);
+    return zetasql_base::OkStatus();
+  }
+
+  // Reads the next tuple into '*data', giving it 'num_extra_slots' extra
+  // slots. The TupleData is borrowed from 'pool' to avoid allocating a new
+  // one per tuple. Returns false if the file is exhausted.
+  zetasql_base::StatusOr<bool> ReadTuple(int num_extra_slots, TupleDataPool* pool,
+                                 std::unique_ptr<TupleData>* data) {
+    uint64_t num_bytes;
+    if (std::fread(&num_bytes, sizeof(num_bytes), 1, file_) != 1) {
+      ZETASQL_RET_CHECK_NE(std::feof(file_), 0)
+          << "Failed to read from temporary file for spilling";
+      return false;
+    }
+    *data = pool->Borrow(slot_types_.size() + num_extra_slots);
+    std::string bytes;
+    for (int i = 0; i < slot_types_.size(); ++i) {
+      if (i > 0) {
+        ZETASQL_RET_CHECK_EQ(std::fread(&num_bytes, sizeof(num_bytes), 1, file_), 1)
+            << "Failed to read from temporary file for spilling";
+      }
+      bytes.resize(num_bytes);
+      if (num_bytes > 0) {
+        ZETASQL_RET_CHECK_EQ(std::fread(&bytes[0], 1, num_bytes, file_), num_bytes)
+            << "Failed to read from temporary file for spilling";
+      }
+      ValueProto value_proto;
+      ZETASQL_RET_CHECK(value_proto.ParseFromString(bytes))
+          << "Failed to parse a Value from a spill file";
+      ZETASQL_ASSIGN_OR_RETURN(Value value,
+                       Value::Deserialize(value_proto, slot_types_[i]));
+      (*data)->mutable_slot(i)->SetValue(std::move(value));
+    }
+    return true;
+  }
+
+  int num_slot_types() const { return slot_types_.size(); }
+
+ private:
+  const std::vector<const Type*> slot_types_;
+  std::FILE* file_;
 };
 
 // Holds a deque of TupleDatas whose memory usage is tracked by a
-// MemoryAccountant, which is not owned by this object.
+// MemoryAccountant, which is not owned by this object. The TupleDatas are
+// stored inline in the deque rather than behind per-tuple heap allocations:
+// std::deque keeps its elements in fixed-size contiguous blocks, so
+// consecutive tuples are adjacent in memory (good locality for the
+// materializing operators that scan them) and pushing at either end never
+// moves existing elements, so pointers handed out by Back() and
+// GetTuplePtrs() remain valid until the pointed-to entry is popped or the
+// deque is sorted.
 class TupleDataDeque {
  public:
   explicit TupleDataDeque(MemoryAccountant* accountant)
@@ -648,26 +955,48 @@ class TupleDataDeque {
   int64_t GetSize() const { return datas_.size(); }
 
   // Adds 'data' to the deque. Returns true on success. On failure, returns
-  // false and populates 'status'. Any modifications to 'data' while it is in
-  // this object are unaccounted for. This method does not return zetasql_base::Status
-  // for performance reasons.
-  bool PushBack(std::unique_ptr<TupleData> data, zetasql_base::Status* status) {
+  // false and populates 'status'. Any modifications to the stored tuple while
+  // it is in this object are unaccounted for. This method does not return
+  // zetasql_base::Status for performance reasons.
+  bool PushBack(TupleData data, zetasql_base::Status* status) {
+    return TryPushBack(&data, status);
+  }
+
+  // Like PushBack(), but on failure leaves '*data' intact so the caller can
+  // free up memory (e.g., by spilling to disk) and try again.
+  bool TryPushBack(TupleData* data, zetasql_base::Status* status) {
     const int64_t byte_size = data->GetPhysicalByteSize() + sizeof(Entry);
     if (!accountant_->RequestBytes(byte_size, status)) {
       return false;
     }
-    datas_.emplace_back(byte_size, std::move(data));
+    datas_.emplace_back(byte_size, std::move(*data));
     return true;
   }
 
-  // Removes the front entry of the deque, which must be non-empty.
-  std::unique_ptr<TupleData> PopFront() {
+  // Like PushBack(), but adds 'data' to the front of the deque.
+  bool PushFront(TupleData data, zetasql_base::Status* status) {
+    const int64_t byte_size = data.GetPhysicalByteSize() + sizeof(Entry);
+    if (!accountant_->RequestBytes(byte_size, status)) {
+      return false;
+    }
+    datas_.emplace_front(byte_size, std::move(data));
+    return true;
+  }
+
+  // Removes and returns the front entry of the deque, which must be
+  // non-empty.
+  TupleData PopFront() {
     Entry entry = std::move(datas_.front());
     datas_.pop_front();
     accountant_->ReturnBytes(entry.first);
     return std::move(entry.second);
   }
 
+  // Returns a pointer to the last tuple of the deque, which must be
+  // non-empty. The pointer stays valid across further pushes at either end
+  // (but not across Sort() or popping the entry).
+  const TupleData* Back() const { return &datas_.back().second; }
+
   // Clears the deque.
   void Clear() {
     while (!IsEmpty()) {
@@ -680,7 +1009,7 @@ class TupleDataDeque {
     std::vector<const TupleData*> ptrs;
     ptrs.reserve(datas_.size());
     for (const Entry& entry : datas_) {
-      ptrs.push_back(entry.second.get());
+      ptrs.push_back(&entry.second);
     }
     return ptrs;
   }
@@ -690,12 +1019,23 @@ class TupleDataDeque {
   // into the appropriate slots. Also updates the memory accountant accordingly.
   zetasql_base::Status SetSlot(int slot_idx, std::vector<Value> values);
 
-  // Sorts the deque using std::sort or std::stable_sort.
+  // Sorts the deque using std::sort or std::stable_sort, or a radix sort if
+  // 'comparator' orders by a single fixed-width key (see RadixSort() below).
   void Sort(const TupleComparator& comparator, bool use_stable_sort);
 
  private:
-  // Stores a TupleData and its memory size.
-  using Entry = std::pair<int64_t, std::unique_ptr<TupleData>>;
+  // Stores a TupleData (inline) and its memory size.
+  using Entry = std::pair<int64_t, TupleData>;
+
+  // Sorts the deque with an LSD radix sort over (key, index) pairs followed
+  // by a permutation of the entries, which is typically several times faster
+  // than a comparison sort for large inputs. Returns false without modifying
+  // the deque if 'comparator' does not order by a single fixed-width key
+  // (per TupleComparator::GetRadixSortSpec()), if the deque is too small for
+  // the radix sort to pay off, or if a TIMESTAMP key cannot be represented
+  // as int64_t nanoseconds. The radix sort is stable, so it is a valid
+  // implementation of both modes of Sort().
+  bool RadixSort(const TupleComparator& comparator);
 
   MemoryAccountant* accountant_;
 
@@ -777,6 +1117,106 @@ class TupleDataOrderedQueue {
   std::multimap<const TupleData*, ValueEntry, Comparator> entries_;
 };
 
+// A bounded priority queue that keeps the 'max_size' smallest TupleDatas
+// inserted into it, breaking ties in favor of earlier insertions (so it keeps
+// the same tuples as a stable sort followed by LIMIT 'max_size'). Memory usage
+// is tracked by a MemoryAccountant, which is not owned by this object. Unlike
+// a TupleDataOrderedQueue that is trimmed after every insertion, a full
+// TupleDataTopNQueue rejects a tuple that is not among the 'max_size' smallest
+// with a single comparison and no allocation, which makes it much cheaper for
+// computing the top N tuples of a large input.
+class TupleDataTopNQueue {
+ public:
+  TupleDataTopNQueue(const TupleComparator& comparator, int64_t max_size,
+                     MemoryAccountant* accountant)
+      : comparator_(comparator), max_size_(max_size), accountant_(accountant) {
+    DCHECK_GE(max_size_, 0);
+  }
+
+  TupleDataTopNQueue(const TupleDataTopNQueue&) = delete;
+  TupleDataTopNQueue& operator=(const TupleDataTopNQueue&) = delete;
+
+  ~TupleDataTopNQueue() { Clear(); }
+
+  bool IsEmpty() const { return entries_.empty(); }
+
+  int64_t GetSize() const { return entries_.size(); }
+
+  // Adds 'data' to the queue if it is among the 'max_size' smallest tuples
+  // inserted so far, evicting the largest entry if the queue would exceed its
+  // bound. Returns true on success, whether or not 'data' was kept. On
+  // failure, returns false and populates 'status'. Any modifications to 'data'
+  // while it is in this object are unaccounted for. This method does not
+  // return zetasql_base::Status for performance reasons.
+  bool Insert(std::unique_ptr<TupleData> data, zetasql_base::Status* status) {
+    if (max_size_ == 0) return true;
+    if (GetSize() >= max_size_ &&
+        !comparator_(*data, *entries_.front().data)) {
+      // 'data' sorts at or after the largest kept tuple (which was inserted
+      // before it, so it wins ties), so 'data' is not among the top
+      // 'max_size_' tuples.
+      return true;
+    }
+    const int64_t byte_size = data->GetPhysicalByteSize() + sizeof(Entry);
+    if (!accountant_->RequestBytes(byte_size, status)) {
+      return false;
+    }
+    entries_.push_back(Entry{next_sequence_number_++, byte_size,
+                             std::move(data)});
+    const auto heap_less = [this](const Entry& a, const Entry& b) {
+      return HeapLess(a, b);
+    };
+    std::push_heap(entries_.begin(), entries_.end(), heap_less);
+    if (GetSize() > max_size_) {
+      PopBack();
+    }
+    return true;
+  }
+
+  // Removes and returns the largest entry of the queue (preferring the most
+  // recently inserted one among ties), which must be non-empty.
+  std::unique_ptr<TupleData> PopBack() {
+    const auto heap_less = [this](const Entry& a, const Entry& b) {
+      return HeapLess(a, b);
+    };
+    std::pop_heap(entries_.begin(), entries_.end(), heap_less);
+    Entry entry = std::move(entries_.back());
+    entries_.pop_back();
+    accountant_->ReturnBytes(entry.byte_size);
+    return std::move(entry.data);
+  }
+
+  // Clears the queue.
+  void Clear() {
+    while (!IsEmpty()) {
+      PopBack();
+    }
+  }
+
+ private:
+  // Stores a TupleData, its memory reservation for 'accountant_', and its
+  // insertion sequence number (used to break ties between equal tuples).
+  struct Entry {
+    int64_t sequence_number;
+    int64_t byte_size;
+    std::unique_ptr<TupleData> data;
+  };
+
+  // Orders 'entries_' as a max-heap whose root is the entry to evict next: the
+  // largest tuple, preferring the most recently inserted one among ties.
+  bool HeapLess(const Entry& a, const Entry& b) const {
+    if (comparator_(*a.data, *b.data)) return true;
+    if (comparator_(*b.data, *a.data)) return false;
+    return a.sequence_number < b.sequence_number;
+  }
+
+  const TupleComparator comparator_;
+  const int64_t max_size_;
+  MemoryAccountant* accountant_;
+  int64_t next_sequence_number_ = 0;
+  std::vector<Entry> entries_;
+};
+
 // Represents a hash set of values with memory tracked by a MemoryAccountant.
 class ValueHashSet {
  public:
@@ -818,6 +1258,60 @@ class ValueHashSet {
   absl::flat_hash_set<Value> values_;
 };
 
+// Dedups (group, value) pairs for all the groups of an aggregation in a
+// single flat hash table. Each group allocates its own group id and passes it
+// to Insert(), so one table provides per-group distinct semantics without
+// maintaining a separate hash set per group (which fragments memory when
+// there are many groups). Bytes for inserted values are not returned to the
+// accountant until Clear() is called.
+class DistinctValueTable {
+ public:
+  explicit DistinctValueTable(MemoryAccountant* accountant)
+      : accountant_(accountant) {}
+
+  DistinctValueTable(const DistinctValueTable&) = delete;
+  DistinctValueTable& operator=(const DistinctValueTable&) = delete;
+
+  ~DistinctValueTable() { Clear(); }
+
+  // Returns a group id with no values in the table. Group ids from before the
+  // last call to Clear() must not be reused.
+  int64_t AllocateGroupId() { return next_group_id_++; }
+
+  // Same contract as ValueHashSet::Insert(), except that 'value' is only
+  // considered present if it was previously inserted with the same
+  // 'group_id'.
+  bool Insert(int64_t group_id, const Value& value, bool* inserted,
+              zetasql_base::Status* status) {
+    *inserted = false;
+    if (values_.contains(std::make_pair(group_id, value))) {
+      return true;
+    }
+    if (!accountant_->RequestBytes(sizeof(int64_t) + value.physical_byte_size(),
+                                   status)) {
+      return false;
+    }
+    values_.emplace(group_id, value);
+    *inserted = true;
+    return true;
+  }
+
+  // Removes the values for all groups and returns their bytes to the
+  // accountant.
+  void Clear() {
+    for (const auto& entry : values_) {
+      accountant_->ReturnBytes(sizeof(int64_t) +
+                               entry.second.physical_byte_size());
+    }
+    values_.clear();
+  }
+
+ private:
+  MemoryAccountant* accountant_;
+  int64_t next_group_id_ = 0;
+  absl::flat_hash_set<std::pair<int64_t, Value>> values_;
+};
+
 // An iterator over TupleDatas. Particularly useful as a representation of a
 // relation. Implementations must be thread compatible.
 //
@@ -851,6 +1345,45 @@ class TupleIterator {
   // TupleData into a wider TupleData with more slots.
   virtual TupleData* Next() = 0;
 
+  // Suggested value of 'max_rows' for NextBatch().
+  static constexpr int kDefaultBatchSize = 1024;
+
+  // Batch-at-a-time variant of Next(). Clears 'batch' and fills it with up to
+  // 'max_rows' tuples. Returns false when no tuples were produced, either
+  // because the iterator is exhausted or because there is an error; the
+  // caller must call Status() to distinguish. The tuples in 'batch' are owned
+  // by the caller and remain valid across subsequent calls.
+  //
+  // The default implementation simply copies tuples out of Next().  Iterators
+  // whose per-tuple work is small (e.g., filtering and computing expressions)
+  // override this to process a whole batch per virtual call.  A caller must
+  // use either Next() or NextBatch() on a given iterator, not both; the
+  // behavior of NextBatch() is undefined after it has returned false.
+  virtual bool NextBatch(int max_rows, std::vector<TupleData>* batch);
+
+  // Hints that the caller intends to read this iterator's tuples, but possibly
+  // not right away. Iterators that can produce tuples in the background (see
+  // PrefetchingTupleIterator in relational_op.cc) start doing so; iterators
+  // that merely wrap another iterator forward the hint; everything else
+  // ignores it. Next() implies this hint, so it only matters for iterators
+  // whose first Next() call may be a long time coming, such as the later
+  // inputs of a UNION ALL. Like Next(), it must not be called before any
+  // calls to DisableReordering().
+  virtual void StartPrefetch() {}
+
+  // Returns a best-effort estimate of the number of tuples this iterator will
+  // produce, or absl::nullopt if no estimate is available (the default). Must
+  // be cheap and is only meaningful before the first call to
+  // Next()/NextBatch(). Iterators that merely wrap another iterator without
+  // changing its cardinality forward the estimate; table scans derive it from
+  // EvaluatorTableIterator::ApproximateRowCount(). Used for adaptive
+  // decisions such as hash-join build-side selection (see
+  // JoinOp::CreateIterator() in relational_op.cc); the estimate never affects
+  // query results.
+  virtual absl::optional<int64_t> ApproximateRowCount() const {
+    return absl::nullopt;
+  }
+
   // Returns the current status.
   virtual zetasql_base::Status Status() const = 0;
 
@@ -862,6 +1395,8 @@ class TupleIterator {
   //   the order of tuples (x1, y1), (x2, y2) where x1 = x2, but not tuples
   //   where x1 != x2.
   // - LetOpTupleIterator (used by LetOp), which just wraps another iterator.
+  // - ProfilingTupleIterator (see RelationalOp::MaybeProfile() in operator.h),
+  //   which just wraps another iterator.
   // - TestTupleIterator, which is a test-only class.
   virtual bool PreservesOrder() const { return true; }
 
@@ -884,6 +1419,11 @@ class TupleIterator {
 // Wraps another iterator and scrambles its order. The scrambling is
 // deterministic to make issues easier to debug. There is some nontrivial
 // processing involved so this iterator should only be used in tests.
+// Scrambling buffers batches of tuples from the wrapped iterator; if
+// DisableReordering() is called (which must happen before the first call to
+// Next()), tuples are instead streamed through one at a time without reading
+// ahead, so consumers that only look at a prefix of the input (e.g., EXISTS)
+// do not pull tuples they will never use.
 class ReorderingTupleIterator : public TupleIterator {
  public:
   explicit ReorderingTupleIterator(std::unique_ptr<TupleIterator> iter)
@@ -896,6 +1436,12 @@ class ReorderingTupleIterator : public TupleIterator {
 
   TupleData* Next() override;
 
+  void StartPrefetch() override { iter_->StartPrefetch(); }
+
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return iter_->ApproximateRowCount();
+  }
+
   zetasql_base::Status Status() const override { return status_; }
 
   bool PreservesOrder() const override { return !reorder_; }
@@ -979,6 +1525,127 @@ class PassThroughTupleIterator : public TupleIterator {
   zetasql_base::Status iterator_factory_status_;
 };
 
+// Streams the merge of a set of sorted runs of tuples that an operator
+// spilled to disk as TupleSpillFiles under memory pressure (e.g., the
+// external sort in SortOp or partitioned aggregation in AggregateOp). Ties
+// between runs are broken in favor of the earlier run, so that a stable sort
+// of the input remains stable. Unlike the in-memory iterators of those
+// operators, this iterator never scrambles tuples with equal keys; it is only
+// used when spilling is enabled, which is never the case for compliance or
+// random query tests.
+//
+// Like PassThroughTupleIterator, this class uses callbacks to avoid a
+// dependency on EvaluationContext.
+class SortedRunMergeTupleIterator : public TupleIterator {
+ public:
+  // We avoid constructing the debug std::string where possible because that can be
+  // expensive.
+  using DebugStringFactory = std::function<std::string()>;
+  // Called periodically (every 'verify_not_aborted_period' tuples) so that
+  // the merge can be cancelled; typically wraps
+  // EvaluationContext::VerifyNotAborted().
+  using VerifyNotAbortedCallback = std::function<zetasql_base::Status()>;
+
+  SortedRunMergeTupleIterator(
+      const DebugStringFactory& debug_string_factory,
+      std::unique_ptr<const TupleSchema> schema,
+      std::unique_ptr<TupleComparator> comparator,
+      std::vector<std::unique_ptr<TupleSpillFile>> runs, int num_extra_slots,
+      int64_t verify_not_aborted_period,
+      const VerifyNotAbortedCallback& verify_not_aborted)
+      : debug_string_factory_(debug_string_factory),
+        schema_(std::move(schema)),
+        comparator_(std::move(comparator)),
+        runs_(std::move(runs)),
+        num_extra_slots_(num_extra_slots),
+        verify_not_aborted_period_(verify_not_aborted_period),
+        verify_not_aborted_(verify_not_aborted) {}
+
+  SortedRunMergeTupleIterator(const SortedRunMergeTupleIterator&) = delete;
+  SortedRunMergeTupleIterator& operator=(const SortedRunMergeTupleIterator&) =
+      delete;
+
+  const TupleSchema& Schema() const override { return *schema_; }
+
+  TupleData* Next() override {
+    if (num_next_calls_ % verify_not_aborted_period_ == 0) {
+      status_ = verify_not_aborted_();
+      if (!status_.ok()) {
+        return nullptr;
+      }
+    }
+    if (num_next_calls_ == 0) {
+      status_ = StartMerge();
+      if (!status_.ok()) {
+        return nullptr;
+      }
+    }
+    ++num_next_calls_;
+
+    // Pick the smallest head tuple, preferring the earliest run on ties.
+    int min_run_idx = -1;
+    for (int i = 0; i < heads_.size(); ++i) {
+      if (heads_[i] == nullptr) continue;
+      if (min_run_idx == -1 ||
+          (*comparator_)(*heads_[i], *heads_[min_run_idx])) {
+        min_run_idx = i;
+      }
+    }
+    if (min_run_idx == -1) return nullptr;
+
+    // The previously returned tuple may be invalidated by this call, so
+    // recycle its storage for the next read.
+    if (current_ != nullptr) {
+      pool_.Return(std::move(current_));
+    }
+    current_ = std::move(heads_[min_run_idx]);
+    status_ = AdvanceRun(min_run_idx);
+    if (!status_.ok()) {
+      return nullptr;
+    }
+    return current_.get();
+  }
+
+  zetasql_base::Status Status() const override { return status_; }
+
+  std::string DebugString() const override { return debug_string_factory_(); }
+
+ private:
+  // Rewinds every run and loads its first tuple into 'heads_'.
+  zetasql_base::Status StartMerge() {
+    heads_.resize(runs_.size());
+    for (int i = 0; i < runs_.size(); ++i) {
+      ZETASQL_RETURN_IF_ERROR(runs_[i]->StartRead());
+      ZETASQL_RETURN_IF_ERROR(AdvanceRun(i));
+    }
+    return zetasql_base::OkStatus();
+  }
+
+  // Loads the next tuple of run 'run_idx' into 'heads_', which is left NULL if
+  // the run is exhausted.
+  zetasql_base::Status AdvanceRun(int run_idx) {
+    heads_[run_idx] = nullptr;
+    return runs_[run_idx]
+        ->ReadTuple(num_extra_slots_, &pool_, &heads_[run_idx])
+        .status();
+  }
+
+  const DebugStringFactory debug_string_factory_;
+  const std::unique_ptr<const TupleSchema> schema_;
+  const std::unique_ptr<TupleComparator> comparator_;
+  std::vector<std::unique_ptr<TupleSpillFile>> runs_;
+  const int num_extra_slots_;
+  const int64_t verify_not_aborted_period_;
+  const VerifyNotAbortedCallback verify_not_aborted_;
+  // The next unmerged tuple of each run, or NULL if the run is exhausted.
+  std::vector<std::unique_ptr<TupleData>> heads_;
+  // Recycles the TupleDatas of returned tuples into ReadTuple() calls.
+  TupleDataPool pool_;
+  std::unique_ptr<TupleData> current_;
+  int64_t num_next_calls_ = 0;
+  zetasql_base::Status status_;
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_REFERENCE_IMPL_TUPLE_H_
@@ -69,6 +69,27 @@ static zetasql_base::Status GetZetaSqlCollators(
   return ::zetasql_base::OkStatus();
 }
 
+// Orders two key values of which at least one is NULL under 'key's direction
+// and null order. Returns false if both values are null, in which case the
+// key considers the tuples equal and does not order them; otherwise sets
+// '*less' to whether the first tuple sorts before the second.
+static inline bool MixedNullLess(const KeyArg* key, bool v1_null, bool v2_null,
+                                 bool* less) {
+  if (v1_null && v2_null) return false;  // NULLs are considered equal.
+  if (key->is_descending()) {
+    // NULLS LAST is the default for DESC order.
+    const bool nulls_last = key->null_order() != KeyArg::kNullsFirst;
+    // Non-null sorts after null except with nulls-first ordering.
+    *less = nulls_last ? !v1_null : v1_null;
+  } else {
+    // NULLS FIRST is the default for ASC order.
+    const bool nulls_first = key->null_order() != KeyArg::kNullsLast;
+    // Null sorts before non-null except with nulls-last ordering.
+    *less = nulls_first ? !v2_null : v2_null;
+  }
+  return true;
+}
+
 zetasql_base::StatusOr<std::unique_ptr<TupleComparator>> TupleComparator::Create(
     absl::Span<const KeyArg* const> keys, absl::Span<const int> slots_for_keys,
     absl::Span<const TupleData* const> params, EvaluationContext* context) {
@@ -79,8 +100,129 @@ zetasql_base::StatusOr<std::unique_ptr<TupleComparator>> TupleComparator::Create
   return absl::WrapUnique(new TupleComparator(keys, slots_for_keys, collators));
 }
 
+const std::string& TupleComparator::GetSortKey(
+    int key_index, const ZetaSqlCollator& collator,
+    const std::string& value) const {
+  absl::flat_hash_map<std::string, std::string>& cache =
+      (*sort_key_caches_)[key_index];
+  auto it = cache.find(value);
+  if (it == cache.end()) {
+    std::string sort_key;
+    collator.GetSortKeyUtf8(value, &sort_key);
+    it = cache.emplace(value, std::move(sort_key)).first;
+  }
+  return it->second;
+}
+
+bool TupleComparator::CompareInt64Key(const TupleComparator& comparator,
+                                      const TupleData& t1,
+                                      const TupleData& t2) {
+  const KeyArg* key = comparator.keys_[0];
+  const int slot_idx = comparator.slots_for_keys_[0];
+  const Value& v1 = t1.slot(slot_idx).value();
+  const Value& v2 = t2.slot(slot_idx).value();
+  if (v1.is_null() || v2.is_null()) {
+    bool less;
+    return MixedNullLess(key, v1.is_null(), v2.is_null(), &less) && less;
+  }
+  const int64_t x1 = v1.int64_value();
+  const int64_t x2 = v2.int64_value();
+  return key->is_descending() ? x2 < x1 : x1 < x2;
+}
+
+bool TupleComparator::CompareInt64Int64Keys(const TupleComparator& comparator,
+                                            const TupleData& t1,
+                                            const TupleData& t2) {
+  for (int i = 0; i < 2; ++i) {
+    const KeyArg* key = comparator.keys_[i];
+    const int slot_idx = comparator.slots_for_keys_[i];
+    const Value& v1 = t1.slot(slot_idx).value();
+    const Value& v2 = t2.slot(slot_idx).value();
+    if (v1.is_null() || v2.is_null()) {
+      bool less;
+      if (MixedNullLess(key, v1.is_null(), v2.is_null(), &less)) return less;
+      continue;  // Both null; this key does not order the tuples.
+    }
+    const int64_t x1 = v1.int64_value();
+    const int64_t x2 = v2.int64_value();
+    if (x1 != x2) {
+      return key->is_descending() ? x2 < x1 : x1 < x2;
+    }
+  }
+  return false;
+}
+
+bool TupleComparator::CompareBinaryStringKey(const TupleComparator& comparator,
+                                             const TupleData& t1,
+                                             const TupleData& t2) {
+  const KeyArg* key = comparator.keys_[0];
+  const int slot_idx = comparator.slots_for_keys_[0];
+  const Value& v1 = t1.slot(slot_idx).value();
+  const Value& v2 = t2.slot(slot_idx).value();
+  if (v1.is_null() || v2.is_null()) {
+    bool less;
+    return MixedNullLess(key, v1.is_null(), v2.is_null(), &less) && less;
+  }
+  const int result = v1.string_value().compare(v2.string_value());
+  return key->is_descending() ? result > 0 : result < 0;
+}
+
+TupleComparator::FastCompare TupleComparator::SelectFastCompare() const {
+  // Keys with an explicit collation other than binary need the collation
+  // logic in the generic loop.
+  for (const std::unique_ptr<const ZetaSqlCollator>& collator : *collators_) {
+    if (collator != nullptr && !collator->IsBinaryComparison()) return nullptr;
+  }
+  if (keys_.size() == 1) {
+    switch (keys_[0]->type()->kind()) {
+      case TYPE_INT64:
+        return &TupleComparator::CompareInt64Key;
+      case TYPE_STRING:
+        // With a binary collator the generic loop also compares the string
+        // encodings, so the specialization covers both the collated and the
+        // uncollated case.
+        return &TupleComparator::CompareBinaryStringKey;
+      default:
+        return nullptr;
+    }
+  }
+  if (keys_.size() == 2 && keys_[0]->type()->kind() == TYPE_INT64 &&
+      keys_[1]->type()->kind() == TYPE_INT64) {
+    return &TupleComparator::CompareInt64Int64Keys;
+  }
+  return nullptr;
+}
+
+absl::optional<TupleComparator::RadixSortSpec>
+TupleComparator::GetRadixSortSpec() const {
+  if (keys_.size() != 1) return absl::nullopt;
+  // Collated keys (which are always strings) need the collation logic in
+  // operator().
+  if ((*collators_)[0] != nullptr) return absl::nullopt;
+  const KeyArg* key = keys_[0];
+  const TypeKind kind = key->type()->kind();
+  if (kind != TYPE_INT64 && kind != TYPE_DATE && kind != TYPE_TIMESTAMP) {
+    return absl::nullopt;
+  }
+  RadixSortSpec spec;
+  spec.slot = slots_for_keys_[0];
+  spec.type_kind = kind;
+  spec.descending = key->is_descending();
+  // This matches the null ordering in MixedNullLess(): NULLS LAST is the
+  // default for DESC order and NULLS FIRST is the default for ASC order.
+  if (key->is_descending()) {
+    spec.nulls_first = key->null_order() == KeyArg::kNullsFirst;
+  } else {
+    spec.nulls_first = key->null_order() != KeyArg::kNullsLast;
+  }
+  return spec;
+}
+
 bool TupleComparator::operator()(const TupleData& t1,
                                  const TupleData& t2) const {
+  if (fast_compare_ != nullptr) {
+    return (*fast_compare_)(*this, t1, t2);
+  }
   for (int i = 0; i < keys_.size(); ++i) {
     const KeyArg* key = keys_[i];
     const ZetaSqlCollator* collator = (*collators_)[i].get();
@@ -90,29 +232,24 @@ bool TupleComparator::operator()(const TupleData& t1,
     const Value& v2 = t2.slot(slot_idx).value();
 
     if (v1.is_null() || v2.is_null()) {
-      if (v1.is_null() && v2.is_null()) {  // NULLs are considered equal.
-        continue;
-      }
-      if (key->is_descending()) {
-        // NULLS LAST is the default for DESC order.
-        const bool nulls_last = key->null_order() != KeyArg::kNullsFirst;
-        // Non-null sorts after null except with nulls-first ordering.
-        return nulls_last ? !v1.is_null() : v1.is_null();
-      } else {
-        // NULLS FIRST is the default for ASC order.
-        const bool nulls_first = key->null_order() != KeyArg::kNullsLast;
-        // Null sorts before non-null except with nulls-last ordering.
-        return nulls_first ? !v2.is_null() : v2.is_null();
-      }
+      bool less;
+      if (MixedNullLess(key, v1.is_null(), v2.is_null(), &less)) return less;
+      continue;  // Both null; this key does not order the tuples.
     }
 
     if (collator != nullptr) {
       DCHECK(v1.type()->IsString());
       DCHECK(v2.type()->IsString());
-      zetasql_base::Status status;
-      int64_t result =
-          collator->CompareUtf8(v1.string_value(), v2.string_value(), &status);
-      ZETASQL_DCHECK_OK(status);
+      int result;
+      if (collator->IsBinaryComparison()) {
+        result = v1.string_value().compare(v2.string_value());
+      } else {
+        // Compare precomputed sort keys instead of calling
+        // ZetaSqlCollator::CompareUtf8() per pair; each string's sort key is
+        // computed once and reused across all comparisons against it.
+        result = GetSortKey(i, *collator, v1.string_value())
+                     .compare(GetSortKey(i, *collator, v2.string_value()));
+      }
       if (result != 0) {  // v1 != v2
         if (key->is_descending()) {
           return result > 0;  // v1 > v2
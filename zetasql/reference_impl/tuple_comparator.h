@@ -18,10 +18,14 @@
 #define ZETASQL_REFERENCE_IMPL_TUPLE_COMPARATOR_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "zetasql/common/internal_value.h"
 #include "zetasql/public/collator.h"
+#include "zetasql/public/type.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "zetasql/base/status.h"
 
@@ -66,15 +70,62 @@ class TupleComparator {
 
   const std::vector<const KeyArg*>& keys() const { return keys_; }
 
+  // Describes a sort order that can be produced by a radix sort on a single
+  // fixed-width key instead of a comparison sort with this object.
+  struct RadixSortSpec {
+    // The index of the key's slot in a TupleData.
+    int slot;
+    // The kind of the key type: TYPE_INT64, TYPE_DATE, or TYPE_TIMESTAMP.
+    TypeKind type_kind;
+    // Whether the key sorts in descending order.
+    bool descending;
+    // Whether tuples with a NULL key sort before all tuples with non-NULL
+    // keys (as opposed to after all of them).
+    bool nulls_first;
+  };
+
+  // Returns a description of this comparator's sort order if it orders by a
+  // single uncollated INT64, DATE, or TIMESTAMP key, or nullopt if the key
+  // shape requires comparison sorting.
+  absl::optional<RadixSortSpec> GetRadixSortSpec() const;
+
  private:
   using Collators = std::vector<std::unique_ptr<const ZetaSqlCollator>>;
+  using SortKeyCaches = std::vector<absl::flat_hash_map<std::string, std::string>>;
 
   TupleComparator(absl::Span<const KeyArg* const> keys,
                   absl::Span<const int> slots_for_keys,
                   std::shared_ptr<const Collators> collators)
       : keys_(keys.begin(), keys.end()),
         slots_for_keys_(slots_for_keys.begin(), slots_for_keys.end()),
-        collators_(collators) {}
+        collators_(collators),
+        sort_key_caches_(std::make_shared<SortKeyCaches>(keys_.size())),
+        fast_compare_(SelectFastCompare()) {}
+
+  // Type-specialized comparison functions for common key shapes, selected
+  // once at construction time by SelectFastCompare(). They read the key
+  // slots and compare primitive values directly, bypassing the per-key type
+  // dispatch in the generic loop in operator(). Each is exactly equivalent
+  // to the generic loop for its shape, including null ordering.
+  using FastCompare = bool (*)(const TupleComparator& comparator,
+                               const TupleData& t1, const TupleData& t2);
+  static bool CompareInt64Key(const TupleComparator& comparator,
+                              const TupleData& t1, const TupleData& t2);
+  static bool CompareInt64Int64Keys(const TupleComparator& comparator,
+                                    const TupleData& t1, const TupleData& t2);
+  static bool CompareBinaryStringKey(const TupleComparator& comparator,
+                                     const TupleData& t1, const TupleData& t2);
+
+  // Returns the specialized comparison function for this comparator's key
+  // shape (single INT64, INT64+INT64, or single STRING compared by encoding),
+  // or nullptr if the shape has no specialization.
+  FastCompare SelectFastCompare() const;
+
+  // Returns the collation sort key for 'value', which is compared under
+  // 'collator' by the key in 'keys_' with index 'key_index'. The key is
+  // computed on first use and then served from 'sort_key_caches_'.
+  const std::string& GetSortKey(int key_index, const ZetaSqlCollator& collator,
+                                const std::string& value) const;
 
   const std::vector<const KeyArg*> keys_;
   const std::vector<int> slots_for_keys_;
@@ -84,6 +135,18 @@ class TupleComparator {
   // compared based on their UTF-8 encoding.
   // We use std::shared_ptr<const ...> to allow the comparator to be copied.
   const std::shared_ptr<const Collators> collators_;
+  // Collation sort keys previously computed by GetSortKey(), keyed by string
+  // value. This corresponds 1-1 with keys_; entries for keys without a
+  // collator stay empty. Comparing precomputed sort keys turns each repeated
+  // collated comparison (e.g. while sorting) into a plain string comparison,
+  // at a memory cost proportional to the distinct strings being compared
+  // (which the caller is typically already holding in memory).
+  // As above, std::shared_ptr allows the comparator to be copied.
+  const std::shared_ptr<SortKeyCaches> sort_key_caches_;
+  // Specialized comparison function for this comparator's key shape, or
+  // nullptr to use the generic loop. Must be initialized after the members
+  // above (SelectFastCompare() reads them).
+  const FastCompare fast_compare_;
 };
 
 }  // namespace zetasql
@@ -33,6 +33,7 @@ using testing::ElementsAre;
 using testing::HasSubstr;
 using testing::UnorderedElementsAre;
 
+using zetasql_base::testing::IsOkAndHolds;
 using zetasql_base::testing::StatusIs;
 
 TEST(TupleSchemaTest, BasicTests) {
@@ -59,6 +60,49 @@ TEST(TupleSchemaTest, BasicTests) {
   EXPECT_EQ("<foo,bar>", schema.DebugString());
 }
 
+TEST(ProtoFieldRegistryTest, ReadRegisteredProtoFieldsFillsColumns) {
+  TypeFactory type_factory;
+
+  ProtoFieldAccessInfo key_access;
+  key_access.field_info.descriptor =
+      zetasql_test::KitchenSinkPB::descriptor()->FindFieldByName("int64_key_1");
+  ASSERT_TRUE(key_access.field_info.descriptor != nullptr);
+  key_access.field_info.format = FieldFormat::DEFAULT_FORMAT;
+  key_access.field_info.type = types::Int64Type();
+  key_access.field_info.default_value = Int64(0);
+
+  ProtoFieldAccessInfo val_access = key_access;
+  val_access.field_info.descriptor =
+      zetasql_test::KitchenSinkPB::descriptor()->FindFieldByName("int64_val");
+  ASSERT_TRUE(val_access.field_info.descriptor != nullptr);
+  val_access.field_info.default_value = Int64(-1);
+
+  ProtoFieldRegistry registry(/*id=*/1);
+  EXPECT_EQ(0, registry.RegisterField(&key_access));
+  EXPECT_EQ(1, registry.RegisterField(&val_access));
+
+  // Two rows; the second leaves int64_val unset.
+  std::vector<std::string> rows(2);
+  zetasql_test::KitchenSinkPB row;
+  row.set_int64_key_1(10);
+  row.set_int64_key_2(20);
+  row.set_int64_val(100);
+  row.SerializePartialToString(&rows[0]);
+  row.set_int64_key_1(11);
+  row.clear_int64_val();
+  row.SerializePartialToString(&rows[1]);
+
+  std::vector<ProtoFieldValueList> columns;
+  ZETASQL_ASSERT_OK(ReadRegisteredProtoFields(registry, rows, &columns));
+  ASSERT_EQ(columns.size(), 2);
+  ASSERT_EQ(columns[0].size(), 2);
+  ASSERT_EQ(columns[1].size(), 2);
+  EXPECT_THAT(columns[0][0], IsOkAndHolds(Int64(10)));
+  EXPECT_THAT(columns[0][1], IsOkAndHolds(Int64(11)));
+  EXPECT_THAT(columns[1][0], IsOkAndHolds(Int64(100)));
+  EXPECT_THAT(columns[1][1], IsOkAndHolds(Int64(-1)));
+}
+
 TEST(TupleSlotTest, GetPhysicalByteSize) {
   const TupleSlot empty_slot;
   EXPECT_GT(empty_slot.GetPhysicalByteSize(), sizeof(Value));
@@ -164,6 +208,40 @@ TEST(TupleDataTest, Equals) {
   EXPECT_FALSE(data1.Equals(data4));
 }
 
+TEST(TupleDataPoolTest, BorrowAndReturn) {
+  TupleDataPool pool;
+
+  std::unique_ptr<TupleData> data2 = pool.Borrow(/*num_slots=*/2);
+  EXPECT_EQ(2, data2->num_slots());
+  data2->mutable_slot(0)->SetValue(Int64(10));
+  data2->mutable_slot(1)->SetValue(Int64(20));
+  const TupleData* data2_ptr = data2.get();
+
+  std::unique_ptr<TupleData> data3 = pool.Borrow(/*num_slots=*/3);
+  EXPECT_EQ(3, data3->num_slots());
+  const TupleData* data3_ptr = data3.get();
+
+  pool.Return(std::move(data2));
+  pool.Return(std::move(data3));
+
+  // Borrowing again returns the recycled TupleDatas with the matching number
+  // of slots, but with their values dropped.
+  std::unique_ptr<TupleData> recycled3 = pool.Borrow(/*num_slots=*/3);
+  EXPECT_EQ(data3_ptr, recycled3.get());
+  EXPECT_EQ(3, recycled3->num_slots());
+
+  std::unique_ptr<TupleData> recycled2 = pool.Borrow(/*num_slots=*/2);
+  EXPECT_EQ(data2_ptr, recycled2.get());
+  EXPECT_EQ(2, recycled2->num_slots());
+  EXPECT_FALSE(recycled2->slot(0).value().is_valid());
+  EXPECT_FALSE(recycled2->slot(1).value().is_valid());
+
+  // The pool is now empty, so another Borrow() allocates a fresh TupleData.
+  std::unique_ptr<TupleData> fresh2 = pool.Borrow(/*num_slots=*/2);
+  EXPECT_NE(data2_ptr, fresh2.get());
+  EXPECT_EQ(2, fresh2->num_slots());
+}
+
 TEST(Tuple, DebugString) {
   TupleSchema schema({VariableId("foo"), VariableId("bar")});
   TupleData data = CreateTupleDataFromValues({Int64(10), NullInt64()});
@@ -260,6 +338,104 @@ TEST(MemoryAccountant, BasicTest) {
   accountant.ReturnBytes(50);
 }
 
+TEST(MemoryAccountant, UsedAndPeakBytes) {
+  MemoryAccountant accountant(/*total_num_bytes=*/100);
+  zetasql_base::Status status;
+  EXPECT_EQ(accountant.total_num_bytes(), 100);
+  EXPECT_EQ(accountant.used_bytes(), 0);
+  EXPECT_EQ(accountant.peak_used_bytes(), 0);
+
+  EXPECT_TRUE(accountant.RequestBytes(60, &status));
+  EXPECT_EQ(accountant.used_bytes(), 60);
+  EXPECT_EQ(accountant.peak_used_bytes(), 60);
+
+  accountant.ReturnBytes(50);
+  EXPECT_EQ(accountant.used_bytes(), 10);
+  EXPECT_EQ(accountant.peak_used_bytes(), 60);
+
+  EXPECT_TRUE(accountant.RequestBytes(30, &status));
+  EXPECT_EQ(accountant.used_bytes(), 40);
+  EXPECT_EQ(accountant.peak_used_bytes(), 60);
+
+  accountant.ReturnBytes(40);
+}
+
+TEST(MemoryAccountant, UsageCallbackFiresOncePerUpwardCrossing) {
+  MemoryAccountant accountant(/*total_num_bytes=*/100);
+  zetasql_base::Status status;
+
+  std::vector<int64_t> usages;
+  accountant.SetUsageCallback(
+      /*threshold_bytes=*/50,
+      [&usages](int64_t used_bytes) { usages.push_back(used_bytes); });
+
+  // Stays below the threshold: no callback.
+  EXPECT_TRUE(accountant.RequestBytes(40, &status));
+  EXPECT_TRUE(usages.empty());
+
+  // Crosses the threshold: fires once, and not again while usage stays above
+  // the threshold.
+  EXPECT_TRUE(accountant.RequestBytes(20, &status));
+  EXPECT_THAT(usages, ElementsAre(60));
+  EXPECT_TRUE(accountant.RequestBytes(20, &status));
+  EXPECT_THAT(usages, ElementsAre(60));
+
+  // Dropping below the threshold re-arms the callback for the next crossing.
+  accountant.ReturnBytes(60);
+  EXPECT_TRUE(accountant.RequestBytes(40, &status));
+  EXPECT_THAT(usages, ElementsAre(60, 60));
+
+  accountant.ReturnBytes(60);
+}
+
+TEST(MemoryAccountant, SharedMemoryPoolTest) {
+  SharedMemoryPool pool(/*total_num_bytes=*/100);
+  EXPECT_EQ(pool.total_num_bytes(), 100);
+  EXPECT_EQ(pool.remaining_bytes(), 100);
+  zetasql_base::Status status;
+
+  {
+    MemoryAccountant accountant1(/*total_num_bytes=*/0, &pool);
+    MemoryAccountant accountant2(/*total_num_bytes=*/0, &pool);
+
+    // An accountant acquires from the pool in chunks, so the first request
+    // grabs everything this small pool has.
+    EXPECT_TRUE(accountant1.RequestBytes(50, &status));
+    ZETASQL_EXPECT_OK(status);
+    EXPECT_EQ(accountant1.remaining_bytes(), 50);
+    EXPECT_EQ(pool.remaining_bytes(), 0);
+
+    EXPECT_TRUE(accountant1.RequestBytes(50, &status));
+    ZETASQL_EXPECT_OK(status);
+    EXPECT_EQ(accountant1.remaining_bytes(), 0);
+
+    // The shared budget is exhausted, so requests through either accountant
+    // fail.
+    EXPECT_FALSE(accountant1.RequestBytes(1, &status));
+    EXPECT_THAT(status, StatusIs(zetasql_base::StatusCode::kResourceExhausted));
+    status = zetasql_base::OkStatus();
+
+    EXPECT_FALSE(accountant2.RequestBytes(1, &status));
+    EXPECT_THAT(status, StatusIs(zetasql_base::StatusCode::kResourceExhausted));
+    status = zetasql_base::OkStatus();
+
+    // Returned bytes stay in the accountant's local reservation (they are far
+    // below the chunk size), and are released to the pool when the accountant
+    // is destroyed.
+    accountant1.ReturnBytes(100);
+    EXPECT_EQ(accountant1.remaining_bytes(), 100);
+    EXPECT_EQ(pool.remaining_bytes(), 0);
+  }
+  EXPECT_EQ(pool.remaining_bytes(), 100);
+
+  // The released bytes are available to a new accountant.
+  MemoryAccountant accountant3(/*total_num_bytes=*/0, &pool);
+  EXPECT_TRUE(accountant3.RequestBytes(100, &status));
+  ZETASQL_EXPECT_OK(status);
+  EXPECT_EQ(pool.remaining_bytes(), 0);
+  accountant3.ReturnBytes(100);
+}
+
 TEST(TupleDataDeque, PushAndPopTest) {
   MemoryAccountant accountant(/*total_num_bytes=*/1000);
 
@@ -276,7 +452,7 @@ TEST(TupleDataDeque, PushAndPopTest) {
     TupleData data = CreateTupleDataFromValues({Int64(num_tuples)});
 
     zetasql_base::Status status;
-    if (!deque.PushBack(absl::make_unique<TupleData>(data), &status)) {
+    if (!deque.PushBack(data, &status)) {
       ASSERT_THAT(status, StatusIs(zetasql_base::StatusCode::kResourceExhausted));
       EXPECT_EQ(remaining_bytes, accountant.remaining_bytes());
       break;
@@ -306,9 +482,9 @@ TEST(TupleDataDeque, PushAndPopTest) {
     ASSERT_FALSE(deque.IsEmpty());
     const int64_t remaining_bytes = accountant.remaining_bytes();
 
-    std::unique_ptr<TupleData> data = deque.PopFront();
-    ASSERT_EQ(data->num_slots(), 1);
-    EXPECT_EQ(data->slot(0).value(), Int64(i));
+    const TupleData data = deque.PopFront();
+    ASSERT_EQ(data.num_slots(), 1);
+    EXPECT_EQ(data.slot(0).value(), Int64(i));
 
     EXPECT_GE(accountant.remaining_bytes(), remaining_bytes + sizeof(int64_t));
   }
@@ -323,9 +499,9 @@ TEST(TupleDataDeque, DestructorTest) {
     TupleDataDeque deque(&accountant);
     TupleData data = CreateTupleDataFromValues({Int64(10)});
     zetasql_base::Status status;
-    ASSERT_TRUE(deque.PushBack(absl::make_unique<TupleData>(data), &status));
-    ASSERT_TRUE(deque.PushBack(absl::make_unique<TupleData>(data), &status));
-    ASSERT_TRUE(deque.PushBack(absl::make_unique<TupleData>(data), &status));
+    ASSERT_TRUE(deque.PushBack(data, &status));
+    ASSERT_TRUE(deque.PushBack(data, &status));
+    ASSERT_TRUE(deque.PushBack(data, &status));
     EXPECT_LT(accountant.remaining_bytes(), 1000);
   }
   EXPECT_EQ(accountant.remaining_bytes(), 1000);
@@ -341,7 +517,7 @@ TEST(TupleDataDeque, SetSlotTest) {
     TupleData data(/*num_slots=*/2);
     data.mutable_slot(0)->SetValue(Int64(i));
     zetasql_base::Status status;
-    ASSERT_TRUE(deque.PushBack(absl::make_unique<TupleData>(data), &status));
+    ASSERT_TRUE(deque.PushBack(data, &status));
   }
 
   int64_t original_remaining_bytes = accountant.remaining_bytes();
@@ -409,6 +585,102 @@ TEST(TupleDataDeque, SetSlotTest) {
   }
 }
 
+// Sorts by a single descending INT64 key with NULLS FIRST. The input is
+// large enough for Sort() to take the radix sort path; slot 1 carries the
+// input position so the test can verify stability among equal keys.
+TEST(TupleDataDeque, RadixSortInt64Key) {
+  VariableId k1("k1"), k2("k2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, Int64Type()));
+  KeyArg key_arg(k2, std::move(key), KeyArg::kDescending, KeyArg::kNullsFirst);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+
+  MemoryAccountant accountant(/*total_num_bytes=*/1 << 20);
+  TupleDataDeque deque(&accountant);
+  zetasql_base::Status status;
+  const int num_tuples = 200;
+  for (int i = 0; i < num_tuples; ++i) {
+    // Duplicated keys (including negative ones) with some NULLs mixed in.
+    const Value key_value =
+        (i % 17 == 0) ? NullInt64() : Int64((i * 37) % 50 - 25);
+    TupleData data = CreateTupleDataFromValues({key_value, Int64(i)});
+    ASSERT_TRUE(deque.PushBack(data, &status));
+  }
+  deque.Sort(*comparator, /*use_stable_sort=*/true);
+
+  const std::vector<const TupleData*> tuples = deque.GetTuplePtrs();
+  ASSERT_EQ(tuples.size(), num_tuples);
+  int i = 0;
+  // The NULL keys come first, in input order.
+  Value previous_position = Int64(-1);
+  for (; i < num_tuples && tuples[i]->slot(0).value().is_null(); ++i) {
+    EXPECT_TRUE(previous_position.LessThan(tuples[i]->slot(1).value()));
+    previous_position = tuples[i]->slot(1).value();
+  }
+  EXPECT_GT(i, 0);
+  // The non-NULL keys are descending; equal keys keep their input order.
+  for (++i; i < num_tuples; ++i) {
+    const Value& previous_key = tuples[i - 1]->slot(0).value();
+    const Value& current_key = tuples[i]->slot(0).value();
+    ASSERT_FALSE(current_key.is_null());
+    EXPECT_FALSE(previous_key.LessThan(current_key));
+    if (previous_key.Equals(current_key)) {
+      EXPECT_TRUE(
+          tuples[i - 1]->slot(1).value().LessThan(tuples[i]->slot(1).value()));
+    }
+  }
+}
+
+// Like the above, but with an ascending TIMESTAMP key and the default null
+// order (NULLS FIRST for ascending keys).
+TEST(TupleDataDeque, RadixSortTimestampKey) {
+  VariableId k1("k1"), k2("k2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, TimestampType()));
+  KeyArg key_arg(k2, std::move(key), KeyArg::kAscending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+
+  MemoryAccountant accountant(/*total_num_bytes=*/1 << 20);
+  TupleDataDeque deque(&accountant);
+  zetasql_base::Status status;
+  const int num_tuples = 100;
+  for (int i = 0; i < num_tuples; ++i) {
+    const Value key_value =
+        (i % 13 == 0) ? NullTimestamp()
+                      : TimestampFromUnixMicros((i * 31) % 40 - 20);
+    TupleData data = CreateTupleDataFromValues({key_value, Int64(i)});
+    ASSERT_TRUE(deque.PushBack(data, &status));
+  }
+  deque.Sort(*comparator, /*use_stable_sort=*/true);
+
+  const std::vector<const TupleData*> tuples = deque.GetTuplePtrs();
+  ASSERT_EQ(tuples.size(), num_tuples);
+  int i = 0;
+  for (; i < num_tuples && tuples[i]->slot(0).value().is_null(); ++i) {
+  }
+  EXPECT_GT(i, 0);
+  for (++i; i < num_tuples; ++i) {
+    const Value& previous_key = tuples[i - 1]->slot(0).value();
+    const Value& current_key = tuples[i]->slot(0).value();
+    ASSERT_FALSE(current_key.is_null());
+    EXPECT_FALSE(current_key.LessThan(previous_key));
+    if (previous_key.Equals(current_key)) {
+      EXPECT_TRUE(
+          tuples[i - 1]->slot(1).value().LessThan(tuples[i]->slot(1).value()));
+    }
+  }
+}
+
 TEST(TupleDataOrderedQueue, InsertAndPopTest) {
   VariableId k1("k1"), k2("k2");
   TupleSchema schema({k1});
@@ -502,6 +774,181 @@ TEST(TupleDataOrderedQueue, DestructorTest) {
   EXPECT_EQ(accountant.remaining_bytes(), 1000);
 }
 
+TEST(TupleDataTopNQueue, InsertAndPopTest) {
+  VariableId k1("k1"), k2("k2");
+  TupleSchema schema({k1});
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, Int64Type()));
+  KeyArg key_arg(k2, std::move(key), KeyArg::kAscending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+
+  MemoryAccountant accountant(/*total_num_bytes=*/1000);
+  TupleDataTopNQueue q(*comparator, /*max_size=*/3, &accountant);
+  zetasql_base::Status status;
+
+  // Insert keys 5, 0, 4, 1, 3, 2. Only the three smallest are kept.
+  for (const int64_t k : {5, 0, 4, 1, 3, 2}) {
+    TupleData data = CreateTupleDataFromValues({Int64(k)});
+    ASSERT_TRUE(q.Insert(absl::make_unique<TupleData>(data), &status));
+    ZETASQL_ASSERT_OK(status);
+    EXPECT_LE(q.GetSize(), 3);
+  }
+  EXPECT_EQ(q.GetSize(), 3);
+
+  // PopBack() returns the kept tuples from largest to smallest.
+  for (const int64_t k : {2, 1, 0}) {
+    ASSERT_FALSE(q.IsEmpty());
+    std::unique_ptr<TupleData> data = q.PopBack();
+    ASSERT_EQ(data->num_slots(), 1);
+    EXPECT_EQ(data->slot(0).value(), Int64(k));
+  }
+  EXPECT_TRUE(q.IsEmpty());
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
+TEST(TupleComparator, SpecializedInt64Key) {
+  VariableId k1("k1"), k2("k2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, Int64Type()));
+  // NULLS LAST overrides the ascending default of NULLS FIRST.
+  KeyArg key_arg(k2, std::move(key), KeyArg::kAscending, KeyArg::kNullsLast);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+  const auto less = [&comparator](const Value& v1, const Value& v2) {
+    return (*comparator)(CreateTupleDataFromValues({v1}),
+                         CreateTupleDataFromValues({v2}));
+  };
+  EXPECT_TRUE(less(Int64(1), Int64(2)));
+  EXPECT_FALSE(less(Int64(2), Int64(1)));
+  EXPECT_FALSE(less(Int64(1), Int64(1)));
+  EXPECT_TRUE(less(Int64(1), NullInt64()));
+  EXPECT_FALSE(less(NullInt64(), Int64(1)));
+  EXPECT_FALSE(less(NullInt64(), NullInt64()));
+}
+
+TEST(TupleComparator, SpecializedInt64Int64Keys) {
+  VariableId k1("k1"), k2("k2"), v1("v1"), v2("v2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key1,
+                       DerefExpr::Create(k1, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key2,
+                       DerefExpr::Create(k2, Int64Type()));
+  KeyArg key_arg1(v1, std::move(key1), KeyArg::kDescending);
+  KeyArg key_arg2(v2, std::move(key2), KeyArg::kAscending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg1, &key_arg2}, /*slots_for_keys=*/{0, 1},
+                              /*params=*/{}, &context));
+  const auto less = [&comparator](const Value& a1, const Value& a2,
+                                  const Value& b1, const Value& b2) {
+    return (*comparator)(CreateTupleDataFromValues({a1, a2}),
+                         CreateTupleDataFromValues({b1, b2}));
+  };
+  EXPECT_TRUE(less(Int64(2), Int64(5), Int64(1), Int64(0)));
+  EXPECT_FALSE(less(Int64(1), Int64(0), Int64(2), Int64(5)));
+  // Ties on the first key fall through to the second.
+  EXPECT_TRUE(less(Int64(1), Int64(3), Int64(1), Int64(4)));
+  EXPECT_FALSE(less(Int64(1), Int64(4), Int64(1), Int64(3)));
+  EXPECT_FALSE(less(Int64(1), Int64(4), Int64(1), Int64(4)));
+  // NULLS LAST is the default for the descending first key; a tie of NULLs
+  // there still falls through to the second key.
+  EXPECT_TRUE(less(Int64(1), Int64(0), NullInt64(), Int64(0)));
+  EXPECT_TRUE(less(NullInt64(), Int64(3), NullInt64(), Int64(4)));
+}
+
+TEST(TupleComparator, SpecializedStringKey) {
+  VariableId k1("k1"), k2("k2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, StringType()));
+  KeyArg key_arg(k2, std::move(key), KeyArg::kAscending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+  const auto less = [&comparator](const Value& v1, const Value& v2) {
+    return (*comparator)(CreateTupleDataFromValues({v1}),
+                         CreateTupleDataFromValues({v2}));
+  };
+  EXPECT_TRUE(less(String("a"), String("b")));
+  EXPECT_FALSE(less(String("b"), String("a")));
+  EXPECT_FALSE(less(String("a"), String("a")));
+  EXPECT_TRUE(less(String("a"), String("aa")));
+  // NULLS FIRST is the default for ascending order.
+  EXPECT_TRUE(less(NullString(), String("a")));
+  EXPECT_FALSE(less(String("a"), NullString()));
+}
+
+TEST(TupleDataTopNQueue, TieBreakingTest) {
+  VariableId k1("k1"), k2("k2"), v("v");
+  TupleSchema schema({k1, v});
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                       DerefExpr::Create(k1, Int64Type()));
+  KeyArg key_arg(k2, std::move(key), KeyArg::kAscending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                              /*params=*/{}, &context));
+
+  MemoryAccountant accountant(/*total_num_bytes=*/1000);
+  TupleDataTopNQueue q(*comparator, /*max_size=*/2, &accountant);
+  zetasql_base::Status status;
+
+  // All three tuples have the same key, so the queue keeps the two that were
+  // inserted first (like a stable sort followed by LIMIT 2 would).
+  for (const std::string& id : {"a", "b", "c"}) {
+    TupleData data = CreateTupleDataFromValues({Int64(1), String(id)});
+    ASSERT_TRUE(q.Insert(absl::make_unique<TupleData>(data), &status));
+    ZETASQL_ASSERT_OK(status);
+  }
+  EXPECT_EQ(q.GetSize(), 2);
+
+  // Among equal tuples, PopBack() returns the most recently inserted first.
+  EXPECT_EQ(q.PopBack()->slot(1).value(), String("b"));
+  EXPECT_EQ(q.PopBack()->slot(1).value(), String("a"));
+  EXPECT_TRUE(q.IsEmpty());
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
+TEST(TupleDataTopNQueue, DestructorTest) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1000);
+  {
+    VariableId k1("k1"), k2("k2");
+    TupleSchema schema({k1});
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key,
+                         DerefExpr::Create(k1, Int64Type()));
+    KeyArg key_arg(k2, std::move(key), KeyArg::kAscending);
+
+    EvaluationContext context((EvaluationOptions()));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<TupleComparator> comparator,
+        TupleComparator::Create({&key_arg}, /*slots_for_keys=*/{0},
+                                /*params=*/{}, &context));
+
+    TupleDataTopNQueue q(*comparator, /*max_size=*/3, &accountant);
+    TupleData data = CreateTupleDataFromValues({Int64(10)});
+    zetasql_base::Status status;
+    ASSERT_TRUE(q.Insert(absl::make_unique<TupleData>(data), &status));
+    ASSERT_TRUE(q.Insert(absl::make_unique<TupleData>(data), &status));
+    ASSERT_TRUE(q.Insert(absl::make_unique<TupleData>(data), &status));
+    EXPECT_LT(accountant.remaining_bytes(), 1000);
+  }
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
 TEST(ValueHashSet, BasicTest) {
   MemoryAccountant accountant(/*total_num_bytes=*/1000);
   ValueHashSet set(&accountant);
@@ -552,6 +999,54 @@ TEST(ValueHashSet, DestructorTest) {
   EXPECT_EQ(accountant.remaining_bytes(), 1000);
 }
 
+TEST(DistinctValueTable, PerGroupDistinctness) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1000);
+  DistinctValueTable table(&accountant);
+
+  const int64_t group1 = table.AllocateGroupId();
+  const int64_t group2 = table.AllocateGroupId();
+  ASSERT_NE(group1, group2);
+
+  bool inserted;
+  zetasql_base::Status status;
+  EXPECT_TRUE(table.Insert(group1, Int64(0), &inserted, &status));
+  EXPECT_TRUE(inserted);
+  EXPECT_TRUE(table.Insert(group1, Int64(0), &inserted, &status));
+  EXPECT_FALSE(inserted);
+  // The same value is still distinct in another group.
+  EXPECT_TRUE(table.Insert(group2, Int64(0), &inserted, &status));
+  EXPECT_TRUE(inserted);
+
+  EXPECT_LT(accountant.remaining_bytes(), 1000);
+  table.Clear();
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
+TEST(DistinctValueTable, OutOfMemory) {
+  MemoryAccountant accountant(/*total_num_bytes=*/1000);
+  {
+    DistinctValueTable table(&accountant);
+    const int64_t group = table.AllocateGroupId();
+    int num_values = 0;
+    while (true) {
+      bool inserted;
+      zetasql_base::Status status;
+      if (!table.Insert(group, Int64(num_values), &inserted, &status)) {
+        EXPECT_THAT(status,
+                    StatusIs(zetasql_base::StatusCode::kResourceExhausted));
+        EXPECT_FALSE(inserted);
+        break;
+      }
+      ++num_values;
+    }
+
+    // Ensure we got a reasonable number of values. 10 is an arbitrary number.
+    ASSERT_GE(num_values, 10);
+  }
+  // The destructor returns the bytes to the accountant.
+  EXPECT_EQ(accountant.remaining_bytes(), 1000);
+}
+
 TEST(ReorderingTupleIterator, BasicTest) {
   for (int size = 0; size <= 500; ++size) {
     for (bool error : {false, true}) {
@@ -629,6 +1124,61 @@ TEST(ReorderingTupleIterator, DisableReordering) {
   EXPECT_EQ(output[2].slot(0).value(), Int64(2));
 }
 
+// Forwards to another iterator, counting the calls to Next().
+class CountingTupleIterator : public TupleIterator {
+ public:
+  CountingTupleIterator(std::unique_ptr<TupleIterator> iter,
+                        int* num_next_calls)
+      : iter_(std::move(iter)), num_next_calls_(num_next_calls) {}
+
+  CountingTupleIterator(const CountingTupleIterator&) = delete;
+  CountingTupleIterator& operator=(const CountingTupleIterator&) = delete;
+
+  const TupleSchema& Schema() const override { return iter_->Schema(); }
+
+  TupleData* Next() override {
+    ++*num_next_calls_;
+    return iter_->Next();
+  }
+
+  zetasql_base::Status Status() const override { return iter_->Status(); }
+
+  std::string DebugString() const override { return iter_->DebugString(); }
+
+ private:
+  std::unique_ptr<TupleIterator> iter_;
+  int* num_next_calls_;
+};
+
+TEST(ReorderingTupleIterator, DisableReorderingDoesNotReadAhead) {
+  std::vector<TupleData> values;
+  for (int i = 0; i < 3; ++i) {
+    values.push_back(CreateTupleDataFromValues({Int64(i)}));
+  }
+  int num_next_calls = 0;
+  std::unique_ptr<TupleIterator> iter =
+      absl::make_unique<CountingTupleIterator>(
+          absl::make_unique<TestTupleIterator>(
+              std::vector<VariableId>{VariableId("foo")}, values,
+              /*preserves_order=*/true, zetasql_base::OkStatus()),
+          &num_next_calls);
+
+  iter = absl::make_unique<ReorderingTupleIterator>(std::move(iter));
+  ZETASQL_ASSERT_OK(iter->DisableReordering());
+
+  // With reordering disabled, the iterator must not buffer a batch of input
+  // tuples; it should read exactly one input tuple per call to Next().
+  const TupleData* data = iter->Next();
+  ASSERT_TRUE(data != nullptr);
+  EXPECT_EQ(data->slot(0).value(), Int64(0));
+  EXPECT_EQ(num_next_calls, 1);
+
+  data = iter->Next();
+  ASSERT_TRUE(data != nullptr);
+  EXPECT_EQ(data->slot(0).value(), Int64(1));
+  EXPECT_EQ(num_next_calls, 2);
+}
+
 TEST(ReorderingTupleIterator, DisableReorderingFailsAfterNext) {
   std::vector<TupleData> values;
   for (int i = 0; i < 3; ++i) {
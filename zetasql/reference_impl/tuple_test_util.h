@@ -24,6 +24,7 @@
 #include "zetasql/reference_impl/tuple.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/types/optional.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
 #include "zetasql/base/status_macros.h"
@@ -37,12 +38,18 @@ class TestTupleIterator : public TupleIterator {
  public:
   static std::string GetDebugString() { return "TestTupleIterator"; }
 
-  TestTupleIterator(absl::Span<const VariableId> variables,
-                    absl::Span<const TupleData> values, bool preserves_order,
-                    const zetasql_base::Status& end_status)
+  // If 'approximate_row_count' is set, the iterator reports it from
+  // ApproximateRowCount(); by default it reports no estimate, like most
+  // iterators.
+  TestTupleIterator(
+      absl::Span<const VariableId> variables,
+      absl::Span<const TupleData> values, bool preserves_order,
+      const zetasql_base::Status& end_status,
+      absl::optional<int64_t> approximate_row_count = absl::nullopt)
       : schema_(variables),
         end_status_(end_status),
         preserves_order_(preserves_order),
+        approximate_row_count_(approximate_row_count),
         values_(values.begin(), values.end()) {
     if (!preserves_order_) {
       std::reverse(values_.begin(), values_.end());
@@ -66,6 +73,10 @@ class TestTupleIterator : public TupleIterator {
 
   zetasql_base::Status Status() const override { return status_; }
 
+  absl::optional<int64_t> ApproximateRowCount() const override {
+    return approximate_row_count_;
+  }
+
   bool PreservesOrder() const override { return preserves_order_; }
 
   zetasql_base::Status DisableReordering() override {
@@ -83,6 +94,7 @@ class TestTupleIterator : public TupleIterator {
   const TupleSchema schema_;
   const zetasql_base::Status end_status_;
   bool preserves_order_;
+  const absl::optional<int64_t> approximate_row_count_;
   std::vector<TupleData> values_;
   int index_ = 0;
   bool cancelled_ = false;
@@ -17,6 +17,7 @@
 // Implementations of the various ValueExprs.
 
 #include <array>
+#include <cmath>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -33,6 +34,7 @@
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/message.h"
 #include "zetasql/common/internal_value.h"
+#include "zetasql/reference_impl/common.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/public/proto_util.h"
@@ -52,6 +54,7 @@
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include <cstdint>
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -632,8 +635,27 @@ bool ProtoFieldReader::GetFieldValue(const TupleSlot& proto_slot,
     value_list_owner = absl::make_unique<ProtoFieldValueList>();
     value_list = value_list_owner.get();
 
-    const ::zetasql_base::Status read_status = ReadProtoFields(
-        field_infos, proto_value.ToCord(), value_list_owner.get());
+    // If this message's fields have been read before (e.g., through a
+    // GetProtoFieldExpr with a different registry), the context hands back a
+    // wire-offset index for it, and we jump directly to the registered
+    // fields instead of re-scanning the message from byte 0.
+    std::shared_ptr<const ProtoWireOffsetIndex> wire_offset_index;
+    {
+      auto status_or_index = context->GetProtoWireOffsetIndex(proto_value);
+      if (!status_or_index.ok()) {
+        *status = status_or_index.status();
+        return false;
+      }
+      wire_offset_index = status_or_index.ValueOrDie();
+    }
+
+    const ::zetasql_base::Status read_status =
+        wire_offset_index != nullptr
+            ? ReadProtoFieldsWithOffsetIndex(field_infos, proto_value.ToCord(),
+                                             *wire_offset_index,
+                                             value_list_owner.get())
+            : ReadProtoFields(field_infos, proto_value.ToCord(),
+                              value_list_owner.get());
     if (!read_status.ok()) {
       *status = read_status;
       return false;
@@ -833,6 +855,12 @@ bool ExistsExpr::Eval(absl::Span<const TupleData* const> params,
   }
   std::unique_ptr<TupleIterator> iter = std::move(status_or_iter).ValueOrDie();
 
+  // The result of EXISTS cannot depend on the order of the input, so we
+  // disable reordering. This prevents ReorderingTupleIterator from buffering a
+  // batch of tuples when we only look at the first one.
+  *status = iter->DisableReordering();
+  if (!status->ok()) return false;
+
   const TupleData* tuple = iter->Next();
   if (tuple == nullptr) {
     *status = iter->Status();
@@ -894,13 +922,22 @@ bool ScalarFunctionCallExpr::Eval(absl::Span<const TupleData* const> params,
                                   VirtualTupleSlot* result,
                                   ::zetasql_base::Status* status) const {
   const auto& args = GetArgs();
-  std::vector<Value> call_args(args.size());
+  // Most builtin functions take a handful of arguments, so evaluating into an
+  // inlined buffer avoids a heap allocation per row.
+  absl::InlinedVector<Value, 4> call_args(args.size());
   for (int i = 0; i < args.size(); i++) {
     std::shared_ptr<TupleSlot::SharedProtoState> arg_shared_state;
     VirtualTupleSlot arg_result(&call_args[i], &arg_shared_state);
     if (!args[i]->value_expr()->Eval(params, context, &arg_result, status)) {
       return false;
     }
+    // An argument that decides the call (FALSE for AND, TRUE for OR) makes
+    // the remaining arguments irrelevant, so skip them.
+    if (short_circuit_value_.is_valid() &&
+        call_args[i].Equals(short_circuit_value_)) {
+      result->SetValue(call_args[i]);
+      return true;
+    }
   }
 
   if (!function_->Eval(call_args, context, result->mutable_value(), status)) {
@@ -932,7 +969,8 @@ ScalarFunctionCallExpr::ScalarFunctionCallExpr(
     ResolvedFunctionCallBase::ErrorMode error_mode)
     : ValueExpr(function->output_type()),
       function_(std::move(function)),
-      error_mode_(error_mode) {
+      error_mode_(error_mode),
+      short_circuit_value_(function_->ShortCircuitValue()) {
   std::vector<std::unique_ptr<ExprArg>> args;
   args.reserve(exprs.size());
   for (auto& e : exprs) {
@@ -941,6 +979,110 @@ ScalarFunctionCallExpr::ScalarFunctionCallExpr(
   SetArgs<ExprArg>(kArgument, std::move(args));
 }
 
+// -------------------------------------------------------
+// InListExpr
+// -------------------------------------------------------
+
+// Lists with at least this many distinct non-NULL values get a Bloom filter
+// in front of the hash set. For smaller lists the exact probe is cheap enough
+// that the extra filter probe does not pay off.
+static const int64_t kMinInListSizeForBloomFilter = 1024;
+
+// Returns true if 'value' is a floating point NaN, which SQL equality never
+// matches.
+static bool IsNaNValue(const Value& value) {
+  switch (value.type_kind()) {
+    case TYPE_DOUBLE:
+      return std::isnan(value.double_value());
+    case TYPE_FLOAT:
+      return std::isnan(value.float_value());
+    default:
+      return false;
+  }
+}
+
+::zetasql_base::StatusOr<std::unique_ptr<InListExpr>> InListExpr::Create(
+    std::unique_ptr<ValueExpr> needle, absl::Span<const Value> values) {
+  ZETASQL_RET_CHECK(needle != nullptr);
+  const Type* needle_type = needle->output_type();
+  ZETASQL_RET_CHECK(needle_type->IsSimpleType()) << needle_type->DebugString();
+  ZETASQL_RETURN_IF_ERROR(ValidateTypeSupportsEqualityComparison(needle_type));
+  for (const Value& value : values) {
+    ZETASQL_RET_CHECK(value.type()->Equals(needle_type))
+        << value.type()->DebugString() << " vs. "
+        << needle_type->DebugString();
+  }
+  return absl::WrapUnique(new InListExpr(std::move(needle), values));
+}
+
+::zetasql_base::Status InListExpr::SetSchemasForEvaluation(
+    absl::Span<const TupleSchema* const> params_schemas) {
+  return GetMutableArg(kNeedle)->mutable_value_expr()->SetSchemasForEvaluation(
+      params_schemas);
+}
+
+bool InListExpr::Eval(absl::Span<const TupleData* const> params,
+                      EvaluationContext* context, VirtualTupleSlot* result,
+                      ::zetasql_base::Status* status) const {
+  Value needle_value;
+  std::shared_ptr<TupleSlot::SharedProtoState> needle_shared_state;
+  VirtualTupleSlot needle_slot(&needle_value, &needle_shared_state);
+  if (!needle()->Eval(params, context, &needle_slot, status)) {
+    return false;
+  }
+
+  bool found = false;
+  if (!needle_value.is_null() && !values_.empty()) {
+    // 'values_' contains no NULLs or NaNs, so hash set equality (under which
+    // NULLs and NaNs compare equal to themselves, unlike under SQL equality)
+    // agrees with SQL equality for every possible probe.
+    const uint64_t hash = needle_value.HashCode();
+    if (bloom_filter_ == nullptr || bloom_filter_->MayContain(hash)) {
+      found = values_.contains(needle_value);
+    }
+  }
+  if (found) {
+    result->SetValue(Value::Bool(true));
+  } else if (has_null_ || needle_value.is_null()) {
+    // 'needle IN (..., NULL, ...)' is NULL rather than false when there is no
+    // match, as is 'NULL IN (...)' for a non-empty list.
+    result->SetValue(Value::NullBool());
+  } else {
+    result->SetValue(Value::Bool(false));
+  }
+  return true;
+}
+
+std::string InListExpr::DebugInternal(const std::string& indent,
+                                      bool verbose) const {
+  return absl::StrCat("InListExpr(",
+                      needle()->DebugInternal(indent + kIndentSpace, verbose),
+                      ", ", num_list_elements_, " values)");
+}
+
+InListExpr::InListExpr(std::unique_ptr<ValueExpr> needle,
+                       absl::Span<const Value> values)
+    : ValueExpr(types::BoolType()),
+      num_list_elements_(values.size()) {
+  values_.reserve(values.size());
+  for (const Value& value : values) {
+    if (value.is_null()) {
+      has_null_ = true;
+    } else if (!IsNaNValue(value)) {
+      // NaN never equals anything under SQL equality, so NaN elements can be
+      // dropped entirely.
+      values_.insert(value);
+    }
+  }
+  if (values_.size() >= kMinInListSizeForBloomFilter) {
+    bloom_filter_ = absl::make_unique<BloomFilter>(values_.size());
+    for (const Value& value : values_) {
+      bloom_filter_->Insert(value.HashCode());
+    }
+  }
+  SetArg(kNeedle, absl::make_unique<ExprArg>(std::move(needle)));
+}
+
 // -------------------------------------------------------
 // AggregateFunctionCallExpr
 // -------------------------------------------------------
@@ -1210,17 +1352,18 @@ bool LetExpr::Eval(absl::Span<const TupleData* const> params,
   data_ptrs.insert(data_ptrs.end(), params.begin(), params.end());
 
   for (const ExprArg* arg : assign()) {
-    auto new_data = absl::make_unique<TupleData>(/*num_slots=*/1);
+    TupleData new_data(/*num_slots=*/1);
 
     if (!arg->value_expr()->EvalSimple(data_ptrs, context,
-                                       new_data->mutable_slot(0), status)) {
+                                       new_data.mutable_slot(0), status)) {
       return false;
     }
 
-    data_ptrs.push_back(new_data.get());
     if (!new_datas->PushBack(std::move(new_data), status)) {
       return false;
     }
+    // The pointer stays valid because later pushes do not move entries.
+    data_ptrs.push_back(new_datas->Back());
   }
   return body()->Eval(data_ptrs, context, result, status);
 }
@@ -1355,15 +1498,48 @@ static ::zetasql_base::StatusOr<Value> EvalExpr(
   return zetasql_base::OkStatus();
 }
 
-::zetasql_base::StatusOr<std::vector<Value>>
-DMLValueExpr::GetScannedTupleAsColumnValues(
-    const ResolvedColumnList& column_list, const Tuple& t) const {
-  std::vector<Value> values;
+// Number of rows to process between calls to
+// EvaluationContext::VerifyNotAborted() in the batched DML row loops.
+// Checking once per row is measurably expensive for large statements, and
+// checking every few rows still aborts promptly.
+static const int kDMLRowsBetweenAbortChecks = 64;
+
+::zetasql_base::StatusOr<std::vector<int>> DMLValueExpr::GetSlotsForColumns(
+    const ResolvedColumnList& column_list, const TupleSchema& schema) const {
+  std::vector<int> slots;
+  slots.reserve(column_list.size());
   for (const ResolvedColumn& column : column_list) {
-    ZETASQL_ASSIGN_OR_RETURN(const Value value, GetColumnValue(column, t));
-    values.push_back(value);
+    ZETASQL_ASSIGN_OR_RETURN(
+        const VariableId variable_id,
+        column_to_variable_mapping_->LookupVariableNameForColumn(&column));
+    absl::optional<int> slot = schema.FindIndexForVariable(variable_id);
+    ZETASQL_RET_CHECK(slot.has_value()) << variable_id;
+    slots.push_back(slot.value());
+  }
+  return slots;
+}
+
+::zetasql_base::StatusOr<std::vector<std::vector<Value>>>
+DMLValueExpr::GetScannedTuplesAsColumnValues(
+    const ResolvedColumnList& column_list, const TupleSchema& schema,
+    absl::Span<const std::unique_ptr<TupleData>> tuples,
+    EvaluationContext* context) const {
+  ZETASQL_ASSIGN_OR_RETURN(const std::vector<int> slots,
+                   GetSlotsForColumns(column_list, schema));
+  std::vector<std::vector<Value>> rows;
+  rows.reserve(tuples.size());
+  for (const std::unique_ptr<TupleData>& tuple : tuples) {
+    if (rows.size() % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
+    std::vector<Value> values;
+    values.reserve(slots.size());
+    for (const int slot : slots) {
+      values.push_back(tuple->slot(slot).value());
+    }
+    rows.push_back(std::move(values));
   }
-  return values;
+  return rows;
 }
 
 ::zetasql_base::StatusOr<Value> DMLValueExpr::GetColumnValue(
@@ -1385,10 +1561,11 @@ DMLValueExpr::GetScannedTupleAsColumnValues(
   ZETASQL_ASSIGN_OR_RETURN(const absl::optional<int> primary_key_index,
                    GetPrimaryKeyColumnIndex(context));
   *has_primary_key = primary_key_index.has_value();
+  row_map->reserve(original_rows.size());
   for (int64_t row_number = 0; row_number < original_rows.size(); ++row_number) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    if (row_number % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     const std::vector<Value>& row_values = original_rows[row_number];
 
@@ -1448,30 +1625,31 @@ zetasql_base::StatusOr<absl::optional<int>> DMLValueExpr::GetPrimaryKeyColumnInd
 
 ::zetasql_base::StatusOr<Value> DMLValueExpr::GetDMLOutputValue(
     int64_t num_rows_modified,
-    const std::vector<std::vector<Value>>& dml_output_rows,
+    std::vector<std::vector<Value>> dml_output_rows,
     EvaluationContext* context) const {
-  for (const std::vector<Value>& dml_output_row : dml_output_rows) {
-    for (const Value& value : dml_output_row) {
-      ZETASQL_RET_CHECK(value.is_valid());
-    }
-  }
-
   std::vector<Value> dml_output_values;
-  for (const std::vector<Value>& dml_output_row : dml_output_rows) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+  dml_output_values.reserve(dml_output_rows.size());
+  for (std::vector<Value>& dml_output_row : dml_output_rows) {
+    if (dml_output_values.size() % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     ZETASQL_RET_CHECK_EQ(dml_output_row.size(), column_list_->size());
+    for (const Value& value : dml_output_row) {
+      ZETASQL_RET_CHECK(value.is_valid());
+    }
     if (is_value_table_) {
       ZETASQL_RET_CHECK_EQ(1, dml_output_row.size());
-      dml_output_values.push_back(dml_output_row[0]);
+      dml_output_values.push_back(std::move(dml_output_row[0]));
     } else {
       const Type* element_type = table_array_type_->element_type();
       ZETASQL_RET_CHECK(element_type->IsStruct());
       const StructType* table_row_type = element_type->AsStruct();
+      // The row values come from the table scan (or from update/insert
+      // expressions coerced by the analyzer), so their types are known to
+      // match 'table_row_type'.
       dml_output_values.push_back(
-          Value::Struct(table_row_type, dml_output_row));
+          Value::UnsafeStruct(table_row_type, std::move(dml_output_row)));
     }
   }
 
@@ -1566,24 +1744,32 @@ DMLDeleteValueExpr::Create(
   ZETASQL_RETURN_IF_ERROR(EvalRelationalOp(*relational_op, params, context,
                                    &tuple_schema, &tuple_datas));
 
+  // Resolve the column slots once for the whole batch; the rows that survive
+  // the WHERE clause are copied out through them below.
+  ZETASQL_ASSIGN_OR_RETURN(const std::vector<int> slots,
+                   GetSlotsForColumns(*column_list_, *tuple_schema));
+  dml_output_rows.reserve(tuple_datas.size());
+  int64_t row_number = 0;
   for (const std::unique_ptr<TupleData>& tuple_data : tuple_datas) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
-
-    const Tuple tuple(tuple_schema.get(), tuple_data.get());
-    ZETASQL_ASSIGN_OR_RETURN(const std::vector<Value> tuple_as_values,
-                     GetScannedTupleAsColumnValues(*column_list_, tuple));
+    if (row_number++ % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     // The WHERE clause can reference column values and statement parameters.
     ZETASQL_ASSIGN_OR_RETURN(
         const Value where_value,
-        EvalExpr(*where_expr, ConcatSpans(params, {tuple.data}), context));
+        EvalExpr(*where_expr, ConcatSpans(params, {tuple_data.get()}),
+                 context));
     const bool deleted = (where_value == Bool(true));
     if (deleted) {
       ++num_rows_deleted;
     } else {
-      dml_output_rows.push_back(tuple_as_values);
+      std::vector<Value> tuple_as_values;
+      tuple_as_values.reserve(slots.size());
+      for (const int slot : slots) {
+        tuple_as_values.push_back(tuple_data->slot(slot).value());
+      }
+      dml_output_rows.push_back(std::move(tuple_as_values));
     }
   }
 
@@ -1591,7 +1777,8 @@ DMLDeleteValueExpr::Create(
                                         num_rows_deleted, context));
 
   ZETASQL_RETURN_IF_ERROR(resolved_node_->CheckFieldsAccessed());
-  return GetDMLOutputValue(num_rows_deleted, dml_output_rows, context);
+  return GetDMLOutputValue(num_rows_deleted, std::move(dml_output_rows),
+                           context);
 }
 
 DMLDeleteValueExpr::DMLDeleteValueExpr(
@@ -1701,10 +1888,16 @@ DMLUpdateValueExpr::Create(
   std::vector<std::unique_ptr<TupleData>> tuples;
   ZETASQL_RETURN_IF_ERROR(EvalRelationalOp(*relational_op, params, context,
                                    &tuple_schema, &tuples));
+  // Resolve the column slots once for the whole batch; unmodified rows are
+  // copied out through them below.
+  ZETASQL_ASSIGN_OR_RETURN(const std::vector<int> slots,
+                   GetSlotsForColumns(*column_list_, *tuple_schema));
+  dml_output_rows.reserve(tuples.size());
+  int64_t row_number = 0;
   for (const std::unique_ptr<TupleData>& tuple_data : tuples) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    if (row_number++ % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     const Tuple tuple(tuple_schema.get(), tuple_data.get());
     std::vector<const TupleData*> joined_tuple_datas;
@@ -1712,9 +1905,12 @@ DMLUpdateValueExpr::Create(
                                         from_tuples.get(), where_expr, context,
                                         &joined_tuple_datas));
     if (joined_tuple_datas.empty()) {
-      ZETASQL_ASSIGN_OR_RETURN(const std::vector<Value> dml_output_row,
-                       GetScannedTupleAsColumnValues(*column_list_, tuple));
-      dml_output_rows.push_back(dml_output_row);
+      std::vector<Value> dml_output_row;
+      dml_output_row.reserve(slots.size());
+      for (const int slot : slots) {
+        dml_output_row.push_back(tuple_data->slot(slot).value());
+      }
+      dml_output_rows.push_back(std::move(dml_output_row));
       continue;
     }
 
@@ -1732,7 +1928,7 @@ DMLUpdateValueExpr::Create(
 
     ZETASQL_ASSIGN_OR_RETURN(std::vector<Value> dml_output_row,
                      GetDMLOutputRow(tuple, update_map, context));
-    dml_output_rows.push_back(dml_output_row);
+    dml_output_rows.push_back(std::move(dml_output_row));
   }
 
   // Verify that there are no duplicate primary keys in the modified table.
@@ -1748,7 +1944,8 @@ DMLUpdateValueExpr::Create(
                                         num_rows_modified, context));
 
   ZETASQL_RETURN_IF_ERROR(resolved_node_->CheckFieldsAccessed());
-  return GetDMLOutputValue(num_rows_modified, dml_output_rows, context);
+  return GetDMLOutputValue(num_rows_modified, std::move(dml_output_rows),
+                           context);
 }
 
 ::zetasql_base::StatusOr<Value> DMLUpdateValueExpr::UpdateNode::GetNewValue(
@@ -1779,7 +1976,10 @@ DMLUpdateValueExpr::Create(
                          update_node.GetNewValue(new_fields[field_idx]));
         new_fields[field_idx] = field_value;
       }
-      return Value::Struct(original_value.type()->AsStruct(), new_fields);
+      // Move the fields into the new struct; the unmodified ones still share
+      // storage with 'original_value'.
+      return Value::UnsafeStruct(original_value.type()->AsStruct(),
+                                 std::move(new_fields));
     }
     case TYPE_PROTO:
       return GetNewProtoValue(original_value);
@@ -1814,7 +2014,11 @@ DMLUpdateValueExpr::Create(
                          update_node.GetNewValue(new_elements[offset]));
         new_elements[offset] = element_value;
       }
-      return Value::Array(original_value.type()->AsArray(), new_elements);
+      // Move the elements into the new array; the unmodified ones still share
+      // storage with 'original_value'.
+      return InternalValue::ArrayChecked(original_value.type()->AsArray(),
+                                         InternalValue::kPreservesOrder,
+                                         std::move(new_elements));
     }
     default:
       ZETASQL_RET_CHECK_FAIL()
@@ -2327,7 +2531,9 @@ DMLUpdateValueExpr::DMLUpdateValueExpr(
     }
   }
 
-  return Value::Array(original_value.type()->AsArray(), new_elements);
+  return InternalValue::ArrayChecked(original_value.type()->AsArray(),
+                                     InternalValue::kPreservesOrder,
+                                     std::move(new_elements));
 }
 
 ::zetasql_base::StatusOr<std::vector<Value>> DMLUpdateValueExpr::GetDMLOutputRow(
@@ -2660,7 +2866,7 @@ DMLInsertValueExpr::Create(
 
   ZETASQL_RETURN_IF_ERROR(resolved_node_->CheckFieldsAccessed());
 
-  return GetDMLOutputValue(num_rows_modified, row_map, context);
+  return GetDMLOutputValue(num_rows_modified, &row_map, context);
 }
 
 DMLInsertValueExpr::DMLInsertValueExpr(
@@ -2719,28 +2925,40 @@ DMLInsertValueExpr::DMLInsertValueExpr(
   ZETASQL_RETURN_IF_ERROR(PopulateColumnsToInsert(insert_column_map, params, context,
                                           &columns_to_insert));
 
-  for (const std::vector<Value>& columns_to_insert_for_row :
-       columns_to_insert) {
+  // Resolve each column of the table to the offset of the corresponding
+  // inserted column (or -1 for columns not being inserted) once instead of
+  // doing a hash lookup per value.
+  std::vector<int> insert_column_offsets;
+  insert_column_offsets.reserve(column_list_->size());
+  for (int i = 0; i < column_list_->size(); ++i) {
+    const ResolvedColumn& column = (*column_list_)[i];
+    const InsertColumnOffsets* offsets =
+        zetasql_base::FindOrNull(insert_column_map, column);
+    if (offsets == nullptr) {
+      insert_column_offsets.push_back(-1);
+    } else {
+      ZETASQL_RET_CHECK_EQ(i, offsets->column_offset);
+      insert_column_offsets.push_back(offsets->insert_column_offset);
+    }
+  }
+
+  rows_to_insert->reserve(columns_to_insert.size());
+  for (std::vector<Value>& columns_to_insert_for_row : columns_to_insert) {
     std::vector<Value> row_to_insert;
+    row_to_insert.reserve(column_list_->size());
 
     for (int i = 0; i < column_list_->size(); ++i) {
-      const ResolvedColumn& column = (*column_list_)[i];
-
-      const InsertColumnOffsets* insert_column_offsets =
-          zetasql_base::FindOrNull(insert_column_map, column);
-      if (insert_column_offsets == nullptr) {
+      const int insert_column_offset = insert_column_offsets[i];
+      if (insert_column_offset == -1) {
         // Fill in NULL for any values that are not being inserted.
-        row_to_insert.push_back(Value::Null(column.type()));
+        row_to_insert.push_back(Value::Null((*column_list_)[i].type()));
       } else {
-        ZETASQL_RET_CHECK_EQ(i, insert_column_offsets->column_offset);
-        const int insert_column_offset =
-            insert_column_offsets->insert_column_offset;
         row_to_insert.push_back(
-            columns_to_insert_for_row[insert_column_offset]);
+            std::move(columns_to_insert_for_row[insert_column_offset]));
       }
     }
 
-    rows_to_insert->push_back(row_to_insert);
+    rows_to_insert->push_back(std::move(row_to_insert));
   }
 
   return zetasql_base::OkStatus();
@@ -2761,38 +2979,33 @@ DMLInsertValueExpr::DMLInsertValueExpr(
     ZETASQL_RETURN_IF_ERROR(EvalRelationalOp(*relational_op, params, context,
                                      &tuple_schema, &tuples));
 
-    for (const std::unique_ptr<TupleData>& tuple : tuples) {
-      // It is expensive to call this for every row, but this code is only used
-      // for compliance testing, so it's ok.
-      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
-      ZETASQL_ASSIGN_OR_RETURN(const std::vector<Value> columns_to_insert_for_row,
-                       GetScannedTupleAsColumnValues(
-                           stmt()->query_output_column_list(),
-                           Tuple(tuple_schema.get(), tuple.get())));
-      columns_to_insert->push_back(columns_to_insert_for_row);
-    }
+    ZETASQL_ASSIGN_OR_RETURN(
+        *columns_to_insert,
+        GetScannedTuplesAsColumnValues(stmt()->query_output_column_list(),
+                                       *tuple_schema, tuples, context));
   } else {
+    columns_to_insert->reserve(stmt()->row_list().size());
     for (const std::unique_ptr<const ResolvedInsertRow>& resolved_insert_row :
          stmt()->row_list()) {
-      // It is expensive to call this for every row, but this code is only used
-      // for compliance testing, so it's ok.
-      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+      if (columns_to_insert->size() % kDMLRowsBetweenAbortChecks == 0) {
+        ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+      }
 
       const std::vector<std::unique_ptr<const ResolvedDMLValue>>& dml_values =
           resolved_insert_row->value_list();
       ZETASQL_RET_CHECK_EQ(dml_values.size(), insert_column_map.size());
 
       std::vector<Value> columns_to_insert_for_row;
+      columns_to_insert_for_row.reserve(dml_values.size());
       for (const std::unique_ptr<const ResolvedDMLValue>& dml_value :
            dml_values) {
         ZETASQL_ASSIGN_OR_RETURN(const ValueExpr* value_expr,
                          LookupResolvedExpr(dml_value->value()));
-        ZETASQL_ASSIGN_OR_RETURN(const Value value,
-                         EvalExpr(*value_expr, params, context));
-        columns_to_insert_for_row.push_back(value);
+        ZETASQL_ASSIGN_OR_RETURN(Value value, EvalExpr(*value_expr, params, context));
+        columns_to_insert_for_row.push_back(std::move(value));
       }
 
-      columns_to_insert->push_back(columns_to_insert_for_row);
+      columns_to_insert->push_back(std::move(columns_to_insert_for_row));
     }
   }
   return zetasql_base::OkStatus();
@@ -2809,17 +3022,9 @@ DMLInsertValueExpr::DMLInsertValueExpr(
   ZETASQL_RETURN_IF_ERROR(EvalRelationalOp(*relational_op, params, context,
                                    &tuple_schema, &tuples));
 
-  for (const std::unique_ptr<TupleData>& tuple : tuples) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
-    ZETASQL_ASSIGN_OR_RETURN(
-        const std::vector<Value> column_values,
-        GetScannedTupleAsColumnValues(*column_list_,
-                                      Tuple(tuple_schema.get(), tuple.get())));
-    original_rows->push_back(column_values);
-  }
-
+  ZETASQL_ASSIGN_OR_RETURN(*original_rows,
+                   GetScannedTuplesAsColumnValues(*column_list_, *tuple_schema,
+                                                  tuples, context));
   return zetasql_base::OkStatus();
 }
 
@@ -2831,9 +3036,9 @@ DMLInsertValueExpr::DMLInsertValueExpr(
   const int64_t max_original_row_number = row_map->size() - 1;
   bool found_primary_key_collision = false;
   for (int i = 0; i < rows_to_insert.size(); ++i) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    if (i % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     const std::vector<Value>& row_to_insert = rows_to_insert[i];
 
@@ -2916,20 +3121,21 @@ DMLInsertValueExpr::DMLInsertValueExpr(
 }
 
 ::zetasql_base::StatusOr<Value> DMLInsertValueExpr::GetDMLOutputValue(
-    int64_t num_rows_modified, const PrimaryKeyRowMap& row_map,
+    int64_t num_rows_modified, PrimaryKeyRowMap* row_map,
     EvaluationContext* context) const {
-  std::vector<std::vector<Value>> dml_output_rows(row_map.size());
-  for (const auto& elt : row_map) {
-    // It is expensive to call this for every row, but this code is only used
-    // for compliance testing, so it's ok.
-    ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+  std::vector<std::vector<Value>> dml_output_rows(row_map->size());
+  int64_t num_rows_placed = 0;
+  for (auto& elt : *row_map) {
+    if (num_rows_placed++ % kDMLRowsBetweenAbortChecks == 0) {
+      ZETASQL_RETURN_IF_ERROR(context->VerifyNotAborted());
+    }
 
     const int64_t row_number = elt.second.row_number;
-    dml_output_rows[row_number] = elt.second.values;
+    dml_output_rows[row_number] = std::move(elt.second.values);
   }
 
-  return DMLValueExpr::GetDMLOutputValue(num_rows_modified, dml_output_rows,
-                                         context);
+  return DMLValueExpr::GetDMLOutputValue(num_rows_modified,
+                                         std::move(dml_output_rows), context);
 }
 
 // -------------------------------------------------------
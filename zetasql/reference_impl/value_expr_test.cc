@@ -16,6 +16,7 @@
 
 // Tests for ValueExprs not covered by other tests.
 
+#include <limits>
 #include <memory>
 #include <set>
 #include <string>
@@ -457,6 +458,102 @@ TEST_F(EvalTest, IfExpr) {
   EXPECT_THAT(EvalExpr(*if_op_null, EmptyParams()), IsOkAndHolds(Int64(1)));
 }
 
+TEST_F(EvalTest, AndOrShortCircuit) {
+  // A deciding operand (FALSE for AND, TRUE for OR) stops evaluation, so the
+  // erroring operand after it is never evaluated.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto false_expr, ConstExpr::Create(Bool(false)));
+  std::vector<std::unique_ptr<ValueExpr>> and_args;
+  and_args.push_back(std::move(false_expr));
+  and_args.push_back(DivByZeroErrorExpr());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto and_op,
+      ScalarFunctionCallExpr::Create(
+          CreateFunction(FunctionKind::kAnd, BoolType()), std::move(and_args)));
+  EXPECT_THAT(EvalExpr(*and_op, EmptyParams()), IsOkAndHolds(Bool(false)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr, ConstExpr::Create(Bool(true)));
+  std::vector<std::unique_ptr<ValueExpr>> or_args;
+  or_args.push_back(std::move(true_expr));
+  or_args.push_back(DivByZeroErrorExpr());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto or_op,
+      ScalarFunctionCallExpr::Create(
+          CreateFunction(FunctionKind::kOr, BoolType()), std::move(or_args)));
+  EXPECT_THAT(EvalExpr(*or_op, EmptyParams()), IsOkAndHolds(Bool(true)));
+
+  // A non-deciding operand does not stop evaluation and the error surfaces.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto true_expr2, ConstExpr::Create(Bool(true)));
+  std::vector<std::unique_ptr<ValueExpr>> failing_and_args;
+  failing_and_args.push_back(std::move(true_expr2));
+  failing_and_args.push_back(DivByZeroErrorExpr());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto failing_and_op,
+                       ScalarFunctionCallExpr::Create(
+                           CreateFunction(FunctionKind::kAnd, BoolType()),
+                           std::move(failing_and_args)));
+  EXPECT_THAT(EvalExpr(*failing_and_op, EmptyParams()),
+              StatusIs(zetasql_base::OUT_OF_RANGE, HasSubstr("division by zero")));
+}
+
+TEST_F(EvalTest, InListExpr) {
+  const std::vector<Value> list = {Int64(1), Int64(3), Int64(5), Int64(7),
+                                   Int64(9), Int64(11), Int64(13), Int64(15)};
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto match_needle, ConstExpr::Create(Int64(7)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_match,
+                       InListExpr::Create(std::move(match_needle), list));
+  EXPECT_EQ("InListExpr(ConstExpr(7), 8 values)", in_match->DebugString());
+  EXPECT_THAT(EvalExpr(*in_match, EmptyParams()), IsOkAndHolds(Bool(true)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto miss_needle, ConstExpr::Create(Int64(8)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_miss,
+                       InListExpr::Create(std::move(miss_needle), list));
+  EXPECT_THAT(EvalExpr(*in_miss, EmptyParams()), IsOkAndHolds(Bool(false)));
+
+  // A NULL element turns a non-match into NULL, and a NULL needle is never a
+  // match.
+  std::vector<Value> list_with_null = list;
+  list_with_null.push_back(NullInt64());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto miss_needle2, ConstExpr::Create(Int64(8)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto in_miss_with_null,
+      InListExpr::Create(std::move(miss_needle2), list_with_null));
+  EXPECT_THAT(EvalExpr(*in_miss_with_null, EmptyParams()),
+              IsOkAndHolds(NullBool()));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto null_needle, ConstExpr::Create(NullInt64()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_null_needle,
+                       InListExpr::Create(std::move(null_needle), list));
+  EXPECT_THAT(EvalExpr(*in_null_needle, EmptyParams()),
+              IsOkAndHolds(NullBool()));
+
+  // NaN never equals anything under SQL equality, even another NaN.
+  const Value nan = Double(std::numeric_limits<double>::quiet_NaN());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto nan_needle, ConstExpr::Create(nan));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_nan,
+                       InListExpr::Create(std::move(nan_needle),
+                                          {nan, Double(1.5), Double(2.5)}));
+  EXPECT_THAT(EvalExpr(*in_nan, EmptyParams()), IsOkAndHolds(Bool(false)));
+}
+
+TEST_F(EvalTest, InListExprLargeList) {
+  // Large enough that the hash set gets a Bloom filter in front of it; the
+  // results must be the same as for a small list.
+  std::vector<Value> list;
+  for (int i = 0; i < 2000; ++i) {
+    list.push_back(Int64(3 * i));
+  }
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto match_needle, ConstExpr::Create(Int64(3 * 1234)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_match,
+                       InListExpr::Create(std::move(match_needle), list));
+  EXPECT_THAT(EvalExpr(*in_match, EmptyParams()), IsOkAndHolds(Bool(true)));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto miss_needle, ConstExpr::Create(Int64(3 * 1234 + 1)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto in_miss,
+                       InListExpr::Create(std::move(miss_needle), list));
+  EXPECT_THAT(EvalExpr(*in_miss, EmptyParams()), IsOkAndHolds(Bool(false)));
+}
+
 TEST_F(EvalTest, LetExpr) {
   VariableId a("a"), x("x"), y("y");
 
@@ -0,0 +1,194 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "zetasql/base/logging.h"
+#include "absl/memory/memory.h"
+
+namespace zetasql {
+namespace {
+
+// Pass increment for a query of weight 1. A query's stride is
+// kStrideScale / weight, so a query with twice the weight advances its pass
+// half as fast and is dispatched twice as often.
+constexpr int64_t kStrideScale = int64_t{1} << 20;
+
+// The scheduler and worker index of the calling thread, if it is a worker
+// thread. Used to route tasks scheduled by running tasks to the worker's
+// local deque.
+thread_local WorkStealingScheduler* current_scheduler = nullptr;
+thread_local int current_worker_index = -1;
+
+}  // namespace
+
+WorkStealingScheduler::QueryHandle::~QueryHandle() {
+  scheduler_->WaitForQuery(query_id_);
+  scheduler_->UnregisterQuery(query_id_);
+}
+
+void WorkStealingScheduler::QueryHandle::Schedule(std::function<void()> task) {
+  scheduler_->ScheduleTask(query_id_, std::move(task));
+}
+
+void WorkStealingScheduler::QueryHandle::Wait() {
+  scheduler_->WaitForQuery(query_id_);
+}
+
+WorkStealingScheduler::WorkStealingScheduler(int num_threads)
+    : workers_(num_threads) {
+  CHECK_GE(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  {
+    absl::MutexLock l(&mutex_);
+    CHECK(queries_.empty())
+        << "All QueryHandles must be destroyed before the scheduler";
+    stopped_ = true;
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::unique_ptr<WorkStealingScheduler::QueryHandle>
+WorkStealingScheduler::RegisterQuery(double weight) {
+  CHECK_GT(weight, 0);
+  absl::MutexLock l(&mutex_);
+  const int64_t query_id = next_query_id_++;
+  auto query = absl::make_unique<QueryState>();
+  query->pass = virtual_time_;
+  query->stride =
+      std::max(static_cast<int64_t>(kStrideScale / weight), int64_t{1});
+  CHECK(queries_.emplace(query_id, std::move(query)).second);
+  return absl::WrapUnique(new QueryHandle(this, query_id));
+}
+
+void WorkStealingScheduler::ScheduleTask(int64_t query_id,
+                                         std::function<void()> task) {
+  absl::MutexLock l(&mutex_);
+  auto it = queries_.find(query_id);
+  CHECK(it != queries_.end());
+  ++it->second->num_unfinished_tasks;
+  if (current_scheduler == this) {
+    workers_[current_worker_index].local_deque.push_back(
+        {query_id, std::move(task)});
+  } else {
+    it->second->fair_queue.push_back(std::move(task));
+  }
+}
+
+void WorkStealingScheduler::WaitForQuery(int64_t query_id) {
+  absl::MutexLock l(&mutex_);
+  auto it = queries_.find(query_id);
+  CHECK(it != queries_.end());
+  QueryState* query = it->second.get();
+  mutex_.Await(absl::Condition(
+      +[](QueryState* query) { return query->num_unfinished_tasks == 0; },
+      query));
+}
+
+void WorkStealingScheduler::UnregisterQuery(int64_t query_id) {
+  absl::MutexLock l(&mutex_);
+  CHECK_EQ(queries_.erase(query_id), 1);
+}
+
+void WorkStealingScheduler::WorkerLoop(int worker_index) {
+  current_scheduler = this;
+  current_worker_index = worker_index;
+  while (true) {
+    Task task;
+    {
+      absl::MutexLock l(&mutex_);
+      mutex_.Await(absl::Condition(
+          this, &WorkStealingScheduler::HasWorkOrStoppedLocked));
+      if (!DequeueTaskLocked(worker_index, &task)) {
+        // Another worker took the work that woke us. Exit only once the
+        // scheduler is stopping and fully drained.
+        if (stopped_) return;
+        continue;
+      }
+    }
+    task.fn();
+    absl::MutexLock l(&mutex_);
+    auto it = queries_.find(task.query_id);
+    CHECK(it != queries_.end());
+    --it->second->num_unfinished_tasks;
+  }
+}
+
+bool WorkStealingScheduler::DequeueTaskLocked(int worker_index, Task* task) {
+  // Own local deque first, newest task first, for locality with the task
+  // that spawned it.
+  WorkerState& self = workers_[worker_index];
+  if (!self.local_deque.empty()) {
+    *task = std::move(self.local_deque.back());
+    self.local_deque.pop_back();
+    return true;
+  }
+  // Then the fair queues: dispatch the query with the smallest pass,
+  // breaking ties by registration order.
+  QueryState* best = nullptr;
+  int64_t best_query_id = -1;
+  for (auto& entry : queries_) {
+    QueryState* query = entry.second.get();
+    if (query->fair_queue.empty()) continue;
+    if (best == nullptr || query->pass < best->pass ||
+        (query->pass == best->pass && entry.first < best_query_id)) {
+      best = query;
+      best_query_id = entry.first;
+    }
+  }
+  if (best != nullptr) {
+    task->query_id = best_query_id;
+    task->fn = std::move(best->fair_queue.front());
+    best->fair_queue.pop_front();
+    best->pass += best->stride;
+    virtual_time_ = std::max(virtual_time_, best->pass);
+    return true;
+  }
+  // Finally steal the oldest task from another worker's deque (the one its
+  // owner would run last).
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    WorkerState& victim = workers_[(worker_index + i) % workers_.size()];
+    if (victim.local_deque.empty()) continue;
+    *task = std::move(victim.local_deque.front());
+    victim.local_deque.pop_front();
+    return true;
+  }
+  return false;
+}
+
+bool WorkStealingScheduler::HasWorkOrStoppedLocked() const {
+  if (stopped_) return true;
+  for (const WorkerState& worker : workers_) {
+    if (!worker.local_deque.empty()) return true;
+  }
+  for (const auto& entry : queries_) {
+    if (!entry.second->fair_queue.empty()) return true;
+  }
+  return false;
+}
+
+}  // namespace zetasql
@@ -0,0 +1,163 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// A shared scheduler that multiplexes background tasks from many concurrent
+// evaluations over one fixed pool of worker threads, instead of dedicating a
+// thread to each evaluation. Each evaluation registers a QueryHandle with a
+// fairness weight; a worker with no local work dispatches the pending task of
+// the registered query with the smallest stride-scheduling pass, so over time
+// each query's share of the pool is proportional to its weight and a burst of
+// heavy queries cannot starve light ones. Tasks scheduled from within a
+// running task go to the worker's local deque (run newest-first for
+// locality); other workers steal from the front of that deque when they have
+// nothing else to do, which keeps the pool busy when one query fans out.
+//
+// Tasks are expected to be coarse (an operator advancing its input by a
+// buffer's worth of rows, not per-row work): all queues share one mutex, so
+// the scheduler is off the per-row path by design. See
+// EvaluatorOptions::scheduler for how evaluations opt in.
+
+#ifndef ZETASQL_REFERENCE_IMPL_WORK_STEALING_SCHEDULER_H_
+#define ZETASQL_REFERENCE_IMPL_WORK_STEALING_SCHEDULER_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql {
+
+class WorkStealingScheduler {
+ public:
+  // Represents one registered query. Thread-safe. Must not outlive the
+  // scheduler that created it.
+  class QueryHandle {
+   public:
+    QueryHandle(const QueryHandle&) = delete;
+    QueryHandle& operator=(const QueryHandle&) = delete;
+
+    // Waits for this query's scheduled tasks to finish (as Wait() does), then
+    // unregisters the query from the scheduler.
+    ~QueryHandle();
+
+    // Schedules 'task' to run on some worker thread. If called from within a
+    // task already running on this scheduler, the new task goes to that
+    // worker's local deque; otherwise it joins this query's fair queue.
+    // 'task' must not block indefinitely on work that has not been scheduled
+    // yet (it would pin a worker), but it may block briefly and it may
+    // schedule further tasks.
+    void Schedule(std::function<void()> task);
+
+    // Blocks until every task scheduled on this handle so far (including
+    // tasks those tasks scheduled) has finished running.
+    void Wait();
+
+   private:
+    friend class WorkStealingScheduler;
+
+    QueryHandle(WorkStealingScheduler* scheduler, int64_t query_id)
+        : scheduler_(scheduler), query_id_(query_id) {}
+
+    WorkStealingScheduler* const scheduler_;
+    const int64_t query_id_;
+  };
+
+  // Creates a scheduler with 'num_threads' worker threads (which must be at
+  // least 1). The workers start immediately and idle until tasks arrive.
+  explicit WorkStealingScheduler(int num_threads);
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  // Runs all tasks that have been scheduled (including tasks they schedule)
+  // and joins the worker threads. All QueryHandles must have been destroyed
+  // first.
+  ~WorkStealingScheduler();
+
+  // Registers a query with the given fairness weight (which must be
+  // positive). When workers dispatch from the fair queues, a query with
+  // weight 2 runs tasks at twice the rate of a query with weight 1. A newly
+  // registered query starts at the scheduler's current virtual time, so it
+  // cannot monopolize the pool to "catch up" with long-running queries.
+  std::unique_ptr<QueryHandle> RegisterQuery(double weight = 1.0);
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+ private:
+  struct Task {
+    int64_t query_id;
+    std::function<void()> fn;
+  };
+
+  // State for one registered query, keyed by query id in 'queries_'.
+  struct QueryState {
+    // Pass and stride for stride scheduling: dispatching one fair-queue task
+    // advances 'pass' by 'stride', and workers always dispatch the nonempty
+    // queue with the smallest pass. Strides are integers so that pass
+    // comparisons between queries are exact.
+    int64_t pass;
+    int64_t stride;
+    // Tasks scheduled from outside the scheduler's workers, run in FIFO
+    // order.
+    std::deque<std::function<void()>> fair_queue;
+    // Scheduled tasks (queued or running) not yet finished, including tasks
+    // in worker-local deques. Wait() blocks until this reaches zero.
+    int64_t num_unfinished_tasks = 0;
+  };
+
+  // State for one worker thread. Tasks scheduled by a running task land on
+  // the owning worker's deque; the owner pops from the back and thieves pop
+  // from the front.
+  struct WorkerState {
+    std::deque<Task> local_deque;
+  };
+
+  void WorkerLoop(int worker_index);
+
+  // Pops the next task for 'worker_index' into '*task': its own local deque
+  // first, then the fair queues, then another worker's deque. Returns false
+  // if there is no work anywhere.
+  bool DequeueTaskLocked(int worker_index, Task* task)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool HasWorkOrStoppedLocked() const EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  void ScheduleTask(int64_t query_id, std::function<void()> task);
+  void WaitForQuery(int64_t query_id);
+  void UnregisterQuery(int64_t query_id);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<int64_t, std::unique_ptr<QueryState>> queries_
+      GUARDED_BY(mutex_);
+  int64_t next_query_id_ GUARDED_BY(mutex_) = 0;
+  // The largest pass reached by any query's dispatched fair-queue tasks; new
+  // queries start here so they cannot flood the pool to "catch up".
+  int64_t virtual_time_ GUARDED_BY(mutex_) = 0;
+  std::vector<WorkerState> workers_;  // Deques guarded by 'mutex_'.
+  bool stopped_ GUARDED_BY(mutex_) = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_REFERENCE_IMPL_WORK_STEALING_SCHEDULER_H_
@@ -0,0 +1,175 @@
+//
+// Copyright 2019 ZetaSQL Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/reference_impl/work_stealing_scheduler.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+
+namespace zetasql {
+namespace {
+
+TEST(WorkStealingSchedulerTest, RunsAllScheduledTasks) {
+  WorkStealingScheduler scheduler(/*num_threads=*/4);
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> query =
+      scheduler.RegisterQuery();
+
+  absl::Mutex mutex;
+  int num_runs = 0;
+  for (int i = 0; i < 100; ++i) {
+    query->Schedule([&mutex, &num_runs] {
+      absl::MutexLock l(&mutex);
+      ++num_runs;
+    });
+  }
+  query->Wait();
+  EXPECT_EQ(num_runs, 100);
+
+  // The handle can keep scheduling after a Wait().
+  query->Schedule([&mutex, &num_runs] {
+    absl::MutexLock l(&mutex);
+    ++num_runs;
+  });
+  query->Wait();
+  EXPECT_EQ(num_runs, 101);
+}
+
+TEST(WorkStealingSchedulerTest, WeightsSetDispatchShares) {
+  // One worker makes the dispatch order deterministic: with the worker
+  // blocked, queue 30 tasks for a weight-3 query and 10 for a weight-1
+  // query, then release the worker and watch the interleaving.
+  WorkStealingScheduler scheduler(/*num_threads=*/1);
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> heavy =
+      scheduler.RegisterQuery(/*weight=*/3.0);
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> light =
+      scheduler.RegisterQuery(/*weight=*/1.0);
+
+  absl::Notification gate;
+  absl::Mutex mutex;
+  std::vector<char> order;
+  heavy->Schedule([&gate] { gate.WaitForNotification(); });
+  for (int i = 0; i < 30; ++i) {
+    heavy->Schedule([&mutex, &order] {
+      absl::MutexLock l(&mutex);
+      order.push_back('h');
+    });
+  }
+  for (int i = 0; i < 10; ++i) {
+    light->Schedule([&mutex, &order] {
+      absl::MutexLock l(&mutex);
+      order.push_back('l');
+    });
+  }
+  gate.Notify();
+  heavy->Wait();
+  light->Wait();
+
+  ASSERT_EQ(order.size(), 40);
+  // While both queries still have pending tasks, the heavy query gets three
+  // dispatches for each of the light query's.
+  int num_heavy = 0;
+  int num_light = 0;
+  for (int i = 0; i < 12; ++i) {
+    (order[i] == 'h' ? num_heavy : num_light)++;
+  }
+  EXPECT_EQ(num_heavy, 9);
+  EXPECT_EQ(num_light, 3);
+}
+
+TEST(WorkStealingSchedulerTest, IdleWorkersStealSpawnedSubtasks) {
+  WorkStealingScheduler scheduler(/*num_threads=*/2);
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> query =
+      scheduler.RegisterQuery();
+
+  absl::Mutex mutex;
+  int num_subtask_runs = 0;
+  std::vector<std::thread::id> subtask_threads;
+  absl::Notification all_subtasks_ran;
+  query->Schedule([&] {
+    // Subtasks land on this worker's local deque. This task then keeps its
+    // worker busy until they have all run, so they can only run if the other
+    // worker steals them.
+    for (int i = 0; i < 8; ++i) {
+      query->Schedule([&] {
+        absl::MutexLock l(&mutex);
+        subtask_threads.push_back(std::this_thread::get_id());
+        if (++num_subtask_runs == 8) all_subtasks_ran.Notify();
+      });
+    }
+    all_subtasks_ran.WaitForNotification();
+  });
+  query->Wait();
+
+  EXPECT_EQ(num_subtask_runs, 8);
+  for (const std::thread::id& id : subtask_threads) {
+    EXPECT_NE(id, std::this_thread::get_id());
+  }
+}
+
+TEST(WorkStealingSchedulerTest, NewQueryStartsAtCurrentVirtualTime) {
+  // A query that registers after another has been running for a while must
+  // not get a burst of dispatches to "catch up". With the worker blocked,
+  // run down most of an old query's backlog, register a new query, and check
+  // that the remaining dispatches still alternate.
+  WorkStealingScheduler scheduler(/*num_threads=*/1);
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> old_query =
+      scheduler.RegisterQuery();
+
+  absl::Mutex mutex;
+  std::vector<char> order;
+  for (int i = 0; i < 20; ++i) {
+    old_query->Schedule([&mutex, &order] {
+      absl::MutexLock l(&mutex);
+      order.push_back('o');
+    });
+  }
+  old_query->Wait();
+
+  std::unique_ptr<WorkStealingScheduler::QueryHandle> new_query =
+      scheduler.RegisterQuery();
+  absl::Notification gate;
+  old_query->Schedule([&gate] { gate.WaitForNotification(); });
+  for (int i = 0; i < 5; ++i) {
+    old_query->Schedule([&mutex, &order] {
+      absl::MutexLock l(&mutex);
+      order.push_back('o');
+    });
+    new_query->Schedule([&mutex, &order] {
+      absl::MutexLock l(&mutex);
+      order.push_back('n');
+    });
+  }
+  gate.Notify();
+  old_query->Wait();
+  new_query->Wait();
+
+  ASSERT_EQ(order.size(), 30);
+  // Both queries have weight 1, so after the gate the dispatches alternate;
+  // in every prefix the counts differ by at most one.
+  int balance = 0;
+  for (int i = 20; i < 30; ++i) {
+    balance += order[i] == 'o' ? 1 : -1;
+    EXPECT_LE(abs(balance), 1) << "at position " << i;
+  }
+}
+
+}  // namespace
+}  // namespace zetasql
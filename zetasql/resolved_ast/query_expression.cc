@@ -65,6 +65,26 @@ void QueryExpression::ClearAllClauses() {
 
 std::string QueryExpression::GetSQLQuery() const {
   std::string sql;
+  // Reserve a rough lower bound of the output size up front, so that building
+  // a large query does not repeatedly regrow (and copy) the buffer. Nested
+  // query expressions in set_op_scan_list_ reserve for themselves.
+  size_t size_estimate = 64;
+  for (const auto& with_entry : with_list_) {
+    size_estimate += with_entry.first.size() + with_entry.second.size() + 8;
+  }
+  for (const auto& select_entry : select_list_) {
+    size_estimate += select_entry.first.size() + select_entry.second.size() + 6;
+  }
+  for (const auto& group_by_entry : group_by_list_) {
+    size_estimate += group_by_entry.second.size() + 2;
+  }
+  for (const std::string& order_by_entry : order_by_list_) {
+    size_estimate += order_by_entry.size() + 2;
+  }
+  size_estimate += query_hints_.size() + select_as_modifier_.size() +
+                   from_.size() + where_.size() + group_by_hints_.size() +
+                   order_by_hints_.size() + limit_.size() + offset_.size();
+  sql.reserve(size_estimate);
   if (!with_list_.empty()) {
     absl::StrAppend(&sql, "WITH ", JoinListWithAliases(with_list_, ", "), " ");
   }
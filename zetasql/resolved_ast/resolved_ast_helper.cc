@@ -16,8 +16,13 @@
 
 #include "zetasql/resolved_ast/resolved_ast_helper.h"
 
+#include <utility>
+#include <vector>
+
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_column.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_builder.h"
 
 namespace zetasql {
 
@@ -41,4 +46,41 @@ const ResolvedExpr* FindProjectExpr(
   return nullptr;
 }
 
+zetasql_base::StatusOr<std::unique_ptr<const ResolvedNode>>
+ReplaceResolvedSubtree(std::unique_ptr<const ResolvedNode>* root,
+                       const ResolvedNode* target,
+                       std::unique_ptr<const ResolvedNode> replacement) {
+  ZETASQL_RET_CHECK(root != nullptr && *root != nullptr);
+  ZETASQL_RET_CHECK(target != nullptr);
+  ZETASQL_RET_CHECK(replacement != nullptr);
+
+  // Use non-recursive traversal to avoid stack issues.  The stack holds
+  // pointers to the unique_ptrs owning the nodes still to examine, so we
+  // can swap ownership at the match without touching any other node.
+  std::vector<std::unique_ptr<const ResolvedNode>*> node_stack;
+  node_stack.push_back(root);
+
+  while (!node_stack.empty()) {
+    std::unique_ptr<const ResolvedNode>* node_ptr = node_stack.back();
+    node_stack.pop_back();
+
+    if (node_ptr->get() == target) {
+      std::unique_ptr<const ResolvedNode> original = std::move(*node_ptr);
+      *node_ptr = std::move(replacement);
+      return std::move(original);
+    }
+
+    // Remove constness to enumerate the owning child pointers.  This does
+    // not mutate the node; the same pattern is used for bottom-up rewrites
+    // in Resolver::TryCollapsingExpressionsAsLiterals.
+    const_cast<ResolvedNode*>(node_ptr->get())
+        ->AddMutableChildNodePointers(&node_stack);
+  }
+
+  return ::zetasql_base::NotFoundErrorBuilder()
+         << "ReplaceResolvedSubtree: target node " << target->node_kind_string()
+         << " is not a descendant of the root "
+         << (*root)->node_kind_string();
+}
+
 }  // namespace zetasql
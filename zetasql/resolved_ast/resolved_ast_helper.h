@@ -17,8 +17,12 @@
 #ifndef ZETASQL_RESOLVED_AST_RESOLVED_AST_HELPER_H_
 #define ZETASQL_RESOLVED_AST_RESOLVED_AST_HELPER_H_
 
+#include <memory>
+
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_column.h"
+#include "zetasql/base/status.h"
+#include "zetasql/base/statusor.h"
 
 namespace zetasql {
 
@@ -32,6 +36,26 @@ const ResolvedComputedColumn* FindProjectComputedColumn(
 const ResolvedExpr* FindProjectExpr(
     const ResolvedProjectScan* project, const ResolvedColumn& column);
 
+// Replaces the subtree rooted at <target> inside the tree owned by <*root>
+// with <replacement>, mutating the tree in place, and returns the detached
+// original subtree.  <target> must be <root->get()> or one of its
+// descendants; returns a NOT_FOUND error (leaving the tree unchanged)
+// otherwise.
+//
+// This is for rewriters that own their input tree and want to change a small
+// part of a large resolved AST.  Unlike a rewrite via
+// ResolvedASTDeepCopyVisitor, which copies every node, this only walks
+// pointers until it finds <target> and then swaps one unique_ptr, so all
+// unmodified subtrees are reused as-is.
+//
+// The caller is responsible for the replacement making sense where <target>
+// was (e.g. an expression of the same type), just as when pushing a modified
+// node in a ResolvedASTDeepCopyVisitor subclass.
+zetasql_base::StatusOr<std::unique_ptr<const ResolvedNode>>
+ReplaceResolvedSubtree(std::unique_ptr<const ResolvedNode>* root,
+                       const ResolvedNode* target,
+                       std::unique_ptr<const ResolvedNode> replacement);
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_RESOLVED_AST_RESOLVED_AST_HELPER_H_
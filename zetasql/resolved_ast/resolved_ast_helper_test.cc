@@ -22,6 +22,7 @@
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
+#include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/analyzer/query_resolver_helper.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/proto_util.h"
@@ -38,6 +39,8 @@
 
 namespace zetasql {
 
+using zetasql_base::testing::StatusIs;
+
 static std::unique_ptr<const ResolvedLiteral> MakeInt32Literal(int value) {
   return MakeResolvedLiteral(Value::Int32(value));
 }
@@ -61,4 +64,44 @@ TEST(ResolvedAstHelperTest, FindProjectExpr) {
             FindProjectExpr(project.get(), col2));
 }
 
+TEST(ResolvedAstHelperTest, ReplaceResolvedSubtree) {
+  const ResolvedColumn col1(10, "T", "C", types::Int32Type());
+  const ResolvedColumn col2(11, "T", "C2", types::Int32Type());
+  auto project = MakeResolvedProjectScan(
+      {col1, col2} /* column_list */,
+      MakeNodeVector(MakeResolvedComputedColumn(col1, MakeInt32Literal(5)),
+                     MakeResolvedComputedColumn(col2, MakeInt32Literal(6))),
+      MakeResolvedSingleRowScan());
+  const ResolvedExpr* old_expr = FindProjectExpr(project.get(), col2);
+  const ResolvedScan* unchanged_scan = project->input_scan();
+  std::unique_ptr<const ResolvedNode> root = std::move(project);
+
+  // Replacing a node that is not in the tree fails and leaves it unchanged.
+  auto stray_literal = MakeInt32Literal(-1);
+  EXPECT_THAT(
+      ReplaceResolvedSubtree(&root, stray_literal.get(), MakeInt32Literal(7)),
+      StatusIs(zetasql_base::StatusCode::kNotFound));
+
+  // Replace one literal deep in the tree; everything else is untouched.
+  auto replacement = MakeInt32Literal(7);
+  const ResolvedLiteral* replacement_ptr = replacement.get();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<const ResolvedNode> original,
+      ReplaceResolvedSubtree(&root, old_expr, std::move(replacement)));
+  EXPECT_EQ(old_expr, original.get());
+
+  const ResolvedProjectScan* new_project =
+      root->GetAs<ResolvedProjectScan>();
+  EXPECT_EQ(replacement_ptr, FindProjectExpr(new_project, col2));
+  EXPECT_EQ(unchanged_scan, new_project->input_scan());
+
+  // Replacing the root itself swaps the whole tree.
+  auto row_scan = MakeResolvedSingleRowScan();
+  const ResolvedSingleRowScan* row_scan_ptr = row_scan.get();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      original, ReplaceResolvedSubtree(&root, root.get(), std::move(row_scan)));
+  EXPECT_EQ(new_project, original.get());
+  EXPECT_EQ(row_scan_ptr, root.get());
+}
+
 }  // namespace zetasql
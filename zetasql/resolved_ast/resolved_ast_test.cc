@@ -37,11 +37,13 @@
 #include "zetasql/resolved_ast/validator.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "zetasql/base/arena.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
 
 using testing::ContainerEq;
+using testing::Contains;
 using testing::ElementsAre;
 using testing::HasSubstr;
 using testing::NotNull;
@@ -169,6 +171,67 @@ TEST(ResolvedAST, ReleaseAndSet) {
   EXPECT_EQ(2, project->expr_list_size());
 }
 
+TEST(ResolvedAST, ArenaAllocation) {
+  zetasql_base::UnsafeArena arena(/*block_size=*/4096);
+  {
+    // Nodes made inside the scope live in the arena.  Their destructors still
+    // run on delete; the memory goes away with the arena.
+    ResolvedNodeArenaScope arena_scope(&arena);
+    auto literal = MakeIntLiteral(17);
+    EXPECT_EQ(RESOLVED_LITERAL, literal->node_kind());
+    auto join = MakeJoin();
+    EXPECT_EQ(RESOLVED_JOIN_SCAN, join->node_kind());
+  }
+  EXPECT_FALSE(arena.is_empty());
+
+  // Nodes made outside any scope are plain heap allocations, and deleting
+  // one while a scope is active must still free it from the heap.  Heap
+  // checker verifies no leak.
+  auto heap_literal = MakeIntLiteral(42);
+  {
+    ResolvedNodeArenaScope arena_scope(&arena);
+    heap_literal.reset();
+
+    // Scopes nest; the inner scope's arena wins until it exits.
+    zetasql_base::UnsafeArena inner_arena(/*block_size=*/4096);
+    {
+      ResolvedNodeArenaScope inner_scope(&inner_arena);
+      EXPECT_EQ(RESOLVED_LITERAL, MakeIntLiteral(1)->node_kind());
+    }
+    EXPECT_FALSE(inner_arena.is_empty());
+  }
+}
+
+TEST(ResolvedAST, RestoreWithTypeCacheAndArena) {
+  auto column = MakeResolvedComputedColumn(MakeColumn(), MakeIntLiteral(17));
+  AnyResolvedNodeProto proto;
+  FileDescriptorSetMap file_descriptor_set_map;
+  ZETASQL_ASSERT_OK(column->SaveTo(&file_descriptor_set_map, &proto));
+
+  TypeFactory factory;
+  IdStringPool string_pool;
+  RestoredTypeCache type_cache;
+  ResolvedNode::RestoreParams params(/*pools=*/{}, /*catalog=*/nullptr,
+                                     &factory, &string_pool);
+  params.type_cache = &type_cache;
+
+  zetasql_base::UnsafeArena arena(/*block_size=*/4096);
+  {
+    ResolvedNodeArenaScope arena_scope(&arena);
+    auto restored1 = ResolvedNode::RestoreFrom(proto, params);
+    ZETASQL_ASSERT_OK(restored1.status());
+    auto restored2 = ResolvedNode::RestoreFrom(proto, params);
+    ZETASQL_ASSERT_OK(restored2.status());
+    EXPECT_EQ(restored1.ValueOrDie()->DebugString(),
+              restored2.ValueOrDie()->DebugString());
+    EXPECT_EQ(column->DebugString(), restored1.ValueOrDie()->DebugString());
+    // The column is int32_t and the literal int64_t; both restorations
+    // together resolve just those two distinct types.
+    EXPECT_EQ(2, type_cache.num_types());
+  }
+  EXPECT_FALSE(arena.is_empty());
+}
+
 TEST(ResolvedAST, GetAs) {
   std::unique_ptr<const ResolvedNode> node = MakeJoin();
   EXPECT_EQ(RESOLVED_JOIN_SCAN, node->node_kind());
@@ -738,6 +801,68 @@ TEST(ResolvedAST, GetDescendantsSatisfying) {
   EXPECT_THAT(found_nodes, ElementsAre(p1, s1));
 }
 
+TEST(ResolvedAST, GetPreorderTraversal) {
+  // Build up a tree that looks like
+  //   q1:QueryStatement
+  //     p1:Project
+  //       c1:ComputedColumn
+  //         e1:Literal
+  //       c2:ComputedColumn
+  //         e2:Literal
+  //       s1:TableScan
+  auto s1_uptr = MakeResolvedTableScan({} /* column_list */, t1, nullptr);
+  std::unique_ptr<const ResolvedLiteral> e1_uptr = MakeIntLiteral(6);
+  std::unique_ptr<const ResolvedLiteral> e2_uptr = MakeIntLiteral(7);
+  const ResolvedTableScan* s1 = s1_uptr.get();
+  const ResolvedLiteral* e1 = e1_uptr.get();
+  const ResolvedLiteral* e2 = e2_uptr.get();
+  auto p1_uptr = MakeResolvedProjectScan(
+      {} /* column_list */,
+      MakeNodeVector(
+          MakeResolvedComputedColumn(MakeColumn(), std::move(e1_uptr)),
+          MakeResolvedComputedColumn(MakeColumn(), std::move(e2_uptr))),
+      std::move(s1_uptr));
+  const ResolvedProjectScan* p1 = p1_uptr.get();
+  auto q1_uptr =
+      MakeResolvedQueryStmt({} /* output_column_list */,
+                            false /* is_value_table */, std::move(p1_uptr));
+  const ResolvedQueryStmt* q1 = q1_uptr.get();
+
+  std::vector<ResolvedNode::PreorderNode> traversal;
+
+  // A leaf flattens to just itself.
+  s1->GetPreorderTraversal(&traversal);
+  ASSERT_EQ(traversal.size(), 1);
+  EXPECT_EQ(traversal[0].node, s1);
+  EXPECT_EQ(traversal[0].kind, RESOLVED_TABLE_SCAN);
+  EXPECT_EQ(traversal[0].parent_index, -1);
+
+  q1->GetPreorderTraversal(&traversal);
+  ASSERT_EQ(traversal.size(), 7);
+
+  // Preorder: parents precede children, siblings keep GetChildNodes order.
+  EXPECT_EQ(traversal[0].node, q1);
+  EXPECT_EQ(traversal[1].node, p1);
+  EXPECT_EQ(traversal[2].kind, RESOLVED_COMPUTED_COLUMN);
+  EXPECT_EQ(traversal[3].node, e1);
+  EXPECT_EQ(traversal[4].kind, RESOLVED_COMPUTED_COLUMN);
+  EXPECT_EQ(traversal[5].node, e2);
+  EXPECT_EQ(traversal[6].node, s1);
+
+  // Kinds match the nodes and parent indexes point at the enclosing node.
+  for (int i = 0; i < traversal.size(); ++i) {
+    EXPECT_EQ(traversal[i].kind, traversal[i].node->node_kind());
+    if (i == 0) {
+      EXPECT_EQ(traversal[i].parent_index, -1);
+    } else {
+      EXPECT_LT(traversal[i].parent_index, i);
+      std::vector<const ResolvedNode*> children;
+      traversal[traversal[i].parent_index].node->GetChildNodes(&children);
+      EXPECT_THAT(children, Contains(traversal[i].node));
+    }
+  }
+}
+
 TEST(ResolvedAST, TableSerialization) {
   SimpleColumn column("bar", "baz", types::Int64Type());
   SimpleTable table("bar", {&column}, false, 123);
@@ -62,8 +62,16 @@ zetasql_base::StatusOr<ResolvedColumn> ResolvedColumn::RestoreFrom(
   const IdString table_name = params.string_pool->Make(proto.table_name());
   const IdString column_name = params.string_pool->Make(proto.name());
   const Type* type;
-  ZETASQL_RETURN_IF_ERROR(params.type_factory->DeserializeFromProtoUsingExistingPools(
-      proto.type(), params.pools, &type));
+  if (params.type_cache != nullptr) {
+    // Columns are the most numerous carriers of serialized types, so the
+    // cache matters most here.
+    ZETASQL_ASSIGN_OR_RETURN(type,
+                     params.type_cache->GetOrRestore(
+                         proto.type(), params.pools, params.type_factory));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(params.type_factory->DeserializeFromProtoUsingExistingPools(
+        proto.type(), params.pools, &type));
+  }
   return ResolvedColumn(proto.column_id(), table_name, column_name, type);
 }
 
@@ -16,7 +16,9 @@
 
 #include "zetasql/resolved_ast/resolved_node.h"
 
+#include <cstring>
 #include <queue>
+#include <utility>
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
@@ -34,12 +36,71 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "zetasql/base/arena.h"
 #include "zetasql/base/map_util.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
 
 namespace zetasql {
 
+namespace {
+
+// Arena that ResolvedNode::operator new allocates from, if any.  Set and
+// restored by ResolvedNodeArenaScope.
+thread_local zetasql_base::UnsafeArena* current_resolved_node_arena = nullptr;
+
+// Each node allocation is prefixed by one header word recording whether the
+// block came from an arena or from the heap, so operator delete can tell
+// them apart.  The header is kDefaultAlignment bytes to preserve the
+// alignment of the node that follows it.
+constexpr size_t kAllocHeaderSize = zetasql_base::BaseArena::kDefaultAlignment;
+constexpr uint64_t kHeapAllocTag = 0;
+constexpr uint64_t kArenaAllocTag = 1;
+
+static_assert(kAllocHeaderSize >= sizeof(uint64_t),
+              "Allocation header must fit the tag word");
+
+}  // namespace
+
 // ResolvedNode::RestoreFrom is generated in resolved_node.cc.template.
 
+void* ResolvedNode::operator new(size_t size) {
+  zetasql_base::UnsafeArena* arena = current_resolved_node_arena;
+  char* block;
+  uint64_t tag;
+  if (arena != nullptr) {
+    block = static_cast<char*>(arena->AllocAligned(
+        size + kAllocHeaderSize, zetasql_base::BaseArena::kDefaultAlignment));
+    tag = kArenaAllocTag;
+  } else {
+    block = static_cast<char*>(::operator new(size + kAllocHeaderSize));
+    tag = kHeapAllocTag;
+  }
+  memcpy(block, &tag, sizeof(tag));
+  return block + kAllocHeaderSize;
+}
+
+void ResolvedNode::operator delete(void* ptr) {
+  if (ptr == nullptr) return;
+  char* block = static_cast<char*>(ptr) - kAllocHeaderSize;
+  uint64_t tag;
+  memcpy(&tag, block, sizeof(tag));
+  if (tag == kHeapAllocTag) {
+    ::operator delete(block);
+  }
+  // Arena-allocated nodes are freed in bulk when the arena is destroyed.
+}
+
+ResolvedNodeArenaScope::ResolvedNodeArenaScope(zetasql_base::UnsafeArena* arena)
+    : previous_arena_(current_resolved_node_arena) {
+  DCHECK(arena != nullptr);
+  current_resolved_node_arena = arena;
+}
+
+ResolvedNodeArenaScope::~ResolvedNodeArenaScope() {
+  current_resolved_node_arena = previous_arena_;
+}
+
 zetasql_base::Status ResolvedNode::Accept(ResolvedASTVisitor* visitor) const {
   return ::zetasql_base::OkStatus();
 }
@@ -215,6 +276,36 @@ void ResolvedNode::GetDescendantsSatisfying(
   }
 }
 
+void ResolvedNode::GetPreorderTraversal(
+    std::vector<PreorderNode>* traversal) const {
+  traversal->clear();
+
+  // Use non-recursive traversal to avoid stack issues.  The stack holds
+  // nodes not yet emitted, paired with the traversal index of their parent.
+  // Children are pushed in reverse so they pop in order, giving a preorder
+  // where parents precede children and siblings keep their GetChildNodes
+  // order.
+  std::vector<std::pair<const ResolvedNode*, int>> node_stack;
+  node_stack.emplace_back(this, -1 /* parent_index */);
+
+  std::vector<const ResolvedNode*> tmp_vector;
+
+  while (!node_stack.empty()) {
+    const ResolvedNode* node = node_stack.back().first;
+    const int parent_index = node_stack.back().second;
+    node_stack.pop_back();
+
+    const int node_index = static_cast<int>(traversal->size());
+    traversal->push_back({node, node->node_kind(), parent_index});
+
+    tmp_vector.clear();
+    node->GetChildNodes(&tmp_vector);
+    for (auto it = tmp_vector.rbegin(); it != tmp_vector.rend(); ++it) {
+      node_stack.emplace_back(*it, node_index);
+    }
+  }
+}
+
 // NameFormat nodes format as
 //   <name> := <node>
 // if <node> fits on one line (because it has no child fields to print).
@@ -559,4 +650,24 @@ std::string ResolvedImportStmt::GetImportKindString() const {
   return ImportKindToString(import_kind_);
 }
 
+zetasql_base::StatusOr<const Type*> RestoredTypeCache::GetOrRestore(
+    const TypeProto& proto,
+    const std::vector<const google::protobuf::DescriptorPool*>& pools,
+    TypeFactory* type_factory) {
+  // Serializing the proto for the key is much cheaper than deserializing
+  // the type, which walks the descriptor pools and the factory's internal
+  // structures.
+  std::string key;
+  ZETASQL_RET_CHECK(proto.SerializeToString(&key));
+  const auto it = cache_.find(key);
+  if (it != cache_.end()) {
+    return it->second;
+  }
+  const Type* type;
+  ZETASQL_RETURN_IF_ERROR(type_factory->DeserializeFromProtoUsingExistingPools(
+      proto, pools, &type));
+  cache_.emplace(std::move(key), type);
+  return type;
+}
+
 }  // namespace zetasql
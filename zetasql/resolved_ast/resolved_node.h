@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "google/protobuf/descriptor.h"
+#include "absl/container/flat_hash_map.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/id_string.h"
 #include "zetasql/public/parse_location.h"
@@ -34,9 +35,29 @@
 #include "zetasql/base/status.h"
 #include "zetasql/base/statusor.h"
 
+namespace zetasql_base {
+class UnsafeArena;
+}  // namespace zetasql_base
+
+// Every field accessor on a generated ResolvedNode subclass records the
+// access in a mutable bitmap so that CheckFieldsAccessed() can detect fields
+// an engine never looked at.  Engines that never call CheckFieldsAccessed()
+// in production can define ZETASQL_DISABLE_FIELD_ACCESS_TRACKING (e.g. via
+// --copt) to compile the bookkeeping out, analogous to what NDEBUG does for
+// assertions, removing a store to a shared mutable word from every const
+// field read.  With tracking disabled, CheckFieldsAccessed() always returns
+// OK and ClearFieldsAccessed() is a no-op, so this mode must not be used in
+// builds that run tests relying on them (e.g. compliance tests).
+#ifdef ZETASQL_DISABLE_FIELD_ACCESS_TRACKING
+#define ZETASQL_RECORD_FIELD_ACCESSED(bitmap) (void)0
+#else
+#define ZETASQL_RECORD_FIELD_ACCESSED(bitmap) accessed_ |= (bitmap)
+#endif
+
 namespace zetasql {
 
 class ResolvedASTVisitor;
+class RestoredTypeCache;
 
 // This is the base class for the resolved AST.
 // Subclasses are in the generated file resolved_ast.h.
@@ -61,6 +82,15 @@ class ResolvedNode {
   ResolvedNode& operator=(const ResolvedNode&) = delete;
   virtual ~ResolvedNode() {}
 
+  // ResolvedNodes are normally individual heap allocations.  While a
+  // ResolvedNodeArenaScope (below) is active on the current thread, nodes are
+  // instead carved out of that scope's arena, and operator delete releases
+  // nothing - the memory is reclaimed in bulk when the arena is destroyed.
+  // Each allocation is tagged so that nodes allocated outside a scope are
+  // still freed normally, regardless of where they get deleted.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   // Return this node's kind.
   // e.g. zetasql::RESOLVED_TABLE_SCAN for ResolvedTableScan.
   virtual ResolvedNodeKind node_kind() const = 0;
@@ -141,6 +171,13 @@ class ResolvedNode {
     // This is used to store any IdStrings allocated during
     // deserialization.
     IdStringPool* string_pool = nullptr;
+
+    // Optional cache of types restored during deserialization. The
+    // serialization format repeats the full TypeProto at every use of a
+    // type, and a large tree typically references only a handful of
+    // distinct types, so a cache collapses most type restorations into a
+    // hash lookup. May be null. Not owned.
+    RestoredTypeCache* type_cache = nullptr;
   };
 
   // Deserializes any node type from <proto>.
@@ -167,6 +204,10 @@ class ResolvedNode {
   // ZetaSQL query safely and not missing anything. We assume that if an
   // engine reads a field and sees a value it does not understand, the engine
   // itself will generate an unimplemented error.
+  //
+  // In builds with ZETASQL_DISABLE_FIELD_ACCESS_TRACKING defined (see the
+  // comment above namespace zetasql), no access bookkeeping is done and this
+  // method always returns OK.
   virtual zetasql_base::Status CheckFieldsAccessed() const;
 
   // Reset the field accessed markers in this node and its children.
@@ -216,6 +257,31 @@ class ResolvedNode {
       bool (ResolvedNode::*filter_method)() const,
       std::vector<const ResolvedNode*>* found_nodes) const;
 
+  // An entry in the flat preorder produced by GetPreorderTraversal.
+  // Each node is tagged with its kind and the index of its parent, so
+  // passes that filter by kind or need the enclosing node can work off
+  // the flat array without any virtual calls.
+  struct PreorderNode {
+    const ResolvedNode* node;
+    ResolvedNodeKind kind;
+
+    // Index of this node's parent in the traversal vector, or -1 for the
+    // node the traversal started from.  Parents always precede their
+    // children, so iterating the vector in reverse visits every node
+    // before its ancestors.
+    int parent_index;
+  };
+
+  // Flattens the tree rooted at this node (inclusive) into a preorder
+  // array in <traversal>.  The tree is walked once; passes that would
+  // otherwise traverse it repeatedly (each visit costing two virtual
+  // dispatches and a GetChildNodes vector per node) can instead iterate
+  // the flat array, which is far more cache-friendly for large trees.
+  //
+  // The traversal holds unowned pointers and is invalidated by any
+  // mutation of the tree.
+  void GetPreorderTraversal(std::vector<PreorderNode>* traversal) const;
+
   // Records the parse location range.
   void SetParseLocationRange(const ParseLocationRange& parse_location_range);
 
@@ -318,6 +384,56 @@ class ResolvedNode {
   std::unique_ptr<ParseLocationRange> parse_location_range_;  // May be NULL.
 };
 
+// While a ResolvedNodeArenaScope is alive, ResolvedNodes constructed on the
+// current thread are allocated in <arena> rather than individually on the
+// heap.  Node destructors still run when the nodes are deleted (they own
+// strings, vectors and Values), but their memory is released all at once
+// with the arena, so teardown of a large resolved AST does no per-node
+// heap frees.
+//
+// The arena must outlive every node allocated while the scope is active.
+// The analyzer establishes a scope around resolution when
+// AnalyzerOptions::allocate_resolved_ast_in_arena() is set, using the arena
+// from AnalyzerOptions::arena(), which AnalyzerOutput keeps alive.
+//
+// Scopes may nest; the innermost scope's arena is used.
+class ResolvedNodeArenaScope {
+ public:
+  explicit ResolvedNodeArenaScope(zetasql_base::UnsafeArena* arena);
+  ResolvedNodeArenaScope(const ResolvedNodeArenaScope&) = delete;
+  ResolvedNodeArenaScope& operator=(const ResolvedNodeArenaScope&) = delete;
+  ~ResolvedNodeArenaScope();
+
+ private:
+  zetasql_base::UnsafeArena* const previous_arena_;
+};
+
+// Caches zetasql::Type objects restored from serialized TypeProtos, keyed
+// by the proto's serialized bytes. Pass one through
+// ResolvedNode::RestoreParams::type_cache to deduplicate type restoration
+// within a tree, or across trees restored against the same descriptor pools
+// and TypeFactory; a cache must not be reused with different pools or a
+// different factory. Not thread safe.
+class RestoredTypeCache {
+ public:
+  RestoredTypeCache() {}
+  RestoredTypeCache(const RestoredTypeCache&) = delete;
+  RestoredTypeCache& operator=(const RestoredTypeCache&) = delete;
+
+  // Returns the type for 'proto', deserializing it with 'type_factory'
+  // against 'pools' on first use and serving repeats from the cache.
+  zetasql_base::StatusOr<const Type*> GetOrRestore(
+      const TypeProto& proto,
+      const std::vector<const google::protobuf::DescriptorPool*>& pools,
+      TypeFactory* type_factory);
+
+  // Number of distinct types restored so far.
+  size_t num_types() const { return cache_.size(); }
+
+ private:
+  absl::flat_hash_map<std::string, const Type*> cache_;
+};
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_RESOLVED_AST_RESOLVED_NODE_H_
@@ -212,8 +212,8 @@ void SQLBuilder::PushQueryFragment(
 }
 
 void SQLBuilder::PushQueryFragment(const ResolvedNode* node,
-                                   const std::string& text) {
-  PushQueryFragment(absl::make_unique<QueryFragment>(node, text));
+                                   std::string text) {
+  PushQueryFragment(absl::make_unique<QueryFragment>(node, std::move(text)));
 }
 
 void SQLBuilder::PushQueryFragment(const ResolvedNode* node,
@@ -375,7 +375,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedExpressionColumn(
 zetasql_base::Status SQLBuilder::VisitResolvedLiteral(const ResolvedLiteral* node) {
   ZETASQL_ASSIGN_OR_RETURN(const std::string result, GetSQL(node->value(),
                                                options_.product_mode));
-  PushQueryFragment(node, result);
+  PushQueryFragment(node, std::move(result));
   return ::zetasql_base::OkStatus();
 }
 
@@ -602,7 +602,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedWindowPartitioning(
   }
   absl::StrAppend(&sql, " BY ", absl::StrJoin(partition_by_list_sql, ", "));
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -622,7 +622,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedWindowOrdering(
   }
   absl::StrAppend(&sql, " BY ", absl::StrJoin(order_by_list_sql, ", "));
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -650,7 +650,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedWindowFrame(
                          : absl::StrCat(frame_unit_sql, " BETWEEN ",
                                         start_expr_sql, " AND ", end_expr_sql);
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -699,7 +699,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedWindowFrameExpr(
     }
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -742,17 +742,14 @@ void AppendFieldOrParenthesizedExtensionName(
 static bool IsAmbiguousFieldExtraction(
     const google::protobuf::FieldDescriptor& field_descriptor,
     const ResolvedExpr* resolved_parent, bool get_has_bit) {
-  const google::protobuf::Descriptor* message_descriptor =
-      resolved_parent->type()->AsProto()->descriptor();
+  const ProtoType* message_type = resolved_parent->type()->AsProto();
   if (get_has_bit) {
-    return ProtoType::FindFieldByNameIgnoreCase(
-               message_descriptor,
+    return message_type->FindFieldByNameIgnoreCase(
                absl::StrCat("has_", field_descriptor.name())) != nullptr;
   } else {
     return absl::StartsWithIgnoreCase(field_descriptor.name(), "has_") &&
-           ProtoType::FindFieldByNameIgnoreCase(
-               message_descriptor, field_descriptor.name().substr(4)) !=
-               nullptr;
+           message_type->FindFieldByNameIgnoreCase(
+               field_descriptor.name().substr(4)) != nullptr;
   }
 }
 
@@ -841,7 +838,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedGetProtoField(
     absl::StrAppend(&text, ")");
   }
 
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -892,7 +889,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedReplaceField(
   }
   absl::StrAppend(&text, replace_field_item_sql, ")");
 
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return zetasql_base::OkStatus();
 }
 
@@ -966,7 +963,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedSubqueryExpr(
     }
   }
 
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   previous_pending_aggregate_columns.swap(pending_columns_);
   return ::zetasql_base::OkStatus();
 }
@@ -1112,7 +1109,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedOption(const ResolvedOption* node)
     // std::string literals.
     absl::StrAppend(&text, "(", result->GetSQL(), ")");
   }
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -1149,7 +1146,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedParameter(const ResolvedParameter*
       param_str =
           AddExplicitCast(param_str, node->type(), options_.product_mode);
     }
-    PushQueryFragment(node, param_str);
+    PushQueryFragment(node, std::move(param_str));
   }
   return ::zetasql_base::OkStatus();
 }
@@ -1169,7 +1166,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedMakeProto(const ResolvedMakeProto*
   }
   absl::StrAppend(&text, ")");
 
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -1186,7 +1183,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedMakeProtoField(
   absl::StrAppend(&text, " AS ");
   AppendFieldOrParenthesizedExtensionName(node->field_descriptor(), &text);
 
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -1209,7 +1206,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedMakeStruct(
     absl::StrAppend(&text, result->GetSQL());
   }
   absl::StrAppend(&text, ")");
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -1236,7 +1233,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedGetStructField(
   const std::string& field_name =
       node->expr()->type()->AsStruct()->field(node->field_idx()).name;
   absl::StrAppend(&text, ToIdentifierLiteral(field_name));
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -1978,7 +1975,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedOrderByItem(
                         ? " NULLS FIRST"
                         : " NULLS LAST");
   }
-  PushQueryFragment(node, text);
+  PushQueryFragment(node, std::move(text));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2342,7 +2339,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedQueryStmt(const ResolvedQueryStmt*
   }
   absl::StrAppend(&sql, query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2359,7 +2356,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedExplainStmt(
                    ProcessNode(node->statement()));
   absl::StrAppend(&sql, "EXPLAIN ", result->GetSQL());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2424,7 +2421,7 @@ zetasql_base::Status SQLBuilder::GetCreateViewStatement(
   }
   absl::StrAppend(&sql, "AS ", query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2524,7 +2521,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateDatabaseStmt(
                      GetHintListString(node->option_list()));
     absl::StrAppend(&sql, " OPTIONS(", options_string, ")");
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2683,7 +2680,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateTableStmt(
   ZETASQL_ASSIGN_OR_RETURN(std::string sql,
                    ProcessCreateTableStmtBase(
                        node, /* process_column_definitions = */ true));
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2728,7 +2725,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateTableAsSelectStmt(
   }
   absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2805,7 +2802,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateModelStmt(
   // Append SELECT statement.
   absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2912,7 +2909,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateIndexStmt(
     absl::StrAppend(&sql, "OPTIONS(", options_string, ") ");
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2968,7 +2965,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateMaterializedViewStmt(
   }
   absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -2981,7 +2978,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateExternalTableStmt(
                    GetHintListString(node->option_list()));
   absl::StrAppend(&sql, "OPTIONS(", options_string, ") ");
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3020,7 +3017,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateConstantStmt(
                    ProcessNode(node->expr()));
   absl::StrAppend(&sql, " = ", expr_fragment->GetSQL());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3070,7 +3067,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateFunctionStmt(
     absl::StrAppend(&sql, " OPTIONS(", options_string, ") ");
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3121,7 +3118,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateTableFunctionStmt(
   // Dummy access on is_value_table field so as to pass the final
   // CheckFieldsAccessed() on a statement level before building the sql.
   node->is_value_table();
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3142,7 +3139,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateProcedureStmt(
 
   absl::StrAppend(&sql, node->procedure_body());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3196,7 +3193,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedExportDataStmt(
   }
   absl::StrAppend(&sql, "AS ", query_expression->GetSQLQuery());
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3214,7 +3211,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCallStmt(const ResolvedCallStmt* n
     argument_list.push_back(result->GetSQL());
   }
   absl::StrAppend(&sql, "(", absl::StrJoin(argument_list, ", "), ")");
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3230,7 +3227,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDefineTableStmt(
   ZETASQL_ASSIGN_OR_RETURN(const std::string result, GetHintListString(node->option_list()));
   absl::StrAppend(&sql, "(", result, ")");
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3243,7 +3240,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDescribeStmt(
     absl::StrAppend(&sql, " FROM ",
                     IdentifierPathToString(node->from_name_path()));
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3260,7 +3257,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedShowStmt(
     ZETASQL_ASSIGN_OR_RETURN(const std::string result, GetSQL(value, options_.product_mode));
     absl::StrAppend(&sql, " LIKE ", result);
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3289,7 +3286,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedBeginStmt(
   if (!modes.empty()) {
     absl::StrAppend(&sql, " ", absl::StrJoin(modes, ", "));
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3317,7 +3314,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedSetTransactionStmt(
   if (!modes.empty()) {
     absl::StrAppend(&sql, " ", absl::StrJoin(modes, ", "));
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3339,7 +3336,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedStartBatchStmt(
   if (!node->batch_type().empty()) {
     absl::StrAppend(&sql, " ", node->batch_type());
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3364,7 +3361,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedAssertStmt(
   if (!node->description().empty()) {
     absl::StrAppend(&sql, " AS ", ToStringLiteral(node->description()));
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3430,7 +3427,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDeleteStmt(
     absl::StrAppend(&sql, " ", assert_rows_modified->GetSQL());
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3440,7 +3437,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDropStmt(
   absl::StrAppend(&sql, "DROP ", ToIdentifierLiteral(node->object_type()),
                   node->is_if_exists() ? " IF EXISTS " : " ",
                   IdentifierPathToString(node->name_path()));
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3454,7 +3451,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDropFunctionStmt(
     absl::StrAppend(&sql, node->signature()->signature().GetSQLDeclaration(
                               {} /* arg_name_list */, options_.product_mode));
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3464,7 +3461,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDropMaterializedViewStmt(
   absl::StrAppend(&sql, "DROP MATERIALIZED VIEW",
                   node->is_if_exists() ? " IF EXISTS " : " ",
                   IdentifierPathToString(node->name_path()));
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3481,7 +3478,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedDropRowAccessPolicyStmt(
   }
   absl::StrAppend(&sql, " ON ",
                   IdentifierPathToString(node->target_name_path()));
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3504,7 +3501,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedTruncateStmt(
                      ProcessNode(node->where_expr()));
     absl::StrAppend(&sql, " WHERE ", where->GetSQL());
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3629,7 +3626,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedUpdateItem(
     absl::StrAppend(&sql, absl::StrJoin(nested_statements_sql, ", "));
 
     nested_dml_targets_.pop_back();
-    PushQueryFragment(node, sql);
+    PushQueryFragment(node, std::move(sql));
   }
 
   update_item_targets_and_offsets_.back().pop_back();
@@ -3720,7 +3717,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedUpdateStmt(
     absl::StrAppend(&sql, " ", assert_rows_modified->GetSQL());
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3816,7 +3813,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedInsertStmt(
     absl::StrAppend(&sql, " ", assert_rows_modified->GetSQL());
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3851,7 +3848,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedMergeStmt(const ResolvedMergeStmt*
                      ProcessNode(when_clause.get()));
     absl::StrAppend(&sql, " ", when_clause_sql->GetSQL());
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3901,7 +3898,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedMergeWhen(const ResolvedMergeWhen*
       absl::StrAppend(&sql, "DELETE");
       break;
   }
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3919,7 +3916,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedAlterTableSetOptionsStmt(
   ZETASQL_ASSIGN_OR_RETURN(const std::string options_string,
                    GetHintListString(node->option_list()));
   absl::StrAppend(&sql, "SET OPTIONS(", options_string, ") ");
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -3931,7 +3928,7 @@ zetasql_base::Status SQLBuilder::GetResolvedAlterObjectStmtSQL(
   absl::StrAppend(
       &sql, object_kind, " ", node->is_if_exists() ? "IF EXISTS " : "",
       IdentifierPathToString(node->name_path()), " ", actions_string);
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4078,7 +4075,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedAlterRowAccessPolicyStmt(
   ZETASQL_ASSIGN_OR_RETURN(const std::string actions_string,
                    GetAlterActionSQL(node->alter_action_list()));
   absl::StrAppend(&sql, " ", actions_string);
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4095,7 +4092,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedPrivilege(const ResolvedPrivilege*
                     absl::StrJoin(node->unit_list(), ", ", formatter), ")");
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4126,7 +4123,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedAggregateHavingModifier(
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<QueryFragment> result,
                    ProcessNode(node->having_expr()));
   absl::StrAppend(&sql, result->GetSQL());
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4144,7 +4141,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedGrantStmt(
   ZETASQL_RET_CHECK(!grantee_sql.empty());
   absl::StrAppend(&sql, grantee_sql);
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4162,7 +4159,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedRevokeStmt(
   ZETASQL_RET_CHECK(!grantee_sql.empty());
   absl::StrAppend(&sql, grantee_sql);
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4172,16 +4169,16 @@ zetasql_base::Status SQLBuilder::VisitResolvedRenameStmt(
   absl::StrAppend(&sql, "RENAME ", ToIdentifierLiteral(node->object_type()),
                   " ", IdentifierPathToString(node->old_name_path()), " TO ",
                   IdentifierPathToString(node->new_name_path()));
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
-std::string SQLBuilder::sql() {
+const std::string& SQLBuilder::sql() {
   if (sql_.empty()) {
     if (query_fragments_.empty()) {
       // No sql to build here since no ResolvedAST was visited before calling
-      // sql().
-      return "";
+      // sql(). 'sql_' is empty, which is the right result.
+      return sql_;
     }
 
     std::unique_ptr<QueryFragment> query_fragment = PopQueryFragment();
@@ -4193,6 +4190,11 @@ std::string SQLBuilder::sql() {
   return sql_;
 }
 
+std::string SQLBuilder::release_sql() {
+  sql();  // Builds sql_ from the last query fragment if not built yet.
+  return std::move(sql_);
+}
+
 zetasql_base::Status SQLBuilder::VisitResolvedCreateRowAccessPolicyStmt(
     const ResolvedCreateRowAccessPolicyStmt* node) {
   std::string sql = "CREATE ";
@@ -4224,7 +4226,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedCreateRowAccessPolicyStmt(
   // but we use the std::string form directly because it's simpler.
   absl::StrAppend(&sql, " FILTER USING (", node->predicate_str(), ")");
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4267,7 +4269,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedImportStmt(
     absl::StrAppend(&sql, "OPTIONS(", result, ") ");
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
@@ -4281,7 +4283,7 @@ zetasql_base::Status SQLBuilder::VisitResolvedModuleStmt(
     absl::StrAppend(&sql, "OPTIONS(", result, ") ");
   }
 
-  PushQueryFragment(node, sql);
+  PushQueryFragment(node, std::move(sql));
   return ::zetasql_base::OkStatus();
 }
 
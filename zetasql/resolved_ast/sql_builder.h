@@ -111,7 +111,12 @@ class SQLBuilder : public ResolvedASTVisitor {
   zetasql_base::Status Process(const ResolvedNode& ast);
 
   // Returns the sql std::string for the last visited ResolvedAST.
-  std::string sql();
+  const std::string& sql();
+
+  // Like sql(), but transfers the built std::string out of the builder
+  // without copying it. The builder's stored sql is left empty, so this
+  // should be the last call for the visited ResolvedAST.
+  std::string release_sql();
 
   // Visit methods for types of ResolvedStatement.
   zetasql_base::Status VisitResolvedQueryStmt(const ResolvedQueryStmt* node) override;
@@ -335,7 +340,7 @@ class SQLBuilder : public ResolvedASTVisitor {
 
   // Helper functions which creates QueryFragment from the passed params and
   // push it on query_fragments_.
-  void PushQueryFragment(const ResolvedNode* node, const std::string& text);
+  void PushQueryFragment(const ResolvedNode* node, std::string text);
   void PushQueryFragment(const ResolvedNode* node,
                          QueryExpression* query_expression);
 
@@ -16,7 +16,9 @@
 
 #include "zetasql/scripting/parsed_script.h"
 
+#include <memory>
 #include <stack>
+#include <utility>
 
 #include "zetasql/common/errors.h"
 #include "zetasql/parser/ast_node_kind.h"
@@ -203,17 +205,36 @@ class ValidateVariableDeclarationsVisitor
   const ParsedScript* parsed_script_;
 };
 
-// Visitor which records a mapping of each statement's index as a child of
-// its parent.  This is used by the script executor implementation to locate
-// the "next" statement after each statement finishes running.
-class PopulateMapStatementIndexVisitor : public NonRecursiveParseTreeVisitor {
+// Visitor which builds, in a single pass over the parse tree, the maps used
+// by the script executor to advance through the script:
+// - A mapping of each statement's index as a child of its parent, used to
+//   locate the "next" statement after each statement finishes running.
+// - A mapping assocating each BREAK, CONTINUE, LEAVE, or ITERATE statement
+//   with its innermost loop, used to determine the target location of these
+//   statements, as well as any variable declaration blocks that must be
+//   exited when the statement executes.
+// - A mapping of each statement's starting byte offset to the statement, used
+//   to locate a statement from a position without re-walking the tree.
+//
+// A single pass keeps the cost of constructing a ParsedScript low for large
+// scripts, where each additional traversal is significant.
+class PopulateStatementMapsVisitor : public NonRecursiveParseTreeVisitor {
  public:
-  // Caller retains ownership of map_statement_index.
-  explicit PopulateMapStatementIndexVisitor(
-      ParsedScript::StatementIndexMap* map_statement_index)
-      : map_statement_index_(map_statement_index) {}
+  // Caller retains ownership of all three maps.
+  PopulateStatementMapsVisitor(
+      ParsedScript::StatementIndexMap* map_statement_index,
+      ParsedScript::BreakContinueMap* break_continue_map,
+      ParsedScript::StatementStartMap* statement_start_map)
+      : map_statement_index_(map_statement_index),
+        break_continue_map_(break_continue_map),
+        statement_start_map_(statement_start_map) {}
+
+  const zetasql_base::Status& status() const { return status_; }
 
   VisitResult defaultVisit(const ASTNode* node) override {
+    if (node->IsStatement()) {
+      RecordStatementStart(node->GetAs<ASTStatement>());
+    }
     return VisitResult::VisitChildren(node);
   }
   VisitResult visitASTStatementList(const ASTStatementList* node) override {
@@ -223,37 +244,29 @@ class PopulateMapStatementIndexVisitor : public NonRecursiveParseTreeVisitor {
     }
     return VisitResult::VisitChildren(node);
   }
-
- private:
-  ParsedScript::StatementIndexMap* map_statement_index_;
-};
-
-// Visitor which builds a mapping, assocating each BREAK, CONTINUE, LEAVE, or
-// ITERATE statement with its innermost loop.  Used to determine the target
-// location of these statements, as well as any variable declaration blocks
-// that must be exited when the statement executes.
-class PopulateBreakContinueMapVisitor : public NonRecursiveParseTreeVisitor {
- public:
-  explicit PopulateBreakContinueMapVisitor(
-      ParsedScript::BreakContinueMap* break_continue_map)
-      : break_continue_map_(break_continue_map) {}
-
-  const zetasql_base::Status& status() const { return status_; }
-
-  VisitResult defaultVisit(const ASTNode* node) override {
-    return VisitResult::VisitChildren(node);
-  }
   VisitResult visitASTBreakStatement(const ASTBreakStatement* node) override {
+    RecordStatementStart(node);
     (*break_continue_map_)[node] = CreateBreakContinueContext(node);
     return VisitResult::Empty();
   }
   VisitResult visitASTContinueStatement(
       const ASTContinueStatement* node) override {
+    RecordStatementStart(node);
     (*break_continue_map_)[node] = CreateBreakContinueContext(node);
     return VisitResult::Empty();
   }
 
  private:
+  // Records <statement> as the statement starting at its start byte offset.
+  // The traversal visits parents before children, so if a nested statement
+  // were ever to share a start location with its parent, the outermost
+  // statement wins.
+  void RecordStatementStart(const ASTStatement* statement) {
+    zetasql_base::InsertIfNotPresent(
+        statement_start_map_,
+        statement->GetParseLocationRange().start().GetByteOffset(), statement);
+  }
+
   BreakContinueContext CreateBreakContinueContext(
       const ASTBreakContinueStatement* stmt) {
     const ASTLoopStatement* enclosing_loop = nullptr;
@@ -276,62 +289,22 @@ class PopulateBreakContinueMapVisitor : public NonRecursiveParseTreeVisitor {
     return BreakContinueContext(enclosing_loop, std::move(blocks_to_exit));
   }
 
+  ParsedScript::StatementIndexMap* map_statement_index_;
   ParsedScript::BreakContinueMap* break_continue_map_;
+  ParsedScript::StatementStartMap* statement_start_map_;
   zetasql_base::Status status_;
 };
-
-// Visitor to find the statement within a script that matches a given position.
-class FindStatementFromPositionVisitor : public NonRecursiveParseTreeVisitor {
- public:
-  explicit FindStatementFromPositionVisitor(const ParseLocationPoint& location)
-      : location_(location) {}
-
-  const ASTStatement* match() const { return match_; }
-
-  VisitResult defaultVisit(const ASTNode* node) override {
-    if (match_ != nullptr) {
-      return VisitResult::Empty();
-    }
-    if (node->IsStatement()) {
-      const ParseLocationRange& stmt_range = node->GetParseLocationRange();
-      if (stmt_range.start() == location_) {
-        match_ = node->GetAs<ASTStatement>();
-        return VisitResult::Empty();
-      }
-      return VisitResult::VisitChildren(node);
-    }
-    return VisitResult::Empty();
-  }
-
-  VisitResult visitASTExceptionHandlerList(
-      const ASTExceptionHandlerList* node) override {
-    return VisitResult::VisitChildren(node);
-  }
-
-  VisitResult visitASTExceptionHandler(
-      const ASTExceptionHandler* node) override {
-    return VisitResult::VisitChildren(node);
-  }
-
-  VisitResult visitASTStatementList(const ASTStatementList* node) override {
-    return VisitResult::VisitChildren(node);
-  }
-
-  VisitResult visitASTScript(const ASTScript* node) override {
-    return VisitResult::VisitChildren(node);
-  }
-
- private:
-  const ParseLocationPoint location_;
-  const ASTStatement* match_ = nullptr;
-};
 }  // namespace
 
 const ASTStatement* ParsedScript::FindStatementFromPosition(
     const ParseLocationPoint& start_pos) const {
-  FindStatementFromPositionVisitor visitor(start_pos);
-  script()->TraverseNonRecursive(&visitor);
-  return visitor.match();
+  const ASTStatement* const* statement =
+      zetasql_base::FindOrNull(statement_start_map_, start_pos.GetByteOffset());
+  if (statement == nullptr ||
+      (*statement)->GetParseLocationRange().start() != start_pos) {
+    return nullptr;
+  }
+  return *statement;
 }
 
 zetasql_base::StatusOr<ParsedScript::VariableTypeMap>
@@ -371,6 +344,22 @@ ParsedScript::GetVariablesInScopeAtStatement(
   return variables;
 }
 
+std::shared_ptr<const void> ParsedScript::GetSegmentAnalysis(
+    const ScriptSegment& segment) const {
+  const std::shared_ptr<const void>* analysis = zetasql_base::FindOrNull(
+      segment_analysis_map_,
+      std::make_pair(segment.range().start().GetByteOffset(),
+                     segment.range().end().GetByteOffset()));
+  return analysis != nullptr ? *analysis : nullptr;
+}
+
+void ParsedScript::SetSegmentAnalysis(const ScriptSegment& segment,
+                                      std::shared_ptr<const void> analysis) {
+  segment_analysis_map_[std::make_pair(
+      segment.range().start().GetByteOffset(),
+      segment.range().end().GetByteOffset())] = std::move(analysis);
+}
+
 zetasql_base::Status ParsedScript::GatherInformationAndRunChecksInternal() {
   // Check the maximum-depth constraint first, to ensure that other checks
   // do not cause a stack overflow in the case of a deeply nested script.
@@ -382,21 +371,17 @@ zetasql_base::Status ParsedScript::GatherInformationAndRunChecksInternal() {
   script()->TraverseNonRecursive(&var_decl_visitor);
   ZETASQL_RETURN_IF_ERROR(var_decl_visitor.status());
 
-  // Walk the parse tree, constructing a StatementIndexMap, associating each
-  // statement in the script with its index in the child list of the statement's
-  // parent.  This is used to transfer control when advancing through the
-  // script.
-  PopulateMapStatementIndexVisitor map_statement_index_visitor(
-      &statement_index_map_);
-  script()->TraverseNonRecursive(&map_statement_index_visitor);
-
-  // Walk the parse tree, building up a map, associating each BREAK, CONTINUE,
-  // LEAVE, or ITERATE statement with its innermost loop and set of blocks that
-  // must exit in order to continue or exit the loop.
-  PopulateBreakContinueMapVisitor break_continue_map_visitor(
-      &break_continue_map_);
-  script()->TraverseNonRecursive(&break_continue_map_visitor);
-  ZETASQL_RETURN_IF_ERROR(break_continue_map_visitor.status());
+  // Walk the parse tree once, constructing the maps used to transfer control
+  // when advancing through the script: the StatementIndexMap, associating each
+  // statement in the script with its index in the child list of the
+  // statement's parent; the BreakContinueMap, associating each BREAK,
+  // CONTINUE, LEAVE, or ITERATE statement with its innermost loop and set of
+  // blocks that must exit in order to continue or exit the loop; and the
+  // StatementStartMap, associating each statement with its start location.
+  PopulateStatementMapsVisitor statement_maps_visitor(
+      &statement_index_map_, &break_continue_map_, &statement_start_map_);
+  script()->TraverseNonRecursive(&statement_maps_visitor);
+  ZETASQL_RETURN_IF_ERROR(statement_maps_visitor.status());
 
   return zetasql_base::OkStatus();
 }
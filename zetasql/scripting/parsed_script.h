@@ -17,11 +17,15 @@
 #ifndef ZETASQL_SCRIPTING_PARSED_SCRIPT_H_
 #define ZETASQL_SCRIPTING_PARSED_SCRIPT_H_
 
+#include <memory>
+#include <utility>
+
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/public/type.h"
 #include "zetasql/scripting/break_continue_context.h"
+#include "zetasql/scripting/script_segment.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/flags/declare.h"
 #include "zetasql/base/status.h"
@@ -44,6 +48,11 @@ class ParsedScript {
   using BreakContinueMap =
       absl::flat_hash_map<const ASTStatement*, BreakContinueContext>;
 
+  // Mapping of each statement's starting byte offset within the script to the
+  // statement itself.  Used to locate a statement from a position without
+  // traversing the parse tree.
+  using StatementStartMap = absl::flat_hash_map<int, const ASTStatement*>;
+
   // Mapping of variable name to ASTType.
   using VariableTypeMap =
       absl::flat_hash_map<IdString, const ASTType*, IdStringCaseHash,
@@ -112,6 +121,25 @@ class ParsedScript {
   zetasql_base::StatusOr<VariableTypeMap> GetVariablesInScopeAtStatement(
       const ASTStatement* next_statement) const;
 
+  // Engines embedding the scripting library typically analyze the segment for
+  // each statement or expression as control flow reaches it.  Inside of a
+  // loop, the same segment is reached on every iteration with identical text,
+  // so the engine's analysis result can be reused rather than recomputed.
+  // The following methods memoize an engine-defined analysis artifact for a
+  // segment of this script, keyed by the segment's range; the stored handle
+  // is opaque to ParsedScript.
+  //
+  // Returns the artifact previously memoized for <segment>, or nullptr if
+  // no artifact has been memoized for its range.
+  std::shared_ptr<const void> GetSegmentAnalysis(
+      const ScriptSegment& segment) const;
+
+  // Memoizes <analysis> as the artifact for <segment>, replacing any
+  // previously-memoized artifact for the same range.  <segment> must be a
+  // segment of this script.
+  void SetSegmentAnalysis(const ScriptSegment& segment,
+                          std::shared_ptr<const void> analysis);
+
  private:
   static zetasql_base::StatusOr<std::unique_ptr<ParsedScript>> CreateInternal(
       absl::string_view script_string, const ParserOptions& parser_options,
@@ -160,8 +188,21 @@ class ParsedScript {
   // <parser_output_> owns the lifetime of all objects in the map.
   BreakContinueMap break_continue_map_;
 
+  // Map associating the starting byte offset of each statement in the script
+  // with the statement itself, so that FindStatementFromPosition() does not
+  // need to traverse the parse tree on each call.
+  //
+  // <parser_output_> owns the lifetime of all ASTStatement objects in the map.
+  StatementStartMap statement_start_map_;
+
   // Routine arguments existing from the beginning the script.
   ArgumentTypeMap routine_arguments_;
+
+  // Map associating the byte range of a segment of this script with the
+  // engine-defined analysis artifact memoized for it.  See
+  // GetSegmentAnalysis().
+  absl::flat_hash_map<std::pair<int, int>, std::shared_ptr<const void>>
+      segment_analysis_map_;
 };
 
 }  // namespace zetasql
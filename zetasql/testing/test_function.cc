@@ -16,13 +16,17 @@
 
 #include "zetasql/testing/test_function.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iosfwd>
+#include <thread>
 #include <utility>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/public/value.h"
 #include "zetasql/testing/test_value.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/status.h"
@@ -212,5 +216,70 @@ std::ostream& operator<<(std::ostream& out, const QueryParamsWithResult& p) {
   }
 }
 
+zetasql_base::Status RunTestCasesInParallel(
+    int num_cases, int num_threads,
+    const std::function<zetasql_base::Status(int case_idx)>& run_case) {
+  CHECK_GE(num_cases, 0);
+
+  // Each worker pulls the next unclaimed case index and records its failures
+  // in a private slot, so no locking is needed.
+  struct WorkerResult {
+    int num_failures = 0;
+    // The failing case with the smallest index seen by this worker.
+    int first_failure_idx = -1;
+    zetasql_base::Status first_failure;
+  };
+
+  std::atomic<int> next_case_idx{0};
+  const auto run_cases = [num_cases, &next_case_idx,
+                          &run_case](WorkerResult* result) {
+    while (true) {
+      const int case_idx = next_case_idx.fetch_add(1);
+      if (case_idx >= num_cases) return;
+      const zetasql_base::Status status = run_case(case_idx);
+      if (!status.ok()) {
+        ++result->num_failures;
+        if (result->first_failure_idx < 0) {
+          result->first_failure_idx = case_idx;
+          result->first_failure = status;
+        }
+      }
+    }
+  };
+
+  std::vector<WorkerResult> results(std::max(num_threads, 1));
+  if (num_threads <= 1) {
+    run_cases(&results[0]);
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      workers.emplace_back(run_cases, &results[i]);
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // Aggregate the per-worker results, reporting the first failure by case
+  // index so the output is deterministic regardless of scheduling.
+  int num_failures = 0;
+  const WorkerResult* first = nullptr;
+  for (const WorkerResult& result : results) {
+    num_failures += result.num_failures;
+    if (result.first_failure_idx >= 0 &&
+        (first == nullptr ||
+         result.first_failure_idx < first->first_failure_idx)) {
+      first = &result;
+    }
+  }
+  if (first == nullptr) return zetasql_base::OkStatus();
+  return zetasql_base::Status(
+      first->first_failure.code(),
+      absl::StrCat(num_failures, " of ", num_cases,
+                   " test cases failed; first failure (case ",
+                   first->first_failure_idx,
+                   "): ", first->first_failure.message()));
+}
 
 }  // namespace zetasql
@@ -18,6 +18,7 @@
 #define ZETASQL_TESTING_TEST_FUNCTION_H_
 
 #include <stddef.h>
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -168,6 +169,40 @@ class QueryParamsWithResult {
 std::vector<QueryParamsWithResult> InvertResults(
     const std::vector<QueryParamsWithResult>& tests);
 
+// Returns the subset of 'tests' that belongs to shard 'shard_index' (in
+// [0, 'num_shards')) out of 'num_shards' total shards.  Every test case
+// belongs to exactly one shard, so drivers can run the full corpus as
+// 'num_shards' independent runs (e.g., one per machine or process).  Cases
+// are assigned round-robin so that a run of adjacent cases with similar cost
+// spreads across shards.  Works for any copyable test case type, e.g.,
+// QueryParamsWithResult or FunctionTestCall.
+template <typename TestCaseType>
+std::vector<TestCaseType> ShardTestCases(const std::vector<TestCaseType>& tests,
+                                         int num_shards, int shard_index) {
+  CHECK_GT(num_shards, 0);
+  CHECK_GE(shard_index, 0);
+  CHECK_LT(shard_index, num_shards);
+  std::vector<TestCaseType> shard;
+  shard.reserve(tests.size() / num_shards + 1);
+  for (size_t i = shard_index; i < tests.size(); i += num_shards) {
+    shard.push_back(tests[i]);
+  }
+  return shard;
+}
+
+// Runs 'num_cases' independent test cases on 'num_threads' worker threads by
+// invoking 'run_case' with each case index in [0, 'num_cases').  Workers pull
+// case indexes dynamically, so uneven per-case cost balances automatically.
+// 'run_case' must be thread-safe.
+//
+// Always runs every case.  Returns OK if all cases do; otherwise returns a
+// status with the code and message of the first failing case (by index) and
+// the total number of failures.  With 'num_threads' <= 1, runs everything on
+// the calling thread.
+zetasql_base::Status RunTestCasesInParallel(
+    int num_cases, int num_threads,
+    const std::function<zetasql_base::Status(int case_idx)>& run_case);
+
 struct FunctionTestCall {
   std::string function_name;
   QueryParamsWithResult params;
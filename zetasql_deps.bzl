@@ -618,6 +618,17 @@ java_library(
             strip_prefix = "googletest-b77e5c76252bac322bb82c5b444f050bd0d92451",
         )
 
+    # Google Benchmark framework. Used by benchmark targets.
+    if not native.existing_rule("com_github_google_benchmark"):
+        http_archive(
+            name = "com_github_google_benchmark",
+            urls = [
+                "https://github.com/google/benchmark/archive/v1.5.0.tar.gz",
+            ],
+            sha256 = "3c6a165b6ecc948967a1ead710d4a181d7b0fbcaa183ef7ea84604994966221a",
+            strip_prefix = "benchmark-1.5.0",
+        )
+
     # RE2 Regex Framework, mostly used in unit tests.
     if not native.existing_rule("com_google_re2"):
         http_archive(